@@ -23,6 +23,8 @@
 
 #ifdef _WIN32
 #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
 #endif
 
 #include "cpu_extensions.h"
@@ -33,9 +35,10 @@ void GetCPUID(int outInfo[4], int functionID)
     // subfunction_id = 0
 #ifdef _WIN32
     __cpuidex(outInfo, functionID, 0);  // defined in intrin.h
+#elif defined(__x86_64__) || defined(__i386__)
+    __cpuid_count(functionID, 0, outInfo[0], outInfo[1], outInfo[2], outInfo[3]);  // defined in cpuid.h
 #else
-    // To Do
-    //__cpuid_count(0, function_id, outInfo[0], outInfo[1], outInfo[2], outInfo[3]);
+    outInfo[0] = outInfo[1] = outInfo[2] = outInfo[3] = 0;
 #endif
 }
 
@@ -63,7 +66,7 @@ CPUExtensions GetCPUExtensions()
 
     int cpuInfo[4];
 
-#ifndef __linux__
+#if defined(_WIN32) || defined(__x86_64__) || defined(__i386__)
 
     GetCPUID(cpuInfo, 0);
 
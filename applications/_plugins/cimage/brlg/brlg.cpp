@@ -123,48 +123,13 @@ int Image_Plugin_BRLG::TC_PluginFileSaveTexture(const char* fileName, CMP_Textur
 #endif
 }
 
-int Image_Plugin_BRLG::TC_PluginFileLoadTexture(const char* fileName, MipSet* srcTexture)
-{
-    std::vector<CMP_MipSet> resultMipSets;
-
-    if (!srcTexture || !fileName)
-        return PE_InitErr;
-
-    int error = LoadPackagedTextures(fileName, resultMipSets);
-
-    if (error != PE_OK)
-        return error;
-
-    if (resultMipSets.size() > 1)
-    {
-        if (BRLG_CMips)
-            BRLG_CMips->PrintError(
-                "ERROR: Expected to only load one texture from BRLG file, but loaded %d textures. Use \"LoadPackagedTextures\" function when loading "
-                "non-legacy BRLG files.\n",
-                resultMipSets.size());
-
-        return BRLG_PLUGIN_ERROR_UNSUPPORTED_TYPE;
-    }
-
-    if (resultMipSets.size() == 0)
-    {
-        if (BRLG_CMips)
-            BRLG_CMips->PrintError("ERROR: No data could be loaded from the BRLG file \"%s\"\n", fileName);
-        return BRLG_PLUGIN_ERROR_UNSUPPORTED_TYPE;
-    }
-
-    *srcTexture = resultMipSets[0];
-
-    return PE_OK;
-}
-
-static CMP_DWORD ReadBlockData(CMP_MipSet& destTexture, FILE* inFile, CMP_DWORD compressedDataSize = 0)
+static CMP_DWORD ReadBlockData(CMP_MipSet& destTexture, CMP_Stream* inStream, CMP_DWORD compressedDataSize = 0)
 {
     // Read block header
 
     BRLG_BlockHeader blockHeader = {};
 
-    if (fread(&blockHeader, sizeof(BRLG_BlockHeader), 1, inFile) != 1)
+    if (CMP_StreamRead(inStream, &blockHeader, sizeof(BRLG_BlockHeader), 1) != 1)
     {
         if (BRLG_CMips)
             BRLG_CMips->PrintError("ERROR: BRLG Plug-in encountered an invalid block header.\n");
@@ -214,7 +179,7 @@ static CMP_DWORD ReadBlockData(CMP_MipSet& destTexture, FILE* inFile, CMP_DWORD
     if (blockHeader.extraDataSize > 0)
     {
         char* originalFileName = (char*)malloc(blockHeader.extraDataSize);
-        fread(originalFileName, blockHeader.extraDataSize, 1, inFile);
+        CMP_StreamRead(inStream, originalFileName, blockHeader.extraDataSize, 1);
 
         BRLG_ExtraInfo* extraInfo = (BRLG_ExtraInfo*)calloc(1, sizeof(BRLG_ExtraInfo));
         extraInfo->numChars       = blockHeader.extraDataSize;
@@ -224,31 +189,24 @@ static CMP_DWORD ReadBlockData(CMP_MipSet& destTexture, FILE* inFile, CMP_DWORD
     }
 
     // Read compressed data
-    fread((CMP_BYTE*)(mipLevel->m_pbData), mipLevel->m_dwLinearSize, 1, inFile);
+    CMP_StreamRead(inStream, (CMP_BYTE*)(mipLevel->m_pbData), mipLevel->m_dwLinearSize, 1);
 
     CMP_DWORD totalReadSize = sizeof(blockHeader) + blockHeader.extraDataSize + mipLevel->m_dwLinearSize;
     return totalReadSize;
 }
 
-int Image_Plugin_BRLG::LoadPackagedTextures(const char* srcFileName, std::vector<CMP_MipSet>& destTextures)
+// Reads every texture of a BRLG file from inStream and closes it, srcFileName only names the source in errors
+static int LoadPackagedStream(CMP_Stream* inStream, std::vector<CMP_MipSet>& destTextures, const char* srcFileName)
 {
-    FILE* inFile = fopen(srcFileName, "rb");
-    if (inFile == NULL)
-    {
-        if (BRLG_CMips)
-            BRLG_CMips->PrintError("Error(%d): BRLG Plugin ID(%d) opening file = %s ", EL_Error, BRLG_PLUGIN_ERROR_FILE_OPEN, srcFileName);
-        return PE_InitErr;
-    }
-
     // Read the header
 
     BRLG_FileHeader fileHeader = {};
 
-    if (fread(&fileHeader, sizeof(BRLG_FileHeader), 1, inFile) != 1)
+    if (CMP_StreamRead(inStream, &fileHeader, sizeof(BRLG_FileHeader), 1) != 1)
     {
         if (BRLG_CMips)
             BRLG_CMips->PrintError("Error(%d): BRLG Plugin invalid file header. Filename = %s ", EL_Error, srcFileName);
-        fclose(inFile);
+        CMP_StreamClose(inStream);
         return BRLG_PLUGIN_ERROR_UNSUPPORTED_TYPE;
     }
 
@@ -260,7 +218,7 @@ int Image_Plugin_BRLG::LoadPackagedTextures(const char* srcFileName, std::vector
         {
             if (BRLG_CMips)
                 BRLG_CMips->PrintError("Error(%d): BRLG Plugin invalid file identifier. Filename = %s ", EL_Error, srcFileName);
-            fclose(inFile);
+            CMP_StreamClose(inStream);
             return BRLG_PLUGIN_ERROR_NOT_BRLG;
         }
     }
@@ -269,7 +227,7 @@ int Image_Plugin_BRLG::LoadPackagedTextures(const char* srcFileName, std::vector
     {
         if (BRLG_CMips)
             BRLG_CMips->PrintError("Error(%d): BRLG Plugin invalid file version. Filename = %s ", EL_Error, srcFileName);
-        fclose(inFile);
+        CMP_StreamClose(inStream);
         return BRLG_PLUGIN_ERROR_NOT_BRLG;
     }
 
@@ -277,19 +235,19 @@ int Image_Plugin_BRLG::LoadPackagedTextures(const char* srcFileName, std::vector
     if (fileHeader.majorVersion == 1)
     {
         CMP_MipSet destTexture   = {};
-        CMP_DWORD  totalReadSize = ReadBlockData(destTexture, inFile, fileHeader.compressedDataSize);
+        CMP_DWORD  totalReadSize = ReadBlockData(destTexture, inStream, fileHeader.compressedDataSize);
 
         if (totalReadSize == 0)
         {
             if (BRLG_CMips)
                 BRLG_CMips->PrintError("ERROR: Could not read BRLG block data in file \"%s\".\n", srcFileName);
 
-            fclose(inFile);
+            CMP_StreamClose(inStream);
             return BRLG_PLUGIN_ERROR_UNSUPPORTED_TYPE;
         }
 
         destTextures.push_back(std::move(destTexture));
-        fclose(inFile);
+        CMP_StreamClose(inStream);
         return PE_OK;
     }
 
@@ -301,14 +259,14 @@ int Image_Plugin_BRLG::LoadPackagedTextures(const char* srcFileName, std::vector
     {
         CMP_MipSet destTexture = {};
 
-        CMP_DWORD bytesRead = ReadBlockData(destTexture, inFile);
+        CMP_DWORD bytesRead = ReadBlockData(destTexture, inStream);
 
         if (bytesRead == 0)
         {
             if (BRLG_CMips)
                 BRLG_CMips->PrintError("ERROR: Could not read BRLG block data in file \"%s\".\n", srcFileName);
 
-            fclose(inFile);
+            CMP_StreamClose(inStream);
             return BRLG_PLUGIN_ERROR_UNSUPPORTED_TYPE;
         }
 
@@ -317,12 +275,92 @@ int Image_Plugin_BRLG::LoadPackagedTextures(const char* srcFileName, std::vector
         remainingBytes -= bytesRead;
     }
 
-    fclose(inFile);
+    CMP_StreamClose(inStream);
+
+    return PE_OK;
+}
+
+int Image_Plugin_BRLG::LoadPackagedTextures(const char* srcFileName, std::vector<CMP_MipSet>& destTextures)
+{
+    FILE* inFile = fopen(srcFileName, "rb");
+    if (inFile == NULL)
+    {
+        if (BRLG_CMips)
+            BRLG_CMips->PrintError("Error(%d): BRLG Plugin ID(%d) opening file = %s ", EL_Error, BRLG_PLUGIN_ERROR_FILE_OPEN, srcFileName);
+        return PE_InitErr;
+    }
+
+    CMP_Stream inStream;
+    CMP_InitFileStream(&inStream, inFile);
+
+    int error = LoadPackagedStream(&inStream, destTextures, srcFileName);
+    CMP_StreamClose(&inStream);
+    return error;
+}
+
+// Loads the only texture of a BRLG file from inStream and closes it, fileName only names the source in errors
+static int LoadBRLG(CMP_Stream* inStream, MipSet* srcTexture, const char* fileName)
+{
+    std::vector<CMP_MipSet> resultMipSets;
+
+    int error = LoadPackagedStream(inStream, resultMipSets, fileName);
+
+    if (error != PE_OK)
+        return error;
+
+    if (resultMipSets.size() > 1)
+    {
+        if (BRLG_CMips)
+            BRLG_CMips->PrintError(
+                "ERROR: Expected to only load one texture from BRLG file, but loaded %d textures. Use \"LoadPackagedTextures\" function when loading "
+                "non-legacy BRLG files.\n",
+                resultMipSets.size());
+
+        return BRLG_PLUGIN_ERROR_UNSUPPORTED_TYPE;
+    }
+
+    if (resultMipSets.size() == 0)
+    {
+        if (BRLG_CMips)
+            BRLG_CMips->PrintError("ERROR: No data could be loaded from the BRLG file \"%s\"\n", fileName);
+        return BRLG_PLUGIN_ERROR_UNSUPPORTED_TYPE;
+    }
+
+    *srcTexture = resultMipSets[0];
 
     return PE_OK;
 }
 
-static void WriteFileHeader(FILE* destFile, CMP_DWORD totalFileSize)
+int Image_Plugin_BRLG::TC_PluginFileLoadTexture(const char* fileName, MipSet* srcTexture)
+{
+    if (!srcTexture || !fileName)
+        return PE_InitErr;
+
+    FILE* inFile = fopen(fileName, "rb");
+    if (inFile == NULL)
+    {
+        if (BRLG_CMips)
+            BRLG_CMips->PrintError("Error(%d): BRLG Plugin ID(%d) opening file = %s ", EL_Error, BRLG_PLUGIN_ERROR_FILE_OPEN, fileName);
+        return PE_InitErr;
+    }
+
+    CMP_Stream inStream;
+    CMP_InitFileStream(&inStream, inFile);
+
+    int error = LoadBRLG(&inStream, srcTexture, fileName);
+    CMP_StreamClose(&inStream);
+    return error;
+}
+
+int Image_Plugin_BRLG::TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* srcTexture)
+{
+    if (!srcTexture || !pStream)
+        return PE_InitErr;
+
+    return LoadBRLG(pStream, srcTexture, "stream");
+}
+
+static void WriteFileHeader(CMP_Stream* destStream, CMP_DWORD totalFileSize)
 {
     BRLG_FileHeader fileHeader = {};
 
@@ -331,10 +369,10 @@ static void WriteFileHeader(FILE* destFile, CMP_DWORD totalFileSize)
     fileHeader.headerSize             = sizeof(BRLG_FileHeader);
     fileHeader.compressedDataSize     = totalFileSize - fileHeader.headerSize;
 
-    fwrite(&fileHeader, sizeof(BRLG_FileHeader), 1, destFile);
+    CMP_StreamWrite(destStream, &fileHeader, sizeof(BRLG_FileHeader), 1);
 }
 
-static void WriteBlockHeader(FILE* destFile, const MipSet* texture)
+static void WriteBlockHeader(CMP_Stream* destStream, const MipSet* texture)
 {
     BRLG_BlockHeader blockHeader = {};
 
@@ -354,22 +392,20 @@ static void WriteBlockHeader(FILE* destFile, const MipSet* texture)
 
     blockHeader.compressedBlockSize = texture->dwDataSize;
 
-    fwrite(&blockHeader, sizeof(BRLG_BlockHeader), 1, destFile);
+    CMP_StreamWrite(destStream, &blockHeader, sizeof(BRLG_BlockHeader), 1);
 
     if (extraInfo)
     {
-        fwrite(extraInfo->fileName, extraInfo->numChars, 1, destFile);
+        CMP_StreamWrite(destStream, extraInfo->fileName, extraInfo->numChars, 1);
     }
 
     MipLevel* mipLevel = BRLG_CMips->GetMipLevel(texture, 0);
-    fwrite(mipLevel->m_pbData, texture->dwDataSize, 1, destFile);
+    CMP_StreamWrite(destStream, mipLevel->m_pbData, texture->dwDataSize, 1);
 }
 
-int Image_Plugin_BRLG::TC_PluginFileSaveTexture(const char* fileName, MipSet* srcTexture)
+// Writes a BRLG file holding the one texture to outStream
+static void SaveBRLG(CMP_Stream* outStream, const MipSet* srcTexture)
 {
-    assert(fileName);
-    assert(srcTexture);
-
     CMP_DWORD totalFileSize = sizeof(BRLG_FileHeader) + sizeof(BRLG_BlockHeader);
 
     if (srcTexture->m_pReservedData)
@@ -380,6 +416,15 @@ int Image_Plugin_BRLG::TC_PluginFileSaveTexture(const char* fileName, MipSet* sr
 
     totalFileSize += srcTexture->dwDataSize;
 
+    WriteFileHeader(outStream, totalFileSize);
+    WriteBlockHeader(outStream, srcTexture);
+}
+
+int Image_Plugin_BRLG::TC_PluginFileSaveTexture(const char* fileName, MipSet* srcTexture)
+{
+    assert(fileName);
+    assert(srcTexture);
+
     // Check if the base directory of the file exists, if not we create it
     std::string baseDirectory = CMP_GetBaseDir(std::string(fileName));
     if (!baseDirectory.empty() && !CMP_DirExists(baseDirectory))
@@ -402,10 +447,21 @@ int Image_Plugin_BRLG::TC_PluginFileSaveTexture(const char* fileName, MipSet* sr
         return PE_InitErr;
     }
 
-    WriteFileHeader(outFile, totalFileSize);
-    WriteBlockHeader(outFile, srcTexture);
+    CMP_Stream outStream;
+    CMP_InitFileStream(&outStream, outFile);
 
-    fclose(outFile);
+    SaveBRLG(&outStream, srcTexture);
+    CMP_StreamClose(&outStream);
+
+    return PE_OK;
+}
+
+int Image_Plugin_BRLG::TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* srcTexture)
+{
+    assert(pStream);
+    assert(srcTexture);
+
+    SaveBRLG(pStream, srcTexture);
 
     return PE_OK;
 }
@@ -450,14 +506,17 @@ int Image_Plugin_BRLG::SavePackagedTextures(const char* destFileName, const std:
         return PE_InitErr;
     }
 
-    WriteFileHeader(outFile, totalFileSize);
+    CMP_Stream outStream;
+    CMP_InitFileStream(&outStream, outFile);
+
+    WriteFileHeader(&outStream, totalFileSize);
 
     for (const CMP_MipSet& texture : srcTextures)
     {
-        WriteBlockHeader(outFile, &texture);
+        WriteBlockHeader(&outStream, &texture);
     }
 
-    fclose(outFile);
+    CMP_StreamClose(&outStream);
 
     return PE_OK;
 }
\ No newline at end of file
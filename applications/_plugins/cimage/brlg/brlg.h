@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "cmp_plugininterface.h"
+#include "cmp_stream.h"
 
 #define BRLG_PLUGIN_VERSION_MAJOR 2
 #define BRLG_PLUGIN_VERSION_MINOR 0
@@ -53,6 +54,9 @@ public:
     int TC_PluginFileSaveTexture(const char* fileName, MipSet* srcTexture);
     int TC_PluginFileSaveTexture(const char* fileName, CMP_Texture* srcTexture);
 
+    int TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* srcTexture);
+    int TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* srcTexture);
+
     // These two functions are the only ones that fully support the new BRLG version 2 paradigm
     // So in a way the older functions are deprecated, though they will still work
     // But the loading especially should only be done through the new LoadPackagedTextures function
@@ -119,30 +119,22 @@ int Plugin_DDS::TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* s
 #endif
 }
 
-int Plugin_DDS::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+// Loaders and savers close the stream when they are done, pszFilename is only used in messages
+static int LoadDDS(CMP_Stream* pStream, MipSet* pMipSet, const char* pszFilename)
 {
-    g_pszFilename = pszFilename;
-    FILE* pFile   = NULL;
-    pFile         = fopen(pszFilename, ("rb"));
-    if (pFile == NULL)
-    {
-        DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_FILE_OPEN, pszFilename);
-        return PE_Unknown;
-    }
-
-    CMP_DWORD dwFileHeader;
-    fread(&dwFileHeader, sizeof(CMP_DWORD), 1, pFile);
+    CMP_DWORD dwFileHeader = 0;
+    CMP_StreamRead(pStream, &dwFileHeader, sizeof(CMP_DWORD), 1);
     if (dwFileHeader != DDS_HEADER)
     {
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_NOT_DDS, pszFilename);
         return PE_Unknown;
     }
 
     DDSD2 ddsd;
-    if (fread(&ddsd, sizeof(DDSD2), 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, &ddsd, sizeof(DDSD2), 1) != 1)
     {
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_NOT_DDS, pszFilename);
         return PE_Unknown;
     }
@@ -151,14 +143,14 @@ int Plugin_DDS::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         ddsd.dwMipMapCount = 1;
     else if (ddsd.dwMipMapCount == 0)
     {
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_NOT_DDS, pszFilename);
         return PE_Unknown;
     }
 
     // if ((DDSHeader->ddspf.flags & DDS_FOURCC) && (MAKEFOURCC('D', 'X', '1', '0') == DDSHeader->ddspf.fourCC))
     if (ddsd.ddpfPixelFormat.dwFourCC == CMP_MAKEFOURCC('D', 'X', '1', '0'))
-        return LoadDDS_DX10(pFile, &ddsd, pMipSet);
+        return LoadDDS_DX10(pStream, &ddsd, pMipSet);
 
     // Prep for next revision
     // DDS_FILE_HEADER* DDSHeader = reinterpret_cast<DDS_FILE_HEADER*>(&ddsd);
@@ -177,135 +169,178 @@ int Plugin_DDS::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     if ((DDSHeader->ddspf.flags & DDPF_LUMINANCE) && (DDSHeader->ddspf.RGBBitCount == 16) && (DDSHeader->ddspf.RBitMask & 0xffff) &&
         (DDSHeader->ddspf.GBitMask == 0) && (DDSHeader->ddspf.BBitMask == 0))
     {
-        return LoadDDS_R16(pFile, &ddsd, pMipSet);
+        return LoadDDS_R16(pStream, &ddsd, pMipSet);
     }
 
     if ((DDSHeader->ddspf.flags & DDS_BUMPDUDV) && (DDSHeader->ddspf.RGBBitCount == 32))
     {
         pMipSet->m_format = CMP_FORMAT_RGBA_8888_S;
-        return LoadDDS_RGB8888_S(pFile, &ddsd, pMipSet, (ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS) ? true : false);
+        return LoadDDS_RGB8888_S(pStream, &ddsd, pMipSet, (ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS) ? true : false);
     }
 
     // Try known FourCC first for legcay support
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_A32B32G32R32F)
-        return LoadDDS_ABGR32F(pFile, &ddsd, pMipSet);
+        return LoadDDS_ABGR32F(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_A16B16G16R16F)
-        return LoadDDS_ABGR16F(pFile, &ddsd, pMipSet);
+        return LoadDDS_ABGR16F(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_G32R32F)
-        return LoadDDS_GR32F(pFile, &ddsd, pMipSet);
+        return LoadDDS_GR32F(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_R32F)
-        return LoadDDS_R32F(pFile, &ddsd, pMipSet);
+        return LoadDDS_R32F(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_R16F)
-        return LoadDDS_R16F(pFile, &ddsd, pMipSet);
+        return LoadDDS_R16F(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_G16R16F)
-        return LoadDDS_G16R16F(pFile, &ddsd, pMipSet);
+        return LoadDDS_G16R16F(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_A16B16G16R16)
-        return LoadDDS_ABGR16(pFile, &ddsd, pMipSet);
+        return LoadDDS_ABGR16(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_Q16W16V16U16)
-        return LoadDDS_ABGR16(pFile, &ddsd, pMipSet);
+        return LoadDDS_ABGR16(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_G16R16)
-        return LoadDDS_G16R16(pFile, &ddsd, pMipSet);
+        return LoadDDS_G16R16(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC == D3DFMT_L16)
-        return LoadDDS_R16(pFile, &ddsd, pMipSet);
+        return LoadDDS_R16(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwFourCC)
-        return LoadDDS_FourCC(pFile, &ddsd, pMipSet);
+        return LoadDDS_FourCC(pStream, &ddsd, pMipSet);
 
     if (ddsd.ddpfPixelFormat.dwLuminanceBitCount == 8 && (ddsd.ddpfPixelFormat.dwFlags & DDPF_LUMINANCE))
-        return LoadDDS_G8(pFile, &ddsd, pMipSet);
+        return LoadDDS_G8(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwLuminanceBitCount == 16 && (ddsd.ddpfPixelFormat.dwFlags & DDPF_LUMINANCE) && (ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS))
-        return LoadDDS_AG8(pFile, &ddsd, pMipSet);
+        return LoadDDS_AG8(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwLuminanceBitCount == 16 && (ddsd.ddpfPixelFormat.dwFlags & DDPF_LUMINANCE) && (ddsd.ddpfPixelFormat.dwGBitMask == 0xffff))
-        return LoadDDS_G16(pFile, &ddsd, pMipSet);
+        return LoadDDS_G16(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwAlphaBitDepth == 8 && (ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHA))
-        return LoadDDS_A8(pFile, &ddsd, pMipSet);
+        return LoadDDS_A8(pStream, &ddsd, pMipSet);
     if ((ddsd.ddpfPixelFormat.dwFlags & DDPF_RGB) && !(ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS) && (ddsd.ddpfPixelFormat.dwRGBBitCount == 16))
-        return LoadDDS_RGB565(pFile, &ddsd, pMipSet);
+        return LoadDDS_RGB565(pStream, &ddsd, pMipSet);
     if ((ddsd.ddpfPixelFormat.dwFlags & DDPF_RGB) && !(ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS) && (ddsd.ddpfPixelFormat.dwRGBBitCount == 24))
-        return LoadDDS_RGB888(pFile, &ddsd, pMipSet);
+        return LoadDDS_RGB888(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwRGBBitCount == 32 && (ddsd.ddpfPixelFormat.dwRBitMask == 0x3ff || ddsd.ddpfPixelFormat.dwRBitMask == 0x3ff00000))
-        return LoadDDS_ARGB2101010(pFile, &ddsd, pMipSet);
+        return LoadDDS_ARGB2101010(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwRGBBitCount == 32 && ddsd.ddpfPixelFormat.dwRBitMask == 0xffff && ddsd.ddpfPixelFormat.dwGBitMask == 0xffff0000)
-        return LoadDDS_G16R16(pFile, &ddsd, pMipSet);
+        return LoadDDS_G16R16(pStream, &ddsd, pMipSet);
     if (ddsd.ddpfPixelFormat.dwLuminanceBitCount == 16 && (ddsd.ddpfPixelFormat.dwFlags & DDPF_LUMINANCE) && (ddsd.ddpfPixelFormat.dwRBitMask == 0xffff))
     {  // 16bpp Gray
         pMipSet->m_format = CMP_FORMAT_ABGR_16;
-        return LoadDDS_ABGR16(pFile, &ddsd, pMipSet);
+        return LoadDDS_ABGR16(pStream, &ddsd, pMipSet);
     }
     if (ddsd.ddpfPixelFormat.dwRGBBitCount == 16 && ddsd.ddpfPixelFormat.dwRBitMask == 0xffff)
     {
         pMipSet->m_format = CMP_FORMAT_R_16;
-        return LoadDDS_R16(pFile, &ddsd, pMipSet);
+        return LoadDDS_R16(pStream, &ddsd, pMipSet);
     }
     if (ddsd.ddpfPixelFormat.dwRGBBitCount == 32)
     {
         pMipSet->m_format = CMP_FORMAT_ARGB_8888;
-        return LoadDDS_RGB8888(pFile, &ddsd, pMipSet, (ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS) ? true : false);
+        return LoadDDS_RGB8888(pStream, &ddsd, pMipSet, (ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS) ? true : false);
     }
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_UNSUPPORTED_TYPE, pszFilename);
     return PE_Unknown;
 }
 
-int Plugin_DDS::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+static int SaveDDS(CMP_Stream* pStream, MipSet* pMipSet)
 {
-    assert(pszFilename);
-    assert(pMipSet);
-
-    FILE* pFile = NULL;
-    pFile       = fopen(pszFilename, ("wb"));
-    if (pFile == NULL)
-    {
-        return PE_Unknown;
-    }
-
-    fwrite(&DDS_HEADER, sizeof(CMP_DWORD), 1, pFile);
+    CMP_StreamWrite(pStream, &DDS_HEADER, sizeof(CMP_DWORD), 1);
 
     if (pMipSet->m_dwFourCC == CMP_FOURCC_G8)
-        return SaveDDS_G8(pFile, pMipSet);
+        return SaveDDS_G8(pStream, pMipSet);
     else if (pMipSet->m_dwFourCC == CMP_FOURCC_A8)
-        return SaveDDS_A8(pFile, pMipSet);
+        return SaveDDS_A8(pStream, pMipSet);
     else if (IsD3D10Format(pMipSet))
-        return SaveDDS_DX10(pFile, pMipSet);
+        return SaveDDS_DX10(pStream, pMipSet);
     else if (pMipSet->m_dwFourCC)
-        return SaveDDS_FourCC(pFile, pMipSet);
+        return SaveDDS_FourCC(pStream, pMipSet);
     else if (pMipSet->m_ChannelFormat == CF_Float16)
     {
         if (pMipSet->m_TextureDataType == TDT_R)
-            return SaveDDS_R16F(pFile, pMipSet);
+            return SaveDDS_R16F(pStream, pMipSet);
         else if (pMipSet->m_TextureDataType == TDT_RG)
-            return SaveDDS_RG16F(pFile, pMipSet);
+            return SaveDDS_RG16F(pStream, pMipSet);
         else
-            return SaveDDS_ABGR16F(pFile, pMipSet);
+            return SaveDDS_ABGR16F(pStream, pMipSet);
     }
     else if (pMipSet->m_ChannelFormat == CF_Float32)
     {
         if (pMipSet->m_TextureDataType == TDT_R)
-            return SaveDDS_R32F(pFile, pMipSet);
+            return SaveDDS_R32F(pStream, pMipSet);
         else if (pMipSet->m_TextureDataType == TDT_RG)
-            return SaveDDS_RG32F(pFile, pMipSet);
+            return SaveDDS_RG32F(pStream, pMipSet);
         else
-            return SaveDDS_ABGR32F(pFile, pMipSet);
+            return SaveDDS_ABGR32F(pStream, pMipSet);
     }
     else if (pMipSet->m_ChannelFormat == CF_2101010)
-        return SaveDDS_ARGB2101010(pFile, pMipSet);
+        return SaveDDS_ARGB2101010(pStream, pMipSet);
     else if (pMipSet->m_ChannelFormat == CF_16bit)
     {
         if (pMipSet->m_TextureDataType == TDT_R)
-            return SaveDDS_R16(pFile, pMipSet);
+            return SaveDDS_R16(pStream, pMipSet);
         else if (pMipSet->m_TextureDataType == TDT_RG)
-            return SaveDDS_RG16(pFile, pMipSet);
+            return SaveDDS_RG16(pStream, pMipSet);
         else
-            return SaveDDS_ABGR16(pFile, pMipSet);
+            return SaveDDS_ABGR16(pStream, pMipSet);
     }
     else if (pMipSet->m_TextureDataType == TDT_RGB)
     {
-        return SaveDDS_RGB888(pFile, pMipSet);
+        return SaveDDS_RGB888(pStream, pMipSet);
     }
 
     if (pMipSet->m_format == CMP_FORMAT_RGBA_8888_S)
-        return SaveDDS_RGBA8888_S(pFile, pMipSet);
+        return SaveDDS_RGBA8888_S(pStream, pMipSet);
+
+    return SaveDDS_ARGB8888(pStream, pMipSet);
+}
+
+int Plugin_DDS::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    g_pszFilename = pszFilename;
+    FILE* pFile   = NULL;
+    pFile         = fopen(pszFilename, ("rb"));
+    if (pFile == NULL)
+    {
+        DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_FILE_OPEN, pszFilename);
+        return PE_Unknown;
+    }
+
+    CMP_Stream stream;
+    CMP_InitFileStream(&stream, pFile);
+
+    int result = LoadDDS(&stream, pMipSet, pszFilename);
+    CMP_StreamClose(&stream);
+    return result;
+}
+
+int Plugin_DDS::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    assert(pszFilename);
+    assert(pMipSet);
+
+    FILE* pFile = NULL;
+    pFile       = fopen(pszFilename, ("wb"));
+    if (pFile == NULL)
+    {
+        return PE_Unknown;
+    }
+
+    CMP_Stream stream;
+    CMP_InitFileStream(&stream, pFile);
+
+    int result = SaveDDS(&stream, pMipSet);
+    CMP_StreamClose(&stream);
+    return result;
+}
+
+int Plugin_DDS::TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    g_pszFilename = "stream";
+    return LoadDDS(pStream, pMipSet, g_pszFilename);
+}
+
+int Plugin_DDS::TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    assert(pStream);
+    assert(pMipSet);
 
-    return SaveDDS_ARGB8888(pFile, pMipSet);
+    return SaveDDS(pStream, pMipSet);
 }
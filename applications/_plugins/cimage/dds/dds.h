@@ -27,6 +27,7 @@
 
 #include "cmp_plugininterface.h"
 #include "plugininterface.h"
+#include "cmp_stream.h"
 
 #ifdef _WIN32
 #include "ddraw.h"
@@ -62,6 +63,8 @@ public:
     int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet);
     int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture);
     int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture);
+    int TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet);
+    int TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet);
 };
 
 extern CMIPS* DDS_CMips;
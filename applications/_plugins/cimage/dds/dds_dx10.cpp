@@ -45,21 +45,21 @@
 #include "version.h"
 #include "texture.h"
 
-TC_PluginError LoadDDS_DX10_RGBA_32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_RGBA32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_RGBA_16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_RGBA16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_RG32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R10G10B10A2(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R11G11B10F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R8G8B8A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R16G16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R8G8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, CMP_DWORD dwFourCC);
+TC_PluginError LoadDDS_DX10_RGBA_32F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_RGBA32(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_RGBA_16F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_RGBA16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_RG32(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R10G10B10A2(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R11G11B10F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R8G8B8A8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R16G16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R32(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R8G8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_FourCC(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet, CMP_DWORD dwFourCC);
 
 extern int CMP_MaxFacesOrSlices(const MipSet* pMipSet, int nMipLevel);
 
@@ -75,24 +75,24 @@ typedef struct
 // TODO: This function doesn't set pMipSet->m_format for all loaded DDS images
 // this is mostly fine because we assume RGBA8888 by default, and most of these functions convert to that format
 // but this isn't the case for everything, so a better solution should probably be sought out
-TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     DDS_HEADER_DDS10 HeaderDDS10;
     ;
-    fread(&HeaderDDS10, sizeof(HeaderDDS10), 1, pFile);
+    CMP_StreamRead(pStream, &HeaderDDS10, sizeof(HeaderDDS10), 1);
 
     TC_PluginError err = PE_Unknown;
 
     switch (HeaderDDS10.dxgiFormat)
     {
     case DXGI_FORMAT_R32G32B32A32_FLOAT:
-        err = LoadDDS_DX10_RGBA_32F(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_RGBA_32F(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R32G32B32A32_UINT:
     case DXGI_FORMAT_R32G32B32A32_TYPELESS:
     case DXGI_FORMAT_R32G32B32A32_SINT:
-        err = LoadDDS_DX10_RGBA32(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_RGBA32(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R16G16B16A16_FLOAT:
@@ -100,29 +100,29 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_R16G16B16A16_TYPELESS:
     case DXGI_FORMAT_R16G16B16A16_SNORM:
     case DXGI_FORMAT_R16G16B16A16_SINT:
-        err = LoadDDS_DX10_RGBA16(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_RGBA16(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R32G32_TYPELESS:
     case DXGI_FORMAT_R32G32_FLOAT:
     case DXGI_FORMAT_R32G32_UINT:
     case DXGI_FORMAT_R32G32_SINT:
-        err = LoadDDS_DX10_RG32(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_RG32(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R10G10B10A2_TYPELESS:
     case DXGI_FORMAT_R10G10B10A2_UNORM:
     case DXGI_FORMAT_R10G10B10A2_UINT:
         pMipSet->m_format = CMP_FORMAT_RGBA_1010102;
-        err               = LoadDDS_DX10_R10G10B10A2(pFile, pDDSD, pMipSet);
+        err               = LoadDDS_DX10_R10G10B10A2(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R9G9B9E5_SHAREDEXP:
-        err = LoadDDS_DX10_R9G9B9E5_SHAREDEXP(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_R9G9B9E5_SHAREDEXP(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R11G11B10_FLOAT:
-        err = LoadDDS_DX10_R11G11B10F(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_R11G11B10F(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R8G8B8A8_TYPELESS:
@@ -131,7 +131,7 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_R8G8B8A8_UINT:
     case DXGI_FORMAT_R8G8B8A8_SNORM:
     case DXGI_FORMAT_R8G8B8A8_SINT:
-        err = LoadDDS_DX10_R8G8B8A8(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_R8G8B8A8(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R16G16_TYPELESS:
@@ -139,13 +139,13 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_R16G16_UINT:
     case DXGI_FORMAT_R16G16_SNORM:
     case DXGI_FORMAT_R16G16_SINT:
-        err = LoadDDS_DX10_R16G16(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_R16G16(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R32_TYPELESS:
     case DXGI_FORMAT_R32_UINT:
     case DXGI_FORMAT_R32_SINT:
-        err = LoadDDS_DX10_R32(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_R32(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R8G8_TYPELESS:
@@ -153,7 +153,7 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_R8G8_UINT:
     case DXGI_FORMAT_R8G8_SNORM:
     case DXGI_FORMAT_R8G8_SINT:
-        err = LoadDDS_DX10_R8G8(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_R8G8(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R16_TYPELESS:
@@ -163,7 +163,7 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_R16_UINT:
     case DXGI_FORMAT_R16_SNORM:
     case DXGI_FORMAT_R16_SINT:
-        err = LoadDDS_DX10_R16(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_R16(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_R8_TYPELESS:
@@ -171,7 +171,7 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_R8_UINT:
     case DXGI_FORMAT_R8_SNORM:
     case DXGI_FORMAT_R8_SINT:
-        err = LoadDDS_DX10_R8(pFile, pDDSD, pMipSet);
+        err = LoadDDS_DX10_R8(pStream, pDDSD, pMipSet);
         break;
 
     case DXGI_FORMAT_BC1_TYPELESS:
@@ -179,7 +179,7 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_BC1_UNORM_SRGB:
         pMipSet->m_compressed = true;
         pMipSet->m_format     = CMP_FORMAT_BC1;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_BC1);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_BC1);
         break;
 
     case DXGI_FORMAT_BC2_TYPELESS:
@@ -187,7 +187,7 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_BC2_UNORM_SRGB:
         pMipSet->m_compressed = true;
         pMipSet->m_format     = CMP_FORMAT_BC2;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_BC2);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_BC2);
         break;
 
     case DXGI_FORMAT_BC3_TYPELESS:
@@ -195,45 +195,45 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_BC3_UNORM_SRGB:
         pMipSet->m_compressed = true;
         pMipSet->m_format     = CMP_FORMAT_BC3;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_BC3);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_BC3);
         break;
 
     case DXGI_FORMAT_BC4_TYPELESS:
     case DXGI_FORMAT_BC4_UNORM:
         pMipSet->m_compressed = true;
         pMipSet->m_format     = CMP_FORMAT_BC4;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_BC4);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_BC4);
         break;
 
     case DXGI_FORMAT_BC4_SNORM:
         pMipSet->m_compressed = true;
         pMipSet->m_format     = CMP_FORMAT_BC4_S;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_BC4S);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_BC4S);
         break;
 
     case DXGI_FORMAT_BC5_TYPELESS:
     case DXGI_FORMAT_BC5_UNORM:
         pMipSet->m_format     = CMP_FORMAT_BC5;
         pMipSet->m_compressed = true;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_BC5);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_BC5);
         break;
 
     case DXGI_FORMAT_BC5_SNORM:
         pMipSet->m_format     = CMP_FORMAT_BC5_S;
         pMipSet->m_compressed = true;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_BC5S);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_BC5S);
         break;
 
     case DXGI_FORMAT_BC6H_TYPELESS:
     case DXGI_FORMAT_BC6H_UF16:
         pMipSet->m_compressed = true;
         pMipSet->m_format     = CMP_FORMAT_BC6H;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_DX10);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_DX10);
         break;
     case DXGI_FORMAT_BC6H_SF16:
         pMipSet->m_compressed = true;
         pMipSet->m_format     = CMP_FORMAT_BC6H_SF;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_DX10);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_DX10);
         break;
 
     case DXGI_FORMAT_BC7_TYPELESS:
@@ -241,13 +241,13 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     case DXGI_FORMAT_BC7_UNORM_SRGB:
         pMipSet->m_compressed = true;
         pMipSet->m_format     = CMP_FORMAT_BC7;
-        err                   = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_DX10);
+        err                   = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_DX10);
         break;
 
     // case DXGI_FORMAT_???:
     //    pMipSet->m_compressed = true;
     //    pMipSet->m_format     = CMP_FORMAT_ASTC;
-    //    err = LoadDDS_DX10_FourCC(pFile, pDDSD, pMipSet, CMP_FOURCC_DX10);
+    //    err = LoadDDS_DX10_FourCC(pStream, pDDSD, pMipSet, CMP_FOURCC_DX10);
     //    pMipSet->m_swizzle    = ???;
     //    break;
     //
@@ -255,68 +255,69 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
         assert(0);
     }
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return err;
 }
 
-TC_PluginError LoadDDS_DX10_RGBA_32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RGBA_32F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float32, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float32, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
 }
 
-TC_PluginError LoadDDS_DX10_RGBA32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RGBA32(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_32bit, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_32bit, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
 }
 
-TC_PluginError LoadDDS_DX10_RGBA_16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RGBA_16F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
 }
 
-TC_PluginError LoadDDS_DX10_RGBA16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RGBA16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
 }
 
-TC_PluginError LoadDDS_DX10_RG32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RG32(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_32bit, TDT_XRGB, PreLoopABGR32, LoopR32G32, PreLoopABGR32);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_32bit, TDT_XRGB, PreLoopABGR32, LoopR32G32, PreLoopABGR32);
 }
 
-TC_PluginError LoadDDS_DX10_R10G10B10A2(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R10G10B10A2(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     pMipSet->m_TextureDataType   = TDT_ARGB;
     ChannelFormat channelFormat  = CF_1010102;
     void*         pChannelFormat = &channelFormat;
     return GenericLoadFunction(
-        pFile, pDDSD, pMipSet, pChannelFormat, channelFormat, pMipSet->m_TextureDataType, PreLoopDefault, LoopR10G10B10A2, PostLoopDefault);
+        pStream, pDDSD, pMipSet, pChannelFormat, channelFormat, pMipSet->m_TextureDataType, PreLoopDefault, LoopR10G10B10A2, PostLoopDefault);
 }
 
-TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     pMipSet->m_TextureDataType   = TDT_XRGB;
     ChannelFormat channelFormat  = CF_Float9995E;
     void*         pChannelFormat = &channelFormat;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, pChannelFormat, channelFormat, pMipSet->m_TextureDataType, PreLoopDefault, LoopR9G9B9E5, PostLoopDefault);
+    return GenericLoadFunction(
+        pStream, pDDSD, pMipSet, pChannelFormat, channelFormat, pMipSet->m_TextureDataType, PreLoopDefault, LoopR9G9B9E5, PostLoopDefault);
 }
 
-TC_PluginError LoadDDS_DX10_R11G11B10F(FILE* /*pFile*/, DDSD2* /*pDDSD*/, MipSet* /*pMipSet*/)
+TC_PluginError LoadDDS_DX10_R11G11B10F(CMP_Stream* /*pStream*/, DDSD2* /*pDDSD*/, MipSet* /*pMipSet*/)
 {
     return PE_Unknown;
     /*
         void* extra;
-        return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
+        return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
     */
 }
 
-TC_PluginError LoadDDS_DX10_R8G8B8A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R8G8B8A8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     ARGB8888Struct* pARGB8888Struct = (ARGB8888Struct*)calloc(sizeof(ARGB8888Struct), 1);
     void*           extra           = pARGB8888Struct;
@@ -332,43 +333,43 @@ TC_PluginError LoadDDS_DX10_R8G8B8A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 
     pMipSet->m_TextureDataType = TDT_ARGB;
 
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888, PostLoopRGB8888);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888, PostLoopRGB8888);
 }
 
-TC_PluginError LoadDDS_DX10_R16G16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R16G16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_XRGB, PreLoopABGR16, LoopR16G16, PreLoopABGR16);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_16bit, TDT_XRGB, PreLoopABGR16, LoopR16G16, PreLoopABGR16);
 }
 
-TC_PluginError LoadDDS_DX10_R8G8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R8G8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB8888, LoopR8G8, PreLoopRGB8888);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB8888, LoopR8G8, PreLoopRGB8888);
 }
 
-TC_PluginError LoadDDS_DX10_R32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R32(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_32bit, TDT_XRGB, PreLoopABGR32, LoopR32, PostLoopABGR32);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_32bit, TDT_XRGB, PreLoopABGR32, LoopR32, PostLoopABGR32);
 }
 
-TC_PluginError LoadDDS_DX10_R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_XRGB, PreLoopABGR16, LoopR16, PostLoopABGR16);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_16bit, TDT_XRGB, PreLoopABGR16, LoopR16, PostLoopABGR16);
 }
 
-TC_PluginError LoadDDS_DX10_R8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB8888, LoopR8, PreLoopRGB8888);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB8888, LoopR8, PreLoopRGB8888);
 }
 
-TC_PluginError LoadDDS_DX10_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, CMP_DWORD /*dwFourCC*/)
+TC_PluginError LoadDDS_DX10_FourCC(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet, CMP_DWORD /*dwFourCC*/)
 {
     void* extra;
-    return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopFourCC, LoopFourCC, PostLoopFourCC);
+    return GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopFourCC, LoopFourCC, PostLoopFourCC);
 }
 
 DXGI_FORMAT GetDXGIFormat(const MipSet* pMipSet)
@@ -453,9 +454,9 @@ bool SetupDDSD10(DDS_HEADER_DDS10& HeaderDDS10, const MipSet* pMipSet)
     return true;
 }
 
-TC_PluginError SaveDDS_DX10(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_DX10(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     DDSD2 ddsd2;
@@ -481,20 +482,10 @@ TC_PluginError SaveDDS_DX10(FILE* pFile, const MipSet* pMipSet)
         break;
     }
 
-    // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
-
     DDS_HEADER_DDS10 HeaderDDS10;
     SetupDDSD10(HeaderDDS10, pMipSet);
 
-    fwrite(&HeaderDDS10, sizeof(HeaderDDS10), 1, pFile);
-
-    int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
-    for (int nSlice = 0; nSlice < nSlices; nSlice++)
-        for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
-
-    fclose(pFile);
-
-    return PE_OK;
+    // Write the data
+    CMP_FileSpan headers[] = {{&ddsd2, sizeof(DDSD2)}, {&HeaderDDS10, sizeof(HeaderDDS10)}};
+    return SaveDDS_Levels(pStream, pMipSet, headers, 2);
 }
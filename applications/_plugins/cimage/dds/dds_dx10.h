@@ -28,7 +28,7 @@
 #include "tc_pluginapi.h"
 #include "dds_file.h"
 
-TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError SaveDDS_DX10(FILE* pFile, const MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError SaveDDS_DX10(CMP_Stream* pStream, const MipSet* pMipSet);
 
 #endif
@@ -48,11 +48,11 @@
 #include "texture.h"
 #include "atiformats.h"
 
-TC_PluginError LoadDDS_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_FourCC(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopFourCC, LoopFourCC, PostLoopFourCC);
-    fclose(pFile);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopFourCC, LoopFourCC, PostLoopFourCC);
+    CMP_StreamClose(pStream);
 
     // Try to set MipSet format for know FourCC formats
     if (pMipSet->m_format == CMP_FORMAT_Unknown)
@@ -61,25 +61,25 @@ TC_PluginError LoadDDS_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     return err;
 }
 
-TC_PluginError LoadDDS_RGB565(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_RGB565(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB565, LoopRGB565, PostLoopRGB565);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB565, LoopRGB565, PostLoopRGB565);
     //pMipSet->m_format  = CMP_FORMAT_RGB_565;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_RGB888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_RGB888(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB888, LoopRGB888, PostLoopRGB888);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB888, LoopRGB888, PostLoopRGB888);
     pMipSet->m_format  = CMP_FORMAT_ARGB_8888;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_RGB8888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha)
+TC_PluginError LoadDDS_RGB8888(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha)
 {
     ARGB8888Struct* pARGB8888Struct = (ARGB8888Struct*)calloc(sizeof(ARGB8888Struct), 1);
     void*           extra           = pARGB8888Struct;
@@ -154,12 +154,12 @@ TC_PluginError LoadDDS_RGB8888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool
 
     pMipSet->m_TextureDataType = bAlpha ? TDT_ARGB : TDT_XRGB;
 
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888, PostLoopRGB8888);
-    fclose(pFile);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888, PostLoopRGB8888);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_RGB8888_S(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha)
+TC_PluginError LoadDDS_RGB8888_S(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha)
 {
     ARGB8888Struct* pARGB8888Struct = (ARGB8888Struct*)calloc(sizeof(ARGB8888Struct), 1);
     void*           extra           = pARGB8888Struct;
@@ -213,17 +213,18 @@ TC_PluginError LoadDDS_RGB8888_S(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, boo
 
     pMipSet->m_TextureDataType = bAlpha ? TDT_ARGB : TDT_XRGB;
 
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888_S, PostLoopRGB8888);
-    fclose(pFile);
+    TC_PluginError err = GenericLoadFunction(
+        pStream, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888_S, PostLoopRGB8888);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_ARGB2101010(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_ARGB2101010(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     pMipSet->m_TextureDataType    = TDT_ARGB;
     ChannelFormat  channelFormat  = CF_2101010;
     void*          pChannelFormat = &channelFormat;
-    TC_PluginError err            = GenericLoadFunction(pFile,
+    TC_PluginError err            = GenericLoadFunction(pStream,
                                              pDDSD,
                                              pMipSet,
                                              pChannelFormat,
@@ -233,16 +234,16 @@ TC_PluginError LoadDDS_ARGB2101010(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
                                              (pDDSD->ddpfPixelFormat.dwRBitMask == 0x3ff00000) ? LoopR10G10B10A2 : LoopDefault,
                                              PostLoopDefault);
     pMipSet->m_format             = CMP_FORMAT_ARGB_2101010;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_RGBA1010102(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_RGBA1010102(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     pMipSet->m_TextureDataType    = TDT_ARGB;
     ChannelFormat  channelFormat  = CF_1010102;
     void*          pChannelFormat = &channelFormat;
-    TC_PluginError err            = GenericLoadFunction(pFile,
+    TC_PluginError err            = GenericLoadFunction(pStream,
                                              pDDSD,
                                              pMipSet,
                                              pChannelFormat,
@@ -252,130 +253,130 @@ TC_PluginError LoadDDS_RGBA1010102(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
                                              (pDDSD->ddpfPixelFormat.dwRBitMask == 0xffc00000) ? LoopR10G10B10A2 : LoopDefault,
                                              PostLoopDefault);
     pMipSet->m_format             = CMP_FORMAT_RGBA_1010102;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_ABGR32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_ABGR32F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float32, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float32, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
     pMipSet->m_format  = CMP_FORMAT_ARGB_32F;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_GR32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_GR32F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float32, TDT_RG, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float32, TDT_RG, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
     //pMipSet->m_format  = CMP_FORMAT_GR32F;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_R32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_R32F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float32, TDT_R, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float32, TDT_R, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
     //pMipSet->m_format  = CMP_FORMAT_R32F;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_R16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_R16F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_R, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float16, TDT_R, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
     //pMipSet->m_format  = CMP_FORMAT_R16F;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_G16R16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_G16R16F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_RG, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float16, TDT_RG, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
     //pMipSet->m_format  = CMP_FORMAT_G16R16F;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_ABGR16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_ABGR16F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
     pMipSet->m_format  = CMP_FORMAT_ABGR_16F;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_G8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_G8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopG8, LoopG8, PostLoopG8);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopG8, LoopG8, PostLoopG8);
     //pMipSet->m_format  = CMP_FORMAT_G8;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_AG8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_AG8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_ARGB, PreLoopAG8, LoopAG8, PostLoopAG8);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Compressed, TDT_ARGB, PreLoopAG8, LoopAG8, PostLoopAG8);
     //pMipSet->m_format  = CMP_FORMAT_AG8;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_G16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_G16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopG16, LoopG16, PostLoopG16);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopG16, LoopG16, PostLoopG16);
     //pMipSet->m_format  = CMP_FORMAT_G16;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_A8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_ARGB, PreLoopA8, LoopA8, PostLoopA8);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_Compressed, TDT_ARGB, PreLoopA8, LoopA8, PostLoopA8);
     //pMipSet->m_format  = CMP_FORMAT_A8;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_ABGR16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_ABGR16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_ARGB, PreLoopABGR16, LoopABGR16, PostLoopABGR16);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_16bit, TDT_ARGB, PreLoopABGR16, LoopABGR16, PostLoopABGR16);
     pMipSet->m_format  = CMP_FORMAT_ABGR_16;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_G16R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_G16R16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_RG, PreLoopG16R16, LoopABGR16, PostLoopG16R16);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_16bit, TDT_RG, PreLoopG16R16, LoopABGR16, PostLoopG16R16);
     //pMipSet->m_format  = CMP_FORMAT_G16R16;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError LoadDDS_R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_R16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
-    TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_R, PreLoopR16, LoopR16, PostLoopR16);
+    TC_PluginError err = GenericLoadFunction(pStream, pDDSD, pMipSet, extra, CF_16bit, TDT_R, PreLoopR16, LoopR16, PostLoopR16);
     pMipSet->m_format  = CMP_FORMAT_R_16;
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     return err;
 }
 
-TC_PluginError SaveDDS_RGB888(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_RGB888(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -391,7 +392,7 @@ TC_PluginError SaveDDS_RGB888(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwRGBAlphaBitMask = 0x00000000;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
@@ -402,20 +403,20 @@ TC_PluginError SaveDDS_RGB888(FILE* pFile, const MipSet* pMipSet)
             CMP_BYTE* pEnd  = pData + DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_dwLinearSize;
             while (pData < pEnd)
             {
-                fwrite(pData, 3, 1, pFile);
+                CMP_StreamWrite(pStream, pData, 3, 1);
                 pData += 3;
             }
         }
     }
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_ARGB8888(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_ARGB8888(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -432,7 +433,7 @@ TC_PluginError SaveDDS_ARGB8888(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwRGBAlphaBitMask = 0xff000000;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
@@ -453,16 +454,16 @@ TC_PluginError SaveDDS_ARGB8888(FILE* pFile, const MipSet* pMipSet)
                     i += 4;
                 }
             }
-            fwrite(pbData, (DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize), 1, pFile);
+            CMP_StreamWrite(pStream, pbData, (DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize), 1);
         }
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_RGBA8888_S(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_RGBA8888_S(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -482,7 +483,7 @@ TC_PluginError SaveDDS_RGBA8888_S(FILE* pFile, const MipSet* pMipSet)
         ddsd2.ddpfPixelFormat.dwFlags |= DDPF_ALPHAPIXELS;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
@@ -521,19 +522,19 @@ TC_PluginError SaveDDS_RGBA8888_S(FILE* pFile, const MipSet* pMipSet)
                 }
             }
 
-            fwrite(pData, (DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize), 1, pFile);
+            CMP_StreamWrite(pStream, pData, (DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize), 1);
             delete[] pData;
         }
     }
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_ARGB2101010(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_ARGB2101010(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -549,7 +550,7 @@ TC_PluginError SaveDDS_ARGB2101010(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFlags           = DDPF_ALPHAPIXELS | DDPF_RGB;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
@@ -557,19 +558,21 @@ TC_PluginError SaveDDS_ARGB2101010(FILE* pFile, const MipSet* pMipSet)
             if (pMipSet->m_swizzle)
             {
                 // to do swizzle data
-                fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+                CMP_StreamWrite(
+                    pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
             }
             else
-                fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+                CMP_StreamWrite(
+                    pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_ABGR16(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_ABGR16(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -581,21 +584,22 @@ TC_PluginError SaveDDS_ABGR16(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_A16B16G16R16;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_R16(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_R16(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -607,21 +611,22 @@ TC_PluginError SaveDDS_R16(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_L16;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_RG16(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_RG16(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -633,21 +638,22 @@ TC_PluginError SaveDDS_RG16(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_G16R16;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_ABGR16F(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_ABGR16F(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -659,21 +665,22 @@ TC_PluginError SaveDDS_ABGR16F(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_A16B16G16R16F;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_R16F(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_R16F(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -685,21 +692,22 @@ TC_PluginError SaveDDS_R16F(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_R16F;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_RG16F(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_RG16F(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -711,21 +719,22 @@ TC_PluginError SaveDDS_RG16F(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_G16R16F;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_ABGR32F(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_ABGR32F(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -737,21 +746,22 @@ TC_PluginError SaveDDS_ABGR32F(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_A32B32G32R32F;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_R32F(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_R32F(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -763,21 +773,22 @@ TC_PluginError SaveDDS_R32F(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_R32F;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_RG32F(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_RG32F(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     // Initialise surface descriptor
@@ -789,21 +800,22 @@ TC_PluginError SaveDDS_RG32F(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC = D3DFMT_G32R32F;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_FourCC(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_FourCC(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     DDSD2 ddsd2;
@@ -826,21 +838,13 @@ TC_PluginError SaveDDS_FourCC(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwFourCC                = pMipSet->m_dwFourCC;
     ddsd2.ddpfPixelFormat.dwPrivateFormatBitCount = pMipSet->m_dwFourCC2;
 
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
-
-    int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
-    for (int nSlice = 0; nSlice < nSlices; nSlice++)
-        for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
-
-    fclose(pFile);
-
-    return PE_OK;
+    CMP_FileSpan header = {&ddsd2, sizeof(DDSD2)};
+    return SaveDDS_Levels(pStream, pMipSet, &header, 1);
 }
 
-TC_PluginError SaveDDS_G8(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_G8(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     DDSD2 ddsd2;
@@ -852,21 +856,22 @@ TC_PluginError SaveDDS_G8(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwLuminanceBitMask  = 0xff;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveDDS_A8(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveDDS_A8(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    assert(pFile);
+    assert(pStream);
     assert(pMipSet);
 
     DDSD2 ddsd2;
@@ -878,14 +883,15 @@ TC_PluginError SaveDDS_A8(FILE* pFile, const MipSet* pMipSet)
     ddsd2.ddpfPixelFormat.dwRGBAlphaBitMask = 0xff;
 
     // Write the data
-    fwrite(&ddsd2, sizeof(DDSD2), 1, pFile);
+    CMP_StreamWrite(pStream, &ddsd2, sizeof(DDSD2), 1);
 
     int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
     for (int nSlice = 0; nSlice < nSlices; nSlice++)
         for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+            CMP_StreamWrite(
+                pStream, DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1);
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
@@ -574,42 +574,42 @@ static const CMP_DWORD DDS_HEADER = CMP_MAKEFOURCC('D', 'D', 'S', ' ');
 #define DDS_CUBEMAP 0x00000200                  // DDSCAPS2_CUBEMAP
 #define DDS_FLAGS_VOLUME 0x00200000             // DDSCAPS2_VOLUME
 
-TC_PluginError LoadDDS_ABGR32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_ABGR16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_GR32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_R32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_R16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_G16R16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_RGB565(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_RGB888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_RGB8888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha);
-TC_PluginError LoadDDS_RGB8888_S(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha);
-TC_PluginError LoadDDS_ARGB2101010(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_RGBA1010102(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_ABGR16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_G16R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_G8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_G16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_AG8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-
-TC_PluginError SaveDDS_ABGR32F(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_RG32F(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_R32F(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_ABGR16F(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_RG16F(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_R16F(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_ARGB8888(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_RGBA8888_S(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_ARGB2101010(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_ABGR16(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_R16(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_RG16(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_RGB888(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_FourCC(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_G8(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveDDS_A8(FILE* pFile, const MipSet* pMipSet);
+TC_PluginError LoadDDS_ABGR32F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_ABGR16F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_GR32F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_R32F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_R16F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_G16R16F(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_FourCC(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_RGB565(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_RGB888(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_RGB8888(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha);
+TC_PluginError LoadDDS_RGB8888_S(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha);
+TC_PluginError LoadDDS_ARGB2101010(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_RGBA1010102(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_ABGR16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_G16R16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_R16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_G8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_G16(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_AG8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_A8(CMP_Stream* pStream, DDSD2* pDDSD, MipSet* pMipSet);
+
+TC_PluginError SaveDDS_ABGR32F(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_RG32F(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_R32F(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_ABGR16F(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_RG16F(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_R16F(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_ARGB8888(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_RGBA8888_S(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_ARGB2101010(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_ABGR16(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_R16(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_RG16(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_RGB888(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_FourCC(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_G8(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveDDS_A8(CMP_Stream* pStream, const MipSet* pMipSet);
 
 #endif
@@ -29,19 +29,21 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <limits>
+#include <vector>
 
 #include "dds.h"
 #include "dds_file.h"
 #include "dds_helpers.h"
 #include "tc_pluginapi.h"
 #include "version.h"
+#include "cmp_filemap.h"
 
 extern int CMP_MaxFacesOrSlices(const MipSet* pMipSet, int nMipLevel);
-typedef TC_PluginError(PreLoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+typedef TC_PluginError(PreLoopFunction)(CMP_Stream*& pStream, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
 typedef TC_PluginError(
-    LoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-typedef TC_PluginError(PostLoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError GenericLoadFunction(FILE*&           pFile,
+    LoopFunction)(CMP_Stream*& pStream, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+typedef TC_PluginError(PostLoopFunction)(CMP_Stream*& pStream, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError GenericLoadFunction(CMP_Stream*&     pStream,
                                    DDSD2*&          pDDSD,
                                    MipSet*&         pMipSet,
                                    void*&           extra,
@@ -120,7 +122,7 @@ void DetermineTextureType(const DDSD2* pDDSD, MipSet* pMipSet)
     }
 }
 
-TC_PluginError GenericLoadFunction(FILE*&           pFile,
+TC_PluginError GenericLoadFunction(CMP_Stream*&     pStream,
                                    DDSD2*&          pDDSD,
                                    MipSet*&         pMipSet,
                                    void*&           extra,
@@ -145,12 +147,12 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
     else if (pMipSet->m_nMipLevels > pMipSet->m_nMaxMipLevels)
         pMipSet->m_nMipLevels = pMipSet->m_nMaxMipLevels;
 
-    err = fnPreLoop(pFile, pDDSD, pMipSet, extra);
+    err = fnPreLoop(pStream, pDDSD, pMipSet, extra);
     if (err != PE_OK)
         return err;
 
     if (pMipSet->m_dwFourCC)
-        return fnLoop(pFile, pDDSD, pMipSet, extra, 0, 0, pDDSD->dwWidth, pDDSD->dwHeight);
+        return fnLoop(pStream, pDDSD, pMipSet, extra, 0, 0, pDDSD->dwWidth, pDDSD->dwHeight);
     else
     {
         //pMipSet now allocated
@@ -162,7 +164,7 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
                 dwHeight = pDDSD->dwHeight;
                 for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
                 {
-                    err = fnLoop(pFile, pDDSD, pMipSet, extra, nMipLevel, nFace, dwWidth, dwHeight);
+                    err = fnLoop(pStream, pDDSD, pMipSet, extra, nMipLevel, nFace, dwWidth, dwHeight);
                     if (err != PE_OK)
                         return err;
                     dwWidth  = (dwWidth > 1) ? (dwWidth >> 1) : 1;
@@ -179,7 +181,7 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
                 int nMaxSlices = CMP_MaxFacesOrSlices(pMipSet, nMipLevel);
                 for (int nSlice = 0; nSlice < nMaxSlices; nSlice++)
                 {
-                    err = fnLoop(pFile, pDDSD, pMipSet, extra, nMipLevel, nSlice, dwWidth, dwHeight);
+                    err = fnLoop(pStream, pDDSD, pMipSet, extra, nMipLevel, nSlice, dwWidth, dwHeight);
                     if (err != PE_OK)
                         return err;
                 }
@@ -193,15 +195,22 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
             return PE_Unknown;
         }
     }
-    return fnPostLoop(pFile, pDDSD, pMipSet, extra);
+    return fnPostLoop(pStream, pDDSD, pMipSet, extra);
 }
 
-TC_PluginError PreLoopDefault(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PreLoopDefault(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopDefault(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopDefault(CMP_Stream*& pStream,
+                           DDSD2*&,
+                           MipSet*&     pMipSet,
+                           void*&       extra,
+                           int          nMipLevel,
+                           int          nFaceOrSlice,
+                           CMP_DWORD    dwWidth,
+                           CMP_DWORD    dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
 
@@ -212,18 +221,18 @@ TC_PluginError LoopDefault(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopDefault(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopDefault(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
+TC_PluginError PreLoopFourCC(CMP_Stream*& pStream, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
 {
     if (pDDSD->ddpfPixelFormat.dwFourCC == CMP_FOURCC_DXT1 && !(pDDSD->ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS))
         pMipSet->m_TextureDataType = TDT_XRGB;
@@ -234,10 +243,10 @@ TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void
         pMipSet->m_dwFourCC2 = pDDSD->ddpfPixelFormat.dwPrivateFormatBitCount;
 
     // Get Data Size
-    long nCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long nSize = ftell(pFile) - nCurrPos;
-    fseek(pFile, nCurrPos, SEEK_SET);
+    int64_t nCurrPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, 0, SEEK_END);
+    int64_t nSize = CMP_StreamTell(pStream) - nCurrPos;
+    CMP_StreamSeek(pStream, nCurrPos, SEEK_SET);
 
     CMP_DWORD dwWidth;
     CMP_DWORD dwHeight;
@@ -270,7 +279,7 @@ TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void
         break;
     default:
         assert(0);
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         return PE_Unknown;
     }
     //make a DWORD, then cast to void*
@@ -280,7 +289,14 @@ TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void
     return PE_OK;
 }
 
-TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extra*/, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopFourCC(CMP_Stream*& pStream,
+                          DDSD2*&,
+                          MipSet*&     pMipSet,
+                          void*&       /*extra*/,
+                          int          nMipLevel,
+                          int          nFaceOrSlice,
+                          CMP_DWORD    dwWidth,
+                          CMP_DWORD    dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
 
@@ -291,10 +307,34 @@ TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extr
 
     // Get Data Size
     // We need to read everything that we can as we don't know how big each mip-level is
-    long nCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long nSize = ftell(pFile) - nCurrPos;
-    fseek(pFile, nCurrPos, SEEK_SET);
+    int64_t nCurrPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, 0, SEEK_END);
+    int64_t nSize = CMP_StreamTell(pStream) - nCurrPos;
+    CMP_StreamSeek(pStream, nCurrPos, SEEK_SET);
+
+    // Map the data instead of reading it, the pages are only read from the file when the data is first used
+    FILE* pFile = CMP_GetStreamFile(pStream);
+    if (pFile && (pMipSet->m_Flags & MS_FLAG_MapSourceFile) && (nCurrPos >= 0) && (nSize > 0))
+    {
+        CMP_FileMapping* pMapping = CMP_FileMapping::Map(pFile);
+        if (pMapping && ((size_t)nCurrPos + (size_t)nSize <= pMapping->GetSize()))
+        {
+            pMipLevel->m_pbData = pMapping->AdoptRange((size_t)nCurrPos);
+            if (pMipLevel->m_pbData)
+            {
+                pMipLevel->m_dwLinearSize = nSize;
+                pMipLevel->m_nWidth       = dwWidth;
+                pMipLevel->m_nHeight      = dwHeight;
+                pMipSet->m_Flags |= MS_FLAG_MappedLevels;
+            }
+        }
+
+        if (pMapping)
+            pMapping->Release();
+
+        if (pMipLevel->m_pbData)
+            return PE_OK;
+    }
 
     if (!DDS_CMips->AllocateCompressedMipLevelData(pMipLevel, dwWidth, dwHeight, nSize))
     {
@@ -302,7 +342,7 @@ TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extr
     }
 
     //read in the data....
-    if (fread(pMipLevel->m_pbData, nSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, nSize, 1) != 1)
     {
         //Error(PLUGIN_NAME, EL_Error, IDS_ERROR_FILE_OPEN, g_pszFilename);
         return PE_Unknown;
@@ -310,12 +350,12 @@ TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extr
     return PE_OK;
 }
 
-TC_PluginError PostLoopFourCC(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopFourCC(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopRGB565(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
+TC_PluginError PreLoopRGB565(CMP_Stream*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
@@ -326,7 +366,7 @@ TC_PluginError PreLoopRGB565(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& ext
     return extra ? PE_OK : PE_Unknown;
 }
 
-TC_PluginError LoopRGB565(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopRGB565(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     // Allocate the permanent buffer and unpack the bitmap data into it
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
@@ -336,7 +376,7 @@ TC_PluginError LoopRGB565(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra,
         return PE_Unknown;
     }
 
-    if (fread(extra, pMipLevel->m_dwLinearSize / 2, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, extra, pMipLevel->m_dwLinearSize / 2, 1) != 1)
     {
         free(extra);
         return PE_Unknown;
@@ -357,13 +397,13 @@ TC_PluginError LoopRGB565(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra,
     return PE_OK;
 }
 
-TC_PluginError PostLoopRGB565(FILE*&, DDSD2*&, MipSet*&, void*& extra)
+TC_PluginError PostLoopRGB565(CMP_Stream*&, DDSD2*&, MipSet*&, void*& extra)
 {
     free(extra);
     return PE_OK;
 }
 
-TC_PluginError PreLoopRGB888(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
+TC_PluginError PreLoopRGB888(CMP_Stream*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
@@ -374,9 +414,9 @@ TC_PluginError PreLoopRGB888(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& ext
     return extra ? PE_OK : PE_Unknown;
 }
 
-TC_PluginError LoopRGB888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopRGB888(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
-    if (fread(extra, dwWidth * dwHeight * 3, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, extra, dwWidth * dwHeight * 3, 1) != 1)
     {
         free(extra);
         return PE_Unknown;
@@ -410,20 +450,27 @@ TC_PluginError LoopRGB888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra,
     return PE_OK;
 }
 
-TC_PluginError PostLoopRGB888(FILE*&, DDSD2*&, MipSet*&, void*& extra)
+TC_PluginError PostLoopRGB888(CMP_Stream*&, DDSD2*&, MipSet*&, void*& extra)
 {
     free(extra);
     return PE_OK;
 }
 
-TC_PluginError PreLoopRGB8888(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopRGB8888(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopRGB8888(CMP_Stream*& pStream,
+                           DDSD2*&,
+                           MipSet*&     pMipSet,
+                           void*&       extra,
+                           int          nMipLevel,
+                           int          nFaceOrSlice,
+                           CMP_DWORD    dwWidth,
+                           CMP_DWORD    dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
 
@@ -436,7 +483,7 @@ TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra
     if (!(pARGB8888Struct->nFlags & EF_UseBitMasks))
     {
         //not using bitmasks
-        if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+        if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         {
             return PE_Unknown;
         }
@@ -444,7 +491,7 @@ TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra
     else
     {
         //using bitmasks
-        if (fread(pARGB8888Struct->pMemory, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+        if (CMP_StreamRead(pStream, pARGB8888Struct->pMemory, pMipLevel->m_dwLinearSize, 1) != 1)
         {
             return PE_Unknown;
         }
@@ -466,7 +513,14 @@ TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra
     return PE_OK;
 }
 
-TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopRGB8888_S(CMP_Stream*& pStream,
+                             DDSD2*&,
+                             MipSet*&     pMipSet,
+                             void*&       extra,
+                             int          nMipLevel,
+                             int          nFaceOrSlice,
+                             CMP_DWORD    dwWidth,
+                             CMP_DWORD    dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
 
@@ -479,7 +533,7 @@ TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& ext
     if (!(pARGB8888Struct->nFlags & EF_UseBitMasks))
     {
         //not using bitmasks
-        if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+        if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         {
             return PE_Unknown;
         }
@@ -487,7 +541,7 @@ TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& ext
     else
     {
         //using bitmasks
-        if (fread(pARGB8888Struct->pMemory, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+        if (CMP_StreamRead(pStream, pARGB8888Struct->pMemory, pMipLevel->m_dwLinearSize, 1) != 1)
         {
             return PE_Unknown;
         }
@@ -513,19 +567,19 @@ TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& ext
     return PE_OK;
 }
 
-TC_PluginError PostLoopRGB8888(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopRGB8888(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopABGR32F(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopABGR32F(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopABGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopABGR32F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -534,18 +588,18 @@ TC_PluginError LoopABGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopABGR32F(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopABGR32F(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopGR32F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -560,7 +614,7 @@ TC_PluginError LoopGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nM
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pTempData, dwSize, 1) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -582,7 +636,7 @@ TC_PluginError LoopGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nM
     return PE_OK;
 }
 
-TC_PluginError LoopR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR32F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -597,7 +651,7 @@ TC_PluginError LoopR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pTempData, dwSize, 1) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -619,7 +673,7 @@ TC_PluginError LoopR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     return PE_OK;
 }
 
-TC_PluginError LoopR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR16F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -634,7 +688,7 @@ TC_PluginError LoopR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     if (!pTempData)
         return PE_Unknown;
 
-    size_t dwBytesRead = fread(pTempData, 1, dwSize, pFile);
+    size_t dwBytesRead = CMP_StreamRead(pStream, pTempData, 1, dwSize);
     if (dwBytesRead != dwSize)
     {
         free(pTempData);
@@ -657,14 +711,14 @@ TC_PluginError LoopR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     return PE_OK;
 }
 
-TC_PluginError PreLoopABGR16F(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopABGR16F(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopABGR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopABGR16F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -673,25 +727,25 @@ TC_PluginError LoopABGR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopABGR16F(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopABGR16F(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopG8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopG8(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = CMP_FOURCC_G8;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopG8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -700,25 +754,25 @@ TC_PluginError LoopG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipL
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopG8(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopG8(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopAG8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopAG8(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = CMP_FOURCC_AG8;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopAG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopAG8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -727,25 +781,25 @@ TC_PluginError LoopAG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopAG8(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopAG8(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopG16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopG16(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = CMP_FOURCC_G16;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopG16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopG16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -754,25 +808,25 @@ TC_PluginError LoopG16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopG16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopG16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopA8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopA8(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = CMP_FOURCC_A8;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopA8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopA8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -781,25 +835,25 @@ TC_PluginError LoopA8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipL
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopA8(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopA8(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopABGR16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopABGR16(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopABGR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopABGR16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -808,25 +862,25 @@ TC_PluginError LoopABGR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopABGR16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopABGR16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopG16R16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopG16R16(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopG16R16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopG16R16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -841,7 +895,7 @@ TC_PluginError LoopG16R16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pTempData, dwSize, 1) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -863,11 +917,43 @@ TC_PluginError LoopG16R16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     return PE_OK;
 }
 
-TC_PluginError PostLoopG16R16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopG16R16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
+TC_PluginError SaveDDS_Levels(CMP_Stream* pStream, const MipSet* pMipSet, const CMP_FileSpan* pHeaders, size_t nHeaders)
+{
+    std::vector<CMP_FileSpan> spans(pHeaders, pHeaders + nHeaders);
+
+    int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
+    for (int nSlice = 0; nSlice < nSlices; nSlice++)
+    {
+        for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
+        {
+            CMP_FileSpan span;
+            span.pData = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData;
+            span.size  = DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize;
+            if (span.pData && span.size)
+                spans.push_back(span);
+        }
+    }
+
+    // Files take the spans in one gather write, other streams one span at a time
+    bool  bWritten = true;
+    FILE* pFile    = CMP_GetStreamFile(pStream);
+    if (pFile)
+        bWritten = CMP_WriteFileGather(pFile, spans.data(), spans.size());
+    else
+    {
+        for (size_t i = 0; bWritten && (i < spans.size()); i++)
+            bWritten = CMP_StreamWrite(pStream, spans[i].pData, spans[i].size, 1) == 1;
+    }
+    CMP_StreamClose(pStream);
+
+    return bWritten ? PE_OK : PE_Unknown;
+}
+
 bool SetupDDSD(DDSD2& ddsd2, const MipSet* pMipSet, bool bCompressed)
 {
     assert(pMipSet);
@@ -949,14 +1035,14 @@ bool SetupDDSD_DX10(DDSD2& ddsd2, const MipSet* pMipSet, bool /*bCompressed*/)
     return true;
 }
 
-TC_PluginError PreLoopABGR32(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopABGR32(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopABGR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopABGR32(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -965,18 +1051,18 @@ TC_PluginError LoopABGR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopABGR32(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopABGR32(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR32(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -991,7 +1077,7 @@ TC_PluginError LoopR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
     if (!pTempData)
         return PE_Unknown;
 
-    size_t dwBytesRead = fread(pTempData, 1, dwSize, pFile);
+    size_t dwBytesRead = CMP_StreamRead(pStream, pTempData, 1, dwSize);
     if (dwBytesRead != dwSize)
     {
         free(pTempData);
@@ -1014,7 +1100,7 @@ TC_PluginError LoopR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
     return PE_OK;
 }
 
-TC_PluginError LoopR8G8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR8G8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1029,7 +1115,7 @@ TC_PluginError LoopR8G8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pTempData, dwSize, 1) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -1052,7 +1138,7 @@ TC_PluginError LoopR8G8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     return PE_OK;
 }
 
-TC_PluginError LoopR32G32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR32G32(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1067,7 +1153,7 @@ TC_PluginError LoopR32G32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pTempData, dwSize, 1) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -1089,7 +1175,7 @@ TC_PluginError LoopR32G32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     return PE_OK;
 }
 
-TC_PluginError LoopR10G10B10A2(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR10G10B10A2(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1104,7 +1190,7 @@ TC_PluginError LoopR10G10B10A2(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&,
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pTempData, dwSize, 1) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -1125,7 +1211,7 @@ TC_PluginError LoopR10G10B10A2(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&,
     return PE_OK;
 }
 
-TC_PluginError LoopR9G9B9E5(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR9G9B9E5(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1134,13 +1220,13 @@ TC_PluginError LoopR9G9B9E5(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pfData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pMipLevel->m_pfData, pMipLevel->m_dwLinearSize, 1) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError LoopR16G16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR16G16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1155,7 +1241,7 @@ TC_PluginError LoopR16G16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pTempData, dwSize, 1) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -1177,12 +1263,12 @@ TC_PluginError LoopR16G16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     return PE_OK;
 }
 
-TC_PluginError PreLoopR16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PreLoopR16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it, for CMP we are always using RGBA buffer
@@ -1199,7 +1285,7 @@ TC_PluginError LoopR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
     if (!pTempData)
         return PE_Unknown;
 
-    size_t dwBytesRead = fread(pTempData, 1, dwSize, pFile);
+    size_t dwBytesRead = CMP_StreamRead(pStream, pTempData, 1, dwSize);
     if (dwBytesRead != dwSize)
     {
         free(pTempData);
@@ -1223,12 +1309,12 @@ TC_PluginError LoopR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
     return PE_OK;
 }
 
-TC_PluginError PostLoopR16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopR16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopR8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1243,7 +1329,7 @@ TC_PluginError LoopR8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipL
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, pTempData, dwSize, 1) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -30,6 +30,7 @@
 #include "tc_pluginapi.h"
 #include "texture.h"
 #include "dds.h"
+#include "cmp_filemap.h"
 
 typedef struct _ARGB8888Struct
 {
@@ -49,11 +50,11 @@ typedef enum _ExtraFlags
     EF_UseBitMasks = 0x1,
 } ExtraFlags;
 
-typedef TC_PluginError(PreLoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+typedef TC_PluginError(PreLoopFunction)(CMP_Stream*& pStream, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
 typedef TC_PluginError(
-    LoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-typedef TC_PluginError(PostLoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError GenericLoadFunction(FILE*&           pFile,
+    LoopFunction)(CMP_Stream*& pStream, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+typedef TC_PluginError(PostLoopFunction)(CMP_Stream*& pStream, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError GenericLoadFunction(CMP_Stream*&     pStream,
                                    DDSD2*&          pDDSD,
                                    MipSet*&         pMipSet,
                                    void*&           extra,
@@ -65,7 +66,7 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
 
 bool           IsD3D10Format(const MipSet* pMipSet);
 void           DetermineTextureType(const DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError GenericLoadFunction(FILE*&           pFile,
+TC_PluginError GenericLoadFunction(CMP_Stream*&     pStream,
                                    DDSD2*&          pDDSD,
                                    MipSet*&         pMipSet,
                                    void*&           extra,
@@ -74,68 +75,114 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
                                    PreLoopFunction  fnPreLoop,
                                    LoopFunction     fnLoop,
                                    PostLoopFunction fnPostLoop);
-TC_PluginError PreLoopDefault(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError LoopDefault(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopDefault(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extra*/, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopFourCC(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopRGB565(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError LoopRGB565(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopRGB565(FILE*&, DDSD2*&, MipSet*&, void*& extra);
-TC_PluginError PreLoopRGB888(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError LoopRGB888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopRGB888(FILE*&, DDSD2*&, MipSet*&, void*& extra);
-TC_PluginError PreLoopRGB8888(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopRGB8888(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopABGR32F(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopABGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopABGR32F(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError LoopGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PreLoopABGR16F(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopABGR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopABGR16F(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopG8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopG8(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopAG8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopAG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopAG8(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopG16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopG16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopG16(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopA8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopA8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopA8(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopABGR16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopABGR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopABGR16(FILE*&, DDSD2*&, MipSet*&, void*&);
-
-TC_PluginError PreLoopG16R16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopG16R16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopG16R16(FILE*&, DDSD2*&, MipSet*&, void*&);
-
-TC_PluginError PreLoopABGR32(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopABGR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopABGR32(FILE*&, DDSD2*&, MipSet*&, void*&);
-
-TC_PluginError LoopR32G32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR10G10B10A2(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR9G9B9E5(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-
-TC_PluginError LoopR16G16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR8G8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-
-TC_PluginError PreLoopR16(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError LoopR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopR16(FILE*&, DDSD2*&, MipSet*&, void*&);
-
-TC_PluginError LoopR8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PreLoopDefault(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError LoopDefault(CMP_Stream*& pStream,
+                           DDSD2*&,
+                           MipSet*&     pMipSet,
+                           void*&       extra,
+                           int          nMipLevel,
+                           int          nFaceOrSlice,
+                           CMP_DWORD    dwWidth,
+                           CMP_DWORD    dwHeight);
+TC_PluginError PostLoopDefault(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopFourCC(CMP_Stream*& pStream, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError LoopFourCC(CMP_Stream*& pStream,
+                          DDSD2*&,
+                          MipSet*&     pMipSet,
+                          void*&       /*extra*/,
+                          int          nMipLevel,
+                          int          nFaceOrSlice,
+                          CMP_DWORD    dwWidth,
+                          CMP_DWORD    dwHeight);
+TC_PluginError PostLoopFourCC(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopRGB565(CMP_Stream*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError LoopRGB565(CMP_Stream*& pStream,
+                          DDSD2*&,
+                          MipSet*&     pMipSet,
+                          void*&       extra,
+                          int          nMipLevel,
+                          int          nFaceOrSlice,
+                          CMP_DWORD    dwWidth,
+                          CMP_DWORD    dwHeight);
+TC_PluginError PostLoopRGB565(CMP_Stream*&, DDSD2*&, MipSet*&, void*& extra);
+TC_PluginError PreLoopRGB888(CMP_Stream*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError LoopRGB888(CMP_Stream*& pStream,
+                          DDSD2*&,
+                          MipSet*&     pMipSet,
+                          void*&       extra,
+                          int          nMipLevel,
+                          int          nFaceOrSlice,
+                          CMP_DWORD    dwWidth,
+                          CMP_DWORD    dwHeight);
+TC_PluginError PostLoopRGB888(CMP_Stream*&, DDSD2*&, MipSet*&, void*& extra);
+TC_PluginError PreLoopRGB8888(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopRGB8888(CMP_Stream*& pStream,
+                           DDSD2*&,
+                           MipSet*&     pMipSet,
+                           void*&       extra,
+                           int          nMipLevel,
+                           int          nFaceOrSlice,
+                           CMP_DWORD    dwWidth,
+                           CMP_DWORD    dwHeight);
+TC_PluginError LoopRGB8888_S(CMP_Stream*& pStream,
+                             DDSD2*&,
+                             MipSet*&     pMipSet,
+                             void*&       extra,
+                             int          nMipLevel,
+                             int          nFaceOrSlice,
+                             CMP_DWORD    dwWidth,
+                             CMP_DWORD    dwHeight);
+TC_PluginError PostLoopRGB8888(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopABGR32F(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopABGR32F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopABGR32F(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError LoopGR32F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR32F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR16F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PreLoopABGR16F(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopABGR16F(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopABGR16F(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopG8(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopG8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopG8(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopAG8(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopAG8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopAG8(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopG16(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopG16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopG16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopA8(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopA8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopA8(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopABGR16(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopABGR16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopABGR16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+
+TC_PluginError PreLoopG16R16(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopG16R16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopG16R16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+
+TC_PluginError PreLoopABGR32(CMP_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopABGR32(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopABGR32(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+
+TC_PluginError LoopR32G32(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR10G10B10A2(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR9G9B9E5(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+
+TC_PluginError LoopR16G16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR32(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR8G8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+
+TC_PluginError PreLoopR16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError LoopR16(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopR16(CMP_Stream*&, DDSD2*&, MipSet*&, void*&);
+
+TC_PluginError LoopR8(CMP_Stream*& pStream, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+
+// Writes the headers and then the data of every level with gather writes and closes the file, for data that is
+// saved as it is in memory
+TC_PluginError SaveDDS_Levels(CMP_Stream* pStream, const MipSet* pMipSet, const CMP_FileSpan* pHeaders, size_t nHeaders);
 
 bool SetupDDSD(DDSD2& ddsd2, const MipSet* pMipSet, bool bCompressed);
 bool SetupDDSD_DX10(DDSD2& ddsd2, const MipSet* pMipSet, bool bCompressed);
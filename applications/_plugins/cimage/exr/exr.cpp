@@ -86,6 +86,7 @@ IMath.lib;Half.lib;IlmImf.lib;IlmThread.lib;Iex.lib;zlibstatic_d.lib;
 #include <ImfPixelType.h>
 #include <ImathFun.h>
 #include <ImfDeepFrameBuffer.h>
+#include <ImfStdIO.h>
 #pragma warning(pop)
 
 #include "common.h"
@@ -258,9 +259,10 @@ bool allocateMipSet(Array<Rgba>& pixels, MipSet* pMipSet, int w, int h)
     return true;
 }
 
-int loadImage(const char fileName[], const char layer[], Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
+int loadImage(IStream& is, const char layer[], Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
 {
-    MultiPartInputFile inmaster(fileName);
+    is.seekg(0);
+    MultiPartInputFile inmaster(is);
     InputPart          in(inmaster, 0);
     header = in.header();
 
@@ -273,8 +275,8 @@ int loadImage(const char fileName[], const char layer[], Header& header, Array<R
         int           width, height;
         int           w, h;
 
-        Exr::fileinfo(fileName, width, height);
-        Exr::readRgba(fileName, pixels, w, h);
+        Exr::fileinfo(is, width, height);
+        Exr::readRgba(is, pixels, w, h);
 
         CMP_Texture srcTexture;
         srcTexture.dwSize     = sizeof(CMP_Texture);
@@ -388,9 +390,10 @@ int loadImage(const char fileName[], const char layer[], Header& header, Array<R
     return PE_OK;
 }
 
-int loadTiledImage(const char fileName[], const char layer[], int lx, int ly, Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
+int loadTiledImage(IStream& is, const char layer[], int lx, int ly, Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
 {
-    MultiPartInputFile inmaster(fileName);
+    is.seekg(0);
+    MultiPartInputFile inmaster(is);
     TiledInputPart     in(inmaster, 0);
     header = in.header();
 
@@ -405,7 +408,7 @@ int loadTiledImage(const char fileName[], const char layer[], int lx, int ly, He
         std::cout << "Level (" << lx << ", " << ly
                   << ") does "
                      "not exist in part "
-                  << 0 << " of file " << fileName << "." << std::endl;
+                  << 0 << " of file " << is.fileName() << "." << std::endl;
         return PE_Unknown;
     }
     else
@@ -521,9 +524,10 @@ int loadTiledImage(const char fileName[], const char layer[], int lx, int ly, He
     return PE_OK;
 }
 
-int loadPreviewImage(const char fileName[], Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
+int loadPreviewImage(IStream& is, Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
 {
-    MultiPartInputFile inmaster(fileName);
+    is.seekg(0);
+    MultiPartInputFile inmaster(is);
     InputPart          in(inmaster, 0);
     header = in.header();
 
@@ -575,9 +579,10 @@ int loadPreviewImage(const char fileName[], Header& header, Array<Rgba>& pixels,
     return PE_OK;
 }
 
-int loadImageChannel(const char fileName[], const char channelName[], Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
+int loadImageChannel(IStream& is, const char channelName[], Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
 {
-    MultiPartInputFile inmaster(fileName);
+    is.seekg(0);
+    MultiPartInputFile inmaster(is);
     InputPart          in(inmaster, 0);
 
     header = in.header();
@@ -631,7 +636,7 @@ int loadImageChannel(const char fileName[], const char channelName[], Header& he
     }
     else
     {
-        std::cerr << "Image file \"" << fileName
+        std::cerr << "Image file \"" << is.fileName()
                   << "\" has no "
                      "channel named \""
                   << channelName << "\"." << std::endl;
@@ -648,9 +653,10 @@ int loadImageChannel(const char fileName[], const char channelName[], Header& he
     return PE_OK;
 }
 
-int loadTiledImageChannel(const char fileName[], const char channelName[], int lx, int ly, Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
+int loadTiledImageChannel(IStream& is, const char channelName[], int lx, int ly, Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
 {
-    MultiPartInputFile inmaster(fileName);
+    is.seekg(0);
+    MultiPartInputFile inmaster(is);
     TiledInputPart     in(inmaster, 0);
 
     if (!in.isValidLevel(lx, ly))
@@ -658,7 +664,7 @@ int loadTiledImageChannel(const char fileName[], const char channelName[], int l
         std::cerr << "Level (" << lx << ", " << ly
                   << ") does "
                      "not exist in file "
-                  << fileName << ".";
+                  << is.fileName() << ".";
         return PE_Unknown;
     }
 
@@ -736,7 +742,7 @@ int loadTiledImageChannel(const char fileName[], const char channelName[], int l
     }
     else
     {
-        std::cerr << "Image file \"" << fileName << "\" part " << 0
+        std::cerr << "Image file \"" << is.fileName() << "\" part " << 0
                   << " "
                      "has no channel named \""
                   << channelName << "\"." << std::endl;
@@ -1114,11 +1120,9 @@ int loadDeepTileImage(MultiPartInputFile&  inmaster,
     return PE_OK;
 }
 
-int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+// Loads the image that starts at position 0 of is
+static int LoadEXR(IStream& is, MipSet* pMipSet)
 {
-    if (!CMP_FileExists(pszFilename))
-        return -1;
-
     // uncomment the flag below to disable EXR mipmap loading / load only level 0
     // pMipSet->m_Flags |= MS_FLAG_DisableMipMapping;
 
@@ -1127,7 +1131,8 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     int miplevels = 1;
     try
     {
-        TiledRgbaInputFile file(pszFilename);
+        is.seekg(0);
+        TiledRgbaInputFile file(is);
         if (!file.isComplete())
             return PE_Unknown;
 
@@ -1190,15 +1195,16 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     {
         try
         {
+            is.seekg(0);
             int                 numparts = 0;
-            MultiPartInputFile* infile   = new MultiPartInputFile(pszFilename);
+            MultiPartInputFile* infile   = new MultiPartInputFile(is);
             numparts                     = infile->parts();
             delete infile;
         }
         catch (IEX_NAMESPACE::BaseExc& e)
         {
             if (EXR_CMips)
-                EXR_CMips->PrintError(e.what());
+                EXR_CMips->PrintError("%s\n", e.what());
             return PE_Unknown;
         }
     }
@@ -1216,7 +1222,8 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     int                 zsize    = 0;
 
     //loadImage
-    MultiPartInputFile inmaster(pszFilename);
+    is.seekg(0);
+    MultiPartInputFile inmaster(is);
     Header             h    = inmaster.header(0);
     std::string        type = h.type();
 
@@ -1231,29 +1238,32 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
 
     else if (preview)
     {
-        loadPreviewImage(pszFilename, header, pixels, pMipSet);
+        loadPreviewImage(is, header, pixels, pMipSet);
     }
     else
     {
         if (channel)
         {
-            loadImageChannel(pszFilename, channel, header, pixels, pMipSet);
+            loadImageChannel(is, channel, header, pixels, pMipSet);
         }
         else
         {
-            loadImage(pszFilename, layer, header, pixels, pMipSet);
+            loadImage(is, layer, header, pixels, pMipSet);
         }
     }
     return PE_OK;
 }
 
-int Plugin_EXR::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+// Writes the image to os, which is empty
+static int SaveEXR(OStream& os, MipSet* pMipSet)
 {
     if (!TC_PluginFileSupportsFormat(NULL, pMipSet))
     {
         if (EXR_CMips)
-            EXR_CMips->PrintError(
-                "Error(%d): EXR Plugin ID(%d) Filename=%s\n unsupported format, EXR only support 16F type.", EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, pszFilename);
+            EXR_CMips->PrintError("Error(%d): EXR Plugin ID(%d) Filename=%s\n unsupported format, EXR only support 16F type.",
+                                  EL_Error,
+                                  IDS_ERROR_UNSUPPORTED_TYPE,
+                                  os.fileName());
         return PE_Unknown;
     }
 
@@ -1266,18 +1276,17 @@ int Plugin_EXR::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
         int           image_height = pMipSet->m_nHeight;
         Array2D<Rgba> pixels(image_height, image_width);
         pixels.resizeErase(image_height, image_width);
-        string sFile = pszFilename;
 
         CMP_HALFSHORT* data = EXR_CMips->GetMipLevel(pMipSet, 0)->m_phfsData;
 
         Texture2Rgba(data, pixels, image_width, image_height, pMipSet->m_isDeCompressed);
 
-        Exr::writeRgba(sFile, pixels, image_width, image_height);
+        Exr::writeRgba(os, pixels, image_width, image_height);
     }
     // Save Muliple MIP levels as TiledRGB
     else
     {
-        TiledRgbaOutputFile file(pszFilename, pMipSet->m_nWidth, pMipSet->m_nHeight, TILE_WIDTH, TILE_HEIGHT, levelMode, ROUND_DOWN);
+        TiledRgbaOutputFile file(os, Header(pMipSet->m_nWidth, pMipSet->m_nHeight), WRITE_RGBA, TILE_WIDTH, TILE_HEIGHT, levelMode, ROUND_DOWN);
         for (int i = 0; i < file.numLevels(); i++)
         {
             Array2D<Rgba> pixels(file.levelHeight(i), file.levelWidth(i));
@@ -1299,6 +1308,51 @@ int Plugin_EXR::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
     return PE_OK;
 }
 
+int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    if (!CMP_FileExists(pszFilename))
+        return -1;
+
+    StdIFStream is(pszFilename);
+    return LoadEXR(is, pMipSet);
+}
+
+int Plugin_EXR::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    StdOFStream os(pszFilename);
+    return SaveEXR(os, pMipSet);
+}
+
+int Plugin_EXR::TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    try
+    {
+        Exr_IStream is(pStream, "stream");
+        return LoadEXR(is, pMipSet);
+    }
+    catch (IEX_NAMESPACE::BaseExc& e)
+    {
+        if (EXR_CMips)
+            EXR_CMips->PrintError("%s\n", e.what());
+        return PE_Unknown;
+    }
+}
+
+int Plugin_EXR::TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    try
+    {
+        Exr_OStream os(pStream, "stream");
+        return SaveEXR(os, pMipSet);
+    }
+    catch (IEX_NAMESPACE::BaseExc& e)
+    {
+        if (EXR_CMips)
+            EXR_CMips->PrintError("%s\n", e.what());
+        return PE_Unknown;
+    }
+}
+
 bool TC_PluginFileSupportsFormat(const HFILETYPE, const MipSet* pMipSet)
 {
     assert(pMipSet);
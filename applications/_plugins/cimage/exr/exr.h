@@ -60,6 +60,8 @@ public:
     int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet);
     int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture);
     int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture);
+    int TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet);
+    int TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet);
 };
 
 extern void* make_Plugin_EXR();
@@ -385,25 +385,19 @@ static void copy_scanline(void* dst, const void* src, int pixels, int method)
     };
 }
 
-int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+// Loads from the current position of pStream and closes it, pszFilename only names the source in errors
+static int LoadKTX(CMP_Stream* pStream, MipSet* pMipSet, const char* pszFilename)
 {
-    FILE* pFile = NULL;
-    pFile       = fopen(pszFilename, ("rb"));
-    if (pFile == NULL)
-    {
-        if (KTX_CMips)
-            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) opening file = %s \n"), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
-        return -1;
-    }
+    int64_t nStart = CMP_StreamTell(pStream);
 
     //using libktx
     KTX_header  fheader;
     KTX_texinfo texinfo;
-    if (fread(&fheader, sizeof(KTX_header), 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, &fheader, sizeof(KTX_header), 1) != 1)
     {
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) invalid KTX header. Filename = %s \n"), EL_Error, IDS_ERROR_NOT_KTX, pszFilename);
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         return -1;
     }
 
@@ -411,7 +405,7 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     {
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) invalid KTX header. Filename = %s \n"), EL_Error, IDS_ERROR_NOT_KTX, pszFilename);
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         return -1;
     }
 
@@ -622,7 +616,7 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         default:
             if (KTX_CMips)
                 KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) unsupported GL format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.glFormat);
-            fclose(pFile);
+            CMP_StreamClose(pStream);
             return -1;
         }
     }
@@ -742,7 +736,7 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         default:
             if (KTX_CMips)
                 KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) unsupported GL format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.glFormat);
-            fclose(pFile);
+            CMP_StreamClose(pStream);
             return -1;
         }
     }
@@ -761,7 +755,7 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     default:
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) unsupported texture format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, texinfo.glTarget);
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         return -1;
     }
 
@@ -771,7 +765,7 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     //{
     //    if (KTX_CMips)
     //        KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) array textures not supported %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.numberOfArrayElements);
-    //    fclose(pFile);
+    //    CMP_StreamClose(pStream);
     //    return -1;
     //}
 
@@ -797,26 +791,16 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         pMipSet->m_nMipLevels = pMipSet->m_nMaxMipLevels;
     }
 
-    fclose(pFile);
-    pFile = NULL;
-    pFile = fopen(pszFilename, "rb");
-    if (pFile == NULL)
-    {
-        if (KTX_CMips)
-            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) loading file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
-        return -1;
-    }
-
     //skip key value data
     int imageSizeOffset = sizeof(KTX_header) + fheader.bytesOfKeyValueData;
-    if (fseek(pFile, imageSizeOffset, SEEK_SET))
+    if (CMP_StreamSeek(pStream, nStart + imageSizeOffset, SEEK_SET))
     {
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) Seek past key/vals in KTX compressed bitmap file failed. Format %x\n"),
                                   EL_Error,
                                   IDS_ERROR_UNSUPPORTED_TYPE,
                                   fheader.glFormat);
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         return -1;
     }
 
@@ -834,13 +818,13 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         if ((w <= 0) || (h <= 0))
             break;
 
-        totalByteRead = fread(&faceSize, 1, sizeof(khronos_uint32_t), pFile);
+        totalByteRead = CMP_StreamRead(pStream, &faceSize, 1, sizeof(khronos_uint32_t));
         if (totalByteRead == 0)
         {
             if (KTX_CMips)
                 KTX_CMips->PrintError(
                     ("Error(%d): KTX Plugin ID(%d) Read image data size failed. Format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.glFormat);
-            fclose(pFile);
+            CMP_StreamClose(pStream);
             return -1;
         }
         if (fheader.endianness == KTX_ENDIAN_REF_REV)
@@ -927,7 +911,7 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
                                           EL_Error,
                                           IDS_ERROR_UNSUPPORTED_TYPE,
                                           fheader.glFormat);
-                fclose(pFile);
+                CMP_StreamClose(pStream);
                 return -1;
             }
 
@@ -936,13 +920,13 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
             //size to be read has to be same as face size, else padding is done in the KTX file
             if (sizeTobeRead == faceSizeRounded)
             {
-                bytesRead = fread(pData, 1, faceSizeRounded, pFile);
+                bytesRead = CMP_StreamRead(pStream, pData, 1, faceSizeRounded);
             }
             else if (faceSizeRounded > sizeTobeRead)  // padding in KTX file
             {
                 std::vector<CMP_BYTE> pTempData;
                 pTempData.resize(faceSizeRounded);
-                bytesRead       = fread(pTempData.data(), 1, faceSizeRounded, pFile);
+                bytesRead       = CMP_StreamRead(pStream, pTempData.data(), 1, faceSizeRounded);
                 int paddedBytes = faceSizeRounded - sizeTobeRead;
 
                 int n = 0;
@@ -967,7 +951,7 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
                                           EL_Error,
                                           IDS_ERROR_UNSUPPORTED_TYPE,
                                           fheader.glFormat);
-                fclose(pFile);
+                CMP_StreamClose(pStream);
                 return -1;
             }
         }
@@ -979,20 +963,9 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     return 0;
 }
 
-int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+// Saves at the current position of pStream and closes it, pszFilename only names the destination in errors
+static int SaveKTX(CMP_Stream* pStream, MipSet* pMipSet, const char* pszFilename)
 {
-    assert(pszFilename);
-    assert(pMipSet);
-
-    FILE* pFile = fopen(pszFilename, "wb");
-
-    if (pFile == NULL)
-    {
-        if (KTX_CMips)
-            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
-        return -1;
-    }
-
     //using libktx
     KTX_texture_info textureinfo;
     KTX_image_info*  inputMip = new KTX_image_info[pMipSet->m_nMipLevels];
@@ -1014,7 +987,7 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_ALLOCATEMIPSET, pszFilename);
 
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         delete[] inputMip;
 
         return -1;
@@ -1025,7 +998,7 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_ALLOCATEMIPSET, pszFilename);
 
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         delete[] inputMip;
 
         return -1;
@@ -1369,9 +1342,24 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
 
     textureinfo.numberOfMipmapLevels = pMipSet->m_nMipLevels;
 
-    KTX_error_code save = ktxWriteKTXF(pFile, &textureinfo, pDataLen, pData, pMipSet->m_nMipLevels, inputMip);
+    // Files are written by libktx directly, other streams get the file libktx builds in memory
+    KTX_error_code save;
+    FILE*          pFile = CMP_GetStreamFile(pStream);
+    if (pFile)
+    {
+        save = ktxWriteKTXF(pFile, &textureinfo, pDataLen, pData, pMipSet->m_nMipLevels, inputMip);
+    }
+    else
+    {
+        unsigned char* pBytes = NULL;
+        GLsizei        nBytes = 0;
+        save                  = ktxWriteKTXM(&pBytes, &nBytes, &textureinfo, pDataLen, pData, pMipSet->m_nMipLevels, inputMip);
+        if ((save == KTX_SUCCESS) && nBytes && (CMP_StreamWrite(pStream, pBytes, nBytes, 1) != 1))
+            save = KTX_FILE_WRITE_ERROR;
+        free(pBytes);
+    }
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
     delete[] inputMip;
 
     if (save != KTX_SUCCESS)
@@ -1384,3 +1372,56 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
 
     return 0;
 }
+
+int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    FILE* pFile = NULL;
+    pFile       = fopen(pszFilename, ("rb"));
+    if (pFile == NULL)
+    {
+        if (KTX_CMips)
+            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) opening file = %s \n"), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    CMP_Stream stream;
+    CMP_InitFileStream(&stream, pFile);
+
+    int result = LoadKTX(&stream, pMipSet, pszFilename);
+    CMP_StreamClose(&stream);
+    return result;
+}
+
+int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    assert(pszFilename);
+    assert(pMipSet);
+
+    FILE* pFile = fopen(pszFilename, "wb");
+
+    if (pFile == NULL)
+    {
+        if (KTX_CMips)
+            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    CMP_Stream stream;
+    CMP_InitFileStream(&stream, pFile);
+
+    int result = SaveKTX(&stream, pMipSet, pszFilename);
+    CMP_StreamClose(&stream);
+    return result;
+}
+
+int Plugin_KTX::TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    return LoadKTX(pStream, pMipSet, "stream");
+}
+
+int Plugin_KTX::TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    assert(pMipSet);
+
+    return SaveKTX(pStream, pMipSet, "stream");
+}
@@ -38,6 +38,7 @@
 #include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 
 #include "gl_format.h"
 #pragma comment(lib, "opengl32.lib")  // Open GL
@@ -104,7 +105,8 @@ int Plugin_KTX2::TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture*
     return -1;
 }
 
-int Plugin_KTX2::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+// Loads pszFilename, or the rest of pStream when that is not NULL and pszFilename only names the source in errors
+static int LoadKTX2(CMP_Stream* pStream, MipSet* pMipSet, const char* pszFilename)
 {
     ktxTexture2* texture2 = nullptr;
     ktxTexture*  texture  = nullptr;
@@ -115,7 +117,15 @@ int Plugin_KTX2::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipS
     ktx_uint32_t   glType;
     ktx_uint32_t   glFormat;
 
-    loadStatus = ktxTexture2_CreateFromNamedFile(pszFilename, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture2);
+    if (pStream)
+    {
+        // libktx copies the image data out of the buffer
+        std::vector<CMP_BYTE> data;
+        CMP_StreamReadAll(pStream, data);
+        loadStatus = ktxTexture2_CreateFromMemory(data.data(), data.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture2);
+    }
+    else
+        loadStatus = ktxTexture2_CreateFromNamedFile(pszFilename, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture2);
     if (loadStatus != KTX_SUCCESS)
     {
         if (KTX2_CMips)
@@ -643,10 +653,95 @@ int Plugin_KTX2::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipS
     return 0;
 }
 
-int Plugin_KTX2::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+static void AppendKTX2Value(std::vector<ktx_uint8_t>& data, const void* pValue, size_t size)
+{
+    const ktx_uint8_t* pBytes = static_cast<const ktx_uint8_t*>(pValue);
+    data.insert(data.end(), pBytes, pBytes + size);
+}
+
+static void AppendKTX2Value(std::vector<ktx_uint8_t>& data, ktx_uint32_t value)
+{
+    AppendKTX2Value(data, &value, sizeof(value));
+}
+
+static void AppendKTX2Value(std::vector<ktx_uint8_t>& data, ktx_uint64_t value)
+{
+    AppendKTX2Value(data, &value, sizeof(value));
+}
+
+// Writes a single level block compressed texture up to its level data: header, level index, DFD and key/value data,
+// padded so that the level data written after it by the caller is aligned as the KTX2 specification requires.
+// libktx only writes whole textures, so this is laid out here with the DFD libktx makes for the format.
+static int SaveKTX2Header(CMP_Stream* pStream, const MipSet* pMipSet, ktxTextureCreateInfo* pCreateInfo, const char* pszFilename)
+{
+    static const ktx_uint8_t ktx2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    ktxTexture2*   texture2     = nullptr;
+    KTX_error_code createStatus = ktxTexture2_Create(pCreateInfo, KTX_TEXTURE_CREATE_NO_STORAGE, &texture2);
+    if (createStatus != KTX_SUCCESS)
+    {
+        KTX2_CMips->PrintError("Error(%d): Create status KTX2 Plugin on saving file = %s \n", createStatus, pszFilename);
+        return -1;
+    }
+
+    std::stringstream writer;
+    writeId2(writer);
+
+    std::vector<ktx_uint8_t> kvd;
+    std::string              key   = KTX_WRITER_KEY;
+    std::string              value = writer.str();
+    AppendKTX2Value(kvd, (ktx_uint32_t)(key.length() + 1 + value.length() + 1));
+    AppendKTX2Value(kvd, key.c_str(), key.length() + 1);
+    AppendKTX2Value(kvd, value.c_str(), value.length() + 1);
+    kvd.resize((kvd.size() + 3) & ~(size_t)3, 0);
+
+    // 80 byte header then one 24 byte level index entry, the level data offset is a multiple of lcm(block size, 4)
+    ktx_uint32_t dfdOffset   = 80 + 24;
+    ktx_uint32_t dfdLength   = texture2->pDfd[0];
+    ktx_uint32_t kvdOffset   = dfdOffset + dfdLength;
+    ktx_uint32_t kvdLength   = (ktx_uint32_t)kvd.size();
+    ktx_uint64_t levelOffset = ((ktx_uint64_t)kvdOffset + kvdLength + 15) & ~(ktx_uint64_t)15;
+    ktx_uint64_t levelLength = KTX2_CMips->GetMipLevel(pMipSet, 0)->m_dwLinearSize;
+
+    std::vector<ktx_uint8_t> header;
+    AppendKTX2Value(header, ktx2Identifier, sizeof(ktx2Identifier));
+    AppendKTX2Value(header, (ktx_uint32_t)texture2->vkFormat);
+    AppendKTX2Value(header, (ktx_uint32_t)1);  // typeSize of block compressed formats
+    AppendKTX2Value(header, (ktx_uint32_t)pCreateInfo->baseWidth);
+    AppendKTX2Value(header, (ktx_uint32_t)pCreateInfo->baseHeight);
+    AppendKTX2Value(header, (ktx_uint32_t)0);  // pixelDepth
+    AppendKTX2Value(header, (ktx_uint32_t)0);  // layerCount
+    AppendKTX2Value(header, (ktx_uint32_t)1);  // faceCount
+    AppendKTX2Value(header, (ktx_uint32_t)1);  // levelCount
+    AppendKTX2Value(header, (ktx_uint32_t)0);  // supercompressionScheme
+    AppendKTX2Value(header, dfdOffset);
+    AppendKTX2Value(header, dfdLength);
+    AppendKTX2Value(header, kvdOffset);
+    AppendKTX2Value(header, kvdLength);
+    AppendKTX2Value(header, (ktx_uint64_t)0);  // sgdByteOffset
+    AppendKTX2Value(header, (ktx_uint64_t)0);  // sgdByteLength
+    AppendKTX2Value(header, levelOffset);
+    AppendKTX2Value(header, levelLength);
+    AppendKTX2Value(header, levelLength);  // uncompressedByteLength
+    AppendKTX2Value(header, texture2->pDfd, dfdLength);
+    AppendKTX2Value(header, kvd.data(), kvd.size());
+    header.resize((size_t)levelOffset, 0);
+
+    ktxTexture_Destroy(ktxTexture(texture2));
+
+    if (CMP_StreamWrite(pStream, header.data(), header.size(), 1) != 1)
+    {
+        KTX2_CMips->PrintError("Error: KTX2 Plugin on saving header = %s \n", pszFilename);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Saves to pszFilename, or to pStream when that is not NULL and pszFilename only names the destination in errors.
+// A single level without data saves the header alone, see SaveKTX2Header.
+static int SaveKTX2(CMP_Stream* pStream, MipSet* pMipSet, const char* pszFilename)
 {
-    assert(pszFilename);
-    assert(pMipSet);
     assert(pszFilename);
     assert(pMipSet);
 
@@ -1033,6 +1128,10 @@ int Plugin_KTX2::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipS
         return -1;
     }
 
+    if (pStream && (pMipSet->m_nMipLevels == 1) && isCompressed && (pMipSet->m_format != CMP_FORMAT_BASIS) &&
+        (KTX2_CMips->GetMipLevel(pMipSet, 0)->m_pbData == NULL))
+        return SaveKTX2Header(pStream, pMipSet, &textureCreateInfo, pszFilename);
+
     ktxTexture2* texture2 = nullptr;
     ktxTexture*  texture  = nullptr;
 
@@ -1096,6 +1195,24 @@ int Plugin_KTX2::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipS
     writeId2(writer);
     ktxHashList_AddKVPair(&texture->kvDataHead, KTX_WRITER_KEY, (ktx_uint32_t)writer.str().length() + 1, writer.str().c_str());
 
+    if (pStream)
+    {
+        ktx_uint8_t*   pBytes = NULL;
+        ktx_size_t     nBytes = 0;
+        KTX_error_code save   = ktxTexture_WriteToMemory(texture, &pBytes, &nBytes);
+        if ((save == KTX_SUCCESS) && nBytes && (CMP_StreamWrite(pStream, pBytes, nBytes, 1) != 1))
+            save = KTX_FILE_WRITE_ERROR;
+        free(pBytes);
+
+        if (save != KTX_SUCCESS)
+        {
+            KTX2_CMips->PrintError("Error(%d): WriteToMemory KTX2 Plugin on saving file = %s \n", save, pszFilename);
+            return -1;
+        }
+
+        return 0;
+    }
+
     KTX_error_code save = ktxTexture_WriteToNamedFile(texture, pszFilename);
     if (save != KTX_SUCCESS)
     {
@@ -1105,3 +1222,25 @@ int Plugin_KTX2::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipS
 
     return 0;
 }
+
+int Plugin_KTX2::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    return LoadKTX2(NULL, pMipSet, pszFilename);
+}
+
+int Plugin_KTX2::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    assert(pszFilename);
+
+    return SaveKTX2(NULL, pMipSet, pszFilename);
+}
+
+int Plugin_KTX2::TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    return LoadKTX2(pStream, pMipSet, "stream");
+}
+
+int Plugin_KTX2::TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    return SaveKTX2(pStream, pMipSet, "stream");
+}
@@ -25,6 +25,7 @@
 #define _PLUGIN_IMAGE_KTX2_H
 
 #include "cmp_plugininterface.h"
+#include "cmp_stream.h"
 #include "stdint.h"
 #include "ktx.h"
 #include "ktxint.h"
@@ -52,6 +53,8 @@ public:
     int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet);
     int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture);
     int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture);
+    int TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet);
+    int TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet);
 };
 
 struct CMP_DFD
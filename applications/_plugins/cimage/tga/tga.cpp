@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 #include "tc_pluginapi.h"
 #include "tc_plugininternal.h"
 #include "compressonator.h"
@@ -94,62 +95,52 @@ int Plugin_TGA::TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* s
 #endif
 #include "stb_image.h"
 
-int Plugin_TGA::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+// Loads from the current position of pStream and closes it, pszFilename only names the source in errors
+static int LoadTGA(CMP_Stream* pStream, MipSet* pMipSet, const char* pszFilename)
 {
-    CMP_CMIPS lCMips;
-    if (!TGA_CMips)
-    {
-        TGA_CMips = &lCMips;
-    }
-
-    // ATI code
-    FILE* pFile = NULL;
-    pFile       = fopen(pszFilename, ("rb"));
-    if (pFile == NULL)
-    {
-        if (TGA_CMips)
-            TGA_CMips->PrintError(("Error(%d): TGA Plugin ID(%d) opening file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
-        return -1;
-    }
+    int64_t nStart = CMP_StreamTell(pStream);
 
     // Read the header
     TGAHeader header;
-    if (fread(&header, sizeof(TGAHeader), 1, pFile) != 1)
+    if (CMP_StreamRead(pStream, &header, sizeof(TGAHeader), 1) != 1)
     {
         if (TGA_CMips)
             TGA_CMips->PrintError(("Error(%d): TGA Plugin ID(%d) invalid TGA header. Filename = %s "), EL_Error, IDS_ERROR_NOT_TGA, pszFilename);
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         return -1;
     }
 
     // Skip the ID field
     if (header.cIDFieldLength)
-        fseek(pFile, header.cIDFieldLength, SEEK_CUR);
+        CMP_StreamSeek(pStream, header.cIDFieldLength, SEEK_CUR);
 
     if (!TGA_CMips->AllocateMipSet(pMipSet, CF_8bit, TDT_ARGB, TT_2D, header.nWidth, header.nHeight, 1))
     {  // depthsupport, what should nDepth be set as here?
-        fclose(pFile);
+        CMP_StreamClose(pStream);
         return PE_Unknown;
     }
 
     if (header.cColorMapType == 0)
     {
         if (header.cImageType == ImageType_ARGB8888 && header.cColorDepth == 32)
-            return LoadTGA_ARGB8888(pFile, pMipSet, header);
+            return LoadTGA_ARGB8888(pStream, pMipSet, header);
         else if (header.cImageType == ImageType_ARGB8888_RLE && header.cColorDepth == 32)
-            return LoadTGA_ARGB8888_RLE(pFile, pMipSet, header);
+            return LoadTGA_ARGB8888_RLE(pStream, pMipSet, header);
         else if (header.cImageType == ImageType_ARGB8888 && header.cColorDepth == 24)
-            return LoadTGA_RGB888(pFile, pMipSet, header);
+            return LoadTGA_RGB888(pStream, pMipSet, header);
         else if (header.cImageType == ImageType_ARGB8888_RLE && header.cColorDepth == 24)
-            return LoadTGA_RGB888_RLE(pFile, pMipSet, header);
+            return LoadTGA_RGB888_RLE(pStream, pMipSet, header);
         else if (header.cImageType == ImageType_G8_RLE && header.cColorDepth == 8)
-            return LoadTGA_G8_RLE(pFile, pMipSet, header);  // Raw greyscale -> Converted to RGBA channels where R=G=B and alpha is 255
+            return LoadTGA_G8_RLE(pStream, pMipSet, header);  // Raw greyscale -> Converted to RGBA channels where R=G=B and alpha is 255
         else                                                // use stbi
         {
-            fclose(pFile);
+            std::vector<CMP_BYTE> data;
+            if (CMP_StreamSeek(pStream, nStart, SEEK_SET) == 0)
+                CMP_StreamReadAll(pStream, data);
+            CMP_StreamClose(pStream);
             char*   sti_pData;
             int32_t width, height, channels;
-            sti_pData = (char*)stbi_load(pszFilename, &width, &height, &channels, STBI_rgb_alpha);
+            sti_pData = (char*)stbi_load_from_memory(data.data(), (int)data.size(), &width, &height, &channels, STBI_rgb_alpha);
             if (sti_pData)
             {
                 if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), width, height, CF_8bit, TDT_ARGB))
@@ -174,30 +165,14 @@ int Plugin_TGA::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
 
     if (TGA_CMips)
         TGA_CMips->PrintError(("Error(%d): TGA Plugin ID(%d) file load Filename = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return -1;
 }
 
-int Plugin_TGA::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+// Saves at the current position of pStream and closes it, pszFilename only names the destination in errors
+static int SaveTGA(CMP_Stream* pStream, MipSet* pMipSet, const char* pszFilename)
 {
-    CMP_CMIPS lCMips;
-    if (!TGA_CMips)
-    {
-        TGA_CMips = &lCMips;
-    }
-    assert(pszFilename);
-    assert(pMipSet);
-
-    FILE* pFile = NULL;
-    pFile       = fopen(pszFilename, ("wb"));
-    if (pFile == NULL)
-    {
-        if (TGA_CMips)
-            TGA_CMips->PrintError(("Error(%d): TGA Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
-        return -1;
-    }
-
     TGAHeader header;
     memset(&header, 0, sizeof(header));
     switch (pMipSet->m_dwFourCC)
@@ -226,31 +201,107 @@ int Plugin_TGA::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
     header.nWidth  = static_cast<short>(pMipSet->m_nWidth);
     header.nHeight = static_cast<short>(pMipSet->m_nHeight);
 
-    fwrite(&header, sizeof(header), 1, pFile);
+    CMP_StreamWrite(pStream, &header, sizeof(header), 1);
 
     if (header.cImageType == ImageType_G8)
-        return SaveTGA_G8(pFile, pMipSet);
+        return SaveTGA_G8(pStream, pMipSet);
     else if (header.cImageType == ImageType_G8_RLE)
-        return SaveTGA_G8_RLE(pFile, pMipSet);
+        return SaveTGA_G8_RLE(pStream, pMipSet);
     else if (header.cImageType == ImageType_ARGB8888 && pMipSet->m_TextureDataType == TDT_ARGB)
-        return SaveTGA_ARGB8888(pFile, pMipSet);
+        return SaveTGA_ARGB8888(pStream, pMipSet);
     else if (header.cImageType == ImageType_ARGB8888_RLE && pMipSet->m_TextureDataType == TDT_ARGB)
-        return SaveTGA_ARGB8888_RLE(pFile, pMipSet);
+        return SaveTGA_ARGB8888_RLE(pStream, pMipSet);
     else if (header.cImageType == ImageType_ARGB8888 && pMipSet->m_TextureDataType == TDT_XRGB)
-        return SaveTGA_RGB888(pFile, pMipSet);
+        return SaveTGA_RGB888(pStream, pMipSet);
     else if (header.cImageType == ImageType_ARGB8888_RLE && pMipSet->m_TextureDataType == TDT_XRGB)
-        return SaveTGA_RGB888_RLE(pFile, pMipSet);
+        return SaveTGA_RGB888_RLE(pStream, pMipSet);
 
     if (TGA_CMips)
         TGA_CMips->PrintError(("Error(%d): TGA Plugin ID(%d) unsupported type Filename = %s "), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, pszFilename);
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return -1;
 }
 
+int Plugin_TGA::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    CMP_CMIPS lCMips;
+    if (!TGA_CMips)
+    {
+        TGA_CMips = &lCMips;
+    }
+
+    // ATI code
+    FILE* pFile = NULL;
+    pFile       = fopen(pszFilename, ("rb"));
+    if (pFile == NULL)
+    {
+        if (TGA_CMips)
+            TGA_CMips->PrintError(("Error(%d): TGA Plugin ID(%d) opening file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    CMP_Stream stream;
+    CMP_InitFileStream(&stream, pFile);
+
+    int result = LoadTGA(&stream, pMipSet, pszFilename);
+    CMP_StreamClose(&stream);
+    return result;
+}
+
+int Plugin_TGA::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
+{
+    CMP_CMIPS lCMips;
+    if (!TGA_CMips)
+    {
+        TGA_CMips = &lCMips;
+    }
+    assert(pszFilename);
+    assert(pMipSet);
+
+    FILE* pFile = NULL;
+    pFile       = fopen(pszFilename, ("wb"));
+    if (pFile == NULL)
+    {
+        if (TGA_CMips)
+            TGA_CMips->PrintError(("Error(%d): TGA Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    CMP_Stream stream;
+    CMP_InitFileStream(&stream, pFile);
+
+    int result = SaveTGA(&stream, pMipSet, pszFilename);
+    CMP_StreamClose(&stream);
+    return result;
+}
+
+int Plugin_TGA::TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    CMP_CMIPS lCMips;
+    if (!TGA_CMips)
+    {
+        TGA_CMips = &lCMips;
+    }
+
+    return LoadTGA(pStream, pMipSet, "stream");
+}
+
+int Plugin_TGA::TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet)
+{
+    CMP_CMIPS lCMips;
+    if (!TGA_CMips)
+    {
+        TGA_CMips = &lCMips;
+    }
+    assert(pMipSet);
+
+    return SaveTGA(pStream, pMipSet, "stream");
+}
+
 //---------------- TGA Code -----------------------------------
 
-TC_PluginError LoadTGA_ARGB8888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+TC_PluginError LoadTGA_ARGB8888(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
         return PE_Unknown;
@@ -265,8 +316,8 @@ TC_PluginError LoadTGA_ARGB8888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     // Allocate a temporary buffer and read the bitmap data into it
     CMP_DWORD      dwSize    = pMipSet->m_nWidth * pMipSet->m_nHeight * sizeof(CMP_COLOR);
     unsigned char* pTempData = static_cast<unsigned char*>(malloc(dwSize));
-    fread(pTempData, dwSize, 1, pFile);
-    fclose(pFile);
+    CMP_StreamRead(pStream, pTempData, dwSize, 1);
+    CMP_StreamClose(pStream);
 
     CMP_BYTE* pTempPtr = pTempData;
 
@@ -316,7 +367,7 @@ TC_PluginError LoadTGA_ARGB8888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     return PE_OK;
 }
 
-TC_PluginError LoadTGA_ARGB8888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+TC_PluginError LoadTGA_ARGB8888_RLE(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
         return PE_Unknown;
@@ -329,14 +380,14 @@ TC_PluginError LoadTGA_ARGB8888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Hea
     pMipSet->m_nMipLevels      = 1;
 
     // Allocate a temporary buffer and read the bitmap data into it
-    long lCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long lEndPos = ftell(pFile);
-    fseek(pFile, lCurrPos, SEEK_SET);
+    int64_t lCurrPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, 0, SEEK_END);
+    int64_t lEndPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, lCurrPos, SEEK_SET);
     CMP_DWORD      dwTempSize = lEndPos - lCurrPos;
     unsigned char* pTempData  = static_cast<unsigned char*>(malloc(dwTempSize));
-    fread(pTempData, dwTempSize, 1, pFile);
-    fclose(pFile);
+    CMP_StreamRead(pStream, pTempData, dwTempSize, 1);
+    CMP_StreamClose(pStream);
 
     CMP_DWORD dwPitch  = pMipSet->m_nWidth * sizeof(CMP_COLOR);
     CMP_BYTE* pTempPtr = pTempData;
@@ -407,7 +458,7 @@ TC_PluginError LoadTGA_ARGB8888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Hea
     return PE_OK;
 }
 
-TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+TC_PluginError LoadTGA_RGB888(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
         return PE_Unknown;
@@ -422,8 +473,8 @@ TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     // Allocate a temporary buffer and read the bitmap data into it
     CMP_DWORD      dwSize    = pMipSet->m_nWidth * pMipSet->m_nHeight * 3;
     unsigned char* pTempData = static_cast<unsigned char*>(malloc(dwSize));
-    fread(pTempData, dwSize, 1, pFile);
-    fclose(pFile);
+    CMP_StreamRead(pStream, pTempData, dwSize, 1);
+    CMP_StreamClose(pStream);
 
     CMP_BYTE* pTempPtr = pTempData;
 
@@ -467,7 +518,7 @@ TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     return PE_OK;
 }
 
-TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+TC_PluginError LoadTGA_RGB888_RLE(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
         return PE_Unknown;
@@ -480,14 +531,14 @@ TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Heade
     pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
 
     // Allocate a temporary buffer and read the bitmap data into it
-    long lCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long lEndPos = ftell(pFile);
-    fseek(pFile, lCurrPos, SEEK_SET);
+    int64_t lCurrPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, 0, SEEK_END);
+    int64_t lEndPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, lCurrPos, SEEK_SET);
     CMP_DWORD      dwTempSize = lEndPos - lCurrPos;
     unsigned char* pTempData  = static_cast<unsigned char*>(malloc(dwTempSize));
-    fread(pTempData, dwTempSize, 1, pFile);
-    fclose(pFile);
+    CMP_StreamRead(pStream, pTempData, dwTempSize, 1);
+    CMP_StreamClose(pStream);
 
     CMP_BYTE* pTempPtr   = pTempData;
     CMP_DWORD dwPitchOut = pMipSet->m_nWidth * sizeof(CMP_COLOR);
@@ -561,7 +612,7 @@ TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Heade
 }
 
 // No longer used : Remove
-TC_PluginError LoadTGA_G8(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+TC_PluginError LoadTGA_G8(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
         return PE_Unknown;
@@ -574,14 +625,14 @@ TC_PluginError LoadTGA_G8(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
 
     // Allocate a temporary buffer and read the bitmap data into it
-    long lCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long lEndPos = ftell(pFile);
-    fseek(pFile, lCurrPos, SEEK_SET);
+    int64_t lCurrPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, 0, SEEK_END);
+    int64_t lEndPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, lCurrPos, SEEK_SET);
     CMP_DWORD      dwTempSize = lEndPos - lCurrPos;
     unsigned char* pTempData  = static_cast<unsigned char*>(malloc(dwTempSize));
-    fread(pTempData, dwTempSize, 1, pFile);
-    fclose(pFile);
+    CMP_StreamRead(pStream, pTempData, dwTempSize, 1);
+    CMP_StreamClose(pStream);
 
     CMP_BYTE* pTempPtr = pTempData;
 
@@ -644,7 +695,7 @@ TC_PluginError LoadTGA_G8(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     return PE_OK;
 }
 
-TC_PluginError LoadTGA_G8_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+TC_PluginError LoadTGA_G8_RLE(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
         return PE_Unknown;
@@ -657,14 +708,14 @@ TC_PluginError LoadTGA_G8_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
 
     // Allocate a temporary buffer and read the bitmap data into it
-    long lCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long lEndPos = ftell(pFile);
-    fseek(pFile, lCurrPos, SEEK_SET);
+    int64_t lCurrPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, 0, SEEK_END);
+    int64_t lEndPos = CMP_StreamTell(pStream);
+    CMP_StreamSeek(pStream, lCurrPos, SEEK_SET);
     CMP_DWORD      dwTempSize = lEndPos - lCurrPos;
     unsigned char* pTempData  = static_cast<unsigned char*>(malloc(dwTempSize));
-    fread(pTempData, dwTempSize, 1, pFile);
-    fclose(pFile);
+    CMP_StreamRead(pStream, pTempData, dwTempSize, 1);
+    CMP_StreamClose(pStream);
 
     CMP_BYTE* pTempPtr = pTempData;
 
@@ -764,7 +815,7 @@ CMP_BYTE CalcRawLength(CMP_BYTE* pThis, CMP_BYTE* pEnd, int nSize, int nOffset)
 //
 // Need to Fix this
 
-void SaveLineRLE(FILE* pFile, CMP_BYTE* pThis, CMP_BYTE* pEnd, int nSize, int nOffset)
+void SaveLineRLE(CMP_Stream* pStream, CMP_BYTE* pThis, CMP_BYTE* pEnd, int nSize, int nOffset)
 {
     while (pThis < pEnd)
     {
@@ -774,25 +825,25 @@ void SaveLineRLE(FILE* pFile, CMP_BYTE* pThis, CMP_BYTE* pEnd, int nSize, int nO
         {
             CMP_BYTE cRunLength       = CalcRunLength(pThis, pEnd, nSize, nOffset);
             CMP_BYTE cRepetitionCount = (cRunLength - 1) | 0x80;
-            fwrite(&cRepetitionCount, sizeof(cRepetitionCount), 1, pFile);
-            fwrite(pThis, nSize, 1, pFile);
+            CMP_StreamWrite(pStream, &cRepetitionCount, sizeof(cRepetitionCount), 1);
+            CMP_StreamWrite(pStream, pThis, nSize, 1);
             pThis += (cRunLength * nOffset);
         }
         else
         {
             CMP_BYTE cRawLength       = CalcRawLength(pThis, pEnd, nSize, nOffset);
             CMP_BYTE cRepetitionCount = (cRawLength - 1);
-            fwrite(&cRepetitionCount, sizeof(cRepetitionCount), 1, pFile);
+            CMP_StreamWrite(pStream, &cRepetitionCount, sizeof(cRepetitionCount), 1);
             if (nSize == nOffset)
             {
-                fwrite(pThis, nSize * cRawLength, 1, pFile);
+                CMP_StreamWrite(pStream, pThis, nSize * cRawLength, 1);
                 pThis += (cRawLength * nOffset);
             }
             else
             {
                 for (CMP_BYTE i = 0; i < cRawLength; i++)
                 {
-                    fwrite(pThis, nSize, 1, pFile);
+                    CMP_StreamWrite(pStream, pThis, nSize, 1);
                     pThis += nOffset;
                 }
             }
@@ -800,7 +851,7 @@ void SaveLineRLE(FILE* pFile, CMP_BYTE* pThis, CMP_BYTE* pEnd, int nSize, int nO
     }
 }
 
-TC_PluginError SaveRLE(FILE* pFile, const MipSet* pMipSet, int nSize, int nOffset)
+TC_PluginError SaveRLE(CMP_Stream* pStream, const MipSet* pMipSet, int nSize, int nOffset)
 {
     CMP_DWORD dwPitch = pMipSet->m_nWidth * nOffset;
     for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
@@ -808,10 +859,10 @@ TC_PluginError SaveRLE(FILE* pFile, const MipSet* pMipSet, int nSize, int nOffse
         CMP_BYTE* pThis = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
         CMP_BYTE* pEnd  = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + ((j + 1) * dwPitch));
 
-        SaveLineRLE(pFile, pThis, pEnd, nSize, nOffset);
+        SaveLineRLE(pStream, pThis, pEnd, nSize, nOffset);
     }
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
@@ -821,7 +872,7 @@ TC_PluginError SaveRLE(FILE* pFile, const MipSet* pMipSet, int nSize, int nOffse
 // Code using the pMipSet->m_swizzle should be reviewed
 //--------------------------------------------------------
 
-TC_PluginError SaveTGA_ARGB8888(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveTGA_ARGB8888(CMP_Stream* pStream, const MipSet* pMipSet)
 {
     CMP_DWORD dwPitch = pMipSet->m_nWidth * 4;
 
@@ -837,7 +888,7 @@ TC_PluginError SaveTGA_ARGB8888(FILE* pFile, const MipSet* pMipSet)
                 RGBA[1] = (CMP_BYTE)*pData++;
                 RGBA[0] = (CMP_BYTE)*pData++;
                 RGBA[3] = (CMP_BYTE)*pData++;
-                fwrite(RGBA, 4, 1, pFile);
+                CMP_StreamWrite(pStream, RGBA, 4, 1);
             }
         }
     }
@@ -846,21 +897,21 @@ TC_PluginError SaveTGA_ARGB8888(FILE* pFile, const MipSet* pMipSet)
     //    for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
     //    {
     //        CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
-    //        fwrite(pData, dwPitch, 1, pFile);
+    //        CMP_StreamWrite(pStream, pData, dwPitch, 1);
     //    }
     //}
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveTGA_ARGB8888_RLE(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveTGA_ARGB8888_RLE(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    return SaveRLE(pFile, pMipSet, sizeof(CMP_COLOR), sizeof(CMP_COLOR));
+    return SaveRLE(pStream, pMipSet, sizeof(CMP_COLOR), sizeof(CMP_COLOR));
 }
 
-TC_PluginError SaveTGA_RGB888(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveTGA_RGB888(CMP_Stream* pStream, const MipSet* pMipSet)
 {
     CMP_DWORD dwPitch = pMipSet->m_nWidth * sizeof(CMP_COLOR);
     for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
@@ -869,37 +920,37 @@ TC_PluginError SaveTGA_RGB888(FILE* pFile, const MipSet* pMipSet)
         CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
         for (int i = 0; i < pMipSet->m_nWidth; i++)
         {
-            fwrite(pData, 3, 1, pFile);
+            CMP_StreamWrite(pStream, pData, 3, 1);
             pData += sizeof(CMP_COLOR);
         }
     }
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveTGA_RGB888_RLE(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveTGA_RGB888_RLE(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    return SaveRLE(pFile, pMipSet, 3, sizeof(CMP_COLOR));
+    return SaveRLE(pStream, pMipSet, 3, sizeof(CMP_COLOR));
 }
 
-TC_PluginError SaveTGA_G8(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveTGA_G8(CMP_Stream* pStream, const MipSet* pMipSet)
 {
     for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
     {
         CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * pMipSet->m_nWidth));
-        fwrite(pData, pMipSet->m_nWidth, 1, pFile);
+        CMP_StreamWrite(pStream, pData, pMipSet->m_nWidth, 1);
     }
 
-    fclose(pFile);
+    CMP_StreamClose(pStream);
 
     return PE_OK;
 }
 
-TC_PluginError SaveTGA_G8_RLE(FILE* pFile, const MipSet* pMipSet)
+TC_PluginError SaveTGA_G8_RLE(CMP_Stream* pStream, const MipSet* pMipSet)
 {
-    return SaveRLE(pFile, pMipSet, sizeof(CMP_BYTE), sizeof(CMP_BYTE));
+    return SaveRLE(pStream, pMipSet, sizeof(CMP_BYTE), sizeof(CMP_BYTE));
 }
 
 // ------------ Registry!
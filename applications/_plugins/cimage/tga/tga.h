@@ -37,6 +37,7 @@
 #endif
 
 #include "plugininterface.h"
+#include "cmp_stream.h"
 
 // ---------------- TGA Plugin ------------------------
 #ifdef _WIN32
@@ -60,6 +61,8 @@ public:
     int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet);
     int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture);
     int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture);
+    int TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet);
+    int TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet);
 };
 
 extern void* make_Plugin_TGA();
@@ -126,19 +129,19 @@ typedef struct
 #define IDD_FILE_SAVE_PARAMETERS 101
 #define IDC_RLE_COMPRESSED 1000
 
-TC_PluginError LoadTGA_ARGB8888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header);
-TC_PluginError LoadTGA_ARGB8888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header);
-TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header);
-TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header);
-TC_PluginError LoadTGA_G8(FILE* pFile, MipSet* pMipSet, TGAHeader& Header);
-TC_PluginError LoadTGA_G8_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header);
-
-TC_PluginError SaveTGA_ARGB8888(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveTGA_ARGB8888_RLE(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveTGA_RGB888(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveTGA_RGB888_RLE(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveTGA_G8(FILE* pFile, const MipSet* pMipSet);
-TC_PluginError SaveTGA_G8_RLE(FILE* pFile, const MipSet* pMipSet);
+TC_PluginError LoadTGA_ARGB8888(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header);
+TC_PluginError LoadTGA_ARGB8888_RLE(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header);
+TC_PluginError LoadTGA_RGB888(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header);
+TC_PluginError LoadTGA_RGB888_RLE(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header);
+TC_PluginError LoadTGA_G8(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header);
+TC_PluginError LoadTGA_G8_RLE(CMP_Stream* pStream, MipSet* pMipSet, TGAHeader& Header);
+
+TC_PluginError SaveTGA_ARGB8888(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveTGA_ARGB8888_RLE(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveTGA_RGB888(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveTGA_RGB888_RLE(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveTGA_G8(CMP_Stream* pStream, const MipSet* pMipSet);
+TC_PluginError SaveTGA_G8_RLE(CMP_Stream* pStream, const MipSet* pMipSet);
 
 void LoadRegistryKeys(TGA_FileSaveParams* pParams);
 void LoadRegistryKeyDefaults(TGA_FileSaveParams* pParams);
@@ -27,6 +27,8 @@
 #endif
 #include "cexr.h"
 
+#include <IexBaseExc.h>
+
 float half_conv_float(unsigned short in)
 {
     union fi32
@@ -84,6 +86,86 @@ void Exr::writeRgba(const string outf, const Array2D<Rgba>& pix, int w, int h)
     file.writePixels(h);
 }
 
+void Exr::fileinfo(IStream& in, int& width, int& height)
+{
+    in.seekg(0);
+    RgbaInputFile file(in);
+    Box2i         dw = file.dataWindow();
+
+    width  = dw.max.x - dw.min.x + 1;
+    height = dw.max.y - dw.min.y + 1;
+}
+
+void Exr::readRgba(IStream& in, Array2D<Rgba>& pix, int& w, int& h)
+{
+    in.seekg(0);
+    RgbaInputFile file(in);
+    Box2i         dw = file.dataWindow();
+    w                = dw.max.x - dw.min.x + 1;
+    h                = dw.max.y - dw.min.y + 1;
+    pix.resizeErase(h, w);
+    file.setFrameBuffer(&pix[0][0] - dw.min.x - dw.min.y * w, 1, w);
+    file.readPixels(dw.min.y, dw.max.y);
+}
+
+void Exr::writeRgba(OStream& out, const Array2D<Rgba>& pix, int w, int h)
+{
+    RgbaOutputFile file(out, Header(w, h), WRITE_RGBA);
+    file.setFrameBuffer(&pix[0][0], 1, w);
+    file.writePixels(h);
+}
+
+Exr_IStream::Exr_IStream(CMP_Stream* pStream, const char fileName[])
+    : IStream(fileName)
+    , m_pStream(pStream)
+    , m_Start(CMP_StreamTell(pStream))
+{
+}
+
+bool Exr_IStream::read(char c[], int n)
+{
+    // OpenEXR expects the whole request or an exception
+    if (CMP_StreamRead(m_pStream, c, 1, (size_t)n) != (size_t)n)
+        throw IEX_NAMESPACE::InputExc("Unexpected end of file.");
+
+    return true;
+}
+
+Exr_Int64 Exr_IStream::tellg()
+{
+    return (Exr_Int64)(CMP_StreamTell(m_pStream) - m_Start);
+}
+
+void Exr_IStream::seekg(Exr_Int64 pos)
+{
+    if (CMP_StreamSeek(m_pStream, m_Start + (int64_t)pos, SEEK_SET) != 0)
+        throw IEX_NAMESPACE::InputExc("Seek failed.");
+}
+
+Exr_OStream::Exr_OStream(CMP_Stream* pStream, const char fileName[])
+    : OStream(fileName)
+    , m_pStream(pStream)
+    , m_Start(CMP_StreamTell(pStream))
+{
+}
+
+void Exr_OStream::write(const char c[], int n)
+{
+    if (CMP_StreamWrite(m_pStream, c, 1, (size_t)n) != (size_t)n)
+        throw IEX_NAMESPACE::IoExc("Write failed.");
+}
+
+Exr_Int64 Exr_OStream::tellp()
+{
+    return (Exr_Int64)(CMP_StreamTell(m_pStream) - m_Start);
+}
+
+void Exr_OStream::seekp(Exr_Int64 pos)
+{
+    if (CMP_StreamSeek(m_pStream, m_Start + (int64_t)pos, SEEK_SET) != 0)
+        throw IEX_NAMESPACE::IoExc("Seek failed.");
+}
+
 void Rgba2Texture(Array2D<Rgba>& pixels, CMP_HALFSHORT* data, int w, int h)
 {
     // Save the Half Data format value into CMP_HALFSHORT bit format for processing later
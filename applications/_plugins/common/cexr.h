@@ -36,6 +36,8 @@
 #include <ImathBox.h>
 #include <ImfArray.h>
 #include <ImfRgbaFile.h>
+#include <ImfIO.h>
+#include <OpenEXRConfig.h>
 #pragma warning(pop)
 
 #include <string.h>
@@ -47,10 +49,47 @@ using namespace IMF;
 using namespace IMATH;
 
 #include "cmp_fileio.h"
+#include "cmp_stream.h"
 
 #pragma warning(disable : 4201)
 typedef unsigned int uint;
 
+// OpenEXR 3 moved stream positions from its own Int64 to uint64_t
+#if OPENEXR_VERSION_MAJOR >= 3
+typedef uint64_t Exr_Int64;
+#else
+typedef IMF::Int64 Exr_Int64;
+#endif
+
+// OpenEXR streams on a CMP_Stream, positions are counted from where the stream was when the adapter was made
+class Exr_IStream : public IStream
+{
+public:
+    Exr_IStream(CMP_Stream* pStream, const char fileName[]);
+
+    virtual bool      read(char c[], int n);
+    virtual Exr_Int64 tellg();
+    virtual void      seekg(Exr_Int64 pos);
+
+private:
+    CMP_Stream* m_pStream;
+    int64_t     m_Start;
+};
+
+class Exr_OStream : public OStream
+{
+public:
+    Exr_OStream(CMP_Stream* pStream, const char fileName[]);
+
+    virtual void      write(const char c[], int n);
+    virtual Exr_Int64 tellp();
+    virtual void      seekp(Exr_Int64 pos);
+
+private:
+    CMP_Stream* m_pStream;
+    int64_t     m_Start;
+};
+
 class Exr
 {
 public:
@@ -60,6 +99,11 @@ public:
     static void fileinfo(const string inf, int& width, int& height);
     static void readRgba(const string inf, Array2D<Rgba>& pix, int& w, int& h);
     static void writeRgba(const string outf, const Array2D<Rgba>& pix, int w, int h);
+
+    // The stream versions start from the beginning of the stream
+    static void fileinfo(IStream& in, int& width, int& height);
+    static void readRgba(IStream& in, Array2D<Rgba>& pix, int& w, int& h);
+    static void writeRgba(OStream& out, const Array2D<Rgba>& pix, int w, int h);
 };
 
 extern void  Rgba2Texture(Array2D<Rgba>& pixels, CMP_HALFSHORT* data, int w, int h);
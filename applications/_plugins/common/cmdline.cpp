@@ -1641,6 +1641,8 @@ static bool CompressDecompressMesh(std::string SourceFile, std::string DestFile)
                             CFilterParam.nFilterType        = 0;
                             CFilterParam.nMinSize           = nMinSize;
                             CFilterParam.fGammaCorrection   = g_CmdPrams.CompressOptions.fInputFilterGamma;
+                            CFilterParam.useThreadPool      = !g_CmdPrams.CompressOptions.bDisableMultiThreading;
+                            CFilterParam.dwnumThreads       = g_CmdPrams.CompressOptions.dwnumThreads;
                             CMP_GenerateMIPLevelsEx(&inMips, &CFilterParam);
                         }
 
@@ -3787,6 +3789,8 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                     CFilterParam.nFilterType        = 0;
                     CFilterParam.nMinSize           = nMinSize;
                     CFilterParam.fGammaCorrection   = g_CmdPrams.CompressOptions.fInputFilterGamma;
+                    CFilterParam.useThreadPool      = !g_CmdPrams.CompressOptions.bDisableMultiThreading;
+                    CFilterParam.dwnumThreads       = g_CmdPrams.CompressOptions.dwnumThreads;
                     CMP_GenerateMIPLevelsEx((CMP_MipSet*)&g_MipSetIn, &CFilterParam);
                 }
                 else if (g_CmdPrams.CompressOptions.genGPUMipMaps)
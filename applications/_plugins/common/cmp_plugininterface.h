@@ -37,7 +37,7 @@
 #include "pluginmanager.h"
 
 #define TC_API_VERSION_MAJOR 1
-#define TC_API_VERSION_MINOR 4
+#define TC_API_VERSION_MINOR 5
 
 typedef CMP_DWORD_PTR TC_HANDLE;  ///< Generic Texture API handle
 typedef TC_HANDLE     HFILETYPE;  ///< Handle to a FileType.
@@ -66,6 +66,19 @@ public:
     virtual int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)         = 0;
     virtual int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture) = 0;
     virtual int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture) = 0;
+
+    // Loads from or saves to a stream that can read, write, seek and tell, in place of a named file.
+    // Added in API version 1.5, the host does not call them on older plugins. Plugins without stream support keep these.
+    virtual int TC_PluginStreamLoadTexture(CMP_Stream* pStream, MipSet* pMipSet)
+    {
+        (void)pStream, (void)pMipSet;
+        return -1;
+    }
+    virtual int TC_PluginStreamSaveTexture(CMP_Stream* pStream, MipSet* pMipSet)
+    {
+        (void)pStream, (void)pMipSet;
+        return -1;
+    }
 };
 
 class PluginInterface_Analysis : PluginBase
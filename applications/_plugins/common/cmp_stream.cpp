@@ -0,0 +1,306 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "cmp_stream.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+size_t CMP_StreamRead(CMP_Stream* pStream, void* pBuffer, size_t size, size_t count)
+{
+    if (!pStream || !pStream->pRead || (size == 0) || (count == 0))
+        return 0;
+
+    return pStream->pRead(pBuffer, size * count, pStream->pUser) / size;
+}
+
+size_t CMP_StreamWrite(CMP_Stream* pStream, const void* pBuffer, size_t size, size_t count)
+{
+    if (!pStream || !pStream->pWrite || (size == 0) || (count == 0))
+        return 0;
+
+    return pStream->pWrite(pBuffer, size * count, pStream->pUser) / size;
+}
+
+int CMP_StreamSeek(CMP_Stream* pStream, int64_t offset, int origin)
+{
+    if (!pStream || !pStream->pSeek)
+        return -1;
+
+    return pStream->pSeek(offset, origin, pStream->pUser);
+}
+
+int64_t CMP_StreamTell(CMP_Stream* pStream)
+{
+    if (!pStream || !pStream->pTell)
+        return -1;
+
+    return pStream->pTell(pStream->pUser);
+}
+
+int64_t CMP_StreamSize(CMP_Stream* pStream)
+{
+    int64_t pos = CMP_StreamTell(pStream);
+    if ((pos < 0) || (CMP_StreamSeek(pStream, 0, SEEK_END) != 0))
+        return -1;
+
+    int64_t size = CMP_StreamTell(pStream);
+    if (CMP_StreamSeek(pStream, pos, SEEK_SET) != 0)
+        return -1;
+
+    return size;
+}
+
+bool CMP_StreamReadAll(CMP_Stream* pStream, std::vector<CMP_BYTE>& data)
+{
+    data.clear();
+    if (!pStream || !pStream->pRead)
+        return false;
+
+    // Read the rest in one go when the size is known, otherwise in chunks until the end
+    int64_t pos  = CMP_StreamTell(pStream);
+    int64_t size = (pos >= 0) ? CMP_StreamSize(pStream) : -1;
+    if ((size >= 0) && (size >= pos))
+    {
+        data.resize((size_t)(size - pos));
+        size_t read = data.empty() ? 0 : pStream->pRead(data.data(), data.size(), pStream->pUser);
+        data.resize(read);
+        return true;
+    }
+
+    const size_t chunk = 1 << 20;
+    size_t       read;
+    do
+    {
+        size_t used = data.size();
+        data.resize(used + chunk);
+        read = pStream->pRead(data.data() + used, chunk, pStream->pUser);
+        data.resize(used + read);
+    } while (read == chunk);
+
+    return true;
+}
+
+void CMP_StreamClose(CMP_Stream* pStream)
+{
+    if (!pStream || !pStream->pClose)
+        return;
+
+    CMP_StreamClose_Proc pClose = pStream->pClose;
+    pStream->pClose             = NULL;
+    pClose(pStream->pUser);
+}
+
+//==============================
+// File streams
+//==============================
+
+static size_t CMP_API CMP_FileStreamRead(void* pBuffer, size_t size, CMP_DWORD_PTR pUser)
+{
+    return fread(pBuffer, 1, size, reinterpret_cast<FILE*>(pUser));
+}
+
+static size_t CMP_API CMP_FileStreamWrite(const void* pBuffer, size_t size, CMP_DWORD_PTR pUser)
+{
+    return fwrite(pBuffer, 1, size, reinterpret_cast<FILE*>(pUser));
+}
+
+static int CMP_API CMP_FileStreamSeek(int64_t offset, int origin, CMP_DWORD_PTR pUser)
+{
+#ifdef _WIN32
+    return _fseeki64(reinterpret_cast<FILE*>(pUser), offset, origin);
+#else
+    return fseeko(reinterpret_cast<FILE*>(pUser), (off_t)offset, origin);
+#endif
+}
+
+static int64_t CMP_API CMP_FileStreamTell(CMP_DWORD_PTR pUser)
+{
+#ifdef _WIN32
+    return _ftelli64(reinterpret_cast<FILE*>(pUser));
+#else
+    return (int64_t)ftello(reinterpret_cast<FILE*>(pUser));
+#endif
+}
+
+static void CMP_API CMP_FileStreamClose(CMP_DWORD_PTR pUser)
+{
+    fclose(reinterpret_cast<FILE*>(pUser));
+}
+
+void CMP_InitFileStream(CMP_Stream* pStream, FILE* pFile)
+{
+    pStream->dwSize = sizeof(CMP_Stream);
+    pStream->pRead  = CMP_FileStreamRead;
+    pStream->pWrite = CMP_FileStreamWrite;
+    pStream->pSeek  = CMP_FileStreamSeek;
+    pStream->pTell  = CMP_FileStreamTell;
+    pStream->pClose = CMP_FileStreamClose;
+    pStream->pUser  = reinterpret_cast<CMP_DWORD_PTR>(pFile);
+}
+
+FILE* CMP_GetStreamFile(const CMP_Stream* pStream)
+{
+    if (!pStream || (pStream->pRead != CMP_FileStreamRead))
+        return NULL;
+
+    return reinterpret_cast<FILE*>(pStream->pUser);
+}
+
+//==============================
+// Memory streams
+//==============================
+
+CMP_MemoryStream::CMP_MemoryStream(const void* pData, size_t size)
+    : m_pData((const CMP_BYTE*)pData)
+    , m_pBuffer(NULL)
+    , m_Size(size)
+    , m_Capacity(size)
+    , m_Pos(0)
+{
+    m_Stream.dwSize = sizeof(CMP_Stream);
+    m_Stream.pRead  = Read;
+    m_Stream.pWrite = NULL;
+    m_Stream.pSeek  = Seek;
+    m_Stream.pTell  = Tell;
+    m_Stream.pClose = NULL;
+    m_Stream.pUser  = reinterpret_cast<CMP_DWORD_PTR>(this);
+}
+
+CMP_MemoryStream::CMP_MemoryStream()
+    : m_pData(NULL)
+    , m_pBuffer(NULL)
+    , m_Size(0)
+    , m_Capacity(0)
+    , m_Pos(0)
+{
+    m_Stream.dwSize = sizeof(CMP_Stream);
+    m_Stream.pRead  = Read;
+    m_Stream.pWrite = Write;
+    m_Stream.pSeek  = Seek;
+    m_Stream.pTell  = Tell;
+    m_Stream.pClose = NULL;
+    m_Stream.pUser  = reinterpret_cast<CMP_DWORD_PTR>(this);
+}
+
+CMP_MemoryStream::~CMP_MemoryStream()
+{
+    free(m_pBuffer);
+}
+
+void* CMP_MemoryStream::Detach(size_t* pSize)
+{
+    void* pBuffer = m_pBuffer;
+    if (pSize)
+        *pSize = m_Size;
+
+    m_pBuffer  = NULL;
+    m_pData    = NULL;
+    m_Size     = 0;
+    m_Capacity = 0;
+    m_Pos      = 0;
+    return pBuffer;
+}
+
+size_t CMP_API CMP_MemoryStream::Read(void* pBuffer, size_t size, CMP_DWORD_PTR pUser)
+{
+    CMP_MemoryStream* pThis = reinterpret_cast<CMP_MemoryStream*>(pUser);
+    if (pThis->m_Pos >= pThis->m_Size)
+        return 0;
+
+    if (size > pThis->m_Size - pThis->m_Pos)
+        size = pThis->m_Size - pThis->m_Pos;
+
+    memcpy(pBuffer, pThis->m_pData + pThis->m_Pos, size);
+    pThis->m_Pos += size;
+    return size;
+}
+
+size_t CMP_API CMP_MemoryStream::Write(const void* pBuffer, size_t size, CMP_DWORD_PTR pUser)
+{
+    CMP_MemoryStream* pThis = reinterpret_cast<CMP_MemoryStream*>(pUser);
+    if (size > SIZE_MAX - pThis->m_Pos)
+        return 0;
+
+    size_t end = pThis->m_Pos + size;
+    if (end > pThis->m_Capacity)
+    {
+        // Grow by half again so a texture written level by level is moved a few times at most
+        size_t capacity = pThis->m_Capacity + pThis->m_Capacity / 2;
+        if (capacity < end)
+            capacity = end;
+        if (capacity < 4096)
+            capacity = 4096;
+
+        CMP_BYTE* pNewBuffer = (CMP_BYTE*)realloc(pThis->m_pBuffer, capacity);
+        if (!pNewBuffer)
+            return 0;
+
+        pThis->m_pBuffer  = pNewBuffer;
+        pThis->m_pData    = pNewBuffer;
+        pThis->m_Capacity = capacity;
+    }
+
+    // A seek past the end leaves a gap that reads back as zeros, as it does in a file
+    if (pThis->m_Pos > pThis->m_Size)
+        memset(pThis->m_pBuffer + pThis->m_Size, 0, pThis->m_Pos - pThis->m_Size);
+
+    memcpy(pThis->m_pBuffer + pThis->m_Pos, pBuffer, size);
+    pThis->m_Pos = end;
+    if (end > pThis->m_Size)
+        pThis->m_Size = end;
+
+    return size;
+}
+
+int CMP_API CMP_MemoryStream::Seek(int64_t offset, int origin, CMP_DWORD_PTR pUser)
+{
+    CMP_MemoryStream* pThis = reinterpret_cast<CMP_MemoryStream*>(pUser);
+
+    int64_t base;
+    switch (origin)
+    {
+    case SEEK_SET:
+        base = 0;
+        break;
+    case SEEK_CUR:
+        base = (int64_t)pThis->m_Pos;
+        break;
+    case SEEK_END:
+        base = (int64_t)pThis->m_Size;
+        break;
+    default:
+        return -1;
+    }
+
+    if ((offset < -base) || (offset > INT64_MAX - base))
+        return -1;
+
+    pThis->m_Pos = (size_t)(base + offset);
+    return 0;
+}
+
+int64_t CMP_API CMP_MemoryStream::Tell(CMP_DWORD_PTR pUser)
+{
+    return (int64_t)reinterpret_cast<CMP_MemoryStream*>(pUser)->m_Pos;
+}
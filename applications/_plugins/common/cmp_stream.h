@@ -0,0 +1,102 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _CMP_STREAM_H
+#define _CMP_STREAM_H
+
+#include "compressonator.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <vector>
+
+// Stream I/O for the image plugins, shaped after stdio so loaders and savers read the same for files and memory
+
+// Reads or writes count items of size bytes and returns the number of whole items transferred
+size_t CMP_StreamRead(CMP_Stream* pStream, void* pBuffer, size_t size, size_t count);
+size_t CMP_StreamWrite(CMP_Stream* pStream, const void* pBuffer, size_t size, size_t count);
+
+// 0 on success, origin is SEEK_SET, SEEK_CUR or SEEK_END
+int     CMP_StreamSeek(CMP_Stream* pStream, int64_t offset, int origin);
+int64_t CMP_StreamTell(CMP_Stream* pStream);
+
+// Size of the whole stream, -1 if it cannot seek
+int64_t CMP_StreamSize(CMP_Stream* pStream);
+
+// Reads from the current position to the end of the stream
+bool CMP_StreamReadAll(CMP_Stream* pStream, std::vector<CMP_BYTE>& data);
+
+// Calls the close callback of the stream, only the first call does anything
+void CMP_StreamClose(CMP_Stream* pStream);
+
+// A stream on an open file, closing the stream closes the file
+void CMP_InitFileStream(CMP_Stream* pStream, FILE* pFile);
+
+// The file of a stream set up with CMP_InitFileStream, NULL for other streams
+FILE* CMP_GetStreamFile(const CMP_Stream* pStream);
+
+// A stream on memory, either reading a buffer owned by the caller or writing to a buffer that grows as needed
+class CMP_MemoryStream
+{
+public:
+    CMP_MemoryStream(const void* pData, size_t size);
+    CMP_MemoryStream();
+    ~CMP_MemoryStream();
+
+    CMP_Stream* GetStream()
+    {
+        return &m_Stream;
+    }
+
+    const CMP_BYTE* GetData() const
+    {
+        return m_pData;
+    }
+
+    size_t GetSize() const
+    {
+        return m_Size;
+    }
+
+    // Hands the written buffer to the caller, who frees it with free()
+    void* Detach(size_t* pSize);
+
+private:
+    CMP_MemoryStream(const CMP_MemoryStream&);
+    CMP_MemoryStream& operator=(const CMP_MemoryStream&);
+
+    static size_t CMP_API  Read(void* pBuffer, size_t size, CMP_DWORD_PTR pUser);
+    static size_t CMP_API  Write(const void* pBuffer, size_t size, CMP_DWORD_PTR pUser);
+    static int CMP_API     Seek(int64_t offset, int origin, CMP_DWORD_PTR pUser);
+    static int64_t CMP_API Tell(CMP_DWORD_PTR pUser);
+
+    CMP_Stream      m_Stream;
+    const CMP_BYTE* m_pData;
+    CMP_BYTE*       m_pBuffer;  // Buffer that is written, NULL for a stream that reads
+    size_t          m_Size;
+    size_t          m_Capacity;
+    size_t          m_Pos;
+};
+
+#endif
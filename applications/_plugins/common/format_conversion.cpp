@@ -28,6 +28,7 @@
 #include "compressonator.h"
 #include "atiformats.h"
 #include "format_conversion.h"
+#include "halfconvert.h"
 
 FloatParams::FloatParams(const CMP_AnalysisData* analysisData)
     : FloatParams()
@@ -512,10 +513,7 @@ CMP_ERROR HalfShortToFloat(CMP_FLOAT* outBuffer, CMP_HALFSHORT* inBuffer, CMP_DW
     if (!outBuffer)
         return CMP_ERR_INVALID_DEST_TEXTURE;
 
-    for (CMP_DWORD i = 0; i < numElements; i++)
-    {
-        outBuffer[i] = HalfShortToFloat(inBuffer[i]);
-    }
+    ConvertHalfToFloat(outBuffer, (const unsigned short*)inBuffer, numElements);
 
     return CMP_OK;
 }
@@ -538,10 +536,7 @@ CMP_ERROR FloatToHalfShort(CMP_HALFSHORT* outBuffer, CMP_FLOAT* inBuffer, CMP_DW
     if (!outBuffer)
         return CMP_ERR_INVALID_DEST_TEXTURE;
 
-    for (CMP_DWORD i = 0; i < numElements; i++)
-    {
-        outBuffer[i] = CMP_HALF(inBuffer[i]).bits();
-    }
+    ConvertFloatToHalf((unsigned short*)outBuffer, inBuffer, numElements);
 
     return CMP_OK;
 }
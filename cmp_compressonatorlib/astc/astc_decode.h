@@ -26,6 +26,7 @@
 #define _ASTC_DECODE_H_
 
 #include "astc/astc_definitions.h"
+#include "astc/astc_encode_kernel.h"
 
 class ASTCBlockDecoder
 {
@@ -35,7 +36,13 @@ public:
     ~ASTCBlockDecoder(){};
 
     // *out is determined by ImageData::m_DataType
-    void DecompressBlock(BYTE BlockWidth, BYTE BlockHeight, BYTE bitness, float out[][4], BYTE in[ASTC_COMPRESSED_BLOCK_SIZE]);
+    // ASTCEncode holds the partition and quantization tables for the block size, as set up by init_ASTC
+    void DecompressBlock(BYTE                             BlockWidth,
+                         BYTE                             BlockHeight,
+                         BYTE                             bitness,
+                         float                            out[][4],
+                         BYTE                             in[ASTC_COMPRESSED_BLOCK_SIZE],
+                         const ASTC_Encoder::ASTC_Encode* ASTCEncode);
 
 private:
 };
@@ -78,7 +78,7 @@ double ASTCBlockEncoder::CompressBlock_kernel(ASTC_Encoder::astc_codec_image* in
     //ASTC_Encoder::CGU_UINT pixelcount = ASTCEncode->m_ydim * ASTCEncode->m_xdim;
     //ASTC_Encoder::fetch_imageblock(input_image, &pb, pixelcount, ASTCEncode);
 
-    fetch_imageblock_cpu((const astc_codec_image_cpu*)input_image, (imageblock_cpu*)&m_pb, ASTCEncode->m_xdim, ASTCEncode->m_ydim, ASTCEncode->m_zdim, x, y, z);
+    fetch_imageblock_cpu((const astc_codec_image_cpu*)input_image, (imageblock_cpu*)&m_pb, ASTCEncode->m_xdim, ASTCEncode->m_ydim, ASTCEncode->m_zdim, x, y, z, ASTCEncode);
 
     ASTC_Encoder::compress_symbolic_block((ASTC_Encoder::imageblock*)&m_pb, &scb, ASTCEncode);
     ASTC_Encoder::physical_compressed_block pcb;
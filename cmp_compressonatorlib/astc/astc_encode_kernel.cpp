@@ -10265,10 +10265,28 @@ float compress_symbolic_block(imageblock* blk, symbolic_compressed_block* scb, _
     endpoints_and_weights eix1[MAX_DECIMATION_MODES];
     endpoints_and_weights eix2[MAX_DECIMATION_MODES];
 
+#ifdef __OPENCL_VERSION__
     __global2 float*   decimated_weights                         = ASTCEncode->decimated_weights;
     __global2 uint8_t* u8_quantized_decimated_quantized_weights  = ASTCEncode->u8_quantized_decimated_quantized_weights;
     __global2 float*   decimated_quantized_weights               = ASTCEncode->decimated_quantized_weights;
     __global2 float*   flt_quantized_decimated_quantized_weights = ASTCEncode->flt_quantized_decimated_quantized_weights;
+#else
+    // On the CPU the ASTC_Encode settings are shared by all threads encoding a texture,
+    // so the weight scratch arrays are kept per thread instead
+    struct WeightScratch
+    {
+        float   decimated_weights[2 * MAX_DECIMATION_MODES * MAX_WEIGHTS_PER_BLOCK];
+        uint8_t u8_quantized_decimated_quantized_weights[2 * MAX_WEIGHT_MODES * MAX_WEIGHTS_PER_BLOCK];
+        float   decimated_quantized_weights[2 * MAX_DECIMATION_MODES * MAX_WEIGHTS_PER_BLOCK];
+        float   flt_quantized_decimated_quantized_weights[2 * MAX_WEIGHT_MODES * MAX_WEIGHTS_PER_BLOCK];
+    };
+    static thread_local WeightScratch scratch;
+
+    float*   decimated_weights                         = scratch.decimated_weights;
+    uint8_t* u8_quantized_decimated_quantized_weights  = scratch.u8_quantized_decimated_quantized_weights;
+    float*   decimated_quantized_weights               = scratch.decimated_quantized_weights;
+    float*   flt_quantized_decimated_quantized_weights = scratch.flt_quantized_decimated_quantized_weights;
+#endif
 
     if (blk->red_min == blk->red_max && blk->green_min == blk->green_max && blk->blue_min == blk->blue_max && blk->alpha_min == blk->alpha_max)
     {
@@ -18,6 +18,8 @@
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <atomic>
+#include <mutex>
 
 #include "astc_host.h"
 #include "astc_encode_kernel.h"
@@ -138,6 +140,14 @@ float4 normalize(float4 p)
 }
 */
 
+// Stand-in for rand() when picking texels for bitmap partitioning: the block size descriptors
+// must be identical for every codec instance, independent of what else used rand() before
+static int bitmap_partitioning_random(unsigned int* seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (int)((*seed >> 16) & 0x7FFF);
+}
+
 #ifdef ASTC_ENABLE_3D_SUPPORT
 // These functions use new () and should either be in CPU or changed to share a pre allocated pointer
 void initialize_decimation_table_3d(
@@ -533,10 +543,11 @@ void construct_block_size_descriptor_3d_host(int xdim, int ydim, int zdim, block
         int arr[MAX_TEXELS_PER_BLOCK];
         for (i = 0; i < xdim * ydim * zdim; i++)
             arr[i] = 0;
-        int arr_elements_set = 0;
+        int          arr_elements_set = 0;
+        unsigned int seed             = 1;
         while (arr_elements_set < 64)
         {
-            int idx = rand() % (xdim * ydim * zdim);
+            int idx = bitmap_partitioning_random(&seed) % (xdim * ydim * zdim);
             if (arr[idx] == 0)
             {
                 arr_elements_set++;
@@ -997,10 +1008,11 @@ void construct_block_size_descriptor_2d_host(int xdim, int ydim, block_size_desc
         int arr[MAX_TEXELS_PER_BLOCK];
         for (i = 0; i < xdim * ydim; i++)
             arr[i] = 0;
-        int arr_elements_set = 0;
+        int          arr_elements_set = 0;
+        unsigned int seed             = 1;
         while (arr_elements_set < 64)
         {
-            int idx = rand() % (xdim * ydim);
+            int idx = bitmap_partitioning_random(&seed) % (xdim * ydim);
             if (arr[idx] == 0)
             {
                 arr_elements_set++;
@@ -1926,8 +1938,6 @@ bool init_ASTC(__global ASTC_Encode* ASTCEncode)
 //=====================================================================================================================================
 // CPU Based Decoder code
 
-extern ASTC_Encoder::ASTC_Encode g_ASTCEncode;
-
 void initialize_decimation_table_2d_cpu(
     // dimensions of the block
     int xdim,
@@ -2322,29 +2332,41 @@ void construct_block_size_descriptor_3d(int xdim, int ydim, int zdim, block_size
 }
 #endif
 
-static block_size_descriptor_cpu* bsd_pointers[4096];
+static std::atomic<block_size_descriptor_cpu*> bsd_pointers[4096];
+static std::mutex                              bsd_mutex;
 
 // function to obtain a block size descriptor. If the descriptor does not exist,
-// it is created as needed. Should not be called from within multithreaded code.
+// it is created as needed. Codecs decoding on different threads share the descriptors.
 block_size_descriptor_cpu* get_block_size_descriptor_cpu(int xdim, int ydim, int zdim)
 {
-    int bsd_index = xdim + (ydim << 4) + (zdim << 8);
-    if (bsd_pointers[bsd_index] == NULL)
+    int                        bsd_index = xdim + (ydim << 4) + (zdim << 8);
+    block_size_descriptor_cpu* bsd       = bsd_pointers[bsd_index].load(std::memory_order_acquire);
+    if (bsd == NULL)
     {
-        block_size_descriptor_cpu* bsd = new block_size_descriptor_cpu;
+        std::lock_guard<std::mutex> lock(bsd_mutex);
+        bsd = bsd_pointers[bsd_index].load(std::memory_order_relaxed);
+        if (bsd == NULL)
+        {
+            bsd = new block_size_descriptor_cpu;
 #ifdef ASTC_ENABLE_3D_SUPPORT
-        if (zdim > 1)
-            construct_block_size_descriptor_3d(xdim, ydim, zdim, bsd);
-        else
+            if (zdim > 1)
+                construct_block_size_descriptor_3d(xdim, ydim, zdim, bsd);
+            else
 #endif
-            construct_block_size_descriptor_2d_cpu(xdim, ydim, bsd);
+                construct_block_size_descriptor_2d_cpu(xdim, ydim, bsd);
 
-        bsd_pointers[bsd_index] = bsd;
+            bsd_pointers[bsd_index].store(bsd, std::memory_order_release);
+        }
     }
-    return bsd_pointers[bsd_index];
+    return bsd;
 }
 
-void physical_to_symbolic_cpu(int xdim, int ydim, int zdim, physical_compressed_block_cpu pb, symbolic_compressed_block_cpu* res)
+void physical_to_symbolic_cpu(int                              xdim,
+                              int                              ydim,
+                              int                              zdim,
+                              physical_compressed_block_cpu    pb,
+                              symbolic_compressed_block_cpu*   res,
+                              const ASTC_Encoder::ASTC_Encode* ASTCEncode)
 {
     uint8_t bswapped[16];
     int     i, j;
@@ -2519,7 +2541,7 @@ void physical_to_symbolic_cpu(int xdim, int ydim, int zdim, physical_compressed_
     if (color_bits < 0)
         color_bits = 0;
 
-    int color_quantization_level  = g_ASTCEncode.quantization_mode_table[color_integer_count >> 1][color_bits];
+    int color_quantization_level  = ASTCEncode->quantization_mode_table[color_integer_count >> 1][color_bits];
     res->color_quantization_level = color_quantization_level;
     if (color_quantization_level < 4)
         res->error_block = 1;
@@ -2715,7 +2737,9 @@ void fetch_imageblock_cpu(const astc_codec_image_cpu* img,
                           // position in texture.
                           int xpos,
                           int ypos,
-                          int zpos)
+                          int zpos,
+                          // encoder settings
+                          const ASTC_Encoder::ASTC_Encode* ASTCEncode)
 {
     float* fptr  = pb->orig_data;
     int    xsize = img->xsize + 2 * img->padding;
@@ -2840,8 +2864,8 @@ void fetch_imageblock_cpu(const astc_codec_image_cpu* img,
     // impose the choice on every pixel when encoding.
     for (i = 0; i < pixelcount; i++)
     {
-        pb->rgb_lns[i]   = (uint8_t)g_ASTCEncode.m_rgb_force_use_of_hdr;
-        pb->alpha_lns[i] = (uint8_t)g_ASTCEncode.m_alpha_force_use_of_hdr;
+        pb->rgb_lns[i]   = (uint8_t)ASTCEncode->m_rgb_force_use_of_hdr;
+        pb->alpha_lns[i] = (uint8_t)ASTCEncode->m_alpha_force_use_of_hdr;
         pb->nan_texel[i] = 0;
     }
 
@@ -2957,15 +2981,16 @@ void initialize_image_cpu(astc_codec_image_cpu* img)
     }
 }
 
-void write_imageblock_cpu(astc_codec_image_cpu* img,
-                          const imageblock_cpu* pb,
-                          int                   xdim,
-                          int                   ydim,
-                          int                   zdim,
-                          int                   xpos,
-                          int                   ypos,
-                          int                   zpos,
-                          swizzlepattern_cpu    swz)
+void write_imageblock_cpu(astc_codec_image_cpu*            img,
+                          const imageblock_cpu*            pb,
+                          int                              xdim,
+                          int                              ydim,
+                          int                              zdim,
+                          int                              xpos,
+                          int                              ypos,
+                          int                              zpos,
+                          swizzlepattern_cpu               swz,
+                          const ASTC_Encoder::ASTC_Encode* ASTCEncode)
 {
     const float*   fptr  = pb->orig_data;
     const uint8_t* nptr  = pb->nan_texel;
@@ -3003,7 +3028,7 @@ void write_imageblock_cpu(astc_codec_image_cpu* img,
                         {
 #ifdef USE_PERFORMM_SRGB_TRANSFORM
                             // apply swizzle
-                            if (g_ASTCEncode.m_perform_srgb_transform)
+                            if (ASTCEncode->m_perform_srgb_transform)
                             {
                                 float r = fptr[0];
                                 float g = fptr[1];
@@ -3098,7 +3123,7 @@ void write_imageblock_cpu(astc_codec_image_cpu* img,
                         {
 #ifdef USE_PERFORMM_SRGB_TRANSFORM
                             // apply swizzle
-                            if (g_ASTCEncode.m_perform_srgb_transform)
+                            if (ASTCEncode->m_perform_srgb_transform)
                             {
                                 float r = fptr[0];
                                 float g = fptr[1];
@@ -3355,15 +3380,16 @@ void imageblock_initialize_orig_from_work_cpu(imageblock_cpu* pb, int pixelcount
     imageblock_initialize_deriv_from_work_and_orig_cpu(pb, pixelcount);
 }
 
-void unpack_color_endpoints_cpu(ASTC_Encoder::astc_decode_mode decode_mode,
-                                int                            format,
-                                int                            quantization_level,
-                                int*                           input,
-                                int*                           rgb_hdr,
-                                int*                           alpha_hdr,
-                                int*                           nan_endpoint,
-                                ASTC_Encoder::ushort4*         output0,
-                                ASTC_Encoder::ushort4*         output1)
+void unpack_color_endpoints_cpu(ASTC_Encoder::astc_decode_mode   decode_mode,
+                                int                              format,
+                                int                              quantization_level,
+                                int*                             input,
+                                int*                             rgb_hdr,
+                                int*                             alpha_hdr,
+                                int*                             nan_endpoint,
+                                ASTC_Encoder::ushort4*           output0,
+                                ASTC_Encoder::ushort4*           output1,
+                                const ASTC_Encoder::ASTC_Encode* ASTCEncode)
 {
     *nan_endpoint = 0;
 
@@ -3472,7 +3498,7 @@ void unpack_color_endpoints_cpu(ASTC_Encoder::astc_decode_mode decode_mode,
 
     if (*alpha_hdr == -1)
     {
-        if (g_ASTCEncode.m_alpha_force_use_of_hdr)
+        if (ASTCEncode->m_alpha_force_use_of_hdr)
         {
             output0->w = 0x7800;
             output1->w = 0x7800;
@@ -3623,15 +3649,16 @@ int compute_value_of_texel_int_cpu(int texel_to_get, const decimation_table_cpu*
     return summed_value >> 4;
 }
 
-void decompress_symbolic_block_cpu(ASTC_Encoder::astc_decode_mode decode_mode,
-                                   int                            xdim,
-                                   int                            ydim,
-                                   int                            zdim,  // dimensions of block
-                                   int                            xpos,
-                                   int                            ypos,
-                                   int                            zpos,  // position of block
-                                   symbolic_compressed_block_cpu* scb,
-                                   imageblock_cpu*                blk)
+void decompress_symbolic_block_cpu(ASTC_Encoder::astc_decode_mode   decode_mode,
+                                   int                              xdim,
+                                   int                              ydim,
+                                   int                              zdim,  // dimensions of block
+                                   int                              xpos,
+                                   int                              ypos,
+                                   int                              zpos,  // position of block
+                                   symbolic_compressed_block_cpu*   scb,
+                                   imageblock_cpu*                  blk,
+                                   const ASTC_Encoder::ASTC_Encode* ASTCEncode)
 {
     blk->xpos = xpos;
     blk->ypos = ypos;
@@ -3772,7 +3799,8 @@ void decompress_symbolic_block_cpu(ASTC_Encoder::astc_decode_mode decode_mode,
                                    &(alpha_hdr_endpoint[i]),
                                    &(nan_endpoint[i]),
                                    &(color_endpoint0[i]),
-                                   &(color_endpoint1[i]));
+                                   &(color_endpoint1[i]),
+                                   ASTCEncode);
 
     // first unquantize the weights
     int uq_plane1_weights[MAX_WEIGHTS_PER_BLOCK];
@@ -3809,7 +3837,7 @@ void decompress_symbolic_block_cpu(ASTC_Encoder::astc_decode_mode decode_mode,
     // each texel.
     for (i = 0; i < texels_per_block; i++)
     {
-        ASTC_Encoder::uint8_t partition = g_ASTCEncode.partition_tables[partition_count][scb->partition_index].partition_of_texel[i];
+        ASTC_Encoder::uint8_t partition = ASTCEncode->partition_tables[partition_count][scb->partition_index].partition_of_texel[i];
 
         ASTC_Encoder::ushort4 color = lerp_color_int(
             decode_mode, color_endpoint0[partition], color_endpoint1[partition], weights[i], plane2_weights[i], is_dual_plane ? plane2_color_component : -1);
@@ -4657,29 +4657,36 @@ void initialize_image_cpu(astc_codec_image_cpu* img);
 
 void imageblock_initialize_orig_from_work_cpu(imageblock_cpu* pb, int pixelcount);
 void imageblock_initialize_work_from_orig_cpu(imageblock_cpu* pb, int pixelcount);
-void physical_to_symbolic_cpu(int xdim, int ydim, int zdim, physical_compressed_block_cpu pb, symbolic_compressed_block_cpu* res);
+void physical_to_symbolic_cpu(int                              xdim,
+                              int                              ydim,
+                              int                              zdim,
+                              physical_compressed_block_cpu    pb,
+                              symbolic_compressed_block_cpu*   res,
+                              const ASTC_Encoder::ASTC_Encode* ASTCEncode);
 
 void update_imageblock_flags_cpu(imageblock_cpu* pb, int xdim, int ydim, int zdim);
 
-void decompress_symbolic_block_cpu(ASTC_Encoder::astc_decode_mode decode_mode,
-                                   int                            xdim,
-                                   int                            ydim,
-                                   int                            zdim,  // dimensions of block
-                                   int                            xpos,
-                                   int                            ypos,
-                                   int                            zpos,  // position of block
-                                   symbolic_compressed_block_cpu* scb,
-                                   imageblock_cpu*                blk);
+void decompress_symbolic_block_cpu(ASTC_Encoder::astc_decode_mode   decode_mode,
+                                   int                              xdim,
+                                   int                              ydim,
+                                   int                              zdim,  // dimensions of block
+                                   int                              xpos,
+                                   int                              ypos,
+                                   int                              zpos,  // position of block
+                                   symbolic_compressed_block_cpu*   scb,
+                                   imageblock_cpu*                  blk,
+                                   const ASTC_Encoder::ASTC_Encode* ASTCEncode);
 
-void write_imageblock_cpu(astc_codec_image_cpu* img,
-                          const imageblock_cpu* pb,
-                          int                   xdim,
-                          int                   ydim,
-                          int                   zdim,
-                          int                   xpos,
-                          int                   ypos,
-                          int                   zpos,
-                          swizzlepattern_cpu    swz);
+void write_imageblock_cpu(astc_codec_image_cpu*            img,
+                          const imageblock_cpu*            pb,
+                          int                              xdim,
+                          int                              ydim,
+                          int                              zdim,
+                          int                              xpos,
+                          int                              ypos,
+                          int                              zpos,
+                          swizzlepattern_cpu               swz,
+                          const ASTC_Encoder::ASTC_Encode* ASTCEncode);
 
 void destroy_image_cpu(astc_codec_image_cpu* img);
 
@@ -4694,7 +4701,9 @@ void fetch_imageblock_cpu(const astc_codec_image_cpu* img,
                           // position in texture.
                           int xpos,
                           int ypos,
-                          int zpos);
+                          int zpos,
+                          // encoder settings
+                          const ASTC_Encoder::ASTC_Encode* ASTCEncode);
 
 #ifdef __OPENCL_VERSION__
 // The following is avaiable in OPENCL but not on CPU
@@ -25,11 +25,18 @@
 #include "astc/astc_definitions.h"
 #include "astc/astc_encode.h"
 #include "astc/astc_decode.h"
+#include "astc/astc_host.h"
 #include "compressonator.h"
 
+#include <mutex>
+
 extern CMP_BOOL         g_LibraryInitialized;
 static ASTCBlockDecoder g_Decoder;
 
+// Decoder tables for the block size last passed to CMP_DecodeASTCBlock
+static std::mutex                 g_DecoderMutex;
+static ASTC_Encoder::ASTC_Encode* g_DecoderSettings = NULL;
+
 // Need to remove these calls
 int astc_codec_unlink(const char* filename)
 {
@@ -59,6 +66,23 @@ extern "C" BC_ERROR CMP_DecodeASTCBlock(CMP_BYTE BlockWidth, CMP_BYTE BlockHeigh
         return BC_ERROR_INVALID_PARAMETERS;
     }
 
-    g_Decoder.DecompressBlock(BlockWidth, BlockHeight, Bitness, out, in);
+    std::lock_guard<std::mutex> lock(g_DecoderMutex);
+
+    if (!g_DecoderSettings || (g_DecoderSettings->m_xdim != BlockWidth) || (g_DecoderSettings->m_ydim != BlockHeight))
+    {
+        if (!g_DecoderSettings)
+            g_DecoderSettings = new ASTC_Encoder::ASTC_Encode();
+
+        g_DecoderSettings->m_decode_mode            = ASTC_Encoder::DECODE_HDR;
+        g_DecoderSettings->m_rgb_force_use_of_hdr   = 0;
+        g_DecoderSettings->m_alpha_force_use_of_hdr = 0;
+        g_DecoderSettings->m_perform_srgb_transform = 0;
+        g_DecoderSettings->m_xdim                   = BlockWidth;
+        g_DecoderSettings->m_ydim                   = BlockHeight;
+        g_DecoderSettings->m_zdim                   = 1;
+        ASTC_Encoder::init_ASTC(g_DecoderSettings);
+    }
+
+    g_Decoder.DecompressBlock(BlockWidth, BlockHeight, Bitness, out, in, g_DecoderSettings);
     return BC_ERROR_NONE;
 }
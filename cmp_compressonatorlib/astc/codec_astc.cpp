@@ -40,8 +40,9 @@
 #include "astc/arm/astc_codec_internals.h"
 #include "debug.h"
 
-#include <chrono>
+#include <atomic>
 #include <cstring>
+#include <mutex>
 
 #ifdef ASTC_COMPDEBUGGER
 #include "compclient.h"
@@ -51,31 +52,6 @@ extern CompViewerClient g_CompClient;
 //======================================================================================
 #define USE_MULTITHREADING 1
 
-// Gets the total numver of active processor cores on the running host system
-extern CMP_INT CMP_GetNumberOfProcessors();
-
-struct ASTCEncodeThreadParam
-{
-    ASTCBlockEncoder* encoder;
-
-    // Encoder params
-    astc_codec_image*             input_image;
-    uint8_t*                      bp;
-    int                           xdim;
-    int                           ydim;
-    int                           zdim;
-    int                           x;
-    int                           y;
-    int                           z;
-    astc_decode_mode              decode_mode;
-    const error_weighting_params* ewp;
-
-    volatile CMP_BOOL run;
-    volatile CMP_BOOL exit;
-};
-
-static ASTCEncodeThreadParam* g_EncodeParameterStorage = NULL;
-
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////////////
@@ -83,77 +59,29 @@ static ASTCEncodeThreadParam* g_EncodeParameterStorage = NULL;
 CCodec_ASTC::CCodec_ASTC()
     : CCodec_DXTC(CT_ASTC)
 {
-    m_LibraryInitialized   = false;
-    m_AbortRequested       = false;
-    m_NumThreads           = 0;
-    m_NumEncodingThreads   = 0;  // new auto setting to use max processors * 2 threads
-    m_EncodingThreadHandle = NULL;
-    m_xdim                 = 4;
-    m_ydim                 = 4;
-    m_zdim                 = 1;
-    m_decoder              = NULL;
-    m_Quality              = 0.05;
+    m_LibraryInitialized = false;
+    m_AbortRequested     = false;
+    m_NumThreads         = 0;
+    m_NumEncodingThreads = 0;  // auto setting uses all thread pool workers
+    m_Use_MultiThreading = true;
+    m_xdim               = 4;
+    m_ydim               = 4;
+    m_zdim               = 1;
+    m_decoder            = NULL;
+    m_ASTCEncode         = NULL;
+    m_Quality            = 0.05;
+
+    for (CMP_DWORD i = 0; i < MAX_ASTC_THREADS; i++)
+    {
+        m_encoder[i] = NULL;
+    }
 }
 
 CCodec_ASTC::~CCodec_ASTC()
 {
     if (m_LibraryInitialized)
     {
-        if (m_Use_MultiThreading)
-        {
-            // Tell all the live threads that they can exit when they have finished any current work
-            for (int i = 0; i < m_LiveThreads; i++)
-            {
-                // If a thread is in the running state then we need to wait for it to finish
-                // any queued work from the producer before we can tell it to exit.
-                //
-                // If we don't wait then there is a race condition here where we have
-                // told the thread to run but it hasn't yet been scheduled - if we set
-                // the exit flag before it runs then its block will not be processed.
-#pragma warning(push)
-#pragma warning(disable : 4127)  //warning C4127: conditional expression is constant
-                while (1)
-                {
-                    if (g_EncodeParameterStorage[i].run != TRUE)
-                    {
-                        break;
-                    }
-                }
-#pragma warning(pop)
-                // Signal to the thread that it can exit
-                g_EncodeParameterStorage[i].exit = TRUE;
-            }
-
-            // Now wait for all threads to have exited
-            if (m_LiveThreads > 0)
-            {
-                for (CMP_DWORD dwThread = 0; dwThread < m_LiveThreads; dwThread++)
-                {
-                    std::thread& curThread = m_EncodingThreadHandle[dwThread];
-
-                    curThread.join();
-                }
-            }
-
-            for (unsigned int i = 0; i < m_LiveThreads; i++)
-            {
-                std::thread& curThread = m_EncodingThreadHandle[i];
-
-                curThread = std::thread();
-            }
-
-            delete[] m_EncodingThreadHandle;
-        }  // MultiThreading
-
-        m_EncodingThreadHandle = NULL;
-
-        if (g_EncodeParameterStorage)
-        {
-            delete[] g_EncodeParameterStorage;
-            g_EncodeParameterStorage = NULL;
-        }
-
-        for (int i = 0; i < m_NumEncodingThreads; i++)
+        for (int i = 0; i < MAX_ASTC_THREADS; i++)
         {
             if (m_encoder[i])
             {
@@ -170,6 +98,12 @@ CCodec_ASTC::~CCodec_ASTC()
 
         m_LibraryInitialized = false;
     }
+
+    if (m_ASTCEncode)
+    {
+        delete m_ASTCEncode;
+        m_ASTCEncode = NULL;
+    }
 }
 
 void CCodec_ASTC::find_closest_blockdim_2d(float target_bitrate, int* x, int* y, int consider_illegal)
@@ -334,202 +268,147 @@ bool CCodec_ASTC::SetParameter(const CMP_CHAR* pszParamName, CODECFLOAT fValue)
     return true;
 }
 
-//
-// Thread procedure for encoding a block
-//
-// The thread stays alive, and expects blocks to be pushed to it by a producer
-// process that signals it when new work is available. When the producer is finished
-// it should set the exit flag in the parameters to allow the tread to quit
-//
-
 #include "astc_host.h"
-ASTC_Encoder::ASTC_Encode g_ASTCEncode;
 
-unsigned int ASTCThreadProcEncode(void* param)
+CodecError CCodec_ASTC::CreateASTCEncoders(CMP_INT count)
 {
-    ASTCEncodeThreadParam* tp = (ASTCEncodeThreadParam*)param;
-
-    while (tp->exit == FALSE)
+    for (CMP_INT i = 0; i < count; i++)
     {
-        if (tp->run == TRUE)
-        {
-            g_ASTCEncode.m_xdim = tp->xdim;
-            g_ASTCEncode.m_ydim = tp->ydim;
-            g_ASTCEncode.m_zdim = tp->zdim;
+        if (m_encoder[i])
+            continue;
 
-            tp->encoder->CompressBlock_kernel((ASTC_Encoder::astc_codec_image*)tp->input_image, tp->bp, tp->x, tp->y, tp->z, &g_ASTCEncode);
-
-            tp->run = FALSE;
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(0));
+        m_encoder[i] = new ASTCBlockEncoder();
+        if (!m_encoder[i])
+            return CE_Unknown;
     }
-
-    return 0;
+    return CE_OK;
 }
 
 CodecError CCodec_ASTC::InitializeASTCLibrary()
 {
     if (!m_LibraryInitialized)
     {
-        g_ASTCEncode.m_decode_mode            = ASTC_Encoder::DECODE_HDR;
-        g_ASTCEncode.m_rgb_force_use_of_hdr   = 0;
-        g_ASTCEncode.m_alpha_force_use_of_hdr = 0;
-        g_ASTCEncode.m_perform_srgb_transform = 0;
-        g_ASTCEncode.m_Quality                = (float)m_Quality;
-        g_ASTCEncode.m_target_bitrate         = m_target_bitrate;
-        g_ASTCEncode.m_xdim                   = m_xdim;
-        g_ASTCEncode.m_ydim                   = m_ydim;
-        g_ASTCEncode.m_zdim                   = m_zdim;
-        ASTC_Encoder::init_ASTC(&g_ASTCEncode);
-
-        //====================== Threads
-        for (CMP_DWORD i = 0; i < MAX_ASTC_THREADS; i++)
-        {
-            m_encoder[i] = NULL;
-        }
+        // Settings and tables are owned by this instance so several codecs can encode at the same time
+        if (!m_ASTCEncode)
+            m_ASTCEncode = new ASTC_Encoder::ASTC_Encode();
+        if (!m_ASTCEncode)
+            return CE_Unknown;
+
+        m_ASTCEncode->m_decode_mode            = ASTC_Encoder::DECODE_HDR;
+        m_ASTCEncode->m_rgb_force_use_of_hdr   = 0;
+        m_ASTCEncode->m_alpha_force_use_of_hdr = 0;
+        m_ASTCEncode->m_perform_srgb_transform = 0;
+        m_ASTCEncode->m_Quality                = (float)m_Quality;
+        m_ASTCEncode->m_target_bitrate         = m_target_bitrate;
+        m_ASTCEncode->m_xdim                   = m_xdim;
+        m_ASTCEncode->m_ydim                   = m_ydim;
+        m_ASTCEncode->m_zdim                   = m_zdim;
+        ASTC_Encoder::init_ASTC(m_ASTCEncode);
 
-        // Create threaded encoder instances
-        m_LiveThreads        = 0;
-        m_LastThread         = 0;
         m_NumEncodingThreads = MIN(m_NumThreads, (decltype(m_NumThreads))MAX_ASTC_THREADS);
         if (m_NumEncodingThreads == 0)
-        {
-            m_NumEncodingThreads = CMP_GetNumberOfProcessors();
-            if (m_NumEncodingThreads <= 2)
-                m_NumEncodingThreads = 8;  // fallback to a default!
-            if (m_NumEncodingThreads > 128)
-                m_NumEncodingThreads = 128;
-        }
+            m_NumEncodingThreads = CMP_ThreadPool::GetInstance().GetNumThreads();
         m_Use_MultiThreading = (m_NumEncodingThreads != 1);
 
-        g_EncodeParameterStorage = new ASTCEncodeThreadParam[m_NumEncodingThreads];
-        if (!g_EncodeParameterStorage)
-        {
+        // Encoders for the pool workers are created when encoding starts, the pool size can change between calls
+        if (CreateASTCEncoders(1) != CE_OK)
             return CE_Unknown;
-        }
-
-        m_EncodingThreadHandle = new std::thread[m_NumEncodingThreads];
-        if (!m_EncodingThreadHandle)
-        {
-            delete[] g_EncodeParameterStorage;
-            g_EncodeParameterStorage = NULL;
-
-            return CE_Unknown;
-        }
-
-        CMP_INT i;
-
-        for (i = 0; i < m_NumEncodingThreads; i++)
-        {
-            // Create single encoder instance
-            m_encoder[i] = new ASTCBlockEncoder();
-
-            // Cleanup if problem!
-            if (!m_encoder[i])
-            {
-                delete[] g_EncodeParameterStorage;
-                g_EncodeParameterStorage = NULL;
-
-                delete[] m_EncodingThreadHandle;
-                m_EncodingThreadHandle = NULL;
-
-                for (CMP_INT j = 0; j < i; j++)
-                {
-                    delete m_encoder[j];
-                    m_encoder[j] = NULL;
-                }
-
-                return CE_Unknown;
-            }
-
-#ifdef USE_DBGTRACE
-            //DbgTrace(("Encoder[%d]:ModeMask %X, Quality %f", i, m_ModeMask, m_Quality));
-#endif
-        }
-
-        // Create the encoding threads
-        for (i = 0; i < m_NumEncodingThreads; i++)
-        {
-            // Initialize thread parameters.
-            g_EncodeParameterStorage[i].encoder = m_encoder[i];
-            // Inform the thread that at the moment it doesn't have any work to do
-            // but that it should wait for some and not exit
-            g_EncodeParameterStorage[i].run  = FALSE;
-            g_EncodeParameterStorage[i].exit = FALSE;
-
-            m_EncodingThreadHandle[i] = std::thread(ASTCThreadProcEncode, (void*)&g_EncodeParameterStorage[i]);
-            m_LiveThreads++;
-        }
 
         // Create single decoder instance
         m_decoder = new ASTCBlockDecoder();
 
         if (!m_decoder)
         {
-            for (CMP_INT j = 0; j < m_NumEncodingThreads; j++)
-            {
-                delete m_encoder[j];
-                m_encoder[j] = NULL;
-            }
+            delete m_encoder[0];
+            m_encoder[0] = NULL;
             return CE_Unknown;
         }
 
         m_LibraryInitialized = true;
     }
+    else if ((m_ASTCEncode->m_xdim != (unsigned int)m_xdim) || (m_ASTCEncode->m_ydim != (unsigned int)m_ydim) ||
+             (m_ASTCEncode->m_zdim != (unsigned int)m_zdim))
+    {
+        // The partition and decimation tables depend on the block size
+        m_ASTCEncode->m_xdim = m_xdim;
+        m_ASTCEncode->m_ydim = m_ydim;
+        m_ASTCEncode->m_zdim = m_zdim;
+        ASTC_Encoder::init_ASTC(m_ASTCEncode);
+    }
     return CE_OK;
 }
 
 CodecError CCodec_ASTC::EncodeASTCBlock(astc_codec_image* input_image, uint8_t* bp, int xdim, int ydim, int zdim, int x, int y, int z)
 {
-    if (m_Use_MultiThreading)
-    {
-        CMP_WORD threadIndex;
+    m_ASTCEncode->m_xdim = xdim;
+    m_ASTCEncode->m_ydim = ydim;
+    m_ASTCEncode->m_zdim = zdim;
 
-        // Loop and look for an available thread
-        CMP_BOOL found = FALSE;
-        threadIndex    = m_LastThread;
-        while (found == FALSE)
-        {
-            if (g_EncodeParameterStorage == NULL)
-                return CE_Unknown;
+    m_encoder[0]->CompressBlock_kernel((ASTC_Encoder::astc_codec_image*)input_image, bp, x, y, z, m_ASTCEncode);
+    return CE_OK;
+}
 
-            if (g_EncodeParameterStorage[threadIndex].run == FALSE)
-            {
-                found = TRUE;
-                break;
-            }
+//
+// Multithreaded encoding
+//
+// Each row of blocks (over all z slices) is one index of a ParallelFor on the shared thread pool, so at most
+// m_NumEncodingThreads workers encode rows at once and nothing is queued per block. The source image is
+// already staged in input_image, workers only read it. The caller blocks in the pool until the last row is written.
+//
+CodecError CCodec_ASTC::EncodeASTCBlockRows(astc_codec_image*   input_image,
+                                            uint8_t*            bufferOutput,
+                                            int                 xblocks,
+                                            int                 yblocks,
+                                            int                 zblocks,
+                                            Codec_Feedback_Proc pFeedbackProc,
+                                            CMP_DWORD_PTR       pUser1,
+                                            CMP_DWORD_PTR       pUser2)
+{
+    CMP_ThreadPool& pool = CMP_ThreadPool::GetInstance();
 
-            // Increment and wrap the thread index
-            threadIndex++;
-            if (threadIndex == m_LiveThreads)
-            {
-                threadIndex = 0;
-            }
-        }
+    CodecError err = CreateASTCEncoders(pool.GetNumThreads());
+    if (err != CE_OK)
+        return err;
 
-        m_LastThread = threadIndex;
-
-        g_EncodeParameterStorage[threadIndex].input_image = input_image;
-        g_EncodeParameterStorage[threadIndex].bp          = bp;
-        g_EncodeParameterStorage[threadIndex].xdim        = xdim;
-        g_EncodeParameterStorage[threadIndex].ydim        = ydim;
-        g_EncodeParameterStorage[threadIndex].zdim        = zdim;
-        g_EncodeParameterStorage[threadIndex].x           = x;
-        g_EncodeParameterStorage[threadIndex].y           = y;
-        g_EncodeParameterStorage[threadIndex].z           = z;
-        // Tell the thread to start working
-        g_EncodeParameterStorage[threadIndex].run = TRUE;
-    }
-    else
-    {
-        g_ASTCEncode.m_xdim = xdim;
-        g_ASTCEncode.m_ydim = ydim;
-        g_ASTCEncode.m_zdim = zdim;
+    // Block dimensions in m_ASTCEncode are shared read-only by every row job
+    m_ASTCEncode->m_xdim = m_xdim;
+    m_ASTCEncode->m_ydim = m_ydim;
+    m_ASTCEncode->m_zdim = m_zdim;
+
+    const int                  numRows       = yblocks * zblocks;
+    CMP_INT                    lineAtPercent = (CMP_INT)(numRows * 0.01F);
+    ASTCBlockEncoder**         encoders      = m_encoder;
+    ASTC_Encoder::ASTC_Encode* ASTCEncode    = m_ASTCEncode;
+    const int                  xdim          = m_xdim;
+    const int                  ydim          = m_ydim;
+    const int                  zdim          = m_zdim;
+    std::atomic<CMP_INT>       rowsDone(0);
+    std::atomic<bool>          aborted(false);
+    std::mutex                 feedbackMutex;
+    if (lineAtPercent == 0)
+        lineAtPercent = 1;
+
+    pool.ParallelFor(numRows, m_NumEncodingThreads, [&](CMP_INT row) {
+        if (aborted)
+            return;
+
+        ASTCBlockEncoder* encoder = encoders[CMP_ThreadPool::GetWorkerIndex()];
+        const int         y       = row % yblocks;
+        const int         z       = row / yblocks;
+        uint8_t*          bp      = bufferOutput + (size_t)row * xblocks * 16;
+        for (int x = 0; x < xblocks; x++)
+            encoder->CompressBlock_kernel((ASTC_Encoder::astc_codec_image*)input_image, bp + x * 16, x * xdim, y * ydim, z * zdim, ASTCEncode);
+
+        CMP_INT done = ++rowsDone;
+        if (pFeedbackProc && ((done % lineAtPercent) == 0))
+        {
+            std::lock_guard<std::mutex> lock(feedbackMutex);
+            if (!aborted && pFeedbackProc(100.0f * done / numRows, pUser1, pUser2))
+                aborted = true;
+        }
+    });
 
-        m_encoder[0]->CompressBlock_kernel((ASTC_Encoder::astc_codec_image*)input_image, bp, x, y, z, &g_ASTCEncode);
-    }
-    return CE_OK;
+    return aborted ? CE_Aborted : CE_OK;
 }
 
 CodecError CCodec_ASTC::FinishASTCEncoding(void)
@@ -539,24 +418,6 @@ CodecError CCodec_ASTC::FinishASTCEncoding(void)
         return CE_Unknown;
     }
 
-    if (!g_EncodeParameterStorage)
-    {
-        return CE_Unknown;
-    }
-
-    if (m_Use_MultiThreading)
-    {
-        // Wait for all the live threads to finish any current work
-        for (CMP_DWORD i = 0; i < m_LiveThreads; i++)
-        {
-            // If a thread is in the running state then we need to wait for it to finish
-            // its work from the producer
-            while (g_EncodeParameterStorage[i].run == TRUE)
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
-        }
-    }
     return CE_OK;
 }
 
@@ -681,16 +542,6 @@ CodecError CCodec_ASTC::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
         }
     }
 
-    m_NumEncodingThreads = MIN(m_NumThreads, (decltype(m_NumThreads))MAX_ASTC_THREADS);
-    if (m_NumEncodingThreads == 0)
-    {
-        m_NumEncodingThreads = CMP_GetNumberOfProcessors();
-        if (m_NumEncodingThreads <= 2)
-            m_NumEncodingThreads = 8;  // fallback to a default!
-        if (m_NumEncodingThreads > 128)
-            m_NumEncodingThreads = 128;
-    }
-
     // Common ARM and AMD Code
     CodecError result       = CE_OK;
     int        xdim         = m_xdim;
@@ -706,25 +557,32 @@ CodecError CCodec_ASTC::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
     float TotalBlocks     = (float)(yblocks * xblocks);
     int   processingBlock = 0;
 
-    for (z = 0; z < zblocks; z++)
+    if (m_Use_MultiThreading)
     {
-        for (y = 0; y < yblocks; y++)
+        result = EncodeASTCBlockRows((astc_codec_image*)input_image, bufferOutput, xblocks, yblocks, zblocks, pFeedbackProc, pUser1, pUser2);
+    }
+    else
+    {
+        for (z = 0; z < zblocks; z++)
         {
-            for (x = 0; x < xblocks; x++)
+            for (y = 0; y < yblocks; y++)
             {
-                int      offset = ((z * yblocks + y) * xblocks + x) * 16;
-                uint8_t* bp     = bufferOutput + offset;
-                EncodeASTCBlock((astc_codec_image*)input_image, bp, xdim, ydim, zdim, x * xdim, y * ydim, z * zdim);
-                processingBlock++;
-            }
+                for (x = 0; x < xblocks; x++)
+                {
+                    int      offset = ((z * yblocks + y) * xblocks + x) * 16;
+                    uint8_t* bp     = bufferOutput + offset;
+                    EncodeASTCBlock((astc_codec_image*)input_image, bp, xdim, ydim, zdim, x * xdim, y * ydim, z * zdim);
+                    processingBlock++;
+                }
 
-            if (pFeedbackProc)
-            {
-                float fProgress = 100.f * ((float)(processingBlock) / TotalBlocks);
-                if (pFeedbackProc(fProgress, pUser1, pUser2))
+                if (pFeedbackProc)
                 {
-                    result = CE_Aborted;
-                    break;
+                    float fProgress = 100.f * ((float)(processingBlock) / TotalBlocks);
+                    if (pFeedbackProc(fProgress, pUser1, pUser2))
+                    {
+                        result = CE_Aborted;
+                        break;
+                    }
                 }
             }
         }
@@ -809,7 +667,7 @@ CodecError CCodec_ASTC::Decompress(CCodecBuffer&       bufferIn,
             bufferIn.ReadBlock(cmpColX * 4, cmpRowY * 4, CompData.compressedBlock, 4);
 
             // Encode to the appropriate location in the compressed image
-            m_decoder->DecompressBlock(Block_Width, Block_Height, bitness, DecData.decodedBlock, CompData.in);
+            m_decoder->DecompressBlock(Block_Width, Block_Height, bitness, DecData.decodedBlock, CompData.in, m_ASTCEncode);
 
             // Now that we have a decoded block lets copy that data over to the target image buffer
             CMP_DWORD outCol    = cmpColX * Block_Width;
@@ -33,6 +33,7 @@
 #include "codec_common.h"
 #include "codec_dxtc.h"
 #include "compressonator.h"
+#include "cmp_threadpool.h"
 
 class CCodec_ASTC : public CCodec_DXTC
 {
@@ -66,20 +67,31 @@ private:
     CMP_INT  m_NumEncodingThreads;
     bool     m_AbortRequested;
 
-    int   m_xdim, m_ydim, m_zdim;  // Is now implamented and set by user ( defined in g_ASTCEncode )
-    float m_target_bitrate;        // defined in g_ASTCEncode
+    int   m_xdim, m_ydim, m_zdim;  // Is now implamented and set by user ( defined in m_ASTCEncode )
+    float m_target_bitrate;        // defined in m_ASTCEncode
+
+    // Encoder settings and the partition, decimation and quantization tables for the current block size.
+    // Shared read-only by every block of this codec, nothing here is global so codecs can run concurrently.
+    ASTC_Encoder::ASTC_Encode* m_ASTCEncode;
 
     // ASTC Encoders and decoders: for encoding use the interfaces below
     ASTCBlockDecoder* m_decoder;
+    // Encoders are indexed by thread pool worker, slot 0 is also used for single threaded encoding
     ASTCBlockEncoder* m_encoder[MAX_ASTC_THREADS];
 
-    // Encoder interfaces
-    std::thread* m_EncodingThreadHandle;
-
     CodecError EncodeASTCBlock(astc_codec_image* input_image, uint8_t* bp, int xdim, int ydim, int zdim, int x, int y, int z);
+    CodecError EncodeASTCBlockRows(astc_codec_image*   input_image,
+                                   uint8_t*            bufferOutput,
+                                   int                 xblocks,
+                                   int                 yblocks,
+                                   int                 zblocks,
+                                   Codec_Feedback_Proc pFeedbackProc,
+                                   CMP_DWORD_PTR       pUser1,
+                                   CMP_DWORD_PTR       pUser2);
 
     CodecError FinishASTCEncoding();
     CodecError InitializeASTCLibrary();
+    CodecError CreateASTCEncoders(CMP_INT count);
 
     // Encoder interfaces
     void find_closest_blockdim_2d(float target_bitrate, int* x, int* y, int consider_illegal);
@@ -88,8 +100,6 @@ private:
 
     // Internal status
     CMP_BOOL m_Use_MultiThreading;
-    CMP_WORD m_LiveThreads;
-    CMP_WORD m_LastThread;
 
     // Speed and Quality
     double m_Quality;
@@ -30,10 +30,9 @@
 
 #include "common.h"
 #include "codec_ati1n.h"
-
-#ifdef TEST_CMP_CORE_DECODER
 #include "cmp_core.h"
-#endif
+
+#include <vector>
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -185,9 +184,40 @@ CodecError CCodec_ATI1N::Decompress(CCodecBuffer&       bufferIn,
         alphaF[i] = FLT_MAX;
     }
 
+    // RGBA:8888 buffers have the full blocks of each row decoded into a single channel row that is then
+    // expanded into the buffer
+    const bool            bDecodeRows = bUseFixed && bufferOut.GetBufferType() == CBT_RGBA8888;
+    const CMP_DWORD       dwFullX     = bufferOut.GetWidth() >> 2;
+    std::vector<CMP_BYTE> rowBlocks(bDecodeRows ? dwFullX * BLOCK_SIZE_4X4 : 0);
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
-        for (CMP_DWORD i = 0; i < dwBlocksX; i++)
+        CMP_DWORD i = 0;
+        if (bDecodeRows && dwFullX > 0 && (j * 4 + 4) <= bufferOut.GetHeight())
+        {
+            DecompressBlocksBC4(bufferIn.GetData() + j * bufferIn.GetPitch(),
+                                bufferIn.GetPitch(),
+                                dwFullX,
+                                1,
+                                rowBlocks.data(),
+                                dwFullX * 4);
+
+            for (CMP_DWORD row = 0; row < 4; row++)
+            {
+                const CMP_BYTE* pValue = &rowBlocks[row * dwFullX * 4];
+                CMP_BYTE*       pData  = bufferOut.GetData() + (j * 4 + row) * bufferOut.GetPitch();
+                for (CMP_DWORD x = 0; x < dwFullX * 4; x++, pData += 4)
+                {
+                    pData[RGBA8888_CHANNEL_R] = pValue[x];
+                    pData[RGBA8888_CHANNEL_G] = pValue[x];
+                    pData[RGBA8888_CHANNEL_B] = pValue[x];
+                    pData[RGBA8888_CHANNEL_A] = 0xFF;
+                }
+            }
+            i = dwFullX;
+        }
+
+        for (; i < dwBlocksX; i++)
         {
             CMP_DWORD compressedBlock[2];
             bufferIn.ReadBlock(i * 4, j * 4, compressedBlock, 2);
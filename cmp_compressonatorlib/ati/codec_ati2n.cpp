@@ -30,10 +30,9 @@
 
 #include "common.h"
 #include "codec_ati2n.h"
-
-#ifdef TEST_CMP_CORE_DECODER
 #include "cmp_core.h"
-#endif
+
+#include <vector>
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -203,9 +202,47 @@ CodecError CCodec_ATI2N::Decompress(CCodecBuffer&       bufferIn,
 
     CMP_DWORD compressedBlock[4];
 
+    // RGBA:8888 buffers have the full blocks of each row decoded into two single channel rows that are then
+    // expanded into the buffer, with the same channel order as the blocks written below
+    const bool            bDecodeRows = bUseFixed && bufferOut.GetBufferType() == CBT_RGBA8888;
+    const CMP_DWORD       dwFullX     = bufferOut.GetWidth() >> 2;
+    std::vector<CMP_BYTE> rowBlocks(bDecodeRows ? dwFullX * BLOCK_SIZE_4X4 * 2 : 0);
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
-        for (CMP_DWORD i = 0; i < dwBlocksX; i++)
+        CMP_DWORD i = 0;
+        if (bDecodeRows && dwFullX > 0 && (j * 4 + 4) <= bufferOut.GetHeight())
+        {
+            CMP_BYTE* pRow1 = rowBlocks.data();
+            CMP_BYTE* pRow2 = pRow1 + dwFullX * BLOCK_SIZE_4X4;
+            DecompressBlocksBC5(bufferIn.GetData() + j * bufferIn.GetPitch(),
+                                bufferIn.GetPitch(),
+                                dwFullX,
+                                1,
+                                pRow1,
+                                dwFullX * 4,
+                                pRow2,
+                                dwFullX * 4);
+
+            const CMP_BYTE* pRowX = dwXOffset ? pRow2 : pRow1;
+            const CMP_BYTE* pRowY = dwYOffset ? pRow2 : pRow1;
+            for (CMP_DWORD row = 0; row < 4; row++)
+            {
+                const CMP_BYTE* pX    = &pRowX[row * dwFullX * 4];
+                const CMP_BYTE* pY    = &pRowY[row * dwFullX * 4];
+                CMP_BYTE*       pData = bufferOut.GetData() + (j * 4 + row) * bufferOut.GetPitch();
+                for (CMP_DWORD x = 0; x < dwFullX * 4; x++, pData += 4)
+                {
+                    pData[RGBA8888_CHANNEL_R] = 0;
+                    pData[RGBA8888_CHANNEL_G] = pY[x];
+                    pData[RGBA8888_CHANNEL_B] = pX[x];
+                    pData[RGBA8888_CHANNEL_A] = 0xFF;
+                }
+            }
+            i = dwFullX;
+        }
+
+        for (; i < dwBlocksX; i++)
         {
             bufferIn.ReadBlock(i * 4, j * 4, compressedBlock, 4);
 
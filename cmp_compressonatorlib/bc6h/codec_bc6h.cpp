@@ -34,8 +34,6 @@
 #include "bc6h_definitions.h"
 #include "hdr_encode.h"
 
-#include <chrono>
-
 using namespace HDR_Encode;
 
 #ifdef BC6H_COMPDEBUGGER
@@ -46,34 +44,8 @@ extern CompViewerClient g_CompClient;
 //======================================================================================
 #define USE_MULTITHREADING 1
 
-// Gets the total numver of active processor cores on the running host system
-extern CMP_INT CMP_GetNumberOfProcessors();
-
-//
-// Thread procedure for encoding a block
-//
-// The thread stays alive, and expects blocks to be pushed to it by a producer
-// process that signals it when new work is available. When the producer is finished
-// it should set the exit flag in the parameters to allow the tread to quit
-//
-
-unsigned int BC6HThreadProcEncode(void* param)
-{
-    BC6HEncodeThreadParam* tp = (BC6HEncodeThreadParam*)param;
-
-    while (tp->exit == FALSE)
-    {
-        if (tp->run == TRUE)
-        {
-            tp->encoder->CompressBlock(tp->in, tp->out);
-            tp->run = FALSE;
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(0));
-    }
-
-    return 0;
-}
+// Blocks handed to a pool worker per wakeup, a batch is always made of whole rows of blocks
+#define BC6H_BLOCKS_PER_BATCH 64
 
 int g_block = 0;  // Keep track of current encoder block!
 
@@ -97,12 +69,15 @@ CCodec_BC6H::CCodec_BC6H(CodecType codecType)
     m_UsePatternRec = false;
 
     // Internal setting
-    m_LibraryInitialized   = false;
-    m_NumEncodingThreads   = 0;  // new auto setting to use max processors * 2 threads
-    m_EncodingThreadHandle = NULL;
-    m_LiveThreads          = 0;
-    m_LastThread           = 0;
-    m_CodecType            = codecType;
+    m_LibraryInitialized = false;
+    m_NumEncodingThreads = 0;  // auto setting uses all thread pool workers
+    m_decoder            = NULL;
+    m_CodecType          = codecType;
+
+    for (DWORD i = 0; i < BC6H_MAX_THREADS; i++)
+    {
+        m_encoder[i] = NULL;
+    }
 }
 
 bool CCodec_BC6H::SetParameter(const CMP_CHAR* pszParamName, CMP_CHAR* sValue)
@@ -174,69 +149,7 @@ CCodec_BC6H::~CCodec_BC6H()
 {
     if (m_LibraryInitialized)
     {
-        if (m_Use_MultiThreading)
-        {
-            // Tell all the live threads that they can exit when they have finished any current work
-            for (int i = 0; i < m_LiveThreads; i++)
-            {
-                // If a thread is in the running state then we need to wait for it to finish
-                // any queued work from the producer before we can tell it to exit.
-                //
-                // If we don't wait then there is a race condition here where we have
-                // told the thread to run but it hasn't yet been scheduled - if we set
-                // the exit flag before it runs then its block will not be processed.
-#pragma warning(push)
-#pragma warning(disable : 4127)  //warning C4127: conditional expression is constant
-                while (1)
-                {
-                    if (m_EncodeParameterStorage == NULL)
-                        break;
-                    if (m_EncodeParameterStorage[i].run != TRUE)
-                    {
-                        break;
-                    }
-                }
-#pragma warning(pop)
-                // Signal to the thread that it can exit
-                m_EncodeParameterStorage[i].exit = TRUE;
-            }
-
-            // Now wait for all threads to have exited
-            if (m_LiveThreads > 0)
-            {
-                for (DWORD dwThread = 0; dwThread < m_LiveThreads; dwThread++)
-                {
-                    std::thread& curThread = m_EncodingThreadHandle[dwThread];
-
-                    curThread.join();
-                }
-            }
-
-            for (unsigned int i = 0; i < m_LiveThreads; i++)
-            {
-                std::thread& curThread = m_EncodingThreadHandle[i];
-
-                curThread = std::thread();
-            }
-
-            delete[] m_EncodingThreadHandle;
-
-        }  // MultiThreading
-        else
-        {
-            // detach thread and delete
-            std::thread& curThread = m_EncodingThreadHandle[0];
-            curThread.detach();
-            delete[] m_EncodingThreadHandle;
-        }
-
-        m_EncodingThreadHandle = NULL;
-
-        if (m_EncodeParameterStorage)
-            delete[] m_EncodeParameterStorage;
-        m_EncodeParameterStorage = NULL;
-
-        for (int i = 0; i < m_NumEncodingThreads; i++)
+        for (int i = 0; i < BC6H_MAX_THREADS; i++)
         {
             if (m_encoder[i])
             {
@@ -255,187 +168,221 @@ CCodec_BC6H::~CCodec_BC6H()
     }
 }
 
+CodecError CCodec_BC6H::CCreateBC6HEncoders(CMP_INT count)
+{
+    for (CMP_INT i = 0; i < count; i++)
+    {
+        if (m_encoder[i])
+            continue;
+
+        CMP_BC6H_BLOCK_PARAMETERS user_options;
+
+        user_options.bIsSigned      = m_bIsSigned;
+        user_options.fQuality       = m_Quality;
+        user_options.dwMask         = m_ModeMask;
+        user_options.fExposure      = m_Exposure;
+        user_options.bUsePatternRec = m_UsePatternRec;
+
+        m_encoder[i] = new BC6HBlockEncoder(user_options);
+        if (!m_encoder[i])
+            return CE_Unknown;
+
+#ifdef USE_DBGTRACE
+        DbgTrace(("Encoder[%d]:ModeMask %X, Quality %f\n", i, m_ModeMask, m_Quality));
+#endif
+    }
+    return CE_OK;
+}
+
 CodecError CCodec_BC6H::CInitializeBC6HLibrary()
 {
     if (!m_LibraryInitialized)
     {
-        for (DWORD i = 0; i < BC6H_MAX_THREADS; i++)
-        {
-            m_encoder[i] = NULL;
-        }
-
-        // Create threaded encoder instances
-        m_LiveThreads        = 0;
-        m_LastThread         = 0;
         m_NumEncodingThreads = cmp_minT(m_NumThreads, BC6H_MAX_THREADS);
         if (m_NumEncodingThreads == 0)
-        {
-            m_NumEncodingThreads = CMP_GetNumberOfProcessors();
-            if (m_NumEncodingThreads <= 2)
-                m_NumEncodingThreads = 8;  // fallback to a default!
-            if (m_NumEncodingThreads > 128)
-                m_NumEncodingThreads = 128;
-        }
+            m_NumEncodingThreads = CMP_ThreadPool::GetInstance().GetNumThreads();
         m_Use_MultiThreading = (m_NumEncodingThreads != 1);
 
-        m_EncodeParameterStorage = new BC6HEncodeThreadParam[m_NumEncodingThreads];
-        if (!m_EncodeParameterStorage)
+        // Encoders for the pool workers are created when encoding starts, the pool size can change between calls
+        if (CCreateBC6HEncoders(1) != CE_OK)
+            return CE_Unknown;
+
+        // Create single decoder instance
+        m_decoder = new BC6HBlockDecoder();
+        if (!m_decoder)
         {
+            delete m_encoder[0];
+            m_encoder[0] = NULL;
             return CE_Unknown;
         }
 
-        for (int i = 0; i < m_NumEncodingThreads; i++)
-            m_EncodeParameterStorage[i].run = false;
+        m_LibraryInitialized = true;
+    }
+    return CE_OK;
+}
 
-        m_EncodingThreadHandle = new std::thread[m_NumEncodingThreads];
-        if (!m_EncodingThreadHandle)
-        {
-            delete[] m_EncodeParameterStorage;
-            m_EncodeParameterStorage = NULL;
+CodecError CCodec_BC6H::CEncodeBC6HBlock(float in[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG], BYTE* out)
+{
+    if ((!m_LibraryInitialized) || (!in) || (!out))
+    {
+        return CE_Unknown;
+    }
 
-            return CE_Unknown;
-        }
+    m_encoder[0]->CompressBlock(in, out);
+    return CE_OK;
+}
 
-        for (int i = 0; i < m_NumEncodingThreads; i++)
-        {
-            // Create single encoder instance
-            CMP_BC6H_BLOCK_PARAMETERS user_options;
+CodecError CCodec_BC6H::CFinishBC6HEncoding(void)
+{
+    if (!m_LibraryInitialized)
+    {
+        return CE_Unknown;
+    }
 
-            user_options.bIsSigned      = m_bIsSigned;
-            user_options.fQuality       = m_Quality;
-            user_options.dwMask         = m_ModeMask;
-            user_options.fExposure      = m_Exposure;
-            user_options.bUsePatternRec = m_UsePatternRec;
+    return CE_OK;
+}
 
-            m_encoder[i] = new BC6HBlockEncoder(user_options);
+//
+// Multithreaded encoding: the calling thread reads batches of source blocks into a bounded set of
+// staging slots and queues each batch as one task on the shared thread pool. When every slot is in
+// flight the caller blocks on a condition variable that the workers signal as they release a slot,
+// idle workers sleep inside the pool, so nothing polls while waiting for work.
+//
+CodecError CCodec_BC6H::CEncodeBC6HBlockBatches(CCodecBuffer&       bufferIn,
+                                                CCodecBuffer&       bufferOut,
+                                                Codec_Feedback_Proc pFeedbackProc,
+                                                CMP_DWORD_PTR       pUser1,
+                                                CMP_DWORD_PTR       pUser2)
+{
+    CMP_ThreadPool& pool = CMP_ThreadPool::GetInstance();
 
-            // Cleanup if problem!
-            if (!m_encoder[i])
-            {
-                if (m_EncodeParameterStorage)
-                    delete[] m_EncodeParameterStorage;
-                m_EncodeParameterStorage = NULL;
+    CodecError err = CCreateBC6HEncoders(pool.GetNumThreads());
+    if (err != CE_OK)
+        return err;
 
-                delete[] m_EncodingThreadHandle;
-                m_EncodingThreadHandle = NULL;
+    struct BC6HSourceBlock
+    {
+        float in[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG];
+    };
+
+    const CMP_DWORD dwBlocksX        = ((bufferIn.GetWidth() + 3) >> 2);
+    const CMP_DWORD dwBlocksY        = ((bufferIn.GetHeight() + 3) >> 2);
+    const CMP_DWORD dwRowsPerBatch   = cmp_maxT(BC6H_BLOCKS_PER_BATCH / dwBlocksX, 1u);
+    const CMP_DWORD dwBlocksPerBatch = dwRowsPerBatch * dwBlocksX;
+    const CMP_DWORD dwNumBatches     = (dwBlocksY + dwRowsPerBatch - 1) / dwRowsPerBatch;
+    CMP_DWORD       lineAtPercent    = (CMP_DWORD)(dwBlocksY * 0.01F);
+    if (lineAtPercent == 0)
+        lineAtPercent = 1;
 
-                for (int j = 0; j < i; j++)
+    // Two slots per worker keeps the workers fed while the caller reads the next batch,
+    // a user specified thread count also caps the number of batches being encoded at once
+    CMP_DWORD dwNumSlots = (m_NumThreads > 0) ? m_NumEncodingThreads : 2 * m_NumEncodingThreads;
+    dwNumSlots           = cmp_minT(dwNumSlots, dwNumBatches);
+
+    std::vector<BC6HSourceBlock> slotBlocks((size_t)dwNumSlots * dwBlocksPerBatch);
+    std::vector<CMP_DWORD>       freeSlots;
+    for (CMP_DWORD slot = 0; slot < dwNumSlots; slot++)
+        freeSlots.push_back(slot);
+
+    std::mutex              slotMutex;
+    std::condition_variable slotReleased;
+    std::atomic<CMP_DWORD>  rowsDone(0);
+    std::atomic<bool>       aborted(false);
+    CMP_DWORD               rowsReported = 0;
+    CMP_TaskGroup           batches;
+    CMP_BYTE*               pOutBuffer = bufferOut.GetData();
+    BC6HBlockEncoder**      encoders   = m_encoder;
+
+    // Blocks until at least minFreeSlots slots are free, progress is reported on every wakeup
+    auto waitForSlots = [&](size_t minFreeSlots) {
+        for (;;)
+        {
+            if (pFeedbackProc && !aborted)
+            {
+                CMP_DWORD done = rowsDone.load();
+                if (done >= rowsReported + lineAtPercent)
                 {
-                    delete m_encoder[j];
-                    m_encoder[j] = NULL;
+                    rowsReported = done;
+                    if (pFeedbackProc(100.0f * done / dwBlocksY, pUser1, pUser2))
+                        aborted = true;
                 }
-
-                return CE_Unknown;
             }
 
-#ifdef USE_DBGTRACE
-            DbgTrace(("Encoder[%d]:ModeMask %X, Quality %f\n", i, m_ModeMask, m_Quality));
-#endif
-        }
+            std::unique_lock<std::mutex> lock(slotMutex);
+            if (freeSlots.size() >= minFreeSlots)
+                return;
 
-        // Create the encoding threads
-        for (CMP_INT i = 0; i < m_NumEncodingThreads; i++)
-        {
-            // Initialize thread parameters.
-            m_EncodeParameterStorage[i].encoder = m_encoder[i];
-            // Inform the thread that at the moment it doesn't have any work to do
-            // but that it should wait for some and not exit
-            m_EncodeParameterStorage[i].run  = FALSE;
-            m_EncodeParameterStorage[i].exit = FALSE;
-
-            m_EncodingThreadHandle[i] = std::thread(BC6HThreadProcEncode, (void*)&m_EncodeParameterStorage[i]);
-            m_LiveThreads++;
-        }
-
-        // Create single decoder instance
-        m_decoder = new BC6HBlockDecoder();
-        if (!m_decoder)
-        {
-            for (CMP_INT j = 0; j < m_NumEncodingThreads; j++)
+            // A pool worker must not park while its own batches may still be sitting in its queue
+            if (CMP_ThreadPool::GetWorkerIndex() >= 0)
             {
-                delete m_encoder[j];
-                m_encoder[j] = NULL;
+                lock.unlock();
+                if (pool.RunPendingTask())
+                    continue;
+                lock.lock();
+                if (freeSlots.size() >= minFreeSlots)
+                    return;
             }
-            return CE_Unknown;
-        }
 
-        m_LibraryInitialized = true;
-    }
-    return CE_OK;
-}
+            slotReleased.wait(lock);
+        }
+    };
 
-CodecError CCodec_BC6H::CEncodeBC6HBlock(float in[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG], BYTE* out)
-{
-    if (m_Use_MultiThreading)
+    for (CMP_DWORD batch = 0; (batch < dwNumBatches) && !aborted; batch++)
     {
-        CMP_WORD threadIndex;
+        waitForSlots(1);
+        if (aborted)
+            break;
 
-        if ((!m_LibraryInitialized) || (!in) || (!out))
+        CMP_DWORD slot;
         {
-            return CE_Unknown;
+            std::lock_guard<std::mutex> lock(slotMutex);
+            slot = freeSlots.back();
+            freeSlots.pop_back();
         }
 
-        // Loop and look for an available thread
-        bool found  = FALSE;
-        threadIndex = m_LastThread;
-        while (found == FALSE)
+        const CMP_DWORD  firstRow = batch * dwRowsPerBatch;
+        const CMP_DWORD  numRows  = cmp_minT(dwRowsPerBatch, dwBlocksY - firstRow);
+        BC6HSourceBlock* blocks   = &slotBlocks[(size_t)slot * dwBlocksPerBatch];
+
+        // Source buffers are not safe to read concurrently, so all reads stay on this thread
+        for (CMP_DWORD j = 0; j < numRows; j++)
         {
-            if (m_EncodeParameterStorage[threadIndex].run == FALSE)
+            for (CMP_DWORD i = 0; i < dwBlocksX; i++)
             {
-                found = TRUE;
-                break;
+                BC6HSourceBlock& block = blocks[j * dwBlocksX + i];
+                memset(block.in, 0, sizeof(block.in));
+                bufferIn.ReadBlockRGBA(i * 4, (firstRow + j) * 4, 4, 4, &block.in[0][0]);
             }
+        }
 
-            // Increment and wrap the thread index
-            threadIndex++;
-            if (threadIndex == m_LiveThreads)
+        pool.Submit(batches, [&, slot, firstRow, numRows, blocks]() {
+            if (!aborted)
             {
-                threadIndex = 0;
+                BC6HBlockEncoder* encoder = encoders[CMP_ThreadPool::GetWorkerIndex()];
+                CMP_BYTE*         out     = pOutBuffer + (size_t)firstRow * dwBlocksX * 16;
+                for (CMP_DWORD b = 0; b < numRows * dwBlocksX; b++)
+                    encoder->CompressBlock(blocks[b].in, out + b * 16);
+                rowsDone += numRows;
             }
-        }
 
-        m_LastThread = threadIndex;
+            {
+                std::lock_guard<std::mutex> lock(slotMutex);
+                freeSlots.push_back(slot);
+            }
+            slotReleased.notify_one();
+        });
+    }
 
-        // Copy the input data into the thread storage
-        memcpy(m_EncodeParameterStorage[threadIndex].in, in, MAX_SUBSET_SIZE * MAX_DIMENSION_BIG * sizeof(float));
+    // Every slot is back once the last batch has been encoded
+    waitForSlots(dwNumSlots);
+    pool.Wait(batches);
 
-        // Set the output pointer for the thread to the provided location
-        m_EncodeParameterStorage[threadIndex].out = out;
+    if (aborted)
+        return CE_Aborted;
 
-        // Tell the thread to start working
-        m_EncodeParameterStorage[threadIndex].run = TRUE;
-    }
-    else
-    {
-        // Copy the input data into the thread storage
-        memcpy(m_EncodeParameterStorage[0].in, in, BC6H_MAX_SUBSET_SIZE * MAX_DIMENSION_BIG * sizeof(float));
-        // Set the output pointer for the thread to write
-        m_EncodeParameterStorage[0].out = out;
-        m_encoder[0]->CompressBlock(m_EncodeParameterStorage[0].in, m_EncodeParameterStorage[0].out);
-    }
-    return CE_OK;
-}
-
-CodecError CCodec_BC6H::CFinishBC6HEncoding(void)
-{
-    if (!m_LibraryInitialized)
-    {
-        return CE_Unknown;
-    }
+    if (pFeedbackProc)
+        pFeedbackProc(100.0f, pUser1, pUser2);
 
-    if (m_Use_MultiThreading)
-    {
-        // Wait for all the live threads to finish any current work
-        for (DWORD i = 0; i < m_LiveThreads; i++)
-        {
-            // If a thread is in the running state then we need to wait for it to finish
-            // its work from the producer
-            while (m_EncodeParameterStorage[i].run == TRUE)
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
-        }
-    }
     return CE_OK;
 }
 
@@ -456,6 +403,11 @@ CodecError CCodec_BC6H::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
     if (err != CE_OK)
         return err;
 
+#if !defined(BC6H_COMPDEBUGGER) && !defined(_BC6H_COMPDEBUGGER) && !defined(_SAVE_AS_BC6) && !defined(BC6H_DEBUG_TO_RESULTS_TXT)
+    if (m_Use_MultiThreading)
+        return CEncodeBC6HBlockBatches(bufferIn, bufferOut, pFeedbackProc, pUser1, pUser2);
+#endif
+
 #ifdef BC6H_COMPDEBUGGER
     CompViewerClient g_CompClient;
     if (g_CompClient.connect())
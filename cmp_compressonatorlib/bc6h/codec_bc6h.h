@@ -29,6 +29,7 @@
 #define _CODEC_BC6H_H_INCLUDED_
 
 #include <thread>
+#include <vector>
 
 #include "bc6h_encode.h"
 #include "bc6h_decode.h"
@@ -36,15 +37,7 @@
 #include "codec_common.h"
 #include "codec_dxtc.h"
 #include "compressonator.h"
-
-struct BC6HEncodeThreadParam
-{
-    BC6HBlockEncoder* encoder;
-    float             in[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG];
-    CMP_BYTE*         out;
-    volatile CMP_BOOL run;
-    volatile CMP_BOOL exit;
-};
+#include "cmp_threadpool.h"
 
 class CCodec_BC6H : public CCodec_DXTC
 {
@@ -79,8 +72,6 @@ public:
                                   CMP_DWORD_PTR       pUser2        = NULL);
 
 private:
-    BC6HEncodeThreadParam* m_EncodeParameterStorage;
-
     // BC6H User configurable variables
     CMP_WORD m_ModeMask;
     float    m_Quality;
@@ -93,17 +84,21 @@ private:
     CMP_BOOL m_LibraryInitialized;
     CMP_BOOL m_Use_MultiThreading;
     CMP_INT  m_NumEncodingThreads;
-    CMP_WORD m_LiveThreads;
-    CMP_WORD m_LastThread;
 
     // BC6H Encoders and decoders: for encding use the interfaces below
-    std::thread*      m_EncodingThreadHandle;
+    // Encoders are indexed by thread pool worker, slot 0 is also used for single threaded encoding
     BC6HBlockEncoder* m_encoder[BC6H_MAX_THREADS];
     BC6HBlockDecoder* m_decoder;
 
     // Encoder interfaces
     CodecError CInitializeBC6HLibrary();
+    CodecError CCreateBC6HEncoders(CMP_INT count);
     CodecError CEncodeBC6HBlock(float in[BC6H_BLOCK_PIXELS][MAX_DIMENSION_BIG], CMP_BYTE* out);
+    CodecError CEncodeBC6HBlockBatches(CCodecBuffer&       bufferIn,
+                                       CCodecBuffer&       bufferOut,
+                                       Codec_Feedback_Proc pFeedbackProc,
+                                       CMP_DWORD_PTR       pUser1,
+                                       CMP_DWORD_PTR       pUser2);
     CodecError CFinishBC6HEncoding(void);
 };
 
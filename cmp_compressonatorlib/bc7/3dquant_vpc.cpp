@@ -69,6 +69,9 @@ std::mutex mtx;
 
 void Quant_Init(void)
 {
+    // Codecs can be initialized from several threads at once, the tables must be complete before any of them returns
+    std::lock_guard<std::mutex> lock(mtx);
+
     if (g_Quant_init > 0)
     {
         g_Quant_init++;
@@ -77,8 +80,6 @@ void Quant_Init(void)
     if (amd_codes[0][0])
         return;
 
-    mtx.lock();
-
     for (int numClusters = 0; numClusters < MAX_CLUSTERS; numClusters++)
     {
         for (int numEntries = 0; numEntries < MAX_ENTRIES_QUANT_TRACE; numEntries++)
@@ -99,8 +100,6 @@ void Quant_Init(void)
     init_ramps();
 
     g_Quant_init++;
-
-    mtx.unlock();
 }
 
 void Quant_DeInit(void)
@@ -30,7 +30,11 @@
 #include "common.h"
 #include "codec_bc7.h"
 #include "bc7_library.h"
-#include <chrono>
+#include "cmp_core.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #ifdef BC7_COMPDEBUGGER
 #include "compclient.h"
@@ -50,35 +54,6 @@ int   bc7_blockcount = 0;
 int   bc7_total_MSE  = 0;
 #endif
 
-// Gets the total numver of active processor cores on the running host system
-extern CMP_INT CMP_GetNumberOfProcessors();
-
-//
-// Thread procedure for encoding a block
-//
-// The thread stays alive, and expects blocks to be pushed to it by a producer
-// process that signals it when new work is available. When the producer is finished
-// it should set the exit flag in the parameters to allow the tread to quit
-//
-
-unsigned int BC7ThreadProcEncode(void* param)
-{
-    BC7EncodeThreadParam* tp = (BC7EncodeThreadParam*)param;
-
-    while (tp->exit == FALSE)
-    {
-        if (tp->run == TRUE)
-        {
-            tp->encoder->CompressBlock(tp->in, tp->out);
-            tp->run = FALSE;
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(0));
-    }
-
-    return 0;
-}
-
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////////////
@@ -95,12 +70,17 @@ CCodec_BC7::CCodec_BC7()
     m_ColourRestrict     = FALSE;
     m_AlphaRestrict      = FALSE;
     m_ImageNeedsAlpha    = TRUE;
+    m_UseFloatEncoder    = FALSE;
+
+    m_NumThreads         = 0;
+    m_NumEncodingThreads = m_NumThreads;
+    m_decoder            = NULL;
+    m_coreOptions        = NULL;
 
-    m_NumThreads           = 0;
-    m_NumEncodingThreads   = m_NumThreads;
-    m_EncodingThreadHandle = NULL;
-    m_LiveThreads          = 0;
-    m_LastThread           = 0;
+    for (CMP_DWORD i = 0; i < MAX_BC7_THREADS; i++)
+    {
+        m_encoder[i] = NULL;
+    }
 }
 
 bool CCodec_BC7::SetParameter(const CMP_CHAR* pszParamName, CMP_CHAR* sValue)
@@ -120,6 +100,8 @@ bool CCodec_BC7::SetParameter(const CMP_CHAR* pszParamName, CMP_CHAR* sValue)
         m_AlphaRestrict = std::stoi(sValue) > 0 ? TRUE : FALSE;
     else if (strcmp(pszParamName, "ImageNeedsAlpha") == 0)
         m_ImageNeedsAlpha = std::stoi(sValue) > 0 ? TRUE : FALSE;
+    else if (strcmp(pszParamName, "UseFloatEncoder") == 0)
+        m_UseFloatEncoder = std::stoi(sValue) > 0 ? TRUE : FALSE;
     else if (strcmp(pszParamName, CodecParameters::NumThreads) == 0)
     {
         m_NumThreads         = (CMP_BYTE)std::stoi(sValue) & 0xFF;
@@ -157,6 +139,8 @@ bool CCodec_BC7::SetParameter(const CMP_CHAR* pszParamName, CMP_DWORD dwValue)
         m_AlphaRestrict = (dwValue & 1) ? TRUE : FALSE;
     else if (strcmp(pszParamName, "ImageNeedsAlpha") == 0)
         m_ImageNeedsAlpha = (dwValue & 1) ? TRUE : FALSE;
+    else if (strcmp(pszParamName, "UseFloatEncoder") == 0)
+        m_UseFloatEncoder = (dwValue & 1) ? TRUE : FALSE;
     else if (strcmp(pszParamName, CodecParameters::NumThreads) == 0)
     {
         m_NumThreads         = (CMP_BYTE)dwValue;
@@ -182,59 +166,7 @@ CCodec_BC7::~CCodec_BC7()
 {
     if (m_LibraryInitialized)
     {
-        if (m_Use_MultiThreading)
-        {
-            // Tell all the live threads that they can exit when they have finished any current work
-            for (int i = 0; i < m_LiveThreads; i++)
-            {
-                // If a thread is in the running state then we need to wait for it to finish
-                // any queued work from the producer before we can tell it to exit.
-                //
-                // If we don't wait then there is a race condition here where we have
-                // told the thread to run but it hasn't yet been scheduled - if we set
-                // the exit flag before it runs then its block will not be processed.
-#pragma warning(push)
-#pragma warning(disable : 4127)  //warning C4127: conditional expression is constant
-                while (1)
-                {
-                    if (m_EncodeParameterStorage[i].run != TRUE)
-                    {
-                        break;
-                    }
-                }
-#pragma warning(pop)
-                // Signal to the thread that it can exit
-                m_EncodeParameterStorage[i].exit = TRUE;
-            }
-
-            // Now wait for all threads to have exited
-            if (m_LiveThreads > 0)
-            {
-                for (CMP_DWORD dwThread = 0; dwThread < m_LiveThreads; dwThread++)
-                {
-                    std::thread& curThread = m_EncodingThreadHandle[dwThread];
-
-                    curThread.join();
-                }
-            }
-
-            for (unsigned int i = 0; i < m_LiveThreads; i++)
-            {
-                std::thread& curThread = m_EncodingThreadHandle[i];
-
-                curThread = std::thread();
-            }
-
-            delete[] m_EncodingThreadHandle;
-        }  // MultiThreading
-
-        m_EncodingThreadHandle = NULL;
-
-        if (m_EncodeParameterStorage)
-            delete[] m_EncodeParameterStorage;
-        m_EncodeParameterStorage = NULL;
-
-        for (int i = 0; i < m_NumEncodingThreads; i++)
+        for (int i = 0; i < MAX_BC7_THREADS; i++)
         {
             if (m_encoder[i])
             {
@@ -249,12 +181,36 @@ CCodec_BC7::~CCodec_BC7()
             m_decoder = NULL;
         }
 
+        if (m_coreOptions)
+        {
+            DestroyOptionsBC7(m_coreOptions);
+            m_coreOptions = NULL;
+        }
+
         Quant_DeInit();
 
         m_LibraryInitialized = false;
     }
 }
 
+CodecError CCodec_BC7::CreateBC7Encoders(CMP_INT count)
+{
+    for (CMP_INT i = 0; i < count; i++)
+    {
+        if (m_encoder[i])
+            continue;
+
+        m_encoder[i] = new BC7BlockEncoder(m_ModeMask, m_ImageNeedsAlpha, m_Quality, m_ColourRestrict, m_AlphaRestrict, m_Performance);
+        if (!m_encoder[i])
+            return CE_Unknown;
+
+#ifdef USE_DBGTRACE
+        DbgTrace(("Encoder[%d]:ModeMask %X, Quality %f", i, m_ModeMask, m_Quality));
+#endif
+    }
+    return CE_OK;
+}
+
 CodecError CCodec_BC7::InitializeBC7Library()
 {
     if (!m_LibraryInitialized)
@@ -262,94 +218,32 @@ CodecError CCodec_BC7::InitializeBC7Library()
         // One time initialisation for quantizer and shaker
         Quant_Init();
 
-        for (CMP_DWORD i = 0; i < MAX_BC7_THREADS; i++)
-        {
-            m_encoder[i] = NULL;
-        }
-
-        // Create threaded encoder instances
-        m_LiveThreads = 0;
-        m_LastThread  = 0;
         //printf("BC7 CPU Num user threads = %d\n",m_NumEncodingThreads);
         m_NumEncodingThreads = cmp_minT(m_NumThreads, MAX_BC7_THREADS);
         if (m_NumEncodingThreads == 0)
-        {
-            m_NumEncodingThreads = CMP_GetNumberOfProcessors();
-            if (m_NumEncodingThreads <= 2)
-                m_NumEncodingThreads = 8;  // fallback to a default!
-            if (m_NumEncodingThreads > 128)
-                m_NumEncodingThreads = 128;
-        }
+            m_NumEncodingThreads = CMP_ThreadPool::GetInstance().GetNumThreads();
         m_Use_MultiThreading = (m_NumEncodingThreads != 1);
 
-        m_EncodeParameterStorage = new BC7EncodeThreadParam[m_NumEncodingThreads];
-        if (!m_EncodeParameterStorage)
-        {
+        // Encoders for the pool workers are created when encoding starts, the pool size can change between calls
+        if (CreateBC7Encoders(1) != CE_OK)
             return CE_Unknown;
-        }
-
-        m_EncodingThreadHandle = new std::thread[m_NumEncodingThreads];
-        if (!m_EncodingThreadHandle)
-        {
-            delete[] m_EncodeParameterStorage;
-            m_EncodeParameterStorage = NULL;
-
-            return CE_Unknown;
-        }
 
-        CMP_INT i;
-        //printf("BC7 CPU Num threads used = %d\n",m_NumEncodingThreads);
-        for (i = 0; i < m_NumEncodingThreads; i++)
+        // The single precision encoder takes the same settings as the reference encoder, except for m_Performance
+        if (m_UseFloatEncoder)
         {
-            // Create single encoder instance
-            m_encoder[i] = new BC7BlockEncoder(m_ModeMask, m_ImageNeedsAlpha, m_Quality, m_ColourRestrict, m_AlphaRestrict, m_Performance);
-
-            // Cleanup if problem!
-            if (!m_encoder[i])
-            {
-                delete[] m_EncodeParameterStorage;
-                m_EncodeParameterStorage = NULL;
-
-                delete[] m_EncodingThreadHandle;
-                m_EncodingThreadHandle = NULL;
-
-                for (CMP_INT j = 0; j < i; j++)
-                {
-                    delete m_encoder[j];
-                    m_encoder[j] = NULL;
-                }
-
+            if (CreateOptionsBC7(&m_coreOptions) != CGU_CORE_OK)
                 return CE_Unknown;
-            }
-
-#ifdef USE_DBGTRACE
-            DbgTrace(("Encoder[%d]:ModeMask %X, Quality %f", i, m_ModeMask, m_Quality));
-#endif
-        }
-
-        // Create the encoding threads
-        for (i = 0; i < m_NumEncodingThreads; i++)
-        {
-            // Initialize thread parameters.
-            m_EncodeParameterStorage[i].encoder = m_encoder[i];
-            // Inform the thread that at the moment it doesn't have any work to do
-            // but that it should wait for some and not exit
-            m_EncodeParameterStorage[i].run  = FALSE;
-            m_EncodeParameterStorage[i].exit = FALSE;
-
-            m_EncodingThreadHandle[i] = std::thread(BC7ThreadProcEncode, (void*)&m_EncodeParameterStorage[i]);
-            m_LiveThreads++;
+            SetQualityBC7(m_coreOptions, (CGU_FLOAT)m_Quality);
+            SetMaskBC7(m_coreOptions, (CGU_UINT8)(m_ModeMask ? m_ModeMask : 0xCF));  // BC7BlockEncoder default when no modes are set
+            SetAlphaOptionsBC7(m_coreOptions, m_ImageNeedsAlpha, m_ColourRestrict, m_AlphaRestrict);
         }
 
         // Create single decoder instance
         m_decoder = new BC7BlockDecoder();
         if (!m_decoder)
         {
-            for (CMP_INT j = 0; j < m_NumEncodingThreads; j++)
-            {
-                delete m_encoder[j];
-                m_encoder[j] = NULL;
-            }
+            delete m_encoder[0];
+            m_encoder[0] = NULL;
             return CE_Unknown;
         }
 
@@ -360,62 +254,36 @@ CodecError CCodec_BC7::InitializeBC7Library()
 
 CodecError CCodec_BC7::EncodeBC7Block(double in[BC7_BLOCK_PIXELS][MAX_DIMENSION_BIG], CMP_BYTE* out)
 {
-#ifdef USE_SINGLETHREADING
-    m_Use_MultiThreading = false;
-#endif
-
-    if (m_Use_MultiThreading)
+    if ((!m_LibraryInitialized) || (!in) || (!out))
     {
-        CMP_WORD threadIndex;
-
-        if ((!m_LibraryInitialized) || (!in) || (!out))
-        {
-            return CE_Unknown;
-        }
-
-        // Loop and look for an available thread
-        CMP_BOOL found = FALSE;
-        threadIndex    = m_LastThread;
-        while (found == FALSE)
-        {
-            if (m_EncodeParameterStorage == NULL)
-                return CE_Unknown;
-
-            if (m_EncodeParameterStorage[threadIndex].run == FALSE)
-            {
-                found = TRUE;
-                break;
-            }
-
-            // Increment and wrap the thread index
-            threadIndex++;
-            if (threadIndex == m_LiveThreads)
-            {
-                threadIndex = 0;
-            }
-        }
-
-        m_LastThread = threadIndex;
-
-        // Copy the input data into the thread storage
-        std::memcpy(m_EncodeParameterStorage[threadIndex].in, in, MAX_SUBSET_SIZE * MAX_DIMENSION_BIG * sizeof(double));
+        return CE_Unknown;
+    }
 
-        // Set the output pointer for the thread to the provided location
-        m_EncodeParameterStorage[threadIndex].out = out;
+    //printf("BC7 CPU Single Threaded\n");
+    m_encoder[0]->CompressBlock(in, out);
+    return CE_OK;
+}
 
-        // Tell the thread to start working
-        m_EncodeParameterStorage[threadIndex].run = TRUE;
+// Encodes one block read with ReadBlockRGBA. The single precision encoder takes the 8 bit
+// block as it is, the reference encoder works on a double copy of it.
+void CCodec_BC7::EncodeBC7SourceBlock(BC7BlockEncoder* encoder, const CMP_BYTE srcBlock[BLOCK_SIZE_4X4X4], CMP_BYTE* out)
+{
+    if (m_coreOptions)
+    {
+        CompressBlockBC7(srcBlock, BLOCK_SIZE_4 * 4, out, m_coreOptions);
+        return;
     }
-    else
+
+    double blockToEncode[BLOCK_SIZE_4X4][CHANNEL_SIZE_ARGB];
+    for (int k = 0; k < BLOCK_SIZE_4X4; k++)
     {
-        //printf("BC7 CPU Single Threaded\n");
-        // Copy the input data into the thread storage
-        std::memcpy(m_EncodeParameterStorage[0].in, in, MAX_SUBSET_SIZE * MAX_DIMENSION_BIG * sizeof(double));
-        // Set the output pointer for the thread to write
-        m_EncodeParameterStorage[0].out = out;
-        m_encoder[0]->CompressBlock(m_EncodeParameterStorage[0].in, m_EncodeParameterStorage[0].out);
+        blockToEncode[k][BC_COMP_RED]   = (double)srcBlock[k * 4];
+        blockToEncode[k][BC_COMP_GREEN] = (double)srcBlock[k * 4 + 1];
+        blockToEncode[k][BC_COMP_BLUE]  = (double)srcBlock[k * 4 + 2];
+        blockToEncode[k][BC_COMP_ALPHA] = (double)srcBlock[k * 4 + 3];
     }
-    return CE_OK;
+
+    encoder->CompressBlock(blockToEncode, out);
 }
 
 CodecError CCodec_BC7::FinishBC7Encoding(void)
@@ -425,25 +293,77 @@ CodecError CCodec_BC7::FinishBC7Encoding(void)
         return CE_Unknown;
     }
 
-    if (!m_EncodeParameterStorage)
+    return CE_OK;
+}
+
+//
+// Multithreaded encoding
+//
+// Each row of blocks is handed out as one job on the shared thread pool and reads its own source blocks.
+// 8 bit buffers read their pixels directly; the other formats convert through CCodecBuffer, which keeps
+// per buffer conversion state, so those reads are serialized while the encodes still run in parallel.
+// Workers pull rows until the image is done while the caller blocks in the pool until the last row is written.
+//
+CodecError CCodec_BC7::EncodeBC7BlockRows(CCodecBuffer&       bufferIn,
+                                          CCodecBuffer&       bufferOut,
+                                          Codec_Feedback_Proc pFeedbackProc,
+                                          CMP_DWORD_PTR       pUser1,
+                                          CMP_DWORD_PTR       pUser2)
+{
+    CMP_ThreadPool& pool = CMP_ThreadPool::GetInstance();
+
+    if (!m_coreOptions)
     {
-        return CE_Unknown;
+        CodecError err = CreateBC7Encoders(pool.GetNumThreads());
+        if (err != CE_OK)
+            return err;
     }
 
-    if (m_Use_MultiThreading)
-    {
-        // Wait for all the live threads to finish any current work
-        for (CMP_DWORD i = 0; i < m_LiveThreads; i++)
+    const CMP_DWORD dwBlocksX     = ((bufferIn.GetWidth() + 3) >> 2);
+    const CMP_DWORD dwBlocksY     = ((bufferIn.GetHeight() + 3) >> 2);
+    CMP_DWORD       lineAtPercent = (CMP_DWORD)(dwBlocksY * 0.01F);
+    if (lineAtPercent == 0)
+        lineAtPercent = 1;
+
+    const CodecBufferType srcType    = bufferIn.GetBufferType();
+    const bool            directRead = (srcType == CBT_RGBA8888 || srcType == CBT_RGB888 || srcType == CBT_RG8 || srcType == CBT_R8);
+    std::mutex            readMutex;
+
+    CMP_BYTE*              pOutBuffer = bufferOut.GetData();
+    BC7BlockEncoder**      encoders   = m_encoder;
+    std::atomic<CMP_DWORD> rowsDone(0);
+    std::atomic<bool>      aborted(false);
+    std::mutex             feedbackMutex;
+
+    pool.ParallelFor(dwBlocksY, m_NumEncodingThreads, [&](CMP_INT row) {
+        if (aborted)
+            return;
+
+        BC7BlockEncoder* encoder = encoders[CMP_ThreadPool::GetWorkerIndex()];
+        CMP_BYTE         srcBlock[BLOCK_SIZE_4X4X4];
+        for (CMP_DWORD i = 0; i < dwBlocksX; i++)
         {
-            // If a thread is in the running state then we need to wait for it to finish
-            // its work from the producer
-            while (m_EncodeParameterStorage[i].run == TRUE)
+            memset(srcBlock, 0, sizeof(srcBlock));
+            if (directRead)
+                bufferIn.ReadBlockRGBA(i * 4, row * 4, 4, 4, srcBlock);
+            else
             {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                std::lock_guard<std::mutex> lock(readMutex);
+                bufferIn.ReadBlockRGBA(i * 4, row * 4, 4, 4, srcBlock);
             }
+            EncodeBC7SourceBlock(encoder, srcBlock, pOutBuffer + ((size_t)row * dwBlocksX + i) * 16);
         }
-    }
-    return CE_OK;
+
+        CMP_DWORD done = ++rowsDone;
+        if (pFeedbackProc && ((done % lineAtPercent) == 0))
+        {
+            std::lock_guard<std::mutex> lock(feedbackMutex);
+            if (!aborted && pFeedbackProc(100.0f * done / dwBlocksY, pUser1, pUser2))
+                aborted = true;
+        }
+    });
+
+    return aborted ? CE_Aborted : CE_OK;
 }
 
 #ifdef USE_THREADED_CALLBACKS
@@ -488,6 +408,11 @@ CodecError CCodec_BC7::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut,
     if (err != CE_OK)
         return err;
 
+#if !defined(BC7_COMPDEBUGGER) && !defined(USE_FILEIO) && !defined(USE_THREADED_CALLBACKS) && !defined(USE_SINGLETHREADING)
+    if (m_Use_MultiThreading)
+        return EncodeBC7BlockRows(bufferIn, bufferOut, pFeedbackProc, pUser1, pUser2);
+#endif
+
 #ifdef USE_THREADED_CALLBACKS
     // Create a progress thread that will track
     // the current progress of encoding 100% = done
@@ -534,8 +459,6 @@ CodecError CCodec_BC7::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut,
     DbgTrace(("   : Height %d Width %d Pitch %d isFloat %d", bufferOut.GetHeight(), bufferOut.GetWidth(), bufferOut.GetWidth(), bufferOut.IsFloat()));
 #endif
 
-    char row, col, srcIndex;
-
     CMP_BYTE* pOutBuffer;
     pOutBuffer = bufferOut.GetData();
 
@@ -562,7 +485,6 @@ CodecError CCodec_BC7::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut,
             DbgTrace(("--------------  Block: x=%3d y=%3d ---------------", i, j));
 #endif
 
-            double   blockToEncode[BLOCK_SIZE_4X4][CHANNEL_SIZE_ARGB];
             CMP_BYTE srcBlock[BLOCK_SIZE_4X4X4];
 
             memset(srcBlock, 0, sizeof(srcBlock));
@@ -575,22 +497,8 @@ CodecError CCodec_BC7::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut,
             }
 #endif
 
-            // Create the block for encoding
-            srcIndex = 0;
-            for (row = 0; row < BLOCK_SIZE_4; row++)
-            {
-                for (col = 0; col < BLOCK_SIZE_4; col++)
-                {
-                    blockToEncode[row * BLOCK_SIZE_4 + col][BC_COMP_RED]   = (double)srcBlock[srcIndex];
-                    blockToEncode[row * BLOCK_SIZE_4 + col][BC_COMP_GREEN] = (double)srcBlock[srcIndex + 1];
-                    blockToEncode[row * BLOCK_SIZE_4 + col][BC_COMP_BLUE]  = (double)srcBlock[srcIndex + 2];
-                    blockToEncode[row * BLOCK_SIZE_4 + col][BC_COMP_ALPHA] = (double)srcBlock[srcIndex + 3];
-                    srcIndex += 4;
-                }
-            }
-
             // printf("[i %3d, j%3d]\n",i,j);
-            EncodeBC7Block(blockToEncode, pOutBuffer + block);
+            EncodeBC7SourceBlock(m_encoder[0], srcBlock, pOutBuffer + block);
 
 #ifdef BC7_COMPDEBUGGER  // Checks decompression it should match or be close to source
             if (CompClient.Connected())
@@ -635,9 +543,9 @@ CodecError CCodec_BC7::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut,
 
             for (int y = 0; y < 16; y++)
             {
-                bMSE += pow(blockToSave[y][2] - blockToEncode[y][2], 2.0);
-                gMSE += pow(blockToSave[y][1] - blockToEncode[y][1], 2.0);
-                rMSE += pow(blockToSave[y][0] - blockToEncode[y][0], 2.0);
+                bMSE += pow(blockToSave[y][2] - srcBlock[y * 4 + 2], 2.0);
+                gMSE += pow(blockToSave[y][1] - srcBlock[y * 4 + 1], 2.0);
+                rMSE += pow(blockToSave[y][0] - srcBlock[y * 4], 2.0);
             }
 
             bMSE *= (1.0 / 16);
@@ -754,9 +662,25 @@ CodecError CCodec_BC7::Decompress(CCodecBuffer&       bufferIn,
     const CMP_DWORD dwBlocksY = ((bufferIn.GetHeight() + 3) >> 2);
     const CMP_FLOAT fBlocksXY = (CMP_FLOAT)(dwBlocksX * dwBlocksY);
 
+    // RGBA:8888 buffers have the full blocks of each row decoded straight into the buffer
+    const bool      bDecodeRows = bufferOut.GetBufferType() == CBT_RGBA8888;
+    const CMP_DWORD dwFullX     = bufferOut.GetWidth() >> 2;
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
-        for (CMP_DWORD i = 0; i < dwBlocksX; i++)
+        CMP_DWORD i = 0;
+        if (bDecodeRows && (j * 4 + 4) <= bufferOut.GetHeight())
+        {
+            DecompressBlocksBC7(bufferIn.GetData() + j * bufferIn.GetPitch(),
+                                bufferIn.GetPitch(),
+                                dwFullX,
+                                1,
+                                bufferOut.GetData() + j * 4 * bufferOut.GetPitch(),
+                                bufferOut.GetPitch());
+            i = dwFullX;
+        }
+
+        for (; i < dwBlocksX; i++)
         {
             union FBLOCKS
             {
@@ -36,6 +36,7 @@
 #include "codec_common.h"
 #include "codec_dxtc.h"
 #include "compressonator.h"
+#include "cmp_threadpool.h"
 
 // #define USE_THREADED_CALLBACKS  // This is experimental code to improve compression performance!
 #ifdef USE_THREADED_CALLBACKS
@@ -46,15 +47,6 @@ typedef struct
 } CMP_PROGRESS_THREAD;
 #endif
 
-struct BC7EncodeThreadParam
-{
-    BC7BlockEncoder*  encoder;
-    double            in[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG];
-    CMP_BYTE*         out;
-    volatile CMP_BOOL run;
-    volatile CMP_BOOL exit;
-};
-
 class CCodec_BC7 : public CCodec_DXTC
 {
 public:
@@ -88,8 +80,6 @@ public:
                                   CMP_DWORD_PTR       pUser2        = NULL);
 
 private:
-    BC7EncodeThreadParam* m_EncodeParameterStorage;
-
     // BC7 User configurable variables
     CMP_DWORD m_ModeMask;
     double    m_Quality;
@@ -98,23 +88,32 @@ private:
     CMP_BOOL  m_AlphaRestrict;
     CMP_WORD  m_NumThreads;
     CMP_BOOL  m_ImageNeedsAlpha;
+    CMP_BOOL  m_UseFloatEncoder;
 
     // BC7 Internal status
     CMP_BOOL m_LibraryInitialized;
     CMP_BOOL m_Use_MultiThreading;
     CMP_INT  m_NumEncodingThreads;
-    CMP_WORD m_LiveThreads;
-    CMP_WORD m_LastThread;
 
     // BC7 Encoders and decoders: for encding use the interfaces below
-    std::thread*     m_EncodingThreadHandle;
+    // Encoders are indexed by thread pool worker, slot 0 is also used for single threaded encoding
     BC7BlockEncoder* m_encoder[MAX_BC7_THREADS];
     BC7BlockDecoder* m_decoder;
 
+    // CMP_Core BC7 options used by the single precision encoder, the options are only read while encoding
+    void* m_coreOptions;
+
     // Encoder interfaces
     CodecError InitializeBC7Library();
+    CodecError CreateBC7Encoders(CMP_INT count);
     CodecError EncodeBC7Block(double in[BC7_BLOCK_PIXELS][MAX_DIMENSION_BIG], CMP_BYTE* out);
+    void       EncodeBC7SourceBlock(BC7BlockEncoder* encoder, const CMP_BYTE srcBlock[BLOCK_SIZE_4X4X4], CMP_BYTE* out);
     CodecError FinishBC7Encoding(void);
+    CodecError EncodeBC7BlockRows(CCodecBuffer&       bufferIn,
+                                  CCodecBuffer&       bufferOut,
+                                  Codec_Feedback_Proc pFeedbackProc,
+                                  CMP_DWORD_PTR       pUser1,
+                                  CMP_DWORD_PTR       pUser2);
 
     static void Run();
 
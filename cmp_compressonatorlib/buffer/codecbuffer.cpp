@@ -53,6 +53,7 @@
 #include "codecbuffer_r32f.h"
 #include "codecbuffer_block.h"
 #include "codecbuffer_rgb9995ef.h"
+#include "halfconvert.h"
 
 CCodecBuffer* CreateCodecBuffer(CodecBufferType nCodecBufferType,
                                 CMP_BYTE        nBlockWidth,
@@ -269,7 +270,7 @@ CCodecBuffer::~CCodecBuffer()
 #endif
     if (m_pData && !m_bUserAllocedData)
     {
-        free(m_pData);
+        CMP_MemFree(m_pData);
         m_pData = NULL;
     }
 }
@@ -3066,10 +3067,7 @@ void CCodecBuffer::ConvertBlock(float fBlock[], CMP_HALF hBlock[], CMP_DWORD dwB
     assert(hBlock);
     assert(dwBlockSize);
     if (fBlock && hBlock && dwBlockSize)
-    {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            fBlock[i] = (float)hBlock[i];
-    }
+        ConvertHalfToFloat(fBlock, hBlock, dwBlockSize);
 }
 
 void CCodecBuffer::ConvertBlock(float fBlock[], CMP_DWORD dwBlock[], CMP_DWORD dwBlockSize)
@@ -3162,10 +3160,7 @@ void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], float fBlock[], CMP_DWORD dwB
     assert(fBlock);
     assert(dwBlockSize);
     if (hBlock && fBlock && dwBlockSize)
-    {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            hBlock[i] = (float)fBlock[i];
-    }
+        ConvertFloatToHalf(hBlock, fBlock, dwBlockSize);
 }
 
 void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], CMP_DWORD dwBlock[], CMP_DWORD dwBlockSize)
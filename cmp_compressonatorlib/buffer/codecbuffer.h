@@ -32,6 +32,7 @@
 #include "common.h"
 #include "compressonator.h"
 #include "mathmacros.h"
+#include "cmp_memory.h"
 
 typedef enum _CodecBufferType
 {
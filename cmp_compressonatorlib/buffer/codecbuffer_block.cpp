@@ -120,7 +120,7 @@ CCodecBuffer_Block::CCodecBuffer_Block(CodecBufferType nCodecBufferType,
     if (m_pData == NULL)
     {
         CMP_DWORD dwSize = dwBlocks * m_dwBlockSize;
-        m_pData          = (CMP_BYTE*)malloc(dwSize);
+        m_pData          = (CMP_BYTE*)CMP_MemAlloc(dwSize);
     }
 }
 
@@ -54,7 +54,7 @@ CCodecBuffer_R16F::CCodecBuffer_R16F(CMP_BYTE  nBlockWidth,
     if (m_pData == NULL)
     {
         CMP_DWORD dwSize = m_dwPitch * GetHeight();
-        m_pData          = (CMP_BYTE*)malloc(dwSize);
+        m_pData          = (CMP_BYTE*)CMP_MemAlloc(dwSize);
     }
 }
 
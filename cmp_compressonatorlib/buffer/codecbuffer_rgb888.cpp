@@ -56,7 +56,7 @@ CCodecBuffer_RGB888::CCodecBuffer_RGB888(CMP_BYTE  nBlockWidth,
     if (m_pData == NULL)
     {
         m_DataSize = m_dwPitch * m_dwHeight;
-        m_pData    = (CMP_BYTE*)calloc(1, m_DataSize);
+        m_pData    = (CMP_BYTE*)CMP_MemCalloc(m_DataSize);
     }
 
     m_dwFormat = CMP_FORMAT_RGB_888;
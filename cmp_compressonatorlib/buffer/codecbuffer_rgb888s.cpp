@@ -56,7 +56,7 @@ CCodecBuffer_RGB888S::CCodecBuffer_RGB888S(CMP_BYTE  nBlockWidth,
     if (m_pData == NULL)
     {
         m_DataSize = m_dwPitch * GetHeight();
-        m_pData    = (CMP_BYTE*)calloc(m_DataSize, sizeof(CMP_SBYTE));
+        m_pData    = (CMP_BYTE*)CMP_MemCalloc(m_DataSize * sizeof(CMP_SBYTE));
     }
 
     m_dwFormat = CMP_FORMAT_RGB_888_S;
@@ -29,6 +29,7 @@
 
 #include "common.h"
 #include "codecbuffer_rgba16f.h"
+#include "halfconvert.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -55,7 +56,7 @@ CCodecBuffer_RGBA16F::CCodecBuffer_RGBA16F(CMP_BYTE  nBlockWidth,
     if (m_pData == NULL)
     {
         CMP_DWORD dwSize = m_dwPitch * GetHeight();
-        m_pData          = (CMP_BYTE*)malloc(dwSize);
+        m_pData          = (CMP_BYTE*)CMP_MemAlloc(dwSize);
     }
 }
 
@@ -228,3 +229,52 @@ bool CCodecBuffer_RGBA16F::WriteBlockRGBA(CMP_DWORD x, CMP_DWORD y, CMP_BYTE w,
     }
     return true;
 }
+
+bool CCodecBuffer_RGBA16F::ReadBlockRGBA(CMP_DWORD x, CMP_DWORD y, CMP_BYTE w, CMP_BYTE h, float block[])
+{
+    assert(x < GetWidth());
+    assert(y < GetHeight());
+    assert(x % w == 0);
+    assert(y % h == 0);
+
+    if (x >= GetWidth() || y >= GetHeight())
+        return false;
+
+    CMP_DWORD dwWidth = cmp_minT(w, (GetWidth() - x));
+
+    CMP_DWORD j;
+    for (j = 0; j < h && (y + j) < GetHeight(); j++)
+    {
+        CMP_HALF* pData = (CMP_HALF*)(GetData() + ((y + j) * m_dwPitch) + (x * RGBA16F_nPixelSize));
+        ConvertHalfToFloat(GET_PIXEL(0, j), pData, dwWidth * RGBA16F_nChannelCount);
+
+        // Pad line with previous values if necessary
+        if (dwWidth < w)
+            PadLine(dwWidth, w, 4, &block[j * w * RGBA16F_nChannelCount]);
+    }
+
+    // Pad block with previous values if necessary
+    if (j < h)
+        PadBlock(j, w, h, 4, block);
+    return true;
+}
+
+bool CCodecBuffer_RGBA16F::WriteBlockRGBA(CMP_DWORD x, CMP_DWORD y, CMP_BYTE w, CMP_BYTE h, float block[])
+{
+    assert(x < GetWidth());
+    assert(y < GetHeight());
+    assert(x % w == 0);
+    assert(y % h == 0);
+
+    if (x >= GetWidth() || y >= GetHeight())
+        return false;
+
+    CMP_DWORD dwWidth = cmp_minT(w, (GetWidth() - x));
+
+    for (CMP_DWORD j = 0; j < h && (y + j) < GetHeight(); j++)
+    {
+        CMP_HALF* pData = (CMP_HALF*)(GetData() + ((y + j) * m_dwPitch) + (x * RGBA16F_nPixelSize));
+        ConvertFloatToHalf(pData, GET_PIXEL(0, j), dwWidth * RGBA16F_nChannelCount);
+    }
+    return true;
+}
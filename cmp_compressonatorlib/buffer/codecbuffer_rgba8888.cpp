@@ -54,7 +54,7 @@ CCodecBuffer_RGBA8888::CCodecBuffer_RGBA8888(CMP_BYTE  nBlockWidth,
     if (m_pData == NULL)
     {
         m_DataSize = m_dwPitch * GetHeight();
-        m_pData    = (CMP_BYTE*)calloc(1, m_DataSize);
+        m_pData    = (CMP_BYTE*)CMP_MemCalloc(m_DataSize);
     }
 
     m_dwFormat = CMP_FORMAT_RGBA_8888;
@@ -254,14 +254,14 @@ bool CCodecBuffer_RGBA8888::ReadBlockRGBA(CMP_DWORD xw, CMP_DWORD yh, CMP_BYTE w
             {
                 for (iw = 0; iw < minWidth; iw++)
                 {
-                    pdwBlock[(jh * minWidth) + iw] = SWIZZLE_RGBA_BGRA(pdwData[iw]);
+                    pdwBlock[(jh * w) + iw] = SWIZZLE_RGBA_BGRA(pdwData[iw]);
                 }
             }
             else
             {
                 for (iw = 0; iw < minWidth; iw++)
                 {
-                    pdwBlock[(jh * minWidth) + iw] = pdwData[iw];
+                    pdwBlock[(jh * w) + iw] = pdwData[iw];
                 }
             }
 
@@ -294,7 +294,7 @@ bool CCodecBuffer_RGBA8888::WriteBlockRGBA(CMP_DWORD x, CMP_DWORD y, CMP_BYTE w,
         CMP_DWORD* pData = (CMP_DWORD*)(GetData() + ((y + j) * m_dwPitch) + (x * sizeof(CMP_DWORD)));
 
         for (CMP_DWORD i = 0; i < dwWidth; i++)
-            *pData++ = pdwBlock[(j * dwWidth) + i];
+            *pData++ = pdwBlock[(j * w) + i];
     }
 
     return true;
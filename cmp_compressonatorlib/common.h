@@ -161,6 +161,10 @@ struct CMP_CMIPS
     bool AllocateMipLevelData(CMP_MipLevel* pMipLevel, CMP_INT nWidth, CMP_INT nHeight, CMP_ChannelFormat channelFormat, CMP_TextureDataType textureDataType);
     bool AllocateCompressedMipLevelData(CMP_MipLevel* pMipLevel, CMP_INT nWidth, CMP_INT nHeight, CMP_DWORD dwSize);
 
+    // Allocates the data of every mip level and face of a mip set made by AllocateMipSet as one 64 byte aligned block and sets
+    // MS_FLAG_ContiguousLevels. FreeMipSet releases the block, its levels must not be freed or reallocated one by one.
+    bool AllocateContiguousMipLevels(CMP_MipSet* pMipSet);
+
     void FreeMipSet(CMP_MipSet* pMipSet);            // Removes entire mipset
     void FreeMipLevelData(CMP_MipLevel* pMipLevel);  // removes a single miplevel generated by ...MipLevelData()
 
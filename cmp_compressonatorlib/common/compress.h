@@ -56,13 +56,25 @@
 // TODO: This probably shouldn't be defined in compress.cpp
 CMP_INT CMP_GetNumberOfProcessors();
 
-CMP_ERROR CodecCompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, const CMP_CompressOptions* options, CMP_Feedback_Proc feedbackProc);
+CMP_ERROR CodecCompressTexture(const CMP_Texture*         srcTexture,
+                               CMP_Texture*               destTexture,
+                               const CMP_CompressOptions* options,
+                               CMP_Feedback_Proc          feedbackProc,
+                               CMP_DWORD_PTR              pUser1 = NULL,
+                               CMP_DWORD_PTR              pUser2 = NULL);
 
 CMP_ERROR CodecCompressTextureThreaded(const CMP_Texture*         srcTexture,
                                        CMP_Texture*               destTexture,
                                        const CMP_CompressOptions* options,
-                                       CMP_Feedback_Proc          feedbackProc);
+                                       CMP_Feedback_Proc          feedbackProc,
+                                       CMP_DWORD_PTR              pUser1 = NULL,
+                                       CMP_DWORD_PTR              pUser2 = NULL);
 
-CMP_ERROR CodecDecompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, const CMP_CompressOptions* options, CMP_Feedback_Proc feedbackProc);
+CMP_ERROR CodecDecompressTexture(const CMP_Texture*         srcTexture,
+                                 CMP_Texture*               destTexture,
+                                 const CMP_CompressOptions* options,
+                                 CMP_Feedback_Proc          feedbackProc,
+                                 CMP_DWORD_PTR              pUser1 = NULL,
+                                 CMP_DWORD_PTR              pUser2 = NULL);
 
 #endif  // !COMPRESS_H
@@ -29,7 +29,10 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 #include "windows.h"
@@ -42,9 +45,13 @@
 #include "common.h"
 #include "compressonator.h"
 #include "texture_utils.h"
+#include "cmp_threadpool.h"
 
 #define MAX_THREADS 64
 
+// Block rows per tile in CodecCompressTextureThreaded when CMP_CompressOptions::dwTileHeight is 0
+#define CMP_DEFAULT_TILE_HEIGHT 4
+
 CMP_INT CMP_GetNumberOfProcessors()
 {
 #ifndef _WIN32
@@ -189,7 +196,12 @@ static void CMP_PrepareCMPSourceForIMG_Destination(CMP_Texture* destTexture, CMP
 
 #endif
 
-CMP_ERROR CodecCompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, const CMP_CompressOptions* options, CMP_Feedback_Proc feedbackProc)
+CMP_ERROR CodecCompressTexture(const CMP_Texture*         srcTexture,
+                               CMP_Texture*               destTexture,
+                               const CMP_CompressOptions* options,
+                               CMP_Feedback_Proc          feedbackProc,
+                               CMP_DWORD_PTR              pUser1,
+                               CMP_DWORD_PTR              pUser2)
 {
     CodecType destType = GetCodecType(destTexture->format);
     if (destType == CT_Unknown)
@@ -247,6 +259,7 @@ CMP_ERROR CodecCompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destT
             codec->SetParameter("ColourRestrict", (CMP_DWORD)options->brestrictColour);
             codec->SetParameter("AlphaRestrict", (CMP_DWORD)options->brestrictAlpha);
             codec->SetParameter("Quality", (CODECFLOAT)options->fquality);
+            codec->SetParameter("UseFloatEncoder", (CMP_DWORD)options->bUseFloatBC7);
             break;
 #ifdef USE_BASIS
         case CT_BASIS:
@@ -370,7 +383,7 @@ CMP_ERROR CodecCompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destT
     srcBuffer->m_bSwizzle = swizzleSrcBuffer;
 
     DISABLE_FP_EXCEPTIONS;
-    CodecError err = codec->Compress(*srcBuffer, *destBuffer, feedbackProc);
+    CodecError err = codec->Compress(*srcBuffer, *destBuffer, feedbackProc, pUser1, pUser2);
     RESTORE_FP_EXCEPTIONS;
 
     destTexture->dwDataSize = destBuffer->GetDataSize();
@@ -382,7 +395,12 @@ CMP_ERROR CodecCompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destT
     return GetError(err);
 }
 
-CMP_ERROR CodecDecompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, const CMP_CompressOptions* options, CMP_Feedback_Proc feedbackProc)
+CMP_ERROR CodecDecompressTexture(const CMP_Texture*         srcTexture,
+                                 CMP_Texture*               destTexture,
+                                 const CMP_CompressOptions* options,
+                                 CMP_Feedback_Proc          feedbackProc,
+                                 CMP_DWORD_PTR              pUser1,
+                                 CMP_DWORD_PTR              pUser2)
 {
     CodecType srcType = GetCodecType(srcTexture->format);
     if (srcType == CT_Unknown)
@@ -448,7 +466,7 @@ CMP_ERROR CodecDecompressTexture(const CMP_Texture* srcTexture, CMP_Texture* des
     destBuffer->SetBlockDepth(destTexture->nBlockDepth);
     destBuffer->SetFormat(destTexture->format);
 
-    CodecError err1 = codec->Decompress(*srcBuffer, *destBuffer, feedbackProc);
+    CodecError err1 = codec->Decompress(*srcBuffer, *destBuffer, feedbackProc, pUser1, pUser2);
 
     RESTORE_FP_EXCEPTIONS;
 
@@ -467,48 +485,59 @@ CMP_ERROR CodecDecompressTexture(const CMP_Texture* srcTexture, CMP_Texture* des
 
 #ifdef THREADED_COMPRESS
 
-class CATICompressThreadData
-{
-public:
-    CATICompressThreadData();
-    ~CATICompressThreadData();
-
-    CCodec*           m_pCodec;
-    CCodecBuffer*     m_pSrcBuffer;
-    CCodecBuffer*     m_pDestBuffer;
-    CMP_Feedback_Proc m_pFeedbackProc;
-    CodecError        m_errorCode;
-};
-
-CATICompressThreadData::CATICompressThreadData()
-    : m_pCodec(NULL)
-    , m_pSrcBuffer(NULL)
-    , m_pDestBuffer(NULL)
-    , m_pFeedbackProc(NULL)
-    , m_errorCode(CE_OK)
-{
-}
-
-CATICompressThreadData::~CATICompressThreadData()
+static void SetThreadedCodecParameters(CCodec* codec, const CMP_CompressOptions* options)
 {
-    SAFE_DELETE(m_pCodec);
-    SAFE_DELETE(m_pSrcBuffer);
-    SAFE_DELETE(m_pDestBuffer);
-}
+    // Set weightings ?
+    if (options->bUseChannelWeighting && (options->fWeightingRed > 0.0 || options->fWeightingGreen > 0.0 || options->fWeightingBlue > 0.0))
+    {
+        codec->SetParameter("UseChannelWeighting", (CMP_DWORD)1);
+        codec->SetParameter("WeightR", options->fWeightingRed > MINIMUM_WEIGHT_VALUE ? (CODECFLOAT)options->fWeightingRed : MINIMUM_WEIGHT_VALUE);
+        codec->SetParameter("WeightG", options->fWeightingGreen > MINIMUM_WEIGHT_VALUE ? (CODECFLOAT)options->fWeightingGreen : MINIMUM_WEIGHT_VALUE);
+        codec->SetParameter("WeightB", options->fWeightingBlue > MINIMUM_WEIGHT_VALUE ? (CODECFLOAT)options->fWeightingBlue : MINIMUM_WEIGHT_VALUE);
+    }
+    codec->SetParameter("UseAdaptiveWeighting", (CMP_DWORD)options->bUseAdaptiveWeighting);
+    codec->SetParameter("DXT1UseAlpha", (CMP_DWORD)options->bDXT1UseAlpha);
+    codec->SetParameter("AlphaThreshold", (CMP_DWORD)options->nAlphaThreshold);
+    // The threaded path has always applied the refinement steps, bUseRefinementSteps is only checked by the single threaded path
+    codec->SetParameter("RefineSteps", (CMP_DWORD)options->nRefinementSteps);
+    codec->SetParameter("Quality", (CODECFLOAT)options->fquality);
+
+    // New override to that set quality if compresion for DXTn & ATInN codecs
+    if (options->fquality != AMD_CODEC_QUALITY_DEFAULT)
+    {
+        if (options->fquality < 0.3)
+            codec->SetParameter("CompressionSpeed", (CMP_DWORD)CMP_Speed_SuperFast);
+        else if (options->fquality < 0.6)
+            codec->SetParameter("CompressionSpeed", (CMP_DWORD)CMP_Speed_Fast);
+        else
+            codec->SetParameter("CompressionSpeed", (CMP_DWORD)CMP_Speed_Normal);
+    }
+    else
+        codec->SetParameter("CompressionSpeed", (CMP_DWORD)options->nCompressionSpeed);
 
-void ThreadedCompressProc(void* lpParameter)
-{
-    CATICompressThreadData* pThreadData = (CATICompressThreadData*)lpParameter;
-    DISABLE_FP_EXCEPTIONS;
-    CodecError err = pThreadData->m_pCodec->Compress(*pThreadData->m_pSrcBuffer, *pThreadData->m_pDestBuffer, pThreadData->m_pFeedbackProc);
-    RESTORE_FP_EXCEPTIONS;
-    pThreadData->m_errorCode = err;
+    // This will eventually replace the above code for setting codec options
+    // It is currently implemented with BC6H and can be expanded to other codec
+    if (options->NumCmds > 0)
+    {
+        int maxCmds = options->NumCmds;
+        if (options->NumCmds > AMD_MAX_CMDS)
+            maxCmds = AMD_MAX_CMDS;
+        for (int i = 0; i < maxCmds; i++)
+            codec->SetParameter(options->CmdSet[i].strCommand, (CMP_CHAR*)options->CmdSet[i].strParameter);
+    }
 }
 
+//
+// The image is cut into tiles of full width block rows that the pool workers pull one at a time,
+// so detailed regions that are slow to compress get shared out instead of holding up a single band.
+// Each worker compresses its tiles with its own codec instance.
+//
 CMP_ERROR CodecCompressTextureThreaded(const CMP_Texture*         srcTexture,
                                        CMP_Texture*               destTexture,
                                        const CMP_CompressOptions* options,
-                                       CMP_Feedback_Proc          feedbackProc)
+                                       CMP_Feedback_Proc          feedbackProc,
+                                       CMP_DWORD_PTR              pUser1,
+                                       CMP_DWORD_PTR              pUser2)
 {
     CodecType destType = GetCodecType(destTexture->format);
     if (destType == CT_Unknown)
@@ -538,170 +567,136 @@ CMP_ERROR CodecCompressTextureThreaded(const CMP_Texture*         srcTexture,
         return CMP_ABORTED;
 #endif
 
-    CMP_DWORD dwMaxThreadCount = cmp_minT(CMP_GetNumberOfProcessors(), MAX_THREADS);
-    CMP_DWORD dwLinesRemaining = destTexture->dwHeight;
-    CMP_BYTE* pSourceData      = srcTexture->pData;
-    CMP_BYTE* pDestData        = destTexture->pData;
-    CMP_BOOL  swizzleSrcBuffer = false;
+    CMP_ThreadPool& pool             = CMP_ThreadPool::GetInstance();
+    CMP_INT         numWorkers       = cmp_minT(pool.GetNumThreads(), (CMP_INT)MAX_THREADS);
+    CMP_BOOL        validOptions     = options && (options->dwSize == sizeof(CMP_CompressOptions));
+    CMP_BOOL        swizzleSrcBuffer = false;
 
 #ifdef _DEBUG
     if ((destTexture->format == CMP_FORMAT_ETC2_RGBA) || (destTexture->format == CMP_FORMAT_ETC2_RGBA1))
-        dwMaxThreadCount = 1;
+        numWorkers = 1;
 #endif
 
-    CATICompressThreadData aThreadData[MAX_THREADS];
-    std::thread            ahThread[MAX_THREADS];
+    CodecBufferType srcBufferType = GetCodecBufferType(srcTexture->format);
 
-    CMP_DWORD dwThreadCount = 0;
-    for (CMP_DWORD dwThread = 0; dwThread < dwMaxThreadCount; dwThread++)
+    // GPUOpen issue # 59 fix
+    if (validOptions && NeedSwizzle(destTexture->format))
     {
-        CATICompressThreadData& threadData = aThreadData[dwThread];
+        switch (srcBufferType)
+        {
+        case CBT_BGRA8888:
+        case CBT_BGR888:
+        case CBT_R8:
+            swizzleSrcBuffer = false;
+            break;
+        default:
+            swizzleSrcBuffer = true;
+            break;
+        }
+    }
 
-        // Compressing
-        threadData.m_pCodec = CreateCodec(destType);
-        assert(threadData.m_pCodec);
-        if (threadData.m_pCodec == NULL)
-            return CMP_ERR_UNABLE_TO_INIT_CODEC;
+    // One codec per pool worker, created by the worker on its first tile
+    std::vector<CCodec*> codecs(pool.GetNumThreads(), NULL);
 
-        // Have we got valid options ?
-        if (options && options->dwSize == sizeof(CMP_CompressOptions))
-        {
-            // Set weightings ?
-            if (options->bUseChannelWeighting && (options->fWeightingRed > 0.0 || options->fWeightingGreen > 0.0 || options->fWeightingBlue > 0.0))
-            {
-                threadData.m_pCodec->SetParameter("UseChannelWeighting", (CMP_DWORD)1);
-                threadData.m_pCodec->SetParameter("WeightR",
-                                                  options->fWeightingRed > MINIMUM_WEIGHT_VALUE ? (CODECFLOAT)options->fWeightingRed : MINIMUM_WEIGHT_VALUE);
-                threadData.m_pCodec->SetParameter(
-                    "WeightG", options->fWeightingGreen > MINIMUM_WEIGHT_VALUE ? (CODECFLOAT)options->fWeightingGreen : MINIMUM_WEIGHT_VALUE);
-                threadData.m_pCodec->SetParameter("WeightB",
-                                                  options->fWeightingBlue > MINIMUM_WEIGHT_VALUE ? (CODECFLOAT)options->fWeightingBlue : MINIMUM_WEIGHT_VALUE);
-            }
-            threadData.m_pCodec->SetParameter("UseAdaptiveWeighting", (CMP_DWORD)options->bUseAdaptiveWeighting);
-            threadData.m_pCodec->SetParameter("DXT1UseAlpha", (CMP_DWORD)options->bDXT1UseAlpha);
-            threadData.m_pCodec->SetParameter("AlphaThreshold", (CMP_DWORD)options->nAlphaThreshold);
-            threadData.m_pCodec->SetParameter("RefineSteps", (CMP_DWORD)options->nRefinementSteps);
-            threadData.m_pCodec->SetParameter("Quality", (CODECFLOAT)options->fquality);
-
-            // New override to that set quality if compresion for DXTn & ATInN codecs
-            if (options->fquality != AMD_CODEC_QUALITY_DEFAULT)
-            {
-                if (options->fquality < 0.3)
-                    threadData.m_pCodec->SetParameter("CompressionSpeed", (CMP_DWORD)CMP_Speed_SuperFast);
-                else if (options->fquality < 0.6)
-                    threadData.m_pCodec->SetParameter("CompressionSpeed", (CMP_DWORD)CMP_Speed_Fast);
-                else
-                    threadData.m_pCodec->SetParameter("CompressionSpeed", (CMP_DWORD)CMP_Speed_Normal);
-            }
-            else
-                threadData.m_pCodec->SetParameter("CompressionSpeed", (CMP_DWORD)options->nCompressionSpeed);
+    CMP_DWORD dwBlockHeight = destTexture->nBlockHeight ? destTexture->nBlockHeight : 4;
+    CMP_DWORD dwTileRows    = (validOptions && options->dwTileHeight > 0) ? options->dwTileHeight : CMP_DEFAULT_TILE_HEIGHT;
+    CMP_DWORD dwTileHeight  = dwTileRows * dwBlockHeight;
+    CMP_INT   numTiles      = (CMP_INT)((destTexture->dwHeight + dwTileHeight - 1) / dwTileHeight);
 
-            switch (destType)
-            {
-            case CT_BC6H:
-                // Reserved
-                break;
-            }
+    std::atomic<CMP_INT> tilesDone(0);
+    std::atomic<bool>    aborted(false);
+    std::atomic<int>     firstError(CE_OK);
+    std::mutex           feedbackMutex;
+
+    pool.ParallelFor(numTiles, numWorkers, [&](CMP_INT nTile) {
+        if (aborted || (firstError != CE_OK))
+            return;
 
-            // This will eventually replace the above code for setting codec options
-            // It is currently implemented with BC6H and can be expanded to other codec
-            if (options->NumCmds > 0)
+        CCodec*& codec = codecs[CMP_ThreadPool::GetWorkerIndex()];
+        if (codec == NULL)
+        {
+            codec = CreateCodec(destType);
+            assert(codec);
+            if (codec == NULL)
             {
-                int maxCmds = options->NumCmds;
-                if (options->NumCmds > AMD_MAX_CMDS)
-                    maxCmds = AMD_MAX_CMDS;
-                for (int i = 0; i < maxCmds; i++)
-                    threadData.m_pCodec->SetParameter(options->CmdSet[i].strCommand, (CMP_CHAR*)options->CmdSet[i].strParameter);
+                firstError = CE_Unknown;
+                return;
             }
+            if (validOptions)
+                SetThreadedCodecParameters(codec, options);
         }
 
-        CodecBufferType srcBufferType = GetCodecBufferType(srcTexture->format);
+        CMP_DWORD dwTop    = nTile * dwTileHeight;
+        CMP_DWORD dwHeight = cmp_minT(dwTileHeight, destTexture->dwHeight - dwTop);
+
+        CMP_BYTE* pSourceData =
+            srcTexture->pData +
+            CalcBufferSize(srcTexture->format, srcTexture->dwWidth, dwTop, srcTexture->dwPitch, srcTexture->nBlockWidth, srcTexture->nBlockHeight);
+        CMP_BYTE* pDestData = destTexture->pData + CalcBufferSize(destType, destTexture->dwWidth, dwTop, destTexture->nBlockWidth, destTexture->nBlockHeight);
+
+        CCodecBuffer* pSrcBuffer = CreateCodecBuffer(srcBufferType,
+                                                     srcTexture->nBlockWidth,
+                                                     srcTexture->nBlockHeight,
+                                                     srcTexture->nBlockDepth,
+                                                     srcTexture->dwWidth,
+                                                     dwHeight,
+                                                     srcTexture->dwPitch,
+                                                     pSourceData,
+                                                     srcTexture->dwDataSize);
+
+        CCodecBuffer* pDestBuffer = codec->CreateBuffer(destTexture->nBlockWidth,
+                                                        destTexture->nBlockHeight,
+                                                        destTexture->nBlockDepth,
+                                                        destTexture->dwWidth,
+                                                        dwHeight,
+                                                        destTexture->dwPitch,
+                                                        pDestData,
+                                                        destTexture->dwDataSize);
 
-        // GPUOpen issue # 59 fix
-        if (NeedSwizzle(destTexture->format))
+        assert(pSrcBuffer);
+        assert(pDestBuffer);
+        if (pSrcBuffer == NULL || pDestBuffer == NULL)
         {
-            switch (srcBufferType)
-            {
-            case CBT_BGRA8888:
-            case CBT_BGR888:
-            case CBT_R8:
-                swizzleSrcBuffer = false;
-                break;
-            default:
-                swizzleSrcBuffer = true;
-                break;
-            }
+            SAFE_DELETE(pSrcBuffer);
+            SAFE_DELETE(pDestBuffer);
+            firstError = CE_Unknown;
+            return;
         }
 
-        CMP_DWORD dwThreadsRemaining = dwMaxThreadCount - dwThread;
-        CMP_DWORD dwHeight           = 0;
-        if (dwThreadsRemaining > 1)
+        pSrcBuffer->SetFormat(srcTexture->format);
+        pDestBuffer->SetFormat(destTexture->format);
+        pSrcBuffer->m_bSwizzle = swizzleSrcBuffer;
+
+        // Tiles are small, progress is reported per tile rather than from inside the codec
+        DISABLE_FP_EXCEPTIONS;
+        CodecError err = codec->Compress(*pSrcBuffer, *pDestBuffer, NULL);
+        RESTORE_FP_EXCEPTIONS;
+
+        SAFE_DELETE(pSrcBuffer);
+        SAFE_DELETE(pDestBuffer);
+
+        if (err != CE_OK)
         {
-            CMP_DWORD dwBlockHeight = threadData.m_pCodec->GetBlockHeight();
-            dwHeight                = dwLinesRemaining / dwThreadsRemaining;
-            dwHeight                = cmp_minT(((dwHeight + dwBlockHeight - 1) / dwBlockHeight) * dwBlockHeight, dwLinesRemaining);  // Round by block height
-            dwLinesRemaining -= dwHeight;
+            int expected = CE_OK;
+            firstError.compare_exchange_strong(expected, (int)err);
+            return;
         }
-        else
-            dwHeight = dwLinesRemaining;
 
-        if (dwHeight > 0)
+        CMP_INT done = ++tilesDone;
+        if (feedbackProc)
         {
-            threadData.m_pSrcBuffer = CreateCodecBuffer(srcBufferType,
-                                                        srcTexture->nBlockWidth,
-                                                        srcTexture->nBlockHeight,
-                                                        srcTexture->nBlockDepth,
-                                                        srcTexture->dwWidth,
-                                                        dwHeight,
-                                                        srcTexture->dwPitch,
-                                                        pSourceData,
-                                                        srcTexture->dwDataSize);
-            threadData.m_pSrcBuffer->SetFormat(srcTexture->format);
-
-            threadData.m_pDestBuffer = threadData.m_pCodec->CreateBuffer(destTexture->nBlockWidth,
-                                                                         destTexture->nBlockHeight,
-                                                                         destTexture->nBlockDepth,
-                                                                         destTexture->dwWidth,
-                                                                         dwHeight,
-                                                                         destTexture->dwPitch,
-                                                                         pDestData,
-                                                                         destTexture->dwDataSize);
-            threadData.m_pDestBuffer->SetFormat(destTexture->format);
-
-            pSourceData +=
-                CalcBufferSize(srcTexture->format, srcTexture->dwWidth, dwHeight, srcTexture->dwPitch, srcTexture->nBlockWidth, srcTexture->nBlockHeight);
-            pDestData += CalcBufferSize(destType, destTexture->dwWidth, dwHeight, destTexture->nBlockWidth, destTexture->nBlockHeight);
-
-            assert(threadData.m_pSrcBuffer);
-            assert(threadData.m_pDestBuffer);
-            if (threadData.m_pSrcBuffer == NULL || threadData.m_pDestBuffer == NULL)
-                return CMP_ERR_GENERIC;
-
-            threadData.m_pSrcBuffer->m_bSwizzle = swizzleSrcBuffer;
-            threadData.m_pFeedbackProc          = feedbackProc;
-
-            ahThread[dwThreadCount++] = std::thread(ThreadedCompressProc, &threadData);
+            std::lock_guard<std::mutex> lock(feedbackMutex);
+            if (!aborted && feedbackProc(100.0f * done / numTiles, pUser1, pUser2))
+                aborted = true;
         }
-    }
-
-    for (CMP_DWORD dwThread = 0; dwThread < dwThreadCount; dwThread++)
-    {
-        std::thread& curThread = ahThread[dwThread];
-
-        curThread.join();
-    }
-
-    CodecError err = CE_OK;
-    for (CMP_DWORD dwThread = 0; dwThread < dwThreadCount; dwThread++)
-    {
-        CATICompressThreadData& threadData = aThreadData[dwThread];
+    });
 
-        if (err == CE_OK)
-            err = threadData.m_errorCode;
+    for (CCodec* codec : codecs)
+        SAFE_DELETE(codec);
 
-        ahThread[dwThread] = std::thread();
-    }
+    if (firstError != CE_OK)
+        return GetError((CodecError)firstError.load());
 
-    return GetError(err);
+    return aborted ? CMP_ABORTED : CMP_OK;
 }
 #endif  // THREADED_COMPRESS
@@ -33,12 +33,20 @@
 
 #include "compressonator.h"  // User shared: Keep private code out of this header
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "atiformats.h"
 #include "codec.h"
 #include "codec_common.h"
+#include "cmp_memory.h"
 #include "cmp_mips.h"
+#include "cmp_threadpool.h"
 #include "common.h"
 #include "compress.h"
 #include "debug.h"
@@ -270,10 +278,12 @@ static void CMP_PrepareSourceForCMP_Destination(CMP_Texture* pTexture, CMP_FORMA
 }
 #endif
 
-CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture*               pSourceTexture,
-                                     CMP_Texture*               pDestTexture,
-                                     const CMP_CompressOptions* pOptions,
-                                     CMP_Feedback_Proc          pFeedbackProc)
+static CMP_ERROR ConvertTexture(CMP_Texture*               pSourceTexture,
+                                CMP_Texture*               pDestTexture,
+                                const CMP_CompressOptions* pOptions,
+                                CMP_Feedback_Proc          pFeedbackProc,
+                                CMP_DWORD_PTR              pUser1,
+                                CMP_DWORD_PTR              pUser2)
 {
 #ifdef USE_DBGTRACE
     DbgTrace(("-------> pSourceTexture [%x] pDestTexture [%x] pOptions [%x]", pSourceTexture, pDestTexture, pOptions));
@@ -397,17 +407,17 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture*               pSourceTexture,
 #endif
         )
         {
-            return CodecCompressTextureThreaded(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc);
+            return CodecCompressTextureThreaded(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc, pUser1, pUser2);
         }
         else
 #endif  // THREADED_COMPRESS
         {
-            return CodecCompressTexture(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc);
+            return CodecCompressTexture(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc, pUser1, pUser2);
         }
     }
     else if (!compressing && decompressing)  // Decompression
     {
-        return CodecDecompressTexture(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc);
+        return CodecDecompressTexture(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc, pUser1, pUser2);
     }
     else  // Decompressing & then compressing
     {
@@ -458,10 +468,10 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture*               pSourceTexture,
         }
 
         DISABLE_FP_EXCEPTIONS;
-        CodecError err2 = pCodecIn->Decompress(*pSrcBuffer, *pTempBuffer, pFeedbackProc);
+        CodecError err2 = pCodecIn->Decompress(*pSrcBuffer, *pTempBuffer, pFeedbackProc, pUser1, pUser2);
         if (err2 == CE_OK)
         {
-            err2 = pCodecOut->Compress(*pTempBuffer, *pDestBuffer, pFeedbackProc);
+            err2 = pCodecOut->Compress(*pTempBuffer, *pDestBuffer, pFeedbackProc, pUser1, pUser2);
         }
         RESTORE_FP_EXCEPTIONS;
 
@@ -469,14 +479,347 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture*               pSourceTexture,
     }
 }
 
-CMP_ERROR CMP_API CMP_ConvertMipTexture(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_MipSetOut, const CMP_CompressOptions* pOptions, CMP_Feedback_Proc pFeedbackProc)
+CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture*               pSourceTexture,
+                                     CMP_Texture*               pDestTexture,
+                                     const CMP_CompressOptions* pOptions,
+                                     CMP_Feedback_Proc          pFeedbackProc)
 {
-    assert(p_MipSetIn);
-    assert(p_MipSetOut);
-    assert(pOptions);
+    return ConvertTexture(pSourceTexture, pDestTexture, pOptions, pFeedbackProc, NULL, NULL);
+}
 
-    CMP_CMIPS CMips;
+//=====================================================================================
+// CMP_ConvertMipTexture work items
+//
+// Every face or slice of every mip level is cut into bands of block rows, and the bands
+// of the whole mip set are compressed as a single parallel loop on the thread pool.
+// Small tail mips then run alongside the large levels instead of after them.
+//=====================================================================================
+
+// Size of a band in blocks, enough bands are made to give each worker a few of them
+#define CMP_MIP_BANDS_PER_THREAD 4
+#define CMP_MIP_MIN_BLOCKS_PER_BAND 1024
+#define CMP_MIP_MAX_BLOCKS_PER_BAND 16384
+
+// One face or slice of a mip level
+struct CMP_MipConvertItem
+{
+    CMP_Texture srcTexture;
+    CMP_Texture destTexture;
+    CMP_INT     nMipLevel;
+    CMP_INT     nFaceOrSlice;
+    CMP_ERROR   status;
+};
+
+struct CMP_MipBandJob;
+
+// A range of block rows of one face or slice
+struct CMP_MipBand
+{
+    CMP_Texture     srcTexture;
+    CMP_Texture     destTexture;
+    size_t          nItem;
+    CMP_FLOAT       fWeight;    // Share of the blocks in the mip set
+    CMP_FLOAT       fProgress;  // Last progress reported for this band
+    CMP_ERROR       status;
+    CMP_MipBandJob* pJob;
+};
+
+struct CMP_MipBandJob
+{
+    CMP_Feedback_Proc pFeedbackProc;
+    CMP_DWORD_PTR     pUser1;
+    CMP_DWORD_PTR     pUser2;
+    std::mutex        feedbackMutex;
+    CMP_FLOAT         fProgress;
+    std::atomic<bool> aborted;
+};
+
+// Codecs report progress per band from any worker, this folds it into one progress value for the mip set
+static bool CMP_API MipBandFeedback(CMP_FLOAT fProgress, CMP_DWORD_PTR pUser1, CMP_DWORD_PTR pUser2)
+{
+    (void)pUser2;
+    CMP_MipBand*    band = (CMP_MipBand*)pUser1;
+    CMP_MipBandJob* job  = band->pJob;
+
+    std::lock_guard<std::mutex> lock(job->feedbackMutex);
+    if (fProgress > band->fProgress)
+    {
+        job->fProgress += (fProgress - band->fProgress) * band->fWeight;
+        band->fProgress = fProgress;
+    }
+
+    if (!job->aborted && job->pFeedbackProc && job->pFeedbackProc(cmp_minT(job->fProgress, 100.0f), job->pUser1, job->pUser2))
+        job->aborted = true;
+
+    return job->aborted;
+}
+
+// Only compression to block codecs with a fixed output size can be split into bands
+static bool CanConvertMipBands(CMP_FORMAT srcFormat, CMP_FORMAT destFormat)
+{
+    if (GetCodecType(srcFormat) != CT_None)
+        return false;
+
+    switch (GetCodecType(destFormat))
+    {
+    case CT_None:
+    case CT_Unknown:
+    case CT_APC:
+    case CT_GTC:
+#ifdef USE_BASIS
+    case CT_BASIS:
+#endif
+    case CT_BRLG:
+        return false;
+    default:
+        return true;
+    }
+}
+
+// Byte offset of pixel row nRow in a texture
+static CMP_DWORD MipBandOffset(const CMP_Texture* pTexture, CMP_DWORD nRow)
+{
+    if (nRow == 0)
+        return 0;
+
+    CMP_Texture rows = *pTexture;
+    rows.dwHeight    = nRow;
+    return CMP_CalculateBufferSize(&rows);
+}
+
+// Number of pool workers the bands of a conversion are spread over
+static CMP_INT MipBandWorkers(const CMP_CompressOptions* pOptions)
+{
+    if (pOptions->bDisableMultiThreading)
+        return 1;
+
+    CMP_INT numWorkers = CMP_ThreadPool::GetInstance().GetNumThreads();
+    if ((pOptions->dwnumThreads > 0) && ((CMP_INT)pOptions->dwnumThreads < numWorkers))
+        numWorkers = (CMP_INT)pOptions->dwnumThreads;
+    return numWorkers;
+}
+
+static void MakeMipBands(const std::vector<CMP_MipConvertItem>& items, CMP_INT numWorkers, CMP_MipBandJob* pJob, std::vector<CMP_MipBand>& bands)
+{
+    double totalBlocks = 0.0;
+    for (const CMP_MipConvertItem& item : items)
+    {
+        const CMP_Texture& dest = item.destTexture;
+        totalBlocks += (double)((dest.dwWidth + dest.nBlockWidth - 1) / dest.nBlockWidth) * ((dest.dwHeight + dest.nBlockHeight - 1) / dest.nBlockHeight);
+    }
+
+    CMP_DWORD blocksPerBand = (CMP_DWORD)(totalBlocks / (numWorkers * CMP_MIP_BANDS_PER_THREAD));
+    blocksPerBand           = cmp_maxT(cmp_minT(blocksPerBand, (CMP_DWORD)CMP_MIP_MAX_BLOCKS_PER_BAND), (CMP_DWORD)CMP_MIP_MIN_BLOCKS_PER_BAND);
+
+    // Items are in mip order, so the bands of the largest levels are handed out first
+    for (size_t nItem = 0; nItem < items.size(); nItem++)
+    {
+        const CMP_MipConvertItem& item         = items[nItem];
+        CMP_DWORD                 nBlockHeight = item.destTexture.nBlockHeight;
+        CMP_DWORD                 dwBlocksX    = (item.destTexture.dwWidth + item.destTexture.nBlockWidth - 1) / item.destTexture.nBlockWidth;
+        CMP_DWORD                 dwBandHeight = cmp_maxT(blocksPerBand / dwBlocksX, (CMP_DWORD)1) * nBlockHeight;
+
+        for (CMP_DWORD nRow = 0; nRow < item.destTexture.dwHeight; nRow += dwBandHeight)
+        {
+            CMP_MipBand band = {};
+            band.srcTexture  = item.srcTexture;
+            band.destTexture = item.destTexture;
+            band.nItem       = nItem;
+            band.status      = CMP_OK;
+            band.pJob        = pJob;
+
+            band.srcTexture.pData       = item.srcTexture.pData + MipBandOffset(&item.srcTexture, nRow);
+            band.destTexture.pData      = item.destTexture.pData + MipBandOffset(&item.destTexture, nRow);
+            band.srcTexture.dwHeight    = cmp_minT(dwBandHeight, item.srcTexture.dwHeight - nRow);
+            band.destTexture.dwHeight   = band.srcTexture.dwHeight;
+            band.srcTexture.dwDataSize  = CMP_CalculateBufferSize(&band.srcTexture);
+            band.destTexture.dwDataSize = CMP_CalculateBufferSize(&band.destTexture);
+
+            band.fWeight = (CMP_FLOAT)(dwBlocksX * ((band.destTexture.dwHeight + nBlockHeight - 1) / nBlockHeight) / totalBlocks);
+            bands.push_back(band);
+        }
+    }
+}
+
+// pBandOptions are the conversion options with dwnumThreads = 1, the bands are the parallel work
+static void ConvertMipBand(CMP_MipBand& band, const CMP_CompressOptions* pBandOptions, CMP_Feedback_Proc pBandFeedbackProc)
+{
+    CMP_MipBandJob* job = band.pJob;
+    if (job->aborted)
+    {
+        band.status = CMP_ABORTED;
+        return;
+    }
+
+    band.status = ConvertTexture(&band.srcTexture, &band.destTexture, pBandOptions, pBandFeedbackProc, (CMP_DWORD_PTR)&band, 0);
+    if (band.status == CMP_ABORTED)
+        job->aborted = true;
+    else if ((band.status == CMP_OK) && pBandFeedbackProc)
+        MipBandFeedback(100.0f, (CMP_DWORD_PTR)&band, 0);
+}
+
+static void GatherMipBandStatus(std::vector<CMP_MipConvertItem>& items, const std::vector<CMP_MipBand>& bands)
+{
+    for (const CMP_MipBand& band : bands)
+    {
+        CMP_MipConvertItem& item = items[band.nItem];
+        if (item.status == CMP_OK)
+            item.status = band.status;
+    }
+}
+
+static void ConvertMipItemsInBands(std::vector<CMP_MipConvertItem>& items,
+                                   const CMP_CompressOptions*       pOptions,
+                                   CMP_Feedback_Proc                pFeedbackProc,
+                                   CMP_DWORD_PTR                    pUser1,
+                                   CMP_DWORD_PTR                    pUser2)
+{
+    CMP_ThreadPool& pool       = CMP_ThreadPool::GetInstance();
+    CMP_INT         numWorkers = MipBandWorkers(pOptions);
+
+    CMP_MipBandJob job;
+    job.pFeedbackProc = pFeedbackProc;
+    job.pUser1        = pUser1;
+    job.pUser2        = pUser2;
+    job.fProgress     = 0.0f;
+    job.aborted       = false;
+
+    std::vector<CMP_MipBand> bands;
+    MakeMipBands(items, numWorkers, &job, bands);
+
+    CMP_CompressOptions bandOptions = *pOptions;
+    bandOptions.dwnumThreads        = 1;
+
+    CMP_Feedback_Proc bandFeedbackProc = pFeedbackProc ? MipBandFeedback : NULL;
+
+    pool.ParallelFor((CMP_INT)bands.size(), numWorkers, [&](CMP_INT nBand) { ConvertMipBand(bands[nBand], &bandOptions, bandFeedbackProc); });
+
+    GatherMipBandStatus(items, bands);
+}
+
+//=====================================================================================
+// CMP_ConvertTextureStream
+//
+// The source is read one band per worker at a time, the bands are compressed on the
+// thread pool and written out in order before the next ones are read. The band buffers
+// are all that is held of the texture, whatever its size.
+//=====================================================================================
+
+CMP_ERROR CMP_API CMP_ConvertTextureStream(const CMP_Texture*         pSourceTexture,
+                                           const CMP_Texture*         pDestTexture,
+                                           const CMP_CompressOptions* pOptions,
+                                           const CMP_RowStream*       pStream,
+                                           CMP_Feedback_Proc          pFeedbackProc)
+{
+    if (!pSourceTexture || (pSourceTexture->dwSize != sizeof(CMP_Texture)) || !pSourceTexture->dwWidth || !pSourceTexture->dwHeight)
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+    if (!pDestTexture || (pDestTexture->dwSize != sizeof(CMP_Texture)))
+        return CMP_ERR_INVALID_DEST_TEXTURE;
+    if (!pOptions || !pStream || (pStream->dwSize != sizeof(CMP_RowStream)) || !pStream->pReadRows || !pStream->pWriteRows)
+        return CMP_ERR_GENERIC;
+    if ((pSourceTexture->dwWidth != pDestTexture->dwWidth) || (pSourceTexture->dwHeight != pDestTexture->dwHeight))
+        return CMP_ERR_SIZE_MISMATCH;
+    if (!CanConvertMipBands(pSourceTexture->format, pDestTexture->format))
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    CMP_Texture srcTexture  = *pSourceTexture;
+    CMP_Texture destTexture = *pDestTexture;
+    srcTexture.pData        = NULL;
+    destTexture.pData       = NULL;
+
+    CMP_DWORD dwHeight     = srcTexture.dwHeight;
+    CMP_DWORD nBlockWidth  = destTexture.nBlockWidth ? destTexture.nBlockWidth : 4;
+    CMP_DWORD nBlockHeight = destTexture.nBlockHeight ? destTexture.nBlockHeight : 4;
+    CMP_DWORD dwBlocksX    = (destTexture.dwWidth + nBlockWidth - 1) / nBlockWidth;
+
+    // Bands are whole block rows, without a height they are the largest bands CMP_ConvertMipTexture makes
+    CMP_DWORD dwBandRows = pStream->dwBandRows ? cmp_minT(pStream->dwBandRows, dwHeight)
+                                               : cmp_maxT((CMP_DWORD)CMP_MIP_MAX_BLOCKS_PER_BAND / dwBlocksX, (CMP_DWORD)1) * nBlockHeight;
+    CMP_DWORD dwBandHeight = ((dwBandRows + nBlockHeight - 1) / nBlockHeight) * nBlockHeight;
+    CMP_DWORD dwNumBands   = (dwHeight + dwBandHeight - 1) / dwBandHeight;
+
+    CMP_INT numWorkers = MipBandWorkers(pOptions);
+    if ((CMP_DWORD)numWorkers > dwNumBands)
+        numWorkers = (CMP_INT)dwNumBands;
+
+    srcTexture.dwHeight        = dwBandHeight;
+    destTexture.dwHeight       = dwBandHeight;
+    CMP_DWORD dwSrcPitch       = MipBandOffset(&srcTexture, 1);
+    size_t    nSrcBandSize     = CMP_CalculateBufferSize(&srcTexture);
+    size_t    nDestBandSize    = CMP_CalculateBufferSize(&destTexture);
+    CMP_BYTE* pSrcBandBuffers  = (CMP_BYTE*)CMP_MemAlloc(nSrcBandSize * numWorkers);
+    CMP_BYTE* pDestBandBuffers = (CMP_BYTE*)CMP_MemAlloc(nDestBandSize * numWorkers);
+
+    CMP_ERROR status = CMP_OK;
+    if (!pSrcBandBuffers || !pDestBandBuffers)
+        status = CMP_ERR_MEM_ALLOC_FOR_MIPSET;
+
+    CMP_MipBandJob job;
+    job.pFeedbackProc = NULL;
+    job.pUser1        = 0;
+    job.pUser2        = 0;
+    job.fProgress     = 0.0f;
+    job.aborted       = false;
+
+    CMP_CompressOptions bandOptions = *pOptions;
+    bandOptions.dwnumThreads        = 1;
+
+    CMP_ThreadPool&          pool = CMP_ThreadPool::GetInstance();
+    std::vector<CMP_MipBand> bands(numWorkers);
+
+    for (CMP_DWORD nRow = 0; (status == CMP_OK) && (nRow < dwHeight); nRow += dwBandHeight * numWorkers)
+    {
+        // Read a band for each worker
+        CMP_INT numBands = 0;
+        for (; (status == CMP_OK) && (numBands < numWorkers) && (nRow + numBands * dwBandHeight < dwHeight); numBands++)
+        {
+            CMP_DWORD    nBandRow = nRow + numBands * dwBandHeight;
+            CMP_MipBand& band     = bands[numBands];
+            band                  = {};
+            band.srcTexture       = srcTexture;
+            band.destTexture      = destTexture;
+            band.status           = CMP_OK;
+            band.pJob             = &job;
+
+            band.srcTexture.pData       = pSrcBandBuffers + nSrcBandSize * numBands;
+            band.destTexture.pData      = pDestBandBuffers + nDestBandSize * numBands;
+            band.srcTexture.dwHeight    = cmp_minT(dwBandHeight, dwHeight - nBandRow);
+            band.destTexture.dwHeight   = band.srcTexture.dwHeight;
+            band.srcTexture.dwDataSize  = CMP_CalculateBufferSize(&band.srcTexture);
+            band.destTexture.dwDataSize = CMP_CalculateBufferSize(&band.destTexture);
+
+            status = pStream->pReadRows(band.srcTexture.pData, nBandRow, band.srcTexture.dwHeight, dwSrcPitch, pStream->pUser);
+        }
+
+        if (status != CMP_OK)
+            break;
+
+        pool.ParallelFor(numBands, numWorkers, [&](CMP_INT nBand) { ConvertMipBand(bands[nBand], &bandOptions, NULL); });
+
+        // Write the bands in row order
+        for (CMP_INT nBand = 0; (status == CMP_OK) && (nBand < numBands); nBand++)
+        {
+            const CMP_MipBand& band = bands[nBand];
+            status                  = band.status;
+            if (status == CMP_OK)
+                status = pStream->pWriteRows(
+                    band.destTexture.pData, band.destTexture.dwDataSize, nRow + nBand * dwBandHeight, band.destTexture.dwHeight, pStream->pUser);
+        }
+
+        CMP_FLOAT fProgress = 100.0f * cmp_minT(nRow + numBands * dwBandHeight, dwHeight) / dwHeight;
+        if ((status == CMP_OK) && pFeedbackProc && pFeedbackProc(fProgress, 0, 0))
+            status = CMP_ABORTED;
+    }
 
+    CMP_MemFree(pSrcBandBuffers);
+    CMP_MemFree(pDestBandBuffers);
+
+    return status;
+}
+
+// Sets up the destination mip set fields shared by all conversion paths
+static void InitMipConvertOutput(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_MipSetOut, const CMP_CompressOptions* pOptions)
+{
     // --------------------------------
     // Setup Compressed Mip Set Target
     // --------------------------------
@@ -510,17 +853,212 @@ CMP_ERROR CMP_API CMP_ConvertMipTexture(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_Mi
         p_MipSetOut->m_transcodeFormat = p_MipSetIn->m_format;
 
     p_MipSetOut->m_nIterations = 0;  // tracks number of processed data miplevels
+}
+
+// Allocates the destination mip set and sets up every face or slice of every mip level before any of them is processed
+static CMP_ERROR SetupMipConvertItems(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_MipSetOut, const CMP_CompressOptions* pOptions, std::vector<CMP_MipConvertItem>& items)
+{
+    CMP_CMIPS CMips;
+
+    if (!CMips.AllocateMipSet(p_MipSetOut,
+                              p_MipSetOut->m_ChannelFormat,
+                              TDT_ARGB,
+                              p_MipSetOut->m_TextureType,
+                              p_MipSetIn->m_nWidth,
+                              p_MipSetIn->m_nHeight,
+                              p_MipSetOut->m_nDepth))
+    {
+        return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
+    }
+
+    CMP_INT srcNumMipmapLevels = p_MipSetIn->m_nMipLevels;
+
+    // It is possible that the source texture will have an "m_nMipLevels" value greater than 1 when compressing to Brotli-G,
+    // but it will not contain any data, so we always want to compress only the one mipmap level.
+    // We do this instead of altering the value because it is still important for us to be able to know how many mipmap levels
+    // the source texture has when compressing to Brotli-G
+    if (pOptions->DestFormat == CMP_FORMAT_BROTLIG)
+    {
+        srcNumMipmapLevels = 1;
+    }
+
+    p_MipSetOut->m_nMipLevels = p_MipSetIn->m_nMipLevels;
 
-    //=====================================================
-    // Case Uncompressed Source to Compressed Destination
-    //=====================================================
     CMP_Texture srcTexture = {};
     srcTexture.dwSize      = sizeof(srcTexture);
     srcTexture.pMipSet     = p_MipSetIn;
 
+    for (int nMipLevel = 0; nMipLevel < srcNumMipmapLevels; nMipLevel++)
+    {
+        for (int nFaceOrSlice = 0; nFaceOrSlice < CMP_MaxFacesOrSlices(p_MipSetIn, nMipLevel); nFaceOrSlice++)
+        {
+            //=====================
+            // Uncompressed source
+            //======================
+            CMP_MipLevel* srcMipLevel  = CMips.GetMipLevel(p_MipSetIn, nMipLevel, nFaceOrSlice);
+            srcTexture.dwPitch         = 0;
+            srcTexture.nBlockWidth     = p_MipSetIn->m_nBlockWidth;
+            srcTexture.nBlockHeight    = p_MipSetIn->m_nBlockHeight;
+            srcTexture.nBlockDepth     = p_MipSetIn->m_nBlockDepth;
+            srcTexture.format          = p_MipSetIn->m_format;
+            srcTexture.transcodeFormat = p_MipSetIn->m_transcodeFormat;
+            srcTexture.dwWidth         = srcMipLevel->m_nWidth;
+            srcTexture.dwHeight        = srcMipLevel->m_nHeight;
+            srcTexture.pData           = srcMipLevel->m_pbData;
+            srcTexture.dwDataSize      = CMP_CalculateBufferSize(&srcTexture);
+
+            // Temporary settings
+            p_MipSetIn->dwWidth    = srcTexture.dwWidth;
+            p_MipSetIn->dwHeight   = srcTexture.dwHeight;
+            p_MipSetIn->pData      = srcTexture.pData;
+            p_MipSetIn->dwDataSize = srcTexture.dwDataSize;
+
+            //========================
+            // Compressed Destination
+            //========================
+            CMP_Texture destTexture     = {};
+            destTexture.dwSize          = sizeof(destTexture);
+            destTexture.dwWidth         = srcMipLevel->m_nWidth;
+            destTexture.dwHeight        = srcMipLevel->m_nHeight;
+            destTexture.dwPitch         = 0;
+            destTexture.nBlockWidth     = p_MipSetIn->m_nBlockWidth;
+            destTexture.nBlockHeight    = p_MipSetIn->m_nBlockHeight;
+            destTexture.format          = pOptions->DestFormat;
+            destTexture.transcodeFormat = p_MipSetOut->m_transcodeFormat;
+            destTexture.dwDataSize      = CMP_CalculateBufferSize(&destTexture);
+
+            p_MipSetOut->m_format   = destTexture.format;
+            p_MipSetOut->dwDataSize = destTexture.dwDataSize;
+            p_MipSetOut->dwWidth    = destTexture.dwWidth;
+            p_MipSetOut->dwHeight   = destTexture.dwHeight;
+
+            //--------------------------------------
+            // Allocate MipSet for Block Compressors
+            //--------------------------------------
+            CMP_MipLevel* pOutMipLevel = CMips.GetMipLevel(p_MipSetOut, nMipLevel, nFaceOrSlice);
+            if (!CMips.AllocateCompressedMipLevelData(pOutMipLevel, destTexture.dwWidth, destTexture.dwHeight, destTexture.dwDataSize))
+            {
+                return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
+            }
+
+            destTexture.pData  = pOutMipLevel->m_pbData;
+            p_MipSetOut->pData = pOutMipLevel->m_pbData;
+
+            CMP_MipConvertItem item = {};
+            item.srcTexture         = srcTexture;
+            item.destTexture        = destTexture;
+            item.nMipLevel          = nMipLevel;
+            item.nFaceOrSlice       = nFaceOrSlice;
+            item.status             = CMP_OK;
+            items.push_back(item);
+        }
+    }
+
+    return CMP_OK;
+}
+
+// Reports the items in mip order, converting each one unless the bands already did
+static CMP_ERROR ProcessMipConvertItems(CMP_MipSet*                      p_MipSetOut,
+                                       const CMP_CompressOptions*       pOptions,
+                                       std::vector<CMP_MipConvertItem>& items,
+                                       bool                             bConverted,
+                                       CMP_Feedback_Proc                pFeedbackProc,
+                                       CMP_DWORD_PTR                    pUser1,
+                                       CMP_DWORD_PTR                    pUser2)
+{
+    CMP_INT srcNumMipmapLevels = items.empty() ? 0 : items.back().nMipLevel + 1;
+
+    for (CMP_MipConvertItem& item : items)
+    {
+        if (pOptions->m_PrintInfoStr && srcNumMipmapLevels > 1 && item.nFaceOrSlice == 0)
+        {
+            char buff[256];
+            snprintf(buff, sizeof(buff), "Processing miplevel %d for texture...\n", item.nMipLevel);
+            pOptions->m_PrintInfoStr(buff);
+        }
+
+        //==========================
+        // Print info about input
+        //==========================
+        // NOTE: This is duplicated in CMP_ConvertMipTextureCGP
+        if (pOptions->m_PrintInfoStr)
+        {
+            char buff[256];
+            if ((p_MipSetOut->m_format == CMP_FORMAT_BROTLIG) || (p_MipSetOut->m_format == CMP_FORMAT_BINARY))
+                snprintf(buff, sizeof(buff), "Source data size      = %d Bytes\n", item.srcTexture.dwDataSize);
+            else
+                snprintf(buff,
+                         sizeof(buff),
+                         "Source data size      = %d Bytes, width = %d px  height = %d px\n",
+                         item.srcTexture.dwDataSize,
+                         item.srcTexture.dwWidth,
+                         item.srcTexture.dwHeight);
+            pOptions->m_PrintInfoStr(buff);
+        }
+
+        //========================
+        // Process ConvertTexture
+        //========================
+        // ConvertTexture works on a copy of the source, so item.srcTexture keeps the initial source size
+        if (!bConverted)
+            item.status = ConvertTexture(&item.srcTexture, &item.destTexture, pOptions, pFeedbackProc, pUser1, pUser2);
+
+        if (item.status != CMP_OK)
+        {
+            return item.status;
+        }
+        else
+            p_MipSetOut->m_nIterations++;
+
+        if (p_MipSetOut->m_format == CMP_FORMAT_BROTLIG)
+        {
+            p_MipSetOut->dwDataSize = item.destTexture.dwDataSize;
+        }
+
+        //==========================
+        // Print info about output
+        //==========================
+        // NOTE: This is mostly duplicated in CMP_ConvertMipTextureCGP
+        if (pOptions->m_PrintInfoStr && (item.destTexture.dwDataSize > 0) && (p_MipSetOut->m_format != CMP_FORMAT_BINARY))
+        {
+            char buff[256];
+            snprintf(buff,
+                     sizeof(buff),
+                     "\rDestination data size = %d Bytes   Resulting compression ratio = %2.2f:1\n",
+                     item.destTexture.dwDataSize,
+                     item.srcTexture.dwDataSize / (float)item.destTexture.dwDataSize);
+            pOptions->m_PrintInfoStr(buff);
+        }
+    }
+
+    return CMP_OK;
+}
+
+static CMP_ERROR ConvertMipTexture(CMP_MipSet*                p_MipSetIn,
+                                   CMP_MipSet*                p_MipSetOut,
+                                   const CMP_CompressOptions* pOptions,
+                                   CMP_Feedback_Proc          pFeedbackProc,
+                                   CMP_DWORD_PTR              pUser1,
+                                   CMP_DWORD_PTR              pUser2)
+{
+    assert(p_MipSetIn);
+    assert(p_MipSetOut);
+    assert(pOptions);
+
+    InitMipConvertOutput(p_MipSetIn, p_MipSetOut, pOptions);
+
 #ifdef USE_BASIS
     if (pOptions->DestFormat == CMP_FORMAT_BASIS)
     {
+        CMP_CMIPS CMips;
+
+        //=====================================================
+        // Case Uncompressed Source to Compressed Destination
+        //=====================================================
+        CMP_Texture srcTexture = {};
+        srcTexture.dwSize      = sizeof(srcTexture);
+        srcTexture.pMipSet     = p_MipSetIn;
+
         p_MipSetOut->m_format          = CMP_FORMAT_BASIS;
         p_MipSetOut->m_transcodeFormat = CMP_FORMAT_BC1;
         p_MipSetOut->m_TextureType     = TT_2D;
@@ -577,7 +1115,7 @@ CMP_ERROR CMP_API CMP_ConvertMipTexture(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_Mi
         //========================
         // Process ConvertTexture
         //========================
-        CMP_ERROR cmp_status = CMP_ConvertTexture(&srcTexture, &destTexture, pOptions, pFeedbackProc);
+        CMP_ERROR cmp_status = ConvertTexture(&srcTexture, &destTexture, pOptions, pFeedbackProc, pUser1, pUser2);
         if (cmp_status != CMP_OK)
         {
             return cmp_status;
@@ -586,154 +1124,285 @@ CMP_ERROR CMP_API CMP_ConvertMipTexture(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_Mi
     else
 #endif
     {
-        if (!CMips.AllocateMipSet(p_MipSetOut,
-                                  p_MipSetOut->m_ChannelFormat,
-                                  TDT_ARGB,
-                                  p_MipSetOut->m_TextureType,
-                                  p_MipSetIn->m_nWidth,
-                                  p_MipSetIn->m_nHeight,
-                                  p_MipSetOut->m_nDepth))
+        std::vector<CMP_MipConvertItem> items;
+
+        CMP_ERROR cmp_status = SetupMipConvertItems(p_MipSetIn, p_MipSetOut, pOptions, items);
+        if (cmp_status != CMP_OK)
+            return cmp_status;
+
+        // With more than one face or mip level, all of them are compressed together on the thread pool
+        bool bUseBands = (items.size() > 1) && !pOptions->bDisableMultiThreading && (pOptions->dwnumThreads != 1) &&
+                         CanConvertMipBands(p_MipSetIn->m_format, pOptions->DestFormat);
+        if (bUseBands)
+            ConvertMipItemsInBands(items, pOptions, pFeedbackProc, pUser1, pUser2);
+
+        cmp_status = ProcessMipConvertItems(p_MipSetOut, pOptions, items, bUseBands, pFeedbackProc, pUser1, pUser2);
+        if (cmp_status != CMP_OK)
+            return cmp_status;
+    }
+    //if (pFeedbackProc)
+    //    pFeedbackProc(100, NULL, NULL);
+
+    return CMP_OK;
+}
+
+CMP_ERROR CMP_API CMP_ConvertMipTexture(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_MipSetOut, const CMP_CompressOptions* pOptions, CMP_Feedback_Proc pFeedbackProc)
+{
+    return ConvertMipTexture(p_MipSetIn, p_MipSetOut, pOptions, pFeedbackProc, NULL, NULL);
+}
+
+//=====================================================================================
+// CMP_ConvertMipTextureAsync
+//
+// The output mip set is set up on the calling thread. A job that can be split into bands then
+// keeps at most one band task per worker on the thread pool. A band task converts bands until
+// work of other callers is waiting in the pool's shared queue and then queues itself behind that work,
+// so concurrent jobs and blocking conversions take turns on the workers. Jobs that can not be
+// split run as a single pool task.
+//=====================================================================================
+
+struct CMP_ConvertJobState
+{
+    CMP_MipSet*          pMipSetIn;
+    CMP_MipSet*          pMipSetOut;
+    CMP_CompressOptions  options;
+    CMP_CompressOptions  bandOptions;
+    CMP_Feedback_Proc    pFeedbackProc;
+    CMP_JobComplete_Proc pCompleteProc;
+    CMP_DWORD_PTR        pUser;
+
+    CMP_MipBandJob                  bandJob;  // Progress and cancellation, also used by jobs without bands
+    std::vector<CMP_MipConvertItem> items;
+    std::vector<CMP_MipBand>        bands;
+    std::atomic<CMP_INT>            nextBand;
+    std::atomic<CMP_INT>            bandsLeft;
+    std::atomic<CMP_INT>            queuedBandTasks;  // Band tasks of this job in the pool's shared queue
+
+    std::mutex              doneMutex;
+    std::condition_variable doneCondition;
+    bool                    bDone;
+    CMP_ERROR               status;
+};
+
+// The handle given out to the caller, a job that is released before it is done keeps running
+struct CMP_ConvertJob
+{
+    std::shared_ptr<CMP_ConvertJobState> state;
+};
+
+// Pool task group of all async jobs, the jobs track their own completion
+static CMP_TaskGroup& ConvertJobTasks()
+{
+    // Intentionally never destroyed, like the pool itself
+    static CMP_TaskGroup* group = new CMP_TaskGroup();
+    return *group;
+}
+
+static bool CMP_API ConvertJobFeedback(CMP_FLOAT fProgress, CMP_DWORD_PTR pUser1, CMP_DWORD_PTR pUser2)
+{
+    (void)pUser2;
+    CMP_ConvertJobState* job = (CMP_ConvertJobState*)pUser1;
+
+    std::lock_guard<std::mutex> lock(job->bandJob.feedbackMutex);
+    job->bandJob.fProgress = fProgress;
+    if (!job->bandJob.aborted && job->pFeedbackProc && job->pFeedbackProc(fProgress, job->pUser, 0))
+        job->bandJob.aborted = true;
+
+    return job->bandJob.aborted;
+}
+
+static void FinishConvertJob(CMP_ConvertJobState* job, CMP_ERROR status)
+{
+    if ((status == CMP_OK) && job->bandJob.aborted)
+        status = CMP_ABORTED;
+
+    if (status == CMP_OK)
+    {
+        std::lock_guard<std::mutex> lock(job->bandJob.feedbackMutex);
+        job->bandJob.fProgress = 100.0f;
+    }
+
+    // The callback runs before waiters are released, so a caller that waited may free everything it passed in
+    if (job->pCompleteProc)
+        job->pCompleteProc(status, job->pUser);
+
+    {
+        std::lock_guard<std::mutex> lock(job->doneMutex);
+        job->status = status;
+        job->bDone  = true;
+        job->doneCondition.notify_all();
+    }
+
+    // Pool workers in CMP_WaitConvertJob sleep on the pool
+    CMP_ThreadPool::GetInstance().WakeWaiters();
+}
+
+static void RunConvertJobBands(const std::shared_ptr<CMP_ConvertJobState>& state);
+
+static void SubmitConvertJobBands(const std::shared_ptr<CMP_ConvertJobState>& state)
+{
+    state->queuedBandTasks++;
+    CMP_ThreadPool::GetInstance().SubmitShared(ConvertJobTasks(), [state]() { RunConvertJobBands(state); });
+}
+
+static void RunConvertJobBands(const std::shared_ptr<CMP_ConvertJobState>& state)
+{
+    CMP_ThreadPool&      pool     = CMP_ThreadPool::GetInstance();
+    CMP_ConvertJobState* job      = state.get();
+    CMP_INT              numBands = (CMP_INT)job->bands.size();
+
+    job->queuedBandTasks--;
+
+    CMP_INT nBand;
+    while ((nBand = job->nextBand++) < numBands)
+    {
+        ConvertMipBand(job->bands[nBand], &job->bandOptions, MipBandFeedback);
+
+        if (--job->bandsLeft == 0)
         {
-            return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
+            GatherMipBandStatus(job->items, job->bands);
+            FinishConvertJob(job, ProcessMipConvertItems(job->pMipSetOut, &job->options, job->items, true, NULL, 0, 0));
+            return;
         }
 
-        CMP_INT srcNumMipmapLevels = p_MipSetIn->m_nMipLevels;
-
-        // It is possible that the source texture will have an "m_nMipLevels" value greater than 1 when compressing to Brotli-G,
-        // but it will not contain any data, so we always want to compress only the one mipmap level.
-        // We do this instead of altering the value because it is still important for us to be able to know how many mipmap levels
-        // the source texture has when compressing to Brotli-G
-        if (pOptions->DestFormat == CMP_FORMAT_BROTLIG)
+        // The other band tasks of this job do not count, they would make every band requeue the job
+        if (pool.HasSharedWork(job->queuedBandTasks.load()) && (job->nextBand.load() < numBands))
         {
-            srcNumMipmapLevels = 1;
+            SubmitConvertJobBands(state);
+            return;
         }
+    }
+}
 
-        p_MipSetOut->m_nMipLevels = p_MipSetIn->m_nMipLevels;
+CMP_ERROR CMP_API CMP_ConvertMipTextureAsync(CMP_MipSet*                p_MipSetIn,
+                                             CMP_MipSet*                p_MipSetOut,
+                                             const CMP_CompressOptions* pOptions,
+                                             CMP_Feedback_Proc          pFeedbackProc,
+                                             CMP_JobComplete_Proc       pCompleteProc,
+                                             CMP_DWORD_PTR              pUser,
+                                             CMP_ConvertJob**           ppJob)
+{
+    if (ppJob)
+        *ppJob = NULL;
+
+    if (!p_MipSetIn)
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+    if (!p_MipSetOut)
+        return CMP_ERR_INVALID_DEST_TEXTURE;
+    if (!pOptions || (pOptions->dwSize != sizeof(CMP_CompressOptions)))
+        return CMP_ERR_GENERIC;
+
+    std::shared_ptr<CMP_ConvertJobState> state = std::make_shared<CMP_ConvertJobState>();
+    CMP_ConvertJobState*                 job   = state.get();
+
+    job->pMipSetIn         = p_MipSetIn;
+    job->pMipSetOut        = p_MipSetOut;
+    job->options           = *pOptions;
+    job->pFeedbackProc     = pFeedbackProc;
+    job->pCompleteProc     = pCompleteProc;
+    job->pUser             = pUser;
+    job->bandJob.fProgress = 0.0f;
+    job->bandJob.aborted   = false;
+    job->nextBand          = 0;
+    job->bandsLeft         = 0;
+    job->queuedBandTasks   = 0;
+    job->bDone             = false;
+    job->status            = CMP_OK;
+
+    // Band progress goes to the user with the job's user pointer
+    job->bandJob.pFeedbackProc = pFeedbackProc;
+    job->bandJob.pUser1        = pUser;
+    job->bandJob.pUser2        = 0;
+
+    CMP_ThreadPool& pool      = CMP_ThreadPool::GetInstance();
+    bool            bUseBands = CanConvertMipBands(p_MipSetIn->m_format, pOptions->DestFormat);
+    CMP_INT         numTasks  = 1;
+
+    if (bUseBands)
+    {
+        InitMipConvertOutput(p_MipSetIn, p_MipSetOut, &job->options);
 
-        for (int nMipLevel = 0; nMipLevel < srcNumMipmapLevels; nMipLevel++)
-        {
-            if (pOptions->m_PrintInfoStr && srcNumMipmapLevels > 1)
-            {
-                char buff[256];
-                snprintf(buff, sizeof(buff), "Processing miplevel %d for texture...\n", nMipLevel);
-                pOptions->m_PrintInfoStr(buff);
-            }
+        CMP_ERROR cmp_status = SetupMipConvertItems(p_MipSetIn, p_MipSetOut, &job->options, job->items);
+        if (cmp_status != CMP_OK)
+            return cmp_status;
 
-            for (int nFaceOrSlice = 0; nFaceOrSlice < CMP_MaxFacesOrSlices(p_MipSetIn, nMipLevel); nFaceOrSlice++)
-            {
-                CMP_DWORD sourceDataSize = 0;
-
-                //=====================
-                // Uncompressed source
-                //======================
-                CMP_MipLevel* srcMipLevel  = CMips.GetMipLevel(p_MipSetIn, nMipLevel, nFaceOrSlice);
-                srcTexture.dwPitch         = 0;
-                srcTexture.nBlockWidth     = p_MipSetIn->m_nBlockWidth;
-                srcTexture.nBlockHeight    = p_MipSetIn->m_nBlockHeight;
-                srcTexture.nBlockDepth     = p_MipSetIn->m_nBlockDepth;
-                srcTexture.format          = p_MipSetIn->m_format;
-                srcTexture.transcodeFormat = p_MipSetIn->m_transcodeFormat;
-                srcTexture.dwWidth         = srcMipLevel->m_nWidth;
-                srcTexture.dwHeight        = srcMipLevel->m_nHeight;
-                srcTexture.pData           = srcMipLevel->m_pbData;
-                srcTexture.dwDataSize      = CMP_CalculateBufferSize(&srcTexture);
-
-                // Temporary settings
-                p_MipSetIn->dwWidth    = srcTexture.dwWidth;
-                p_MipSetIn->dwHeight   = srcTexture.dwHeight;
-                p_MipSetIn->pData      = srcTexture.pData;
-                p_MipSetIn->dwDataSize = srcTexture.dwDataSize;
-
-                //========================
-                // Compressed Destination
-                //========================
-                CMP_Texture destTexture     = {};
-                destTexture.dwSize          = sizeof(destTexture);
-                destTexture.dwWidth         = srcMipLevel->m_nWidth;
-                destTexture.dwHeight        = srcMipLevel->m_nHeight;
-                destTexture.dwPitch         = 0;
-                destTexture.nBlockWidth     = p_MipSetIn->m_nBlockWidth;
-                destTexture.nBlockHeight    = p_MipSetIn->m_nBlockHeight;
-                destTexture.format          = pOptions->DestFormat;
-                destTexture.transcodeFormat = p_MipSetOut->m_transcodeFormat;
-                destTexture.dwDataSize      = CMP_CalculateBufferSize(&destTexture);
-
-                p_MipSetOut->m_format   = destTexture.format;
-                p_MipSetOut->dwDataSize = destTexture.dwDataSize;
-                p_MipSetOut->dwWidth    = destTexture.dwWidth;
-                p_MipSetOut->dwHeight   = destTexture.dwHeight;
-
-                //--------------------------------------
-                // Allocate MipSet for Block Compressors
-                //--------------------------------------
-                CMP_MipLevel* pOutMipLevel = CMips.GetMipLevel(p_MipSetOut, nMipLevel, nFaceOrSlice);
-                if (!CMips.AllocateCompressedMipLevelData(pOutMipLevel, destTexture.dwWidth, destTexture.dwHeight, destTexture.dwDataSize))
-                {
-                    return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
-                }
-
-                destTexture.pData  = pOutMipLevel->m_pbData;
-                p_MipSetOut->pData = pOutMipLevel->m_pbData;
-
-                //==========================
-                // Print info about input
-                //==========================
-                // NOTE: This is duplicated in CMP_ConvertMipTextureCGP
-                if (pOptions->m_PrintInfoStr)
-                {
-                    char buff[256];
-                    if ((p_MipSetOut->m_format == CMP_FORMAT_BROTLIG) || (p_MipSetOut->m_format == CMP_FORMAT_BINARY))
-                        snprintf(buff, sizeof(buff), "Source data size      = %d Bytes\n", srcTexture.dwDataSize);
-                    else
-                        snprintf(buff,
-                                 sizeof(buff),
-                                 "Source data size      = %d Bytes, width = %d px  height = %d px\n",
-                                 srcTexture.dwDataSize,
-                                 srcTexture.dwWidth,
-                                 srcTexture.dwHeight);
-                    pOptions->m_PrintInfoStr(buff);
-                }
-
-                // this is needed to preserve the correct initial source size because CMP_ConvertTexture might
-                // edit the srcTexture and change its format into one better suited for processing
-                sourceDataSize = srcTexture.dwDataSize;
-
-                //========================
-                // Process ConvertTexture
-                //========================
-                CMP_ERROR cmp_status = CMP_ConvertTexture(&srcTexture, &destTexture, pOptions, pFeedbackProc);
-
-                if (cmp_status != CMP_OK)
-                {
-                    return cmp_status;
-                }
-                else
-                    p_MipSetOut->m_nIterations++;
-
-                if (p_MipSetOut->m_format == CMP_FORMAT_BROTLIG)
-                {
-                    p_MipSetOut->dwDataSize = destTexture.dwDataSize;
-                }
-
-                //==========================
-                // Print info about output
-                //==========================
-                // NOTE: This is mostly duplicated in CMP_ConvertMipTextureCGP
-                if (pOptions->m_PrintInfoStr && (destTexture.dwDataSize > 0) && (p_MipSetOut->m_format != CMP_FORMAT_BINARY))
-                {
-                    char buff[256];
-                    snprintf(buff,
-                             sizeof(buff),
-                             "\rDestination data size = %d Bytes   Resulting compression ratio = %2.2f:1\n",
-                             destTexture.dwDataSize,
-                             sourceDataSize / (float)destTexture.dwDataSize);
-                    pOptions->m_PrintInfoStr(buff);
-                }
-            }
-        }
+        CMP_INT numWorkers = MipBandWorkers(&job->options);
+        MakeMipBands(job->items, numWorkers, &job->bandJob, job->bands);
+
+        job->bandOptions              = job->options;
+        job->bandOptions.dwnumThreads = 1;
+        job->bandsLeft                = (CMP_INT)job->bands.size();
+        numTasks                      = cmp_minT(numWorkers, (CMP_INT)job->bands.size());
+    }
+
+    if (ppJob)
+    {
+        *ppJob          = new CMP_ConvertJob();
+        (*ppJob)->state = state;
+    }
+
+    if (!bUseBands)
+    {
+        pool.SubmitShared(ConvertJobTasks(), [state]() {
+            CMP_ConvertJobState* job = state.get();
+            FinishConvertJob(job, ConvertMipTexture(job->pMipSetIn, job->pMipSetOut, &job->options, ConvertJobFeedback, (CMP_DWORD_PTR)job, 0));
+        });
+    }
+    else if (numTasks == 0)
+        FinishConvertJob(job, CMP_OK);
+    else
+    {
+        for (CMP_INT t = 0; t < numTasks; t++)
+            SubmitConvertJobBands(state);
     }
-    //if (pFeedbackProc)
-    //    pFeedbackProc(100, NULL, NULL);
 
     return CMP_OK;
 }
+
+CMP_BOOL CMP_API CMP_PollConvertJob(CMP_ConvertJob* pJob, CMP_FLOAT* pProgress)
+{
+    if (!pJob)
+        return true;
+
+    CMP_ConvertJobState* job = pJob->state.get();
+    if (pProgress)
+    {
+        std::lock_guard<std::mutex> lock(job->bandJob.feedbackMutex);
+        *pProgress = cmp_minT(job->bandJob.fProgress, 100.0f);
+    }
+
+    std::lock_guard<std::mutex> lock(job->doneMutex);
+    return job->bDone;
+}
+
+CMP_ERROR CMP_API CMP_WaitConvertJob(CMP_ConvertJob* pJob)
+{
+    if (!pJob)
+        return CMP_ERR_GENERIC;
+
+    CMP_ConvertJobState* job = pJob->state.get();
+
+    // A pool worker keeps running queued work, the job may be waiting for this worker
+    if (CMP_ThreadPool::GetWorkerIndex() >= 0)
+    {
+        CMP_ThreadPool::GetInstance().WaitUntil([job]() {
+            std::lock_guard<std::mutex> lock(job->doneMutex);
+            return job->bDone;
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(job->doneMutex);
+    job->doneCondition.wait(lock, [job] { return job->bDone; });
+    return job->status;
+}
+
+CMP_VOID CMP_API CMP_CancelConvertJob(CMP_ConvertJob* pJob)
+{
+    if (pJob)
+        pJob->state->bandJob.aborted = true;
+}
+
+CMP_VOID CMP_API CMP_ReleaseConvertJob(CMP_ConvertJob* pJob)
+{
+    delete pJob;
+}
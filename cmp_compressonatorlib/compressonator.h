@@ -344,6 +344,9 @@ struct KernelOptions
 #define MS_FLAG_Default 0x0000
 #define MS_FLAG_AlphaPremult 0x0001
 #define MS_FLAG_DisableMipMapping 0x0002
+#define MS_FLAG_ContiguousLevels 0x0004  // The data of all mip levels and faces is one 64 byte aligned block owned by the mip set
+#define MS_FLAG_MapSourceFile 0x0008     // Set before CMP_LoadTexture to map compressed DDS data instead of reading it into memory
+#define MS_FLAG_MappedLevels 0x0010      // The level data points into a copy-on-write mapping of the source file, see CMP_DetachMipSet
 #define AMD_MAX_CMDS 20
 #define AMD_MAX_CMD_STR 32
 #define AMD_MAX_CMD_PARAM 16
@@ -491,6 +494,11 @@ typedef struct
     CMP_BOOL genGPUMipMaps;  // When ecoding with GPU HW use it to generate MipMap images, valid only when miplevels is set else default is toplevel 1
     CMP_BOOL useSRGBFrames;  // when using GPU HW for encoding and mipmap generation use SRGB frames, default is RGB
     CMP_INT  miplevels;      // miplevels to use when GPU is used to generate them
+
+    CMP_DWORD dwTileHeight;  // Height in block rows of the image tiles that threaded CPU compression hands out to the thread pool workers.
+                             // Smaller tiles balance uneven images better, larger tiles have less overhead. Default 0 uses 4 block rows
+    CMP_BOOL  bUseFloatBC7;  // Encode BC7 on the CPU with the single precision CMP_Core encoder instead of the double precision reference encoder.
+                             // It works on 8-bit blocks directly, dwmodeMask, fquality and the restrict settings are used as for the reference encoder
 } CMP_CompressOptions;
 
 //===================================
@@ -581,6 +589,11 @@ typedef struct
     int   destHeight;  // Scale source texture height to destHeight default 0 no scalwing
     bool  useSRGB;     // if set true process image as SRGB else use linear color space. Default is false
 
+    // Setting that applies to the CPU Box Filter
+    bool      useThreadPool;  // if set true generate each MIP level on the library thread pool, split into row tiles and faces or slices.
+                              // Default is false, the levels are generated on the calling thread
+    CMP_DWORD dwnumThreads;   // Maximum number of thread pool workers used when useThreadPool is set, default 0 uses all workers
+
 } CMP_CFilterParams;
 
 typedef enum
@@ -965,6 +978,37 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture*               pSourceTexture,
                                      const CMP_CompressOptions* pOptions,
                                      CMP_Feedback_Proc          pFeedbackProc);
 
+// Row callbacks for CMP_ConvertTextureStream, pUser is the value given in CMP_RowStream.
+// CMP_ReadRows_Proc fills pRows with dwRowCount source rows starting at row dwRow, each row dwPitch bytes apart.
+// CMP_WriteRows_Proc receives the dwSize bytes of compressed blocks covering dwRowCount rows starting at row dwRow.
+// Both are called in row order from the thread that called CMP_ConvertTextureStream, anything but CMP_OK stops the conversion.
+typedef CMP_ERROR(CMP_API* CMP_ReadRows_Proc)(CMP_BYTE* pRows, CMP_DWORD dwRow, CMP_DWORD dwRowCount, CMP_DWORD dwPitch, CMP_DWORD_PTR pUser);
+typedef CMP_ERROR(CMP_API* CMP_WriteRows_Proc)(const CMP_BYTE* pData, CMP_DWORD dwSize, CMP_DWORD dwRow, CMP_DWORD dwRowCount, CMP_DWORD_PTR pUser);
+
+typedef struct
+{
+    CMP_DWORD          dwSize;      // The size of this structure.
+    CMP_DWORD          dwBandRows;  // Source rows compressed as one band, rounded up to whole blocks - 0 for a default
+    CMP_ReadRows_Proc  pReadRows;   // Source of the rows
+    CMP_WriteRows_Proc pWriteRows;  // Sink of the compressed rows
+    CMP_DWORD_PTR      pUser;       // Passed to the callbacks
+} CMP_RowStream;
+
+// Compresses a texture that is never held in memory as a whole, such as a source image larger than the memory available.
+// The source rows are read in bands, one band per worker thread is compressed at a time and the compressed bands are
+// written in order, so only those bands are in memory at once. Only compression to block formats is supported.
+// \param[in] pSourceTexture The source texture, pData is not used.
+// \param[in] pDestTexture The destination texture, pData is not used.
+// \param[in] pOptions A pointer to the compression options.
+// \param[in] pStream The row callbacks.
+// \param[in] pFeedbackProc A pointer to the feedback function, called after each set of bands - can be NULL.
+// \return    CMP_OK if successful, otherwise the error code.
+CMP_ERROR CMP_API CMP_ConvertTextureStream(const CMP_Texture*         pSourceTexture,
+                                           const CMP_Texture*         pDestTexture,
+                                           const CMP_CompressOptions* pOptions,
+                                           const CMP_RowStream*       pStream,
+                                           CMP_Feedback_Proc          pFeedbackProc);
+
 #ifdef __cplusplus
 };
 #endif
@@ -1023,6 +1067,89 @@ typedef struct
 
 } CMP_AnalysisData;
 
+// Settings for the library wide CPU thread pool shared by all codecs
+typedef struct
+{
+    CMP_DWORD dwSize;            // The size of this structure.
+    CMP_DWORD dwNumThreads;      // Number of worker threads, 0 = number of processors (max 128)
+    CMP_BOOL  bPinThreads;       // Bind each worker to a single logical processor
+    CMP_DWORD dwFirstProcessor;  // First logical processor used when bPinThreads is set, worker n uses dwFirstProcessor + n
+} CMP_ThreadPoolOptions;
+
+// Upper limit on the number of thread pool workers, codecs size their per worker encoder tables with this
+#define CMP_MAX_POOL_THREADS 128
+
+// Handle of a conversion queued with CMP_ConvertMipTextureAsync
+typedef struct CMP_ConvertJob CMP_ConvertJob;
+
+// CMP_JobComplete_Proc
+// Completion function for asynchronous conversion.
+// \param[in] status The final status of the job, CMP_ABORTED when it was cancelled.
+// \param[in] pUser The user pointer given when the job was queued.
+typedef void(CMP_API* CMP_JobComplete_Proc)(CMP_ERROR status, CMP_DWORD_PTR pUser);
+
+// Per worker activity of the CPU thread pool since it was started or the stats were last reset
+typedef struct
+{
+    CMP_DWORD dwSize;                         // The size of this structure.
+    CMP_INT   nNumThreads;                    // Number of workers, entries past this in the arrays are 0
+    CMP_FLOAT fElapsedMS;                     // Wall clock time covered by the stats
+    CMP_FLOAT fBusyMS[CMP_MAX_POOL_THREADS];  // Time each worker spent running tasks
+    CMP_DWORD dwTasks[CMP_MAX_POOL_THREADS];  // Number of tasks each worker picked up
+} CMP_ThreadPoolStats;
+
+// Allocator callbacks for mip level data and codec buffers, pUser is the value given in CMP_AllocatorOptions
+typedef void*(CMP_API* CMP_Alloc_Proc)(size_t size, CMP_DWORD_PTR pUser);
+typedef void(CMP_API* CMP_Free_Proc)(void* ptr, CMP_DWORD_PTR pUser);
+typedef void*(CMP_API* CMP_AlignedAlloc_Proc)(size_t size, size_t alignment, CMP_DWORD_PTR pUser);
+
+// Settings for the library memory allocations
+typedef struct
+{
+    CMP_DWORD             dwSize;         // The size of this structure.
+    CMP_Alloc_Proc        pAlloc;         // Allocates a block, NULL = malloc
+    CMP_Free_Proc         pFree;          // Frees blocks from pAlloc, NULL = free
+    CMP_AlignedAlloc_Proc pAlignedAlloc;  // Allocates an aligned block - can be NULL, then pAlloc blocks are padded for alignment
+    CMP_Free_Proc         pAlignedFree;   // Frees blocks from pAlignedAlloc
+    CMP_DWORD_PTR         pUser;          // Passed to the callbacks
+    CMP_BOOL              bUseArena;      // Keep freed blocks and reuse them for later requests of a similar size
+    CMP_DWORD             dwArenaSizeMB;  // Most memory the arena keeps for reuse, 0 = 256 MB
+} CMP_AllocatorOptions;
+
+// Library memory use since the allocator was set or the stats were last reset, sizes are in bytes
+typedef struct
+{
+    CMP_DWORD dwSize;           // The size of this structure.
+    size_t    nBytesInUse;      // Held by mip levels and codec buffers
+    size_t    nPeakBytesInUse;  // Highest nBytesInUse
+    size_t    nBytesAllocated;  // Total requested from the allocator, blocks reused from the arena are not counted
+    size_t    nArenaBytes;      // Kept by the arena for reuse
+    CMP_DWORD dwAllocations;    // Number of blocks requested from the allocator
+    CMP_DWORD dwArenaReuses;    // Number of requests served from the arena
+} CMP_MemoryStats;
+
+// Stream callbacks for loading and saving textures without a file, pUser is the value given in CMP_Stream.
+// Read and write return the number of bytes transferred, which is less than size only at the end of the data or on an error.
+// Seek takes SEEK_SET, SEEK_CUR or SEEK_END as origin and returns 0 on success, tell returns -1 on an error.
+typedef size_t(CMP_API* CMP_StreamRead_Proc)(void* pBuffer, size_t size, CMP_DWORD_PTR pUser);
+typedef size_t(CMP_API* CMP_StreamWrite_Proc)(const void* pBuffer, size_t size, CMP_DWORD_PTR pUser);
+typedef int(CMP_API* CMP_StreamSeek_Proc)(int64_t offset, int origin, CMP_DWORD_PTR pUser);
+typedef int64_t(CMP_API* CMP_StreamTell_Proc)(CMP_DWORD_PTR pUser);
+typedef void(CMP_API* CMP_StreamClose_Proc)(CMP_DWORD_PTR pUser);
+
+// Source or destination of a texture. A stream without pSeek and pTell is read into memory before the texture is loaded,
+// or the texture is saved to memory and then written to the stream in order.
+typedef struct
+{
+    CMP_DWORD            dwSize;  // The size of this structure.
+    CMP_StreamRead_Proc  pRead;   // Needed to load
+    CMP_StreamWrite_Proc pWrite;  // Needed to save
+    CMP_StreamSeek_Proc  pSeek;   // Can be NULL
+    CMP_StreamTell_Proc  pTell;   // Can be NULL, needed when pSeek is set
+    CMP_StreamClose_Proc pClose;  // Called when the load or save is done with the stream - can be NULL
+    CMP_DWORD_PTR        pUser;   // Passed to the callbacks
+} CMP_Stream;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -1034,6 +1161,12 @@ CMP_INT CMP_API   CMP_GenerateMIPLevelsEx(CMP_MipSet* pMipSet, CMP_CFilterParams
 CMP_INT CMP_API   CMP_GenerateMIPLevels(CMP_MipSet* pMipSet, CMP_INT nMinSize);
 CMP_ERROR CMP_API CMP_CreateCompressMipSet(CMP_MipSet* pMipSetCMP, CMP_MipSet* pMipSetSRC);
 CMP_ERROR CMP_API CMP_CreateMipSet(CMP_MipSet* pMipSet, CMP_INT nWidth, CMP_INT nHeight, CMP_INT nDepth, ChannelFormat channelFormat, TextureType textureType);
+CMP_ERROR CMP_API CMP_CreateContiguousMipSet(CMP_MipSet*   pMipSet,
+                                             CMP_INT       nWidth,
+                                             CMP_INT       nHeight,
+                                             CMP_INT       nDepth,
+                                             ChannelFormat channelFormat,
+                                             TextureType   textureType);
 
 // MIP Map Quality
 CMP_UINT CMP_API  CMP_getFormat_nChannels(CMP_FORMAT format);
@@ -1049,11 +1182,48 @@ typedef bool(CMP_API* CMP_MIPFeedback_Proc)(CMP_MIPPROGRESSPARAM mipProgress);
 // Converts the source texture to the destination texture using MipSets with MIP MAP Levels
 CMP_ERROR CMP_API CMP_ConvertMipTexture(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_MipSetOut, const CMP_CompressOptions* pOptions, CMP_Feedback_Proc pFeedbackProc);
 
+// Asynchronous CMP_ConvertMipTexture, the conversion runs on the CPU thread pool and the call returns once it is queued.
+// Jobs from all callers share the pool workers in turns. The source and destination MipSets must stay valid until the job is done.
+// \param[in] pFeedbackProc Progress of the whole mip set, called from pool workers with pUser as pUser1 - can be NULL.
+// \param[in] pCompleteProc Called once from a pool worker with the final status before the job reports done - can be NULL.
+// \param[out] ppJob Handle for CMP_PollConvertJob, CMP_WaitConvertJob and CMP_CancelConvertJob, free it with CMP_ReleaseConvertJob - can be NULL.
+// \return    CMP_OK if the job was queued, otherwise the error code.
+CMP_ERROR CMP_API CMP_ConvertMipTextureAsync(CMP_MipSet*                p_MipSetIn,
+                                             CMP_MipSet*                p_MipSetOut,
+                                             const CMP_CompressOptions* pOptions,
+                                             CMP_Feedback_Proc          pFeedbackProc,
+                                             CMP_JobComplete_Proc       pCompleteProc,
+                                             CMP_DWORD_PTR              pUser,
+                                             CMP_ConvertJob**           ppJob);
+
+// Returns true once the job is done, pProgress receives the progress in percent - can be NULL
+CMP_BOOL CMP_API CMP_PollConvertJob(CMP_ConvertJob* pJob, CMP_FLOAT* pProgress);
+// Blocks until the job is done and returns its status, must not be called from the job's own callbacks
+CMP_ERROR CMP_API CMP_WaitConvertJob(CMP_ConvertJob* pJob);
+// Asks the job to stop, it then finishes with CMP_ABORTED unless it was already done
+CMP_VOID CMP_API CMP_CancelConvertJob(CMP_ConvertJob* pJob);
+// Frees the handle, a job that is still running carries on and still calls its completion callback
+CMP_VOID CMP_API CMP_ReleaseConvertJob(CMP_ConvertJob* pJob);
+
 //--------------------------------------------
 // CMP_Framework Lib: Texture Encoder Interfaces
 //--------------------------------------------
 CMP_ERROR CMP_API  CMP_LoadTexture(const char* sourceFile, CMP_MipSet* pMipSet);
 CMP_ERROR CMP_API  CMP_SaveTexture(const char* destFile, CMP_MipSet* pMipSet);
+// Copies mapped level data into memory so the mip set no longer depends on its source file, nothing to do for other mip sets
+CMP_ERROR CMP_API  CMP_DetachMipSet(CMP_MipSet* pMipSet);
+// Loading and saving without a file. pszFormat is the file extension of the format, such as "DDS" or ".ktx2". To load it
+// can be NULL, the format is then detected from the data. TGA has no signature and is only found by the stb fallback.
+CMP_ERROR CMP_API  CMP_LoadTextureFromStream(const CMP_Stream* pStream, const char* pszFormat, CMP_MipSet* pMipSet);
+CMP_ERROR CMP_API  CMP_SaveTextureToStream(const CMP_Stream* pStream, const char* pszFormat, CMP_MipSet* pMipSet);
+// Writes only the file header of a single level 2D texture in a block format, the rows from CMP_ConvertTextureStream are then
+// written after it to complete the file. pTexture gives the format and size, its pData is not used. Supports "DDS" and "KTX2".
+// pClose is not called, the stream stays open for the rows.
+CMP_ERROR CMP_API  CMP_SaveTextureHeaderToStream(const CMP_Stream* pStream, const char* pszFormat, const CMP_Texture* pTexture);
+CMP_ERROR CMP_API  CMP_LoadTextureFromMemory(const void* pData, size_t size, const char* pszFormat, CMP_MipSet* pMipSet);
+// *ppData receives the saved texture and *pSize its size in bytes, free the data with CMP_FreeTextureMemory
+CMP_ERROR CMP_API  CMP_SaveTextureToMemory(const char* pszFormat, CMP_MipSet* pMipSet, void** ppData, size_t* pSize);
+CMP_VOID CMP_API   CMP_FreeTextureMemory(void* pData);
 CMP_ERROR CMP_API  CMP_ProcessTexture(CMP_MipSet* srcMipSet, CMP_MipSet* dstMipSet, KernelOptions kernelOptions, CMP_Feedback_Proc pFeedbackProc);
 CMP_ERROR CMP_API  CMP_CompressTexture(KernelOptions* options, CMP_MipSet srcMipSet, CMP_MipSet dstMipSet, CMP_Feedback_Proc pFeedback);
 CMP_VOID CMP_API   CMP_Format2FourCC(CMP_FORMAT format, CMP_MipSet* pMipSet);
@@ -1066,6 +1236,26 @@ CMP_ERROR CMP_API  CMP_GetDeviceInfo(KernelDeviceInfo* pDeviceInfo);
 CMP_BOOL CMP_API   CMP_IsCompressedFormat(CMP_FORMAT format);
 CMP_BOOL CMP_API   CMP_IsFloatFormat(CMP_FORMAT InFormat);
 
+//--------------------------------------------
+// CPU thread pool: workers persist across calls and are shared by all CPU codecs.
+// The pool starts on first use with default settings, CMP_InitThreadPool restarts it
+// with new settings and must not be called while a conversion is in progress.
+//--------------------------------------------
+CMP_ERROR CMP_API CMP_InitThreadPool(const CMP_ThreadPoolOptions* pOptions);
+CMP_VOID CMP_API  CMP_ShutdownThreadPool();
+CMP_INT CMP_API   CMP_GetThreadPoolSize();
+CMP_ERROR CMP_API CMP_GetThreadPoolStats(CMP_ThreadPoolStats* pStats);
+CMP_VOID CMP_API  CMP_ResetThreadPoolStats();
+
+//--------------------------------------------
+// Memory: mip level data and codec buffers are allocated through these callbacks.
+// CMP_SetAllocator releases the blocks kept by the arena and must not be called while a conversion is in progress,
+// blocks that are still in use are freed by the allocator that made them. NULL restores malloc and free without an arena.
+//--------------------------------------------
+CMP_ERROR CMP_API CMP_SetAllocator(const CMP_AllocatorOptions* pOptions);
+CMP_ERROR CMP_API CMP_GetMemoryStats(CMP_MemoryStats* pStats);
+CMP_VOID CMP_API  CMP_ResetMemoryStats();
+
 //--------------------------------------------
 // CMP_Framework Lib: Host level interface
 //--------------------------------------------
@@ -31,9 +31,7 @@
 #include "common.h"
 #include "codec_dxt3.h"
 
-#ifdef TEST_CMP_CORE_DECODER
 #include "cmp_core.h"
-#endif
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -187,20 +185,32 @@ CodecError CCodec_DXT3::Decompress(CCodecBuffer&       bufferIn,
 
     bool bUseFixed = (!bufferOut.IsFloat() && bufferOut.GetChannelDepth() == 8 && !m_bUseFloat);
 
+    // RGBA:8888 buffers have the full blocks of each row decoded straight into the buffer
+    const bool      bDecodeRows = bUseFixed && bufferOut.GetBufferType() == CBT_RGBA8888;
+    const CMP_DWORD dwFullX     = bufferOut.GetWidth() >> 2;
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
-        for (CMP_DWORD i = 0; i < dwBlocksX; i++)
+        CMP_DWORD i = 0;
+        if (bDecodeRows && (j * 4 + 4) <= bufferOut.GetHeight())
+        {
+            DecompressBlocksBC2(bufferIn.GetData() + j * bufferIn.GetPitch(),
+                                bufferIn.GetPitch(),
+                                dwFullX,
+                                1,
+                                bufferOut.GetData() + j * 4 * bufferOut.GetPitch(),
+                                bufferOut.GetPitch());
+            i = dwFullX;
+        }
+
+        for (; i < dwBlocksX; i++)
         {
             CMP_DWORD compressedBlock[4];
             bufferIn.ReadBlock(i * 4, j * 4, compressedBlock, 4);
             if (bUseFixed)
             {
                 CMP_BYTE destBlock[BLOCK_SIZE_4X4X4];
-#ifdef TEST_CMP_CORE_DECODER
                 DecompressBlockBC2((CMP_BYTE*)compressedBlock, destBlock);
-#else
-                DecompressRGBABlock_ExplicitAlpha(destBlock, compressedBlock);
-#endif
                 bufferOut.WriteBlockRGBA(i * 4, j * 4, 4, 4, destBlock);
             }
             else
@@ -31,6 +31,7 @@
 #include "codec_etc.h"
 #include "compressonator_tc.h"
 #include "compressonatorxcodec.h"
+#include "cmp_core.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -42,36 +43,31 @@ CCodec_ETC::CCodec_ETC(CodecType codecType)
 #ifdef USE_ETCPACK
     readCompressParams();
 #endif
+    m_coreOptions = NULL;
+    if (CreateOptionsETC(&m_coreOptions) == 0)
+        SetQualityETC(m_coreOptions, AMD_CODEC_QUALITY_DEFAULT);
 }
 
 CCodec_ETC::~CCodec_ETC()
 {
+    if (m_coreOptions)
+        DestroyOptionsETC(m_coreOptions);
 }
 
-CodecError CCodec_ETC::CompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[2])
+bool CCodec_ETC::SetParameter(const CMP_CHAR* pszParamName, CODECFLOAT fValue)
 {
-    Color888_t srcRGB[4][4];
-    for (int y = 0; y < 4; y++)
-    {
-        for (CMP_DWORD x = 0; x < 4; x++)
-        {
-            srcRGB[x][y].red   = rgbBlock[(x * 16) + (y * 4) + ATC_RGBA8888_CHANNEL_R];
-            srcRGB[x][y].green = rgbBlock[(x * 16) + (y * 4) + ATC_RGBA8888_CHANNEL_G];
-            srcRGB[x][y].blue  = rgbBlock[(x * 16) + (y * 4) + ATC_RGBA8888_CHANNEL_B];
-        }
-    }
-
-    unsigned int  uiCompressedBlockHi, uiCompressedBlockLo;
-    unsigned char tmp[4 * 4 * 3];  // Required just by "fast" ETC function
-
-#ifdef USE_ETCPACK
-    compressBlockDiffFlipFastPerceptual((uint8*)&srcRGB, (uint8*)tmp, 4, 4, 0, 0, uiCompressedBlockHi, uiCompressedBlockLo);
-#else
-    cmp_compressBlockETC2FastPerceptual((uint8*)&srcRGB, (uint8*)tmp, uiCompressedBlockHi, uiCompressedBlockLo);
-#endif
+    if (strcmp(pszParamName, "Quality") == 0)
+        SetQualityETC(m_coreOptions, (float)fValue);
+    else
+        return CCodec_Block_4x4::SetParameter(pszParamName, fValue);
+    return true;
+}
 
-    compressedBlock[0] = SWIZZLE_DWORD(uiCompressedBlockHi);
-    compressedBlock[1] = SWIZZLE_DWORD(uiCompressedBlockLo);
+CodecError CCodec_ETC::CompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[2])
+{
+    // CMP_Core writes the block in the byte order required by the GPU
+    if (CompressBlockETC1(rgbBlock, BLOCK_SIZE_4 * 4, (unsigned char*)compressedBlock, m_coreOptions) != 0)
+        return CE_Unknown;
 
     return CE_OK;
 }
@@ -53,7 +53,13 @@ public:
     CCodec_ETC(CodecType codecType);
     virtual ~CCodec_ETC();
 
+    virtual bool SetParameter(const CMP_CHAR* pszParamName, CODECFLOAT fValue);
+
 protected:
+    // CMP_Core ETC options set from the "Quality" parameter: below 0.5 (including the 0.05 default) uses the fast
+    // search, 0.5 and above uses the full search. The etcpack exhaustive encoders are no longer used by the codecs
+    void* m_coreOptions;
+
     CodecError CompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[2]);
     CodecError CompressRGBABlock_ExplicitAlpha(CMP_BYTE rgbaBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[4]);
     CodecError CompressRGBABlock_InterpolatedAlpha(CMP_BYTE rgbaBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[4]);
@@ -29,6 +29,7 @@
 #include "codec_etc2.h"
 
 #include "compressonator_tc.h"
+#include "cmp_core.h"
 
 #pragma warning(push)
 #pragma warning(disable : 4244)
@@ -57,6 +58,10 @@ void CCodec_ETC2::setupAlphaTable()
 CCodec_ETC2::CCodec_ETC2(CodecType codecType)
     : CCodec_Block_4x4(codecType)
 {
+    m_coreOptions = NULL;
+    if (CreateOptionsETC(&m_coreOptions) == 0)
+        SetQualityETC(m_coreOptions, AMD_CODEC_QUALITY_DEFAULT);
+
 #ifdef USE_ETCPACK
     readCompressParams();
     switch (codecType)
@@ -94,6 +99,17 @@ CCodec_ETC2::CCodec_ETC2(CodecType codecType)
 
 CCodec_ETC2::~CCodec_ETC2()
 {
+    if (m_coreOptions)
+        DestroyOptionsETC(m_coreOptions);
+}
+
+bool CCodec_ETC2::SetParameter(const CMP_CHAR* pszParamName, CODECFLOAT fValue)
+{
+    if (strcmp(pszParamName, "Quality") == 0)
+        SetQualityETC(m_coreOptions, (float)fValue);
+    else
+        return CCodec_Block_4x4::SetParameter(pszParamName, fValue);
+    return true;
 }
 
 //=============
@@ -102,34 +118,9 @@ CCodec_ETC2::~CCodec_ETC2()
 
 CodecError CCodec_ETC2::CompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[2])
 {
-    Color888_t srcRGB[4][4];
-
-    for (int y = 0; y < 4; y++)
-    {
-        for (DWORD x = 0; x < 4; x++)
-        {
-            srcRGB[x][y].red   = rgbBlock[(x * 16) + (y * 4) + ATC_RGBA8888_CHANNEL_R];
-            srcRGB[x][y].green = rgbBlock[(x * 16) + (y * 4) + ATC_RGBA8888_CHANNEL_G];
-            srcRGB[x][y].blue  = rgbBlock[(x * 16) + (y * 4) + ATC_RGBA8888_CHANNEL_B];
-        }
-    }
-
-    unsigned int  uiCompressedBlockHi, uiCompressedBlockLo;
-    unsigned char tmp[4 * 4 * 3];  // Decompressed image
-
-#ifdef USE_ETCPACK
-    if (m_fast)
-    {
-        compressBlockETC2FastPerceptual((uint8*)&srcRGB, (uint8*)tmp, 4, 4, 0, 0, uiCompressedBlockHi, uiCompressedBlockLo);
-    }
-    else
-        compressBlockETC2ExhaustivePerceptual((uint8*)&srcRGB, (uint8*)tmp, 4, 4, 0, 0, uiCompressedBlockHi, uiCompressedBlockLo);
-#else
-    cmp_compressBlockETC2FastPerceptual((uint8*)&srcRGB, (uint8*)tmp, uiCompressedBlockHi, uiCompressedBlockLo);
-#endif
-
-    compressedBlock[0] = SWIZZLE_DWORD(uiCompressedBlockHi);  // Required format for GPU
-    compressedBlock[1] = SWIZZLE_DWORD(uiCompressedBlockLo);  // Required format for GPU
+    // CMP_Core writes the block in the byte order required by the GPU
+    if (CompressBlockETC2(rgbBlock, BLOCK_SIZE_4 * 4, (unsigned char*)compressedBlock, m_coreOptions) != 0)
+        return CE_Unknown;
 
     return CE_OK;
 }
@@ -186,35 +177,11 @@ void CCodec_ETC2::DecompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DW
 
 CodecError CCodec_ETC2::CompressRGBABlock(CMP_BYTE rgbaBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[4])
 {
-    CMP_BYTE alphaBlock[BLOCK_SIZE_4X4];
-    CMP_BYTE ii = 0;
-    for (DWORD y = 0; y < 4; y++)
-    {
-        for (DWORD x = 0; x < 4; x++)
-        {
-            alphaBlock[ii++] = rgbaBlock[(x * 4) + (y * 16) + RGBA8888_CHANNEL_A];
-        }
-    }
+    // EAC alpha block followed by the color block, in the byte order required by the GPU
+    if (CompressBlockETC2RGBA(rgbaBlock, BLOCK_SIZE_4 * 4, (unsigned char*)compressedBlock, m_coreOptions) != 0)
+        return CE_Unknown;
 
-    union
-    {
-        uint8     alphadata[8];
-        CMP_DWORD CompressedAlphaBlock[2];
-    } data;
-
-#ifdef USE_ETCPACK
-    if (m_fast)
-        compressBlockAlphaFast(alphaBlock, 0, 0, 4, 4, data.alphadata);
-    else
-        compressBlockAlphaSlow(alphaBlock, 0, 0, 4, 4, data.alphadata);
-#else
-    cmp_compressBlockAlphaFast(alphaBlock, data.alphadata);
-#endif
-
-    compressedBlock[0] = data.CompressedAlphaBlock[0];
-    compressedBlock[1] = data.CompressedAlphaBlock[1];
-
-    return CompressRGBBlock(rgbaBlock, &compressedBlock[ATC_OFFSET_RGB]);
+    return CE_OK;
 }
 
 void CCodec_ETC2::DecompressRGBABlock(CMP_BYTE rgbaBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[4])
@@ -137,8 +137,12 @@ public:
     CCodec_ETC2(CodecType codecType);
     virtual ~CCodec_ETC2();
 
+    virtual bool SetParameter(const CMP_CHAR* pszParamName, CODECFLOAT fValue);
+
 protected:
-    bool m_fast = true;
+    // CMP_Core ETC options set from the "Quality" parameter: below 0.5 (including the 0.05 default) uses the fast
+    // search, 0.5 and above uses the full search. The etcpack exhaustive encoders are no longer used by the codecs
+    void* m_coreOptions;
 
     CodecError CompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[2]);
     void       DecompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[2]);
@@ -5103,6 +5103,44 @@ void compressBlockDiffFlipCombined(uint8 *img,int width,int height,int startx,in
     }
 }
 
+// Seeds for the LBG-algorithm. srand()/rand() share one sequence between all threads, so blocks
+// compressed in parallel would pick up each other's numbers. This keeps the sequence per block and
+// produces the same numbers as the glibc rand() the seeds were originally taken from.
+#define LBG_RAND_MAX 2147483647
+class LBGRandom
+{
+public:
+    LBGRandom(unsigned int seed)
+    {
+        int word = (int)seed;
+        state[0] = seed;
+        for(int i = 1; i < 31; i++)
+        {
+            word = 16807 * (word % 127773) - 2836 * (word / 127773);
+            if(word < 0)
+                word += 2147483647;
+            state[i] = (unsigned int)word;
+        }
+        for(int i = 31; i < 34; i++)
+            state[i] = state[i - 31];
+        pos = 34;
+        for(int i = 0; i < 310; i++)
+            next();
+    }
+
+    int next()
+    {
+        unsigned int value = state[(pos - 31) % 34] + state[(pos - 3) % 34];
+        state[pos % 34] = value;
+        pos++;
+        return (int)(value >> 1);
+    }
+
+private:
+    unsigned int state[34];
+    unsigned int pos;
+};
+
 // Calculation of the two block colors using the LBG-algorithm
 // The following method scales down the intensity, since this can be compensated for anyway by both the H and T mode.
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
@@ -5111,7 +5149,7 @@ void computeColorLBGHalfIntensityFast(uint8 *img,int width,int startx,int starty
     uint8 block_mask[4][4];
 
     // reset rand so that we get predictable output per block
-    srand(10000);
+    LBGRandom lbgRandom(10000);
     //LBG-algorithm
     double D = 0, oldD, bestD = MAXIMUM_ERROR;
            //eps = 0.0000000001;
@@ -5181,7 +5219,7 @@ void computeColorLBGHalfIntensityFast(uint8 *img,int width,int startx,int starty
         {
             for (uint8 c = 0; c < 3; ++c) 
             { 
-                current_colors[s][c] = double((double(rand())/RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
+                current_colors[s][c] = double((double(lbgRandom.next())/LBG_RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
             }
         }
         
@@ -5306,7 +5344,7 @@ void computeColorLBGNotIntensityFast(uint8 *img,int width,int startx,int starty,
     uint8 block_mask[4][4];
 
     // reset rand so that we get predictable output per block
-    srand(10000);
+    LBGRandom lbgRandom(10000);
     //LBG-algorithm
     double D = 0, oldD, bestD = MAXIMUM_ERROR;
     // eps = 0.0000000001;
@@ -5376,7 +5414,7 @@ void computeColorLBGNotIntensityFast(uint8 *img,int width,int startx,int starty,
         {
             for (uint8 c = 0; c < 3; ++c) 
             { 
-                current_colors[s][c] = double((double(rand())/RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
+                current_colors[s][c] = double((double(lbgRandom.next())/LBG_RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
             }
         }
         // divide into two quantization sets and calculate distortion
@@ -5499,7 +5537,7 @@ void computeColorLBGNotIntensity(uint8 *img,int width,int startx,int starty, uin
     uint8 block_mask[4][4];
 
     // reset rand so that we get predictable output per block
-    srand(10000);
+    LBGRandom lbgRandom(10000);
     //LBG-algorithm
     double D = 0, oldD, bestD = MAXIMUM_ERROR;
     //, eps = 0.0000000001;
@@ -5569,7 +5607,7 @@ void computeColorLBGNotIntensity(uint8 *img,int width,int startx,int starty, uin
         {
             for (uint8 c = 0; c < 3; ++c) 
             { 
-                current_colors[s][c] = double((double(rand())/RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
+                current_colors[s][c] = double((double(lbgRandom.next())/LBG_RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
             }
         }
         
@@ -5692,7 +5730,7 @@ void computeColorLBG(uint8 *img,int width,int startx,int starty, uint8 (LBG_colo
     uint8 block_mask[4][4];
 
     // reset rand so that we get predictable output per block
-    srand(10000);
+    LBGRandom lbgRandom(10000);
     //LBG-algorithm
     double D = 0, oldD, bestD = MAXIMUM_ERROR;
     //, eps = 0.0000000001;
@@ -5754,7 +5792,7 @@ void computeColorLBG(uint8 *img,int width,int startx,int starty, uint8 (LBG_colo
         {
             for (uint8 c = 0; c < 3; ++c) 
             { 
-                current_colors[s][c] = double((double(rand())/RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
+                current_colors[s][c] = double((double(lbgRandom.next())/LBG_RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
             }
         }
         
@@ -5873,7 +5911,7 @@ void computeColorLBGfast(uint8 *img,int width,int startx,int starty, uint8 (LBG_
     uint8 block_mask[4][4];
 
     // reset rand so that we get predictable output per block
-    srand(10000);
+    LBGRandom lbgRandom(10000);
     //LBG-algorithm
     double D = 0, oldD, bestD = MAXIMUM_ERROR;
     //, eps = 0.0000000001;
@@ -5930,7 +5968,7 @@ void computeColorLBGfast(uint8 *img,int width,int startx,int starty, uint8 (LBG_
         {
             for (uint8 c = 0; c < 3; ++c) 
             { 
-                current_colors[s][c] = double((double(rand())/RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
+                current_colors[s][c] = double((double(lbgRandom.next())/LBG_RAND_MAX)*(max_v[c]-min_v[c])) + min_v[c];
             }
         }
         
@@ -92,6 +92,11 @@ CMP_STATIC CGU_FLOAT _cpu_bc1ComputeBestEndpoints(CGU_FLOAT*, CGU_FLOAT*, CGU_FL
 // function pointers
 CMP_STATIC CGU_FLOAT (*cpu_bc1ComputeBestEndpoints)(CGU_FLOAT*, CGU_FLOAT*, CGU_FLOAT*, CGU_FLOAT*, CGU_FLOAT*, int, int) = 0;
 
+// block batch encoders of the low quality settings, 0 when no SIMD extension is enabled
+CMP_STATIC unsigned int (*cpu_bc1CompressBlocksMinMax)(unsigned char*, unsigned int, const unsigned char*, int)      = 0;
+CMP_STATIC void (*cpu_bc3CompressAlphaBlocksMinMax)(unsigned char*, unsigned int, const unsigned char*, int)         = 0;
+CMP_STATIC void (*cpu_bc2CompressExplicitAlphaBlocks)(unsigned char*, unsigned int, const unsigned char*, int)       = 0;
+
 // Toggle which SIMD instruction set extensions to use. Setting this to EXTENSION_COUNT will enable auto-detection of supported extensions.
 // NOTE: The requested extension will only be enabled if it is supported by the current CPU.
 CMP_STATIC bool bc1ToggleSIMD(CGU_INT newExtension)
@@ -112,20 +117,32 @@ CMP_STATIC bool bc1ToggleSIMD(CGU_INT newExtension)
 #ifndef __APPLE__
     if (useAVX512 && IsAvailableAVX512(extensions))
     {
-        cpu_bc1ComputeBestEndpoints = avx512_bc1ComputeBestEndpoints;
+        cpu_bc1ComputeBestEndpoints        = avx512_bc1ComputeBestEndpoints;
+        cpu_bc1CompressBlocksMinMax        = avx512_bc1CompressBlocksMinMax;
+        cpu_bc3CompressAlphaBlocksMinMax   = avx512_bc3CompressAlphaBlocksMinMax;
+        cpu_bc2CompressExplicitAlphaBlocks = avx512_bc2CompressExplicitAlphaBlocks;
     }
     else if (useAVX2 && IsAvailableAVX2(extensions))
     {
-        cpu_bc1ComputeBestEndpoints = avx_bc1ComputeBestEndpoints;
+        cpu_bc1ComputeBestEndpoints        = avx_bc1ComputeBestEndpoints;
+        cpu_bc1CompressBlocksMinMax        = avx_bc1CompressBlocksMinMax;
+        cpu_bc3CompressAlphaBlocksMinMax   = avx_bc3CompressAlphaBlocksMinMax;
+        cpu_bc2CompressExplicitAlphaBlocks = avx_bc2CompressExplicitAlphaBlocks;
     }
     else if (useSSE42 && IsAvailableSSE4(extensions))
     {
-        cpu_bc1ComputeBestEndpoints = sse_bc1ComputeBestEndpoints;
+        cpu_bc1ComputeBestEndpoints        = sse_bc1ComputeBestEndpoints;
+        cpu_bc1CompressBlocksMinMax        = sse_bc1CompressBlocksMinMax;
+        cpu_bc3CompressAlphaBlocksMinMax   = sse_bc3CompressAlphaBlocksMinMax;
+        cpu_bc2CompressExplicitAlphaBlocks = sse_bc2CompressExplicitAlphaBlocks;
     }
     else
 #endif
     {
-        cpu_bc1ComputeBestEndpoints = _cpu_bc1ComputeBestEndpoints;
+        cpu_bc1ComputeBestEndpoints        = _cpu_bc1ComputeBestEndpoints;
+        cpu_bc1CompressBlocksMinMax        = 0;
+        cpu_bc3CompressAlphaBlocksMinMax   = 0;
+        cpu_bc2CompressExplicitAlphaBlocks = 0;
     }
 
     g_bc1FunctionPointersSet = true;
@@ -3065,9 +3082,14 @@ CMP_STATIC CGU_Vec2ui cpu_CompRGBBlock(CMP_IN CGU_Vec4uc bgraBlock[BLOCK_SIZE_4X
     CGU_UINT8  nIndices[2][BLOCK_SIZE_4X4];
     CGU_UINT32 compressedBlock[2] = {0, 0};
 
+    // Copy the pixels rather than casting the pointer, reading CGU_Vec4uc data through a CGU_UINT32 pointer
+    // breaks strict aliasing and optimized builds dropped the pixel stores made by the caller
+    CGU_UINT32 block_32[BLOCK_SIZE_4X4];
+    memcpy(block_32, bgraBlock, sizeof(block_32));
+
     CGU_FLOAT fError3 = CMP_FLT_MAX;
 
-    fError3 = cpu_CompRGBBlock32((CGU_UINT32*)bgraBlock,
+    fError3 = cpu_CompRGBBlock32(block_32,
                                  compressedBlock,
                                  BLOCK_SIZE_4X4,
                                  RG,
@@ -3093,7 +3115,7 @@ CMP_STATIC CGU_Vec2ui cpu_CompRGBBlock(CMP_IN CGU_Vec4uc bgraBlock[BLOCK_SIZE_4X
     {
         CGU_FLOAT fError4 = CMP_FLT_MAX;
         fError4           = (fError3 == 0.0) ? CMP_FLT_MAX
-                                             : cpu_CompRGBBlock32((CGU_UINT32*)bgraBlock,
+                                             : cpu_CompRGBBlock32(block_32,
                                                         compressedBlock,
                                                         BLOCK_SIZE_4X4,
                                                         RG,
@@ -82,6 +82,48 @@ void BC1DisableSIMD()
 {
     bc1ToggleSIMD(EXTENSION_NONE);
 }
+
+// Block batch encoders of the low quality settings, shared with the BC2 and BC3 encoders. The source blocks
+// are BLOCK_SIZE_4X4 RGBA:8888 pixels each, the 8 byte compressed blocks are written cmpBlockBytes apart.
+// They return false if no SIMD extension is enabled, the blocks are then left to the per block encoders.
+bool CompressColorBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const CMP_Vec4uc* srcBlocks, int numBlocks, unsigned int* solidBlocks)
+{
+    if (!g_bc1FunctionPointersSet)
+        bc1ToggleSIMD(EXTENSION_COUNT);
+
+    if (!cpu_bc1CompressBlocksMinMax)
+        return false;
+
+    unsigned int solid = cpu_bc1CompressBlocksMinMax(cmpBlocks, cmpBlockBytes, (const unsigned char*)srcBlocks, numBlocks);
+    if (solidBlocks)
+        *solidBlocks = solid;
+
+    return true;
+}
+
+bool CompressAlphaBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const CMP_Vec4uc* srcBlocks, int numBlocks)
+{
+    if (!g_bc1FunctionPointersSet)
+        bc1ToggleSIMD(EXTENSION_COUNT);
+
+    if (!cpu_bc3CompressAlphaBlocksMinMax)
+        return false;
+
+    cpu_bc3CompressAlphaBlocksMinMax(cmpBlocks, cmpBlockBytes, (const unsigned char*)srcBlocks, numBlocks);
+    return true;
+}
+
+bool CompressExplicitAlphaBlocks(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const CMP_Vec4uc* srcBlocks, int numBlocks)
+{
+    if (!g_bc1FunctionPointersSet)
+        bc1ToggleSIMD(EXTENSION_COUNT);
+
+    if (!cpu_bc2CompressExplicitAlphaBlocks)
+        return false;
+
+    cpu_bc2CompressExplicitAlphaBlocks(cmpBlocks, cmpBlockBytes, (const unsigned char*)srcBlocks, numBlocks);
+    return true;
+}
 #else
 int BC1EnableSSE4()
 {
@@ -357,6 +399,76 @@ int CMP_CDECL CompressBlockBC1(const unsigned char* srcBlock, unsigned int srcSt
     return CGU_CORE_OK;
 }
 
+int CMP_CDECL CompressBlocksBC1(const unsigned char*      srcBlocks,
+                                unsigned int              srcPitchInBytes,
+                                unsigned int              blocksX,
+                                unsigned int              blocksY,
+                                CMP_GLOBAL unsigned char* cmpBlocks,
+                                unsigned int              cmpPitchInBytes,
+                                const void*               options = NULL)
+{
+    if ((srcBlocks == NULL) || (cmpBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    CMP_BC15Options* BC15options = (CMP_BC15Options*)options;
+    CMP_BC15Options  BC15optionsDefault;
+    if (BC15options == NULL)
+    {
+        BC15options = &BC15optionsDefault;
+        SetDefaultBC15Options(BC15options);
+    }
+
+    if (!g_bc1FunctionPointersSet)
+        bc1ToggleSIMD(EXTENSION_COUNT);
+
+    // The min max encoding of the lowest quality setting is done a batch of blocks at a time, without
+    // punch through alpha or sRGB, which need the per block encoder
+    CGU_BOOL batchMinMax = cpu_bc1CompressBlocksMinMax && (BC15options->m_fquality < CMP_QUALITY0) && !BC15options->m_bUseAlpha &&
+                           !BC15options->m_bIsSRGB;
+
+    CMP_Vec4uc inBlocks[BLOCK_BATCH_SIZE][BLOCK_SIZE_4X4];
+
+    for (CGU_UINT32 blockY = 0; blockY < blocksY; blockY++)
+    {
+        const unsigned char*      srcRow = srcBlocks + (size_t)blockY * BlockY * srcPitchInBytes;
+        CMP_GLOBAL unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+
+        for (CGU_UINT32 blockX = 0; blockX < blocksX; blockX += BLOCK_BATCH_SIZE)
+        {
+            CGU_UINT32 numBlocks = (blocksX - blockX) < BLOCK_BATCH_SIZE ? (blocksX - blockX) : BLOCK_BATCH_SIZE;
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                GetBlockRGBA8888(srcRow + (size_t)(blockX + i) * BlockX * 4, srcPitchInBytes, inBlocks[i]);
+
+            if (batchMinMax)
+            {
+                unsigned int solidBlocks = cpu_bc1CompressBlocksMinMax(&cmpRow[blockX * 8], 8, (const unsigned char*)inBlocks, numBlocks);
+
+                // solid color blocks use the 565 match tables, unless refinement asks for the full search
+                if (BC15options->m_nRefinementSteps < 1)
+                {
+                    for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                    {
+                        if (solidBlocks & (1 << i))
+                        {
+                            CGU_Vec2ui            cmpBlock        = cgu_solidColorBlock(inBlocks[i][0].x, inBlocks[i][0].y, inBlocks[i][0].z);
+                            CMP_GLOBAL CGU_UINT32* compressedBlock = (CMP_GLOBAL CGU_UINT32*)&cmpRow[(blockX + i) * 8];
+                            compressedBlock[0]                     = cmpBlock.x;
+                            compressedBlock[1]                     = cmpBlock.y;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                CompressBlockBC1_Internal(inBlocks[i], (CMP_GLOBAL CGU_UINT32*)&cmpRow[(blockX + i) * 8], BC15options);
+        }
+    }
+
+    return CGU_CORE_OK;
+}
+
 int CMP_CDECL DecompressBlockBC1(const unsigned char cmpBlock[8], CMP_GLOBAL unsigned char srcBlock[64], const void* options = NULL)
 {
     CMP_BC15Options* BC15options = (CMP_BC15Options*)options;
@@ -373,7 +485,7 @@ int CMP_CDECL DecompressBlockBC1(const unsigned char cmpBlock[8], CMP_GLOBAL uns
 
     compBlock.y = (CGU_UINT32)cmpBlock[7] << 24 | (CGU_UINT32)cmpBlock[6] << 16 | (CGU_UINT32)cmpBlock[5] << 8 | (CGU_UINT32)cmpBlock[4];
 
-    cmp_decompressDXTRGBA_Internal(srcBlock, compBlock, BC15options->m_mapDecodeRGBA);
+    cmp_decompressDXTRGBA_Internal(srcBlock, compBlock, BC15options->m_mapDecodeRGBA, TRUE);
 
     return CGU_CORE_OK;
 }
@@ -60,6 +60,10 @@ void CompressBlockBC2_Internal(const CMP_Vec4uc srcBlockTemp[16], CMP_GLOBAL CGU
 //============================================== USER INTERFACES ========================================================
 #ifndef ASPM_GPU
 
+// from bc1_encode_kernel.cpp
+bool CompressColorBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const CMP_Vec4uc* srcBlocks, int numBlocks, unsigned int* solidBlocks);
+bool CompressExplicitAlphaBlocks(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const CMP_Vec4uc* srcBlocks, int numBlocks);
+
 int CMP_CDECL CreateOptionsBC2(void** options)
 {
     CMP_BC15Options* BC15optionsDefault = new CMP_BC15Options;
@@ -157,11 +161,16 @@ void DecompressBC2_Internal(CMP_GLOBAL CGU_UINT8 rgbaBlock[BLOCK_SIZE_4X4X4], co
     compBlock.x = compressedBlock[DXTC_OFFSET_RGB];
     compBlock.y = compressedBlock[DXTC_OFFSET_RGB + 1];
 
-    cmp_decompressDXTRGBA_Internal(rgbaBlock, compBlock, BC15options->m_mapDecodeRGBA);
+    cmp_decompressDXTRGBA_Internal(rgbaBlock, compBlock, BC15options->m_mapDecodeRGBA, FALSE);
 
+    // memcpy keeps the byte block from being accessed through a CGU_UINT32 lvalue
     for (CGU_UINT32 i = 0; i < 16; i++)
-        ((CMP_GLOBAL CGU_UINT32*)rgbaBlock)[i] =
-            (alphaBlock[i] << RGBA8888_OFFSET_A) | (((CMP_GLOBAL CGU_UINT32*)rgbaBlock)[i] & ~(BYTE_MASK << RGBA8888_OFFSET_A));
+    {
+        CGU_UINT32 texel;
+        memcpy(&texel, &rgbaBlock[i * 4], sizeof(texel));
+        texel = (alphaBlock[i] << RGBA8888_OFFSET_A) | (texel & ~(BYTE_MASK << RGBA8888_OFFSET_A));
+        memcpy(&rgbaBlock[i * 4], &texel, sizeof(texel));
+    }
 }
 
 int CMP_CDECL CompressBlockBC2(const unsigned char*     srcBlock,
@@ -200,6 +209,54 @@ int CMP_CDECL CompressBlockBC2(const unsigned char*     srcBlock,
     return CGU_CORE_OK;
 }
 
+int CMP_CDECL CompressBlocksBC2(const unsigned char*      srcBlocks,
+                                unsigned int              srcPitchInBytes,
+                                unsigned int              blocksX,
+                                unsigned int              blocksY,
+                                CMP_GLOBAL unsigned char* cmpBlocks,
+                                unsigned int              cmpPitchInBytes,
+                                const void*               options = NULL)
+{
+    if ((srcBlocks == NULL) || (cmpBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    CMP_BC15Options* BC15options = (CMP_BC15Options*)options;
+    CMP_BC15Options  BC15optionsDefault;
+    if (BC15options == NULL)
+    {
+        BC15options = &BC15optionsDefault;
+        SetDefaultBC15Options(BC15options);
+    }
+
+    // Up to CMP_QUALITY1 the color and explicit alpha blocks are min max encoded, a batch of blocks at a time
+    CGU_BOOL batchMinMax = BC15options->m_fquality <= CMP_QUALITY1;
+
+    CMP_Vec4uc inBlocks[BLOCK_BATCH_SIZE][BLOCK_SIZE_4X4];
+
+    for (CGU_UINT32 blockY = 0; blockY < blocksY; blockY++)
+    {
+        const unsigned char*      srcRow = srcBlocks + (size_t)blockY * BlockY * srcPitchInBytes;
+        CMP_GLOBAL unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+
+        for (CGU_UINT32 blockX = 0; blockX < blocksX; blockX += BLOCK_BATCH_SIZE)
+        {
+            CGU_UINT32 numBlocks = (blocksX - blockX) < BLOCK_BATCH_SIZE ? (blocksX - blockX) : BLOCK_BATCH_SIZE;
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                GetBlockRGBA8888(srcRow + (size_t)(blockX + i) * BlockX * 4, srcPitchInBytes, inBlocks[i]);
+
+            if (batchMinMax && CompressExplicitAlphaBlocks(&cmpRow[blockX * 16], 16, inBlocks[0], numBlocks) &&
+                CompressColorBlocksMinMax(&cmpRow[blockX * 16 + 8], 16, inBlocks[0], numBlocks, NULL))
+                continue;
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                CompressBlockBC2_Internal(inBlocks[i], (CMP_GLOBAL CGU_UINT32*)&cmpRow[(blockX + i) * 16], BC15options);
+        }
+    }
+
+    return CGU_CORE_OK;
+}
+
 int CMP_CDECL DecompressBlockBC2(const unsigned char cmpBlock[16], CMP_GLOBAL unsigned char srcBlock[64], const void* options = NULL)
 {
     CMP_BC15Options* BC15options = (CMP_BC15Options*)options;
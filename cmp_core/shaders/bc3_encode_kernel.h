@@ -25,6 +25,7 @@
 
 #include "common_def.h"
 #include "bcn_common_kernel.h"
+#include "bc4_encode_kernel.h"
 
 #define BC3CompBlockSize 16
 
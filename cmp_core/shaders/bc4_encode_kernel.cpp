@@ -22,6 +22,252 @@
 //=====================================================================
 #include "bc4_encode_kernel.h"
 
+#if !defined(ASPM_GPU)
+#include "cpu_extensions.h"
+#include "core_simd.h"
+
+#define BC4_RAMP_BATCH 64  // candidate ramps evaluated per call to cpu_bc4RampErrors
+
+CMP_STATIC CGU_BOOL g_bc4FunctionPointersSet = false;
+
+// Evaluates many candidate ramps of cmp_getRampError() at once, null when the scalar code is used
+CMP_STATIC void (*cpu_bc4RampErrors)(float*, const float*, const float*, int, const float*, const float*, int) = 0;
+
+// Toggle which SIMD instruction set extensions to use. Setting this to EXTENSION_COUNT will enable auto-detection of supported extensions.
+CMP_STATIC bool bc4ToggleSIMD(CGU_INT newExtension)
+{
+    CGU_BOOL useAVX512 = true;
+    CGU_BOOL useAVX2   = true;
+    CGU_BOOL useSSE4   = true;
+
+    CPUExtensions extensions = GetCPUExtensions();
+
+    if (newExtension < EXTENSION_COUNT)  // user requested a specific instruction set extension
+    {
+        useAVX512 = newExtension == EXTENSION_AVX512_F;
+        useAVX2   = newExtension == EXTENSION_AVX2;
+        useSSE4   = newExtension == EXTENSION_SSE42;
+    }
+
+#ifndef __APPLE__
+    if (useAVX512 && IsAvailableAVX512(extensions))
+        cpu_bc4RampErrors = avx512_bc4RampErrors;
+    else if (useAVX2 && IsAvailableAVX2(extensions))
+        cpu_bc4RampErrors = avx_bc4RampErrors;
+    else if (useSSE4 && IsAvailableSSE4(extensions))
+        cpu_bc4RampErrors = sse_bc4RampErrors;
+    else
+#endif
+        cpu_bc4RampErrors = 0;
+
+    g_bc4FunctionPointersSet = true;
+
+    if (newExtension == EXTENSION_AVX512_F)
+        return IsAvailableAVX512(extensions);
+    if (newExtension == EXTENSION_AVX2)
+        return IsAvailableAVX2(extensions);
+    if (newExtension == EXTENSION_SSE42)
+        return IsAvailableSSE4(extensions);
+
+    return true;
+}
+
+int BC4EnableSSE4()
+{
+    bool result = bc4ToggleSIMD(EXTENSION_SSE42);
+
+    return result ? 0 : 1;
+}
+
+int BC4EnableAVX2()
+{
+    bool result = bc4ToggleSIMD(EXTENSION_AVX2);
+
+    return result ? 0 : 1;
+}
+
+int BC4EnableAVX512()
+{
+    bool result = bc4ToggleSIMD(EXTENSION_AVX512_F);
+
+    return result ? 0 : 1;
+}
+
+void BC4DisableSIMD()
+{
+    bc4ToggleSIMD(EXTENSION_NONE);
+}
+
+// Evaluates the candidate ramps collected so far and keeps the first one with a lower error than bestError,
+// this gives the same result as calling cmp_getRampError() on each ramp in order
+static void cmp_flushRampCandidates(CGU_FLOAT  lows[BC4_RAMP_BATCH],
+                                    CGU_FLOAT  highs[BC4_RAMP_BATCH],
+                                    CGU_INT&   numRamps,
+                                    CGU_FLOAT  values[BLOCK_SIZE_4X4],
+                                    CGU_FLOAT  repeats[BLOCK_SIZE_4X4],
+                                    CGU_INT    numValues,
+                                    CGU_FLOAT& bestError,
+                                    CGU_FLOAT& bestLow,
+                                    CGU_FLOAT& bestHigh)
+{
+    CGU_FLOAT errors[BC4_RAMP_BATCH];
+
+    cpu_bc4RampErrors(errors, lows, highs, numRamps, values, repeats, numValues);
+
+    for (CGU_INT i = 0; i < numRamps; i++)
+    {
+        if (errors[i] < bestError)
+        {
+            bestError = errors[i];
+            bestLow   = lows[i];
+            bestHigh  = highs[i];
+        }
+    }
+
+    numRamps = 0;
+}
+
+// Same as cmp_getLinearEndPoints() for unsigned blocks at quality >= CMP_QUALITY2, with the global
+// search and the refinement steps evaluated in batches by cpu_bc4RampErrors
+static CGU_Vec2f cmp_getLinearEndPointsSIMD(CGU_FLOAT _Blk[BLOCK_SIZE_4X4])
+{
+    CGU_UINT32 i;
+    CGU_Vec2f  cmpMinMax;
+    CGU_FLOAT  Ramp[2];
+
+    Ramp[0] = 0.0f;
+    Ramp[1] = 1.0f;
+
+    CGU_FLOAT afUniqueValues[BLOCK_SIZE_4X4];
+    CGU_FLOAT afValueRepeats[BLOCK_SIZE_4X4];
+    for (i = 0; i < BLOCK_SIZE_4X4; i++)
+        afUniqueValues[i] = afValueRepeats[i] = 0.f;
+
+    CGU_FLOAT fBlk[BLOCK_SIZE_4X4];
+    memcpy(fBlk, _Blk, BLOCK_SIZE_4X4 * sizeof(CGU_FLOAT));
+    qsort((void*)fBlk, (size_t)BLOCK_SIZE_4X4, sizeof(CGU_FLOAT), QSortFCmp);
+
+    CGU_FLOAT  new_p          = -2.0f;
+    CGU_UINT32 dwUniqueValues = 0;
+
+    for (i = 0; i < BLOCK_SIZE_4X4; i++)
+    {
+        if (new_p != fBlk[i])
+        {
+            afUniqueValues[dwUniqueValues] = new_p = fBlk[i];
+            afValueRepeats[dwUniqueValues]         = 1.f;
+            dwUniqueValues++;
+        }
+        else if (dwUniqueValues)
+            afValueRepeats[dwUniqueValues - 1] += 1.f;
+    }
+
+    if (dwUniqueValues <= 2)
+    {
+        Ramp[0] = cmp_floor(afUniqueValues[0] * 255.0f + 0.5f);
+        if (dwUniqueValues == 1)
+            Ramp[1] = Ramp[0] + 1.f;
+        else
+            Ramp[1] = cmp_floor(afUniqueValues[1] * 255.0f + 0.5f);
+    }
+    else
+    {
+        CGU_FLOAT min_ex  = afUniqueValues[0];
+        CGU_FLOAT max_ex  = afUniqueValues[dwUniqueValues - 1];
+        CGU_FLOAT min_bnd = 0, max_bnd = 1.;
+        CGU_FLOAT min_r = min_ex, max_r = max_ex;
+        CGU_FLOAT gbl_l = 0, gbl_r = 0;
+        CGU_FLOAT cntr = (min_r + max_r) / 2;
+
+        CGU_FLOAT gbl_err = MAX_ERROR;
+
+        CGU_FLOAT lows[BC4_RAMP_BATCH];
+        CGU_FLOAT highs[BC4_RAMP_BATCH];
+        CGU_INT   numRamps = 0;
+
+        if (!((max_ex - min_ex) <= (48.f / 256.0f)))
+        {
+            CGU_FLOAT gbl_llb = (min_bnd > min_r - GBL_SCH_EXT) ? min_bnd : min_r - GBL_SCH_EXT;
+            CGU_FLOAT gbl_rrb = (max_bnd < max_r + GBL_SCH_EXT) ? max_bnd : max_r + GBL_SCH_EXT;
+            CGU_FLOAT gbl_lrb = (cntr < min_r + GBL_SCH_EXT) ? cntr : min_r + GBL_SCH_EXT;
+            CGU_FLOAT gbl_rlb = (cntr > max_r - GBL_SCH_EXT) ? cntr : max_r - GBL_SCH_EXT;
+
+            for (CGU_FLOAT step_l = gbl_llb; step_l < gbl_lrb; step_l += GBL_SCH_STEP)
+            {
+                for (CGU_FLOAT step_r = gbl_rrb; gbl_rlb <= step_r; step_r -= GBL_SCH_STEP)
+                {
+                    lows[numRamps]  = step_l;
+                    highs[numRamps] = step_r;
+                    if (++numRamps == BC4_RAMP_BATCH)
+                        cmp_flushRampCandidates(lows, highs, numRamps, afUniqueValues, afValueRepeats, dwUniqueValues, gbl_err, gbl_l, gbl_r);
+                }
+            }
+
+            if (numRamps)
+                cmp_flushRampCandidates(lows, highs, numRamps, afUniqueValues, afValueRepeats, dwUniqueValues, gbl_err, gbl_l, gbl_r);
+
+            min_r = gbl_l;
+            max_r = gbl_r;
+        }
+
+        // cmp_linearBlockRefine(), all moves of a step are tried from the same start point
+        CGU_FLOAT m_step = LCL_SCH_STEP / 256.0f;
+        CGU_BOOL  moved;
+
+        do
+        {
+            CGU_FLOAT cr_min0 = min_r;
+            CGU_FLOAT cr_max0 = max_r;
+            CGU_FLOAT maxerror = gbl_err;
+
+            for (CGU_INT mode = 0; mode < SCH_STPS * SCH_STPS; mode++)
+            {
+                lows[numRamps]  = max(min_r + m_step * sMvF[mode / SCH_STPS], min_bnd);
+                highs[numRamps] = min(max_r + m_step * sMvF[mode % SCH_STPS], max_bnd);
+                numRamps++;
+            }
+
+            cmp_flushRampCandidates(lows, highs, numRamps, afUniqueValues, afValueRepeats, dwUniqueValues, gbl_err, cr_min0, cr_max0);
+
+            moved = gbl_err < maxerror;
+            min_r = cr_min0;
+            max_r = cr_max0;
+        } while (moved);
+
+        min_ex = min_r * 255.0f;
+        max_ex = max_r * 255.0f;
+
+        Ramp[0] = cmp_floor(min_ex + 0.5f);
+        Ramp[1] = cmp_floor(max_ex + 0.5f);
+    }
+
+    // Ensure that the two endpoints are not the same
+    if (Ramp[0] == Ramp[1])
+    {
+        if (Ramp[1] < 255.f)
+            Ramp[1] = Ramp[1] + 1.0f;
+        else if (Ramp[1] > 0.0f)
+            Ramp[1] = Ramp[1] - 1.0f;
+    }
+
+    cmpMinMax.x = Ramp[0];
+    cmpMinMax.y = Ramp[1];
+
+    return cmpMinMax;
+}
+
+CGU_Vec2ui CompressAlphaBlockBC4(CGU_FLOAT alphaBlock[BLOCK_SIZE_4X4], CGU_FLOAT fquality, CGU_BOOL isSigned)
+{
+    if (!g_bc4FunctionPointersSet)
+        bc4ToggleSIMD(EXTENSION_COUNT);
+
+    if (cpu_bc4RampErrors && !isSigned && fquality >= CMP_QUALITY2)
+        return cmp_getBlockPackedIndices(cmp_getLinearEndPointsSIMD(alphaBlock), alphaBlock, fquality);
+
+    return cmp_compressAlphaBlock(alphaBlock, fquality, isSigned);
+}
+#endif
+
 //============================================== BC4 INTERFACES =======================================================
 // Processing UINT to either SNORM or UNORM
 void CompressBlockBC4_Internal(const CMP_Vec4uc srcBlockTemp[16], CMP_GLOBAL CGU_UINT32 compressedBlock[2], CMP_GLOBAL const CMP_BC15Options* BC15options)
@@ -75,7 +321,11 @@ void CompressBlockBC4_Internal(const CMP_Vec4uc srcBlockTemp[16], CMP_GLOBAL CGU
         }
     }
 
+#ifndef ASPM_GPU
+    cmpBlock = CompressAlphaBlockBC4(alphaBlock, BC15options->m_fquality, BC15options->m_bIsSNORM);
+#else
     cmpBlock = cmp_compressAlphaBlock(alphaBlock, BC15options->m_fquality, BC15options->m_bIsSNORM);
+#endif
 
     compressedBlock[0] = cmpBlock.x;
     compressedBlock[1] = cmpBlock.y;
@@ -117,7 +367,11 @@ void CompressBlockBC4_SingleChannel(const CGU_UINT8                   srcBlockTe
         alphaBlock[i] = (CGU_FLOAT)(srcBlockTemp[i]) / 255.0f;
 
     CGU_Vec2ui cmpBlock;
-    cmpBlock           = cmp_compressAlphaBlock(alphaBlock, BC15options->m_fquality, FALSE);
+#ifndef ASPM_GPU
+    cmpBlock = CompressAlphaBlockBC4(alphaBlock, BC15options->m_fquality, FALSE);
+#else
+    cmpBlock = cmp_compressAlphaBlock(alphaBlock, BC15options->m_fquality, FALSE);
+#endif
     compressedBlock[0] = cmpBlock.x;
     compressedBlock[1] = cmpBlock.y;
 }
@@ -271,6 +525,47 @@ int CMP_CDECL CompressBlockBC4(const unsigned char* srcBlock, unsigned int srcSt
     return CGU_CORE_OK;
 }
 
+int CMP_CDECL CompressBlocksBC4(const unsigned char*      srcBlocks,
+                                unsigned int              srcPitchInBytes,
+                                unsigned int              blocksX,
+                                unsigned int              blocksY,
+                                CMP_GLOBAL unsigned char* cmpBlocks,
+                                unsigned int              cmpPitchInBytes,
+                                const void*               options = NULL)
+{
+    if ((srcBlocks == NULL) || (cmpBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    CMP_BC15Options* BC15options = (CMP_BC15Options*)options;
+    CMP_BC15Options  BC15optionsDefault;
+    if (BC15options == NULL)
+    {
+        BC15options = &BC15optionsDefault;
+        SetDefaultBC15Options(BC15options);
+    }
+
+    CGU_UINT8 inBlocks[BLOCK_BATCH_SIZE][BLOCK_SIZE_4X4];
+
+    for (CGU_UINT32 blockY = 0; blockY < blocksY; blockY++)
+    {
+        const unsigned char*      srcRow = srcBlocks + (size_t)blockY * BlockY * srcPitchInBytes;
+        CMP_GLOBAL unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+
+        for (CGU_UINT32 blockX = 0; blockX < blocksX; blockX += BLOCK_BATCH_SIZE)
+        {
+            CGU_UINT32 numBlocks = (blocksX - blockX) < BLOCK_BATCH_SIZE ? (blocksX - blockX) : BLOCK_BATCH_SIZE;
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                GetBlockR8(srcRow + (size_t)(blockX + i) * BlockX, srcPitchInBytes, inBlocks[i]);
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                CompressBlockBC4_SingleChannel(inBlocks[i], (CMP_GLOBAL CGU_UINT32*)&cmpRow[(blockX + i) * 8], BC15options);
+        }
+    }
+
+    return CGU_CORE_OK;
+}
+
 int CMP_CDECL DecompressBlockBC4(const unsigned char cmpBlock[8], CMP_GLOBAL unsigned char srcBlock[16], const void* options = NULL)
 {
     CMP_BC15Options* BC15options = (CMP_BC15Options*)options;
@@ -28,4 +28,15 @@
 
 #define BC4CompBlockSize 8
 
+#ifndef ASPM_GPU
+int BC4EnableSSE4();
+int BC4EnableAVX2();
+int BC4EnableAVX512();
+
+void BC4DisableSIMD();
+
+// cmp_compressAlphaBlock() with the SIMD endpoint search of the BC4 and BC5 encoders
+CGU_Vec2ui CompressAlphaBlockBC4(CGU_FLOAT alphaBlock[BLOCK_SIZE_4X4], CGU_FLOAT fquality, CGU_BOOL isSigned);
+#endif
+
 #endif
\ No newline at end of file
@@ -30,11 +30,19 @@ CGU_Vec4ui CompressBC5Block_Internal(CMP_IN CGU_FLOAT aBlockU[16], CMP_IN CGU_FL
     CGU_Vec4ui compBlock;
     CGU_Vec2ui cmpBlock;
 
-    cmpBlock    = cmp_compressAlphaBlock(aBlockU, fquality, isSNorm);
+#ifndef ASPM_GPU
+    cmpBlock = CompressAlphaBlockBC4(aBlockU, fquality, isSNorm);
+#else
+    cmpBlock = cmp_compressAlphaBlock(aBlockU, fquality, isSNorm);
+#endif
     compBlock.x = cmpBlock.x;
     compBlock.y = cmpBlock.y;
 
-    cmpBlock    = cmp_compressAlphaBlock(aBlockV, fquality, isSNorm);
+#ifndef ASPM_GPU
+    cmpBlock = CompressAlphaBlockBC4(aBlockV, fquality, isSNorm);
+#else
+    cmpBlock = cmp_compressAlphaBlock(aBlockV, fquality, isSNorm);
+#endif
     compBlock.z = cmpBlock.x;
     compBlock.w = cmpBlock.y;
     return compBlock;
@@ -163,11 +171,19 @@ void CompressBlockBC5_DualChannel_Internal(const CGU_UINT8                   src
         srcAlphaGF[i] = (CGU_FLOAT)(srcBlockG[i]) / 255.0f;
     }
 
-    cmpBlock           = cmp_compressAlphaBlock(srcAlphaRF, BC15options->m_fquality, FALSE);
+#ifndef ASPM_GPU
+    cmpBlock = CompressAlphaBlockBC4(srcAlphaRF, BC15options->m_fquality, FALSE);
+#else
+    cmpBlock = cmp_compressAlphaBlock(srcAlphaRF, BC15options->m_fquality, FALSE);
+#endif
     compressedBlock[0] = cmpBlock.x;
     compressedBlock[1] = cmpBlock.y;
 
-    cmpBlock           = cmp_compressAlphaBlock(srcAlphaGF, BC15options->m_fquality, FALSE);
+#ifndef ASPM_GPU
+    cmpBlock = CompressAlphaBlockBC4(srcAlphaGF, BC15options->m_fquality, FALSE);
+#else
+    cmpBlock = cmp_compressAlphaBlock(srcAlphaGF, BC15options->m_fquality, FALSE);
+#endif
     compressedBlock[2] = cmpBlock.x;
     compressedBlock[3] = cmpBlock.y;
 }
@@ -316,6 +332,54 @@ int CMP_CDECL CompressBlockBC5(const CGU_UINT8*     srcBlockR,
     return CGU_CORE_OK;
 }
 
+int CMP_CDECL CompressBlocksBC5(const CGU_UINT8*      srcBlocksR,
+                                unsigned int          srcPitchInBytes1,
+                                const CGU_UINT8*      srcBlocksG,
+                                unsigned int          srcPitchInBytes2,
+                                unsigned int          blocksX,
+                                unsigned int          blocksY,
+                                CMP_GLOBAL CGU_UINT8* cmpBlocks,
+                                unsigned int          cmpPitchInBytes,
+                                const void*           options = NULL)
+{
+    if ((srcBlocksR == NULL) || (srcBlocksG == NULL) || (cmpBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    CMP_BC15Options* BC15options = (CMP_BC15Options*)options;
+    CMP_BC15Options  BC15optionsDefault;
+    if (BC15options == NULL)
+    {
+        BC15options = &BC15optionsDefault;
+        SetDefaultBC15Options(BC15options);
+    }
+
+    CGU_UINT8 inBlocksR[BLOCK_BATCH_SIZE][BLOCK_SIZE_4X4];
+    CGU_UINT8 inBlocksG[BLOCK_BATCH_SIZE][BLOCK_SIZE_4X4];
+
+    for (CGU_UINT32 blockY = 0; blockY < blocksY; blockY++)
+    {
+        const CGU_UINT8*      srcRowR = srcBlocksR + (size_t)blockY * BlockY * srcPitchInBytes1;
+        const CGU_UINT8*      srcRowG = srcBlocksG + (size_t)blockY * BlockY * srcPitchInBytes2;
+        CMP_GLOBAL CGU_UINT8* cmpRow  = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+
+        for (CGU_UINT32 blockX = 0; blockX < blocksX; blockX += BLOCK_BATCH_SIZE)
+        {
+            CGU_UINT32 numBlocks = (blocksX - blockX) < BLOCK_BATCH_SIZE ? (blocksX - blockX) : BLOCK_BATCH_SIZE;
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+            {
+                GetBlockR8(srcRowR + (size_t)(blockX + i) * BlockX, srcPitchInBytes1, inBlocksR[i]);
+                GetBlockR8(srcRowG + (size_t)(blockX + i) * BlockX, srcPitchInBytes2, inBlocksG[i]);
+            }
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                CompressBlockBC5_DualChannel_Internal(inBlocksR[i], inBlocksG[i], (CMP_GLOBAL CGU_UINT32*)&cmpRow[(blockX + i) * 16], BC15options);
+        }
+    }
+
+    return CGU_CORE_OK;
+}
+
 int CMP_CDECL DecompressBlockBC5(const CGU_UINT8      cmpBlock[16],
                                  CMP_GLOBAL CGU_UINT8 srcBlockR[16],
                                  CMP_GLOBAL CGU_UINT8 srcBlockG[16],
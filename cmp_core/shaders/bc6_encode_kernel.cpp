@@ -66,6 +66,81 @@ void swap(CGU_INT A, CGU_INT B)
 
 #endif
 
+#if !defined(ASPM_GPU)
+#include "cpu_extensions.h"
+#include "core_simd.h"
+
+CMP_STATIC CGU_BOOL g_bc6FunctionPointersSet = false;
+
+// SIMD version of ep_cube_shake_d, null when the scalar code is used
+CMP_STATIC float (*cpu_bc6ShakeEndpointCube)(int*, float*, int*, const float*, int, const float*, int, const float*, int) = 0;
+
+// Toggle which SIMD instruction set extensions to use. Setting this to EXTENSION_COUNT will enable auto-detection of supported extensions.
+CMP_STATIC bool bc6ToggleSIMD(CGU_INT newExtension)
+{
+    CGU_BOOL useAVX512 = true;
+    CGU_BOOL useAVX2   = true;
+    CGU_BOOL useSSE4   = true;
+
+    CPUExtensions extensions = GetCPUExtensions();
+
+    if (newExtension < EXTENSION_COUNT)  // user requested a specific instruction set extension
+    {
+        useAVX512 = newExtension == EXTENSION_AVX512_F;
+        useAVX2   = newExtension == EXTENSION_AVX2;
+        useSSE4   = newExtension == EXTENSION_SSE42;
+    }
+
+#ifndef __APPLE__
+    if (useAVX512 && IsAvailableAVX512(extensions))
+        cpu_bc6ShakeEndpointCube = avx512_bc6ShakeEndpointCube;
+    else if (useAVX2 && IsAvailableAVX2(extensions))
+        cpu_bc6ShakeEndpointCube = avx_bc6ShakeEndpointCube;
+    else if (useSSE4 && IsAvailableSSE4(extensions))
+        cpu_bc6ShakeEndpointCube = sse_bc6ShakeEndpointCube;
+    else
+#endif
+        cpu_bc6ShakeEndpointCube = 0;
+
+    g_bc6FunctionPointersSet = true;
+
+    if (newExtension == EXTENSION_AVX512_F)
+        return IsAvailableAVX512(extensions);
+    if (newExtension == EXTENSION_AVX2)
+        return IsAvailableAVX2(extensions);
+    if (newExtension == EXTENSION_SSE42)
+        return IsAvailableSSE4(extensions);
+
+    return true;
+}
+
+int BC6EnableSSE4()
+{
+    bool result = bc6ToggleSIMD(EXTENSION_SSE42);
+
+    return result ? 0 : 1;
+}
+
+int BC6EnableAVX2()
+{
+    bool result = bc6ToggleSIMD(EXTENSION_AVX2);
+
+    return result ? 0 : 1;
+}
+
+int BC6EnableAVX512()
+{
+    bool result = bc6ToggleSIMD(EXTENSION_AVX512_F);
+
+    return result ? 0 : 1;
+}
+
+void BC6DisableSIMD()
+{
+    bc6ToggleSIMD(EXTENSION_NONE);
+}
+#endif
+
 __constant CGU_UINT8 BC6_PARTITIONS[MAX_BC6H_PARTITIONS][MAX_SUBSET_SIZE] = {
     {// 0
      0,
@@ -910,47 +985,61 @@ typedef struct
     int       i;
 } a;
 
-inline CGU_INT a_compare(const void* arg1, const void* arg2)
+// Sorts v[0..n-1] by d, equal d values keep their order of i (same result as a stable sort when i is
+// the original position). Uses a Batcher odd-even merge sorting network over the next power of two
+// of n, so the sequence of compare-exchanges only depends on n. Entries past n are padded with the
+// largest key and a larger i so they sort last, v needs room for them (at most MAX_ENTRIES).
+void sortNetwork_d(a v[MAX_ENTRIES], CGU_INT n)
 {
-    if (((a*)arg1)->d - ((a*)arg2)->d > 0)
-        return 1;
-    if (((a*)arg1)->d - ((a*)arg2)->d < 0)
-        return -1;
-    return 0;
-};
+    CGU_INT   size = 1;
+    CGU_INT   i, j, k, p;
+    CGU_FLOAT dmax = v[0].d;
 
-void sortProjection(CGU_FLOAT projection[MAX_ENTRIES], CGU_INT order[MAX_ENTRIES], CGU_INT numEntries)
-{
-    int i;
-    a   what[MAX_ENTRIES + MAX_PARTITIONS_TABLE];
+    while (size < n)
+        size <<= 1;
 
-    for (i = 0; i < numEntries; i++)
-        what[what[i].i = i].d = projection[i];
+    for (i = 1; i < n; i++)
+        dmax = dmax > v[i].d ? dmax : v[i].d;
 
-#ifdef USE_QSORT
-    qsort((void*)&what, numEntries, sizeof(a), a_compare);
-#else
+    for (i = n; i < size; i++)
     {
-        int       j;
-        int       tmp;
-        CGU_FLOAT tmp_d;
-        for (i = 1; i < numEntries; i++)
+        v[i].d = dmax;
+        v[i].i = MAX_ENTRIES + i;
+    }
+
+    for (p = 1; p < size; p <<= 1)
+    {
+        for (k = p; k >= 1; k >>= 1)
         {
-            for (j = i; j > 0; j--)
+            for (j = k % p; j + k < size; j += 2 * k)
             {
-                if (what[j - 1].d > what[j].d)
+                for (i = 0; i < k; i++)
                 {
-                    tmp           = what[j].i;
-                    tmp_d         = what[j].d;
-                    what[j].i     = what[j - 1].i;
-                    what[j].d     = what[j - 1].d;
-                    what[j - 1].i = tmp;
-                    what[j - 1].d = tmp_d;
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                    {
+                        a lo = v[i + j];
+                        a hi = v[i + j + k];
+                        if (lo.d > hi.d || (lo.d == hi.d && lo.i > hi.i))
+                        {
+                            v[i + j]     = hi;
+                            v[i + j + k] = lo;
+                        }
+                    }
                 }
             }
         }
     }
-#endif
+}
+
+void sortProjection(CGU_FLOAT projection[MAX_ENTRIES], CGU_INT order[MAX_ENTRIES], CGU_INT numEntries)
+{
+    int i;
+    a   what[MAX_ENTRIES + MAX_PARTITIONS_TABLE];
+
+    for (i = 0; i < numEntries; i++)
+        what[what[i].i = i].d = projection[i];
+
+    sortNetwork_d(what, numEntries);
 
     for (i = 0; i < numEntries; i++)
         order[i] = what[i].i;
@@ -1024,30 +1113,8 @@ void quant_AnD_Shell(CGU_FLOAT* v_, CGU_INT k, CGU_INT n, CGU_INT idx[MAX_ENTRIE
         for (i = 0; i < n; i++)
             d[i].d -= dm;
 
-            //!!! Need an OpenCL version of qsort
-#ifdef USE_QSORT
-        qsort((void*)&d, n, sizeof(a), a_compare);
-#else
-        {
-            CGU_INT   tmp;
-            CGU_FLOAT tmp_d;
-            for (i = 1; i < n; i++)
-            {
-                for (j = i; j > 0; j--)
-                {
-                    if (d[j - 1].d > d[j].d)
-                    {
-                        tmp        = d[j].i;
-                        tmp_d      = d[j].d;
-                        d[j].i     = d[j - 1].i;
-                        d[j].d     = d[j - 1].d;
-                        d[j - 1].i = tmp;
-                        d[j - 1].d = tmp_d;
-                    }
-                }
-            }
-        }
-#endif
+        sortNetwork_d(d, n);
+
         // got into fundamental simplex
         // move coordinate system origin to its center
         for (i = 0; i < n; i++)
@@ -1762,6 +1829,120 @@ CGU_FLOAT quant_single_point_d(CGU_FLOAT data[MAX_ENTRIES][MAX_DIMENSION_BIG],
 
 //========================================================================================================================
 
+// Tries all 64 corners of the endpoint cube epd (each channel's two endpoints either at the ideal
+// position or moved up by the rounding range), returns the lowest ramp error with its indices, ramp
+// values and the corner bits in s1_out
+CGU_FLOAT ep_cube_shake_d(CGU_FLOAT data[MAX_ENTRIES][MAX_DIMENSION_BIG],
+                          CGU_INT   numEntries,
+                          CGU_INT   clogs,
+                          CGU_FLOAT epd[2][MAX_DIMENSION_BIG][2],
+                          CGU_INT   idx_1[MAX_ENTRIES],
+                          CGU_FLOAT out_1[MAX_ENTRIES][MAX_DIMENSION_BIG],
+                          CGU_INT*  s1_out,
+                          CGU_INT   channels3or4)
+{
+    CGU_INT   i, j, k;
+    CGU_FLOAT err_1 = CMP_FLOAT_MAX;
+    CGU_INT   s1    = 0;
+
+    CGU_FLOAT ce[MAX_ENTRIES][MAX_CLUSTERS_BIG][MAX_DIMENSION_BIG];
+    CGU_FLOAT err_0 = 0;
+    CGU_FLOAT out_0[MAX_ENTRIES][MAX_DIMENSION_BIG];
+    CGU_INT   idx_0[MAX_ENTRIES];
+
+    for (i = 0; i < numEntries; i++)
+    {
+        CGU_FLOAT d[4];
+        d[0] = data[i][0];
+        d[1] = data[i][1];
+        d[2] = data[i][2];
+        d[3] = data[i][3];
+        for (j = 0; j < (1 << clogs); j++)
+            for (k = 0; k < channels3or4; k++)
+            {
+                ce[i][j][k] = (rampf(CLT(clogs), epd[0][k][0], epd[1][k][0], j) - d[k]) * (rampf(CLT(clogs), epd[0][k][0], epd[1][k][0], j) - d[k]);
+            }
+    }
+
+    CGU_INT s   = 0, p1, g;
+    CGU_INT ei0 = 0, ei1 = 0;
+
+    for (p1 = 0; p1 < 64; p1++)
+    {
+        CGU_INT j0 = 0;
+
+        // Gray code increment
+        g = p1 & (-p1);
+
+        err_0 = 0;
+
+        for (j = 0; j < channels3or4; j++)
+        {
+            if (((g >> (2 * j)) & 0x3) != 0)
+            {
+                j0 = j;
+                // new cords
+                ei0 = (((s ^ g) >> (2 * j)) & 0x1);
+                ei1 = (((s ^ g) >> (2 * j + 1)) & 0x1);
+            }
+        }
+        s     = s ^ g;
+        err_0 = 0;
+
+        for (i = 0; i < numEntries; i++)
+        {
+            CGU_FLOAT d[4];
+            d[0]           = data[i][0];
+            d[1]           = data[i][1];
+            d[2]           = data[i][2];
+            d[3]           = data[i][3];
+            CGU_INT   ci   = 0;
+            CGU_FLOAT cmin = CMP_FLOAT_MAX;
+
+            for (j = 0; j < (1 << clogs); j++)
+            {
+                float t_     = 0.;
+                ce[i][j][j0] = (rampf(CLT(clogs), epd[0][j0][ei0], epd[1][j0][ei1], j) - d[j0]) *
+                               (rampf(CLT(clogs), epd[0][j0][ei0], epd[1][j0][ei1], j) - d[j0]);
+                for (k = 0; k < channels3or4; k++)
+                {
+                    t_ += ce[i][j][k];
+                }
+
+                if (t_ < cmin)
+                {
+                    cmin = t_;
+                    ci   = j;
+                }
+            }
+
+            idx_0[i] = ci;
+            for (k = 0; k < channels3or4; k++)
+            {
+                out_0[i][k] = rampf(CLT(clogs), epd[0][k][ei0], epd[1][k][ei1], ci);
+            }
+            err_0 += cmin;
+        }
+
+        if (err_0 < err_1)
+        {
+            // best in the curent ep cube run
+            for (i = 0; i < numEntries; i++)
+            {
+                idx_1[i] = idx_0[i];
+                for (j = 0; j < channels3or4; j++)
+                    out_1[i][j] = out_0[i][j];
+            }
+            err_1 = err_0;
+
+            s1 = s;  // epo coding
+        }
+    }
+
+    *s1_out = s1;
+    return err_1;
+}
+
 CGU_FLOAT ep_shaker_HD(CGU_FLOAT data[MAX_ENTRIES][MAX_DIMENSION_BIG],
                        CGU_INT   numEntries,
                        CGU_INT   index_[MAX_ENTRIES],
@@ -1806,6 +1987,11 @@ CGU_FLOAT ep_shaker_HD(CGU_FLOAT data[MAX_ENTRIES][MAX_DIMENSION_BIG],
     for (j = 0; j < channels3or4; j++)
         max_bits[j] = (bits[0] + 2 * channels3or4 - 1) / (2 * channels3or4);
 
+#if !defined(ASPM_GPU)
+    if (!g_bc6FunctionPointersSet)
+        bc6ToggleSIMD(EXTENSION_COUNT);
+#endif
+
     // handled below automatically
     CGU_INT alls = all_same_d(data, numEntries, channels3or4);
 
@@ -1948,107 +2134,21 @@ CGU_FLOAT ep_shaker_HD(CGU_FLOAT data[MAX_ENTRIES][MAX_DIMENSION_BIG],
                     }
                 }
 
-                CGU_FLOAT ce[MAX_ENTRIES][MAX_CLUSTERS_BIG][MAX_DIMENSION_BIG];
-                CGU_FLOAT err_0 = 0;
-                CGU_FLOAT out_0[MAX_ENTRIES][MAX_DIMENSION_BIG];
-                CGU_INT   idx_0[MAX_ENTRIES];
-
-                for (i = 0; i < numEntries; i++)
-                {
-                    CGU_FLOAT d[4];
-                    d[0] = data[i][0];
-                    d[1] = data[i][1];
-                    d[2] = data[i][2];
-                    d[3] = data[i][3];
-                    for (j = 0; j < (1 << clogs); j++)
-                        for (k = 0; k < channels3or4; k++)
-                        {
-                            ce[i][j][k] = (rampf(CLT(clogs), epd[0][k][0], epd[1][k][0], j) - d[k]) * (rampf(CLT(clogs), epd[0][k][0], epd[1][k][0], j) - d[k]);
-                        }
-                }
-
-                CGU_INT s   = 0, p1, g;
-                CGU_INT ei0 = 0, ei1 = 0;
-
-                for (p1 = 0; p1 < 64; p1++)
-                {
-                    CGU_INT j0 = 0;
-
-                    // Gray code increment
-                    g = p1 & (-p1);
-
-                    err_0 = 0;
-
-                    for (j = 0; j < channels3or4; j++)
-                    {
-                        if (((g >> (2 * j)) & 0x3) != 0)
-                        {
-                            j0 = j;
-                            // new cords
-                            ei0 = (((s ^ g) >> (2 * j)) & 0x1);
-                            ei1 = (((s ^ g) >> (2 * j + 1)) & 0x1);
-                        }
-                    }
-                    s     = s ^ g;
-                    err_0 = 0;
-
-                    for (i = 0; i < numEntries; i++)
-                    {
-                        CGU_FLOAT d[4];
-                        d[0]           = data[i][0];
-                        d[1]           = data[i][1];
-                        d[2]           = data[i][2];
-                        d[3]           = data[i][3];
-                        CGU_INT   ci   = 0;
-                        CGU_FLOAT cmin = CMP_FLOAT_MAX;
-
-                        for (j = 0; j < (1 << clogs); j++)
-                        {
-                            float t_     = 0.;
-                            ce[i][j][j0] = (rampf(CLT(clogs), epd[0][j0][ei0], epd[1][j0][ei1], j) - d[j0]) *
-                                           (rampf(CLT(clogs), epd[0][j0][ei0], epd[1][j0][ei1], j) - d[j0]);
-                            for (k = 0; k < channels3or4; k++)
-                            {
-                                t_ += ce[i][j][k];
-                            }
-
-                            if (t_ < cmin)
-                            {
-                                cmin = t_;
-                                ci   = j;
-                            }
-                        }
-
-                        idx_0[i] = ci;
-                        for (k = 0; k < channels3or4; k++)
-                        {
-                            out_0[i][k] = rampf(CLT(clogs), epd[0][k][ei0], epd[1][k][ei1], ci);
-                        }
-                        err_0 += cmin;
-                    }
-
-                    if (err_0 < err_1)
-                    {
-                        // best in the curent ep cube run
-                        for (i = 0; i < numEntries; i++)
-                        {
-                            idx_1[i] = idx_0[i];
-                            for (j = 0; j < channels3or4; j++)
-                                out_1[i][j] = out_0[i][j];
-                        }
-                        err_1 = err_0;
-
-                        s1 = s;  // epo coding
-                    }
-                }
+#if !defined(ASPM_GPU)
+                if (cpu_bc6ShakeEndpointCube)
+                    err_1 = cpu_bc6ShakeEndpointCube(
+                        idx_1, &out_1[0][0], &s1, &data[0][0], numEntries, rampLerpWeightsBC6[clogs], 1 << clogs, &epd[0][0][0], channels3or4);
+                else
+#endif
+                    err_1 = ep_cube_shake_d(data, numEntries, clogs, epd, idx_1, out_1, &s1, channels3or4);
 
                 // reconstruct epo
                 for (j = 0; j < channels3or4; j++)
                 {
                     {
                         // new cords
-                        ei0         = ((s1 >> (2 * j)) & 0x1);
-                        ei1         = ((s1 >> (2 * j + 1)) & 0x1);
+                        CGU_INT ei0 = ((s1 >> (2 * j)) & 0x1);
+                        CGU_INT ei1 = ((s1 >> (2 * j + 1)) & 0x1);
                         epo_1[0][j] = (int)epd[0][j][ei0];
                         epo_1[1][j] = (int)epd[1][j][ei1];
                     }
@@ -4410,6 +4510,65 @@ int CMP_CDECL CompressBlockBC6(const CGU_UINT16*      srcBlock,
     return CGU_CORE_OK;
 }
 
+int CMP_CDECL CompressBlocksBC6(const CGU_UINT16*      srcBlocks,
+                                unsigned int           srcPitchInShorts,
+                                unsigned int           blocksX,
+                                unsigned int           blocksY,
+                                CMP_GLOBAL CGU_UINT8*  cmpBlocks,
+                                unsigned int           cmpPitchInBytes,
+                                const CMP_GLOBAL void* options = NULL)
+{
+    if ((srcBlocks == NULL) || (cmpBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    BC6H_Encode* BC6HEncode = (BC6H_Encode*)options;
+    BC6H_Encode  BC6HEncodeDefault;
+
+    if (BC6HEncode == NULL)
+    {
+        BC6HEncode = &BC6HEncodeDefault;
+        SetDefaultBC6Options(BC6HEncode);
+    }
+
+    CGU_UINT16        inBlocks[BLOCK_BATCH_SIZE][BLOCK_SIZE_4X4 * 3];
+    BC6H_Encode_local BC6HEncode_local;
+
+    for (CGU_UINT32 blockY = 0; blockY < blocksY; blockY++)
+    {
+        const CGU_UINT16*     srcRow = srcBlocks + (size_t)blockY * BlockY * srcPitchInShorts;
+        CMP_GLOBAL CGU_UINT8* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+
+        for (CGU_UINT32 blockX = 0; blockX < blocksX; blockX += BLOCK_BATCH_SIZE)
+        {
+            CGU_UINT32 numBlocks = (blocksX - blockX) < BLOCK_BATCH_SIZE ? (blocksX - blockX) : BLOCK_BATCH_SIZE;
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+            {
+                const CGU_UINT16* srcBlock = srcRow + (size_t)(blockX + i) * BlockX * 3;
+                for (CGU_UINT8 row = 0; row < 4; row++)
+                    memcpy(&inBlocks[i][row * 12], &srcBlock[row * srcPitchInShorts], 12 * sizeof(CGU_UINT16));
+            }
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+            {
+                memset((CGU_UINT8*)&BC6HEncode_local, 0, sizeof(BC6H_Encode_local));
+                CGU_UINT8 blkindex = 0;
+                for (CGU_INT32 j = 0; j < 16; j++)
+                {
+                    BC6HEncode_local.din[j][0] = inBlocks[i][blkindex++];  // R
+                    BC6HEncode_local.din[j][1] = inBlocks[i][blkindex++];  // G
+                    BC6HEncode_local.din[j][2] = inBlocks[i][blkindex++];  // B
+                    BC6HEncode_local.din[j][3] = 0;                        // A
+                }
+
+                CompressBlockBC6_Internal(&cmpRow[(blockX + i) * 16], 0, &BC6HEncode_local, BC6HEncode);
+            }
+        }
+    }
+
+    return CGU_CORE_OK;
+}
+
 int CMP_CDECL DecompressBlockBC6(const unsigned char cmpBlock[16], CGU_UINT16 srcBlock[48], const void* options = NULL)
 {
     BC6H_Encode* BC6HEncode = (BC6H_Encode*)options;
@@ -4425,6 +4584,52 @@ int CMP_CDECL DecompressBlockBC6(const unsigned char cmpBlock[16], CGU_UINT16 sr
     return CGU_CORE_OK;
 }
 
+// Decodes to RGBA half floats with alpha set to 1.0
+int CMP_CDECL DecompressBlocksBC6(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  CGU_UINT16*          dstBlocks,
+                                  unsigned int         dstPitchInShorts,
+                                  const void*          options = NULL)
+{
+    if ((cmpBlocks == NULL) || (dstBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    BC6H_Encode* BC6HEncode = (BC6H_Encode*)options;
+    BC6H_Encode  BC6HEncodeDefault;
+
+    if (BC6HEncode == NULL)
+    {
+        BC6HEncode = &BC6HEncodeDefault;
+        SetDefaultBC6Options(BC6HEncode);
+    }
+
+    CGU_UINT16 outBlock[BLOCK_SIZE_4X4 * 3];
+
+    for (CGU_UINT32 blockY = 0; blockY < blocksY; blockY++)
+    {
+        const unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+        CGU_UINT16*          dstRow = dstBlocks + (size_t)blockY * 4 * dstPitchInShorts;
+
+        for (CGU_UINT32 blockX = 0; blockX < blocksX; blockX++)
+        {
+            DecompressBC6_Internal(outBlock, cmpRow + (size_t)blockX * 16, BC6HEncode);
+
+            for (CGU_UINT32 i = 0; i < BLOCK_SIZE_4X4; i++)
+            {
+                CGU_UINT16* dstPixel = dstRow + (size_t)(i / 4) * dstPitchInShorts + (blockX * 4 + i % 4) * 4;
+                dstPixel[0]          = outBlock[i * 3 + 0];
+                dstPixel[1]          = outBlock[i * 3 + 1];
+                dstPixel[2]          = outBlock[i * 3 + 2];
+                dstPixel[3]          = 0x3C00;  // half 1.0
+            }
+        }
+    }
+
+    return CGU_CORE_OK;
+}
+
 #endif  // !ASPM
 #endif  // !ASPM_GPU
 
@@ -398,6 +398,12 @@ struct AMD_BC6H_Format
     bool  optimized;  // were end points optimized during final encoding
 };
 
+int BC6EnableSSE4();
+int BC6EnableAVX2();
+int BC6EnableAVX512();
+
+void BC6DisableSIMD();
+
 // ===================================  END OF DECODER CODE ========================================================
 #endif
 
@@ -59,6 +59,69 @@
 
 #include "bc7_common_encoder.h"
 
+#if !defined(ASPM_GPU)
+#include "cpu_extensions.h"
+#include "core_simd.h"
+
+CMP_STATIC CGU_BOOL g_bc7FunctionPointersSet = false;
+
+// Multi-lane version of the partition scan in Compress_mode01237, null when the scalar loop is used
+CMP_STATIC void (*cpu_bc7QuantizePartitions)(float*, unsigned char*, const float*, const unsigned int*, int, int, int, int) = 0;
+
+// Toggle which SIMD instruction set extensions to use. Setting this to EXTENSION_COUNT will enable auto-detection of supported extensions.
+// NOTE: Only AVX2 and AVX-512 variants exist, any other extension or an unsupported CPU selects the scalar code.
+CMP_STATIC bool bc7ToggleSIMD(CGU_INT newExtension)
+{
+    CGU_BOOL useAVX512 = true;
+    CGU_BOOL useAVX2   = true;
+
+    CPUExtensions extensions = GetCPUExtensions();
+
+    if (newExtension < EXTENSION_COUNT)  // user requested a specific instruction set extension
+    {
+        useAVX512 = newExtension == EXTENSION_AVX512_F;
+        useAVX2   = newExtension == EXTENSION_AVX2;
+    }
+
+#ifndef __APPLE__
+    if (useAVX512 && IsAvailableAVX512(extensions))
+        cpu_bc7QuantizePartitions = avx512_bc7QuantizePartitions;
+    else if (useAVX2 && IsAvailableAVX2(extensions))
+        cpu_bc7QuantizePartitions = avx_bc7QuantizePartitions;
+    else
+#endif
+        cpu_bc7QuantizePartitions = 0;
+
+    g_bc7FunctionPointersSet = true;
+
+    if (newExtension == EXTENSION_AVX512_F)
+        return IsAvailableAVX512(extensions);
+    if (newExtension == EXTENSION_AVX2)
+        return IsAvailableAVX2(extensions);
+
+    return true;
+}
+
+int BC7EnableAVX2()
+{
+    bool result = bc7ToggleSIMD(EXTENSION_AVX2);
+
+    return result ? 0 : 1;
+}
+
+int BC7EnableAVX512()
+{
+    bool result = bc7ToggleSIMD(EXTENSION_AVX512_F);
+
+    return result ? 0 : 1;
+}
+
+void BC7DisableSIMD()
+{
+    bc7ToggleSIMD(EXTENSION_NONE);
+}
+#endif
+
 #ifndef ASPM
 //---------------------------------------------
 // Predefinitions for GPU and CPU compiled code
@@ -2260,6 +2323,22 @@ void Compress_mode01237(CGU_INT blockMode, BC7_EncodeState EncodeState[], CMP_UN
 
     CGV_UINT8 bestPartition = 0;
 
+#if !defined(ASPM_GPU)
+    if (!g_bc7FunctionPointersSet)
+        bc7ToggleSIMD(EXTENSION_COUNT);
+
+    // Quantize several partitions at once, one per SIMD lane
+    if (cpu_bc7QuantizePartitions)
+        cpu_bc7QuantizePartitions(storedError,
+                                  &storedBestindex[0][0][0],
+                                  EncodeState->image_src,
+                                  &subset_mask_table[EncodeState->maxSubSets == 3 ? 64 : 0],
+                                  EncodeState->maxSubSets,
+                                  mode_partitionsToTry,
+                                  EncodeState->clusters,
+                                  EncodeState->channels3or4);
+    else
+#endif
     for (CGU_INT mode_blockPartition = 0; mode_blockPartition < mode_partitionsToTry; mode_blockPartition++)
     {
         GetPartitionSubSet_mode01237(
@@ -3514,6 +3593,47 @@ int CMP_CDECL SetAlphaOptionsBC7(void* options, CGU_BOOL imageNeedsAlpha, CGU_BO
     return CGU_CORE_OK;
 }
 
+static void CompressBlockBC7_CPU(const CMP_Vec4uc inBlock[SOURCE_BLOCK_SIZE], CMP_GLOBAL unsigned char cmpBlock[16], BC7_Encode* u_BC7Encode)
+{
+    BC7_EncodeState EncodeState
+#ifndef ASPM
+        = {0}
+#endif
+    ;
+    EncodeState.best_err      = CMP_FLOAT_MAX;
+    EncodeState.validModeMask = u_BC7Encode->validModeMask;
+    EncodeState.part_count    = u_BC7Encode->part_count;
+    EncodeState.channels      = CMP_STATIC_CAST(CGU_UINT8, u_BC7Encode->channels);
+
+    CGU_UINT8  offsetR   = 0;
+    CGU_UINT8  offsetG   = 16;
+    CGU_UINT8  offsetB   = 32;
+    CGU_UINT8  offsetA   = 48;
+    CGU_UINT32 offsetSRC = 0;
+    for (CGU_UINT8 i = 0; i < SOURCE_BLOCK_SIZE; i++)
+    {
+        EncodeState.image_src[offsetR++] = (CGV_FLOAT)inBlock[offsetSRC].x;
+        EncodeState.image_src[offsetG++] = (CGV_FLOAT)inBlock[offsetSRC].y;
+        EncodeState.image_src[offsetB++] = (CGV_FLOAT)inBlock[offsetSRC].z;
+        EncodeState.image_src[offsetA++] = (CGV_FLOAT)inBlock[offsetSRC].w;
+        offsetSRC++;
+    }
+
+    BC7_CompressBlock(&EncodeState, u_BC7Encode);
+
+    if (EncodeState.cmp_isout16Bytes)
+    {
+        for (CGU_UINT8 i = 0; i < COMPRESSED_BLOCK_SIZE; i++)
+        {
+            cmpBlock[i] = EncodeState.cmp_out[i];
+        }
+    }
+    else
+    {
+        memcpy(cmpBlock, EncodeState.best_cmp_out, 16);
+    }
+}
+
 int CMP_CDECL CompressBlockBC7(const unsigned char* srcBlock, unsigned int srcStrideInBytes, CMP_GLOBAL unsigned char cmpBlock[16], const void* options = NULL)
 {
     CMP_Vec4uc inBlock[SOURCE_BLOCK_SIZE];
@@ -3545,43 +3665,64 @@ int CMP_CDECL CompressBlockBC7(const unsigned char* srcBlock, unsigned int srcSt
         init_BC7ramps();
     }
 
-    BC7_EncodeState EncodeState
-#ifndef ASPM
-        = {0}
-#endif
-    ;
-    EncodeState.best_err      = CMP_FLOAT_MAX;
-    EncodeState.validModeMask = u_BC7Encode->validModeMask;
-    EncodeState.part_count    = u_BC7Encode->part_count;
-    EncodeState.channels      = CMP_STATIC_CAST(CGU_UINT8, u_BC7Encode->channels);
+    CompressBlockBC7_CPU(inBlock, cmpBlock, u_BC7Encode);
 
-    CGU_UINT8  offsetR   = 0;
-    CGU_UINT8  offsetG   = 16;
-    CGU_UINT8  offsetB   = 32;
-    CGU_UINT8  offsetA   = 48;
-    CGU_UINT32 offsetSRC = 0;
-    for (CGU_UINT8 i = 0; i < SOURCE_BLOCK_SIZE; i++)
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL CompressBlocksBC7(const unsigned char*      srcBlocks,
+                                unsigned int              srcPitchInBytes,
+                                unsigned int              blocksX,
+                                unsigned int              blocksY,
+                                CMP_GLOBAL unsigned char* cmpBlocks,
+                                unsigned int              cmpPitchInBytes,
+                                const void*               options = NULL)
+{
+    if ((srcBlocks == NULL) || (cmpBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    BC7_Encode* u_BC7Encode      = (BC7_Encode*)options;
+    BC7_Encode  BC7EncodeDefault = {0};
+    if (u_BC7Encode == NULL)
     {
-        EncodeState.image_src[offsetR++] = (CGV_FLOAT)inBlock[offsetSRC].x;
-        EncodeState.image_src[offsetG++] = (CGV_FLOAT)inBlock[offsetSRC].y;
-        EncodeState.image_src[offsetB++] = (CGV_FLOAT)inBlock[offsetSRC].z;
-        EncodeState.image_src[offsetA++] = (CGV_FLOAT)inBlock[offsetSRC].w;
-        offsetSRC++;
+        u_BC7Encode = &BC7EncodeDefault;
+        SetDefaultBC7Options(u_BC7Encode);
+        init_BC7ramps();
     }
 
-    BC7_CompressBlock(&EncodeState, u_BC7Encode);
+    CMP_Vec4uc inBlocks[BLOCK_BATCH_SIZE][SOURCE_BLOCK_SIZE];
 
-    if (EncodeState.cmp_isout16Bytes)
+    for (CGU_UINT32 blockY = 0; blockY < blocksY; blockY++)
     {
-        for (CGU_UINT8 i = 0; i < COMPRESSED_BLOCK_SIZE; i++)
+        const unsigned char*      srcRow = srcBlocks + (size_t)blockY * BlockY * srcPitchInBytes;
+        CMP_GLOBAL unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+
+        for (CGU_UINT32 blockX = 0; blockX < blocksX; blockX += BLOCK_BATCH_SIZE)
         {
-            cmpBlock[i] = EncodeState.cmp_out[i];
+            CGU_UINT32 numBlocks = (blocksX - blockX) < BLOCK_BATCH_SIZE ? (blocksX - blockX) : BLOCK_BATCH_SIZE;
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+            {
+                const unsigned char* srcBlock = srcRow + (size_t)(blockX + i) * BlockX * 4;
+                CGU_INT              dstptr   = 0;
+                for (CGU_UINT8 row = 0; row < 4; row++)
+                {
+                    CGU_INT srcpos = row * srcPitchInBytes;
+                    for (CGU_UINT8 col = 0; col < 4; col++)
+                    {
+                        inBlocks[i][dstptr].x = srcBlock[srcpos++];
+                        inBlocks[i][dstptr].y = srcBlock[srcpos++];
+                        inBlocks[i][dstptr].z = srcBlock[srcpos++];
+                        inBlocks[i][dstptr].w = srcBlock[srcpos++];
+                        dstptr++;
+                    }
+                }
+            }
+
+            for (CGU_UINT32 i = 0; i < numBlocks; i++)
+                CompressBlockBC7_CPU(inBlocks[i], &cmpRow[(blockX + i) * 16], u_BC7Encode);
         }
     }
-    else
-    {
-        memcpy(cmpBlock, EncodeState.best_cmp_out, 16);
-    }
 
     return CGU_CORE_OK;
 }
@@ -3600,6 +3741,45 @@ int CMP_CDECL DecompressBlockBC7(const unsigned char cmpBlock[16], unsigned char
     DecompressBC7_internal((CGU_UINT8(*)[4])srcBlock, (CGU_UINT8*)cmpBlock, u_BC7Encode);
     return CGU_CORE_OK;
 }
+
+int CMP_CDECL DecompressBlocksBC7(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void*          options = NULL)
+{
+    if ((cmpBlocks == NULL) || (dstBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    BC7_Encode* u_BC7Encode      = (BC7_Encode*)options;
+    BC7_Encode  BC7EncodeDefault = {0};
+    if (u_BC7Encode == NULL)
+    {
+        u_BC7Encode = &BC7EncodeDefault;
+        SetDefaultBC7Options(u_BC7Encode);
+        init_BC7ramps();
+    }
+
+    CGU_UINT8 outBlock[SOURCE_BLOCK_SIZE][4];
+
+    for (CGU_UINT32 blockY = 0; blockY < blocksY; blockY++)
+    {
+        const unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+        unsigned char*       dstRow = dstBlocks + (size_t)blockY * BlockY * dstPitchInBytes;
+
+        for (CGU_UINT32 blockX = 0; blockX < blocksX; blockX++)
+        {
+            DecompressBC7_internal(outBlock, (CGU_UINT8*)cmpRow + (size_t)blockX * 16, u_BC7Encode);
+
+            for (CGU_UINT32 row = 0; row < 4; row++)
+                memcpy(dstRow + (size_t)row * dstPitchInBytes + (size_t)blockX * BlockX * 4, outBlock[row * 4], BlockX * 4);
+        }
+    }
+
+    return CGU_CORE_OK;
+}
 #endif
 #endif
 
@@ -75,6 +75,11 @@ struct CGU_Texture_Type
     CGU_UINT8* m_pData;       // Pointer to the texture data
 };
 
+int BC7EnableAVX2();
+int BC7EnableAVX512();
+
+void BC7DisableSIMD();
+
 #endif  // End of ASPM_CPU
 
 #define SOURCE_BLOCK_SIZE 16      // Size of a source block in pixels (each pixel has RGBA:8888 channels)
@@ -359,6 +359,37 @@ static void SetDefaultBC15Options(CMP_BC15Options* BC15Options)
 #endif
     }
 }
+
+// Gathers a 4x4 block of RGBA:8888 pixels whose rows are srcStrideInBytes apart
+static inline void GetBlockRGBA8888(const unsigned char* srcBlock, unsigned int srcStrideInBytes, CMP_Vec4uc inBlock[BLOCK_SIZE_4X4])
+{
+    CGU_INT dstptr = 0;
+    for (CGU_UINT8 row = 0; row < 4; row++)
+    {
+        const unsigned char* srcRow = srcBlock + row * srcStrideInBytes;
+        for (CGU_UINT8 col = 0; col < 4; col++)
+        {
+            inBlock[dstptr].x = srcRow[0];
+            inBlock[dstptr].y = srcRow[1];
+            inBlock[dstptr].z = srcRow[2];
+            inBlock[dstptr].w = srcRow[3];
+            srcRow += 4;
+            dstptr++;
+        }
+    }
+}
+
+// Gathers a 4x4 block of single channel 8 bit pixels whose rows are srcStrideInBytes apart
+static inline void GetBlockR8(const unsigned char* srcBlock, unsigned int srcStrideInBytes, CGU_UINT8 inBlock[BLOCK_SIZE_4X4])
+{
+    for (CGU_UINT8 row = 0; row < 4; row++)
+    {
+        for (CGU_UINT8 col = 0; col < 4; col++)
+        {
+            inBlock[row * 4 + col] = srcBlock[row * srcStrideInBytes + col];
+        }
+    }
+}
 #endif
 
 static CMP_BC15Options CalculateColourWeightings(CGU_Vec4f rgbaBlock[BLOCK_SIZE_4X4], CMP_BC15Options BC15options)
@@ -1527,15 +1558,17 @@ static void cmp_ProcessColors(CMP_INOUT CGU_Vec3f CMP_PTRINOUT  colorMin,
 
 #ifndef ASPM_GPU  // Used by BC1, BC2 & BC3
 //----------------------------------------------------
-// This function decompresses a DXT colour block
-// The block is decompressed to 8 bits per channel
-// Result buffer is RGBA format, A is set to 255
+// Builds the four colour palette of a DXT colour block
+// from its two 565 endpoints, palette entries are
+// RGBA or BGRA 8888 as set by mapDecodeRGBA.
+// BC2 and BC3 colour blocks always use four colours,
+// BC1 blocks with n0 <= n1 use three colours and black
+// with zero alpha.
 //----------------------------------------------------
-static void cmp_decompressDXTRGBA_Internal(CGU_UINT8 rgbBlock[BLOCK_SIZE_4X4X4], const CGU_Vec2ui compressedBlock, const CGU_BOOL mapDecodeRGBA)
+static void cmp_getDXTRGBAPalette(CGU_UINT32 palette[4], const CGU_UINT32 endpoints, const CGU_BOOL mapDecodeRGBA, const CGU_BOOL isBC1)
 {
-    CGU_BOOL   bDXT1 = TRUE;
-    CGU_UINT32 n0    = compressedBlock.x & 0xffff;
-    CGU_UINT32 n1    = compressedBlock.x >> 16;
+    CGU_UINT32 n0 = endpoints & 0xffff;
+    CGU_UINT32 n1 = endpoints >> 16;
     CGU_UINT32 r0;
     CGU_UINT32 g0;
     CGU_UINT32 b0;
@@ -1564,60 +1597,19 @@ static void cmp_decompressDXTRGBA_Internal(CGU_UINT8 rgbBlock[BLOCK_SIZE_4X4X4],
         //--------------------------------------------------------------
         // Channel mapping output as BGRA
         //--------------------------------------------------------------
-        CGU_UINT32 c0 = 0xff000000 | (r0 << 16) | (g0 << 8) | b0;
-        CGU_UINT32 c1 = 0xff000000 | (r1 << 16) | (g1 << 8) | b1;
+        palette[0] = 0xff000000 | (r0 << 16) | (g0 << 8) | b0;
+        palette[1] = 0xff000000 | (r1 << 16) | (g1 << 8) | b1;
 
-        if (!bDXT1 || n0 > n1)
+        if (!isBC1 || n0 > n1)
         {
-            CGU_UINT32 c2 = 0xff000000 | (((2 * r0 + r1) / 3) << 16) | (((2 * g0 + g1) / 3) << 8) | (((2 * b0 + b1) / 3));
-            CGU_UINT32 c3 = 0xff000000 | (((2 * r1 + r0) / 3) << 16) | (((2 * g1 + g0) / 3) << 8) | (((2 * b1 + b0) / 3));
-
-            for (int i = 0; i < 16; i++)
-            {
-                int index = (compressedBlock.y >> (2 * i)) & 3;
-
-                switch (index)
-                {
-                case 0:
-                    ((CGU_UINT32*)rgbBlock)[i] = c0;
-                    break;
-                case 1:
-                    ((CGU_UINT32*)rgbBlock)[i] = c1;
-                    break;
-                case 2:
-                    ((CGU_UINT32*)rgbBlock)[i] = c2;
-                    break;
-                case 3:
-                    ((CGU_UINT32*)rgbBlock)[i] = c3;
-                    break;
-                }
-            }
+            palette[2] = 0xff000000 | (((2 * r0 + r1) / 3) << 16) | (((2 * g0 + g1) / 3) << 8) | (((2 * b0 + b1) / 3));
+            palette[3] = 0xff000000 | (((2 * r1 + r0) / 3) << 16) | (((2 * g1 + g0) / 3) << 8) | (((2 * b1 + b0) / 3));
         }
         else
         {
             // Transparent decode
-            CGU_UINT32 c2 = 0xff000000 | (((r0 + r1) / 2) << 16) | (((g0 + g1) / 2) << 8) | (((b0 + b1) / 2));
-
-            for (int i = 0; i < 16; i++)
-            {
-                int index = (compressedBlock.y >> (2 * i)) & 3;
-
-                switch (index)
-                {
-                case 0:
-                    ((CGU_UINT32*)rgbBlock)[i] = c0;
-                    break;
-                case 1:
-                    ((CGU_UINT32*)rgbBlock)[i] = c1;
-                    break;
-                case 2:
-                    ((CGU_UINT32*)rgbBlock)[i] = c2;
-                    break;
-                case 3:
-                    ((CGU_UINT32*)rgbBlock)[i] = 0x00000000;
-                    break;
-                }
-            }
+            palette[2] = 0xff000000 | (((r0 + r1) / 2) << 16) | (((g0 + g1) / 2) << 8) | (((b0 + b1) / 2));
+            palette[3] = 0x00000000;
         }
     }
     else
@@ -1626,62 +1618,37 @@ static void cmp_decompressDXTRGBA_Internal(CGU_UINT8 rgbBlock[BLOCK_SIZE_4X4X4],
         //--------------------------------------------------------------
         // Channel mapping output as RGBA
         //--------------------------------------------------------------
+        palette[0] = 0xff000000 | (b0 << 16) | (g0 << 8) | r0;
+        palette[1] = 0xff000000 | (b1 << 16) | (g1 << 8) | r1;
 
-        CGU_UINT32 c0 = 0xff000000 | (b0 << 16) | (g0 << 8) | r0;
-        CGU_UINT32 c1 = 0xff000000 | (b1 << 16) | (g1 << 8) | r1;
-
-        if (!bDXT1 || n0 > n1)
+        if (!isBC1 || n0 > n1)
         {
-            CGU_UINT32 c2 = 0xff000000 | (((2 * b0 + b1 + 1) / 3) << 16) | (((2 * g0 + g1 + 1) / 3) << 8) | (((2 * r0 + r1 + 1) / 3));
-            CGU_UINT32 c3 = 0xff000000 | (((2 * b1 + b0 + 1) / 3) << 16) | (((2 * g1 + g0 + 1) / 3) << 8) | (((2 * r1 + r0 + 1) / 3));
-
-            for (int i = 0; i < 16; i++)
-            {
-                int index = (compressedBlock.y >> (2 * i)) & 3;
-                switch (index)
-                {
-                case 0:
-                    ((CMP_GLOBAL CGU_UINT32*)rgbBlock)[i] = c0;
-                    break;
-                case 1:
-                    ((CMP_GLOBAL CGU_UINT32*)rgbBlock)[i] = c1;
-                    break;
-                case 2:
-                    ((CMP_GLOBAL CGU_UINT32*)rgbBlock)[i] = c2;
-                    break;
-                case 3:
-                    ((CMP_GLOBAL CGU_UINT32*)rgbBlock)[i] = c3;
-                    break;
-                }
-            }
+            palette[2] = 0xff000000 | (((2 * b0 + b1 + 1) / 3) << 16) | (((2 * g0 + g1 + 1) / 3) << 8) | (((2 * r0 + r1 + 1) / 3));
+            palette[3] = 0xff000000 | (((2 * b1 + b0 + 1) / 3) << 16) | (((2 * g1 + g0 + 1) / 3) << 8) | (((2 * r1 + r0 + 1) / 3));
         }
         else
         {
             // Transparent decode
-            CGU_UINT32 c2 = 0xff000000 | (((b0 + b1) / 2) << 16) | (((g0 + g1) / 2) << 8) | (((r0 + r1) / 2));
-
-            for (int i = 0; i < 16; i++)
-            {
-                int index = (compressedBlock.y >> (2 * i)) & 3;
-                switch (index)
-                {
-                case 0:
-                    ((CMP_GLOBAL CGU_UINT32*)rgbBlock)[i] = c0;
-                    break;
-                case 1:
-                    ((CMP_GLOBAL CGU_UINT32*)rgbBlock)[i] = c1;
-                    break;
-                case 2:
-                    ((CMP_GLOBAL CGU_UINT32*)rgbBlock)[i] = c2;
-                    break;
-                case 3:
-                    ((CMP_GLOBAL CGU_UINT32*)rgbBlock)[i] = 0x00000000;
-                    break;
-                }
-            }
+            palette[2] = 0xff000000 | (((b0 + b1) / 2) << 16) | (((g0 + g1) / 2) << 8) | (((r0 + r1) / 2));
+            palette[3] = 0x00000000;
         }
     }  //MAP_ABGR
 }
+
+//----------------------------------------------------
+// This function decompresses a DXT colour block
+// The block is decompressed to 8 bits per channel
+// Result buffer is RGBA format, A is set to 255
+//----------------------------------------------------
+static inline void cmp_decompressDXTRGBA_Internal(CGU_UINT8 rgbBlock[BLOCK_SIZE_4X4X4], const CGU_Vec2ui compressedBlock, const CGU_BOOL mapDecodeRGBA, const CGU_BOOL isBC1)
+{
+    CGU_UINT32 palette[4];
+    cmp_getDXTRGBAPalette(palette, compressedBlock.x, mapDecodeRGBA, isBC1);
+
+    // memcpy keeps the byte block from being accessed through a CGU_UINT32 lvalue
+    for (int i = 0; i < 16; i++)
+        memcpy(&rgbBlock[i * 4], &palette[(compressedBlock.y >> (2 * i)) & 3], sizeof(CGU_UINT32));
+}
 #endif  // !ASPM_GPU
 
 //--------------------------------------------------------------------------------------------------------
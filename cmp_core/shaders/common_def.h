@@ -171,6 +171,7 @@
 #define BLOCK_SIZE_4X4 16
 #define BlockX 4
 #define BlockY 4
+#define BLOCK_BATCH_SIZE 16         // Number of source blocks gathered at a time by the CompressBlocksBCn API
 //#define USE_BLOCK_LINEAR    // Source Data is organized in linear form for each block : Experimental Code not fully developed
 //#define USE_DOUBLE          // Default is to use float, enable to use double data types only for float definitions
 
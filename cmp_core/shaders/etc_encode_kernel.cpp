@@ -0,0 +1,1572 @@
+//=====================================================================
+// Copyright (c) 2024   Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+//
+// ETC1, ETC2 RGB and ETC2 RGBA (EAC alpha) block encoder and decoder.
+//
+// The color modes are searched by building candidate palettes of four colors, an ETC1 sub block base color
+// with each modifier table or an ETC2 T or H mode color pair with each distance, and evaluating them in
+// batches with cpu_etcPaletteErrors. The SSE4, AVX2 and AVX-512 versions evaluate one palette per lane and
+// return the same errors as the scalar version, so the encoded blocks do not depend on the instruction set.
+//
+// The compressed blocks are stored in the byte order used by the GPU: the 64 bit color block as two big
+// endian 32 bit words and the EAC alpha block before the color block.
+//
+#include "etc_encode_kernel.h"
+
+#if !defined(ASPM_GPU)
+#include "cpu_extensions.h"
+#include "core_simd.h"
+#include "core_simd_etc.h"
+
+#include <float.h>
+
+#define ETC_MODE_ETC1 0
+#define ETC_MODE_T 1
+#define ETC_MODE_H 2
+#define ETC_MODE_PLANAR 3
+
+#define ETC_MAX_BASE_CANDIDATES 27  // rounded average and its neighbors in each channel
+#define ETC_REFINE_STEPS 8          // T and H color refinement passes
+#define ETC_FAST_REFINE_STEPS 1     // T and H color refinement passes of the fast search
+
+// Fast search: blocks with a lower ETC1 error, about 2.5 RMS per pixel, skip the T and H modes
+#define ETC_FAST_SKIP_ERROR (16.0f * 6.0f)
+
+static const CGU_INT g_etcModifiers[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+static const CGU_INT g_etcDistances[8]    = {3, 6, 11, 16, 23, 32, 41, 64};
+
+static const CGU_INT g_etcAlphaBase[16][4] = {{-15, -9, -6, -3},
+                                              {-13, -10, -7, -3},
+                                              {-13, -8, -5, -2},
+                                              {-13, -6, -4, -2},
+                                              {-12, -8, -6, -3},
+                                              {-11, -9, -7, -3},
+                                              {-11, -8, -7, -4},
+                                              {-11, -8, -5, -3},
+                                              {-10, -8, -6, -2},
+                                              {-10, -8, -5, -2},
+                                              {-10, -8, -4, -2},
+                                              {-10, -7, -5, -2},
+                                              {-10, -7, -4, -3},
+                                              {-10, -3, -2, -1},
+                                              {-9, -8, -6, -4},
+                                              {-9, -7, -5, -3}};
+
+// Perceptual channel weights, the same as the etcpack perceptual encoders
+static const CGU_FLOAT g_etcWeights[3] = {0.299f, 0.587f, 0.114f};
+
+// Single lane type, the scalar encoder evaluates the palettes with the same code as the SIMD versions
+struct ETCScalarLanes
+{
+    typedef float vf;
+
+    static const int Lanes = 1;
+
+    static inline vf zero() { return 0.0f; }
+    static inline vf set1(float a) { return a; }
+    static inline vf load(const float* p) { return *p; }
+    static inline void store(float* p, vf a) { *p = a; }
+
+    static inline vf add(vf a, vf b) { return a + b; }
+    static inline vf sub(vf a, vf b) { return a - b; }
+    static inline vf mul(vf a, vf b) { return a * b; }
+    static inline vf min(vf a, vf b) { return a < b ? a : b; }
+};
+
+static void scalar_etcPaletteErrors(float* errors, const float* palettes, int numPalettes, const float* pixels, int numPixels, const float* weights)
+{
+    etcPaletteErrors<ETCScalarLanes>(errors, palettes, numPalettes, pixels, numPixels, weights);
+}
+
+CMP_STATIC CGU_BOOL g_etcFunctionPointersSet = false;
+
+// Evaluates a batch of candidate palettes against the pixels of a block or sub block
+CMP_STATIC void (*cpu_etcPaletteErrors)(float*, const float*, int, const float*, int, const float*) = scalar_etcPaletteErrors;
+
+// Toggle which SIMD instruction set extensions to use. Setting this to EXTENSION_COUNT will enable auto-detection of supported extensions.
+CMP_STATIC bool etcToggleSIMD(CGU_INT newExtension)
+{
+    CGU_BOOL useAVX512 = true;
+    CGU_BOOL useAVX2   = true;
+    CGU_BOOL useSSE4   = true;
+
+    CPUExtensions extensions = GetCPUExtensions();
+
+    if (newExtension < EXTENSION_COUNT)  // user requested a specific instruction set extension
+    {
+        useAVX512 = newExtension == EXTENSION_AVX512_F;
+        useAVX2   = newExtension == EXTENSION_AVX2;
+        useSSE4   = newExtension == EXTENSION_SSE42;
+    }
+
+#ifndef __APPLE__
+    if (useAVX512 && IsAvailableAVX512(extensions))
+        cpu_etcPaletteErrors = avx512_etcPaletteErrors;
+    else if (useAVX2 && IsAvailableAVX2(extensions))
+        cpu_etcPaletteErrors = avx_etcPaletteErrors;
+    else if (useSSE4 && IsAvailableSSE4(extensions))
+        cpu_etcPaletteErrors = sse_etcPaletteErrors;
+    else
+#endif
+        cpu_etcPaletteErrors = scalar_etcPaletteErrors;
+
+    g_etcFunctionPointersSet = true;
+
+    if (newExtension == EXTENSION_AVX512_F)
+        return IsAvailableAVX512(extensions);
+    if (newExtension == EXTENSION_AVX2)
+        return IsAvailableAVX2(extensions);
+    if (newExtension == EXTENSION_SSE42)
+        return IsAvailableSSE4(extensions);
+
+    return true;
+}
+
+int ETCEnableSSE4()
+{
+    bool result = etcToggleSIMD(EXTENSION_SSE42);
+
+    return result ? 0 : 1;
+}
+
+int ETCEnableAVX2()
+{
+    bool result = etcToggleSIMD(EXTENSION_AVX2);
+
+    return result ? 0 : 1;
+}
+
+int ETCEnableAVX512()
+{
+    bool result = etcToggleSIMD(EXTENSION_AVX512_F);
+
+    return result ? 0 : 1;
+}
+
+void ETCDisableSIMD()
+{
+    etcToggleSIMD(EXTENSION_NONE);
+}
+
+//============================================== BIT AND COLOR HELPERS ================================================
+
+static inline CGU_UINT32 etcGetBits(CGU_UINT32 word, CGU_INT size, CGU_INT startpos)
+{
+    return (word >> (startpos - size + 1)) & ((1u << size) - 1);
+}
+
+static inline void etcPutBits(CGU_UINT32& word, CGU_UINT32 data, CGU_INT size, CGU_INT startpos)
+{
+    CGU_INT    shift = startpos - size + 1;
+    CGU_UINT32 mask  = ((1u << size) - 1) << shift;
+
+    word = (word & ~mask) | ((data << shift) & mask);
+}
+
+// Pixels are numbered x * 4 + y, the order of the index bits of all ETC modes
+static inline void etcSetIndex(CGU_UINT32& indexBits, CGU_INT pixel, CGU_INT index)
+{
+    indexBits |= ((CGU_UINT32)(index >> 1) << (16 + pixel)) | ((CGU_UINT32)(index & 1) << pixel);
+}
+
+static inline CGU_INT etcGetIndex(CGU_UINT32 indexBits, CGU_INT pixel)
+{
+    return (CGU_INT)(((indexBits >> (16 + pixel)) & 1) << 1 | ((indexBits >> pixel) & 1));
+}
+
+static inline CGU_INT etcClamp(CGU_INT value)
+{
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+static inline CGU_INT etcExpand4(CGU_INT c)
+{
+    return (c << 4) | c;
+}
+
+static inline CGU_INT etcExpand5(CGU_INT c)
+{
+    return (c << 3) | (c >> 2);
+}
+
+static inline CGU_INT etcExpand6(CGU_INT c)
+{
+    return (c << 2) | (c >> 4);
+}
+
+static inline CGU_INT etcExpand7(CGU_INT c)
+{
+    return (c << 1) | (c >> 6);
+}
+
+static inline CGU_INT etcQuantize(CGU_FLOAT value, CGU_INT maxValue)
+{
+    CGU_INT q = (CGU_INT)(value * maxValue / 255.0f + 0.5f);
+
+    return q < 0 ? 0 : (q > maxValue ? maxValue : q);
+}
+
+//============================================== PALETTES =============================================================
+
+struct ETCBlock
+{
+    CGU_FLOAT pixels[16][3];  // RGB, in pixel index order x * 4 + y
+    CGU_BOOL  fast;
+};
+
+struct ETCPaletteBatch
+{
+    CGU_FLOAT palettes[12 * ETC_SIMD_MAX_PALETTES];  // see etcPaletteErrors() for the layout
+    CGU_FLOAT errors[ETC_SIMD_MAX_PALETTES];
+    CGU_INT   numPalettes;
+};
+
+static void etcAddPalette(ETCPaletteBatch& batch, const CGU_INT colors[4][3])
+{
+    for (CGU_INT k = 0; k < 4; k++)
+        for (CGU_INT ch = 0; ch < 3; ch++)
+            batch.palettes[(k * 3 + ch) * ETC_SIMD_MAX_PALETTES + batch.numPalettes] = (CGU_FLOAT)colors[k][ch];
+
+    batch.numPalettes++;
+}
+
+static void etcEvaluatePalettes(ETCPaletteBatch& batch, const CGU_FLOAT* pixels, CGU_INT numPixels)
+{
+    cpu_etcPaletteErrors(batch.errors, batch.palettes, batch.numPalettes, pixels, numPixels, g_etcWeights);
+}
+
+// ETC1 palette of an 8 bit base color and a modifier table, in the order of the pixel index values
+static void etcModifierPalette(CGU_INT colors[4][3], const CGU_INT base[3], CGU_INT table)
+{
+    const CGU_INT modifiers[4] = {g_etcModifiers[table][0], g_etcModifiers[table][1], -g_etcModifiers[table][0], -g_etcModifiers[table][1]};
+
+    for (CGU_INT k = 0; k < 4; k++)
+        for (CGU_INT ch = 0; ch < 3; ch++)
+            colors[k][ch] = etcClamp(base[ch] + modifiers[k]);
+}
+
+// T mode palette of two 4 bit colors: the first color, and the second color plus, unchanged and minus the distance
+static void etcTPalette(CGU_INT colors[4][3], const CGU_INT color0[3], const CGU_INT color1[3], CGU_INT distance)
+{
+    CGU_INT d = g_etcDistances[distance];
+
+    for (CGU_INT ch = 0; ch < 3; ch++)
+    {
+        CGU_INT c0 = etcExpand4(color0[ch]);
+        CGU_INT c1 = etcExpand4(color1[ch]);
+
+        colors[0][ch] = c0;
+        colors[1][ch] = etcClamp(c1 + d);
+        colors[2][ch] = c1;
+        colors[3][ch] = etcClamp(c1 - d);
+    }
+}
+
+// H mode palette of two 4 bit colors, each plus and minus the distance
+static void etcHPalette(CGU_INT colors[4][3], const CGU_INT color0[3], const CGU_INT color1[3], CGU_INT distance)
+{
+    CGU_INT d = g_etcDistances[distance];
+
+    for (CGU_INT ch = 0; ch < 3; ch++)
+    {
+        CGU_INT c0 = etcExpand4(color0[ch]);
+        CGU_INT c1 = etcExpand4(color1[ch]);
+
+        colors[0][ch] = etcClamp(c0 + d);
+        colors[1][ch] = etcClamp(c0 - d);
+        colors[2][ch] = etcClamp(c1 + d);
+        colors[3][ch] = etcClamp(c1 - d);
+    }
+}
+
+// Picks the closest palette entry for each pixel, with the same error measure as etcPaletteErrors()
+static CGU_FLOAT etcPaletteIndices(CGU_INT* indices, const CGU_INT colors[4][3], const CGU_FLOAT* pixels, CGU_INT numPixels)
+{
+    CGU_FLOAT error = 0.0f;
+
+    for (CGU_INT i = 0; i < numPixels; i++)
+    {
+        CGU_FLOAT best      = FLT_MAX;
+        CGU_INT   bestIndex = 0;
+
+        for (CGU_INT k = 0; k < 4; k++)
+        {
+            CGU_FLOAT dr = pixels[i * 3 + 0] - (CGU_FLOAT)colors[k][0];
+            CGU_FLOAT dg = pixels[i * 3 + 1] - (CGU_FLOAT)colors[k][1];
+            CGU_FLOAT db = pixels[i * 3 + 2] - (CGU_FLOAT)colors[k][2];
+            CGU_FLOAT e  = g_etcWeights[0] * (dr * dr) + g_etcWeights[1] * (dg * dg) + g_etcWeights[2] * (db * db);
+
+            if (e < best)
+            {
+                best      = e;
+                bestIndex = k;
+            }
+        }
+
+        indices[i] = bestIndex;
+        error += best;
+    }
+
+    return error;
+}
+
+//============================================== ETC1 MODES ===========================================================
+
+struct ETC1Encoding
+{
+    CGU_BOOL  diff;
+    CGU_INT   flip;
+    CGU_INT   base[2][3];  // 4 bit individual or 5 bit differential base colors of the two sub blocks
+    CGU_INT   table[2];
+    CGU_FLOAT error;
+};
+
+// Pixel numbers of the two sub blocks, flip 0 splits the block into left and right halves, flip 1 into top and bottom
+static void etcSubBlockPixels(CGU_INT pixelIds[2][8], CGU_INT flip)
+{
+    CGU_INT count[2] = {0, 0};
+
+    for (CGU_INT j = 0; j < 16; j++)
+    {
+        CGU_INT x   = j >> 2;
+        CGU_INT y   = j & 3;
+        CGU_INT sub = flip ? (y >= 2) : (x >= 2);
+
+        pixelIds[sub][count[sub]++] = j;
+    }
+}
+
+// Base colors to try for a sub block: the rounded average, and its neighbors unless using the fast search
+static CGU_INT etcBaseCandidates(CGU_INT bases[ETC_MAX_BASE_CANDIDATES][3], const CGU_FLOAT average[3], CGU_INT maxValue, CGU_BOOL fast)
+{
+    CGU_INT q[3];
+    for (CGU_INT ch = 0; ch < 3; ch++)
+        q[ch] = etcQuantize(average[ch], maxValue);
+
+    if (fast)
+    {
+        bases[0][0] = q[0];
+        bases[0][1] = q[1];
+        bases[0][2] = q[2];
+        return 1;
+    }
+
+    CGU_INT numBases = 0;
+
+    for (CGU_INT dr = -1; dr <= 1; dr++)
+    {
+        for (CGU_INT dg = -1; dg <= 1; dg++)
+        {
+            for (CGU_INT db = -1; db <= 1; db++)
+            {
+                CGU_INT r = q[0] + dr;
+                CGU_INT g = q[1] + dg;
+                CGU_INT b = q[2] + db;
+
+                if (r < 0 || r > maxValue || g < 0 || g > maxValue || b < 0 || b > maxValue)
+                    continue;
+
+                bases[numBases][0] = r;
+                bases[numBases][1] = g;
+                bases[numBases][2] = b;
+                numBases++;
+            }
+        }
+    }
+
+    return numBases;
+}
+
+// Searches the individual and differential modes with both flips
+static void etcSearchETC1(ETC1Encoding& best, const ETCBlock& block, ETCPaletteBatch& batch)
+{
+    best.error = FLT_MAX;
+
+    for (CGU_INT flip = 0; flip < 2; flip++)
+    {
+        CGU_INT pixelIds[2][8];
+        etcSubBlockPixels(pixelIds, flip);
+
+        CGU_INT   bases4[2][ETC_MAX_BASE_CANDIDATES][3];
+        CGU_INT   bases5[2][ETC_MAX_BASE_CANDIDATES][3];
+        CGU_INT   numBases4[2];
+        CGU_INT   numBases5[2];
+        CGU_FLOAT errors4[2][ETC_MAX_BASE_CANDIDATES];
+        CGU_FLOAT errors5[2][ETC_MAX_BASE_CANDIDATES];
+        CGU_INT   tables4[2][ETC_MAX_BASE_CANDIDATES];
+        CGU_INT   tables5[2][ETC_MAX_BASE_CANDIDATES];
+
+        for (CGU_INT sub = 0; sub < 2; sub++)
+        {
+            CGU_FLOAT subPixels[8][3];
+            CGU_FLOAT average[3] = {0.0f, 0.0f, 0.0f};
+
+            for (CGU_INT i = 0; i < 8; i++)
+            {
+                for (CGU_INT ch = 0; ch < 3; ch++)
+                {
+                    subPixels[i][ch] = block.pixels[pixelIds[sub][i]][ch];
+                    average[ch] += subPixels[i][ch];
+                }
+            }
+
+            for (CGU_INT ch = 0; ch < 3; ch++)
+                average[ch] *= 0.125f;
+
+            numBases4[sub] = etcBaseCandidates(bases4[sub], average, 15, block.fast);
+            numBases5[sub] = etcBaseCandidates(bases5[sub], average, 31, block.fast);
+
+            // one batch holds every base color of both modes with all eight tables
+            batch.numPalettes = 0;
+
+            for (CGU_INT i = 0; i < numBases4[sub] + numBases5[sub]; i++)
+            {
+                CGU_INT base[3];
+                for (CGU_INT ch = 0; ch < 3; ch++)
+                    base[ch] = i < numBases4[sub] ? etcExpand4(bases4[sub][i][ch]) : etcExpand5(bases5[sub][i - numBases4[sub]][ch]);
+
+                for (CGU_INT table = 0; table < 8; table++)
+                {
+                    CGU_INT colors[4][3];
+                    etcModifierPalette(colors, base, table);
+                    etcAddPalette(batch, colors);
+                }
+            }
+
+            etcEvaluatePalettes(batch, &subPixels[0][0], 8);
+
+            for (CGU_INT i = 0; i < numBases4[sub] + numBases5[sub]; i++)
+            {
+                CGU_FLOAT bestError = FLT_MAX;
+                CGU_INT   bestTable = 0;
+
+                for (CGU_INT table = 0; table < 8; table++)
+                {
+                    if (batch.errors[i * 8 + table] < bestError)
+                    {
+                        bestError = batch.errors[i * 8 + table];
+                        bestTable = table;
+                    }
+                }
+
+                if (i < numBases4[sub])
+                {
+                    errors4[sub][i] = bestError;
+                    tables4[sub][i] = bestTable;
+                }
+                else
+                {
+                    errors5[sub][i - numBases4[sub]] = bestError;
+                    tables5[sub][i - numBases4[sub]] = bestTable;
+                }
+            }
+        }
+
+        // differential mode, the second base color is stored as a 3 bit signed offset from the first
+        for (CGU_INT i = 0; i < numBases5[0]; i++)
+        {
+            for (CGU_INT j = 0; j < numBases5[1]; j++)
+            {
+                CGU_BOOL valid = true;
+                for (CGU_INT ch = 0; ch < 3; ch++)
+                {
+                    CGU_INT delta = bases5[1][j][ch] - bases5[0][i][ch];
+                    if (delta < -4 || delta > 3)
+                        valid = false;
+                }
+
+                if (!valid)
+                    continue;
+
+                CGU_FLOAT error = errors5[0][i] + errors5[1][j];
+                if (error < best.error)
+                {
+                    best.error = error;
+                    best.diff  = true;
+                    best.flip  = flip;
+                    for (CGU_INT ch = 0; ch < 3; ch++)
+                    {
+                        best.base[0][ch] = bases5[0][i][ch];
+                        best.base[1][ch] = bases5[1][j][ch];
+                    }
+                    best.table[0] = tables5[0][i];
+                    best.table[1] = tables5[1][j];
+                }
+            }
+        }
+
+        // individual mode, the sub blocks are independent. Only used when better than the differential mode,
+        // like etcpack, so equal errors give the same blocks.
+        CGU_INT choice[2] = {0, 0};
+        for (CGU_INT sub = 0; sub < 2; sub++)
+        {
+            for (CGU_INT i = 1; i < numBases4[sub]; i++)
+            {
+                if (errors4[sub][i] < errors4[sub][choice[sub]])
+                    choice[sub] = i;
+            }
+        }
+
+        CGU_FLOAT error = errors4[0][choice[0]] + errors4[1][choice[1]];
+        if (error < best.error)
+        {
+            best.error = error;
+            best.diff  = false;
+            best.flip  = flip;
+            for (CGU_INT sub = 0; sub < 2; sub++)
+            {
+                for (CGU_INT ch = 0; ch < 3; ch++)
+                    best.base[sub][ch] = bases4[sub][choice[sub]][ch];
+                best.table[sub] = tables4[sub][choice[sub]];
+            }
+        }
+    }
+}
+
+static void etcPackETC1(CGU_UINT32& hi, CGU_UINT32& lo, const ETC1Encoding& enc, const ETCBlock& block)
+{
+    hi = 0;
+    lo = 0;
+
+    if (enc.diff)
+    {
+        for (CGU_INT ch = 0; ch < 3; ch++)
+        {
+            etcPutBits(hi, (CGU_UINT32)enc.base[0][ch], 5, 31 - ch * 8);
+            etcPutBits(hi, (CGU_UINT32)(enc.base[1][ch] - enc.base[0][ch]) & 7, 3, 26 - ch * 8);
+        }
+    }
+    else
+    {
+        for (CGU_INT ch = 0; ch < 3; ch++)
+        {
+            etcPutBits(hi, (CGU_UINT32)enc.base[0][ch], 4, 31 - ch * 8);
+            etcPutBits(hi, (CGU_UINT32)enc.base[1][ch], 4, 27 - ch * 8);
+        }
+    }
+
+    etcPutBits(hi, (CGU_UINT32)enc.table[0], 3, 7);
+    etcPutBits(hi, (CGU_UINT32)enc.table[1], 3, 4);
+    etcPutBits(hi, enc.diff ? 1 : 0, 1, 1);
+    etcPutBits(hi, (CGU_UINT32)enc.flip, 1, 0);
+
+    CGU_INT pixelIds[2][8];
+    etcSubBlockPixels(pixelIds, enc.flip);
+
+    for (CGU_INT sub = 0; sub < 2; sub++)
+    {
+        CGU_INT base[3];
+        for (CGU_INT ch = 0; ch < 3; ch++)
+            base[ch] = enc.diff ? etcExpand5(enc.base[sub][ch]) : etcExpand4(enc.base[sub][ch]);
+
+        CGU_INT colors[4][3];
+        etcModifierPalette(colors, base, enc.table[sub]);
+
+        for (CGU_INT i = 0; i < 8; i++)
+        {
+            CGU_INT index;
+            etcPaletteIndices(&index, colors, block.pixels[pixelIds[sub][i]], 1);
+            etcSetIndex(lo, pixelIds[sub][i], index);
+        }
+    }
+}
+
+//============================================== ETC2 MODES ===========================================================
+
+struct ETC2Encoding
+{
+    CGU_INT   mode;          // ETC_MODE_T, ETC_MODE_H or ETC_MODE_PLANAR
+    CGU_INT   colors[2][3];  // 4 bit colors of the T and H modes
+    CGU_INT   distance;
+    CGU_INT   planar[3][3];  // 6, 7, 6 bit O, H and V colors of the planar mode
+    CGU_FLOAT error;
+};
+
+struct ETCPairCandidate
+{
+    CGU_INT mode;
+    CGU_INT colors[2][3];
+    CGU_INT distance;
+};
+
+static inline CGU_INT etcPackedColor444(const CGU_INT color[3])
+{
+    return (color[0] << 8) | (color[1] << 4) | color[2];
+}
+
+// The lowest bit of the H mode distance is implied by the order of the colors, a pair of equal colors
+// can only store odd distances
+static inline CGU_BOOL etcValidHPair(const CGU_INT color0[3], const CGU_INT color1[3], CGU_INT distance)
+{
+    return (distance & 1) || etcPackedColor444(color0) != etcPackedColor444(color1);
+}
+
+static void etcAddPairCandidates(ETCPaletteBatch&  batch,
+                                 ETCPairCandidate* candidates,
+                                 CGU_INT           mode,
+                                 const CGU_INT     color0[3],
+                                 const CGU_INT     color1[3])
+{
+    for (CGU_INT distance = 0; distance < 8; distance++)
+    {
+        if (mode == ETC_MODE_H && !etcValidHPair(color0, color1, distance))
+            continue;
+
+        CGU_INT colors[4][3];
+        if (mode == ETC_MODE_T)
+            etcTPalette(colors, color0, color1, distance);
+        else
+            etcHPalette(colors, color0, color1, distance);
+
+        ETCPairCandidate& candidate = candidates[batch.numPalettes];
+        candidate.mode              = mode;
+        candidate.distance          = distance;
+        for (CGU_INT ch = 0; ch < 3; ch++)
+        {
+            candidate.colors[0][ch] = color0[ch];
+            candidate.colors[1][ch] = color1[ch];
+        }
+
+        etcAddPalette(batch, colors);
+    }
+}
+
+// Keeps the first candidate of the evaluated batch with a lower error than the best of its mode
+static void etcKeepBestPairs(ETC2Encoding& bestT, ETC2Encoding& bestH, const ETCPaletteBatch& batch, const ETCPairCandidate* candidates)
+{
+    for (CGU_INT i = 0; i < batch.numPalettes; i++)
+    {
+        ETC2Encoding& best = candidates[i].mode == ETC_MODE_T ? bestT : bestH;
+
+        if (batch.errors[i] < best.error)
+        {
+            best.error    = batch.errors[i];
+            best.mode     = candidates[i].mode;
+            best.distance = candidates[i].distance;
+            for (CGU_INT ch = 0; ch < 3; ch++)
+            {
+                best.colors[0][ch] = candidates[i].colors[0][ch];
+                best.colors[1][ch] = candidates[i].colors[1][ch];
+            }
+        }
+    }
+}
+
+// Orders the pixels by their projection on the principal axis of the block colors
+static void etcPrincipalOrder(CGU_INT order[16], CGU_FLOAT projections[16], const ETCBlock& block)
+{
+    CGU_FLOAT mean[3] = {0.0f, 0.0f, 0.0f};
+    for (CGU_INT i = 0; i < 16; i++)
+        for (CGU_INT ch = 0; ch < 3; ch++)
+            mean[ch] += block.pixels[i][ch];
+    for (CGU_INT ch = 0; ch < 3; ch++)
+        mean[ch] *= 1.0f / 16.0f;
+
+    CGU_FLOAT covariance[3][3] = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+    for (CGU_INT i = 0; i < 16; i++)
+    {
+        CGU_FLOAT d[3] = {block.pixels[i][0] - mean[0], block.pixels[i][1] - mean[1], block.pixels[i][2] - mean[2]};
+        for (CGU_INT a = 0; a < 3; a++)
+            for (CGU_INT b = 0; b < 3; b++)
+                covariance[a][b] += d[a] * d[b];
+    }
+
+    // power iteration, starting from the column of the channel with the largest variance
+    CGU_INT start = 0;
+    for (CGU_INT ch = 1; ch < 3; ch++)
+    {
+        if (covariance[ch][ch] > covariance[start][start])
+            start = ch;
+    }
+
+    CGU_FLOAT axis[3] = {covariance[0][start], covariance[1][start], covariance[2][start]};
+
+    for (CGU_INT iteration = 0; iteration < 8; iteration++)
+    {
+        CGU_FLOAT next[3];
+        for (CGU_INT a = 0; a < 3; a++)
+            next[a] = covariance[a][0] * axis[0] + covariance[a][1] * axis[1] + covariance[a][2] * axis[2];
+
+        CGU_FLOAT largest = 0.0f;
+        for (CGU_INT a = 0; a < 3; a++)
+        {
+            CGU_FLOAT m = next[a] < 0.0f ? -next[a] : next[a];
+            if (m > largest)
+                largest = m;
+        }
+
+        if (largest == 0.0f)
+            break;
+
+        for (CGU_INT a = 0; a < 3; a++)
+            axis[a] = next[a] / largest;
+    }
+
+    for (CGU_INT i = 0; i < 16; i++)
+    {
+        order[i]       = i;
+        projections[i] = (block.pixels[i][0] - mean[0]) * axis[0] + (block.pixels[i][1] - mean[1]) * axis[1] + (block.pixels[i][2] - mean[2]) * axis[2];
+    }
+
+    // insertion sort, stable so equal projections keep the pixel order
+    for (CGU_INT i = 1; i < 16; i++)
+    {
+        CGU_INT   id = order[i];
+        CGU_FLOAT p  = projections[id];
+        CGU_INT   j  = i - 1;
+
+        while (j >= 0 && projections[order[j]] > p)
+        {
+            order[j + 1] = order[j];
+            j--;
+        }
+
+        order[j + 1] = id;
+    }
+}
+
+static void etcQuantizedMean(CGU_INT color[3], const ETCBlock& block, const CGU_INT* pixelIds, CGU_INT count)
+{
+    CGU_FLOAT sum[3] = {0.0f, 0.0f, 0.0f};
+
+    for (CGU_INT i = 0; i < count; i++)
+        for (CGU_INT ch = 0; ch < 3; ch++)
+            sum[ch] += block.pixels[pixelIds[i]][ch];
+
+    for (CGU_INT ch = 0; ch < 3; ch++)
+        color[ch] = etcQuantize(sum[ch] / (CGU_FLOAT)count, 15);
+}
+
+// Moves the two colors of a T or H encoding to the means of the pixels each represents, and tries every
+// single channel step of the current colors, until the error stops improving
+static void etcRefinePair(ETC2Encoding& enc, const ETCBlock& block, ETCPaletteBatch& batch, ETCPairCandidate* candidates, CGU_INT steps)
+{
+    ETC2Encoding unused;
+    unused.error = 0.0f;
+
+    for (CGU_INT step = 0; step < steps; step++)
+    {
+        CGU_INT colors[4][3];
+        if (enc.mode == ETC_MODE_T)
+            etcTPalette(colors, enc.colors[0], enc.colors[1], enc.distance);
+        else
+            etcHPalette(colors, enc.colors[0], enc.colors[1], enc.distance);
+
+        CGU_INT indices[16];
+        etcPaletteIndices(indices, colors, &block.pixels[0][0], 16);
+
+        CGU_INT groups[2][16];
+        CGU_INT counts[2] = {0, 0};
+        for (CGU_INT i = 0; i < 16; i++)
+        {
+            CGU_INT group = enc.mode == ETC_MODE_T ? (indices[i] != 0) : (indices[i] >= 2);
+            groups[group][counts[group]++] = i;
+        }
+
+        batch.numPalettes = 0;
+
+        if (counts[0] > 0 && counts[1] > 0)
+        {
+            CGU_INT color0[3];
+            CGU_INT color1[3];
+            etcQuantizedMean(color0, block, groups[0], counts[0]);
+            etcQuantizedMean(color1, block, groups[1], counts[1]);
+            etcAddPairCandidates(batch, candidates, enc.mode, color0, color1);
+        }
+
+        for (CGU_INT c = 0; c < 2; c++)
+        {
+            for (CGU_INT ch = 0; ch < 3; ch++)
+            {
+                for (CGU_INT delta = -1; delta <= 1; delta += 2)
+                {
+                    CGU_INT pair[2][3];
+                    for (CGU_INT i = 0; i < 3; i++)
+                    {
+                        pair[0][i] = enc.colors[0][i];
+                        pair[1][i] = enc.colors[1][i];
+                    }
+
+                    pair[c][ch] += delta;
+                    if (pair[c][ch] < 0 || pair[c][ch] > 15)
+                        continue;
+
+                    etcAddPairCandidates(batch, candidates, enc.mode, pair[0], pair[1]);
+                }
+            }
+        }
+
+        etcEvaluatePalettes(batch, &block.pixels[0][0], 16);
+
+        CGU_FLOAT previousError = enc.error;
+        if (enc.mode == ETC_MODE_T)
+            etcKeepBestPairs(enc, unused, batch, candidates);
+        else
+            etcKeepBestPairs(unused, enc, batch, candidates);
+
+        if (enc.error >= previousError)
+            break;
+    }
+}
+
+// Searches the T and H modes. The pixels are split into two groups along the principal axis, the group means
+// become the two colors and every distance is evaluated. The fast search only splits at the mean, otherwise
+// every split is tried and the colors of the best T and H encodings are refined.
+static void etcSearchTH(ETC2Encoding& best, const ETCBlock& block, ETCPaletteBatch& batch)
+{
+    ETCPairCandidate candidates[ETC_SIMD_MAX_PALETTES];
+
+    CGU_INT   order[16];
+    CGU_FLOAT projections[16];
+    etcPrincipalOrder(order, projections, block);
+
+    CGU_INT firstSplit = 1;
+    CGU_INT lastSplit  = 15;
+
+    if (block.fast)
+    {
+        CGU_INT below = 0;
+        while (below < 16 && projections[order[below]] < 0.0f)
+            below++;
+
+        firstSplit = lastSplit = (below == 0 || below == 16) ? 8 : below;
+    }
+
+    batch.numPalettes = 0;
+
+    for (CGU_INT split = firstSplit; split <= lastSplit; split++)
+    {
+        CGU_INT color0[3];
+        CGU_INT color1[3];
+        etcQuantizedMean(color0, block, order, split);
+        etcQuantizedMean(color1, block, order + split, 16 - split);
+
+        etcAddPairCandidates(batch, candidates, ETC_MODE_T, color0, color1);
+        etcAddPairCandidates(batch, candidates, ETC_MODE_T, color1, color0);
+        etcAddPairCandidates(batch, candidates, ETC_MODE_H, color0, color1);
+    }
+
+    etcEvaluatePalettes(batch, &block.pixels[0][0], 16);
+
+    ETC2Encoding bestT;
+    ETC2Encoding bestH;
+    bestT.error = FLT_MAX;
+    bestH.error = FLT_MAX;
+    etcKeepBestPairs(bestT, bestH, batch, candidates);
+
+    CGU_INT steps = block.fast ? ETC_FAST_REFINE_STEPS : ETC_REFINE_STEPS;
+
+    if (bestT.error < FLT_MAX)
+        etcRefinePair(bestT, block, batch, candidates, steps);
+    if (bestH.error < FLT_MAX)
+        etcRefinePair(bestH, block, batch, candidates, steps);
+
+    if (bestT.error < best.error)
+        best = bestT;
+    if (bestH.error < best.error)
+        best = bestH;
+}
+
+static inline CGU_INT etcPlanarValue(CGU_INT o, CGU_INT h, CGU_INT v, CGU_INT x, CGU_INT y)
+{
+    return etcClamp((x * (h - o) + y * (v - o) + 4 * o + 2) >> 2);
+}
+
+static CGU_INT etcPlanarChannelError(const ETCBlock& block, CGU_INT ch, CGU_INT o, CGU_INT h, CGU_INT v)
+{
+    CGU_INT error = 0;
+
+    for (CGU_INT i = 0; i < 16; i++)
+    {
+        CGU_INT d = etcPlanarValue(o, h, v, i >> 2, i & 3) - (CGU_INT)block.pixels[i][ch];
+        error += d * d;
+    }
+
+    return error;
+}
+
+// Least squares fit of the planar mode, the channels are independent. Unless using the fast search the
+// neighbors of the rounded O, H and V values are also tried.
+static void etcSearchPlanar(ETC2Encoding& best, const ETCBlock& block)
+{
+    CGU_INT   planar[3][3];
+    CGU_FLOAT error = 0.0f;
+
+    for (CGU_INT ch = 0; ch < 3; ch++)
+    {
+        CGU_FLOAT mean = 0.0f;
+        CGU_FLOAT sx   = 0.0f;
+        CGU_FLOAT sy   = 0.0f;
+
+        for (CGU_INT i = 0; i < 16; i++)
+            mean += block.pixels[i][ch];
+        mean *= 1.0f / 16.0f;
+
+        for (CGU_INT i = 0; i < 16; i++)
+        {
+            CGU_FLOAT d = block.pixels[i][ch] - mean;
+            sx += ((i >> 2) - 1.5f) * d;
+            sy += ((i & 3) - 1.5f) * d;
+        }
+
+        // sum of (x - 1.5)^2 over the block is 20
+        CGU_FLOAT dx = sx / 20.0f;
+        CGU_FLOAT dy = sy / 20.0f;
+        CGU_FLOAT o  = mean - 1.5f * (dx + dy);
+
+        CGU_INT maxValue = ch == 1 ? 127 : 63;
+        CGU_INT q[3]     = {etcQuantize(o, maxValue), etcQuantize(o + 4.0f * dx, maxValue), etcQuantize(o + 4.0f * dy, maxValue)};
+        CGU_INT range    = block.fast ? 0 : 1;
+
+        CGU_INT bestError = -1;
+        for (CGU_INT i = -range; i <= range; i++)
+        {
+            for (CGU_INT j = -range; j <= range; j++)
+            {
+                for (CGU_INT k = -range; k <= range; k++)
+                {
+                    CGU_INT qo = q[0] + i;
+                    CGU_INT qh = q[1] + j;
+                    CGU_INT qv = q[2] + k;
+
+                    if (qo < 0 || qo > maxValue || qh < 0 || qh > maxValue || qv < 0 || qv > maxValue)
+                        continue;
+
+                    CGU_INT e = ch == 1 ? etcPlanarChannelError(block, ch, etcExpand7(qo), etcExpand7(qh), etcExpand7(qv))
+                                        : etcPlanarChannelError(block, ch, etcExpand6(qo), etcExpand6(qh), etcExpand6(qv));
+
+                    if (bestError < 0 || e < bestError)
+                    {
+                        bestError      = e;
+                        planar[0][ch] = qo;
+                        planar[1][ch] = qh;
+                        planar[2][ch] = qv;
+                    }
+                }
+            }
+        }
+
+        error += g_etcWeights[ch] * (CGU_FLOAT)bestError;
+    }
+
+    if (error < best.error)
+    {
+        best.error = error;
+        best.mode  = ETC_MODE_PLANAR;
+        for (CGU_INT c = 0; c < 3; c++)
+            for (CGU_INT ch = 0; ch < 3; ch++)
+                best.planar[c][ch] = planar[c][ch];
+    }
+}
+
+// The ETC2 modes reuse the ETC1 differential mode bits, the stuffing below follows the etcpack layout where
+// padding bits make one of the base color plus offset sums overflow: red selects T, green H and blue planar.
+static void etcStuffT(CGU_UINT32& hi, CGU_UINT32 t59)
+{
+    CGU_UINT32 r0a = etcGetBits(t59, 2, 26);
+
+    hi = t59 << 1;
+    etcPutBits(hi, r0a, 2, 28);
+    etcPutBits(hi, t59, 1, 0);
+
+    CGU_UINT32 a   = etcGetBits(hi, 1, 28);
+    CGU_UINT32 b   = etcGetBits(hi, 1, 27);
+    CGU_UINT32 c   = etcGetBits(hi, 1, 25);
+    CGU_UINT32 d   = etcGetBits(hi, 1, 24);
+    CGU_UINT32 bit = (a & c) | ((1 - a) & b & c & d) | (a & b & (1 - c) & d);
+
+    etcPutBits(hi, bit ? 7 : 0, 3, 31);
+    etcPutBits(hi, !bit, 1, 26);
+    etcPutBits(hi, 1, 1, 1);
+}
+
+static void etcStuffH(CGU_UINT32& hi, CGU_UINT32 h58)
+{
+    hi = 0;
+    etcPutBits(hi, etcGetBits(h58, 7, 25), 7, 30);
+    etcPutBits(hi, etcGetBits(h58, 2, 18), 2, 20);
+    etcPutBits(hi, etcGetBits(h58, 16, 16), 16, 17);
+    etcPutBits(hi, etcGetBits(h58, 1, 0), 1, 0);
+
+    etcPutBits(hi, !etcGetBits(hi, 1, 30), 1, 31);
+
+    CGU_UINT32 a   = etcGetBits(hi, 1, 20);
+    CGU_UINT32 b   = etcGetBits(hi, 1, 19);
+    CGU_UINT32 c   = etcGetBits(hi, 1, 17);
+    CGU_UINT32 d   = etcGetBits(hi, 1, 16);
+    CGU_UINT32 bit = (a & c) | ((1 - a) & b & c & d) | (a & b & (1 - c) & d);
+
+    etcPutBits(hi, bit ? 7 : 0, 3, 23);
+    etcPutBits(hi, !bit, 1, 18);
+    etcPutBits(hi, 1, 1, 1);
+}
+
+static void etcStuffPlanar(CGU_UINT32& hi, CGU_UINT32& lo, CGU_UINT32 p57hi, CGU_UINT32 p57lo)
+{
+    hi = 0;
+    lo = 0;
+
+    etcPutBits(hi, etcGetBits(p57hi, 6, 31), 6, 30);  // RO
+    etcPutBits(hi, etcGetBits(p57hi, 1, 25), 1, 24);  // GO
+    etcPutBits(hi, etcGetBits(p57hi, 6, 24), 6, 22);
+    etcPutBits(hi, etcGetBits(p57hi, 1, 18), 1, 16);  // BO
+    etcPutBits(hi, etcGetBits(p57hi, 2, 17), 2, 12);
+    etcPutBits(hi, etcGetBits(p57hi, 3, 15), 3, 9);
+    etcPutBits(hi, etcGetBits(p57hi, 5, 12), 5, 6);  // RH
+    etcPutBits(hi, etcGetBits(p57hi, 1, 7), 1, 0);
+    etcPutBits(lo, etcGetBits(p57hi, 7, 6), 7, 31);   // GH
+    etcPutBits(lo, etcGetBits(p57lo, 6, 31), 6, 24);  // BH
+    etcPutBits(lo, etcGetBits(p57lo, 6, 25), 6, 18);  // RV
+    etcPutBits(lo, etcGetBits(p57lo, 7, 19), 7, 12);  // GV
+    etcPutBits(lo, etcGetBits(p57lo, 6, 12), 6, 5);   // BV
+
+    etcPutBits(hi, !etcGetBits(hi, 1, 30), 1, 31);
+    etcPutBits(hi, !etcGetBits(hi, 1, 22), 1, 23);
+
+    CGU_UINT32 a   = etcGetBits(hi, 1, 12);
+    CGU_UINT32 b   = etcGetBits(hi, 1, 11);
+    CGU_UINT32 c   = etcGetBits(hi, 1, 9);
+    CGU_UINT32 d   = etcGetBits(hi, 1, 8);
+    CGU_UINT32 bit = (a & c) | ((1 - a) & b & c & d) | (a & b & (1 - c) & d);
+
+    etcPutBits(hi, bit ? 7 : 0, 3, 15);
+    etcPutBits(hi, !bit, 1, 10);
+    etcPutBits(hi, 1, 1, 1);
+}
+
+static void etcPackETC2(CGU_UINT32& hi, CGU_UINT32& lo, const ETC2Encoding& enc, const ETCBlock& block)
+{
+    if (enc.mode == ETC_MODE_PLANAR)
+    {
+        CGU_UINT32 p57hi = 0;
+        CGU_UINT32 p57lo = 0;
+
+        etcPutBits(p57hi, (CGU_UINT32)enc.planar[0][0], 6, 31);
+        etcPutBits(p57hi, (CGU_UINT32)enc.planar[0][1], 7, 25);
+        etcPutBits(p57hi, (CGU_UINT32)enc.planar[0][2], 6, 18);
+        etcPutBits(p57hi, (CGU_UINT32)enc.planar[1][0], 6, 12);
+        etcPutBits(p57hi, (CGU_UINT32)enc.planar[1][1], 7, 6);
+        etcPutBits(p57lo, (CGU_UINT32)enc.planar[1][2], 6, 31);
+        etcPutBits(p57lo, (CGU_UINT32)enc.planar[2][0], 6, 25);
+        etcPutBits(p57lo, (CGU_UINT32)enc.planar[2][1], 7, 19);
+        etcPutBits(p57lo, (CGU_UINT32)enc.planar[2][2], 6, 12);
+
+        etcStuffPlanar(hi, lo, p57hi, p57lo);
+        return;
+    }
+
+    const CGU_INT* color0 = enc.colors[0];
+    const CGU_INT* color1 = enc.colors[1];
+
+    // the H mode stores the lowest distance bit in the order of the colors
+    if (enc.mode == ETC_MODE_H && (etcPackedColor444(color0) >= etcPackedColor444(color1)) != ((enc.distance & 1) != 0))
+    {
+        color0 = enc.colors[1];
+        color1 = enc.colors[0];
+    }
+
+    CGU_INT colors[4][3];
+    if (enc.mode == ETC_MODE_T)
+        etcTPalette(colors, color0, color1, enc.distance);
+    else
+        etcHPalette(colors, color0, color1, enc.distance);
+
+    CGU_INT indices[16];
+    etcPaletteIndices(indices, colors, &block.pixels[0][0], 16);
+
+    lo = 0;
+    for (CGU_INT i = 0; i < 16; i++)
+        etcSetIndex(lo, i, indices[i]);
+
+    CGU_UINT32 compact = 0;
+    CGU_INT    top     = enc.mode == ETC_MODE_T ? 26 : 25;
+
+    for (CGU_INT ch = 0; ch < 3; ch++)
+    {
+        etcPutBits(compact, (CGU_UINT32)color0[ch], 4, top - ch * 4);
+        etcPutBits(compact, (CGU_UINT32)color1[ch], 4, top - 12 - ch * 4);
+    }
+
+    if (enc.mode == ETC_MODE_T)
+    {
+        etcPutBits(compact, (CGU_UINT32)enc.distance, 3, 2);
+        etcStuffT(hi, compact);
+    }
+    else
+    {
+        etcPutBits(compact, (CGU_UINT32)(enc.distance >> 1), 2, 1);
+        etcStuffH(hi, compact);
+    }
+}
+
+//============================================== BLOCK ENCODING =======================================================
+
+static void etcStoreWords(CGU_UINT8 cmpBlock[8], CGU_UINT32 hi, CGU_UINT32 lo)
+{
+    for (CGU_INT i = 0; i < 4; i++)
+    {
+        cmpBlock[i]     = (CGU_UINT8)(hi >> (24 - i * 8));
+        cmpBlock[i + 4] = (CGU_UINT8)(lo >> (24 - i * 8));
+    }
+}
+
+static void etcLoadWords(CGU_UINT32& hi, CGU_UINT32& lo, const CGU_UINT8 cmpBlock[8])
+{
+    hi = ((CGU_UINT32)cmpBlock[0] << 24) | ((CGU_UINT32)cmpBlock[1] << 16) | ((CGU_UINT32)cmpBlock[2] << 8) | cmpBlock[3];
+    lo = ((CGU_UINT32)cmpBlock[4] << 24) | ((CGU_UINT32)cmpBlock[5] << 16) | ((CGU_UINT32)cmpBlock[6] << 8) | cmpBlock[7];
+}
+
+static void etcCompressColorBlock(CGU_UINT8 cmpBlock[8], const ETCBlock& block, CGU_BOOL etc2)
+{
+    if (!g_etcFunctionPointersSet)
+        etcToggleSIMD(EXTENSION_COUNT);
+
+    ETCPaletteBatch batch;
+
+    ETC1Encoding etc1;
+    etcSearchETC1(etc1, block, batch);
+
+    ETC2Encoding etc2Best;
+    etc2Best.mode  = ETC_MODE_ETC1;
+    etc2Best.error = etc1.error;
+
+    // the fast search only tries the T and H modes on blocks ETC1 does not already encode well
+    if (etc2)
+    {
+        if (!(block.fast && etc1.error < ETC_FAST_SKIP_ERROR))
+            etcSearchTH(etc2Best, block, batch);
+        etcSearchPlanar(etc2Best, block);
+    }
+
+    CGU_UINT32 hi, lo;
+    if (etc2Best.mode == ETC_MODE_ETC1)
+        etcPackETC1(hi, lo, etc1, block);
+    else
+        etcPackETC2(hi, lo, etc2Best, block);
+
+    etcStoreWords(cmpBlock, hi, lo);
+}
+
+// EAC alpha: a base value, a multiplier and one of sixteen tables of eight modifiers
+static void etcAlphaModifiers(CGU_INT modifiers[8], CGU_INT table)
+{
+    for (CGU_INT j = 0; j < 8; j++)
+    {
+        CGU_INT base = g_etcAlphaBase[table][3 - (j % 4)];
+        modifiers[j] = j < 4 ? base : -base - 1;
+    }
+}
+
+static void etcCompressAlphaBlock(CGU_UINT8 cmpBlock[8], const CGU_INT alpha[16], CGU_BOOL fast)
+{
+    CGU_INT minAlpha = 255;
+    CGU_INT maxAlpha = 0;
+    for (CGU_INT i = 0; i < 16; i++)
+    {
+        minAlpha = alpha[i] < minAlpha ? alpha[i] : minAlpha;
+        maxAlpha = alpha[i] > maxAlpha ? alpha[i] : maxAlpha;
+    }
+
+    // a constant block is stored with a zero multiplier, like etcpack
+    if (minAlpha == maxAlpha)
+    {
+        cmpBlock[0] = (CGU_UINT8)minAlpha;
+        for (CGU_INT i = 1; i < 8; i++)
+            cmpBlock[i] = 0;
+        return;
+    }
+
+    CGU_INT bestError = -1;
+    CGU_INT bestBase  = minAlpha;
+    CGU_INT bestMul   = 1;
+    CGU_INT bestTable = 0;
+
+    CGU_INT range = fast ? 0 : 1;
+
+    for (CGU_INT table = 0; table < 16 && bestError != 0; table++)
+    {
+        CGU_INT modifiers[8];
+        etcAlphaModifiers(modifiers, table);
+
+        CGU_INT lowest  = modifiers[3];
+        CGU_INT highest = modifiers[7];
+
+        CGU_INT mulCenter = (CGU_INT)((CGU_FLOAT)(maxAlpha - minAlpha) / (CGU_FLOAT)(highest - lowest) + 0.5f);
+
+        for (CGU_INT mul = mulCenter - range; mul <= mulCenter + range; mul++)
+        {
+            if (mul < 1 || mul > 15)
+                continue;
+
+            // center the modifier range on the alpha range
+            CGU_INT baseCenter = (CGU_INT)((CGU_FLOAT)(minAlpha + maxAlpha - (lowest + highest) * mul) * 0.5f + 0.5f);
+
+            for (CGU_INT base = baseCenter - range; base <= baseCenter + range; base++)
+            {
+                if (base < 0 || base > 255)
+                    continue;
+
+                CGU_INT error = 0;
+                for (CGU_INT i = 0; i < 16 && (bestError < 0 || error < bestError); i++)
+                {
+                    CGU_INT best = -1;
+                    for (CGU_INT j = 0; j < 8; j++)
+                    {
+                        CGU_INT d = etcClamp(base + modifiers[j] * mul) - alpha[i];
+                        if (best < 0 || d * d < best)
+                            best = d * d;
+                    }
+                    error += best;
+                }
+
+                if (bestError < 0 || error < bestError)
+                {
+                    bestError = error;
+                    bestBase  = base;
+                    bestMul   = mul;
+                    bestTable = table;
+                }
+            }
+        }
+    }
+
+    CGU_INT modifiers[8];
+    etcAlphaModifiers(modifiers, bestTable);
+
+    cmpBlock[0] = (CGU_UINT8)bestBase;
+    cmpBlock[1] = (CGU_UINT8)((bestMul << 4) | bestTable);
+
+    CGU_UINT64 indexBits = 0;
+    for (CGU_INT i = 0; i < 16; i++)
+    {
+        CGU_INT bestIndex = 0;
+        CGU_INT best      = -1;
+        for (CGU_INT j = 0; j < 8; j++)
+        {
+            CGU_INT d = etcClamp(bestBase + modifiers[j] * bestMul) - alpha[i];
+            if (best < 0 || d * d < best)
+            {
+                best      = d * d;
+                bestIndex = j;
+            }
+        }
+
+        indexBits = (indexBits << 3) | (CGU_UINT64)bestIndex;
+    }
+
+    for (CGU_INT i = 0; i < 6; i++)
+        cmpBlock[2 + i] = (CGU_UINT8)(indexBits >> (40 - i * 8));
+}
+
+//============================================== BLOCK DECODING =======================================================
+
+static void etcDecodeColorBlock(CGU_UINT8 rgba[64], const CGU_UINT8 cmpBlock[8], CGU_BOOL etc2)
+{
+    CGU_UINT32 hi, lo;
+    etcLoadWords(hi, lo, cmpBlock);
+
+    CGU_INT colors[16][3];  // in pixel index order x * 4 + y
+    CGU_INT palette[4][3];
+    CGU_INT mode = ETC_MODE_ETC1;
+
+    if (etc2 && etcGetBits(hi, 1, 1))
+    {
+        CGU_INT sums[3];
+        for (CGU_INT ch = 0; ch < 3; ch++)
+        {
+            CGU_INT delta = (CGU_INT)etcGetBits(hi, 3, 26 - ch * 8);
+            sums[ch]      = (CGU_INT)etcGetBits(hi, 5, 31 - ch * 8) + (delta >= 4 ? delta - 8 : delta);
+        }
+
+        if (sums[0] < 0 || sums[0] > 31)
+            mode = ETC_MODE_T;
+        else if (sums[1] < 0 || sums[1] > 31)
+            mode = ETC_MODE_H;
+        else if (sums[2] < 0 || sums[2] > 31)
+            mode = ETC_MODE_PLANAR;
+    }
+
+    if (mode == ETC_MODE_ETC1)
+    {
+        CGU_BOOL diff = etcGetBits(hi, 1, 1) != 0;
+        CGU_INT  flip = (CGU_INT)etcGetBits(hi, 1, 0);
+
+        CGU_INT pixelIds[2][8];
+        etcSubBlockPixels(pixelIds, flip);
+
+        for (CGU_INT sub = 0; sub < 2; sub++)
+        {
+            CGU_INT base[3];
+            for (CGU_INT ch = 0; ch < 3; ch++)
+            {
+                if (diff)
+                {
+                    CGU_INT c = (CGU_INT)etcGetBits(hi, 5, 31 - ch * 8);
+                    if (sub == 1)
+                    {
+                        CGU_INT delta = (CGU_INT)etcGetBits(hi, 3, 26 - ch * 8);
+                        c += delta >= 4 ? delta - 8 : delta;
+                    }
+                    base[ch] = etcExpand5(c & 31);
+                }
+                else
+                    base[ch] = etcExpand4((CGU_INT)etcGetBits(hi, 4, (sub ? 27 : 31) - ch * 8));
+            }
+
+            etcModifierPalette(palette, base, (CGU_INT)etcGetBits(hi, 3, sub ? 4 : 7));
+
+            for (CGU_INT i = 0; i < 8; i++)
+            {
+                CGU_INT j = pixelIds[sub][i];
+                for (CGU_INT ch = 0; ch < 3; ch++)
+                    colors[j][ch] = palette[etcGetIndex(lo, j)][ch];
+            }
+        }
+    }
+    else if (mode == ETC_MODE_PLANAR)
+    {
+        // undo the stuffing of etcStuffPlanar()
+        CGU_INT o[3], h[3], v[3];
+        o[0] = etcExpand6((CGU_INT)etcGetBits(hi, 6, 30));
+        o[1] = etcExpand7((CGU_INT)(etcGetBits(hi, 1, 24) << 6 | etcGetBits(hi, 6, 22)));
+        o[2] = etcExpand6((CGU_INT)(etcGetBits(hi, 1, 16) << 5 | etcGetBits(hi, 2, 12) << 3 | etcGetBits(hi, 3, 9)));
+        h[0] = etcExpand6((CGU_INT)(etcGetBits(hi, 5, 6) << 1 | etcGetBits(hi, 1, 0)));
+        h[1] = etcExpand7((CGU_INT)etcGetBits(lo, 7, 31));
+        h[2] = etcExpand6((CGU_INT)etcGetBits(lo, 6, 24));
+        v[0] = etcExpand6((CGU_INT)etcGetBits(lo, 6, 18));
+        v[1] = etcExpand7((CGU_INT)etcGetBits(lo, 7, 12));
+        v[2] = etcExpand6((CGU_INT)etcGetBits(lo, 6, 5));
+
+        for (CGU_INT j = 0; j < 16; j++)
+            for (CGU_INT ch = 0; ch < 3; ch++)
+                colors[j][ch] = etcPlanarValue(o[ch], h[ch], v[ch], j >> 2, j & 3);
+    }
+    else
+    {
+        CGU_INT color0[3], color1[3];
+        CGU_INT distance;
+
+        if (mode == ETC_MODE_T)
+        {
+            color0[0] = (CGU_INT)(etcGetBits(hi, 2, 28) << 2 | etcGetBits(hi, 2, 25));
+            color0[1] = (CGU_INT)etcGetBits(hi, 4, 23);
+            color0[2] = (CGU_INT)etcGetBits(hi, 4, 19);
+            color1[0] = (CGU_INT)etcGetBits(hi, 4, 15);
+            color1[1] = (CGU_INT)etcGetBits(hi, 4, 11);
+            color1[2] = (CGU_INT)etcGetBits(hi, 4, 7);
+            distance  = (CGU_INT)(etcGetBits(hi, 2, 3) << 1 | etcGetBits(hi, 1, 0));
+
+            etcTPalette(palette, color0, color1, distance);
+        }
+        else
+        {
+            color0[0] = (CGU_INT)etcGetBits(hi, 4, 30);
+            color0[1] = (CGU_INT)(etcGetBits(hi, 3, 26) << 1 | etcGetBits(hi, 1, 20));
+            color0[2] = (CGU_INT)(etcGetBits(hi, 1, 19) << 3 | etcGetBits(hi, 3, 17));
+            color1[0] = (CGU_INT)etcGetBits(hi, 4, 14);
+            color1[1] = (CGU_INT)etcGetBits(hi, 4, 10);
+            color1[2] = (CGU_INT)etcGetBits(hi, 4, 6);
+            distance  = (CGU_INT)(etcGetBits(hi, 1, 2) << 2 | etcGetBits(hi, 1, 0) << 1);
+
+            if (etcPackedColor444(color0) >= etcPackedColor444(color1))
+                distance |= 1;
+
+            etcHPalette(palette, color0, color1, distance);
+        }
+
+        for (CGU_INT j = 0; j < 16; j++)
+            for (CGU_INT ch = 0; ch < 3; ch++)
+                colors[j][ch] = palette[etcGetIndex(lo, j)][ch];
+    }
+
+    for (CGU_INT j = 0; j < 16; j++)
+    {
+        CGU_UINT8* pixel = &rgba[((j & 3) * 4 + (j >> 2)) * 4];
+        pixel[0]         = (CGU_UINT8)colors[j][0];
+        pixel[1]         = (CGU_UINT8)colors[j][1];
+        pixel[2]         = (CGU_UINT8)colors[j][2];
+        pixel[3]         = 255;
+    }
+}
+
+static void etcDecodeAlphaBlock(CGU_UINT8 rgba[64], const CGU_UINT8 cmpBlock[8])
+{
+    CGU_INT base  = cmpBlock[0];
+    CGU_INT mul   = cmpBlock[1] >> 4;
+    CGU_INT table = cmpBlock[1] & 15;
+
+    CGU_INT modifiers[8];
+    etcAlphaModifiers(modifiers, table);
+
+    CGU_UINT64 indexBits = 0;
+    for (CGU_INT i = 0; i < 6; i++)
+        indexBits = (indexBits << 8) | cmpBlock[2 + i];
+
+    for (CGU_INT j = 0; j < 16; j++)
+    {
+        CGU_INT index = (CGU_INT)(indexBits >> (45 - j * 3)) & 7;
+
+        rgba[((j & 3) * 4 + (j >> 2)) * 4 + 3] = (CGU_UINT8)etcClamp(base + modifiers[index] * mul);
+    }
+}
+
+//============================================== USER INTERFACES ========================================================
+
+static void SetDefaultETCOptions(CMP_ETCOptions* ETCOptions)
+{
+    if (ETCOptions)
+        ETCOptions->m_fquality = 1.0f;
+}
+
+// Reads a 4x4 RGBA:8888 block into pixel index order, alpha is optional
+static void etcLoadBlock(ETCBlock& block, CGU_INT alpha[16], const unsigned char* srcBlock, unsigned int srcStrideInBytes, const CMP_ETCOptions* ETCOptions)
+{
+    for (CGU_INT y = 0; y < 4; y++)
+    {
+        for (CGU_INT x = 0; x < 4; x++)
+        {
+            const unsigned char* pixel = srcBlock + y * srcStrideInBytes + x * 4;
+
+            block.pixels[x * 4 + y][0] = pixel[0];
+            block.pixels[x * 4 + y][1] = pixel[1];
+            block.pixels[x * 4 + y][2] = pixel[2];
+
+            if (alpha)
+                alpha[x * 4 + y] = pixel[3];
+        }
+    }
+
+    block.fast = ETCOptions->m_fquality < ETC_FAST_QUALITY;
+}
+
+int CMP_CDECL CreateOptionsETC(void** options)
+{
+    CMP_ETCOptions* ETCOptionsDefault = new CMP_ETCOptions;
+    if (ETCOptionsDefault)
+    {
+        SetDefaultETCOptions(ETCOptionsDefault);
+        (*options) = ETCOptionsDefault;
+    }
+    else
+    {
+        (*options) = NULL;
+        return CGU_CORE_ERR_NEWMEM;
+    }
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL DestroyOptionsETC(void* options)
+{
+    if (!options)
+        return CGU_CORE_ERR_INVALIDPTR;
+    CMP_ETCOptions* ETCOptions = reinterpret_cast<CMP_ETCOptions*>(options);
+    delete ETCOptions;
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL SetQualityETC(void* options, CGU_FLOAT fquality)
+{
+    if (!options)
+        return CGU_CORE_ERR_INVALIDPTR;
+    CMP_ETCOptions* ETCOptions = reinterpret_cast<CMP_ETCOptions*>(options);
+    if (fquality < 0.0f)
+        fquality = 0.0f;
+    else if (fquality > 1.0f)
+        fquality = 1.0f;
+    ETCOptions->m_fquality = fquality;
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL CompressBlockETC1(const unsigned char* srcBlock, unsigned int srcStrideInBytes, CMP_GLOBAL unsigned char cmpBlock[8], const void* options = NULL)
+{
+    CMP_ETCOptions* ETCOptions = (CMP_ETCOptions*)options;
+    CMP_ETCOptions  ETCOptionsDefault;
+    if (ETCOptions == NULL)
+    {
+        ETCOptions = &ETCOptionsDefault;
+        SetDefaultETCOptions(ETCOptions);
+    }
+
+    ETCBlock block;
+    etcLoadBlock(block, NULL, srcBlock, srcStrideInBytes, ETCOptions);
+    etcCompressColorBlock(cmpBlock, block, false);
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL CompressBlockETC2(const unsigned char* srcBlock, unsigned int srcStrideInBytes, CMP_GLOBAL unsigned char cmpBlock[8], const void* options = NULL)
+{
+    CMP_ETCOptions* ETCOptions = (CMP_ETCOptions*)options;
+    CMP_ETCOptions  ETCOptionsDefault;
+    if (ETCOptions == NULL)
+    {
+        ETCOptions = &ETCOptionsDefault;
+        SetDefaultETCOptions(ETCOptions);
+    }
+
+    ETCBlock block;
+    etcLoadBlock(block, NULL, srcBlock, srcStrideInBytes, ETCOptions);
+    etcCompressColorBlock(cmpBlock, block, true);
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL CompressBlockETC2RGBA(const unsigned char* srcBlock, unsigned int srcStrideInBytes, CMP_GLOBAL unsigned char cmpBlock[16], const void* options = NULL)
+{
+    CMP_ETCOptions* ETCOptions = (CMP_ETCOptions*)options;
+    CMP_ETCOptions  ETCOptionsDefault;
+    if (ETCOptions == NULL)
+    {
+        ETCOptions = &ETCOptionsDefault;
+        SetDefaultETCOptions(ETCOptions);
+    }
+
+    ETCBlock block;
+    CGU_INT  alpha[16];
+    etcLoadBlock(block, alpha, srcBlock, srcStrideInBytes, ETCOptions);
+    etcCompressAlphaBlock(cmpBlock, alpha, block.fast);
+    etcCompressColorBlock(cmpBlock + 8, block, true);
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL DecompressBlockETC1(const unsigned char cmpBlock[8], CMP_GLOBAL unsigned char srcBlock[64], const void* options = NULL)
+{
+    (void)options;
+    etcDecodeColorBlock(srcBlock, cmpBlock, false);
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL DecompressBlockETC2(const unsigned char cmpBlock[8], CMP_GLOBAL unsigned char srcBlock[64], const void* options = NULL)
+{
+    (void)options;
+    etcDecodeColorBlock(srcBlock, cmpBlock, true);
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL DecompressBlockETC2RGBA(const unsigned char cmpBlock[16], CMP_GLOBAL unsigned char srcBlock[64], const void* options = NULL)
+{
+    (void)options;
+    etcDecodeColorBlock(srcBlock, cmpBlock + 8, true);
+    etcDecodeAlphaBlock(srcBlock, cmpBlock);
+    return CGU_CORE_OK;
+}
+
+#endif
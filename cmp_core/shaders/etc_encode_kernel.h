@@ -0,0 +1,48 @@
+//=====================================================================
+// Copyright (c) 2024   Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+#ifndef ETC_ENCODE_KERNEL_H
+#define ETC_ENCODE_KERNEL_H
+
+#include "common_def.h"
+
+#define ETCCompBlockSize 8
+#define ETC2RGBACompBlockSize 16
+
+#ifndef ASPM_GPU
+// Quality below this uses the fast search: the T and H modes are skipped for blocks ETC1 already encodes well,
+// and the T, H and planar modes are fitted once instead of searched
+#define ETC_FAST_QUALITY 0.5f
+
+struct CMP_ETCOptions
+{
+    CGU_FLOAT m_fquality;
+};
+
+int ETCEnableSSE4();
+int ETCEnableAVX2();
+int ETCEnableAVX512();
+
+void ETCDisableSIMD();
+#endif
+
+#endif
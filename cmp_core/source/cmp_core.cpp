@@ -22,8 +22,29 @@
 //=====================================================================
 
 #include "bc1_encode_kernel.h"
+#include "bc4_encode_kernel.h"
+#include "etc_encode_kernel.h"
 #include "cpu_extensions.h"
 
+// from bc6_encode_kernel.h and bc7_encode_kernel.h, which conflict with the BC1 kernel headers
+int BC6EnableSSE4();
+int BC6EnableAVX2();
+int BC6EnableAVX512();
+
+void BC6DisableSIMD();
+
+int BC7EnableAVX2();
+int BC7EnableAVX512();
+
+void BC7DisableSIMD();
+
+// from cmp_core_decode.cpp
+int BCnDecodeEnableSSE4();
+int BCnDecodeEnableAVX2();
+int BCnDecodeEnableAVX512();
+
+void BCnDecodeDisableSIMD();
+
 enum SIMD_ENABLED_EXTENSIONS
 {
     SIMD_ENABLED_INVALID = -1,
@@ -39,6 +60,18 @@ int CMP_CDECL EnableSSE4()
 {
     int error = BC1EnableSSE4();
 
+    if (error == 0)
+        error = BC4EnableSSE4();
+    if (error == 0)
+        error = BC6EnableSSE4();
+    if (error == 0)
+        error = BCnDecodeEnableSSE4();
+    if (error == 0)
+        error = ETCEnableSSE4();
+
+    // BC7 has no SSE4 lane path, it falls back to the scalar encoder
+    BC7DisableSIMD();
+
     g_simdExtensionSet = error == 0 ? SIMD_ENABLED_SSE4 : g_simdExtensionSet;
 
     return error;
@@ -48,6 +81,17 @@ int CMP_CDECL EnableAVX2()
 {
     int error = BC1EnableAVX2();
 
+    if (error == 0)
+        error = BC4EnableAVX2();
+    if (error == 0)
+        error = BC6EnableAVX2();
+    if (error == 0)
+        error = BCnDecodeEnableAVX2();
+    if (error == 0)
+        error = ETCEnableAVX2();
+    if (error == 0)
+        error = BC7EnableAVX2();
+
     g_simdExtensionSet = error == 0 ? SIMD_ENABLED_AVX2 : g_simdExtensionSet;
 
     return error;
@@ -57,6 +101,17 @@ int CMP_CDECL EnableAVX512()
 {
     int error = BC1EnableAVX512();
 
+    if (error == 0)
+        error = BC4EnableAVX512();
+    if (error == 0)
+        error = BC6EnableAVX512();
+    if (error == 0)
+        error = BCnDecodeEnableAVX512();
+    if (error == 0)
+        error = ETCEnableAVX512();
+    if (error == 0)
+        error = BC7EnableAVX512();
+
     g_simdExtensionSet = error == 0 ? SIMD_ENABLED_AVX512 : g_simdExtensionSet;
 
     return error;
@@ -65,6 +120,11 @@ int CMP_CDECL EnableAVX512()
 int CMP_CDECL DisableSIMD()
 {
     BC1DisableSIMD();
+    BC4DisableSIMD();
+    BC6DisableSIMD();
+    BC7DisableSIMD();
+    BCnDecodeDisableSIMD();
+    ETCDisableSIMD();
 
     g_simdExtensionSet = SIMD_ENABLED_NONE;
 
@@ -65,6 +65,10 @@ int CMP_CDECL DestroyOptionsBC5(void* optionsBC5);
 int CMP_CDECL DestroyOptionsBC6(void* optionsBC6);
 int CMP_CDECL DestroyOptionsBC7(void* optionsBC7);
 
+// Context create and destroy for the ETC1, ETC2 RGB and ETC2 RGBA codecs
+int CMP_CDECL CreateOptionsETC(void** optionsETC);
+int CMP_CDECL DestroyOptionsETC(void* optionsETC);
+
 //======================================================================================================
 // Block level settings using the options Reference Pointers
 //======================================================================================================
@@ -88,6 +92,9 @@ int CMP_CDECL SetQualityBC5(void* options, float fquality);
 int CMP_CDECL SetQualityBC6(void* options, float fquality);
 int CMP_CDECL SetQualityBC7(void* options, float fquality);
 
+// ETC quality below 0.5 uses the fast search, which skips the ETC2 T and H modes for blocks ETC1 encodes well
+int CMP_CDECL SetQualityETC(void* options, float fquality);
+
 int CMP_CDECL SetAlphaThresholdBC1(void* options, unsigned char alphaThreshold);
 int CMP_CDECL SetRefineStepsBC1(void* options, unsigned int steps);
 
@@ -121,6 +128,11 @@ int CMP_CDECL SetSignedBC6(void* options, bool sf16);
 // but these functions allow users to manually override this process if desired.
 // Whichever instruction set was enabled most recently will be the one that is used. This means that calling
 // EnableSSE4() will overwrite any previous calls to EnableAVX512().
+// BC1 has SSE4, AVX2 and AVX-512 code paths. The unsigned BC4/BC5 and the BC6H endpoint searches have SSE4, AVX2
+// and AVX-512 code paths and the BC7 partition search has AVX2 and AVX-512 code paths, these produce the same
+// output as the scalar encoders. With SSE4 enabled BC7 uses the scalar encoder.
+// The DecompressBlocksBC1 to BC5 row decoders have SSE4 and AVX2 code paths, AVX-512 uses the AVX2 decoders.
+// The ETC1 and ETC2 palette searches have SSE4, AVX2 and AVX-512 code paths with the same output as the scalar encoder.
 
 // If the requested instruction set isn't supported on the CPU a > 0 value will be returned
 int CMP_CDECL EnableSSE4();
@@ -210,4 +222,260 @@ int CMP_CDECL DecompressBlockBC5S(const unsigned char cmpBlock[16], char srcBloc
 int CMP_CDECL CompressBlockBC6(const unsigned short* srcBlock, unsigned int srcStrideInShorts, unsigned char cmpBlock[16], const void* options CMP_DEFAULTNULL);
 int CMP_CDECL DecompressBlockBC6(const unsigned char cmpBlock[16], unsigned short srcBlock[48], const void* options CMP_DEFAULTNULL);
 
+//=========================================================================================================
+// Multiple block API: Compresses a rectangle of blocksX by blocksY (4x4) blocks in one call
+//=========================================================================================================
+// The source layouts match the single block API above, srcPitch is the distance between source pixel rows
+// and cmpPitchInBytes is the distance between rows of compressed blocks in the destination.
+// Options and SIMD settings are resolved once per call, and the results are identical to calling
+// CompressBlockBCn for each block.
+int CMP_CDECL CompressBlocksBC1(const unsigned char* srcBlocks,
+                                unsigned int         srcPitchInBytes,
+                                unsigned int         blocksX,
+                                unsigned int         blocksY,
+                                unsigned char*       cmpBlocks,
+                                unsigned int         cmpPitchInBytes,
+                                const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressBlocksBC2(const unsigned char* srcBlocks,
+                                unsigned int         srcPitchInBytes,
+                                unsigned int         blocksX,
+                                unsigned int         blocksY,
+                                unsigned char*       cmpBlocks,
+                                unsigned int         cmpPitchInBytes,
+                                const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressBlocksBC3(const unsigned char* srcBlocks,
+                                unsigned int         srcPitchInBytes,
+                                unsigned int         blocksX,
+                                unsigned int         blocksY,
+                                unsigned char*       cmpBlocks,
+                                unsigned int         cmpPitchInBytes,
+                                const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressBlocksBC4(const unsigned char* srcBlocks,
+                                unsigned int         srcPitchInBytes,
+                                unsigned int         blocksX,
+                                unsigned int         blocksY,
+                                unsigned char*       cmpBlocks,
+                                unsigned int         cmpPitchInBytes,
+                                const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressBlocksBC5(const unsigned char* srcBlocks1,
+                                unsigned int         srcPitchInBytes1,
+                                const unsigned char* srcBlocks2,
+                                unsigned int         srcPitchInBytes2,
+                                unsigned int         blocksX,
+                                unsigned int         blocksY,
+                                unsigned char*       cmpBlocks,
+                                unsigned int         cmpPitchInBytes,
+                                const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressBlocksBC6(const unsigned short* srcBlocks,
+                                unsigned int          srcPitchInShorts,
+                                unsigned int          blocksX,
+                                unsigned int          blocksY,
+                                unsigned char*        cmpBlocks,
+                                unsigned int          cmpPitchInBytes,
+                                const void* options   CMP_DEFAULTNULL);
+int CMP_CDECL CompressBlocksBC7(const unsigned char* srcBlocks,
+                                unsigned int         srcPitchInBytes,
+                                unsigned int         blocksX,
+                                unsigned int         blocksY,
+                                unsigned char*       cmpBlocks,
+                                unsigned int         cmpPitchInBytes,
+                                const void* options  CMP_DEFAULTNULL);
+
+// Decompresses a rectangle of blocksX by blocksY blocks straight into a pitched destination surface,
+// dstPitch is the distance between rows of destination pixels. The results are identical to calling
+// DecompressBlockBCn for each block. BC1, BC2, BC3 and BC7 write RGBA:8888 pixels, BC4 and BC5 write one
+// 8 bit channel per plane, and BC6 writes RGBA half floats with alpha set to 1.0 and the pitch in unsigned shorts.
+// BC1 to BC5 use SSE4 or AVX2 when enabled.
+int CMP_CDECL DecompressBlocksBC1(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressBlocksBC2(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressBlocksBC3(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressBlocksBC4(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressBlocksBC5(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks1,
+                                  unsigned int         dstPitchInBytes1,
+                                  unsigned char*       dstBlocks2,
+                                  unsigned int         dstPitchInBytes2,
+                                  const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressBlocksBC6(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned short*      dstBlocks,
+                                  unsigned int         dstPitchInShorts,
+                                  const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressBlocksBC7(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void* options  CMP_DEFAULTNULL);
+
+//=========================================================================================================
+// Image level API: Compresses or decompresses a whole image of width x height pixels
+//=========================================================================================================
+// Source and destination pitches are the distance between rows of pixels, cmpPitchInBytes is the distance
+// between rows of compressed blocks. Images need not be a multiple of 4 pixels in size, edge blocks are
+// compressed with their last pixel column and row repeated, and only the pixels inside the image are written
+// when decompressing. The rows of blocks are shared out to numThreads threads, 0 uses one thread per CPU core.
+// Pixel formats are the same as for the block level API above: RGBA:8888 for BC1, BC2, BC3 and BC7, one
+// 8 bit channel per plane for BC4 and BC5, and RGB half floats for BC6 with the pitch in unsigned shorts.
+int CMP_CDECL CompressImageBC1(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressImageBC2(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressImageBC3(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressImageBC4(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressImageBC5(const unsigned char* srcImage1,
+                               unsigned int         srcPitchInBytes1,
+                               const unsigned char* srcImage2,
+                               unsigned int         srcPitchInBytes2,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL CompressImageBC6(const unsigned short* srcImage,
+                               unsigned int          srcPitchInShorts,
+                               unsigned int          width,
+                               unsigned int          height,
+                               unsigned char*        cmpImage,
+                               unsigned int          cmpPitchInBytes,
+                               unsigned int          numThreads,
+                               const void* options   CMP_DEFAULTNULL);
+int CMP_CDECL CompressImageBC7(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void* options  CMP_DEFAULTNULL);
+
+int CMP_CDECL DecompressImageBC1(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressImageBC2(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressImageBC3(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressImageBC4(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressImageBC5(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage1,
+                                 unsigned int         dstPitchInBytes1,
+                                 unsigned char*       dstImage2,
+                                 unsigned int         dstPitchInBytes2,
+                                 unsigned int         numThreads,
+                                 const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressImageBC6(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned short*      dstImage,
+                                 unsigned int         dstPitchInShorts,
+                                 unsigned int         numThreads,
+                                 const void* options  CMP_DEFAULTNULL);
+int CMP_CDECL DecompressImageBC7(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void* options  CMP_DEFAULTNULL);
+
+//=========================================================================================================
+// ETC1, ETC2 RGB and ETC2 RGBA: 4 channel source RGBA:8888 4x4 block
+//=========================================================================================================
+// The compressed blocks use the GPU byte order, ETC2 RGBA stores the 8 byte EAC alpha block first.
+// ETC1 and ETC2 RGB ignore the source alpha and decode with alpha 255.
+int CMP_CDECL CompressBlockETC1(const unsigned char* srcBlock, unsigned int srcStrideInBytes, unsigned char cmpBlock[8], const void* options CMP_DEFAULTNULL);
+int CMP_CDECL CompressBlockETC2(const unsigned char* srcBlock, unsigned int srcStrideInBytes, unsigned char cmpBlock[8], const void* options CMP_DEFAULTNULL);
+int CMP_CDECL CompressBlockETC2RGBA(const unsigned char* srcBlock, unsigned int srcStrideInBytes, unsigned char cmpBlock[16], const void* options CMP_DEFAULTNULL);
+
+int CMP_CDECL DecompressBlockETC1(const unsigned char cmpBlock[8], unsigned char srcBlock[64], const void* options CMP_DEFAULTNULL);
+int CMP_CDECL DecompressBlockETC2(const unsigned char cmpBlock[8], unsigned char srcBlock[64], const void* options CMP_DEFAULTNULL);
+int CMP_CDECL DecompressBlockETC2RGBA(const unsigned char cmpBlock[16], unsigned char srcBlock[64], const void* options CMP_DEFAULTNULL);
+
 #endif  // CMP_CORE
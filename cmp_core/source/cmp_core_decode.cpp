@@ -0,0 +1,343 @@
+//=====================================================================
+// Copyright 2023-2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+// Multiple block DecompressBlocksBCn API for BC1 to BC5, rows of blocks are decoded straight into a pitched
+// destination surface with the SSE4 or AVX2 row decoders in core_simd_decode.h when available. The output is
+// identical to calling DecompressBlockBCn for each block.
+
+#include <string.h>
+
+#include "cmp_core.h"
+#include "common_def.h"
+#include "bcn_common_kernel.h"
+#include "cpu_extensions.h"
+#include "core_simd.h"
+
+CMP_STATIC CGU_BOOL g_bcnDecodeFunctionPointersSet = false;
+
+static CGU_UINT32 ReadUINT32(const unsigned char* p)
+{
+    return (CGU_UINT32)p[3] << 24 | (CGU_UINT32)p[2] << 16 | (CGU_UINT32)p[1] << 8 | (CGU_UINT32)p[0];
+}
+
+// Scalar versions of the row decoders in core_simd_decode.h
+
+static void _cpu_bcnDecodeColorBlocks(unsigned char*       dst,
+                                      unsigned int         dstPitch,
+                                      const unsigned char* cmpBlocks,
+                                      unsigned int         blockBytes,
+                                      int                  numBlocks,
+                                      bool                 mapDecodeRGBA,
+                                      bool                 isBC1)
+{
+    for (int block = 0; block < numBlocks; block++)
+    {
+        const unsigned char* cmpBlock = cmpBlocks + (size_t)block * blockBytes;
+        CGU_UINT32           indices  = ReadUINT32(cmpBlock + 4);
+        CGU_UINT32           palette[4];
+
+        cmp_getDXTRGBAPalette(palette, ReadUINT32(cmpBlock), mapDecodeRGBA, isBC1);
+
+        for (int i = 0; i < 16; i++)
+            memcpy(dst + (size_t)(i / 4) * dstPitch + (block * 4 + i % 4) * 4, &palette[(indices >> (2 * i)) & 3], 4);
+    }
+}
+
+static void _cpu_bcnDecodeAlphaBlocks(unsigned char*       dst,
+                                      unsigned int         dstPitch,
+                                      unsigned int         pixelBytes,
+                                      const unsigned char* cmpBlocks,
+                                      unsigned int         blockBytes,
+                                      int                  numBlocks)
+{
+    for (int block = 0; block < numBlocks; block++)
+    {
+        const unsigned char* cmpBlock = cmpBlocks + (size_t)block * blockBytes;
+        CGU_UINT32           alphaBlock[2];
+        CGU_UINT8            ramp[8];
+
+        alphaBlock[0] = ReadUINT32(cmpBlock);
+        alphaBlock[1] = ReadUINT32(cmpBlock + 4);
+        cmp_getCompressedAlphaRamp(ramp, alphaBlock);
+
+        // 3 bit indices, 8 per 24 bits
+        CGU_UINT8 alpha[16];
+        for (int half = 0; half < 2; half++)
+        {
+            CGU_UINT32 bits = (CGU_UINT32)cmpBlock[2 + half * 3] | (CGU_UINT32)cmpBlock[3 + half * 3] << 8 | (CGU_UINT32)cmpBlock[4 + half * 3] << 16;
+            for (int i = 0; i < 8; i++)
+                alpha[half * 8 + i] = ramp[(bits >> (3 * i)) & 7];
+        }
+
+        // the alpha is the last byte of each pixel, the only byte for single channel pixels
+        for (int row = 0; row < 4; row++)
+        {
+            unsigned char* dstRow = dst + (size_t)row * dstPitch + block * 4 * pixelBytes;
+            if (pixelBytes == 1)
+                memcpy(dstRow, &alpha[row * 4], 4);
+            else
+                for (int col = 0; col < 4; col++)
+                    dstRow[col * 4 + 3] = alpha[row * 4 + col];
+        }
+    }
+}
+
+static void _cpu_bcnDecodeExplicitAlphaBlocks(unsigned char* dst, unsigned int dstPitch, const unsigned char* cmpBlocks, unsigned int blockBytes, int numBlocks)
+{
+    for (int block = 0; block < numBlocks; block++)
+    {
+        const unsigned char* cmpBlock = cmpBlocks + (size_t)block * blockBytes;
+
+        for (int i = 0; i < 16; i++)
+        {
+            unsigned char alpha = (cmpBlock[i / 2] >> (4 * (i & 1))) & 0x0F;
+            dst[(size_t)(i / 4) * dstPitch + (block * 4 + i % 4) * 4 + 3] = (unsigned char)((alpha << 4) | alpha);
+        }
+    }
+}
+
+CMP_STATIC void (*cpu_bcnDecodeColorBlocks)(unsigned char*, unsigned int, const unsigned char*, unsigned int, int, bool, bool) = _cpu_bcnDecodeColorBlocks;
+CMP_STATIC void (*cpu_bcnDecodeAlphaBlocks)(unsigned char*, unsigned int, unsigned int, const unsigned char*, unsigned int, int) = _cpu_bcnDecodeAlphaBlocks;
+CMP_STATIC void (*cpu_bcnDecodeExplicitAlphaBlocks)(unsigned char*, unsigned int, const unsigned char*, unsigned int, int) = _cpu_bcnDecodeExplicitAlphaBlocks;
+
+// Toggle which SIMD instruction set extensions to use. Setting this to EXTENSION_COUNT will enable auto-detection of supported extensions.
+// The decoders only shuffle bytes within 128 bit lanes, so AVX-512 uses the AVX2 code.
+CMP_STATIC bool bcnDecodeToggleSIMD(CGU_INT newExtension)
+{
+    CGU_BOOL useAVX512 = true;
+    CGU_BOOL useAVX2   = true;
+    CGU_BOOL useSSE4   = true;
+
+    CPUExtensions extensions = GetCPUExtensions();
+
+    if (newExtension < EXTENSION_COUNT)  // user requested a specific instruction set extension
+    {
+        useAVX512 = newExtension == EXTENSION_AVX512_F;
+        useAVX2   = newExtension == EXTENSION_AVX2;
+        useSSE4   = newExtension == EXTENSION_SSE42;
+    }
+
+#ifndef __APPLE__
+    if ((useAVX512 && IsAvailableAVX512(extensions)) || (useAVX2 && IsAvailableAVX2(extensions)))
+    {
+        cpu_bcnDecodeColorBlocks         = avx_bcnDecodeColorBlocks;
+        cpu_bcnDecodeAlphaBlocks         = avx_bcnDecodeAlphaBlocks;
+        cpu_bcnDecodeExplicitAlphaBlocks = avx_bcnDecodeExplicitAlphaBlocks;
+    }
+    else if (useSSE4 && IsAvailableSSE4(extensions))
+    {
+        cpu_bcnDecodeColorBlocks         = sse_bcnDecodeColorBlocks;
+        cpu_bcnDecodeAlphaBlocks         = sse_bcnDecodeAlphaBlocks;
+        cpu_bcnDecodeExplicitAlphaBlocks = sse_bcnDecodeExplicitAlphaBlocks;
+    }
+    else
+#endif
+    {
+        cpu_bcnDecodeColorBlocks         = _cpu_bcnDecodeColorBlocks;
+        cpu_bcnDecodeAlphaBlocks         = _cpu_bcnDecodeAlphaBlocks;
+        cpu_bcnDecodeExplicitAlphaBlocks = _cpu_bcnDecodeExplicitAlphaBlocks;
+    }
+
+    g_bcnDecodeFunctionPointersSet = true;
+
+    if (newExtension == EXTENSION_AVX512_F)
+        return IsAvailableAVX512(extensions);
+    if (newExtension == EXTENSION_AVX2)
+        return IsAvailableAVX2(extensions);
+    if (newExtension == EXTENSION_SSE42)
+        return IsAvailableSSE4(extensions);
+
+    return true;
+}
+
+int BCnDecodeEnableSSE4()
+{
+    bool result = bcnDecodeToggleSIMD(EXTENSION_SSE42);
+
+    return result ? 0 : 1;
+}
+
+int BCnDecodeEnableAVX2()
+{
+    bool result = bcnDecodeToggleSIMD(EXTENSION_AVX2);
+
+    return result ? 0 : 1;
+}
+
+int BCnDecodeEnableAVX512()
+{
+    bool result = bcnDecodeToggleSIMD(EXTENSION_AVX512_F);
+
+    return result ? 0 : 1;
+}
+
+void BCnDecodeDisableSIMD()
+{
+    bcnDecodeToggleSIMD(EXTENSION_NONE);
+}
+
+static bool GetMapDecodeRGBA(const void* options)
+{
+    if (options == NULL)
+    {
+        CMP_BC15Options BC15optionsDefault;
+        SetDefaultBC15Options(&BC15optionsDefault);
+        return BC15optionsDefault.m_mapDecodeRGBA != 0;
+    }
+
+    return ((const CMP_BC15Options*)options)->m_mapDecodeRGBA != 0;
+}
+
+int CMP_CDECL DecompressBlocksBC1(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void*          options)
+{
+    if ((cmpBlocks == NULL) || (dstBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    if (!g_bcnDecodeFunctionPointersSet)
+        bcnDecodeToggleSIMD(EXTENSION_COUNT);
+
+    bool mapDecodeRGBA = GetMapDecodeRGBA(options);
+
+    for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+        cpu_bcnDecodeColorBlocks(dstBlocks + (size_t)blockY * 4 * dstPitchInBytes,
+                                 dstPitchInBytes,
+                                 cmpBlocks + (size_t)blockY * cmpPitchInBytes,
+                                 8,
+                                 blocksX,
+                                 mapDecodeRGBA,
+                                 true);
+
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL DecompressBlocksBC2(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void*          options)
+{
+    if ((cmpBlocks == NULL) || (dstBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    if (!g_bcnDecodeFunctionPointersSet)
+        bcnDecodeToggleSIMD(EXTENSION_COUNT);
+
+    bool mapDecodeRGBA = GetMapDecodeRGBA(options);
+
+    for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+    {
+        const unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+        unsigned char*       dstRow = dstBlocks + (size_t)blockY * 4 * dstPitchInBytes;
+
+        cpu_bcnDecodeColorBlocks(dstRow, dstPitchInBytes, cmpRow + 8, 16, blocksX, mapDecodeRGBA, false);
+        cpu_bcnDecodeExplicitAlphaBlocks(dstRow, dstPitchInBytes, cmpRow, 16, blocksX);
+    }
+
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL DecompressBlocksBC3(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void*          options)
+{
+    if ((cmpBlocks == NULL) || (dstBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    if (!g_bcnDecodeFunctionPointersSet)
+        bcnDecodeToggleSIMD(EXTENSION_COUNT);
+
+    bool mapDecodeRGBA = GetMapDecodeRGBA(options);
+
+    for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+    {
+        const unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+        unsigned char*       dstRow = dstBlocks + (size_t)blockY * 4 * dstPitchInBytes;
+
+        cpu_bcnDecodeColorBlocks(dstRow, dstPitchInBytes, cmpRow + 8, 16, blocksX, mapDecodeRGBA, false);
+        cpu_bcnDecodeAlphaBlocks(dstRow, dstPitchInBytes, 4, cmpRow, 16, blocksX);
+    }
+
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL DecompressBlocksBC4(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks,
+                                  unsigned int         dstPitchInBytes,
+                                  const void*          options)
+{
+    (void)options;
+
+    if ((cmpBlocks == NULL) || (dstBlocks == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    if (!g_bcnDecodeFunctionPointersSet)
+        bcnDecodeToggleSIMD(EXTENSION_COUNT);
+
+    for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+        cpu_bcnDecodeAlphaBlocks(dstBlocks + (size_t)blockY * 4 * dstPitchInBytes, dstPitchInBytes, 1, cmpBlocks + (size_t)blockY * cmpPitchInBytes, 8, blocksX);
+
+    return CGU_CORE_OK;
+}
+
+int CMP_CDECL DecompressBlocksBC5(const unsigned char* cmpBlocks,
+                                  unsigned int         cmpPitchInBytes,
+                                  unsigned int         blocksX,
+                                  unsigned int         blocksY,
+                                  unsigned char*       dstBlocks1,
+                                  unsigned int         dstPitchInBytes1,
+                                  unsigned char*       dstBlocks2,
+                                  unsigned int         dstPitchInBytes2,
+                                  const void*          options)
+{
+    (void)options;
+
+    if ((cmpBlocks == NULL) || (dstBlocks1 == NULL) || (dstBlocks2 == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    if (!g_bcnDecodeFunctionPointersSet)
+        bcnDecodeToggleSIMD(EXTENSION_COUNT);
+
+    for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+    {
+        const unsigned char* cmpRow = cmpBlocks + (size_t)blockY * cmpPitchInBytes;
+
+        cpu_bcnDecodeAlphaBlocks(dstBlocks1 + (size_t)blockY * 4 * dstPitchInBytes1, dstPitchInBytes1, 1, cmpRow, 16, blocksX);
+        cpu_bcnDecodeAlphaBlocks(dstBlocks2 + (size_t)blockY * 4 * dstPitchInBytes2, dstPitchInBytes2, 1, cmpRow + 8, 16, blocksX);
+    }
+
+    return CGU_CORE_OK;
+}
@@ -0,0 +1,589 @@
+//=====================================================================
+// Copyright (c) 2024    Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+// Image level CompressImageBCn and DecompressImageBCn API, the image is split into rows of blocks
+// that are shared out to a set of threads. Full blocks are compressed with the CompressBlocksBCn API and
+// decompressed with the DecompressBlocksBCn API, blocks on the right and bottom edges are padded by
+// repeating the last pixel column and row.
+
+#include <atomic>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "cmp_core.h"
+#include "common_def.h"
+
+// Runs processRow(blockRow) for every row of blocks, on numThreads threads including the calling thread.
+// The first row that fails stops the threads from claiming new rows and its status is returned.
+template <typename ProcessRow>
+static int ProcessBlockRows(unsigned int blockRows, unsigned int numThreads, ProcessRow processRow)
+{
+    if (numThreads == 0)
+        numThreads = std::thread::hardware_concurrency();
+    if (numThreads > blockRows)
+        numThreads = blockRows;
+
+    std::atomic<unsigned int> nextRow(0);
+    std::atomic<int>          status(CGU_CORE_OK);
+    auto                      worker = [&]() {
+        unsigned int blockRow;
+        while ((status.load() == CGU_CORE_OK) && ((blockRow = nextRow.fetch_add(1)) < blockRows))
+        {
+            int rowStatus = processRow(blockRow);
+            if (rowStatus != CGU_CORE_OK)
+            {
+                int expected = CGU_CORE_OK;
+                status.compare_exchange_strong(expected, rowStatus);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < numThreads; i++)
+        threads.push_back(std::thread(worker));
+
+    worker();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    return status;
+}
+
+// Copies the 4x4 block at pixel (x, y) into block, edge pixels are repeated for the part outside of the image
+template <typename T>
+static void GetEdgeBlock(const T*     src,
+                         unsigned int srcPitch,
+                         unsigned int channels,
+                         unsigned int x,
+                         unsigned int y,
+                         unsigned int width,
+                         unsigned int height,
+                         T*           block)
+{
+    for (unsigned int row = 0; row < 4; row++)
+    {
+        unsigned int srcY   = (y + row < height) ? y + row : height - 1;
+        const T*     srcRow = src + (size_t)srcY * srcPitch;
+        for (unsigned int col = 0; col < 4; col++)
+        {
+            unsigned int srcX = (x + col < width) ? x + col : width - 1;
+            memcpy(&block[(row * 4 + col) * channels], &srcRow[srcX * channels], channels * sizeof(T));
+        }
+    }
+}
+
+// Copies the part of the decompressed 4x4 block at pixel (x, y) that lies inside of the image
+template <typename T>
+static void SetEdgeBlock(const T*     block,
+                         unsigned int channels,
+                         unsigned int x,
+                         unsigned int y,
+                         unsigned int width,
+                         unsigned int height,
+                         T*           dst,
+                         unsigned int dstPitch)
+{
+    unsigned int rows = (height - y < 4) ? height - y : 4;
+    unsigned int cols = (width - x < 4) ? width - x : 4;
+    for (unsigned int row = 0; row < rows; row++)
+        memcpy(dst + (size_t)(y + row) * dstPitch + x * channels, &block[row * 4 * channels], cols * channels * sizeof(T));
+}
+
+// Compresses one row of blocks of a single plane image, pitches are in units of T
+template <typename T, typename CompressBlocks, typename CompressBlock>
+static int CompressImageRow(const T*       src,
+                             unsigned int   srcPitch,
+                             unsigned int   channels,
+                             unsigned int   width,
+                             unsigned int   height,
+                             unsigned int   blockRow,
+                             unsigned char* cmp,
+                             unsigned int   cmpPitch,
+                             unsigned int   blockBytes,
+                             CompressBlocks compressBlocks,
+                             CompressBlock  compressBlock)
+{
+    unsigned int   blocksX   = (width + 3) / 4;
+    unsigned int   fullX     = (blockRow * 4 + 4 <= height) ? width / 4 : 0;
+    const T*       srcRow    = src + (size_t)blockRow * 4 * srcPitch;
+    unsigned char* cmpRow    = cmp + (size_t)blockRow * cmpPitch;
+    T              block[64] = {};
+
+    int status = (fullX > 0) ? compressBlocks(srcRow, srcPitch, fullX, cmpRow, cmpPitch) : CGU_CORE_OK;
+
+    for (unsigned int blockX = fullX; (blockX < blocksX) && (status == CGU_CORE_OK); blockX++)
+    {
+        GetEdgeBlock(src, srcPitch, channels, blockX * 4, blockRow * 4, width, height, block);
+        status = compressBlock(block, 4 * channels, cmpRow + blockX * blockBytes);
+    }
+
+    return status;
+}
+
+// Decompresses one row of blocks of a single plane image, dstPitch is in units of T
+template <typename T, typename DecompressBlock>
+static int DecompressImageRow(const unsigned char* cmp,
+                               unsigned int         cmpPitch,
+                               unsigned int         blockBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned int         blockRow,
+                               T*                   dst,
+                               unsigned int         dstPitch,
+                               unsigned int         channels,
+                               DecompressBlock      decompressBlock)
+{
+    unsigned int         blocksX = (width + 3) / 4;
+    const unsigned char* cmpRow  = cmp + (size_t)blockRow * cmpPitch;
+    T                    block[64];
+
+    for (unsigned int blockX = 0; blockX < blocksX; blockX++)
+    {
+        int status = decompressBlock(cmpRow + blockX * blockBytes, block);
+        if (status != CGU_CORE_OK)
+            return status;
+        SetEdgeBlock(block, channels, blockX * 4, blockRow * 4, width, height, dst, dstPitch);
+    }
+
+    return CGU_CORE_OK;
+}
+
+// Decompresses one row of blocks of a single plane image, the blocks that lie fully inside of the image are
+// decoded straight into dst with decompressBlocks, dstPitch is in units of T
+template <typename T, typename DecompressBlocks, typename DecompressBlock>
+static int DecompressImageRow(const unsigned char* cmp,
+                               unsigned int         cmpPitch,
+                               unsigned int         blockBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned int         blockRow,
+                               T*                   dst,
+                               unsigned int         dstPitch,
+                               unsigned int         channels,
+                               DecompressBlocks     decompressBlocks,
+                               DecompressBlock      decompressBlock)
+{
+    unsigned int         blocksX = (width + 3) / 4;
+    unsigned int         fullX   = (blockRow * 4 + 4 <= height) ? width / 4 : 0;
+    const unsigned char* cmpRow  = cmp + (size_t)blockRow * cmpPitch;
+    T                    block[64];
+
+    if (fullX > 0)
+    {
+        int status = decompressBlocks(cmpRow, fullX, dst + (size_t)blockRow * 4 * dstPitch, dstPitch);
+        if (status != CGU_CORE_OK)
+            return status;
+    }
+
+    for (unsigned int blockX = fullX; blockX < blocksX; blockX++)
+    {
+        int status = decompressBlock(cmpRow + blockX * blockBytes, block);
+        if (status != CGU_CORE_OK)
+            return status;
+        SetEdgeBlock(block, channels, blockX * 4, blockRow * 4, width, height, dst, dstPitch);
+    }
+
+    return CGU_CORE_OK;
+}
+
+//======================================================================================================
+// RGBA:8888 sources BC1, BC2, BC3 and BC7
+//======================================================================================================
+
+typedef int(CMP_CDECL* CompressBlocksRGBA_Proc)(const unsigned char*, unsigned int, unsigned int, unsigned int, unsigned char*, unsigned int, const void*);
+typedef int(CMP_CDECL* CompressBlockRGBA_Proc)(const unsigned char*, unsigned int, unsigned char*, const void*);
+typedef int(CMP_CDECL* DecompressBlocksRGBA_Proc)(const unsigned char*, unsigned int, unsigned int, unsigned int, unsigned char*, unsigned int, const void*);
+typedef int(CMP_CDECL* DecompressBlockRGBA_Proc)(const unsigned char*, unsigned char*, const void*);
+
+static int CompressImageRGBA(const unsigned char*    srcImage,
+                             unsigned int            srcPitchInBytes,
+                             unsigned int            width,
+                             unsigned int            height,
+                             unsigned char*          cmpImage,
+                             unsigned int            cmpPitchInBytes,
+                             unsigned int            numThreads,
+                             const void*             options,
+                             unsigned int            blockBytes,
+                             CompressBlocksRGBA_Proc compressBlocks,
+                             CompressBlockRGBA_Proc  compressBlock)
+{
+    if ((srcImage == NULL) || (cmpImage == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    return ProcessBlockRows((height + 3) / 4, numThreads, [&](unsigned int blockRow) {
+        return CompressImageRow(
+            srcImage,
+            srcPitchInBytes,
+            4,
+            width,
+            height,
+            blockRow,
+            cmpImage,
+            cmpPitchInBytes,
+            blockBytes,
+            [&](const unsigned char* src, unsigned int srcPitch, unsigned int blocksX, unsigned char* cmp, unsigned int cmpPitch) {
+                return compressBlocks(src, srcPitch, blocksX, 1, cmp, cmpPitch, options);
+            },
+            [&](const unsigned char* block, unsigned int blockPitch, unsigned char* cmp) { return compressBlock(block, blockPitch, cmp, options); });
+    });
+}
+
+static int DecompressImageRGBA(const unsigned char*      cmpImage,
+                               unsigned int              cmpPitchInBytes,
+                               unsigned int              width,
+                               unsigned int              height,
+                               unsigned char*            dstImage,
+                               unsigned int              dstPitchInBytes,
+                               unsigned int              numThreads,
+                               const void*               options,
+                               unsigned int              blockBytes,
+                               DecompressBlocksRGBA_Proc decompressBlocks,
+                               DecompressBlockRGBA_Proc  decompressBlock)
+{
+    if ((cmpImage == NULL) || (dstImage == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    return ProcessBlockRows((height + 3) / 4, numThreads, [&](unsigned int blockRow) {
+        return DecompressImageRow(cmpImage,
+                                  cmpPitchInBytes,
+                                  blockBytes,
+                                  width,
+                                  height,
+                                  blockRow,
+                                  dstImage,
+                                  dstPitchInBytes,
+                                  4,
+                                  [&](const unsigned char* cmp, unsigned int blocksX, unsigned char* dst, unsigned int dstPitch) {
+                                      return decompressBlocks(cmp, cmpPitchInBytes, blocksX, 1, dst, dstPitch, options);
+                                  },
+                                  [&](const unsigned char* cmp, unsigned char* block) { return decompressBlock(cmp, block, options); });
+    });
+}
+
+int CMP_CDECL CompressImageBC1(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void*          options)
+{
+    return CompressImageRGBA(
+        srcImage, srcPitchInBytes, width, height, cmpImage, cmpPitchInBytes, numThreads, options, 8, CompressBlocksBC1, CompressBlockBC1);
+}
+
+int CMP_CDECL CompressImageBC2(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void*          options)
+{
+    return CompressImageRGBA(
+        srcImage, srcPitchInBytes, width, height, cmpImage, cmpPitchInBytes, numThreads, options, 16, CompressBlocksBC2, CompressBlockBC2);
+}
+
+int CMP_CDECL CompressImageBC3(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void*          options)
+{
+    return CompressImageRGBA(
+        srcImage, srcPitchInBytes, width, height, cmpImage, cmpPitchInBytes, numThreads, options, 16, CompressBlocksBC3, CompressBlockBC3);
+}
+
+int CMP_CDECL CompressImageBC7(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void*          options)
+{
+    return CompressImageRGBA(
+        srcImage, srcPitchInBytes, width, height, cmpImage, cmpPitchInBytes, numThreads, options, 16, CompressBlocksBC7, CompressBlockBC7);
+}
+
+int CMP_CDECL DecompressImageBC1(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void*          options)
+{
+    return DecompressImageRGBA(cmpImage, cmpPitchInBytes, width, height, dstImage, dstPitchInBytes, numThreads, options, 8, DecompressBlocksBC1, DecompressBlockBC1);
+}
+
+int CMP_CDECL DecompressImageBC2(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void*          options)
+{
+    return DecompressImageRGBA(cmpImage, cmpPitchInBytes, width, height, dstImage, dstPitchInBytes, numThreads, options, 16, DecompressBlocksBC2, DecompressBlockBC2);
+}
+
+int CMP_CDECL DecompressImageBC3(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void*          options)
+{
+    return DecompressImageRGBA(cmpImage, cmpPitchInBytes, width, height, dstImage, dstPitchInBytes, numThreads, options, 16, DecompressBlocksBC3, DecompressBlockBC3);
+}
+
+int CMP_CDECL DecompressImageBC7(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void*          options)
+{
+    return DecompressImageRGBA(cmpImage, cmpPitchInBytes, width, height, dstImage, dstPitchInBytes, numThreads, options, 16, DecompressBlocksBC7, DecompressBlockBC7);
+}
+
+//======================================================================================================
+// Single and dual channel sources BC4 and BC5
+//======================================================================================================
+
+int CMP_CDECL CompressImageBC4(const unsigned char* srcImage,
+                               unsigned int         srcPitchInBytes,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void*          options)
+{
+    if ((srcImage == NULL) || (cmpImage == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    return ProcessBlockRows((height + 3) / 4, numThreads, [&](unsigned int blockRow) {
+        return CompressImageRow(
+            srcImage,
+            srcPitchInBytes,
+            1,
+            width,
+            height,
+            blockRow,
+            cmpImage,
+            cmpPitchInBytes,
+            8,
+            [&](const unsigned char* src, unsigned int srcPitch, unsigned int blocksX, unsigned char* cmp, unsigned int cmpPitch) {
+                return CompressBlocksBC4(src, srcPitch, blocksX, 1, cmp, cmpPitch, options);
+            },
+            [&](const unsigned char* block, unsigned int blockPitch, unsigned char* cmp) { return CompressBlockBC4(block, blockPitch, cmp, options); });
+    });
+}
+
+int CMP_CDECL DecompressImageBC4(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage,
+                                 unsigned int         dstPitchInBytes,
+                                 unsigned int         numThreads,
+                                 const void*          options)
+{
+    if ((cmpImage == NULL) || (dstImage == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    return ProcessBlockRows((height + 3) / 4, numThreads, [&](unsigned int blockRow) {
+        return DecompressImageRow(cmpImage,
+                                  cmpPitchInBytes,
+                                  8,
+                                  width,
+                                  height,
+                                  blockRow,
+                                  dstImage,
+                                  dstPitchInBytes,
+                                  1,
+                                  [&](const unsigned char* cmp, unsigned int blocksX, unsigned char* dst, unsigned int dstPitch) {
+                                      return DecompressBlocksBC4(cmp, cmpPitchInBytes, blocksX, 1, dst, dstPitch, options);
+                                  },
+                                  [&](const unsigned char* cmp, unsigned char* block) { return DecompressBlockBC4(cmp, block, options); });
+    });
+}
+
+int CMP_CDECL CompressImageBC5(const unsigned char* srcImage1,
+                               unsigned int         srcPitchInBytes1,
+                               const unsigned char* srcImage2,
+                               unsigned int         srcPitchInBytes2,
+                               unsigned int         width,
+                               unsigned int         height,
+                               unsigned char*       cmpImage,
+                               unsigned int         cmpPitchInBytes,
+                               unsigned int         numThreads,
+                               const void*          options)
+{
+    if ((srcImage1 == NULL) || (srcImage2 == NULL) || (cmpImage == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    return ProcessBlockRows((height + 3) / 4, numThreads, [&](unsigned int blockRow) {
+        unsigned int         blocksX = (width + 3) / 4;
+        unsigned int         fullX   = (blockRow * 4 + 4 <= height) ? width / 4 : 0;
+        const unsigned char* srcRow1 = srcImage1 + (size_t)blockRow * 4 * srcPitchInBytes1;
+        const unsigned char* srcRow2 = srcImage2 + (size_t)blockRow * 4 * srcPitchInBytes2;
+        unsigned char*       cmpRow  = cmpImage + (size_t)blockRow * cmpPitchInBytes;
+
+        int status = CGU_CORE_OK;
+        if (fullX > 0)
+            status = CompressBlocksBC5(srcRow1, srcPitchInBytes1, srcRow2, srcPitchInBytes2, fullX, 1, cmpRow, cmpPitchInBytes, options);
+
+        unsigned char block1[16];
+        unsigned char block2[16];
+        for (unsigned int blockX = fullX; (blockX < blocksX) && (status == CGU_CORE_OK); blockX++)
+        {
+            GetEdgeBlock(srcImage1, srcPitchInBytes1, 1, blockX * 4, blockRow * 4, width, height, block1);
+            GetEdgeBlock(srcImage2, srcPitchInBytes2, 1, blockX * 4, blockRow * 4, width, height, block2);
+            status = CompressBlockBC5(block1, 4, block2, 4, cmpRow + blockX * 16, options);
+        }
+
+        return status;
+    });
+}
+
+int CMP_CDECL DecompressImageBC5(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned char*       dstImage1,
+                                 unsigned int         dstPitchInBytes1,
+                                 unsigned char*       dstImage2,
+                                 unsigned int         dstPitchInBytes2,
+                                 unsigned int         numThreads,
+                                 const void*          options)
+{
+    if ((cmpImage == NULL) || (dstImage1 == NULL) || (dstImage2 == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    return ProcessBlockRows((height + 3) / 4, numThreads, [&](unsigned int blockRow) {
+        unsigned int         blocksX = (width + 3) / 4;
+        unsigned int         fullX   = (blockRow * 4 + 4 <= height) ? width / 4 : 0;
+        const unsigned char* cmpRow  = cmpImage + (size_t)blockRow * cmpPitchInBytes;
+
+        int status = CGU_CORE_OK;
+        if (fullX > 0)
+            status = DecompressBlocksBC5(cmpRow,
+                                         cmpPitchInBytes,
+                                         fullX,
+                                         1,
+                                         dstImage1 + (size_t)blockRow * 4 * dstPitchInBytes1,
+                                         dstPitchInBytes1,
+                                         dstImage2 + (size_t)blockRow * 4 * dstPitchInBytes2,
+                                         dstPitchInBytes2,
+                                         options);
+
+        unsigned char block1[16];
+        unsigned char block2[16];
+        for (unsigned int blockX = fullX; (blockX < blocksX) && (status == CGU_CORE_OK); blockX++)
+        {
+            status = DecompressBlockBC5(cmpRow + blockX * 16, block1, block2, options);
+            if (status != CGU_CORE_OK)
+                break;
+            SetEdgeBlock(block1, 1, blockX * 4, blockRow * 4, width, height, dstImage1, dstPitchInBytes1);
+            SetEdgeBlock(block2, 1, blockX * 4, blockRow * 4, width, height, dstImage2, dstPitchInBytes2);
+        }
+
+        return status;
+    });
+}
+
+//======================================================================================================
+// RGB half float source BC6H
+//======================================================================================================
+
+int CMP_CDECL CompressImageBC6(const unsigned short* srcImage,
+                               unsigned int          srcPitchInShorts,
+                               unsigned int          width,
+                               unsigned int          height,
+                               unsigned char*        cmpImage,
+                               unsigned int          cmpPitchInBytes,
+                               unsigned int          numThreads,
+                               const void*           options)
+{
+    if ((srcImage == NULL) || (cmpImage == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    return ProcessBlockRows((height + 3) / 4, numThreads, [&](unsigned int blockRow) {
+        return CompressImageRow(
+            srcImage,
+            srcPitchInShorts,
+            3,
+            width,
+            height,
+            blockRow,
+            cmpImage,
+            cmpPitchInBytes,
+            16,
+            [&](const unsigned short* src, unsigned int srcPitch, unsigned int blocksX, unsigned char* cmp, unsigned int cmpPitch) {
+                return CompressBlocksBC6(src, srcPitch, blocksX, 1, cmp, cmpPitch, options);
+            },
+            [&](const unsigned short* block, unsigned int blockPitch, unsigned char* cmp) { return CompressBlockBC6(block, blockPitch, cmp, options); });
+    });
+}
+
+int CMP_CDECL DecompressImageBC6(const unsigned char* cmpImage,
+                                 unsigned int         cmpPitchInBytes,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned short*      dstImage,
+                                 unsigned int         dstPitchInShorts,
+                                 unsigned int         numThreads,
+                                 const void*          options)
+{
+    if ((cmpImage == NULL) || (dstImage == NULL))
+        return CGU_CORE_ERR_INVALIDPTR;
+
+    return ProcessBlockRows((height + 3) / 4, numThreads, [&](unsigned int blockRow) {
+        return DecompressImageRow(cmpImage,
+                                  cmpPitchInBytes,
+                                  16,
+                                  width,
+                                  height,
+                                  blockRow,
+                                  dstImage,
+                                  dstPitchInShorts,
+                                  3,
+                                  [&](const unsigned char* cmp, unsigned short* block) { return DecompressBlockBC6(cmp, block, options); });
+    });
+}
@@ -30,4 +30,48 @@ float sse_bc1ComputeBestEndpoints(float*, float*, float*, float*, float*, int, i
 float avx_bc1ComputeBestEndpoints(float*, float*, float*, float*, float*, int, int);
 float avx512_bc1ComputeBestEndpoints(float*, float*, float*, float*, float*, int, int);
 
+// BC1 to BC3 block batches
+
+unsigned int sse_bc1CompressBlocksMinMax(unsigned char*, unsigned int, const unsigned char*, int);
+unsigned int avx_bc1CompressBlocksMinMax(unsigned char*, unsigned int, const unsigned char*, int);
+unsigned int avx512_bc1CompressBlocksMinMax(unsigned char*, unsigned int, const unsigned char*, int);
+void         sse_bc3CompressAlphaBlocksMinMax(unsigned char*, unsigned int, const unsigned char*, int);
+void         avx_bc3CompressAlphaBlocksMinMax(unsigned char*, unsigned int, const unsigned char*, int);
+void         avx512_bc3CompressAlphaBlocksMinMax(unsigned char*, unsigned int, const unsigned char*, int);
+void         sse_bc2CompressExplicitAlphaBlocks(unsigned char*, unsigned int, const unsigned char*, int);
+void         avx_bc2CompressExplicitAlphaBlocks(unsigned char*, unsigned int, const unsigned char*, int);
+void         avx512_bc2CompressExplicitAlphaBlocks(unsigned char*, unsigned int, const unsigned char*, int);
+
+// BC1 to BC5 decoding
+
+void sse_bcnDecodeColorBlocks(unsigned char*, unsigned int, const unsigned char*, unsigned int, int, bool, bool);
+void avx_bcnDecodeColorBlocks(unsigned char*, unsigned int, const unsigned char*, unsigned int, int, bool, bool);
+void sse_bcnDecodeAlphaBlocks(unsigned char*, unsigned int, unsigned int, const unsigned char*, unsigned int, int);
+void avx_bcnDecodeAlphaBlocks(unsigned char*, unsigned int, unsigned int, const unsigned char*, unsigned int, int);
+void sse_bcnDecodeExplicitAlphaBlocks(unsigned char*, unsigned int, const unsigned char*, unsigned int, int);
+void avx_bcnDecodeExplicitAlphaBlocks(unsigned char*, unsigned int, const unsigned char*, unsigned int, int);
+
+// BC4, BC5
+
+void sse_bc4RampErrors(float*, const float*, const float*, int, const float*, const float*, int);
+void avx_bc4RampErrors(float*, const float*, const float*, int, const float*, const float*, int);
+void avx512_bc4RampErrors(float*, const float*, const float*, int, const float*, const float*, int);
+
+// BC6H
+
+float sse_bc6ShakeEndpointCube(int*, float*, int*, const float*, int, const float*, int, const float*, int);
+float avx_bc6ShakeEndpointCube(int*, float*, int*, const float*, int, const float*, int, const float*, int);
+float avx512_bc6ShakeEndpointCube(int*, float*, int*, const float*, int, const float*, int, const float*, int);
+
+// BC7
+
+void avx_bc7QuantizePartitions(float*, unsigned char*, const float*, const unsigned int*, int, int, int, int);
+void avx512_bc7QuantizePartitions(float*, unsigned char*, const float*, const unsigned int*, int, int, int, int);
+
+// ETC1, ETC2
+
+void sse_etcPaletteErrors(float*, const float*, int, const float*, int, const float*);
+void avx_etcPaletteErrors(float*, const float*, int, const float*, int, const float*);
+void avx512_etcPaletteErrors(float*, const float*, int, const float*, int, const float*);
+
 #endif
\ No newline at end of file
@@ -26,6 +26,12 @@
 #include <immintrin.h>
 
 #include "core_simd.h"
+#include "core_simd_bc1.h"
+#include "core_simd_bc4.h"
+#include "core_simd_bc6.h"
+#include "core_simd_bc7.h"
+#include "core_simd_etc.h"
+#include "core_simd_decode.h"
 #include "common_def.h"
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -161,4 +167,193 @@ CGU_FLOAT avx_bc1ComputeBestEndpoints(CGU_FLOAT endpointsOut[2],
     return minError;
 }
 
+// Lane types for the lane generic BC1 to BC3, BC4, BC6H, BC7 and ETC code
+
+struct AVX2Lanes
+{
+    typedef __m256  vf;
+    typedef __m256  vm;
+    typedef __m256i vi;
+
+    static const int Lanes = 8;
+
+    static inline vf zero() { return _mm256_setzero_ps(); }
+    static inline vf set1(float a) { return _mm256_set1_ps(a); }
+    static inline vf load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void store(float* p, vf a) { _mm256_storeu_ps(p, a); }
+
+    static inline vi loadPixels(const unsigned char* p, unsigned int stride)
+    {
+        return _mm256_i32gather_epi32((const int*)p, _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((int)stride)), 1);
+    }
+    static inline vf channel(vi a, int shift) { return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(a, _mm_cvtsi32_si128(shift)), _mm256_set1_epi32(0xFF))); }
+
+    static inline vf add(vf a, vf b) { return _mm256_add_ps(a, b); }
+    static inline vf sub(vf a, vf b) { return _mm256_sub_ps(a, b); }
+    static inline vf mul(vf a, vf b) { return _mm256_mul_ps(a, b); }
+    static inline vf div(vf a, vf b) { return _mm256_div_ps(a, b); }
+    static inline vf min(vf a, vf b) { return _mm256_min_ps(a, b); }
+    static inline vf max(vf a, vf b) { return _mm256_max_ps(a, b); }
+    static inline vf sqrt(vf a) { return _mm256_sqrt_ps(a); }
+    static inline vf floor(vf a) { return _mm256_floor_ps(a); }
+    static inline vf ceil(vf a) { return _mm256_ceil_ps(a); }
+    static inline vf trunc(vf a) { return _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+    static inline vm lt(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static inline vm le(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static inline vm gt(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static inline vm ge(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static inline vm eq(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static inline vm neq(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+    static inline vm isNaN(vf a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+
+    static inline vm mand(vm a, vm b) { return _mm256_and_ps(a, b); }
+    static inline vm mor(vm a, vm b) { return _mm256_or_ps(a, b); }
+    static inline vm mandnot(vm a, vm b) { return _mm256_andnot_ps(b, a); }
+    static inline vm mnot(vm a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+    static inline bool any(vm a) { return _mm256_movemask_ps(a) != 0; }
+    static inline int bits(vm a) { return _mm256_movemask_ps(a); }
+
+    static inline vf select(vm m, vf a, vf b) { return _mm256_blendv_ps(b, a, m); }
+};
+
+// Lane type for the BC1 to BC5 row decoders, two blocks per vector, one in each 128 bit lane
+
+struct AVX2DecodeLanes
+{
+    typedef __m256i vi;
+
+    static const int Blocks = 2;
+
+    static inline vi constant(const unsigned char* c) { return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)c)); }
+    static inline vi load8(const unsigned char* p, unsigned int stride)
+    {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadl_epi64((const __m128i*)p)), _mm_loadl_epi64((const __m128i*)(p + stride)), 1);
+    }
+    static inline vi loadRow(const unsigned char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static inline void storeRow(unsigned char* p, vi a) { _mm256_storeu_si256((__m256i*)p, a); }
+    static inline void storeRowR8(unsigned char* p, vi a, int row)
+    {
+        unsigned char bytes[32];
+        _mm256_storeu_si256((__m256i*)bytes, a);
+        memcpy(p, bytes + row * 4, 4);
+        memcpy(p + 4, bytes + 16 + row * 4, 4);
+    }
+
+    static inline vi shuffle8(vi a, vi ctrl) { return _mm256_shuffle_epi8(a, ctrl); }
+    static inline vi and_(vi a, vi b) { return _mm256_and_si256(a, b); }
+    static inline vi or_(vi a, vi b) { return _mm256_or_si256(a, b); }
+    static inline vi add8(vi a, vi b) { return _mm256_add_epi8(a, b); }
+    static inline vi add16(vi a, vi b) { return _mm256_add_epi16(a, b); }
+    static inline vi mullo16(vi a, vi b) { return _mm256_mullo_epi16(a, b); }
+    static inline vi mulhi16(vi a, vi b) { return _mm256_mulhi_epu16(a, b); }
+    static inline vi packus16(vi a, vi b) { return _mm256_packus_epi16(a, b); }
+    static inline vi slli16(vi a, int n) { return _mm256_sll_epi16(a, _mm_cvtsi32_si128(n)); }
+    static inline vi srli16(vi a, int n) { return _mm256_srl_epi16(a, _mm_cvtsi32_si128(n)); }
+
+    static inline vi gt16(vi a, vi b) { return _mm256_cmpgt_epi16(a, b); }
+    static inline vi eq16(vi a, vi b) { return _mm256_cmpeq_epi16(a, b); }
+    static inline vi maxu16(vi a, vi b) { return _mm256_max_epu16(a, b); }
+    static inline vi select(vi m, vi a, vi b) { return _mm256_blendv_epi8(b, a, m); }
+};
+
+// BC1 to BC3 block batches
+
+unsigned int avx_bc1CompressBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    return bc1CompressBlocksMinMax<AVX2Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+void avx_bc3CompressAlphaBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    bc3CompressAlphaBlocksMinMax<AVX2Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+void avx_bc2CompressExplicitAlphaBlocks(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    bc2CompressExplicitAlphaBlocks<AVX2Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+// BC1 to BC5 decoding
+
+void avx_bcnDecodeColorBlocks(unsigned char*       dst,
+                              unsigned int         dstPitch,
+                              const unsigned char* cmpBlocks,
+                              unsigned int         blockBytes,
+                              int                  numBlocks,
+                              bool                 mapDecodeRGBA,
+                              bool                 isBC1)
+{
+    bcnDecodeColorBlocks<AVX2DecodeLanes>(dst, dstPitch, cmpBlocks, blockBytes, numBlocks, mapDecodeRGBA, isBC1);
+}
+
+void avx_bcnDecodeAlphaBlocks(unsigned char*       dst,
+                              unsigned int         dstPitch,
+                              unsigned int         pixelBytes,
+                              const unsigned char* cmpBlocks,
+                              unsigned int         blockBytes,
+                              int                  numBlocks)
+{
+    bcnDecodeAlphaBlocks<AVX2DecodeLanes>(dst, dstPitch, pixelBytes, cmpBlocks, blockBytes, numBlocks);
+}
+
+void avx_bcnDecodeExplicitAlphaBlocks(unsigned char* dst, unsigned int dstPitch, const unsigned char* cmpBlocks, unsigned int blockBytes, int numBlocks)
+{
+    bcnDecodeExplicitAlphaBlocks<AVX2DecodeLanes>(dst, dstPitch, cmpBlocks, blockBytes, numBlocks);
+}
+
+// BC4, BC5
+
+void avx_bc4RampErrors(float*       errors,
+                       const float* lows,
+                       const float* highs,
+                       int          numRamps,
+                       const float* values,
+                       const float* repeats,
+                       int          numValues)
+{
+    bc4RampErrors<AVX2Lanes>(errors, lows, highs, numRamps, values, repeats, numValues);
+}
+
+// BC6H
+
+float avx_bc6ShakeEndpointCube(int*         idx_out,
+                               float*       out,
+                               int*         s1_out,
+                               const float* data,
+                               int          numEntries,
+                               const float* rampWeights,
+                               int          clusters,
+                               const float* epd,
+                               int          channels3or4)
+{
+    return bc6ShakeEndpointCube<AVX2Lanes>(idx_out, out, s1_out, data, numEntries, rampWeights, clusters, epd, channels3or4);
+}
+
+// BC7
+
+void avx_bc7QuantizePartitions(float*              storedError,
+                               unsigned char*      storedBestindex,
+                               const float*        image_src,
+                               const unsigned int* subsetMasks,
+                               int                 maxSubsets,
+                               int                 numPartitions,
+                               int                 clusters,
+                               int                 channels3or4)
+{
+    bc7QuantizePartitions<AVX2Lanes>(storedError, storedBestindex, image_src, subsetMasks, maxSubsets, numPartitions, clusters, channels3or4);
+}
+
+// ETC1, ETC2
+
+void avx_etcPaletteErrors(float*       errors,
+                          const float* palettes,
+                          int          numPalettes,
+                          const float* pixels,
+                          int          numPixels,
+                          const float* weights)
+{
+    etcPaletteErrors<AVX2Lanes>(errors, palettes, numPalettes, pixels, numPixels, weights);
+}
+
 #endif
@@ -26,6 +26,11 @@
 #include <immintrin.h>
 
 #include "core_simd.h"
+#include "core_simd_bc1.h"
+#include "core_simd_bc4.h"
+#include "core_simd_bc6.h"
+#include "core_simd_bc7.h"
+#include "core_simd_etc.h"
 #include "common_def.h"
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -139,4 +144,134 @@ CGU_FLOAT avx512_bc1ComputeBestEndpoints(CGU_FLOAT endpointsOut[2],
     return minError;
 }
 
+// Lane types for the lane generic BC1 to BC3, BC4, BC6H, BC7 and ETC code
+
+struct AVX512Lanes
+{
+    typedef __m512    vf;
+    typedef __mmask16 vm;
+    typedef __m512i   vi;
+
+    static const int Lanes = 16;
+
+    // The unmasked forms of gather, shift, convert, min, max, sqrt and roundscale are built on _mm512_undefined_*,
+    // which GCC 12 reports as maybe uninitialized once inlined. The zero masked forms with every lane set are the
+    // same instructions without the warning.
+    static const vm All = 0xFFFF;
+
+    static inline vf zero() { return _mm512_setzero_ps(); }
+    static inline vf set1(float a) { return _mm512_set1_ps(a); }
+    static inline vf load(const float* p) { return _mm512_loadu_ps(p); }
+    static inline void store(float* p, vf a) { _mm512_storeu_ps(p, a); }
+
+    static inline vi loadPixels(const unsigned char* p, unsigned int stride)
+    {
+        const vi lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        return _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), All, _mm512_mullo_epi32(lanes, _mm512_set1_epi32((int)stride)), (const void*)p, 1);
+    }
+    static inline vf channel(vi a, int shift)
+    {
+        return _mm512_maskz_cvtepi32_ps(All, _mm512_and_si512(_mm512_maskz_srl_epi32(All, a, _mm_cvtsi32_si128(shift)), _mm512_set1_epi32(0xFF)));
+    }
+
+    static inline vf add(vf a, vf b) { return _mm512_add_ps(a, b); }
+    static inline vf sub(vf a, vf b) { return _mm512_sub_ps(a, b); }
+    static inline vf mul(vf a, vf b) { return _mm512_mul_ps(a, b); }
+    static inline vf div(vf a, vf b) { return _mm512_div_ps(a, b); }
+    static inline vf min(vf a, vf b) { return _mm512_maskz_min_ps(All, a, b); }
+    static inline vf max(vf a, vf b) { return _mm512_maskz_max_ps(All, a, b); }
+    static inline vf sqrt(vf a) { return _mm512_maskz_sqrt_ps(All, a); }
+    static inline vf floor(vf a) { return _mm512_maskz_roundscale_ps(All, a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static inline vf ceil(vf a) { return _mm512_maskz_roundscale_ps(All, a, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+    static inline vf trunc(vf a) { return _mm512_maskz_roundscale_ps(All, a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+    static inline vm lt(vf a, vf b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static inline vm le(vf a, vf b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static inline vm gt(vf a, vf b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static inline vm ge(vf a, vf b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static inline vm eq(vf a, vf b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static inline vm neq(vf a, vf b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+    static inline vm isNaN(vf a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+
+    static inline vm mand(vm a, vm b) { return _mm512_kand(a, b); }
+    static inline vm mor(vm a, vm b) { return _mm512_kor(a, b); }
+    static inline vm mandnot(vm a, vm b) { return _mm512_kandn(b, a); }
+    static inline vm mnot(vm a) { return _mm512_knot(a); }
+    static inline bool any(vm a) { return a != 0; }
+    static inline int bits(vm a) { return (int)a; }
+
+    static inline vf select(vm m, vf a, vf b) { return _mm512_mask_blend_ps(m, b, a); }
+};
+
+// BC1 to BC3 block batches
+
+unsigned int avx512_bc1CompressBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    return bc1CompressBlocksMinMax<AVX512Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+void avx512_bc3CompressAlphaBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    bc3CompressAlphaBlocksMinMax<AVX512Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+void avx512_bc2CompressExplicitAlphaBlocks(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    bc2CompressExplicitAlphaBlocks<AVX512Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+// BC4, BC5
+
+void avx512_bc4RampErrors(float*       errors,
+                          const float* lows,
+                          const float* highs,
+                          int          numRamps,
+                          const float* values,
+                          const float* repeats,
+                          int          numValues)
+{
+    bc4RampErrors<AVX512Lanes>(errors, lows, highs, numRamps, values, repeats, numValues);
+}
+
+// BC6H
+
+float avx512_bc6ShakeEndpointCube(int*         idx_out,
+                                  float*       out,
+                                  int*         s1_out,
+                                  const float* data,
+                                  int          numEntries,
+                                  const float* rampWeights,
+                                  int          clusters,
+                                  const float* epd,
+                                  int          channels3or4)
+{
+    return bc6ShakeEndpointCube<AVX512Lanes>(idx_out, out, s1_out, data, numEntries, rampWeights, clusters, epd, channels3or4);
+}
+
+// BC7
+
+void avx512_bc7QuantizePartitions(float*              storedError,
+                                  unsigned char*      storedBestindex,
+                                  const float*        image_src,
+                                  const unsigned int* subsetMasks,
+                                  int                 maxSubsets,
+                                  int                 numPartitions,
+                                  int                 clusters,
+                                  int                 channels3or4)
+{
+    bc7QuantizePartitions<AVX512Lanes>(storedError, storedBestindex, image_src, subsetMasks, maxSubsets, numPartitions, clusters, channels3or4);
+}
+
+// ETC1, ETC2
+
+void avx512_etcPaletteErrors(float*       errors,
+                             const float* palettes,
+                             int          numPalettes,
+                             const float* pixels,
+                             int          numPixels,
+                             const float* weights)
+{
+    etcPaletteErrors<AVX512Lanes>(errors, palettes, numPalettes, pixels, numPixels, weights);
+}
+
 #endif
@@ -0,0 +1,315 @@
+//=====================================================================
+// Copyright 2023-2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#ifndef CORE_SIMD_BC1_H_
+#define CORE_SIMD_BC1_H_
+
+#include <string.h>
+
+// Lane generic versions of the min max block encoders used by the low quality settings of the BC1, BC2
+// and BC3 encoders, used by the CompressBlocksBC1/BC2/BC3 loops:
+//   bc1CompressBlocksMinMax         cgu_CompressRGBBlock_MinMax() from bc1_cmp.h, which is also the
+//                                   low quality path of CompressRGBBlock_FM() in bcn_common_kernel.h
+//   bc3CompressAlphaBlocksMinMax    cmp_getLinearEndPoints() and cmp_getBlockPackedIndices() below
+//                                   CMP_QUALITY2 for unsigned alpha
+//   bc2CompressExplicitAlphaBlocks  cmp_compressExplicitAlphaBlock()
+//
+// Each SIMD lane encodes one block, so a call encodes a whole batch of gathered blocks. The source blocks
+// are 16 RGBA:8888 pixels each, the compressed 8 byte blocks are written cmpBlockBytes apart. The
+// arithmetic is performed in the same order as the scalar code, so the compressed blocks are bit identical.
+// Packed indices are summed in float lanes in fields of at most 24 bits, which keeps the sums exact.
+//
+// The including file provides a lane type V with, in addition to the members used by core_simd_bc4.h:
+//   vi                      integer vector type
+//   loadPixels(p, stride)   the 32 bit pixel at p + lane * stride of each lane
+//   channel(px, shift)      the byte (px >> shift) & 0xFF of each lane, as float
+//   min, max, ceil, trunc, eq, mand, bits (lane mask as an int)
+
+#define BC1_SIMD_MAX_LANES 16
+#define BC1_SIMD_BLOCK_BYTES 64
+
+// std::round(), rounds half way cases away from zero
+template <class V, class vf = typename V::vf>
+static inline vf bc1Round(vf a)
+{
+    const vf one = V::set1(1.0f);
+
+    vf whole    = V::trunc(a);
+    vf fraction = V::sub(a, whole);
+
+    whole = V::add(whole, V::select(V::ge(fraction, V::set1(0.5f)), one, V::zero()));
+    return V::sub(whole, V::select(V::le(fraction, V::set1(-0.5f)), one, V::zero()));
+}
+
+// The blocks of the lanes starting at srcBlocks, a batch that does not fill all lanes is padded with copies
+// of its first block
+template <class V>
+static const unsigned char* bc1LaneBlocks(unsigned char padded[BC1_SIMD_MAX_LANES * BC1_SIMD_BLOCK_BYTES], const unsigned char* srcBlocks, int numBlocks)
+{
+    if (numBlocks >= V::Lanes)
+        return srcBlocks;
+
+    for (int i = 0; i < V::Lanes; i++)
+        memcpy(padded + i * BC1_SIMD_BLOCK_BYTES, srcBlocks + (i < numBlocks ? i : 0) * BC1_SIMD_BLOCK_BYTES, BC1_SIMD_BLOCK_BYTES);
+
+    return padded;
+}
+
+template <class V>
+static void bc1StoreBlock(unsigned char* cmpBlock, unsigned int x, unsigned int y)
+{
+    unsigned int block[2] = {x, y};
+    memcpy(cmpBlock, block, sizeof(block));
+}
+
+// Returns a bit mask of the blocks whose pixels all have the same RGB color, the BC1 encoder replaces
+// those with cgu_solidColorBlock()
+template <class V, class vf = typename V::vf, class vm = typename V::vm, class vi = typename V::vi>
+static unsigned int bc1CompressBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    const vf zero      = V::zero();
+    const vf one       = V::set1(1.0f);
+    const vf three     = V::set1(3.0f);
+    const vf quarter   = V::set1(0.25f);
+    const vf scale[3]  = {V::set1(31.0f), V::set1(63.0f), V::set1(31.0f)};
+    const vf rgbTo565  = V::set1(2048.0f);
+    const vf gTo565    = V::set1(32.0f);
+    const vf byteToUNorm = V::set1(255.0f);
+
+    unsigned int solidBlocks = 0;
+
+    for (int first = 0; first < numBlocks; first += V::Lanes)
+    {
+        int lanes = numBlocks - first < V::Lanes ? numBlocks - first : V::Lanes;
+
+        unsigned char        padded[BC1_SIMD_MAX_LANES * BC1_SIMD_BLOCK_BYTES];
+        const unsigned char* blocks = bc1LaneBlocks<V>(padded, srcBlocks + first * BC1_SIMD_BLOCK_BYTES, lanes);
+
+        // (1) source colors 0..1 and their min max box
+        vf block[16][3];
+        vf srcMin[3] = {one, one, one};
+        vf srcMax[3] = {zero, zero, zero};
+
+        for (int i = 0; i < 16; i++)
+        {
+            vi pixel = V::loadPixels(blocks + i * 4, BC1_SIMD_BLOCK_BYTES);
+
+            for (int c = 0; c < 3; c++)
+            {
+                block[i][c] = V::div(V::channel(pixel, c * 8), byteToUNorm);
+                srcMin[c]   = V::min(srcMin[c], block[i][c]);
+                srcMax[c]   = V::max(srcMax[c], block[i][c]);
+            }
+        }
+
+        vm solid = V::mand(V::mand(V::eq(srcMin[0], srcMax[0]), V::eq(srcMin[1], srcMax[1])), V::eq(srcMin[2], srcMax[2]));
+
+        // (2) cmp_ProcessColors() min max processing, the box is moved out to the 565 grid
+        vf minColor[3];
+        vf maxColor[3];
+        vf c0 = zero;
+        vf c1 = zero;
+
+        for (int c = 0; c < 3; c++)
+        {
+            vf minScaled = V::floor(V::mul(srcMin[c], scale[c]));
+            vf maxScaled = V::ceil(V::mul(srcMax[c], scale[c]));
+
+            minColor[c] = V::div(minScaled, scale[c]);
+            maxColor[c] = V::div(maxScaled, scale[c]);
+
+            const vf shift = c == 0 ? rgbTo565 : (c == 1 ? gTo565 : one);
+            c0             = V::add(c0, V::mul(minScaled, shift));
+            c1             = V::add(c1, V::mul(maxScaled, shift));
+        }
+
+        vm hasRange = V::lt(c0, c1);
+
+        // (3) cmp_getIndicesRGB(), project each color on to the diagonal of the box
+        vf range[3];
+        for (int c = 0; c < 3; c++)
+            range[c] = V::sub(minColor[c], maxColor[c]);
+
+        vf rangeDot = V::add(V::add(V::mul(range[0], range[0]), V::mul(range[1], range[1])), V::mul(range[2], range[2]));
+        vf maxDot   = V::add(V::add(V::mul(maxColor[0], maxColor[0]), V::mul(maxColor[1], maxColor[1])), V::mul(maxColor[2], maxColor[2]));
+        vf minDot   = V::add(V::add(V::mul(maxColor[0], minColor[0]), V::mul(maxColor[1], minColor[1])), V::mul(maxColor[2], minColor[2]));
+
+        // lanes without a range divide by zero, they are not used
+        vf rangeScale = V::div(three, rangeDot);
+        vf bias       = V::mul(V::sub(maxDot, minDot), rangeScale);
+        for (int c = 0; c < 3; c++)
+            range[c] = V::mul(range[c], rangeScale);
+
+        vf indices[2] = {zero, zero};
+        vf weight     = one;
+
+        for (int i = 0; i < 16; i++)
+        {
+            vf diff =
+                V::add(V::add(V::add(V::mul(block[i][0], range[0]), V::mul(block[i][1], range[1])), V::mul(block[i][2], range[2])), bias);
+
+            // ((CGU_UINT32)round(diff)) & 0x3, then remapped with {0, 2, 3, 1}
+            vf index = bc1Round<V>(diff);
+            index    = V::sub(index, V::mul(V::floor(V::mul(index, quarter)), V::set1(4.0f)));
+            index    = V::select(V::eq(index, V::set1(3.0f)), one, V::select(V::eq(index, zero), zero, V::add(index, one)));
+
+            indices[i >> 3] = V::add(indices[i >> 3], V::mul(index, weight));
+            weight          = (i & 7) == 7 ? one : V::mul(weight, V::set1(4.0f));
+        }
+
+        float c0Lanes[BC1_SIMD_MAX_LANES];
+        float c1Lanes[BC1_SIMD_MAX_LANES];
+        float indicesLanes[2][BC1_SIMD_MAX_LANES];
+
+        V::store(c0Lanes, c0);
+        V::store(c1Lanes, c1);
+        V::store(indicesLanes[0], indices[0]);
+        V::store(indicesLanes[1], indices[1]);
+
+        int rangeBits = V::bits(hasRange);
+
+        for (int i = 0; i < lanes; i++)
+        {
+            unsigned int n0 = (unsigned int)c0Lanes[i];
+            unsigned int n1 = (unsigned int)c1Lanes[i];
+
+            unsigned char* cmpBlock = cmpBlocks + (first + i) * cmpBlockBytes;
+            if (rangeBits & (1 << i))
+                bc1StoreBlock<V>(cmpBlock, (n0 << 16) | n1, (unsigned int)indicesLanes[0][i] | ((unsigned int)indicesLanes[1][i] << 16));
+            else
+                bc1StoreBlock<V>(cmpBlock, (n1 << 16) | n0, 0);
+        }
+
+        solidBlocks |= (unsigned int)(V::bits(solid) & ((1 << lanes) - 1)) << first;
+    }
+
+    return solidBlocks;
+}
+
+template <class V, class vf = typename V::vf, class vm = typename V::vm, class vi = typename V::vi>
+static void bc3CompressAlphaBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    const vf zero        = V::zero();
+    const vf one         = V::set1(1.0f);
+    const vf seven       = V::set1(7.0f);
+    const vf byteToUNorm = V::set1(255.0f);
+
+    for (int first = 0; first < numBlocks; first += V::Lanes)
+    {
+        int lanes = numBlocks - first < V::Lanes ? numBlocks - first : V::Lanes;
+
+        unsigned char        padded[BC1_SIMD_MAX_LANES * BC1_SIMD_BLOCK_BYTES];
+        const unsigned char* blocks = bc1LaneBlocks<V>(padded, srcBlocks + first * BC1_SIMD_BLOCK_BYTES, lanes);
+
+        // cmp_getLinearEndPoints() bounding box
+        vf alpha[16];
+        for (int i = 0; i < 16; i++)
+            alpha[i] = V::div(V::channel(V::loadPixels(blocks + i * 4, BC1_SIMD_BLOCK_BYTES), 24), byteToUNorm);
+
+        vf alphaMin = alpha[0];
+        vf alphaMax = alpha[0];
+        for (int i = 1; i < 16; i++)
+        {
+            alphaMin = V::min(alphaMin, alpha[i]);
+            alphaMax = V::max(alphaMax, alpha[i]);
+        }
+
+        // cmp_getBlockPackedIndices(), the ramp runs from the max (index 0) to the min (index 1)
+        vf range     = V::select(V::eq(alphaMin, alphaMax), one, V::sub(alphaMin, alphaMax));
+        vf rampSteps = V::div(seven, range);
+        vf bias      = V::mul(V::sub(zero, rampSteps), alphaMax);
+
+        vf indices[2] = {zero, zero};
+        vf weight     = one;
+
+        for (int i = 0; i < 16; i++)
+        {
+            vf index = bc1Round<V>(V::add(V::mul(alpha[i], rampSteps), bias));
+            index    = V::select(V::eq(index, seven), one, V::select(V::eq(index, zero), zero, V::add(index, one)));
+
+            indices[i >> 3] = V::add(indices[i >> 3], V::mul(index, weight));
+            weight          = (i & 7) == 7 ? one : V::mul(weight, V::set1(8.0f));
+        }
+
+        vf endpoints = V::add(bc1Round<V>(V::mul(alphaMax, byteToUNorm)), V::mul(bc1Round<V>(V::mul(alphaMin, byteToUNorm)), V::set1(256.0f)));
+
+        float endpointLanes[BC1_SIMD_MAX_LANES];
+        float indicesLanes[2][BC1_SIMD_MAX_LANES];
+
+        V::store(endpointLanes, endpoints);
+        V::store(indicesLanes[0], indices[0]);
+        V::store(indicesLanes[1], indices[1]);
+
+        for (int i = 0; i < lanes; i++)
+        {
+            // two 24 bit fields of eight 3 bit indices each follow the 16 bits of the end points
+            unsigned long long block = (unsigned long long)endpointLanes[i] | ((unsigned long long)indicesLanes[0][i] << 16) |
+                                       ((unsigned long long)indicesLanes[1][i] << 40);
+
+            bc1StoreBlock<V>(cmpBlocks + (first + i) * cmpBlockBytes, (unsigned int)block, (unsigned int)(block >> 32));
+        }
+    }
+}
+
+template <class V, class vf = typename V::vf, class vm = typename V::vm, class vi = typename V::vi>
+static void bc2CompressExplicitAlphaBlocks(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    const vf zero      = V::zero();
+    const vf one       = V::set1(1.0f);
+    const vf sixteenth = V::set1(0.0625f);
+
+    for (int first = 0; first < numBlocks; first += V::Lanes)
+    {
+        int lanes = numBlocks - first < V::Lanes ? numBlocks - first : V::Lanes;
+
+        unsigned char        padded[BC1_SIMD_MAX_LANES * BC1_SIMD_BLOCK_BYTES];
+        const unsigned char* blocks = bc1LaneBlocks<V>(padded, srcBlocks + first * BC1_SIMD_BLOCK_BYTES, lanes);
+
+        // four pixels of 4 bits per field
+        vf alpha[4] = {zero, zero, zero, zero};
+        vf weight   = one;
+
+        for (int i = 0; i < 16; i++)
+        {
+            // (v + 7 - (v >> 4)) >> 4, the alpha converted to 0..1 and back is the source byte
+            vf v = V::channel(V::loadPixels(blocks + i * 4, BC1_SIMD_BLOCK_BYTES), 24);
+            v    = V::floor(V::mul(V::sub(V::add(v, V::set1(7.0f)), V::floor(V::mul(v, sixteenth))), sixteenth));
+
+            alpha[i >> 2] = V::add(alpha[i >> 2], V::mul(v, weight));
+            weight        = (i & 3) == 3 ? one : V::mul(weight, V::set1(16.0f));
+        }
+
+        float alphaLanes[4][BC1_SIMD_MAX_LANES];
+        for (int j = 0; j < 4; j++)
+            V::store(alphaLanes[j], alpha[j]);
+
+        for (int i = 0; i < lanes; i++)
+        {
+            bc1StoreBlock<V>(cmpBlocks + (first + i) * cmpBlockBytes,
+                             (unsigned int)alphaLanes[0][i] | ((unsigned int)alphaLanes[1][i] << 16),
+                             (unsigned int)alphaLanes[2][i] | ((unsigned int)alphaLanes[3][i] << 16));
+        }
+    }
+}
+
+#endif
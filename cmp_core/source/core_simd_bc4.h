@@ -0,0 +1,118 @@
+//=====================================================================
+// Copyright 2023-2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#ifndef CORE_SIMD_BC4_H_
+#define CORE_SIMD_BC4_H_
+
+// Lane generic version of cmp_getRampError() from bcn_common_kernel.h, used by the BC4 and BC5 endpoint
+// search in bc4_encode_kernel.cpp.
+//
+// Each SIMD lane evaluates one candidate ramp (low and high endpoint) against the unique values of a
+// single channel block. The error is always summed over all values, the caller compares the results in
+// candidate order which gives the same choices as the early out of the scalar code. The arithmetic is
+// performed in the same order as the scalar code, so the errors are bit identical.
+//
+// The including file provides a lane type V with:
+//   vf, vm, Lanes           float vector and lane mask types, number of lanes
+//   zero, set1, load, store (unaligned)
+//   add, sub, mul, div, floor
+//   le, ge, select(m, a, b) = m ? a : b
+
+#define BC4_SIMD_BLOCK_SIZE 16
+#define BC4_SIMD_MAX_LANES 16
+
+template <class V, class vf = typename V::vf>
+static void bc4RampErrors(float*       errors,     // [numRamps] output
+                          const float* lows,       // [numRamps] low end of each ramp
+                          const float* highs,      // [numRamps] high end of each ramp
+                          int          numRamps,
+                          const float* values,     // [numValues] unique values of the block
+                          const float* repeats,    // [numValues] number of times each value appears
+                          int          numValues)
+{
+    const vf zero  = V::zero();
+    const vf seven = V::set1(7.0f);
+    const vf half  = V::set1(0.5f);
+    const vf one   = V::set1(1.0f);
+
+    for (int first = 0; first < numRamps; first += V::Lanes)
+    {
+        int lanes = numRamps - first < V::Lanes ? numRamps - first : V::Lanes;
+
+        vf low;
+        vf high;
+
+        if (lanes == V::Lanes)
+        {
+            low  = V::load(lows + first);
+            high = V::load(highs + first);
+        }
+        else
+        {
+            // pad the last ramps with a valid range, those lanes are not stored
+            float lowPadded[BC4_SIMD_MAX_LANES];
+            float highPadded[BC4_SIMD_MAX_LANES];
+
+            for (int i = 0; i < V::Lanes; i++)
+            {
+                lowPadded[i]  = i < lanes ? lows[first + i] : 0.0f;
+                highPadded[i] = i < lanes ? highs[first + i] : 1.0f;
+            }
+
+            low  = V::load(lowPadded);
+            high = V::load(highPadded);
+        }
+
+        vf step   = V::div(V::sub(high, low), seven);
+        vf step_h = V::mul(step, half);
+        vf rstep  = V::div(one, step);
+        vf error  = zero;
+
+        for (int i = 0; i < numValues; i++)
+        {
+            vf value = V::set1(values[i]);
+            vf del   = V::sub(value, low);
+
+            // the value this selects on the ramp, clamped to the end points
+            vf v = V::add(V::mul(V::floor(V::mul(V::add(del, step_h), rstep)), step), low);
+            v    = V::select(V::ge(V::sub(value, high), zero), high, v);
+            v    = V::select(V::le(del, zero), low, v);
+
+            vf del2 = V::sub(value, v);
+            error   = V::add(error, V::mul(V::mul(del2, del2), V::set1(repeats[i])));
+        }
+
+        if (lanes == V::Lanes)
+            V::store(errors + first, error);
+        else
+        {
+            float errorPadded[BC4_SIMD_MAX_LANES];
+
+            V::store(errorPadded, error);
+            for (int i = 0; i < lanes; i++)
+                errors[first + i] = errorPadded[i];
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,204 @@
+//=====================================================================
+// Copyright 2023-2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#ifndef CORE_SIMD_BC6_H_
+#define CORE_SIMD_BC6_H_
+
+// Lane generic version of the endpoint cube search ep_cube_shake_d() used by ep_shaker_HD() in
+// bc6_encode_kernel.cpp.
+//
+// The lanes hold the entries (pixels) of one subset. For each of the 64 cube corners the changed
+// channel's squared errors are updated for all entries at once and every lane keeps the first ramp
+// position with the smallest error sum. The arithmetic is performed in the same order as the scalar
+// kernel, so the results are bit identical.
+//
+// The including file provides a lane type V with:
+//   vf, vm, Lanes           float vector and lane mask types, number of lanes
+//   zero, set1, load, store (unaligned)
+//   add, sub, mul
+//   lt, select(m, a, b) = m ? a : b
+
+#include <float.h>
+
+#define BC6_SIMD_MAX_ENTRIES 64   // must match MAX_ENTRIES used by bc6_encode_kernel.h
+#define BC6_SIMD_MAX_CHANNELS 4   // MAX_DIMENSION_BIG
+#define BC6_SIMD_MAX_CLUSTERS 16  // MAX_CLUSTERS_BIG
+
+template <class V, class vf = typename V::vf>
+static float bc6ShakeEndpointCube(int*         idx_out,      // [MAX_ENTRIES]
+                                  float*       out,          // [MAX_ENTRIES][MAX_DIMENSION_BIG]
+                                  int*         s1_out,       // corner bits of the best result
+                                  const float* data,         // [MAX_ENTRIES][MAX_DIMENSION_BIG]
+                                  int          numEntries,
+                                  const float* rampWeights,  // [MAX_CLUSTERS_BIG] ramp weights of the index precision
+                                  int          clusters,     // 1 << clogs
+                                  const float* epd,          // [2][MAX_DIMENSION_BIG][2] endpoint ranges
+                                  int          channels3or4)
+{
+    const int Chunks    = BC6_SIMD_MAX_ENTRIES / V::Lanes;
+    const int numChunks = (numEntries + V::Lanes - 1) / V::Lanes;
+
+    vf d[BC6_SIMD_MAX_CHANNELS][Chunks];                         // entries by channel
+    vf ce[BC6_SIMD_MAX_CHANNELS][BC6_SIMD_MAX_CLUSTERS][Chunks];  // squared error per channel, ramp position and entry
+
+    for (int k = 0; k < channels3or4; k++)
+    {
+        float channel[BC6_SIMD_MAX_ENTRIES];
+
+        for (int i = 0; i < numChunks * V::Lanes; i++)
+            channel[i] = i < numEntries ? data[i * BC6_SIMD_MAX_CHANNELS + k] : 0.0f;
+
+        for (int c = 0; c < numChunks; c++)
+            d[k][c] = V::load(channel + c * V::Lanes);
+    }
+
+#define BC6_SIMD_EPD(i, k, e) epd[((i)*BC6_SIMD_MAX_CHANNELS + (k)) * 2 + (e)]
+
+    for (int k = 0; k < channels3or4; k++)
+    {
+        float p1 = BC6_SIMD_EPD(0, k, 0);
+        float p2 = BC6_SIMD_EPD(1, k, 0);
+
+        for (int j = 0; j < clusters; j++)
+        {
+            vf ramp = V::set1(p1 + rampWeights[j] * (p2 - p1));
+
+            for (int c = 0; c < numChunks; c++)
+            {
+                vf diff     = V::sub(ramp, d[k][c]);
+                ce[k][j][c] = V::mul(diff, diff);
+            }
+        }
+    }
+
+    float err_1   = FLT_MAX;
+    int   s1      = 0;
+    int   s       = 0;
+    int   ei0     = 0;
+    int   ei1     = 0;
+    int   bestEi0 = 0;
+    int   bestEi1 = 0;
+    bool  found   = false;
+    vf    idx_1[Chunks];
+
+    for (int p = 0; p < 64; p++)
+    {
+        int j0 = 0;
+        int g  = p & (-p);  // Gray code increment
+
+        for (int j = 0; j < channels3or4; j++)
+        {
+            if (((g >> (2 * j)) & 0x3) != 0)
+            {
+                j0  = j;
+                ei0 = (((s ^ g) >> (2 * j)) & 0x1);
+                ei1 = (((s ^ g) >> (2 * j + 1)) & 0x1);
+            }
+        }
+        s = s ^ g;
+
+        float p1 = BC6_SIMD_EPD(0, j0, ei0);
+        float p2 = BC6_SIMD_EPD(1, j0, ei1);
+
+        vf cmin[Chunks];
+        vf ci[Chunks];
+
+        for (int c = 0; c < numChunks; c++)
+        {
+            cmin[c] = V::set1(FLT_MAX);
+            ci[c]   = V::zero();
+        }
+
+        for (int j = 0; j < clusters; j++)
+        {
+            vf ramp = V::set1(p1 + rampWeights[j] * (p2 - p1));
+            vf vj   = V::set1((float)j);
+
+            for (int c = 0; c < numChunks; c++)
+            {
+                vf diff      = V::sub(ramp, d[j0][c]);
+                ce[j0][j][c] = V::mul(diff, diff);
+
+                vf t_ = V::zero();
+                for (int k = 0; k < channels3or4; k++)
+                    t_ = V::add(t_, ce[k][j][c]);
+
+                // strict less than keeps the first ramp position with the smallest error
+                typename V::vm better = V::lt(t_, cmin[c]);
+
+                cmin[c] = V::select(better, t_, cmin[c]);
+                ci[c]   = V::select(better, vj, ci[c]);
+            }
+        }
+
+        // the error is summed in entry order like the scalar kernel
+        float errors[BC6_SIMD_MAX_ENTRIES];
+        float err_0 = 0;
+
+        for (int c = 0; c < numChunks; c++)
+            V::store(errors + c * V::Lanes, cmin[c]);
+
+        for (int i = 0; i < numEntries; i++)
+            err_0 += errors[i];
+
+        if (err_0 < err_1)
+        {
+            for (int c = 0; c < numChunks; c++)
+                idx_1[c] = ci[c];
+            err_1   = err_0;
+            s1      = s;
+            bestEi0 = ei0;
+            bestEi1 = ei1;
+            found   = true;
+        }
+    }
+
+    if (found)
+    {
+        float index[BC6_SIMD_MAX_ENTRIES];
+
+        for (int c = 0; c < numChunks; c++)
+            V::store(index + c * V::Lanes, idx_1[c]);
+
+        // the scalar kernel builds the ramp of every channel with the corner bits of the channel changed last
+        for (int i = 0; i < numEntries; i++)
+        {
+            idx_out[i] = (int)index[i];
+
+            for (int k = 0; k < channels3or4; k++)
+            {
+                float p1 = BC6_SIMD_EPD(0, k, bestEi0);
+                float p2 = BC6_SIMD_EPD(1, k, bestEi1);
+
+                out[i * BC6_SIMD_MAX_CHANNELS + k] = p1 + rampWeights[idx_out[i]] * (p2 - p1);
+            }
+        }
+    }
+
+#undef BC6_SIMD_EPD
+
+    *s1_out = s1;
+    return err_1;
+}
+
+#endif
@@ -0,0 +1,472 @@
+//=====================================================================
+// Copyright 2023-2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#ifndef CORE_SIMD_BC7_H_
+#define CORE_SIMD_BC7_H_
+
+// Lane generic version of the BC7 partition scan used by Compress_mode01237 in bc7_encode_kernel.cpp.
+//
+// Each SIMD lane quantizes one candidate partition shape of the same 4x4 block, so all the varying
+// values of GetQuantizeIndex() become vectors and the per lane arithmetic is performed in the same
+// order as the scalar kernel. Loops over a subset's entries run to the largest entry count of all
+// lanes and are masked per lane, the insertion sort of GetProjectedIndex() becomes a fixed
+// compare-exchange network. Index values are kept as floats and wrapped like the uint8 values of the
+// scalar code, which keeps the results bit identical to the scalar encoder.
+//
+// The including file provides a lane type V with:
+//   vf, vm            float vector and lane mask types, Lanes = number of lanes
+//   zero, set1, load, store          (unaligned)
+//   add, sub, mul, div, sqrt, floor
+//   lt, gt, ge, eq, neq, isNaN      (neq and isNaN are true for NaN lanes)
+//   mand, mor, mandnot(a, b) = a & ~b, mnot, any
+//   select(m, a, b) = m ? a : b
+
+#define BC7_SIMD_BLOCK_SIZE 16
+#define BC7_SIMD_MAX_CHANNELS 4
+#define BC7_SIMD_MAX_SUBSETS 3
+#define BC7_SIMD_MAX_LANES 16
+#define BC7_SIMD_EPSILON 0.00390625f  // must match EPSILON used by bc7_encode_kernel.cpp
+
+// wraps an integral float to the 0..255 range the same way a cast to an 8 bit unsigned value does
+template <class V, class vf = typename V::vf>
+static inline vf bc7LaneWrapUint8(vf v)
+{
+    return V::sub(v, V::mul(V::set1(256.0f), V::floor(V::mul(v, V::set1(1.0f / 256.0f)))));
+}
+
+template <class V, class vf = typename V::vf, class vm = typename V::vm>
+static void bc7LaneGetProjectedIndex(vf       projected_index_out[BC7_SIMD_BLOCK_SIZE],
+                                     const vf image_projected[BC7_SIMD_BLOCK_SIZE],
+                                     const vm inside[BC7_SIMD_BLOCK_SIZE],  // lane has an entry at this position
+                                     vf       numEntries,
+                                     int      maxEntries,  // largest numEntries of all lanes
+                                     int      clusters,
+                                     vm       active)
+{
+    const vf zero = V::zero();
+
+    for (int i = 0; i < BC7_SIMD_BLOCK_SIZE; i++)
+        projected_index_out[i] = zero;
+
+    vf image_min = image_projected[0];
+    vf image_max = image_projected[0];
+
+    for (int i = 1; i < maxEntries; i++)
+    {
+        image_min = V::select(V::mand(inside[i], V::lt(image_min, image_projected[i])), image_projected[i], image_min);
+        image_max = V::select(V::mand(inside[i], V::gt(image_max, image_projected[i])), image_projected[i], image_max);
+    }
+
+    vf img_diff = V::sub(image_max, image_min);
+
+    // lanes with a flat projection keep the default index
+    active = V::mandnot(active, V::mor(V::eq(img_diff, zero), V::isNaN(img_diff)));
+    if (!V::any(active))
+        return;
+
+    vf image_s  = V::div(V::set1((float)(clusters - 1)), img_diff);
+    vf image_ms = V::mul(image_min, image_s);
+    vf image_dm = zero;
+    vf image_r  = zero;
+
+    vf what_image[BC7_SIMD_BLOCK_SIZE];
+    vf what_index[BC7_SIMD_BLOCK_SIZE];
+
+    for (int i = 0; i < maxEntries; i++)
+    {
+        vf image_v = V::mul(image_projected[i], image_s);
+        vf image_z = V::floor(V::sub(V::add(image_v, V::set1(0.5F)), image_ms));
+
+        projected_index_out[i] = V::select(inside[i], bc7LaneWrapUint8<V>(image_z), zero);
+
+        what_image[i] = V::sub(V::sub(image_v, image_z), image_ms);
+        what_index[i] = V::set1((float)i);
+        image_dm      = V::select(inside[i], V::add(image_dm, what_image[i]), image_dm);
+        image_r       = V::select(inside[i], V::add(image_r, V::mul(what_image[i], what_image[i])), image_r);
+    }
+
+    vm refine = V::mand(active,
+                        V::ge(V::sub(V::mul(numEntries, image_r), V::mul(image_dm, image_dm)),
+                              V::div(V::sub(numEntries, V::set1(1.0f)), V::set1(8.0f))));
+
+    if (V::any(refine))
+    {
+        image_dm = V::div(image_dm, numEntries);
+
+        for (int i = 0; i < maxEntries; i++)
+            what_image[i] = V::select(inside[i], V::sub(what_image[i], image_dm), what_image[i]);
+
+        // insertion sort, the scalar code visits every pair so it maps to a compare-exchange network
+        for (int i = 1; i < maxEntries; i++)
+        {
+            for (int j = i; j > 0; j--)
+            {
+                vm swap = V::mand(inside[i], V::gt(what_image[j - 1], what_image[j]));
+
+                vf tmp_image      = what_image[j];
+                vf tmp_index      = what_index[j];
+                what_image[j]     = V::select(swap, what_image[j - 1], what_image[j]);
+                what_index[j]     = V::select(swap, what_index[j - 1], what_index[j]);
+                what_image[j - 1] = V::select(swap, tmp_image, what_image[j - 1]);
+                what_index[j - 1] = V::select(swap, tmp_index, what_index[j - 1]);
+            }
+        }
+
+        // got into fundamental simplex
+        // move coordinate system origin to its center
+        for (int i = 0; i < maxEntries; i++)
+        {
+            vf center     = V::div(V::sub(V::set1(2.0f * i + 1), numEntries), V::mul(V::set1(2.0f), numEntries));
+            what_image[i] = V::select(inside[i], V::sub(what_image[i], center), what_image[i]);
+        }
+
+        vf image_mm = zero;
+        vf image_l  = zero;
+        vf image_j  = V::set1(-1.0f);
+
+        for (int i = 0; i < maxEntries; i++)
+        {
+            image_l    = V::select(inside[i], V::add(image_l, what_image[i]), image_l);
+            vm lower   = V::mand(inside[i], V::lt(image_l, image_mm));
+            image_mm   = V::select(lower, image_l, image_mm);
+            image_j    = V::select(lower, V::set1((float)i), image_j);
+        }
+
+        // j + 1 is at most numEntries so the scalar wrap around is never taken
+        image_j = V::add(image_j, V::set1(1.0f));
+
+        for (int i = 0; i < maxEntries; i++)
+        {
+            vm bump = V::mand(V::mand(refine, inside[i]), V::ge(V::set1((float)i), image_j));
+            if (!V::any(bump))
+                continue;
+
+            for (int k = 0; k < maxEntries; k++)
+            {
+                vm hit                 = V::mand(bump, V::eq(what_index[i], V::set1((float)k)));
+                projected_index_out[k] = V::select(hit, bc7LaneWrapUint8<V>(V::add(projected_index_out[k], V::set1(1.0f))), projected_index_out[k]);
+            }
+        }
+    }
+
+    // get minimum index
+    vf index_min = projected_index_out[0];
+    for (int i = 1; i < maxEntries; i++)
+        index_min = V::select(V::mand(inside[i], V::lt(projected_index_out[i], index_min)), projected_index_out[i], index_min);
+
+    // reposition all index by min index (using min index as 0)
+    const vf fifteen = V::set1(15.0f);
+    for (int i = 0; i < maxEntries; i++)
+    {
+        vf index = bc7LaneWrapUint8<V>(V::sub(projected_index_out[i], index_min));
+        index    = V::select(V::gt(index, fifteen), fifteen, index);
+
+        projected_index_out[i] = V::select(V::mand(active, inside[i]), index, zero);
+    }
+}
+
+template <class V, class vf = typename V::vf, class vm = typename V::vm>
+static void bc7LaneGetProjectedImage(vf       projection_out[BC7_SIMD_BLOCK_SIZE],
+                                     const vf image_centered[BC7_SIMD_BLOCK_SIZE * BC7_SIMD_MAX_CHANNELS],
+                                     const vf eigen_vector[BC7_SIMD_MAX_CHANNELS],
+                                     int      maxEntries,
+                                     int      channels3or4)
+{
+    for (int k = 0; k < maxEntries; k++)
+    {
+        projection_out[k] = V::zero();
+        for (int ch = 0; ch < channels3or4; ch++)
+            projection_out[k] = V::add(projection_out[k], V::mul(image_centered[k + (ch * BC7_SIMD_BLOCK_SIZE)], eigen_vector[ch]));
+    }
+}
+
+// Returns the quantization error of each lane, same as GetQuantizeIndex() without the packed index output
+template <class V, class vf = typename V::vf, class vm = typename V::vm>
+static vf bc7LaneGetQuantizeIndex(vf       index_out[BC7_SIMD_BLOCK_SIZE],
+                                  const vf image_src[BC7_SIMD_BLOCK_SIZE * BC7_SIMD_MAX_CHANNELS],
+                                  const vm inside[BC7_SIMD_BLOCK_SIZE],
+                                  vf       numEntries,
+                                  int      maxEntries,
+                                  int      numClusters,
+                                  int      channels3or4)
+{
+    const vf zero = V::zero();
+
+    vf image_centered[BC7_SIMD_BLOCK_SIZE * BC7_SIMD_MAX_CHANNELS];
+    vf image_mean[BC7_SIMD_MAX_CHANNELS];
+    vf eigen_vector[BC7_SIMD_MAX_CHANNELS];
+    vf covariance_vector[BC7_SIMD_MAX_CHANNELS * BC7_SIMD_MAX_CHANNELS];
+
+    for (int ch = 0; ch < channels3or4; ch++)
+    {
+        image_mean[ch] = zero;
+        for (int k = 0; k < maxEntries; k++)
+            image_mean[ch] = V::select(inside[k], V::add(image_mean[ch], image_src[k + (ch * BC7_SIMD_BLOCK_SIZE)]), image_mean[ch]);
+        image_mean[ch] = V::div(image_mean[ch], numEntries);
+        for (int k = 0; k < maxEntries; k++)
+            image_centered[k + (ch * BC7_SIMD_BLOCK_SIZE)] = V::sub(image_src[k + (ch * BC7_SIMD_BLOCK_SIZE)], image_mean[ch]);
+    }
+
+    for (int ch1 = 0; ch1 < channels3or4; ch1++)
+        for (int ch2 = 0; ch2 <= ch1; ch2++)
+        {
+            vf covariance = zero;
+            for (int k = 0; k < maxEntries; k++)
+                covariance = V::select(inside[k],
+                                       V::add(covariance,
+                                              V::mul(image_centered[k + (ch1 * BC7_SIMD_BLOCK_SIZE)], image_centered[k + (ch2 * BC7_SIMD_BLOCK_SIZE)])),
+                                       covariance);
+            covariance_vector[ch1 + ch2 * 4] = covariance;
+            covariance_vector[ch2 + ch1 * 4] = covariance;
+        }
+
+    // lanes where all covariances are the same keep the default index and no error
+    vf image_covt = zero;
+    for (int ch = 0; ch < channels3or4; ch++)
+        image_covt = V::add(image_covt, covariance_vector[ch + ch * 4]);
+
+    vm active = V::mnot(V::lt(image_covt, V::set1(BC7_SIMD_EPSILON)));
+    if (!V::any(active))
+    {
+        for (int i = 0; i < BC7_SIMD_BLOCK_SIZE; i++)
+            index_out[i] = zero;
+        return zero;
+    }
+
+    //-----------------------------------------------------
+    // Eigen vector corresponding to the biggest eigen value
+    //-----------------------------------------------------
+    vf vector_covIn[BC7_SIMD_MAX_CHANNELS * BC7_SIMD_MAX_CHANNELS];
+    vf vector_covOut[BC7_SIMD_MAX_CHANNELS * BC7_SIMD_MAX_CHANNELS];
+
+    vf vector_maxCovariance = zero;
+    for (int ch = 0; ch < channels3or4; ch++)
+        vector_maxCovariance = V::select(V::gt(covariance_vector[ch + ch * 4], vector_maxCovariance), covariance_vector[ch + ch * 4], vector_maxCovariance);
+
+    vm normalize = V::gt(vector_maxCovariance, zero);
+    for (int ch1 = 0; ch1 < channels3or4; ch1++)
+        for (int ch2 = 0; ch2 < channels3or4; ch2++)
+            vector_covIn[ch1 + ch2 * 4] =
+                V::select(normalize, V::div(covariance_vector[ch1 + ch2 * 4], vector_maxCovariance), covariance_vector[ch1 + ch2 * 4]);
+
+    for (int ch1 = 0; ch1 < channels3or4; ch1++)
+        for (int ch2 = 0; ch2 < channels3or4; ch2++)
+        {
+            vf vector_temp_cov = zero;
+            for (int ch3 = 0; ch3 < channels3or4; ch3++)
+                vector_temp_cov = V::add(vector_temp_cov, V::mul(vector_covIn[ch1 + ch3 * 4], vector_covIn[ch3 + ch2 * 4]));
+            vector_covOut[ch1 + ch2 * 4] = vector_temp_cov;
+        }
+
+    vector_maxCovariance          = zero;
+    vf maxCovariance_channel      = zero;
+    for (int ch = 0; ch < channels3or4; ch++)
+    {
+        vm larger             = V::gt(vector_covOut[ch + ch * 4], vector_maxCovariance);
+        maxCovariance_channel = V::select(larger, V::set1((float)ch), maxCovariance_channel);
+        vector_maxCovariance  = V::select(larger, vector_covOut[ch + ch * 4], vector_maxCovariance);
+    }
+
+    vf vector_t = zero;
+    for (int ch = 0; ch < channels3or4; ch++)
+    {
+        vf row = vector_covOut[ch * 4];
+        for (int m = 1; m < channels3or4; m++)
+            row = V::select(V::eq(maxCovariance_channel, V::set1((float)m)), vector_covOut[m + ch * 4], row);
+
+        vector_t         = V::add(vector_t, V::mul(row, row));
+        eigen_vector[ch] = row;
+    }
+
+    vector_t         = V::sqrt(vector_t);
+    vm normalizeEign = V::gt(vector_t, zero);
+    for (int ch = 0; ch < channels3or4; ch++)
+        eigen_vector[ch] = V::select(normalizeEign, V::div(eigen_vector[ch], vector_t), eigen_vector[ch]);
+
+    vf image_projected[BC7_SIMD_BLOCK_SIZE];
+
+    bc7LaneGetProjectedImage<V>(image_projected, image_centered, eigen_vector, maxEntries, channels3or4);
+    bc7LaneGetProjectedIndex<V>(index_out, image_projected, inside, numEntries, maxEntries, numClusters, active);
+
+    //==========================================
+    // Refine
+    //==========================================
+    vf image_q = zero;
+    for (int ch = 0; ch < channels3or4; ch++)
+    {
+        eigen_vector[ch] = zero;
+        for (int k = 0; k < maxEntries; k++)
+            eigen_vector[ch] =
+                V::select(inside[k], V::add(eigen_vector[ch], V::mul(image_centered[k + (ch * BC7_SIMD_BLOCK_SIZE)], index_out[k])), eigen_vector[ch]);
+        image_q = V::add(image_q, V::mul(eigen_vector[ch], eigen_vector[ch]));
+    }
+
+    image_q = V::sqrt(image_q);
+
+    // direction needs to be normalized
+    vm normalizeQ = V::neq(image_q, zero);
+    for (int ch = 0; ch < channels3or4; ch++)
+        eigen_vector[ch] = V::select(normalizeQ, V::div(eigen_vector[ch], image_q), eigen_vector[ch]);
+
+    // Get new projected data
+    bc7LaneGetProjectedImage<V>(image_projected, image_centered, eigen_vector, maxEntries, channels3or4);
+    bc7LaneGetProjectedIndex<V>(index_out, image_projected, inside, numEntries, maxEntries, numClusters, active);
+
+    //===========================
+    // Calc Error
+    //===========================
+    vf image_t       = zero;
+    vf index_average = zero;
+
+    for (int ik = 0; ik < maxEntries; ik++)
+    {
+        index_average = V::select(inside[ik], V::add(index_average, index_out[ik]), index_average);
+        image_t       = V::select(inside[ik], V::add(image_t, V::mul(index_out[ik], index_out[ik])), image_t);
+    }
+
+    index_average = V::div(index_average, numEntries);
+    image_t       = V::sub(image_t, V::mul(V::mul(index_average, index_average), numEntries));
+    image_t       = V::select(V::neq(image_t, zero), V::div(V::set1(1.0F), image_t), image_t);
+
+    for (int ch = 0; ch < channels3or4; ch++)
+    {
+        eigen_vector[ch] = zero;
+        for (int nk = 0; nk < maxEntries; nk++)
+            eigen_vector[ch] =
+                V::select(inside[nk], V::add(eigen_vector[ch], V::mul(image_centered[nk + (ch * BC7_SIMD_BLOCK_SIZE)], index_out[nk])), eigen_vector[ch]);
+    }
+
+    vf err_t = zero;
+    for (int ch = 0; ch < channels3or4; ch++)
+    {
+        vf scale = V::mul(eigen_vector[ch], image_t);
+        for (int k = 0; k < maxEntries; k++)
+        {
+            vf image_decomp = V::add(image_mean[ch], V::mul(scale, V::sub(index_out[k], index_average)));
+            vf diff         = V::sub(image_src[k + (ch * BC7_SIMD_BLOCK_SIZE)], image_decomp);
+            err_t           = V::select(inside[k], V::add(err_t, V::mul(diff, diff)), err_t);
+        }
+    }
+
+    return V::select(active, err_t, zero);
+}
+
+// Quantizes the first numPartitions partition shapes of a block, V::Lanes shapes at a time.
+// Results match the scalar partition loop of Compress_mode01237().
+template <class V>
+static void bc7QuantizePartitions(float              storedError[],             // OUT: [numPartitions]
+                                  unsigned char      storedBestindex[],         // OUT: [numPartitions][MAX_SUBSETS][MAX_SUBSET_SIZE]
+                                  const float        image_src[],               // IN:  planar block, SOURCE_BLOCK_SIZE * MAX_CHANNELS
+                                  const unsigned int subsetMasks[],             // IN:  subset_mask_table entries for maxSubsets
+                                  int                maxSubsets,                // 2 or 3
+                                  int                numPartitions,             // 1..64
+                                  int                clusters,                  // ramp points
+                                  int                channels3or4)              // 3 = RGB or 4 = RGBA
+{
+    typedef typename V::vf vf;
+    typedef typename V::vm vm;
+
+    const int Lanes = V::Lanes;
+
+    // lane transposed subset data, filled per lane and loaded as vectors
+    float subsetData[BC7_SIMD_BLOCK_SIZE * BC7_SIMD_MAX_CHANNELS * BC7_SIMD_MAX_LANES];
+    float laneData[BC7_SIMD_MAX_LANES];
+    float indexData[BC7_SIMD_BLOCK_SIZE * BC7_SIMD_MAX_LANES];
+
+    for (int firstPartition = 0; firstPartition < numPartitions; firstPartition += Lanes)
+    {
+        int numLanes = numPartitions - firstPartition < Lanes ? numPartitions - firstPartition : Lanes;
+        int entryCount[BC7_SIMD_MAX_LANES];
+        vf  err_quant = V::zero();
+
+        for (int subset = 0; subset < maxSubsets; subset++)
+        {
+            int maxEntries = 0;
+
+            for (int lane = 0; lane < Lanes; lane++)
+            {
+                // unused lanes repeat the last partition
+                int          partition = firstPartition + (lane < numLanes ? lane : numLanes - 1);
+                unsigned int mask0     = subsetMasks[partition] & 0xFFFF;
+                unsigned int mask1     = subsetMasks[partition] >> 16;
+                int          count     = 0;
+
+                for (int i = 0; i < BC7_SIMD_BLOCK_SIZE; i++)
+                {
+                    int pixelSubset;
+                    if (maxSubsets == 2)
+                        pixelSubset = (subsetMasks[partition] & (0x01 << i)) ? 1 : 0;
+                    else
+                        pixelSubset = (mask1 & (0x01 << i)) ? 2 : ((mask0 & (0x01 << i)) ? 1 : 0);
+
+                    if (pixelSubset != subset)
+                        continue;
+
+                    for (int ch = 0; ch < BC7_SIMD_MAX_CHANNELS; ch++)
+                    {
+                        float value = (ch == 3 && channels3or4 == 3) ? 0.0F : image_src[i + (ch * BC7_SIMD_BLOCK_SIZE)];
+                        subsetData[(count + ch * BC7_SIMD_BLOCK_SIZE) * Lanes + lane] = value;
+                    }
+                    count++;
+                }
+
+                for (int k = count; k < BC7_SIMD_BLOCK_SIZE; k++)
+                    for (int ch = 0; ch < BC7_SIMD_MAX_CHANNELS; ch++)
+                        subsetData[(k + ch * BC7_SIMD_BLOCK_SIZE) * Lanes + lane] = 0.0F;
+
+                entryCount[lane]    = count;
+                laneData[lane] = (float)count;
+                if (count > maxEntries)
+                    maxEntries = count;
+            }
+
+            vf subset_src[BC7_SIMD_BLOCK_SIZE * BC7_SIMD_MAX_CHANNELS];
+            for (int k = 0; k < BC7_SIMD_BLOCK_SIZE * BC7_SIMD_MAX_CHANNELS; k++)
+                subset_src[k] = V::load(&subsetData[k * Lanes]);
+
+            vf numEntries = V::load(laneData);
+            vm inside[BC7_SIMD_BLOCK_SIZE];
+            for (int k = 0; k < BC7_SIMD_BLOCK_SIZE; k++)
+                inside[k] = V::lt(V::set1((float)k), numEntries);
+
+            vf index_out[BC7_SIMD_BLOCK_SIZE];
+            err_quant = V::add(err_quant, bc7LaneGetQuantizeIndex<V>(index_out, subset_src, inside, numEntries, maxEntries, clusters, channels3or4));
+
+            for (int k = 0; k < maxEntries; k++)
+                V::store(&indexData[k * Lanes], index_out[k]);
+
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                unsigned char* bestIndex = &storedBestindex[((firstPartition + lane) * BC7_SIMD_MAX_SUBSETS + subset) * BC7_SIMD_BLOCK_SIZE];
+                for (int k = 0; k < entryCount[lane]; k++)
+                    bestIndex[k] = (unsigned char)indexData[k * Lanes + lane];
+            }
+        }
+
+        V::store(laneData, err_quant);
+        for (int lane = 0; lane < numLanes; lane++)
+            storedError[firstPartition + lane] = laneData[lane];
+    }
+}
+
+#endif
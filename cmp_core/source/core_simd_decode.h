@@ -0,0 +1,307 @@
+//=====================================================================
+// Copyright 2023-2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#ifndef CORE_SIMD_DECODE_H_
+#define CORE_SIMD_DECODE_H_
+
+#include <string.h>
+
+// Lane generic row decoders for BC1 to BC5, used by the DecompressBlocksBCn API in cmp_core_decode.cpp.
+//
+// The colour palettes and alpha ramps are built in 16 bit fixed point, the divisions by 3, 5 and 7 of the
+// single block decoders are done as a multiply high by a rounded up reciprocal, which gives the same
+// result for every pair of endpoints. The pixels are written straight into the destination rows, so the
+// output is the same as the single block decoders.
+//
+// Each 128 bit lane holds one block, the lane type processes Blocks adjacent blocks at a time.
+//
+// The including file provides a lane type V with:
+//   vi, Blocks                          integer vector type, number of blocks per vector
+//   constant(c)                         the 16 byte pattern c in every block
+//   load8(p, stride)                    8 bytes per block from p + b * stride into the low half of the block
+//   loadRow(p), storeRow(p, a)          16 bytes per block, unaligned
+//   storeRowR8(p, a, row)               dword row of each block to p + b * 4
+//   shuffle8(a, ctrl)                   byte shuffle within each block
+//   and_, or_, add8, add16, mullo16, mulhi16 (unsigned), packus16
+//   slli16(a, n), srli16(a, n)
+//   gt16(a, b) (signed), eq16, maxu16, select(m, a, b)
+
+#define BCN_DECODE_MAX_BLOCKS 2
+
+// Copies the 8 byte blocks of a partial batch into a padded buffer, returns the blocks to read
+static inline const unsigned char* bcnPadBlocks(unsigned char        padded[BCN_DECODE_MAX_BLOCKS * 8],
+                                                const unsigned char* cmpBlocks,
+                                                unsigned int&        blockBytes,
+                                                int                  blocks,
+                                                int                  maxBlocks)
+{
+    if (blocks == maxBlocks)
+        return cmpBlocks;
+
+    memset(padded, 0, BCN_DECODE_MAX_BLOCKS * 8);
+    for (int i = 0; i < blocks; i++)
+        memcpy(padded + i * 8, cmpBlocks + (size_t)i * blockBytes, 8);
+    blockBytes = 8;
+
+    return padded;
+}
+
+// Expands the 565 endpoint in every word pair to 8 bits per channel, words r, g, b, 255 and bit replicated
+// to the full range
+template <class V, class vi = typename V::vi>
+static inline vi bcnExpand565(vi endpoint)
+{
+    static const unsigned short toTop[8]     = {1, 1, 1 << 11, 0, 1, 1, 1 << 11, 0};
+    static const unsigned short channel[8]   = {0xF800, 0x07E0, 0xF800, 0, 0xF800, 0x07E0, 0xF800, 0};
+    static const unsigned short toByte[8]    = {1 << 8, 1 << 13, 1 << 8, 0, 1 << 8, 1 << 13, 1 << 8, 0};
+    static const unsigned short replicate[8] = {1 << 11, 1 << 10, 1 << 11, 0, 1 << 11, 1 << 10, 1 << 11, 0};
+    static const unsigned short alpha[8]     = {0, 0, 0, 255, 0, 0, 0, 255};
+
+    vi c = V::mulhi16(V::and_(V::mullo16(endpoint, V::constant((const unsigned char*)toTop)), V::constant((const unsigned char*)channel)),
+                      V::constant((const unsigned char*)toByte));
+    c    = V::add16(c, V::mulhi16(c, V::constant((const unsigned char*)replicate)));
+
+    return V::or_(c, V::constant((const unsigned char*)alpha));
+}
+
+// Writes the 4x4 RGBA:8888 pixels of numBlocks BC1, BC2 or BC3 colour blocks
+template <class V, class vi = typename V::vi>
+static void bcnDecodeColorBlocks(unsigned char*       dst,            // first pixel of the first block
+                                 unsigned int         dstPitch,       // bytes between rows of pixels
+                                 const unsigned char* cmpBlocks,      // 8 byte colour block of the first block
+                                 unsigned int         blockBytes,     // bytes between compressed blocks
+                                 int                  numBlocks,
+                                 bool                 mapDecodeRGBA,  // RGBA order with rounded interpolation, else BGRA
+                                 bool                 isBC1)          // n0 <= n1 selects three colours and transparent black
+{
+    static const unsigned char  endpoint0[16] = {0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1};
+    static const unsigned char  endpoint1[16] = {2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3};
+    static const unsigned short weight2[8]    = {2, 2, 2, 2, 1, 1, 1, 1};
+    static const unsigned short weight1[8]    = {1, 1, 1, 1, 2, 2, 2, 2};
+    static const unsigned short rounding[8]   = {1, 1, 1, 1, 1, 1, 1, 1};
+    static const unsigned short third[8]      = {21846, 21846, 21846, 21846, 21846, 21846, 21846, 21846};
+    static const unsigned short half[8]       = {1 << 15, 1 << 15, 1 << 15, 1 << 15, 1 << 15, 1 << 15, 1 << 15, 1 << 15};
+    static const unsigned short color2[8]     = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0, 0, 0, 0};
+    static const unsigned char  bgra[16]      = {2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15};
+    static const unsigned char  rgba[16]      = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    static const unsigned char  zero[16]      = {0};
+
+    static const unsigned char indexBytes[16] = {4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7};
+    static const unsigned char colMask[16]    = {0x03, 0x0C, 0x30, 0xC0, 0x03, 0x0C, 0x30, 0xC0, 0x03, 0x0C, 0x30, 0xC0, 0x03, 0x0C, 0x30, 0xC0};
+    static const unsigned char col0[16]       = {0x0C, 0, 0, 0, 0x0C, 0, 0, 0, 0x0C, 0, 0, 0, 0x0C, 0, 0, 0};
+    static const unsigned char col1[16]       = {0, 0x0C, 0, 0, 0, 0x0C, 0, 0, 0, 0x0C, 0, 0, 0, 0x0C, 0, 0};
+    static const unsigned char col2[16]       = {0, 0, 0x0C, 0, 0, 0, 0x0C, 0, 0, 0, 0x0C, 0, 0, 0, 0x0C, 0};
+    static const unsigned char col3[16]       = {0, 0, 0, 0x0C, 0, 0, 0, 0x0C, 0, 0, 0, 0x0C, 0, 0, 0, 0x0C};
+    static const unsigned char pixelRow[4][16] = {{0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3},
+                                                  {4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7},
+                                                  {8, 8, 8, 8, 9, 9, 9, 9, 10, 10, 10, 10, 11, 11, 11, 11},
+                                                  {12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15}};
+    static const unsigned char channel[16]    = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3};
+
+    const vi roundingV = V::constant(mapDecodeRGBA ? (const unsigned char*)rounding : zero);
+    const vi orderV    = V::constant(mapDecodeRGBA ? rgba : bgra);
+
+    for (int first = 0; first < numBlocks; first += V::Blocks)
+    {
+        int                  blocks = numBlocks - first < V::Blocks ? numBlocks - first : V::Blocks;
+        unsigned int         stride = blockBytes;
+        unsigned char        blocksPadded[BCN_DECODE_MAX_BLOCKS * 8];
+        const unsigned char* block  = bcnPadBlocks(blocksPadded, cmpBlocks + (size_t)first * blockBytes, stride, blocks, V::Blocks);
+
+        vi bits = V::load8(block, stride);
+        vi n0   = V::shuffle8(bits, V::constant(endpoint0));
+        vi n1   = V::shuffle8(bits, V::constant(endpoint1));
+        vi c0   = bcnExpand565<V>(n0);
+        vi c1   = bcnExpand565<V>(n1);
+
+        // colours 2 and 3 are (2 * c0 + c1) / 3 and (c0 + 2 * c1) / 3, or for the BC1 three colour mode (c0 + c1) / 2 and zero
+        vi c23 = V::mulhi16(V::add16(V::add16(V::mullo16(c0, V::constant((const unsigned char*)weight2)), V::mullo16(c1, V::constant((const unsigned char*)weight1))), roundingV),
+                            V::constant((const unsigned char*)third));
+        if (isBC1)
+        {
+            vi threeColor = V::eq16(V::maxu16(n0, n1), n1);
+            vi c2         = V::and_(V::mulhi16(V::add16(c0, c1), V::constant((const unsigned char*)half)), V::constant((const unsigned char*)color2));
+            c23           = V::select(threeColor, c2, c23);
+        }
+
+        // c0 and c1 are in both halves of the words, keep c0 in the first half and c1 in the second
+        vi c01 = V::select(V::constant((const unsigned char*)color2), c0, c1);
+        vi pal = V::shuffle8(V::packus16(c01, c23), orderV);
+
+        // palette byte offset of each pixel, (index >> (2 * col)) & 3) * 4 in byte row * 4 + col
+        vi idx  = V::and_(V::shuffle8(bits, V::constant(indexBytes)), V::constant(colMask));
+        vi offs = V::or_(V::or_(V::and_(V::slli16(idx, 2), V::constant(col0)), V::and_(idx, V::constant(col1))),
+                         V::or_(V::and_(V::srli16(idx, 2), V::constant(col2)), V::and_(V::srli16(idx, 4), V::constant(col3))));
+
+        for (int row = 0; row < 4; row++)
+        {
+            vi ctrl   = V::add8(V::shuffle8(offs, V::constant(pixelRow[row])), V::constant(channel));
+            vi pixels = V::shuffle8(pal, ctrl);
+
+            unsigned char* dstRow = dst + (size_t)row * dstPitch + first * 16;
+            if (blocks == V::Blocks)
+                V::storeRow(dstRow, pixels);
+            else
+            {
+                unsigned char rowPadded[BCN_DECODE_MAX_BLOCKS * 16];
+                V::storeRow(rowPadded, pixels);
+                memcpy(dstRow, rowPadded, blocks * 16);
+            }
+        }
+    }
+}
+
+// Shared by the alpha decoders, writes 16 alpha values per block as single channel pixels or into the
+// alpha byte of RGBA:8888 pixels
+template <class V, class vi = typename V::vi>
+static void bcnWriteAlphaBlocks(unsigned char* dst, unsigned int dstPitch, unsigned int pixelBytes, vi alpha, int first, int blocks)
+{
+    static const unsigned char alphaRow[4][16] = {{0x80, 0x80, 0x80, 0, 0x80, 0x80, 0x80, 1, 0x80, 0x80, 0x80, 2, 0x80, 0x80, 0x80, 3},
+                                                  {0x80, 0x80, 0x80, 4, 0x80, 0x80, 0x80, 5, 0x80, 0x80, 0x80, 6, 0x80, 0x80, 0x80, 7},
+                                                  {0x80, 0x80, 0x80, 8, 0x80, 0x80, 0x80, 9, 0x80, 0x80, 0x80, 10, 0x80, 0x80, 0x80, 11},
+                                                  {0x80, 0x80, 0x80, 12, 0x80, 0x80, 0x80, 13, 0x80, 0x80, 0x80, 14, 0x80, 0x80, 0x80, 15}};
+    static const unsigned char colorMask[16]   = {0xFF, 0xFF, 0xFF, 0, 0xFF, 0xFF, 0xFF, 0, 0xFF, 0xFF, 0xFF, 0, 0xFF, 0xFF, 0xFF, 0};
+
+    for (int row = 0; row < 4; row++)
+    {
+        unsigned char* dstRow = dst + (size_t)row * dstPitch + first * pixelBytes * 4;
+
+        if (pixelBytes == 1)
+        {
+            if (blocks == V::Blocks)
+                V::storeRowR8(dstRow, alpha, row);
+            else
+            {
+                unsigned char rowPadded[BCN_DECODE_MAX_BLOCKS * 4];
+                V::storeRowR8(rowPadded, alpha, row);
+                memcpy(dstRow, rowPadded, blocks * 4);
+            }
+        }
+        else
+        {
+            unsigned char  rowPadded[BCN_DECODE_MAX_BLOCKS * 16];
+            unsigned char* rgba = dstRow;
+            if (blocks < V::Blocks)
+            {
+                memcpy(rowPadded, dstRow, blocks * 16);
+                rgba = rowPadded;
+            }
+
+            vi pixels = V::or_(V::and_(V::loadRow(rgba), V::constant(colorMask)), V::shuffle8(alpha, V::constant(alphaRow[row])));
+            V::storeRow(rgba, pixels);
+
+            if (blocks < V::Blocks)
+                memcpy(dstRow, rowPadded, blocks * 16);
+        }
+    }
+}
+
+// Decodes numBlocks BC4 style alpha blocks (BC3 alpha, BC4, and either channel of BC5)
+template <class V, class vi = typename V::vi>
+static void bcnDecodeAlphaBlocks(unsigned char*       dst,         // first pixel of the first block
+                                 unsigned int         dstPitch,    // bytes between rows of pixels
+                                 unsigned int         pixelBytes,  // 1 for single channel pixels, 4 to set the alpha of RGBA:8888 pixels
+                                 const unsigned char* cmpBlocks,   // 8 byte alpha block of the first block
+                                 unsigned int         blockBytes,  // bytes between compressed blocks
+                                 int                  numBlocks)
+{
+    // alpha0 > alpha1 gives 6 interpolated values (w0 * alpha0 + w1 * alpha1 + 3) / 7, else 4 interpolated
+    // values (w0 * alpha0 + w1 * alpha1 + 2) / 5 followed by 0 and 255
+    static const unsigned char  alpha0[16]    = {0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80};
+    static const unsigned char  alpha1[16]    = {1, 0x80, 1, 0x80, 1, 0x80, 1, 0x80, 1, 0x80, 1, 0x80, 1, 0x80, 1, 0x80};
+    static const unsigned short weight0_7[8]  = {7, 0, 6, 5, 4, 3, 2, 1};
+    static const unsigned short weight1_7[8]  = {0, 7, 1, 2, 3, 4, 5, 6};
+    static const unsigned short rounding7[8]  = {3, 3, 3, 3, 3, 3, 3, 3};
+    static const unsigned short seventh[8]    = {9363, 9363, 9363, 9363, 9363, 9363, 9363, 9363};
+    static const unsigned short weight0_5[8]  = {5, 0, 4, 3, 2, 1, 0, 0};
+    static const unsigned short weight1_5[8]  = {0, 5, 1, 2, 3, 4, 0, 0};
+    static const unsigned short rounding5[8]  = {2, 2, 2, 2, 2, 2, 0, 0};
+    static const unsigned short fifth[8]      = {13108, 13108, 13108, 13108, 13108, 13108, 0, 0};
+    static const unsigned short opaque5[8]    = {0, 0, 0, 0, 0, 0, 0, 255};
+
+    // pixel i has its 3 bit index at bit 16 + 3 * i of the block, gather the two bytes holding it into a
+    // 16 bit word and shift the index up to bits 7..9 with a multiply
+    static const unsigned char  gatherLo[16] = {2, 3, 2, 3, 2, 3, 3, 4, 3, 4, 3, 4, 4, 5, 4, 5};
+    static const unsigned char  gatherHi[16] = {5, 6, 5, 6, 5, 6, 6, 7, 6, 7, 6, 7, 7, 0x80, 7, 0x80};
+    static const unsigned short shiftLo[8]   = {1 << 7, 1 << 4, 1 << 1, 1 << 6, 1 << 3, 1 << 0, 1 << 5, 1 << 2};
+    static const unsigned short sevens[8]    = {7, 7, 7, 7, 7, 7, 7, 7};
+
+    for (int first = 0; first < numBlocks; first += V::Blocks)
+    {
+        int                  blocks = numBlocks - first < V::Blocks ? numBlocks - first : V::Blocks;
+        unsigned int         stride = blockBytes;
+        unsigned char        blocksPadded[BCN_DECODE_MAX_BLOCKS * 8];
+        const unsigned char* block  = bcnPadBlocks(blocksPadded, cmpBlocks + (size_t)first * blockBytes, stride, blocks, V::Blocks);
+
+        vi bits = V::load8(block, stride);
+        vi a0   = V::shuffle8(bits, V::constant(alpha0));
+        vi a1   = V::shuffle8(bits, V::constant(alpha1));
+
+        vi ramp7 = V::add16(V::add16(V::mullo16(a0, V::constant((const unsigned char*)weight0_7)), V::mullo16(a1, V::constant((const unsigned char*)weight1_7))),
+                            V::constant((const unsigned char*)rounding7));
+        vi ramp5 = V::add16(V::add16(V::mullo16(a0, V::constant((const unsigned char*)weight0_5)), V::mullo16(a1, V::constant((const unsigned char*)weight1_5))),
+                            V::constant((const unsigned char*)rounding5));
+        ramp7    = V::mulhi16(ramp7, V::constant((const unsigned char*)seventh));
+        ramp5    = V::or_(V::mulhi16(ramp5, V::constant((const unsigned char*)fifth)), V::constant((const unsigned char*)opaque5));
+        vi ramp  = V::select(V::gt16(a0, a1), ramp7, ramp5);
+
+        vi lo = V::and_(V::srli16(V::mullo16(V::shuffle8(bits, V::constant(gatherLo)), V::constant((const unsigned char*)shiftLo)), 7),
+                        V::constant((const unsigned char*)sevens));
+        vi hi = V::and_(V::srli16(V::mullo16(V::shuffle8(bits, V::constant(gatherHi)), V::constant((const unsigned char*)shiftLo)), 7),
+                        V::constant((const unsigned char*)sevens));
+
+        vi alpha = V::shuffle8(V::packus16(ramp, ramp), V::packus16(lo, hi));
+
+        bcnWriteAlphaBlocks<V>(dst, dstPitch, pixelBytes, alpha, first, blocks);
+    }
+}
+
+// Decodes numBlocks BC2 explicit 4 bit alpha blocks into the alpha byte of RGBA:8888 pixels
+template <class V, class vi = typename V::vi>
+static void bcnDecodeExplicitAlphaBlocks(unsigned char*       dst,         // first pixel of the first block
+                                         unsigned int         dstPitch,    // bytes between rows of pixels
+                                         const unsigned char* cmpBlocks,   // 8 byte alpha block of the first block
+                                         unsigned int         blockBytes,  // bytes between compressed blocks
+                                         int                  numBlocks)
+{
+    static const unsigned char pairs[16]    = {0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7};
+    static const unsigned char lowMask[16]  = {0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0};
+    static const unsigned char highMask[16] = {0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F, 0, 0x0F};
+
+    for (int first = 0; first < numBlocks; first += V::Blocks)
+    {
+        int                  blocks = numBlocks - first < V::Blocks ? numBlocks - first : V::Blocks;
+        unsigned int         stride = blockBytes;
+        unsigned char        blocksPadded[BCN_DECODE_MAX_BLOCKS * 8];
+        const unsigned char* block  = bcnPadBlocks(blocksPadded, cmpBlocks + (size_t)first * blockBytes, stride, blocks, V::Blocks);
+
+        // even pixels use the low nibble of their byte and odd pixels the high nibble, a = (n << 4) | n
+        vi bytes   = V::shuffle8(V::load8(block, stride), V::constant(pairs));
+        vi nibbles = V::or_(V::and_(bytes, V::constant(lowMask)), V::and_(V::srli16(bytes, 4), V::constant(highMask)));
+        vi alpha   = V::or_(nibbles, V::slli16(nibbles, 4));
+
+        bcnWriteAlphaBlocks<V>(dst, dstPitch, 4, alpha, first, blocks);
+    }
+}
+
+#endif
@@ -0,0 +1,117 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#ifndef CORE_SIMD_ETC_H_
+#define CORE_SIMD_ETC_H_
+
+// Lane generic palette error evaluation for the ETC1 and ETC2 encoders in etc_encode_kernel.cpp.
+//
+// Each SIMD lane evaluates one candidate palette of four colors against a set of pixels: an ETC1 base color
+// with one of the eight modifier tables, or an ETC2 T or H mode color pair with one of the eight distances.
+// Every pixel picks the palette entry with the lowest weighted squared error and the errors are summed over
+// the pixels. The scalar encoder instantiates the same template with a single lane, so the errors of all
+// code paths are bit identical.
+//
+// The including file provides a lane type V with:
+//   vf, Lanes               float vector type, number of lanes
+//   zero, set1, load, store (unaligned)
+//   add, sub, mul, min
+
+#define ETC_SIMD_MAX_PALETTES 512  // capacity of each palette channel row, a multiple of the widest lane count
+#define ETC_SIMD_MAX_LANES 16
+
+template <class V, class vf = typename V::vf>
+static void etcPaletteErrors(float*       errors,       // [numPalettes] output
+                             const float* palettes,     // [(entry * 3 + channel) * ETC_SIMD_MAX_PALETTES + palette]
+                             int          numPalettes,
+                             const float* pixels,       // [numPixels][3] RGB values of the pixels
+                             int          numPixels,
+                             const float* weights)      // [3] channel weights
+{
+    const vf weightR = V::set1(weights[0]);
+    const vf weightG = V::set1(weights[1]);
+    const vf weightB = V::set1(weights[2]);
+    const vf large   = V::set1(1e30f);
+
+    for (int first = 0; first < numPalettes; first += V::Lanes)
+    {
+        int lanes = numPalettes - first < V::Lanes ? numPalettes - first : V::Lanes;
+
+        vf entries[12];
+
+        if (lanes == V::Lanes)
+        {
+            for (int i = 0; i < 12; i++)
+                entries[i] = V::load(palettes + i * ETC_SIMD_MAX_PALETTES + first);
+        }
+        else
+        {
+            // pad the last palettes with black, those lanes are not stored
+            float padded[ETC_SIMD_MAX_LANES];
+
+            for (int i = 0; i < 12; i++)
+            {
+                for (int lane = 0; lane < V::Lanes; lane++)
+                    padded[lane] = lane < lanes ? palettes[i * ETC_SIMD_MAX_PALETTES + first + lane] : 0.0f;
+
+                entries[i] = V::load(padded);
+            }
+        }
+
+        vf error = V::zero();
+
+        for (int i = 0; i < numPixels; i++)
+        {
+            vf r = V::set1(pixels[i * 3 + 0]);
+            vf g = V::set1(pixels[i * 3 + 1]);
+            vf b = V::set1(pixels[i * 3 + 2]);
+
+            vf best = large;
+
+            for (int k = 0; k < 4; k++)
+            {
+                vf dr = V::sub(r, entries[k * 3 + 0]);
+                vf dg = V::sub(g, entries[k * 3 + 1]);
+                vf db = V::sub(b, entries[k * 3 + 2]);
+
+                vf e = V::add(V::add(V::mul(weightR, V::mul(dr, dr)), V::mul(weightG, V::mul(dg, dg))), V::mul(weightB, V::mul(db, db)));
+                best = V::min(best, e);
+            }
+
+            error = V::add(error, best);
+        }
+
+        if (lanes == V::Lanes)
+            V::store(errors + first, error);
+        else
+        {
+            float errorPadded[ETC_SIMD_MAX_LANES];
+
+            V::store(errorPadded, error);
+            for (int i = 0; i < lanes; i++)
+                errors[first + i] = errorPadded[i];
+        }
+    }
+}
+
+#endif
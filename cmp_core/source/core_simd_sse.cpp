@@ -27,6 +27,11 @@
 #include <smmintrin.h>
 
 #include "core_simd.h"
+#include "core_simd_bc1.h"
+#include "core_simd_bc4.h"
+#include "core_simd_bc6.h"
+#include "core_simd_etc.h"
+#include "core_simd_decode.h"
 #include "common_def.h"
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -198,4 +203,170 @@ CGU_FLOAT sse_bc1ComputeBestEndpoints(CGU_FLOAT endpointsOut[2],
     return minError;
 }
 
+// Lane type for the lane generic BC1 to BC3, BC4, BC6H and ETC code
+
+struct SSE4Lanes
+{
+    typedef __m128  vf;
+    typedef __m128  vm;
+    typedef __m128i vi;
+
+    static const int Lanes = 4;
+
+    static inline vf zero() { return _mm_setzero_ps(); }
+    static inline vf set1(float a) { return _mm_set1_ps(a); }
+    static inline vf load(const float* p) { return _mm_loadu_ps(p); }
+    static inline void store(float* p, vf a) { _mm_storeu_ps(p, a); }
+
+    static inline vi loadPixels(const unsigned char* p, unsigned int stride)
+    {
+        int pixels[4];
+        for (int i = 0; i < 4; i++)
+            memcpy(&pixels[i], p + i * stride, sizeof(int));
+        return _mm_loadu_si128((const __m128i*)pixels);
+    }
+    static inline vf channel(vi a, int shift) { return _mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(a, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(0xFF))); }
+
+    static inline vf add(vf a, vf b) { return _mm_add_ps(a, b); }
+    static inline vf sub(vf a, vf b) { return _mm_sub_ps(a, b); }
+    static inline vf mul(vf a, vf b) { return _mm_mul_ps(a, b); }
+    static inline vf div(vf a, vf b) { return _mm_div_ps(a, b); }
+    static inline vf min(vf a, vf b) { return _mm_min_ps(a, b); }
+    static inline vf max(vf a, vf b) { return _mm_max_ps(a, b); }
+    static inline vf floor(vf a) { return _mm_floor_ps(a); }
+    static inline vf ceil(vf a) { return _mm_ceil_ps(a); }
+    static inline vf trunc(vf a) { return _mm_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+    static inline vm lt(vf a, vf b) { return _mm_cmplt_ps(a, b); }
+    static inline vm le(vf a, vf b) { return _mm_cmple_ps(a, b); }
+    static inline vm ge(vf a, vf b) { return _mm_cmpge_ps(a, b); }
+    static inline vm eq(vf a, vf b) { return _mm_cmpeq_ps(a, b); }
+
+    static inline vm mand(vm a, vm b) { return _mm_and_ps(a, b); }
+    static inline int bits(vm a) { return _mm_movemask_ps(a); }
+
+    static inline vf select(vm m, vf a, vf b) { return _mm_blendv_ps(b, a, m); }
+};
+
+// Lane type for the BC1 to BC5 row decoders, one block per vector
+
+struct SSE4DecodeLanes
+{
+    typedef __m128i vi;
+
+    static const int Blocks = 1;
+
+    static inline vi constant(const unsigned char* c) { return _mm_loadu_si128((const __m128i*)c); }
+    static inline vi load8(const unsigned char* p, unsigned int) { return _mm_loadl_epi64((const __m128i*)p); }
+    static inline vi loadRow(const unsigned char* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static inline void storeRow(unsigned char* p, vi a) { _mm_storeu_si128((__m128i*)p, a); }
+    static inline void storeRowR8(unsigned char* p, vi a, int row)
+    {
+        unsigned char bytes[16];
+        _mm_storeu_si128((__m128i*)bytes, a);
+        memcpy(p, bytes + row * 4, 4);
+    }
+
+    static inline vi shuffle8(vi a, vi ctrl) { return _mm_shuffle_epi8(a, ctrl); }
+    static inline vi and_(vi a, vi b) { return _mm_and_si128(a, b); }
+    static inline vi or_(vi a, vi b) { return _mm_or_si128(a, b); }
+    static inline vi add8(vi a, vi b) { return _mm_add_epi8(a, b); }
+    static inline vi add16(vi a, vi b) { return _mm_add_epi16(a, b); }
+    static inline vi mullo16(vi a, vi b) { return _mm_mullo_epi16(a, b); }
+    static inline vi mulhi16(vi a, vi b) { return _mm_mulhi_epu16(a, b); }
+    static inline vi packus16(vi a, vi b) { return _mm_packus_epi16(a, b); }
+    static inline vi slli16(vi a, int n) { return _mm_sll_epi16(a, _mm_cvtsi32_si128(n)); }
+    static inline vi srli16(vi a, int n) { return _mm_srl_epi16(a, _mm_cvtsi32_si128(n)); }
+
+    static inline vi gt16(vi a, vi b) { return _mm_cmpgt_epi16(a, b); }
+    static inline vi eq16(vi a, vi b) { return _mm_cmpeq_epi16(a, b); }
+    static inline vi maxu16(vi a, vi b) { return _mm_max_epu16(a, b); }
+    static inline vi select(vi m, vi a, vi b) { return _mm_blendv_epi8(b, a, m); }
+};
+
+// BC1 to BC3 block batches
+
+unsigned int sse_bc1CompressBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    return bc1CompressBlocksMinMax<SSE4Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+void sse_bc3CompressAlphaBlocksMinMax(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    bc3CompressAlphaBlocksMinMax<SSE4Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+void sse_bc2CompressExplicitAlphaBlocks(unsigned char* cmpBlocks, unsigned int cmpBlockBytes, const unsigned char* srcBlocks, int numBlocks)
+{
+    bc2CompressExplicitAlphaBlocks<SSE4Lanes>(cmpBlocks, cmpBlockBytes, srcBlocks, numBlocks);
+}
+
+// BC1 to BC5 decoding
+
+void sse_bcnDecodeColorBlocks(unsigned char*       dst,
+                              unsigned int         dstPitch,
+                              const unsigned char* cmpBlocks,
+                              unsigned int         blockBytes,
+                              int                  numBlocks,
+                              bool                 mapDecodeRGBA,
+                              bool                 isBC1)
+{
+    bcnDecodeColorBlocks<SSE4DecodeLanes>(dst, dstPitch, cmpBlocks, blockBytes, numBlocks, mapDecodeRGBA, isBC1);
+}
+
+void sse_bcnDecodeAlphaBlocks(unsigned char*       dst,
+                              unsigned int         dstPitch,
+                              unsigned int         pixelBytes,
+                              const unsigned char* cmpBlocks,
+                              unsigned int         blockBytes,
+                              int                  numBlocks)
+{
+    bcnDecodeAlphaBlocks<SSE4DecodeLanes>(dst, dstPitch, pixelBytes, cmpBlocks, blockBytes, numBlocks);
+}
+
+void sse_bcnDecodeExplicitAlphaBlocks(unsigned char* dst, unsigned int dstPitch, const unsigned char* cmpBlocks, unsigned int blockBytes, int numBlocks)
+{
+    bcnDecodeExplicitAlphaBlocks<SSE4DecodeLanes>(dst, dstPitch, cmpBlocks, blockBytes, numBlocks);
+}
+
+// BC4, BC5
+
+void sse_bc4RampErrors(float*       errors,
+                       const float* lows,
+                       const float* highs,
+                       int          numRamps,
+                       const float* values,
+                       const float* repeats,
+                       int          numValues)
+{
+    bc4RampErrors<SSE4Lanes>(errors, lows, highs, numRamps, values, repeats, numValues);
+}
+
+// BC6H
+
+float sse_bc6ShakeEndpointCube(int*         idx_out,
+                               float*       out,
+                               int*         s1_out,
+                               const float* data,
+                               int          numEntries,
+                               const float* rampWeights,
+                               int          clusters,
+                               const float* epd,
+                               int          channels3or4)
+{
+    return bc6ShakeEndpointCube<SSE4Lanes>(idx_out, out, s1_out, data, numEntries, rampWeights, clusters, epd, channels3or4);
+}
+
+// ETC1, ETC2
+
+void sse_etcPaletteErrors(float*       errors,
+                          const float* palettes,
+                          int          numPalettes,
+                          const float* pixels,
+                          int          numPixels,
+                          const float* weights)
+{
+    etcPaletteErrors<SSE4Lanes>(errors, palettes, numPalettes, pixels, numPixels, weights);
+}
+
 #endif
@@ -27,27 +27,24 @@
 #include "cmp_boxfilter.h"
 #include "format_conversion.h"
 #include "atiformats.h"
+#include "mathmacros.h"
+#include "halfconvert.h"
+#include "cmp_threadpool.h"
 
-// the filter used for mipmap generation, holds pixel pointers for the four corners of the box
-union BoxFilter
-{
-    BoxFilter()
-        : tl(0)
-        , tr(0)
-        , bl(0)
-        , br(0)
-    {
-    }
+#include <vector>
 
-    struct
-    {
-        CMP_BYTE* tl;
-        CMP_BYTE* tr;
-        CMP_BYTE* bl;
-        CMP_BYTE* br;
-    };
-    CMP_BYTE* pixels[4];
-};
+#if defined(_M_X64) || defined(__SSE2__)
+#define CMP_BOXFILTER_SSE2
+#include <immintrin.h>
+
+// The half float kernel has an F16C path that is compiled for its own target and only called when the half
+// conversions use F16C
+#if defined(__GNUC__) || defined(__clang__)
+#define CMP_BOXFILTER_F16C_TARGET __attribute__((target("avx,f16c")))
+#else
+#define CMP_BOXFILTER_F16C_TARGET
+#endif
+#endif
 
 void CMP_SetMipLevelGammaLinearB(MipLevel* pCurMipLevel, CMP_BYTE* pdata, CMP_FLOAT Gamma, CMP_INT numchannels)
 {
@@ -190,163 +187,396 @@ void CMP_SetMipSetGamma(MipSet* pMipSet, CMP_FLOAT Gamma)
     }
 }
 
-void GenerateMipmapLevel(MipLevel* currMipLevel, MipLevel** prevMipLevels, uint32_t numPrevLevels, CMP_FORMAT format)
-{
-    static const uint32_t numChannels = 4;
-
-    assert(currMipLevel);
-    assert(prevMipLevels);
-    assert(numPrevLevels != 0);
-
-    if (!currMipLevel || !prevMipLevels || !prevMipLevels[0] || numPrevLevels == 0)
-        return;
+// Box filter mipmap generation
+//
+// A destination pixel is the rounded average of the 2x2 source pixels in each previous level, a dimension that is
+// already 1 repeats its single column or row. Odd source sizes drop their last column or row, as the size of the
+// new level is rounded down. Each channel format has its own row kernel so the format is only checked once per
+// level, the SSE2 and scalar code of a kernel give identical results.
 
-    bool heightsDifferent = currMipLevel->m_nHeight != prevMipLevels[0]->m_nHeight;
-    bool widthsDifferent  = currMipLevel->m_nWidth != prevMipLevels[0]->m_nWidth;
-    assert(heightsDifferent || widthsDifferent);
+#define CMP_BOXFILTER_MAX_SOURCES 2       // a volume level averages two slices of the previous level
+#define CMP_BOXFILTER_TILE_PIXELS 65536   // destination pixels per thread pool task
 
-    CMP_ChannelFormat channelFormat = GetChannelFormat(format);
+struct CMP_BoxFilterLevel;
 
-    const uint32_t bytesPerChannel = GetChannelFormatBitSize(format) / 8;
-    uint32_t       bytesPerPixel   = bytesPerChannel * numChannels;
+// Filters the destination rows [firstRow, endRow) of a level
+typedef void (*CMP_BoxFilterRowsProc)(const CMP_BoxFilterLevel& level, CMP_INT firstRow, CMP_INT endRow);
 
-    if (format == CMP_FORMAT_ARGB_2101010 || format == CMP_FORMAT_RGBA_1010102)
-        bytesPerPixel = 4;
+struct CMP_BoxFilterLevel
+{
+    CMP_BoxFilterRowsProc filterRows;
+    MipLevel*             dest;
+    MipLevel*             sources[CMP_BOXFILTER_MAX_SOURCES];
+    CMP_INT               numSources;
+    bool                  halveWidth;
+    bool                  halveHeight;
+};
 
-    CMP_BYTE* destPixel = currMipLevel->m_pbData;
+#ifdef CMP_BOXFILTER_SSE2
+// Loads 8 consecutive 32 bit pixels and splits them into the even and the odd pixels
+static inline void CMP_BoxFilterLoadPairs(const CMP_BYTE* src, __m128i& even, __m128i& odd)
+{
+    __m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)src));
+    __m128 b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(src + 16)));
+    even     = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    odd      = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+#endif
 
-    // A set of 4 pixels per previous level, used for averaging the result value
-    std::vector<BoxFilter> levels(numPrevLevels);
+// Row kernels: Row() averages numRows source rows (2 per source level) into width destination pixels.
+// The number of taps per pixel is 2 * numRows, which is 4 or 8.
 
-    const uint32_t numPixelsPerBlock = sizeof(levels[0].pixels) / sizeof(levels[0].pixels[0]);
-    const uint32_t totalNumPixels    = numPrevLevels * numPixelsPerBlock;
+// 8 bit RGBA, signed channels are offset by 128 so that both use the same unsigned sums
+template <bool Signed>
+struct CMP_BoxFilterRGBA8
+{
+    static const CMP_INT BytesPerPixel = 4;
 
-    for (uint32_t y = 0; y < currMipLevel->m_nHeight; ++y)
+    static void Row(CMP_BYTE* dest, const CMP_BYTE* const* rows, CMP_INT numRows, CMP_INT width, bool halveWidth)
     {
-        // update all of the previous layer pixel pointers
-        for (uint32_t i = 0; i < numPrevLevels; ++i)
-        {
-            levels[i].tl = prevMipLevels[i]->m_pbData + 2 * y * prevMipLevels[i]->m_nWidth * bytesPerPixel;
+        const CMP_INT  shift = (numRows == 2) ? 2 : 3;
+        const CMP_BYTE flip  = Signed ? 0x80 : 0x00;
+        CMP_INT        x     = 0;
 
-            levels[i].bl = levels[i].tl;
-            if (heightsDifferent)
-                levels[i].bl = levels[i].tl + prevMipLevels[i]->m_nWidth * bytesPerPixel;
+#ifdef CMP_BOXFILTER_SSE2
+        if (halveWidth)
+        {
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128i flipv = _mm_set1_epi8((char)flip);
+            const __m128i round = _mm_set1_epi16((short)numRows);
+            const __m128i count = _mm_cvtsi32_si128(shift);
 
-            levels[i].tr = levels[i].tl;
-            levels[i].br = levels[i].bl;
-            if (widthsDifferent)
+            // 4 destination pixels from 8 source pixels of each row, the sums fit in 16 bits
+            for (; x + 4 <= width; x += 4)
             {
-                levels[i].tr = levels[i].tl + bytesPerPixel;
-                levels[i].br = levels[i].bl + bytesPerPixel;
+                __m128i lo = zero;
+                __m128i hi = zero;
+                for (CMP_INT r = 0; r < numRows; r++)
+                {
+                    __m128i even, odd;
+                    CMP_BoxFilterLoadPairs(rows[r] + x * 8, even, odd);
+                    even = _mm_xor_si128(even, flipv);
+                    odd  = _mm_xor_si128(odd, flipv);
+                    lo   = _mm_add_epi16(lo, _mm_add_epi16(_mm_unpacklo_epi8(even, zero), _mm_unpacklo_epi8(odd, zero)));
+                    hi   = _mm_add_epi16(hi, _mm_add_epi16(_mm_unpackhi_epi8(even, zero), _mm_unpackhi_epi8(odd, zero)));
+                }
+                lo = _mm_srl_epi16(_mm_add_epi16(lo, round), count);
+                hi = _mm_srl_epi16(_mm_add_epi16(hi, round), count);
+                _mm_storeu_si128((__m128i*)(dest + x * 4), _mm_xor_si128(_mm_packus_epi16(lo, hi), flipv));
             }
         }
+#endif
 
-        for (uint32_t x = 0; x < currMipLevel->m_nWidth; ++x)
+        for (; x < width; x++)
         {
-            if (format == CMP_FORMAT_RGBA_1010102)
+            CMP_INT x0 = halveWidth ? 2 * x : x;
+            CMP_INT x1 = halveWidth ? 2 * x + 1 : x;
+            for (CMP_INT ch = 0; ch < 4; ch++)
             {
-                CMP_DWORD r = 0;
-                CMP_DWORD g = 0;
-                CMP_DWORD b = 0;
-                CMP_DWORD a = 0;
+                CMP_INT sum = 0;
+                for (CMP_INT r = 0; r < numRows; r++)
+                    sum += (rows[r][x0 * 4 + ch] ^ flip) + (rows[r][x1 * 4 + ch] ^ flip);
+                dest[x * 4 + ch] = (CMP_BYTE)(((sum + numRows) >> shift) ^ flip);
+            }
+        }
+    }
+};
 
-                for (uint32_t levelIndex = 0; levelIndex < numPrevLevels; ++levelIndex)
-                {
-                    for (uint32_t pixelIndex = 0; pixelIndex < numPixelsPerBlock; ++pixelIndex)
-                    {
-                        r += RGBA1010102_GET_R(*((CMP_DWORD*)levels[levelIndex].pixels[pixelIndex]));
-                        g += RGBA1010102_GET_G(*((CMP_DWORD*)levels[levelIndex].pixels[pixelIndex]));
-                        b += RGBA1010102_GET_B(*((CMP_DWORD*)levels[levelIndex].pixels[pixelIndex]));
-                        a += RGBA1010102_GET_A(*((CMP_DWORD*)levels[levelIndex].pixels[pixelIndex]));
-                    }
-                }
+// 10:10:10:2 packed pixels, the RGBA1010102 and ARGB2101010 fields are at the same bit offsets
+struct CMP_BoxFilter1010102
+{
+    static const CMP_INT BytesPerPixel = 4;
 
-                r /= totalNumPixels;
-                g /= totalNumPixels;
-                b /= totalNumPixels;
-                a /= totalNumPixels;
+    static void Row(CMP_BYTE* dest, const CMP_BYTE* const* rows, CMP_INT numRows, CMP_INT width, bool halveWidth)
+    {
+        const CMP_INT shift = (numRows == 2) ? 2 : 3;
+        CMP_DWORD*    out   = (CMP_DWORD*)dest;
+        CMP_INT       x     = 0;
 
-                CMP_DWORD pixelValue = (r << RGBA1010102_OFFSET_R) | (g << RGBA1010102_OFFSET_G) | (b << RGBA1010102_OFFSET_B) | (a << RGBA1010102_OFFSET_A);
+#ifdef CMP_BOXFILTER_SSE2
+        if (halveWidth)
+        {
+            const __m128i mask  = _mm_set1_epi32(TEN_BIT_MASK);
+            const __m128i round = _mm_set1_epi32(numRows);
+            const __m128i count = _mm_cvtsi32_si128(shift);
 
-                *((CMP_DWORD*)destPixel) = pixelValue;
-                destPixel += bytesPerPixel;
-            }
-            else if (format == CMP_FORMAT_RGBA_8888_S || format == CMP_FORMAT_ARGB_8888_S)
+            for (; x + 4 <= width; x += 4)
             {
-                for (uint32_t i = 0; i < numChannels; ++i)
+                __m128i r = _mm_setzero_si128();
+                __m128i g = _mm_setzero_si128();
+                __m128i b = _mm_setzero_si128();
+                __m128i a = _mm_setzero_si128();
+                for (CMP_INT row = 0; row < numRows; row++)
                 {
-                    CMP_SBYTE pixelValue = 0;
-                    for (uint32_t j = 0; j < numPrevLevels; ++j)
-                    {
-                        pixelValue += (*((CMP_SBYTE*)levels[j].tl + i) + *((CMP_SBYTE*)levels[j].tr + i) + *((CMP_SBYTE*)levels[j].bl + i) +
-                                       *((CMP_SBYTE*)levels[j].br + i)) /
-                                      4;
-                    }
-
-                    *((CMP_SBYTE*)destPixel) = pixelValue;
-                    destPixel += bytesPerChannel;
+                    __m128i even, odd;
+                    CMP_BoxFilterLoadPairs(rows[row] + x * 8, even, odd);
+                    r = _mm_add_epi32(r, _mm_add_epi32(_mm_and_si128(even, mask), _mm_and_si128(odd, mask)));
+                    g = _mm_add_epi32(g, _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(even, 10), mask), _mm_and_si128(_mm_srli_epi32(odd, 10), mask)));
+                    b = _mm_add_epi32(b, _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(even, 20), mask), _mm_and_si128(_mm_srli_epi32(odd, 20), mask)));
+                    a = _mm_add_epi32(a, _mm_add_epi32(_mm_srli_epi32(even, 30), _mm_srli_epi32(odd, 30)));
                 }
+                r = _mm_srl_epi32(_mm_add_epi32(r, round), count);
+                g = _mm_srl_epi32(_mm_add_epi32(g, round), count);
+                b = _mm_srl_epi32(_mm_add_epi32(b, round), count);
+                a = _mm_srl_epi32(_mm_add_epi32(a, round), count);
+
+                __m128i pixels = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 10)), _mm_or_si128(_mm_slli_epi32(b, 20), _mm_slli_epi32(a, 30)));
+                _mm_storeu_si128((__m128i*)(out + x), pixels);
             }
-            else if (channelFormat == CF_8bit)
-            {
-                for (uint32_t i = 0; i < numChannels; ++i)
-                {
-                    CMP_BYTE pixelValue = 0;
-                    for (uint32_t j = 0; j < numPrevLevels; ++j)
-                    {
-                        pixelValue += (*(levels[j].tl + i) + *(levels[j].tr + i) + *(levels[j].bl + i) + *(levels[j].br + i)) / 4;
-                    }
+        }
+#endif
 
-                    *destPixel = pixelValue;
-                    destPixel += bytesPerChannel;
-                }
+        for (; x < width; x++)
+        {
+            CMP_INT   x0 = halveWidth ? 2 * x : x;
+            CMP_INT   x1 = halveWidth ? 2 * x + 1 : x;
+            CMP_DWORD r = 0, g = 0, b = 0, a = 0;
+            for (CMP_INT row = 0; row < numRows; row++)
+            {
+                const CMP_DWORD* pixels = (const CMP_DWORD*)rows[row];
+                r += RGBA1010102_GET_R(pixels[x0]) + RGBA1010102_GET_R(pixels[x1]);
+                g += RGBA1010102_GET_G(pixels[x0]) + RGBA1010102_GET_G(pixels[x1]);
+                b += RGBA1010102_GET_B(pixels[x0]) + RGBA1010102_GET_B(pixels[x1]);
+                a += RGBA1010102_GET_A(pixels[x0]) + RGBA1010102_GET_A(pixels[x1]);
             }
-            else if (channelFormat == CF_Float16)
+            r = (r + numRows) >> shift;
+            g = (g + numRows) >> shift;
+            b = (b + numRows) >> shift;
+            a = (a + numRows) >> shift;
+
+            out[x] = (r << RGBA1010102_OFFSET_R) | (g << RGBA1010102_OFFSET_G) | (b << RGBA1010102_OFFSET_B) | (a << RGBA1010102_OFFSET_A);
+        }
+    }
+};
+
+// 32 bit float RGBA, each row adds its pixel pair to the sum which is then scaled by the exact power of 2 reciprocal
+struct CMP_BoxFilterF32
+{
+    static const CMP_INT BytesPerPixel = 16;
+
+    static void Row(CMP_BYTE* dest, const CMP_BYTE* const* rows, CMP_INT numRows, CMP_INT width, bool halveWidth)
+    {
+        const CMP_FLOAT scale = 1.0f / (CMP_FLOAT)(numRows * 2);
+        CMP_FLOAT*      out   = (CMP_FLOAT*)dest;
+        CMP_INT         x     = 0;
+
+#ifdef CMP_BOXFILTER_SSE2
+        if (halveWidth)
+        {
+            const __m128 scalev = _mm_set1_ps(scale);
+            for (; x < width; x++)
             {
-                for (uint32_t i = 0; i < numChannels; ++i)
+                __m128 sum = _mm_setzero_ps();
+                for (CMP_INT r = 0; r < numRows; r++)
                 {
-                    CMP_HALFSHORT pixelValue = 0;
-                    for (uint32_t j = 0; j < numPrevLevels; ++j)
-                    {
-                        pixelValue += (*((CMP_HALFSHORT*)levels[j].tl + i) + *((CMP_HALFSHORT*)levels[j].tr + i) + *((CMP_HALFSHORT*)levels[j].bl + i) +
-                                       *((CMP_HALFSHORT*)levels[j].br + i)) /
-                                      (CMP_HALFSHORT)4;
-                    }
-
-                    *((CMP_HALFSHORT*)destPixel) = pixelValue;
-                    destPixel += bytesPerChannel;
+                    const CMP_FLOAT* pixels = (const CMP_FLOAT*)rows[r] + x * 8;
+                    sum                     = _mm_add_ps(sum, _mm_add_ps(_mm_loadu_ps(pixels), _mm_loadu_ps(pixels + 4)));
                 }
+                _mm_storeu_ps(out + x * 4, _mm_mul_ps(sum, scalev));
             }
-            else if (channelFormat == CF_Float32)
+        }
+#endif
+
+        for (; x < width; x++)
+        {
+            CMP_INT x0 = halveWidth ? 2 * x : x;
+            CMP_INT x1 = halveWidth ? 2 * x + 1 : x;
+            for (CMP_INT ch = 0; ch < 4; ch++)
             {
-                for (uint32_t i = 0; i < numChannels; ++i)
+                CMP_FLOAT sum = 0.0f;
+                for (CMP_INT r = 0; r < numRows; r++)
                 {
-                    CMP_FLOAT pixelValue = 0;
-                    for (uint32_t j = 0; j < numPrevLevels; ++j)
-                    {
-                        pixelValue += (*((CMP_FLOAT*)levels[j].tl + i) + *((CMP_FLOAT*)levels[j].tr + i) + *((CMP_FLOAT*)levels[j].bl + i) +
-                                       *((CMP_FLOAT*)levels[j].br + i)) /
-                                      4.0f;
-                    }
-
-                    *((CMP_FLOAT*)destPixel) = pixelValue;
-                    destPixel += bytesPerChannel;
+                    const CMP_FLOAT* pixels = (const CMP_FLOAT*)rows[r];
+                    sum += pixels[x0 * 4 + ch] + pixels[x1 * 4 + ch];
                 }
+                out[x * 4 + ch] = sum * scale;
             }
-            else
+        }
+    }
+};
+
+// 16 bit float RGBA, averaged as floats and rounded back to half once. With F16C the pixels are converted in the
+// row loop, up to the first pixel with an infinite or NAN tap. The rest of the row is converted in chunks by the
+// bulk half conversion and averaged by the float kernel. Both give the same results.
+struct CMP_BoxFilterF16
+{
+    static const CMP_INT BytesPerPixel = 8;
+    static const CMP_INT ChunkPixels   = 128;
+
+#ifdef CMP_BOXFILTER_SSE2
+    CMP_BOXFILTER_F16C_TARGET static CMP_INT RowF16C(CMP_BYTE* dest, const CMP_BYTE* const* rows, CMP_INT numRows, CMP_INT width)
+    {
+        const __m128i exponentMask = _mm_set1_epi16(0x7c00);
+        const __m128  scale        = _mm_set1_ps(1.0f / (CMP_FLOAT)(numRows * 2));
+
+        CMP_INT x = 0;
+        for (; x < width; x++)
+        {
+            __m128  sum     = _mm_setzero_ps();
+            __m128i special = _mm_setzero_si128();
+            for (CMP_INT r = 0; r < numRows; r++)
             {
-                assert(!"Unsupported format");
+                __m128i pair = _mm_loadu_si128((const __m128i*)(rows[r] + x * 16));
+                __m256  taps = _mm256_cvtph_ps(pair);
+
+                special = _mm_or_si128(special, _mm_cmpeq_epi16(_mm_and_si128(pair, exponentMask), exponentMask));
+                sum     = _mm_add_ps(sum, _mm_add_ps(_mm256_castps256_ps128(taps), _mm256_extractf128_ps(taps, 1)));
             }
+            if (_mm_movemask_epi8(special))
+                break;
 
-            // move all pixel pointers over to the next block in the row
-            for (uint32_t i = 0; i < numPrevLevels; ++i)
+            _mm_storel_epi64((__m128i*)(dest + x * 8), _mm_cvtps_ph(_mm_mul_ps(sum, scale), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        }
+
+        return x;
+    }
+#endif
+
+    static void Row(CMP_BYTE* dest, const CMP_BYTE* const* rows, CMP_INT numRows, CMP_INT width, bool halveWidth)
+    {
+        CMP_FLOAT       sourceRows[CMP_BOXFILTER_MAX_SOURCES * 2][ChunkPixels * 2 * 4];
+        CMP_FLOAT       destRow[ChunkPixels * 4];
+        const CMP_BYTE* floatRows[CMP_BOXFILTER_MAX_SOURCES * 2];
+        const CMP_INT   step = halveWidth ? 2 : 1;
+        CMP_INT         x    = 0;
+
+#ifdef CMP_BOXFILTER_SSE2
+        if (halveWidth && GetHalfConvertExtension() != HALF_CONVERT_SCALAR)
+            x = RowF16C(dest, rows, numRows, width);
+#endif
+
+        for (; x < width; x += ChunkPixels)
+        {
+            CMP_INT count = cmp_minT(ChunkPixels, width - x);
+            for (CMP_INT r = 0; r < numRows; r++)
             {
-                levels[i].tl += bytesPerPixel * 2;
-                levels[i].tr += bytesPerPixel * 2;
-                levels[i].bl += bytesPerPixel * 2;
-                levels[i].br += bytesPerPixel * 2;
+                HalfShortToFloat(sourceRows[r], (CMP_HALFSHORT*)rows[r] + x * step * 4, count * step * 4);
+                floatRows[r] = (const CMP_BYTE*)sourceRows[r];
             }
+
+            CMP_BoxFilterF32::Row((CMP_BYTE*)destRow, floatRows, numRows, count, halveWidth);
+            FloatToHalfShort((CMP_HALFSHORT*)dest + x * 4, destRow, count * 4);
+        }
+    }
+};
+
+template <class Kernel>
+static void CMP_BoxFilterRows(const CMP_BoxFilterLevel& level, CMP_INT firstRow, CMP_INT endRow)
+{
+    const CMP_INT   width   = level.dest->m_nWidth;
+    const CMP_INT   numRows = level.numSources * 2;
+    const CMP_BYTE* rows[CMP_BOXFILTER_MAX_SOURCES * 2];
+
+    for (CMP_INT y = firstRow; y < endRow; y++)
+    {
+        for (CMP_INT i = 0; i < level.numSources; i++)
+        {
+            const MipLevel* source = level.sources[i];
+            const size_t    pitch  = (size_t)source->m_nWidth * Kernel::BytesPerPixel;
+
+            rows[i * 2]     = source->m_pbData + (size_t)(level.halveHeight ? 2 * y : y) * pitch;
+            rows[i * 2 + 1] = level.halveHeight ? rows[i * 2] + pitch : rows[i * 2];
+        }
+
+        Kernel::Row(level.dest->m_pbData + (size_t)y * width * Kernel::BytesPerPixel, rows, numRows, width, level.halveWidth);
+    }
+}
+
+static CMP_BoxFilterRowsProc CMP_GetBoxFilterRows(CMP_FORMAT format)
+{
+    if (format == CMP_FORMAT_RGBA_1010102 || format == CMP_FORMAT_ARGB_2101010)
+        return CMP_BoxFilterRows<CMP_BoxFilter1010102>;
+    if (format == CMP_FORMAT_RGBA_8888_S || format == CMP_FORMAT_ARGB_8888_S)
+        return CMP_BoxFilterRows<CMP_BoxFilterRGBA8<true> >;
+
+    switch (GetChannelFormat(format))
+    {
+    case CF_8bit:
+        return CMP_BoxFilterRows<CMP_BoxFilterRGBA8<false> >;
+    case CF_Float16:
+        return CMP_BoxFilterRows<CMP_BoxFilterF16>;
+    case CF_Float32:
+        return CMP_BoxFilterRows<CMP_BoxFilterF32>;
+    default:
+        return NULL;
+    }
+}
+
+// Sets up the filter of a level, returns false for unsupported formats
+static bool CMP_InitBoxFilterLevel(CMP_BoxFilterLevel& level, MipLevel* currMipLevel, MipLevel** prevMipLevels, uint32_t numPrevLevels, CMP_FORMAT format)
+{
+    assert(currMipLevel);
+    assert(prevMipLevels);
+    assert(numPrevLevels != 0 && numPrevLevels <= CMP_BOXFILTER_MAX_SOURCES);
+
+    if (!currMipLevel || !prevMipLevels || !prevMipLevels[0] || numPrevLevels == 0 || numPrevLevels > CMP_BOXFILTER_MAX_SOURCES)
+        return false;
+
+    level.filterRows = CMP_GetBoxFilterRows(format);
+    if (!level.filterRows)
+    {
+        assert(!"Unsupported format");
+        return false;
+    }
+
+    level.dest       = currMipLevel;
+    level.numSources = numPrevLevels;
+    for (uint32_t i = 0; i < numPrevLevels; i++)
+        level.sources[i] = prevMipLevels[i];
+
+    level.halveWidth  = currMipLevel->m_nWidth != prevMipLevels[0]->m_nWidth;
+    level.halveHeight = currMipLevel->m_nHeight != prevMipLevels[0]->m_nHeight;
+    assert(level.halveHeight || level.halveWidth);
+
+    return true;
+}
+
+void GenerateMipmapLevel(MipLevel* currMipLevel, MipLevel** prevMipLevels, uint32_t numPrevLevels, CMP_FORMAT format)
+{
+    CMP_BoxFilterLevel level;
+    if (CMP_InitBoxFilterLevel(level, currMipLevel, prevMipLevels, numPrevLevels, format))
+        level.filterRows(level, 0, currMipLevel->m_nHeight);
+}
+
+// Filters all faces or slices of a mip level. With the thread pool the levels are cut into tiles of rows that are
+// filtered by at most maxWorkers pool workers (0 = all), small levels are filtered on the calling thread.
+static void CMP_BoxFilterLevels(const std::vector<CMP_BoxFilterLevel>& levels, bool useThreadPool, CMP_INT maxWorkers)
+{
+    struct Tile
+    {
+        const CMP_BoxFilterLevel* level;
+        CMP_INT                   firstRow;
+        CMP_INT                   endRow;
+    };
+
+    std::vector<Tile> tiles;
+    CMP_INT           numPixels = 0;
+
+    for (const CMP_BoxFilterLevel& level : levels)
+    {
+        CMP_INT width    = level.dest->m_nWidth;
+        CMP_INT height   = level.dest->m_nHeight;
+        CMP_INT tileRows = CMP_MAX(CMP_BOXFILTER_TILE_PIXELS / width, 1);
+
+        for (CMP_INT y = 0; y < height; y += tileRows)
+        {
+            Tile tile = {&level, y, cmp_minT(y + tileRows, height)};
+            tiles.push_back(tile);
         }
+        numPixels += width * height;
+    }
+
+    auto filterTile = [&tiles](CMP_INT nTile) {
+        const Tile& tile = tiles[nTile];
+        tile.level->filterRows(*tile.level, tile.firstRow, tile.endRow);
+    };
+
+    if (useThreadPool && tiles.size() > 1 && numPixels > CMP_BOXFILTER_TILE_PIXELS && maxWorkers != 1)
+        CMP_ThreadPool::GetInstance().ParallelFor((CMP_INT)tiles.size(), maxWorkers, filterTile);
+    else
+    {
+        for (CMP_INT nTile = 0; nTile < (CMP_INT)tiles.size(); nTile++)
+            filterTile(nTile);
     }
 }
 
@@ -363,6 +593,9 @@ CMP_INT CMP_API CMP_GenerateMIPLevelsEx(CMP_MipSet* pMipSet, CMP_CFilterParams*
     CMP_FLOAT*     null_float      = 0;
     CMP_MipLevel*  null_tempMipTwo = nullptr;
 
+    // The faces or slices of each level are filtered together once they are all allocated
+    std::vector<CMP_BoxFilterLevel> levels;
+
     pMipSet->m_nMipLevels = 1;
 
     while (nWidth > CFilterParam->nMinSize || nHeight > CFilterParam->nMinSize)
@@ -374,6 +607,7 @@ CMP_INT CMP_API CMP_GenerateMIPLevelsEx(CMP_MipSet* pMipSet, CMP_CFilterParams*
                                                                                         : CMP_MaxFacesOrSlices(pMipSet, nCurMipLevel - 1),
                                            1);
 
+        levels.clear();
         for (CMP_INT nFaceOrSlice = 0; nFaceOrSlice < maxFacesOrSlices; nFaceOrSlice++)
         {
             CMP_MipLevel* pThisMipLevel = CMips.GetMipLevel(pMipSet, nCurMipLevel, nFaceOrSlice);
@@ -400,6 +634,7 @@ CMP_INT CMP_API CMP_GenerateMIPLevelsEx(CMP_MipSet* pMipSet, CMP_CFilterParams*
 
             assert(pThisMipLevel->m_pbData);
 
+            CMP_BoxFilterLevel level;
             if (pMipSet->m_TextureType == TT_VolumeTexture && CMP_MaxFacesOrSlices(pMipSet, nCurMipLevel - 1) > 1)
             {
                 //prev miplevel had 2 or more slices, so avg together slices
@@ -407,15 +642,19 @@ CMP_INT CMP_API CMP_GenerateMIPLevelsEx(CMP_MipSet* pMipSet, CMP_CFilterParams*
                 MipLevel* prevMipLevels[] = {CMips.GetMipLevel(pMipSet, nCurMipLevel - 1, nFaceOrSlice * 2),
                                              CMips.GetMipLevel(pMipSet, nCurMipLevel - 1, nFaceOrSlice * 2 + 1)};
 
-                GenerateMipmapLevel(pThisMipLevel, prevMipLevels, 2, pMipSet->m_format);
+                if (CMP_InitBoxFilterLevel(level, pThisMipLevel, prevMipLevels, 2, pMipSet->m_format))
+                    levels.push_back(level);
             }
             else
             {
                 CMP_MipLevel* prevMipLevel = CMips.GetMipLevel(pMipSet, nCurMipLevel - 1, nFaceOrSlice);
-                GenerateMipmapLevel(pThisMipLevel, &prevMipLevel, 1, pMipSet->m_format);
+                if (CMP_InitBoxFilterLevel(level, pThisMipLevel, &prevMipLevel, 1, pMipSet->m_format))
+                    levels.push_back(level);
             }
         }
 
+        CMP_BoxFilterLevels(levels, CFilterParam->useThreadPool, (CMP_INT)CFilterParam->dwnumThreads);
+
         if (pMipSet->m_nMipLevels < MAX_MIPLEVEL_SUPPORTED)
             ++pMipSet->m_nMipLevels;
         else
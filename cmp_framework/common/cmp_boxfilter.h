@@ -31,6 +31,7 @@
 void CMP_SetMipSetGamma(MipSet* pMipSet, CMP_FLOAT Gamma);
 
 // generate a new mipmap level by averaging the pixel values of blocks in the previous mipmap levels
+// numPrevLevels is 1, or 2 to average two slices of a volume texture
 void GenerateMipmapLevel(MipLevel* currMipLevel, MipLevel** prevMipLevels, uint32_t numPrevLevels, CMP_FORMAT format);
 
 #endif
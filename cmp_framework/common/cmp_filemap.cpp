@@ -0,0 +1,289 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "cmp_filemap.h"
+#include "cmp_memory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <errno.h>
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32) && !defined(IOV_MAX)
+#define IOV_MAX 1024
+#endif
+
+typedef std::pair<uint64_t, uint64_t> CMP_FileIdentity;
+
+// Mapped files by identity, with the number of mappings of each
+static std::mutex& CMP_FileMappingMutex()
+{
+    static std::mutex* mutex = new std::mutex();
+    return *mutex;
+}
+
+static std::map<CMP_FileIdentity, int>& CMP_MappedFiles()
+{
+    static std::map<CMP_FileIdentity, int>* files = new std::map<CMP_FileIdentity, int>();
+    return *files;
+}
+
+static void CMP_API CMP_FileMappingFree(void* /*ptr*/, CMP_DWORD_PTR pUser)
+{
+    reinterpret_cast<CMP_FileMapping*>(pUser)->Release();
+}
+
+CMP_FileMapping::CMP_FileMapping()
+    : m_pData(NULL)
+    , m_Size(0)
+    , m_Volume(0)
+    , m_Index(0)
+    , m_RefCount(1)
+{
+}
+
+CMP_FileMapping::~CMP_FileMapping()
+{
+    if (!m_pData)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_pData);
+#else
+    munmap(m_pData, m_Size);
+#endif
+
+    std::lock_guard<std::mutex> lock(CMP_FileMappingMutex());
+    auto                        it = CMP_MappedFiles().find(CMP_FileIdentity(m_Volume, m_Index));
+    if ((it != CMP_MappedFiles().end()) && (--it->second == 0))
+        CMP_MappedFiles().erase(it);
+}
+
+CMP_FileMapping* CMP_FileMapping::Map(FILE* pFile)
+{
+    if (!pFile)
+        return NULL;
+
+    CMP_FileMapping* pMapping = new CMP_FileMapping();
+
+#ifdef _WIN32
+    HANDLE hFile = (HANDLE)_get_osfhandle(_fileno(pFile));
+
+    BY_HANDLE_FILE_INFORMATION info;
+    if ((hFile == INVALID_HANDLE_VALUE) || !GetFileInformationByHandle(hFile, &info))
+    {
+        delete pMapping;
+        return NULL;
+    }
+
+    uint64_t size = ((uint64_t)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+    if ((size == 0) || (size > (uint64_t)SIZE_MAX))
+    {
+        delete pMapping;
+        return NULL;
+    }
+
+    // The view keeps the mapping object alive once it is created
+    HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (hMapping)
+    {
+        pMapping->m_pData = (CMP_BYTE*)MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0);
+        CloseHandle(hMapping);
+    }
+
+    pMapping->m_Size   = (size_t)size;
+    pMapping->m_Volume = info.dwVolumeSerialNumber;
+    pMapping->m_Index  = ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+#else
+    int fd = fileno(pFile);
+
+    struct stat info;
+    if ((fd < 0) || (fstat(fd, &info) != 0) || (info.st_size <= 0) || ((uint64_t)info.st_size > (uint64_t)SIZE_MAX))
+    {
+        delete pMapping;
+        return NULL;
+    }
+
+    void* pData = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (pData != MAP_FAILED)
+        pMapping->m_pData = (CMP_BYTE*)pData;
+
+    pMapping->m_Size   = (size_t)info.st_size;
+    pMapping->m_Volume = (uint64_t)info.st_dev;
+    pMapping->m_Index  = (uint64_t)info.st_ino;
+#endif
+
+    if (!pMapping->m_pData)
+    {
+        delete pMapping;
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(CMP_FileMappingMutex());
+    CMP_MappedFiles()[CMP_FileIdentity(pMapping->m_Volume, pMapping->m_Index)]++;
+    return pMapping;
+}
+
+void CMP_FileMapping::AddRef()
+{
+    std::lock_guard<std::mutex> lock(CMP_FileMappingMutex());
+    m_RefCount++;
+}
+
+void CMP_FileMapping::Release()
+{
+    bool bLast;
+    {
+        std::lock_guard<std::mutex> lock(CMP_FileMappingMutex());
+        bLast = (--m_RefCount == 0);
+    }
+
+    if (bLast)
+        delete this;
+}
+
+CMP_BYTE* CMP_FileMapping::AdoptRange(size_t offset)
+{
+    if (offset >= m_Size)
+        return NULL;
+
+    CMP_BYTE* pData = m_pData + offset;
+
+    AddRef();
+    if (!CMP_MemAdopt(pData, CMP_FileMappingFree, reinterpret_cast<CMP_DWORD_PTR>(this)))
+    {
+        Release();
+        return NULL;
+    }
+
+    return pData;
+}
+
+bool CMP_IsFileMapped(const char* pszFilename)
+{
+    if (!pszFilename)
+        return false;
+
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA(
+        pszFilename, 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    BY_HANDLE_FILE_INFORMATION info;
+    BOOL                       bInfo = GetFileInformationByHandle(hFile, &info);
+    CloseHandle(hFile);
+    if (!bInfo)
+        return false;
+
+    CMP_FileIdentity identity(info.dwVolumeSerialNumber, ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow);
+#else
+    struct stat info;
+    if (stat(pszFilename, &info) != 0)
+        return false;
+
+    CMP_FileIdentity identity((uint64_t)info.st_dev, (uint64_t)info.st_ino);
+#endif
+
+    std::lock_guard<std::mutex> lock(CMP_FileMappingMutex());
+    return CMP_MappedFiles().count(identity) != 0;
+}
+
+bool CMP_WriteFileGather(FILE* pFile, const CMP_FileSpan* pSpans, size_t nSpans)
+{
+    if (!pFile || (nSpans && !pSpans))
+        return false;
+
+#ifdef _WIN32
+    // Large writes bypass the stream buffer in the CRT, so there is no copy to save on Windows
+    for (size_t i = 0; i < nSpans; i++)
+    {
+        if (pSpans[i].size && (fwrite(pSpans[i].pData, pSpans[i].size, 1, pFile) != 1))
+            return false;
+    }
+    return true;
+#else
+    // Whatever is still in the stream buffer goes first
+    if (fflush(pFile) != 0)
+        return false;
+
+    int fd = fileno(pFile);
+
+    std::vector<struct iovec> iov;
+    iov.reserve(nSpans < IOV_MAX ? nSpans : IOV_MAX);
+
+    size_t nSpan = 0;
+    while (nSpan < nSpans)
+    {
+        iov.clear();
+        for (; (nSpan < nSpans) && (iov.size() < IOV_MAX); nSpan++)
+        {
+            if (pSpans[nSpan].size)
+            {
+                struct iovec part;
+                part.iov_base = const_cast<void*>(pSpans[nSpan].pData);
+                part.iov_len  = pSpans[nSpan].size;
+                iov.push_back(part);
+            }
+        }
+
+        // Resume after short writes from the first part that is not fully written
+        size_t nFirst = 0;
+        while (nFirst < iov.size())
+        {
+            ssize_t written = writev(fd, &iov[nFirst], (int)(iov.size() - nFirst));
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+
+            size_t remaining = (size_t)written;
+            while ((nFirst < iov.size()) && (remaining >= iov[nFirst].iov_len))
+                remaining -= iov[nFirst++].iov_len;
+
+            if (remaining)
+            {
+                iov[nFirst].iov_base = (CMP_BYTE*)iov[nFirst].iov_base + remaining;
+                iov[nFirst].iov_len -= remaining;
+            }
+        }
+    }
+
+    return true;
+#endif
+}
@@ -0,0 +1,83 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _CMP_FILEMAP_H
+#define _CMP_FILEMAP_H
+
+#include "compressonator.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// A private mapping of a whole file. Pages are read from the file the first time they are used, and writes go to
+// private copies of the pages, they never reach the file. The mapping is reference counted so that several mip
+// levels can point into it, the file is unmapped when the last one is freed.
+class CMP_FileMapping
+{
+public:
+    // Maps the file that is open in pFile with a reference for the caller, NULL if the file cannot be mapped
+    static CMP_FileMapping* Map(FILE* pFile);
+
+    CMP_BYTE* GetData() const
+    {
+        return m_pData;
+    }
+
+    size_t GetSize() const
+    {
+        return m_Size;
+    }
+
+    void AddRef();
+    void Release();
+
+    // Returns the data at offset as a block that CMP_MemFreeLevel releases, the block holds a reference on the mapping
+    CMP_BYTE* AdoptRange(size_t offset);
+
+private:
+    CMP_FileMapping();
+    ~CMP_FileMapping();
+
+    CMP_BYTE* m_pData;
+    size_t    m_Size;
+    uint64_t  m_Volume;  // Identity of the mapped file
+    uint64_t  m_Index;
+    long      m_RefCount;
+};
+
+// True if the file is mapped, writing to it would then change or truncate data that mip levels point to
+bool CMP_IsFileMapped(const char* pszFilename);
+
+// One part of a gather write
+struct CMP_FileSpan
+{
+    const void* pData;
+    size_t      size;
+};
+
+// Writes the spans one after the other at the current position of pFile, with a single system call per batch
+// of spans rather than a copy through the stream buffer for each one
+bool CMP_WriteFileGather(FILE* pFile, const CMP_FileSpan* pSpans, size_t nSpans);
+
+#endif
@@ -0,0 +1,413 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "cmp_memory.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define CMP_MEM_DEFAULT_ARENA_MB 256
+
+static void* CMP_API CMP_DefaultAlloc(size_t size, CMP_DWORD_PTR /*pUser*/)
+{
+    return malloc(size);
+}
+
+static void CMP_API CMP_DefaultFree(void* ptr, CMP_DWORD_PTR /*pUser*/)
+{
+    free(ptr);
+}
+
+static void* CMP_API CMP_DefaultAlignedAlloc(size_t size, size_t alignment, CMP_DWORD_PTR /*pUser*/)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = NULL;
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : NULL;
+#endif
+}
+
+static void CMP_API CMP_DefaultAlignedFree(void* ptr, CMP_DWORD_PTR /*pUser*/)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+// Kept in front of every block from CMP_MemAlloc, so freeing a block needs no lookup. A block keeps the free function
+// of the allocator that made it, so blocks outlive a change of allocator.
+struct CMP_MemHeader
+{
+    void*         base;      // What the allocator returned
+    size_t        capacity;  // Usable bytes from the aligned pointer
+    CMP_Free_Proc pFree;
+    CMP_DWORD_PTR pUser;
+    uint32_t      magic;
+};
+
+static_assert(sizeof(CMP_MemHeader) <= CMP_MEM_ALIGNMENT, "The block header must fit in the alignment padding");
+
+#define CMP_MEM_MAGIC 0x434D504Du  // "CMPM"
+
+static CMP_MemHeader* CMP_MemGetHeader(void* ptr)
+{
+    CMP_MemHeader* header = reinterpret_cast<CMP_MemHeader*>(ptr) - 1;
+    assert(header->magic == CMP_MEM_MAGIC);
+    return header;
+}
+
+// Who releases a block of mip level data, see CMP_MemFreeLevel
+struct CMP_MemLevelOwner
+{
+    CMP_Free_Proc pFree;  // NULL for blocks from CMP_MemAllocLevel
+    CMP_DWORD_PTR pUser;
+};
+
+class CMP_MemoryManager
+{
+public:
+    static CMP_MemoryManager& GetInstance()
+    {
+        // Intentionally never destroyed, mip sets may be freed during static destruction
+        static CMP_MemoryManager* manager = new CMP_MemoryManager();
+        return *manager;
+    }
+
+    void* Alloc(size_t size)
+    {
+        if (size == 0)
+            size = 1;
+
+        // Only the arena is shared between threads, everything else is in the block header or in atomics
+        if (m_bUseArena.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(m_ArenaMutex);
+
+            // Closest block that is at most a quarter larger than the request
+            auto it = m_Arena.lower_bound(size);
+            if ((it != m_Arena.end()) && (it->first - size <= size / 4))
+            {
+                void* ptr = it->second;
+                m_ArenaBytes -= it->first;
+                m_ArenaReuses++;
+                AddInUse(it->first);
+                m_Arena.erase(it);
+                return ptr;
+            }
+        }
+
+        const CMP_AllocatorOptions* options = m_pOptions.load(std::memory_order_acquire);
+
+        void*         base;
+        uintptr_t     aligned;
+        CMP_MemHeader header;
+        if (options->pAlignedAlloc)
+        {
+            base         = options->pAlignedAlloc(size + CMP_MEM_ALIGNMENT, CMP_MEM_ALIGNMENT, options->pUser);
+            header.pFree = options->pAlignedFree;
+            aligned      = (uintptr_t)base + CMP_MEM_ALIGNMENT;
+        }
+        else
+        {
+            base         = options->pAlloc(size + sizeof(CMP_MemHeader) + CMP_MEM_ALIGNMENT - 1, options->pUser);
+            header.pFree = options->pFree;
+            aligned      = ((uintptr_t)base + sizeof(CMP_MemHeader) + CMP_MEM_ALIGNMENT - 1) & ~(uintptr_t)(CMP_MEM_ALIGNMENT - 1);
+        }
+
+        if (!base)
+            return NULL;
+
+        header.base     = base;
+        header.capacity = size;
+        header.pUser    = options->pUser;
+        header.magic    = CMP_MEM_MAGIC;
+        memcpy(reinterpret_cast<CMP_MemHeader*>(aligned) - 1, &header, sizeof(header));
+
+        m_BytesAllocated.fetch_add(size, std::memory_order_relaxed);
+        m_Allocations.fetch_add(1, std::memory_order_relaxed);
+        AddInUse(size);
+        return (void*)aligned;
+    }
+
+    void Free(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        CMP_MemHeader* header = CMP_MemGetHeader(ptr);
+        m_BytesInUse.fetch_sub(header->capacity, std::memory_order_relaxed);
+
+        if (m_bUseArena.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(m_ArenaMutex);
+            if (m_ArenaBytes + header->capacity <= m_ArenaLimit)
+            {
+                m_Arena.insert(std::make_pair(header->capacity, ptr));
+                m_ArenaBytes += header->capacity;
+                return;
+            }
+        }
+
+        header->pFree(header->base, header->pUser);
+    }
+
+    void* AllocLevel(size_t size)
+    {
+        void* ptr = Alloc(size);
+        if (!ptr)
+            return NULL;
+
+        CMP_MemLevelOwner owner = {NULL, 0};
+
+        std::lock_guard<std::mutex> lock(m_LevelMutex);
+        m_Levels[ptr] = owner;
+        return ptr;
+    }
+
+    void FreeLevel(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        CMP_MemLevelOwner owner;
+        {
+            std::lock_guard<std::mutex> lock(m_LevelMutex);
+            auto it = m_Levels.find(ptr);
+            if (it == m_Levels.end())
+            {
+                free(ptr);
+                return;
+            }
+
+            owner = it->second;
+            m_Levels.erase(it);
+        }
+
+        if (owner.pFree)
+            owner.pFree(ptr, owner.pUser);
+        else
+            Free(ptr);
+    }
+
+    bool Adopt(void* ptr, CMP_Free_Proc pFree, CMP_DWORD_PTR pUser)
+    {
+        if (!ptr || !pFree)
+            return false;
+
+        CMP_MemLevelOwner owner = {pFree, pUser};
+
+        std::lock_guard<std::mutex> lock(m_LevelMutex);
+        return m_Levels.insert(std::make_pair(ptr, owner)).second;
+    }
+
+    bool SetOptions(const CMP_AllocatorOptions* pOptions)
+    {
+        CMP_AllocatorOptions options = {};
+        options.dwSize               = sizeof(options);
+
+        if (pOptions)
+        {
+            if (pOptions->dwSize != sizeof(CMP_AllocatorOptions))
+                return false;
+
+            // The allocator and aligned allocator each need their free function
+            if ((!pOptions->pAlloc != !pOptions->pFree) || (!pOptions->pAlignedAlloc != !pOptions->pAlignedFree))
+                return false;
+
+            options = *pOptions;
+        }
+
+        if (!options.pAlloc)
+        {
+            options.pAlloc = CMP_DefaultAlloc;
+            options.pFree  = CMP_DefaultFree;
+
+            // Keep the platform aligned allocation unless the host only gave its own aligned allocator
+            if (!options.pAlignedAlloc)
+            {
+                options.pAlignedAlloc = CMP_DefaultAlignedAlloc;
+                options.pAlignedFree  = CMP_DefaultAlignedFree;
+            }
+        }
+
+        std::vector<void*> blocks;
+        {
+            std::lock_guard<std::mutex> lock(m_ArenaMutex);
+            for (auto& entry : m_Arena)
+                blocks.push_back(entry.second);
+            m_Arena.clear();
+            m_ArenaBytes = 0;
+
+            // Allocations read the options without a lock, so earlier options are kept for the life of the process
+            m_Options.push_back(std::unique_ptr<CMP_AllocatorOptions>(new CMP_AllocatorOptions(options)));
+            m_pOptions.store(m_Options.back().get(), std::memory_order_release);
+
+            m_ArenaLimit = (size_t)(options.dwArenaSizeMB ? options.dwArenaSizeMB : CMP_MEM_DEFAULT_ARENA_MB) << 20;
+            m_bUseArena.store(options.bUseArena != 0, std::memory_order_release);
+        }
+
+        for (void* ptr : blocks)
+        {
+            CMP_MemHeader* header = CMP_MemGetHeader(ptr);
+            header->pFree(header->base, header->pUser);
+        }
+
+        // Blocks of the previous allocator that are still in use stay counted
+        ResetStats();
+        return true;
+    }
+
+    void GetStats(CMP_MemoryStats& stats)
+    {
+        stats.dwSize          = sizeof(CMP_MemoryStats);
+        stats.nBytesInUse     = m_BytesInUse.load(std::memory_order_relaxed);
+        stats.nPeakBytesInUse = m_PeakBytesInUse.load(std::memory_order_relaxed);
+        stats.nBytesAllocated = m_BytesAllocated.load(std::memory_order_relaxed);
+        stats.dwAllocations   = m_Allocations.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(m_ArenaMutex);
+        stats.nArenaBytes   = m_ArenaBytes;
+        stats.dwArenaReuses = m_ArenaReuses;
+    }
+
+    void ResetStats()
+    {
+        m_PeakBytesInUse.store(m_BytesInUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_BytesAllocated.store(0, std::memory_order_relaxed);
+        m_Allocations.store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(m_ArenaMutex);
+        m_ArenaReuses = 0;
+    }
+
+private:
+    CMP_MemoryManager()
+        : m_pOptions(NULL)
+        , m_bUseArena(false)
+        , m_BytesInUse(0)
+        , m_PeakBytesInUse(0)
+        , m_BytesAllocated(0)
+        , m_Allocations(0)
+        , m_ArenaLimit(0)
+        , m_ArenaBytes(0)
+        , m_ArenaReuses(0)
+    {
+        SetOptions(NULL);
+    }
+
+    void AddInUse(size_t size)
+    {
+        size_t inUse = m_BytesInUse.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t peak  = m_PeakBytesInUse.load(std::memory_order_relaxed);
+        while ((inUse > peak) && !m_PeakBytesInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::atomic<const CMP_AllocatorOptions*> m_pOptions;
+    std::atomic<bool>                        m_bUseArena;
+    std::atomic<size_t>                      m_BytesInUse;
+    std::atomic<size_t>                      m_PeakBytesInUse;
+    std::atomic<size_t>                      m_BytesAllocated;
+    std::atomic<CMP_DWORD>                   m_Allocations;
+
+    // Taken only when the arena is enabled, and by SetOptions and the stats
+    std::mutex                                         m_ArenaMutex;
+    std::vector<std::unique_ptr<CMP_AllocatorOptions>> m_Options;
+    size_t                                             m_ArenaLimit;
+    size_t                                             m_ArenaBytes;
+    CMP_DWORD                                          m_ArenaReuses;
+    std::multimap<size_t, void*>                       m_Arena;  // Free blocks by capacity
+
+    // Taken once per mip level, codec buffers never go through the level registry
+    std::mutex                                   m_LevelMutex;
+    std::unordered_map<void*, CMP_MemLevelOwner> m_Levels;  // Level data from CMP_MemAllocLevel and CMP_MemAdopt
+};
+
+void* CMP_MemAlloc(size_t size)
+{
+    return CMP_MemoryManager::GetInstance().Alloc(size);
+}
+
+void* CMP_MemCalloc(size_t size)
+{
+    void* ptr = CMP_MemAlloc(size);
+    if (ptr)
+        memset(ptr, 0, size);
+    return ptr;
+}
+
+void CMP_MemFree(void* ptr)
+{
+    CMP_MemoryManager::GetInstance().Free(ptr);
+}
+
+void* CMP_MemAllocLevel(size_t size)
+{
+    return CMP_MemoryManager::GetInstance().AllocLevel(size);
+}
+
+void CMP_MemFreeLevel(void* ptr)
+{
+    CMP_MemoryManager::GetInstance().FreeLevel(ptr);
+}
+
+bool CMP_MemAdopt(void* ptr, CMP_Free_Proc pFree, CMP_DWORD_PTR pUser)
+{
+    return CMP_MemoryManager::GetInstance().Adopt(ptr, pFree, pUser);
+}
+
+CMP_ERROR CMP_API CMP_SetAllocator(const CMP_AllocatorOptions* pOptions)
+{
+    if (!CMP_MemoryManager::GetInstance().SetOptions(pOptions))
+        return CMP_ERR_GENERIC;
+
+    return CMP_OK;
+}
+
+CMP_ERROR CMP_API CMP_GetMemoryStats(CMP_MemoryStats* pStats)
+{
+    if (!pStats || (pStats->dwSize != sizeof(CMP_MemoryStats)))
+        return CMP_ERR_GENERIC;
+
+    CMP_MemoryManager::GetInstance().GetStats(*pStats);
+    return CMP_OK;
+}
+
+CMP_VOID CMP_API CMP_ResetMemoryStats()
+{
+    CMP_MemoryManager::GetInstance().ResetStats();
+}
@@ -0,0 +1,52 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _CMP_MEMORY_H
+#define _CMP_MEMORY_H
+
+#include "compressonator.h"
+
+#include <stddef.h>
+
+// Alignment of every block handed out by CMP_MemAlloc
+#define CMP_MEM_ALIGNMENT 64
+
+// Mip level data and codec buffers are allocated here. The blocks come from the allocator set with CMP_SetAllocator
+// and are counted in CMP_GetMemoryStats. With the arena enabled, freed blocks are kept and handed out again for
+// requests of a similar size, so batch conversions stop returning the same sizes to the heap over and over.
+void* CMP_MemAlloc(size_t size);
+void* CMP_MemCalloc(size_t size);
+
+// Only takes blocks from CMP_MemAlloc or CMP_MemCalloc, the block header says how to release it
+void CMP_MemFree(void* ptr);
+
+// Mip level data can also come from the host or a mapped file, so level blocks are tracked once per level.
+// CMP_MemFreeLevel passes blocks that were neither made by CMP_MemAllocLevel nor adopted to free().
+void* CMP_MemAllocLevel(size_t size);
+void  CMP_MemFreeLevel(void* ptr);
+
+// Makes CMP_MemFreeLevel release a block that was not made by CMP_MemAllocLevel, such as mip level data in a mapped
+// file, by calling pFree(ptr, pUser). Adopted blocks are not counted in the stats and are never kept in the arena.
+bool CMP_MemAdopt(void* ptr, CMP_Free_Proc pFree, CMP_DWORD_PTR pUser);
+
+#endif
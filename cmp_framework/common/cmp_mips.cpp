@@ -27,10 +27,24 @@
 #include "cmp_mips.h"
 #include "format_conversion.h"
 #include "atiformats.h"
+#include "cmp_threadpool.h"
+#include "cmp_memory.h"
+#include "mathmacros.h"
 
 #include <stdarg.h>
 #include <stdio.h>
 #include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <vector>
+
+#define CMP_MIPSET_ALIGNMENT CMP_MEM_ALIGNMENT  // alignment of the levels of a contiguous mip set
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define CMP_ANALYSIS_SSE2
+#include <emmintrin.h>
+#endif
 
 void (*PrintStatusLine)(char*) = NULL;
 
@@ -261,410 +275,347 @@ CMP_ERROR CMP_API CMP_CreateMipSet(CMP_MipSet* pMipSet, CMP_INT nWidth, CMP_INT
     return CMP_OK;
 }
 
-// Code duplication for all 3 functions to calc MSE & PSNR
-// can reduce to typed templates
-
-void CMP_calcMSE_PSNRb(MipLevel* pCurMipLevel, CMP_BYTE* pdata1, CMP_BYTE* pdata2, CMP_AnalysisData* pAnalysisData)
+// Bits per pixel of uncompressed mip level data, 0 for unsupported formats
+static CMP_DWORD CMP_MipLevelBitsPerPixel(CMP_ChannelFormat channelFormat, TextureDataType textureDataType)
 {
-    CMP_UINT  RGBAChannels = pAnalysisData->channelBitMap;
-    CMP_FLOAT mse;
-    CMP_FLOAT mseR         = 0.0f;
-    CMP_FLOAT mseG         = 0.0f;
-    CMP_FLOAT mseB         = 0.0f;
-    CMP_FLOAT mseA         = 0.0f;
-    CMP_FLOAT mseRGBA      = 0.0f;
-    CMP_INT   totalPixelsR = 0;
-    CMP_INT   totalPixelsG = 0;
-    CMP_INT   totalPixelsB = 0;
-    CMP_INT   totalPixelsA = 0;
-    CMP_INT   totalPixels  = 0;
-
-    for (int y = 0; y < pCurMipLevel->m_nHeight; y++)
+    CMP_DWORD dwBitsPerPixel;
+    switch (channelFormat)
     {
-        for (int x = 0; x < pCurMipLevel->m_nWidth; x++)
-        {
-            // calc Gamma for the all active channels
-            // Red channel
-            if (RGBAChannels & 0b0001)
-            {
-                mse = powf(abs(*pdata1 - *pdata2), 2);
-                mseR += mse;
-                mseRGBA += mse;
-                totalPixelsR++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Green channel
-            if (RGBAChannels & 0b0010)
-            {
-                mse = powf(abs(*pdata1 - *pdata2), 2);
-                mseG += mse;
-                mseRGBA += mse;
-                totalPixelsG++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Blue channel
-            if (RGBAChannels & 0b0100)
-            {
-                mse = powf(abs(*pdata1 - *pdata2), 2);
-                mseB += mse;
-                mseRGBA += mse;
-                totalPixelsB++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Alpha channel
-            if (RGBAChannels & 0b1000)
-            {
-                mse = powf(abs(*pdata1 - *pdata2), 2);
-                mseA += mse;
-                mseRGBA += mse;
-                totalPixelsA++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-        }
+    case CF_8bit:
+    case CF_2101010:
+    case CF_1010102:
+    case CF_Float9995E:
+        dwBitsPerPixel = 8;
+        break;
+
+    case CF_16bit:
+    case CF_Float16:
+        dwBitsPerPixel = 16;
+        break;
+
+    case CF_32bit:
+    case CF_Float32:
+        dwBitsPerPixel = 32;
+        break;
+
+    default:
+        return 0;
     }
 
-    if (totalPixels == 0)
+    switch (textureDataType)
     {
-        totalPixels = 1;
+    case TDT_XRGB:
+    case TDT_ARGB:
+    case TDT_NORMAL_MAP:
+        dwBitsPerPixel *= 4;
+        break;
+    case TDT_RGB:
+        dwBitsPerPixel *= 3;
+        break;
+    case TDT_RG:
+    case TDT_16:
+        dwBitsPerPixel *= 2;
+        break;
+    case TDT_R:
+    case TDT_8:
+        break;
+    default:
+        return 0;
     }
 
-    pAnalysisData->mse  = mseRGBA / totalPixels;
-    pAnalysisData->mseR = mseR / totalPixelsR;
-    pAnalysisData->mseG = mseG / totalPixelsG;
-    pAnalysisData->mseB = mseB / totalPixelsB;
-    pAnalysisData->mseA = mseA / totalPixelsA;
+    return dwBitsPerPixel;
+}
+
+CMP_ERROR CMP_API CMP_CreateContiguousMipSet(CMP_MipSet*   pMipSet,
+                                             CMP_INT       nWidth,
+                                             CMP_INT       nHeight,
+                                             CMP_INT       nDepth,
+                                             ChannelFormat channelFormat,
+                                             TextureType   textureType)
+{
+    CMP_CMIPS CMips;
 
-    if (pAnalysisData->mse <= 0.0f)
-    {
-        pAnalysisData->mse  = 0.0f;
-        pAnalysisData->mseR = 0.0f;
-        pAnalysisData->mseG = 0.0f;
-        pAnalysisData->mseB = 0.0f;
-        pAnalysisData->mseA = 0.0f;
-
-        pAnalysisData->psnr  = 128.0f;
-        pAnalysisData->psnrR = 128.0f;
-        pAnalysisData->psnrG = 128.0f;
-        pAnalysisData->psnrB = 128.0f;
-        pAnalysisData->psnrA = 128.0f;
-    }
-    else
+    if (CMP_MipLevelBitsPerPixel(channelFormat, TDT_ARGB) == 0)
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+    pMipSet->m_Flags        = MS_FLAG_Default;
+    pMipSet->dwWidth        = 0;
+    pMipSet->dwHeight       = 0;
+    pMipSet->m_dwFourCC     = 0;
+    pMipSet->m_nBlockHeight = 4;
+    pMipSet->m_nBlockWidth  = 4;
+    pMipSet->m_nMipLevels   = 1;
+
+    if (!CMips.AllocateMipSet(pMipSet, channelFormat, TDT_ARGB, textureType, nWidth, nHeight, nDepth))
+        return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
+
+    // Every level and face is allocated up front, CMP_GenerateMIPLevels fills the levels in place
+    if (!CMips.AllocateContiguousMipLevels(pMipSet))
     {
-        if (pAnalysisData->mse > 0.0f)
-            pAnalysisData->psnr = 10.0f * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mse) / logf(10.0f);
-        if (pAnalysisData->mseR > 0.0f)
-            pAnalysisData->psnrR = 10 * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mseR) / logf(10.0f);
-        if (pAnalysisData->mseG > 0.0f)
-            pAnalysisData->psnrG = 10 * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mseG) / logf(10.0f);
-        if (pAnalysisData->mseB > 0.0f)
-            pAnalysisData->psnrB = 10.0f * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mseB) / logf(10.0f);
-        if (pAnalysisData->mseA > 0.0f)
-            pAnalysisData->psnrA = 10.0f * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mseA) / logf(10.0f);
+        CMips.FreeMipSet(pMipSet);
+        return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
     }
+
+    MipLevel* pOutMipLevel = CMips.GetMipLevel(pMipSet, 0);
+    pMipSet->dwDataSize    = pOutMipLevel->m_dwLinearSize;
+    pMipSet->pData         = pOutMipLevel->m_pbData;
+
+    return CMP_OK;
 }
 
-void CMP_calcMSE_PSNR1010102(MipLevel* pCurMipLevel, CMP_DWORD* buffer1, CMP_DWORD* buffer2, CMP_AnalysisData* pAnalysisData)
+CMP_ERROR CMP_API CMP_DetachMipSet(CMP_MipSet* pMipSet)
 {
-    CMP_UINT  RGBAChannels = pAnalysisData->channelBitMap;
-    CMP_FLOAT mse          = 0.0f;
-    CMP_FLOAT mseR         = 0.0f;
-    CMP_FLOAT mseG         = 0.0f;
-    CMP_FLOAT mseB         = 0.0f;
-    CMP_FLOAT mseA         = 0.0f;
-    CMP_FLOAT mseRGBA      = 0.0f;
-    CMP_INT   totalPixelsR = 0;
-    CMP_INT   totalPixelsG = 0;
-    CMP_INT   totalPixelsB = 0;
-    CMP_INT   totalPixelsA = 0;
-    CMP_INT   totalPixels  = 0;
-
-    for (uint32_t i = 0; i < pCurMipLevel->m_nHeight * pCurMipLevel->m_nWidth; ++i)
+    if (!pMipSet)
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    if (!(pMipSet->m_Flags & MS_FLAG_MappedLevels) || !pMipSet->m_pMipLevelTable)
+        return CMP_OK;
+
+    CMP_CMIPS CMips;
+    for (CMP_INT nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
     {
-        // calc Gamma for the all active channels
-        // Red channel
-        if (RGBAChannels & 0b0001)
+        for (CMP_INT nFaceOrSlice = 0; nFaceOrSlice < CMP_MaxFacesOrSlices(pMipSet, nMipLevel); nFaceOrSlice++)
         {
-            int32_t r1 = RGBA1010102_GET_R(buffer1[i]);
-            int32_t r2 = RGBA1010102_GET_R(buffer2[i]);
-
-            mse = powf(abs(r1 - r2), 2);
-            mseR += mse;
-            mseRGBA += mse;
-            totalPixelsR++;
-            totalPixels++;
+            CMP_MipLevel* pMipLevel = CMips.GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
+            if (!pMipLevel || !pMipLevel->m_pbData)
+                continue;
+
+            CMP_BYTE* pData = reinterpret_cast<CMP_BYTE*>(CMP_MemAllocLevel(pMipLevel->m_dwLinearSize));
+            if (!pData)
+                return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
+
+            // Freeing the mapped data drops the level's reference on the mapping
+            memcpy(pData, pMipLevel->m_pbData, pMipLevel->m_dwLinearSize);
+            if (pMipSet->pData == pMipLevel->m_pbData)
+                pMipSet->pData = pData;
+            CMP_MemFreeLevel(pMipLevel->m_pbData);
+            pMipLevel->m_pbData = pData;
         }
+    }
 
-        // Green channel
-        if (RGBAChannels & 0b0010)
-        {
-            int32_t g1 = RGBA1010102_GET_G(buffer1[i]);
-            int32_t g2 = RGBA1010102_GET_G(buffer2[i]);
-
-            mse = powf(abs(g1 - g2), 2);
-            mseG += mse;
-            mseRGBA += mse;
-            totalPixelsG++;
-            totalPixels++;
-        }
+    pMipSet->m_Flags &= ~MS_FLAG_MappedLevels;
+    return CMP_OK;
+}
+
+// MSE and PSNR of two images.
+//
+// The images are split into tiles of a fixed number of pixels that are summed on the thread pool, the tile sums
+// are then added in tile order. The tiling only depends on the image size so the results are the same for any
+// number of threads. The 8 bit and 1010102 errors are summed exactly in integers. The float errors of a tile are
+// summed in doubles, in 4 interleaved accumulators per channel where pixel i of the tile adds to accumulator i % 4,
+// and the channel sum is (acc0 + acc1) + (acc2 + acc3). The SSE2 and scalar code use the same order and sums.
+
+#define CMP_ANALYSIS_TILE_PIXELS 65536
+
+// Per channel sums of squared differences
+struct CMP_ChannelErrors
+{
+    CMP_DOUBLE sum[4];
+};
+
+static void CMP_SquaredErrorsByte(CMP_ChannelErrors& errors, const CMP_BYTE* pdata1, const CMP_BYTE* pdata2, CMP_INT numPixels)
+{
+    uint64_t sum[4] = {0, 0, 0, 0};
+    CMP_INT    i      = 0;
+
+#ifdef CMP_ANALYSIS_SSE2
+    // 4 pixels per step, each 32 bit lane adds up to 4 * 255 * 255 per step so the lanes are flushed every 4096 steps
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 4 <= numPixels)
+    {
+        __m128i acc   = _mm_setzero_si128();
+        CMP_INT steps = cmp_minT((numPixels - i) / 4, 4096);
 
-        // Blue channel
-        if (RGBAChannels & 0b0100)
+        for (CMP_INT s = 0; s < steps; s++, i += 4)
         {
-            int32_t b1 = RGBA1010102_GET_B(buffer1[i]);
-            int32_t b2 = RGBA1010102_GET_B(buffer2[i]);
-
-            mse = powf(abs(b1 - b2), 2);
-            mseB += mse;
-            mseRGBA += mse;
-            totalPixelsB++;
-            totalPixels++;
+            __m128i a = _mm_loadu_si128((const __m128i*)(pdata1 + i * 4));
+            __m128i b = _mm_loadu_si128((const __m128i*)(pdata2 + i * 4));
+            __m128i d = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+
+            __m128i lo = _mm_unpacklo_epi8(d, zero);
+            __m128i hi = _mm_unpackhi_epi8(d, zero);
+            lo         = _mm_mullo_epi16(lo, lo);
+            hi         = _mm_mullo_epi16(hi, hi);
+
+            acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(lo, zero));
+            acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(lo, zero));
+            acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(hi, zero));
+            acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(hi, zero));
         }
 
-        // Alpha channel
-        if (RGBAChannels & 0b1000)
+        CMP_DWORD lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, acc);
+        for (CMP_INT ch = 0; ch < 4; ch++)
+            sum[ch] += lanes[ch];
+    }
+#endif
+
+    for (; i < numPixels; i++)
+    {
+        for (CMP_INT ch = 0; ch < 4; ch++)
         {
-            int32_t a1 = RGBA1010102_GET_A(buffer1[i]);
-            int32_t a2 = RGBA1010102_GET_A(buffer2[i]);
-
-            mse = powf(abs(a1 - a2), 2);
-            mseA += mse;
-            mseRGBA += mse;
-            totalPixelsA++;
-            totalPixels++;
+            CMP_INT d = (CMP_INT)pdata1[i * 4 + ch] - (CMP_INT)pdata2[i * 4 + ch];
+            sum[ch] += (uint64_t)(d * d);
         }
     }
 
-    if (totalPixels == 0)
+    for (CMP_INT ch = 0; ch < 4; ch++)
+        errors.sum[ch] = (CMP_DOUBLE)sum[ch];
+}
+
+static void CMP_SquaredErrors1010102(CMP_ChannelErrors& errors, const CMP_DWORD* buffer1, const CMP_DWORD* buffer2, CMP_INT numPixels)
+{
+    uint64_t sum[4] = {0, 0, 0, 0};
+
+    for (CMP_INT i = 0; i < numPixels; i++)
     {
-        totalPixels = 1;
+        CMP_INT dr = (CMP_INT)RGBA1010102_GET_R(buffer1[i]) - (CMP_INT)RGBA1010102_GET_R(buffer2[i]);
+        CMP_INT dg = (CMP_INT)RGBA1010102_GET_G(buffer1[i]) - (CMP_INT)RGBA1010102_GET_G(buffer2[i]);
+        CMP_INT db = (CMP_INT)RGBA1010102_GET_B(buffer1[i]) - (CMP_INT)RGBA1010102_GET_B(buffer2[i]);
+        CMP_INT da = (CMP_INT)RGBA1010102_GET_A(buffer1[i]) - (CMP_INT)RGBA1010102_GET_A(buffer2[i]);
+
+        sum[0] += (uint64_t)(dr * dr);
+        sum[1] += (uint64_t)(dg * dg);
+        sum[2] += (uint64_t)(db * db);
+        sum[3] += (uint64_t)(da * da);
     }
 
-    pAnalysisData->mse  = mseRGBA / totalPixels;
-    pAnalysisData->mseR = mseR / totalPixelsR;
-    pAnalysisData->mseG = mseG / totalPixelsG;
-    pAnalysisData->mseB = mseB / totalPixelsB;
-    pAnalysisData->mseA = mseA / totalPixelsA;
+    for (CMP_INT ch = 0; ch < 4; ch++)
+        errors.sum[ch] = (CMP_DOUBLE)sum[ch];
+}
+
+// Float errors are summed in 4 interleaved accumulators per channel to hide the add latency, pixel i adds
+// to accumulator i % 4. All calls except the last one of a tile must pass a multiple of 4 pixels.
+struct CMP_FloatErrorSums
+{
+    CMP_DOUBLE acc[4][4];  // [pixel % 4][channel]
 
-    if (pAnalysisData->mse <= 0.0f)
+    CMP_FloatErrorSums()
     {
-        pAnalysisData->mse  = 0.0f;
-        pAnalysisData->mseR = 0.0f;
-        pAnalysisData->mseG = 0.0f;
-        pAnalysisData->mseB = 0.0f;
-        pAnalysisData->mseA = 0.0f;
-
-        pAnalysisData->psnr  = 128.0f;
-        pAnalysisData->psnrR = 128.0f;
-        pAnalysisData->psnrG = 128.0f;
-        pAnalysisData->psnrB = 128.0f;
-        pAnalysisData->psnrA = 128.0f;
+        for (CMP_INT k = 0; k < 4; k++)
+            for (CMP_INT ch = 0; ch < 4; ch++)
+                acc[k][ch] = 0.0;
     }
-    else
+
+    void Get(CMP_ChannelErrors& errors) const
     {
-        if (pAnalysisData->mse > 0.0f)
-            pAnalysisData->psnr = 10.0f * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mse) / logf(10.0f);
-        if (pAnalysisData->mseR > 0.0f)
-            pAnalysisData->psnrR = 10 * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mseR) / logf(10.0f);
-        if (pAnalysisData->mseG > 0.0f)
-            pAnalysisData->psnrG = 10 * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mseG) / logf(10.0f);
-        if (pAnalysisData->mseB > 0.0f)
-            pAnalysisData->psnrB = 10.0f * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mseB) / logf(10.0f);
-        if (pAnalysisData->mseA > 0.0f)
-            pAnalysisData->psnrA = 10.0f * logf((1.0f * 255.0f * 255.0f) / pAnalysisData->mseA) / logf(10.0f);
+        for (CMP_INT ch = 0; ch < 4; ch++)
+            errors.sum[ch] = (acc[0][ch] + acc[1][ch]) + (acc[2][ch] + acc[3][ch]);
     }
-}
+};
 
-void CMP_calcMSE_PSNRHalfShort(MipLevel* pCurMipLevel, CMP_HALFSHORT* pdata1, CMP_HALFSHORT* pdata2, CMP_AnalysisData* pAnalysisData)
+// Adds the squared differences of RGBA float pixels to the sums
+static void CMP_AddSquaredErrorsFloat(CMP_FloatErrorSums& sums, const CMP_FLOAT* pdata1, const CMP_FLOAT* pdata2, CMP_INT numPixels)
 {
-    CMP_UINT   RGBAChannels = pAnalysisData->channelBitMap;
-    CMP_DOUBLE mse;
-    CMP_DOUBLE mseR         = 0.0;
-    CMP_DOUBLE mseG         = 0.0;
-    CMP_DOUBLE mseB         = 0.0;
-    CMP_DOUBLE mseA         = 0.0;
-    CMP_DOUBLE mseRGBA      = 0.0;
-    CMP_INT    totalPixelsR = 0;
-    CMP_INT    totalPixelsG = 0;
-    CMP_INT    totalPixelsB = 0;
-    CMP_INT    totalPixelsA = 0;
-    CMP_INT    totalPixels  = 0;
+    CMP_INT i = 0;
 
-    CMP_FLOAT pixf1;
-    CMP_FLOAT pixf2;
+#ifdef CMP_ANALYSIS_SSE2
+    __m128d accRG[4], accBA[4];
+    for (CMP_INT k = 0; k < 4; k++)
+    {
+        accRG[k] = _mm_loadu_pd(sums.acc[k]);
+        accBA[k] = _mm_loadu_pd(sums.acc[k] + 2);
+    }
 
-    for (int y = 0; y < pCurMipLevel->m_nHeight; y++)
+    for (; i + 4 <= numPixels; i += 4)
     {
-        for (int x = 0; x < pCurMipLevel->m_nWidth; x++)
+        for (CMP_INT k = 0; k < 4; k++)
         {
-            // calc Gamma for the all active channels
-            // Red channel
-            if (RGBAChannels & 0b0001)
-            {
-                pixf1 = HalfShortToFloat(*pdata1);  // convert short int to float
-                pixf2 = HalfShortToFloat(*pdata2);  // convert short int to float
-                mse   = pow(abs(pixf1 - pixf2), 2);
-                mseR += mse;
-                mseRGBA += mse;
-
-                totalPixelsR++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Green channel
-            if (RGBAChannels & 0b0010)
-            {
-                pixf1 = HalfShortToFloat(*pdata1);  // convert short int to float
-                pixf2 = HalfShortToFloat(*pdata2);  // convert short int to float
-                mse   = pow(abs(pixf1 - pixf2), 2);
-                mseG += mse;
-                mseRGBA += mse;
-                totalPixelsG++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Blue channel
-            if (RGBAChannels & 0b0100)
-            {
-                pixf1 = HalfShortToFloat(*pdata1);  // convert short int to float
-                pixf2 = HalfShortToFloat(*pdata2);  // convert short int to float
-                mse   = pow(abs(pixf1 - pixf2), 2);
-                mseB += mse;
-                mseRGBA += mse;
-                totalPixelsB++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Alpha channel
-            if (RGBAChannels & 0b1000)
-            {
-                pixf1 = HalfShortToFloat(*pdata1);  // convert short int to float
-                pixf2 = HalfShortToFloat(*pdata2);  // convert short int to float
-                mse   = pow(abs(pixf1 - pixf2), 2);
-                mseA += mse;
-                mseRGBA += mse;
-                totalPixelsA++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
+            __m128 a = _mm_loadu_ps(pdata1 + (i + k) * 4);
+            __m128 b = _mm_loadu_ps(pdata2 + (i + k) * 4);
+
+            __m128d dRG = _mm_sub_pd(_mm_cvtps_pd(a), _mm_cvtps_pd(b));
+            __m128d dBA = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(a, a)), _mm_cvtps_pd(_mm_movehl_ps(b, b)));
+
+            accRG[k] = _mm_add_pd(accRG[k], _mm_mul_pd(dRG, dRG));
+            accBA[k] = _mm_add_pd(accBA[k], _mm_mul_pd(dBA, dBA));
         }
     }
 
-    if (totalPixels == 0)
+    for (CMP_INT k = 0; k < 4; k++)
     {
-        totalPixels = 1;
+        _mm_storeu_pd(sums.acc[k], accRG[k]);
+        _mm_storeu_pd(sums.acc[k] + 2, accBA[k]);
     }
+#endif
 
-    pAnalysisData->mse  = mseRGBA / totalPixels;
-    pAnalysisData->mseR = mseR / totalPixelsR;
-    pAnalysisData->mseG = mseG / totalPixelsG;
-    pAnalysisData->mseB = mseB / totalPixelsB;
-    pAnalysisData->mseA = mseA / totalPixelsA;
-
-    if (pAnalysisData->mse <= 0.0)
+    for (; i < numPixels; i++)
     {
-        pAnalysisData->mse  = 0.0;
-        pAnalysisData->mseR = 0.0;
-        pAnalysisData->mseG = 0.0;
-        pAnalysisData->mseB = 0.0;
-        pAnalysisData->mseA = 0.0;
+        for (CMP_INT ch = 0; ch < 4; ch++)
+        {
+            CMP_DOUBLE d = (CMP_DOUBLE)pdata1[i * 4 + ch] - (CMP_DOUBLE)pdata2[i * 4 + ch];
+            sums.acc[i % 4][ch] += d * d;
+        }
+    }
+}
 
-        pAnalysisData->psnr  = 128;
-        pAnalysisData->psnrR = 128;
-        pAnalysisData->psnrG = 128;
-        pAnalysisData->psnrB = 128;
-        pAnalysisData->psnrA = 128;
+static void CMP_SquaredErrorsFloat(CMP_ChannelErrors& errors, const CMP_FLOAT* pdata1, const CMP_FLOAT* pdata2, CMP_INT numPixels)
+{
+    CMP_FloatErrorSums sums;
+    CMP_AddSquaredErrorsFloat(sums, pdata1, pdata2, numPixels);
+    sums.Get(errors);
+}
+
+static void CMP_SquaredErrorsHalf(CMP_ChannelErrors& errors, const CMP_HALFSHORT* pdata1, const CMP_HALFSHORT* pdata2, CMP_INT numPixels)
+{
+    const CMP_INT chunkPixels = 1024;
+    CMP_FLOAT     pixels1[chunkPixels * 4];
+    CMP_FLOAT     pixels2[chunkPixels * 4];
+
+    CMP_FloatErrorSums sums;
+    for (CMP_INT i = 0; i < numPixels; i += chunkPixels)
+    {
+        CMP_INT count = cmp_minT(chunkPixels, numPixels - i);
+        HalfShortToFloat(pixels1, (CMP_HALFSHORT*)pdata1 + i * 4, count * 4);
+        HalfShortToFloat(pixels2, (CMP_HALFSHORT*)pdata2 + i * 4, count * 4);
+        CMP_AddSquaredErrorsFloat(sums, pixels1, pixels2, count);
     }
-    else
+    sums.Get(errors);
+}
+
+// Sums the squared differences of the image tiles on the thread pool and adds the tile sums in order
+template <class T, class F>
+static void CMP_SumSquaredErrors(CMP_ChannelErrors& errors, const T* pdata1, const T* pdata2, CMP_INT numPixels, CMP_INT valuesPerPixel, F tileErrors)
+{
+    CMP_INT numTiles = (numPixels + CMP_ANALYSIS_TILE_PIXELS - 1) / CMP_ANALYSIS_TILE_PIXELS;
+
+    std::vector<CMP_ChannelErrors> tiles(numTiles);
+
+    auto sumTile = [&](CMP_INT nTile) {
+        CMP_INT first = nTile * CMP_ANALYSIS_TILE_PIXELS;
+        CMP_INT count = cmp_minT(CMP_ANALYSIS_TILE_PIXELS, numPixels - first);
+        tileErrors(tiles[nTile], pdata1 + first * valuesPerPixel, pdata2 + first * valuesPerPixel, count);
+    };
+
+    if (numTiles > 1)
+        CMP_ThreadPool::GetInstance().ParallelFor(numTiles, 0, sumTile);
+    else if (numTiles == 1)
+        sumTile(0);
+
+    for (CMP_INT ch = 0; ch < 4; ch++)
+        errors.sum[ch] = 0.0;
+
+    for (CMP_INT nTile = 0; nTile < numTiles; nTile++)
     {
-        if (pAnalysisData->mse > 0.0)
-            pAnalysisData->psnr = 10 * log((1.0 * 255 * 255) / pAnalysisData->mse) / log(10.0);
-        if (pAnalysisData->mseR > 0.0)
-            pAnalysisData->psnrR = 10 * log((1.0 * 255 * 255) / pAnalysisData->mseR) / log(10.0);
-        if (pAnalysisData->mseG > 0.0)
-            pAnalysisData->psnrG = 10 * log((1.0 * 255 * 255) / pAnalysisData->mseG) / log(10.0);
-        if (pAnalysisData->mseB > 0.0)
-            pAnalysisData->psnrB = 10 * log((1.0 * 255 * 255) / pAnalysisData->mseB) / log(10.0);
-        if (pAnalysisData->mseA > 0.0)
-            pAnalysisData->psnrA = 10 * log((1.0 * 255 * 255) / pAnalysisData->mseA) / log(10.0);
+        for (CMP_INT ch = 0; ch < 4; ch++)
+            errors.sum[ch] += tiles[nTile].sum[ch];
     }
 }
 
-void CMP_calcMSE_PSNRf32(MipLevel* pCurMipLevel, CMP_FLOAT* pdata1, CMP_FLOAT* pdata2, CMP_AnalysisData* pAnalysisData)
+static void CMP_SetMSE_PSNR(const CMP_ChannelErrors& errors, CMP_INT numPixels, CMP_AnalysisData* pAnalysisData)
 {
     CMP_UINT   RGBAChannels = pAnalysisData->channelBitMap;
-    CMP_DOUBLE mse;
-    CMP_DOUBLE mseR         = 0.0;
-    CMP_DOUBLE mseG         = 0.0;
-    CMP_DOUBLE mseB         = 0.0;
-    CMP_DOUBLE mseA         = 0.0;
     CMP_DOUBLE mseRGBA      = 0.0;
-    CMP_INT    totalPixelsR = 0;
-    CMP_INT    totalPixelsG = 0;
-    CMP_INT    totalPixelsB = 0;
-    CMP_INT    totalPixelsA = 0;
     CMP_INT    totalPixels  = 0;
+    CMP_INT    channelPixels[4];
 
-    for (int y = 0; y < pCurMipLevel->m_nHeight; y++)
+    for (CMP_INT ch = 0; ch < 4; ch++)
     {
-        for (int x = 0; x < pCurMipLevel->m_nWidth; x++)
+        channelPixels[ch] = (RGBAChannels & (1 << ch)) ? numPixels : 0;
+        if (channelPixels[ch])
         {
-            // calc Gamma for the all active channels
-            // Red channel
-            if (RGBAChannels & 0b0001)
-            {
-                mse = pow(abs(*pdata1 - *pdata2), 2);
-                mseR += mse;
-                mseRGBA += mse;
-                totalPixelsR++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Green channel
-            if (RGBAChannels & 0b0010)
-            {
-                mse = pow(abs(*pdata1 - *pdata2), 2);
-                mseG += mse;
-                mseRGBA += mse;
-                totalPixelsG++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Blue channel
-            if (RGBAChannels & 0b0100)
-            {
-                mse = pow(abs(*pdata1 - *pdata2), 2);
-                mseB += mse;
-                mseRGBA += mse;
-                totalPixelsB++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
-            // Alpha channel
-            if (RGBAChannels & 0b1000)
-            {
-                mse = pow(abs(*pdata1 - *pdata2), 2);
-                mseA += mse;
-                mseRGBA += mse;
-                totalPixelsA++;
-                totalPixels++;
-            }
-            pdata1++;
-            pdata2++;
+            mseRGBA += errors.sum[ch];
+            totalPixels += numPixels;
         }
     }
 
@@ -673,11 +624,11 @@ void CMP_calcMSE_PSNRf32(MipLevel* pCurMipLevel, CMP_FLOAT* pdata1, CMP_FLOAT* p
         totalPixels = 1;
     }
 
-    pAnalysisData->mse  = mseRGBA / totalPixels;
-    pAnalysisData->mseR = mseR / totalPixelsR;
-    pAnalysisData->mseG = mseG / totalPixelsG;
-    pAnalysisData->mseB = mseB / totalPixelsB;
-    pAnalysisData->mseA = mseA / totalPixelsA;
+    pAnalysisData->mse  = (float)(mseRGBA / totalPixels);
+    pAnalysisData->mseR = (float)(errors.sum[0] / channelPixels[0]);
+    pAnalysisData->mseG = (float)(errors.sum[1] / channelPixels[1]);
+    pAnalysisData->mseB = (float)(errors.sum[2] / channelPixels[2]);
+    pAnalysisData->mseA = (float)(errors.sum[3] / channelPixels[3]);
 
     if (pAnalysisData->mse <= 0.0)
     {
@@ -695,18 +646,54 @@ void CMP_calcMSE_PSNRf32(MipLevel* pCurMipLevel, CMP_FLOAT* pdata1, CMP_FLOAT* p
     else
     {
         if (pAnalysisData->mse > 0.0)
-            pAnalysisData->psnr = 10 * log((1.0 * 255 * 255) / pAnalysisData->mse) / log(10.0);
+            pAnalysisData->psnr = (float)(10 * log((1.0 * 255 * 255) / pAnalysisData->mse) / log(10.0));
         if (pAnalysisData->mseR > 0.0)
-            pAnalysisData->psnrR = 10 * log((1.0 * 255 * 255) / pAnalysisData->mseR) / log(10.0);
+            pAnalysisData->psnrR = (float)(10 * log((1.0 * 255 * 255) / pAnalysisData->mseR) / log(10.0));
         if (pAnalysisData->mseG > 0.0)
-            pAnalysisData->psnrG = 10 * log((1.0 * 255 * 255) / pAnalysisData->mseG) / log(10.0);
+            pAnalysisData->psnrG = (float)(10 * log((1.0 * 255 * 255) / pAnalysisData->mseG) / log(10.0));
         if (pAnalysisData->mseB > 0.0)
-            pAnalysisData->psnrB = 10 * log((1.0 * 255 * 255) / pAnalysisData->mseB) / log(10.0);
+            pAnalysisData->psnrB = (float)(10 * log((1.0 * 255 * 255) / pAnalysisData->mseB) / log(10.0));
         if (pAnalysisData->mseA > 0.0)
-            pAnalysisData->psnrA = 10 * log((1.0 * 255 * 255) / pAnalysisData->mseA) / log(10.0);
+            pAnalysisData->psnrA = (float)(10 * log((1.0 * 255 * 255) / pAnalysisData->mseA) / log(10.0));
     }
 }
 
+void CMP_calcMSE_PSNRb(MipLevel* pCurMipLevel, CMP_BYTE* pdata1, CMP_BYTE* pdata2, CMP_AnalysisData* pAnalysisData)
+{
+    CMP_INT           numPixels = pCurMipLevel->m_nWidth * pCurMipLevel->m_nHeight;
+    CMP_ChannelErrors errors;
+
+    CMP_SumSquaredErrors(errors, pdata1, pdata2, numPixels, 4, CMP_SquaredErrorsByte);
+    CMP_SetMSE_PSNR(errors, numPixels, pAnalysisData);
+}
+
+void CMP_calcMSE_PSNR1010102(MipLevel* pCurMipLevel, CMP_DWORD* buffer1, CMP_DWORD* buffer2, CMP_AnalysisData* pAnalysisData)
+{
+    CMP_INT           numPixels = pCurMipLevel->m_nWidth * pCurMipLevel->m_nHeight;
+    CMP_ChannelErrors errors;
+
+    CMP_SumSquaredErrors(errors, buffer1, buffer2, numPixels, 1, CMP_SquaredErrors1010102);
+    CMP_SetMSE_PSNR(errors, numPixels, pAnalysisData);
+}
+
+void CMP_calcMSE_PSNRHalfShort(MipLevel* pCurMipLevel, CMP_HALFSHORT* pdata1, CMP_HALFSHORT* pdata2, CMP_AnalysisData* pAnalysisData)
+{
+    CMP_INT           numPixels = pCurMipLevel->m_nWidth * pCurMipLevel->m_nHeight;
+    CMP_ChannelErrors errors;
+
+    CMP_SumSquaredErrors(errors, pdata1, pdata2, numPixels, 4, CMP_SquaredErrorsHalf);
+    CMP_SetMSE_PSNR(errors, numPixels, pAnalysisData);
+}
+
+void CMP_calcMSE_PSNRf32(MipLevel* pCurMipLevel, CMP_FLOAT* pdata1, CMP_FLOAT* pdata2, CMP_AnalysisData* pAnalysisData)
+{
+    CMP_INT           numPixels = pCurMipLevel->m_nWidth * pCurMipLevel->m_nHeight;
+    CMP_ChannelErrors errors;
+
+    CMP_SumSquaredErrors(errors, pdata1, pdata2, numPixels, 4, CMP_SquaredErrorsFloat);
+    CMP_SetMSE_PSNR(errors, numPixels, pAnalysisData);
+}
+
 CMP_ERROR CMP_API CMP_MipSetAnlaysis(CMP_MipSet* src1, CMP_MipSet* src2, CMP_INT nMipLevel, CMP_INT nFaceOrSlice, CMP_AnalysisData* pAnalysisData)
 {
     if (!src1 || !src2)
@@ -1025,49 +1012,9 @@ bool CMP_CMIPS::AllocateMipLevelData(CMP_MipLevel* pMipLevel, int nWidth, int nH
     assert(pMipLevel);
     assert(nWidth > 0 && nHeight > 0);
 
-    CMP_DWORD dwBitsPerPixel;
-    switch (channelFormat)
+    CMP_DWORD dwBitsPerPixel = CMP_MipLevelBitsPerPixel(channelFormat, textureDataType);
+    if (dwBitsPerPixel == 0)
     {
-    case CF_8bit:
-    case CF_2101010:
-    case CF_1010102:
-    case CF_Float9995E:
-        dwBitsPerPixel = 8;
-        break;
-
-    case CF_16bit:
-    case CF_Float16:
-        dwBitsPerPixel = 16;
-        break;
-
-    case CF_32bit:
-    case CF_Float32:
-        dwBitsPerPixel = 32;
-        break;
-
-    default:
-        assert(0);
-        return false;
-    }
-
-    switch (textureDataType)
-    {
-    case TDT_XRGB:
-    case TDT_ARGB:
-    case TDT_NORMAL_MAP:
-        dwBitsPerPixel *= 4;
-        break;
-    case TDT_RGB:
-        dwBitsPerPixel *= 3;
-        break;
-    case TDT_RG:
-    case TDT_16:
-        dwBitsPerPixel *= 2;
-        break;
-    case TDT_R:
-    case TDT_8:
-        break;
-    default:
         assert(0);
         return false;
     }
@@ -1077,7 +1024,7 @@ bool CMP_CMIPS::AllocateMipLevelData(CMP_MipLevel* pMipLevel, int nWidth, int nH
     pMipLevel->m_nHeight      = nHeight;
     pMipLevel->m_dwLinearSize = dwPitch * nHeight;
 
-    pMipLevel->m_pbData = reinterpret_cast<CMP_BYTE*>(malloc(pMipLevel->m_dwLinearSize));
+    pMipLevel->m_pbData = reinterpret_cast<CMP_BYTE*>(CMP_MemAllocLevel(pMipLevel->m_dwLinearSize));
 
     return (pMipLevel->m_pbData != NULL);
 }
@@ -1092,11 +1039,67 @@ bool CMP_CMIPS::AllocateCompressedMipLevelData(CMP_MipLevel* pMipLevel, int nWid
     pMipLevel->m_nWidth       = nWidth;
     pMipLevel->m_nHeight      = nHeight;
 
-    pMipLevel->m_pbData = reinterpret_cast<CMP_BYTE*>(malloc(pMipLevel->m_dwLinearSize));
+    pMipLevel->m_pbData = reinterpret_cast<CMP_BYTE*>(CMP_MemAllocLevel(pMipLevel->m_dwLinearSize));
 
     return (pMipLevel->m_pbData != NULL);
 }
 
+bool CMP_CMIPS::AllocateContiguousMipLevels(CMP_MipSet* pMipSet)
+{
+    assert(pMipSet && pMipSet->m_pMipLevelTable);
+    if (!pMipSet || !pMipSet->m_pMipLevelTable || (pMipSet->m_Flags & MS_FLAG_ContiguousLevels))
+        return false;
+
+    CMP_DWORD dwBitsPerPixel = CMP_MipLevelBitsPerPixel(pMipSet->m_ChannelFormat, pMipSet->m_TextureDataType);
+    if (dwBitsPerPixel == 0)
+        return false;
+
+    // Size every level first, each one starts on an aligned boundary of the block
+    std::vector<CMP_MipLevel*> mipLevels;
+    size_t                     totalSize = 0;
+
+    int nWidth  = pMipSet->m_nWidth;
+    int nHeight = pMipSet->m_nHeight;
+    int nDepth  = pMipSet->m_nDepth;
+    for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMaxMipLevels; nMipLevel++)
+    {
+        for (int nFaceOrSlice = 0; nFaceOrSlice < nDepth; nFaceOrSlice++)
+        {
+            CMP_MipLevel* pMipLevel = GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
+            if (!pMipLevel || pMipLevel->m_pbData)
+            {
+                assert(!"Mip level missing or already allocated");
+                return false;
+            }
+
+            pMipLevel->m_nWidth       = nWidth;
+            pMipLevel->m_nHeight      = nHeight;
+            pMipLevel->m_dwLinearSize = CMP_PAD_BYTE(nWidth, dwBitsPerPixel) * nHeight;
+
+            mipLevels.push_back(pMipLevel);
+            totalSize += (pMipLevel->m_dwLinearSize + CMP_MIPSET_ALIGNMENT - 1) & ~(size_t)(CMP_MIPSET_ALIGNMENT - 1);
+        }
+
+        nWidth  = nWidth > 1 ? nWidth >> 1 : 1;
+        nHeight = nHeight > 1 ? nHeight >> 1 : 1;
+        if (pMipSet->m_TextureType == TT_VolumeTexture)
+            nDepth = nDepth > 1 ? nDepth >> 1 : 1;
+    }
+
+    CMP_BYTE* pData = reinterpret_cast<CMP_BYTE*>(CMP_MemAlloc(totalSize));
+    if (!pData)
+        return false;
+
+    for (CMP_MipLevel* pMipLevel : mipLevels)
+    {
+        pMipLevel->m_pbData = pData;
+        pData += (pMipLevel->m_dwLinearSize + CMP_MIPSET_ALIGNMENT - 1) & ~(size_t)(CMP_MIPSET_ALIGNMENT - 1);
+    }
+
+    pMipSet->m_Flags |= MS_FLAG_ContiguousLevels;
+    return true;
+}
+
 void CMP_CMIPS::FreeMipSet(CMP_MipSet* pMipSet)
 {
     //TODO test
@@ -1130,6 +1133,19 @@ void CMP_CMIPS::FreeMipSet(CMP_MipSet* pMipSet)
                 assert(0);
             }
 
+            if (pMipSet->m_Flags & MS_FLAG_ContiguousLevels)
+            {
+                // A single block starting with the first level holds the data of every level
+                CMP_MemFree(pMipSet->m_pMipLevelTable[0]->m_pbData);
+                for (int i = 0; i < nTotalOldMipLevels; i++)
+                    pMipSet->m_pMipLevelTable[i]->m_pbData = NULL;
+
+                pMipSet->m_Flags &= ~MS_FLAG_ContiguousLevels;
+            }
+
+            // Mapped levels give their reference on the mapping back through CMP_MemFreeLevel below
+            pMipSet->m_Flags &= ~MS_FLAG_MappedLevels;
+
             for (int i = 0; i < nTotalOldMipLevels; i++)
             {
                 if (pMipSet->m_pMipLevelTable[i]->m_pbData)
@@ -1143,7 +1159,7 @@ void CMP_CMIPS::FreeMipSet(CMP_MipSet* pMipSet)
                     }
                     else
 #endif
-                        free(pMipSet->m_pMipLevelTable[i]->m_pbData);
+                        CMP_MemFreeLevel(pMipSet->m_pMipLevelTable[i]->m_pbData);
 
                     pMipSet->m_pMipLevelTable[i]->m_pbData = NULL;
                 }
@@ -1167,7 +1183,7 @@ void CMP_CMIPS::FreeMipLevelData(CMP_MipLevel* pMipLevel)
 {
     if (pMipLevel->m_pbData)
     {
-        free(pMipLevel->m_pbData);
+        CMP_MemFreeLevel(pMipLevel->m_pbData);
         pMipLevel->m_pbData = NULL;
     }
 }
@@ -0,0 +1,471 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "cmp_threadpool.h"
+
+#include <assert.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+static thread_local CMP_INT tls_WorkerIndex = -1;
+
+static CMP_INT GetProcessorCount()
+{
+    CMP_INT count = (CMP_INT)std::thread::hardware_concurrency();
+    return (count > 0) ? count : 1;
+}
+
+static void PinThread(std::thread& thread, CMP_INT processor)
+{
+#ifdef _WIN32
+    if (processor < (CMP_INT)(sizeof(DWORD_PTR) * 8))
+        SetThreadAffinityMask((HANDLE)thread.native_handle(), ((DWORD_PTR)1) << processor);
+#elif !defined(__APPLE__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(processor, &cpuset);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+#else
+    // macOS has no API to bind a thread to a core, affinity is left to the scheduler
+    (void)thread;
+    (void)processor;
+#endif
+}
+
+CMP_ThreadPool& CMP_ThreadPool::GetInstance()
+{
+    // Intentionally never destroyed: workers may still be parked when static destructors run at exit
+    static CMP_ThreadPool* instance = new CMP_ThreadPool();
+    return *instance;
+}
+
+CMP_ThreadPool::CMP_ThreadPool()
+    : m_NumThreads(0)
+    , m_QueuedTasks(0)
+    , m_SharedTasks(0)
+    , m_Sleeping(0)
+    , m_Exit(false)
+{
+}
+
+CMP_ThreadPool::~CMP_ThreadPool()
+{
+    Shutdown();
+}
+
+bool CMP_ThreadPool::Initialize(CMP_DWORD numThreads, CMP_BOOL pinThreads, CMP_DWORD firstProcessor)
+{
+    std::lock_guard<std::mutex> lock(m_ConfigMutex);
+    Stop();
+    Start(numThreads, pinThreads, firstProcessor);
+    return m_NumThreads.load() > 0;
+}
+
+void CMP_ThreadPool::Shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_ConfigMutex);
+    Stop();
+}
+
+CMP_INT CMP_ThreadPool::GetNumThreads()
+{
+    CMP_INT numThreads = m_NumThreads.load();
+    if (numThreads == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_ConfigMutex);
+        if (m_NumThreads.load() == 0)
+            Start(0, false, 0);
+        numThreads = m_NumThreads.load();
+    }
+    return numThreads;
+}
+
+CMP_INT CMP_ThreadPool::GetWorkerIndex()
+{
+    return tls_WorkerIndex;
+}
+
+void CMP_ThreadPool::Start(CMP_DWORD numThreads, CMP_BOOL pinThreads, CMP_DWORD firstProcessor)
+{
+    CMP_INT processors = GetProcessorCount();
+    CMP_INT count      = (numThreads == 0) ? processors : (CMP_INT)numThreads;
+    if (count > CMP_MAX_POOL_THREADS)
+        count = CMP_MAX_POOL_THREADS;
+
+    m_Exit = false;
+    m_Workers.resize(count);
+    for (CMP_INT i = 0; i < count; i++)
+    {
+        m_Workers[i]           = new Worker();
+        m_Workers[i]->busyNS   = 0;
+        m_Workers[i]->numTasks = 0;
+    }
+    m_StatsStart = std::chrono::steady_clock::now();
+
+    // Publish the worker count before any thread can look at the worker table
+    m_NumThreads.store(count);
+
+    for (CMP_INT i = 0; i < count; i++)
+    {
+        m_Workers[i]->thread = std::thread(&CMP_ThreadPool::WorkerProc, this, i);
+        if (pinThreads)
+            PinThread(m_Workers[i]->thread, (CMP_INT)((firstProcessor + i) % processors));
+    }
+}
+
+void CMP_ThreadPool::Stop()
+{
+    if (m_Workers.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Exit = true;
+    }
+    m_WakeUp.notify_all();
+
+    for (Worker* worker : m_Workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+
+    m_NumThreads.store(0);
+    for (Worker* worker : m_Workers)
+        delete worker;
+    m_Workers.clear();
+}
+
+void CMP_ThreadPool::Submit(CMP_TaskGroup& group, std::function<void()> task)
+{
+    GetNumThreads();
+
+    group.m_Pending++;
+
+    Task    item  = {std::move(task), &group};
+    CMP_INT index = tls_WorkerIndex;
+    if (index >= 0)
+    {
+        Worker* worker = m_Workers[index];
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->tasks.push_back(std::move(item));
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Queue.push_back(std::move(item));
+        m_SharedTasks++;
+        group.m_SharedQueued++;
+    }
+
+    // Sleepers register in m_Sleeping before checking m_QueuedTasks, so one of the two sides always sees the other
+    m_QueuedTasks++;
+    if (m_Sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_WakeUp.notify_one();
+    }
+}
+
+void CMP_ThreadPool::SubmitShared(CMP_TaskGroup& group, std::function<void()> task)
+{
+    GetNumThreads();
+
+    group.m_Pending++;
+
+    Task item = {std::move(task), &group};
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Queue.push_back(std::move(item));
+        m_SharedTasks++;
+        group.m_SharedQueued++;
+    }
+
+    m_QueuedTasks++;
+    if (m_Sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_WakeUp.notify_one();
+    }
+}
+
+bool CMP_ThreadPool::HasSharedWork(CMP_INT ownTasks) const
+{
+    return m_SharedTasks.load() > ownTasks;
+}
+
+void CMP_ThreadPool::Wait(CMP_TaskGroup& group)
+{
+    CMP_INT index = tls_WorkerIndex;
+    if (index >= 0)
+    {
+        // Help out instead of blocking a worker, this keeps nested submissions deadlock free
+        Task task;
+        while (!group.IsDone() && PopTask(index, task))
+            RunTask(task);
+    }
+
+    // Always synchronize on the group mutex so the last task is done touching the group before it goes out of scope
+    std::unique_lock<std::mutex> lock(group.m_Mutex);
+    group.m_Done.wait(lock, [&group] { return group.m_Pending.load() == 0; });
+}
+
+bool CMP_ThreadPool::RunPendingTask()
+{
+    CMP_INT index = tls_WorkerIndex;
+    if (index < 0)
+        return false;
+
+    Task task;
+    if (!PopTask(index, task))
+        return false;
+
+    RunTask(task);
+    return true;
+}
+
+void CMP_ThreadPool::WaitUntil(const std::function<bool()>& isDone)
+{
+    CMP_INT index = tls_WorkerIndex;
+    assert(index >= 0);
+
+    Task task;
+    while (!isDone())
+    {
+        if (PopTask(index, task))
+        {
+            RunTask(task);
+            continue;
+        }
+
+        // Same protocol as an idle worker, WakeWaiters takes m_QueueMutex so the check below cannot miss it
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_Sleeping++;
+        m_WakeUp.wait(lock, [this, &isDone] { return m_Exit || (m_QueuedTasks.load() > 0) || isDone(); });
+        m_Sleeping--;
+        if (m_Exit)
+            break;
+    }
+}
+
+void CMP_ThreadPool::WakeWaiters()
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_WakeUp.notify_all();
+}
+
+void CMP_ThreadPool::ParallelFor(CMP_INT count, CMP_INT maxWorkers, const std::function<void(CMP_INT)>& fn)
+{
+    if (count <= 0)
+        return;
+
+    CMP_INT numTasks = GetNumThreads();
+    if ((maxWorkers > 0) && (maxWorkers < numTasks))
+        numTasks = maxWorkers;
+    if (count < numTasks)
+        numTasks = count;
+
+    std::atomic<CMP_INT>  next(0);
+    CMP_TaskGroup         group;
+    std::function<void()> loop = [this, &next, &fn, &group, &loop, count]() {
+        CMP_INT i;
+        while ((i = next++) < count)
+        {
+            fn(i);
+
+            // Give way to other callers, the loop continues once the work queued before it has been picked up
+            if (HasSharedWork(group.m_SharedQueued.load()) && (next.load() < count))
+            {
+                SubmitShared(group, loop);
+                return;
+            }
+        }
+    };
+
+    for (CMP_INT t = 0; t < numTasks; t++)
+        Submit(group, loop);
+    Wait(group);
+}
+
+void CMP_ThreadPool::GetStats(CMP_ThreadPoolStats& stats)
+{
+    // Start the pool if needed so the stats always describe the current workers
+    GetNumThreads();
+
+    std::lock_guard<std::mutex> lock(m_ConfigMutex);
+    stats.nNumThreads = (CMP_INT)m_Workers.size();
+    stats.fElapsedMS  = std::chrono::duration<CMP_FLOAT, std::milli>(std::chrono::steady_clock::now() - m_StatsStart).count();
+    for (CMP_INT i = 0; i < CMP_MAX_POOL_THREADS; i++)
+    {
+        bool active      = i < stats.nNumThreads;
+        stats.fBusyMS[i] = active ? (CMP_FLOAT)(m_Workers[i]->busyNS.load() / 1.0e6) : 0.0f;
+        stats.dwTasks[i] = active ? m_Workers[i]->numTasks.load() : 0;
+    }
+}
+
+void CMP_ThreadPool::ResetStats()
+{
+    std::lock_guard<std::mutex> lock(m_ConfigMutex);
+    for (Worker* worker : m_Workers)
+    {
+        worker->busyNS   = 0;
+        worker->numTasks = 0;
+    }
+    m_StatsStart = std::chrono::steady_clock::now();
+}
+
+bool CMP_ThreadPool::PopTask(CMP_INT index, Task& task)
+{
+    if (m_QueuedTasks.load() == 0)
+        return false;
+
+    CMP_INT numWorkers = (CMP_INT)m_Workers.size();
+
+    // Own work first, newest first for cache locality
+    if (index >= 0)
+    {
+        Worker* worker = m_Workers[index];
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (!worker->tasks.empty())
+        {
+            task = std::move(worker->tasks.back());
+            worker->tasks.pop_back();
+            m_QueuedTasks--;
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        if (!m_Queue.empty())
+        {
+            task = std::move(m_Queue.front());
+            m_Queue.pop_front();
+            m_SharedTasks--;
+            task.group->m_SharedQueued--;
+            m_QueuedTasks--;
+            return true;
+        }
+    }
+
+    // Steal the oldest task from another worker
+    for (CMP_INT i = 1; i < numWorkers; i++)
+    {
+        Worker* victim = m_Workers[(index + i) % numWorkers];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->tasks.empty())
+        {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            m_QueuedTasks--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void CMP_ThreadPool::RunTask(Task& task, Worker* worker)
+{
+    auto start = std::chrono::steady_clock::now();
+    task.run();
+    task.run = nullptr;
+
+    // Account before the group completes so the stats are current once Wait returns
+    if (worker)
+    {
+        auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        worker->busyNS += (uint64_t)busy.count();
+        worker->numTasks++;
+    }
+
+    CMP_TaskGroup* group = task.group;
+    std::lock_guard<std::mutex> lock(group->m_Mutex);
+    if (--group->m_Pending == 0)
+        group->m_Done.notify_all();
+}
+
+void CMP_ThreadPool::WorkerProc(CMP_INT index)
+{
+    tls_WorkerIndex = index;
+
+    Task task;
+    for (;;)
+    {
+        if (PopTask(index, task))
+        {
+            // Nested tasks run inside this one while it waits, so they are already part of its busy time
+            RunTask(task, m_Workers[index]);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_Sleeping++;
+        m_WakeUp.wait(lock, [this] { return m_Exit || (m_QueuedTasks.load() > 0); });
+        m_Sleeping--;
+        if (m_Exit)
+            break;
+    }
+
+    tls_WorkerIndex = -1;
+}
+
+CMP_ERROR CMP_API CMP_InitThreadPool(const CMP_ThreadPoolOptions* pOptions)
+{
+    if (!pOptions || (pOptions->dwSize != sizeof(CMP_ThreadPoolOptions)))
+        return CMP_ERR_GENERIC;
+
+    if (!CMP_ThreadPool::GetInstance().Initialize(pOptions->dwNumThreads, pOptions->bPinThreads, pOptions->dwFirstProcessor))
+        return CMP_ERR_FAILED_HOST_SETUP;
+
+    return CMP_OK;
+}
+
+CMP_VOID CMP_API CMP_ShutdownThreadPool()
+{
+    CMP_ThreadPool::GetInstance().Shutdown();
+}
+
+CMP_INT CMP_API CMP_GetThreadPoolSize()
+{
+    return CMP_ThreadPool::GetInstance().GetNumThreads();
+}
+
+CMP_ERROR CMP_API CMP_GetThreadPoolStats(CMP_ThreadPoolStats* pStats)
+{
+    if (!pStats || (pStats->dwSize != sizeof(CMP_ThreadPoolStats)))
+        return CMP_ERR_GENERIC;
+
+    CMP_ThreadPool::GetInstance().GetStats(*pStats);
+    return CMP_OK;
+}
+
+CMP_VOID CMP_API CMP_ResetThreadPoolStats()
+{
+    CMP_ThreadPool::GetInstance().ResetStats();
+}
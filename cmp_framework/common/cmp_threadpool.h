@@ -0,0 +1,160 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _CMP_THREADPOOL_H
+#define _CMP_THREADPOOL_H
+
+#include "compressonator.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A set of tasks submitted to the pool that a producer can wait on
+class CMP_TaskGroup
+{
+public:
+    CMP_TaskGroup()
+        : m_Pending(0)
+        , m_SharedQueued(0)
+    {
+    }
+
+    bool IsDone() const
+    {
+        return m_Pending.load() == 0;
+    }
+
+private:
+    friend class CMP_ThreadPool;
+
+    std::atomic<CMP_INT>    m_Pending;
+    std::atomic<CMP_INT>    m_SharedQueued;  // Tasks of this group in the shared queue
+    std::mutex              m_Mutex;
+    std::condition_variable m_Done;
+};
+
+//
+// Library wide work-stealing thread pool
+//
+// Workers live for the life of the process (or until CMP_ShutdownThreadPool) and are shared by all CPU codecs.
+// Each worker owns a deque: tasks it submits are pushed and popped LIFO at the back, idle workers steal FIFO
+// from the front of other workers. Tasks submitted from threads outside the pool go to a shared queue.
+//
+// A pool worker that waits on a task group keeps executing queued tasks until the group completes, so tasks
+// can safely submit and wait on nested work. Threads outside the pool simply block until the group is done,
+// this guarantees a task only ever runs on a pool worker and GetWorkerIndex() is valid inside every task.
+//
+class CMP_ThreadPool
+{
+public:
+    static CMP_ThreadPool& GetInstance();
+
+    // Restarts the pool with the given worker count (0 = number of processors).
+    // When pinThreads is set worker i is bound to logical processor (firstProcessor + i) % processors.
+    // Must not be called while work is in flight.
+    bool Initialize(CMP_DWORD numThreads, CMP_BOOL pinThreads, CMP_DWORD firstProcessor);
+    void Shutdown();
+
+    // Number of pool workers, starts the pool with default settings on first use
+    CMP_INT GetNumThreads();
+
+    // Index of the calling pool worker in the range 0..GetNumThreads()-1, or -1 if not called from a pool worker
+    static CMP_INT GetWorkerIndex();
+
+    void Submit(CMP_TaskGroup& group, std::function<void()> task);
+    void Wait(CMP_TaskGroup& group);
+
+    // Queues a task at the back of the shared queue, also when called from a pool worker.
+    // Work queued this way runs in submission order behind everything that is already waiting.
+    void SubmitShared(CMP_TaskGroup& group, std::function<void()> task);
+
+    // True when more than ownTasks tasks are waiting in the shared queue. Long running tasks check this to give way
+    // to other callers, passing how many of their own follow-up tasks are still queued there.
+    bool HasSharedWork(CMP_INT ownTasks) const;
+
+    // Lets a pool worker that is blocked on something other than a task group run one queued task.
+    // Returns false if no task was run or if not called from a pool worker.
+    bool RunPendingTask();
+
+    // Lets a pool worker run queued tasks until isDone() returns true, it sleeps with the idle workers when there is
+    // nothing to run. Whoever makes isDone() true must call WakeWaiters() afterwards.
+    void WaitUntil(const std::function<bool()>& isDone);
+    void WakeWaiters();
+
+    // Runs fn(0..count-1) on at most maxWorkers pool workers (0 = all), indices are handed out dynamically.
+    // While work of other callers waits in the shared queue a worker moves on after each index and requeues the loop
+    // behind it, so loops from different callers share the workers round robin.
+    void ParallelFor(CMP_INT count, CMP_INT maxWorkers, const std::function<void(CMP_INT)>& fn);
+
+    // Busy time and task count of each worker, counted for the tasks a worker picks up from its idle loop
+    void GetStats(CMP_ThreadPoolStats& stats);
+    void ResetStats();
+
+    ~CMP_ThreadPool();
+
+private:
+    CMP_ThreadPool();
+
+    struct Task
+    {
+        std::function<void()> run;
+        CMP_TaskGroup*        group;
+    };
+
+    struct Worker
+    {
+        std::deque<Task>       tasks;
+        std::mutex             mutex;
+        std::thread            thread;
+        std::atomic<uint64_t>  busyNS;
+        std::atomic<CMP_DWORD> numTasks;
+    };
+
+    void Start(CMP_DWORD numThreads, CMP_BOOL pinThreads, CMP_DWORD firstProcessor);
+    void Stop();
+    void WorkerProc(CMP_INT index);
+    bool PopTask(CMP_INT index, Task& task);
+    void RunTask(Task& task, Worker* worker = NULL);
+
+    std::mutex           m_ConfigMutex;  // Serializes start and stop of the workers
+    std::vector<Worker*> m_Workers;
+    std::atomic<CMP_INT> m_NumThreads;
+
+    std::mutex              m_QueueMutex;   // Guards m_Queue and the sleep/wake protocol
+    std::condition_variable m_WakeUp;
+    std::deque<Task>        m_Queue;        // Tasks submitted from threads outside the pool or with SubmitShared
+    std::atomic<CMP_INT>    m_QueuedTasks;
+    std::atomic<CMP_INT>    m_SharedTasks;  // Tasks in m_Queue
+    std::atomic<CMP_INT>    m_Sleeping;
+    bool                    m_Exit;
+
+    std::chrono::steady_clock::time_point m_StatsStart;
+};
+
+#endif
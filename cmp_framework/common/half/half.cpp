@@ -53,12 +53,10 @@
 using namespace std;
 
 //-------------------------------------------------------------
-// Lookup tables for half-to-float and float-to-half conversion
+// Lookup table for float-to-half conversion
 //-------------------------------------------------------------
 
-HALF_EXPORT const half::uif half::_toFloat[1 << 16] =
-#include "tofloat.h"
-    HALF_EXPORT const unsigned short half::_eLut[1 << 9] =
+HALF_EXPORT const unsigned short half::_eLut[1 << 9] =
 #include "elut.h"
 
 //-----------------------------------------------
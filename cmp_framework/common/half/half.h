@@ -214,7 +214,6 @@ class half {
 
     unsigned short                            _h;
 
-    HALF_EXPORT static const uif              _toFloat[1 << 16];
     HALF_EXPORT static const unsigned short   _eLut[1 << 9];
 };
 
@@ -400,10 +399,12 @@ HALF_EXPORT void        printBits   (char  c[35], float f);
 //    slow, but the most common case is accelerated via table lookups.
 //
 //    Converting back from a half to a float is easier because we don't
-//    have to do any rounding.  In addition, there are only 65536
-//    different half numbers; we can convert each of those numbers once
-//    and store the results in a table.  Later, all conversions can be
-//    done using only simple table lookups.
+//    have to do any rounding.  The exponent and significand are moved
+//    into place with a few integer operations, which avoids a 256 KB
+//    lookup table competing with the image data for the caches.
+//
+//    Arrays of halfs and floats are best converted with the bulk
+//    functions in halfconvert.h, which use the F16C instructions.
 //
 //---------------------------------------------------------------------------
 
@@ -475,13 +476,39 @@ half::half (float f) {
 }
 
 
-//------------------------------------------
-// Half-to-float conversion via table lookup
-//------------------------------------------
+//------------------------
+// Half-to-float conversion
+//------------------------
 
 inline
 half::operator float () const {
-    return _toFloat[_h].f;
+    //
+    // Shift the exponent and significand into place and adjust the
+    // exponent bias.  Infinities and NANs keep an all ones exponent;
+    // zeroes and denormalized numbers are normalized by subtracting
+    // the implicit leading 1 again, which is exact.
+    //
+
+    uif x;
+
+    x.i = (_h & 0x7fff) << 13;
+
+    unsigned int e = x.i & 0x0f800000;
+
+    x.i += (127 - 15) << 23;
+
+    if (e == 0x0f800000) {
+        x.i += (128 - 16) << 23;
+    } else if (e == 0) {
+        uif m;
+
+        m.i = (1 - 15 + 127) << 23;
+        x.i += 1 << 23;
+        x.f -= m.f;
+    }
+
+    x.i |= (unsigned int)(_h & 0x8000) << 16;
+    return x.f;
 }
 
 
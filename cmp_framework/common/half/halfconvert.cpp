@@ -0,0 +1,250 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include "halfconvert.h"
+
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)) && !defined(__APPLE__)
+#define HALF_CONVERT_X86
+
+#include <immintrin.h>
+
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// The library is built for the baseline instruction set, the SIMD conversions are compiled for their own
+// targets and only called after checking the CPU
+#if defined(__GNUC__) || defined(__clang__)
+#define HALF_CONVERT_TARGET(t) __attribute__((target(t)))
+#else
+#define HALF_CONVERT_TARGET(t)
+#endif
+#endif
+
+#ifdef HALF_CONVERT_X86
+
+static void HalfConvertCPUID(int info[4], int leaf)
+{
+#ifdef _WIN32
+    __cpuidex(info, leaf, 0);
+#else
+    __cpuid_count(leaf, 0, info[0], info[1], info[2], info[3]);
+#endif
+}
+
+static unsigned long long HalfConvertXGETBV()
+{
+#ifdef _WIN32
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+
+static HalfConvertExtension DetectHalfConvertExtension()
+{
+    int info[4];
+
+    HalfConvertCPUID(info, 0);
+    int numLeaves = info[0];
+    if (numLeaves < 1)
+        return HALF_CONVERT_SCALAR;
+
+    // F16C needs AVX and the OS saving the YMM registers
+    HalfConvertCPUID(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    bool f16c    = (info[2] & (1 << 29)) != 0;
+
+    if (!osxsave || !avx || !f16c)
+        return HALF_CONVERT_SCALAR;
+
+    unsigned long long xcr0 = HalfConvertXGETBV();
+    if ((xcr0 & 0x06) != 0x06)
+        return HALF_CONVERT_SCALAR;
+
+    // AVX-512F with the OS saving the opmask and ZMM registers
+    if (numLeaves >= 7)
+    {
+        HalfConvertCPUID(info, 7);
+        bool avx2    = (info[1] & (1 << 5)) != 0;
+        bool avx512f = (info[1] & (1 << 16)) != 0;
+
+        if (avx2 && avx512f && (xcr0 & 0xe6) == 0xe6)
+            return HALF_CONVERT_AVX512;
+    }
+
+    return HALF_CONVERT_F16C;
+}
+
+// The hardware quiets NANs, while the half class keeps their significand, so groups containing a half with
+// an all ones exponent or a float NAN are converted by the scalar code
+
+HALF_CONVERT_TARGET("avx,f16c")
+static size_t ConvertHalfToFloatF16C(float* dst, const unsigned short* src, size_t count)
+{
+    const __m128i exponentMask = _mm_set1_epi16(0x7c00);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(h, exponentMask), exponentMask)))
+        {
+            for (size_t k = i; k < i + 8; k++)
+            {
+                half value;
+                value.setBits(src[k]);
+                dst[k] = value;
+            }
+            continue;
+        }
+
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+
+    return i;
+}
+
+HALF_CONVERT_TARGET("avx,f16c")
+static size_t ConvertFloatToHalfF16C(unsigned short* dst, const float* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 f = _mm256_loadu_ps(src + i);
+
+        if (_mm256_movemask_ps(_mm256_cmp_ps(f, f, _CMP_UNORD_Q)))
+        {
+            for (size_t k = i; k < i + 8; k++)
+                dst[k] = half(src[k]).bits();
+            continue;
+        }
+
+        _mm_storeu_si128((__m128i*)(dst + i), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    }
+
+    return i;
+}
+
+HALF_CONVERT_TARGET("avx512f,avx2,f16c")
+static size_t ConvertHalfToFloatAVX512(float* dst, const unsigned short* src, size_t count)
+{
+    const __m256i exponentMask = _mm256_set1_epi16(0x7c00);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i h = _mm256_loadu_si256((const __m256i*)(src + i));
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(h, exponentMask), exponentMask)))
+        {
+            for (size_t k = i; k < i + 16; k++)
+            {
+                half value;
+                value.setBits(src[k]);
+                dst[k] = value;
+            }
+            continue;
+        }
+
+        // The zero masked form converts the same lanes, GCC 12 warns about the _mm512_undefined_ps in the unmasked one
+        _mm512_storeu_ps(dst + i, _mm512_maskz_cvtph_ps(0xFFFF, h));
+    }
+
+    return i + ConvertHalfToFloatF16C(dst + i, src + i, count - i);
+}
+
+HALF_CONVERT_TARGET("avx512f,avx2,f16c")
+static size_t ConvertFloatToHalfAVX512(unsigned short* dst, const float* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 f = _mm512_loadu_ps(src + i);
+
+        if (_mm512_cmp_ps_mask(f, f, _CMP_UNORD_Q))
+        {
+            for (size_t k = i; k < i + 16; k++)
+                dst[k] = half(src[k]).bits();
+            continue;
+        }
+
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm512_maskz_cvtps_ph(0xFFFF, f, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    }
+
+    return i + ConvertFloatToHalfF16C(dst + i, src + i, count - i);
+}
+
+#endif
+
+HalfConvertExtension GetHalfConvertExtension()
+{
+#ifdef HALF_CONVERT_X86
+    static const HalfConvertExtension extension = DetectHalfConvertExtension();
+    return extension;
+#else
+    return HALF_CONVERT_SCALAR;
+#endif
+}
+
+void ConvertHalfToFloat(float* dst, const unsigned short* src, size_t count)
+{
+    size_t i = 0;
+
+#ifdef HALF_CONVERT_X86
+    HalfConvertExtension extension = GetHalfConvertExtension();
+    if (extension == HALF_CONVERT_AVX512)
+        i = ConvertHalfToFloatAVX512(dst, src, count);
+    else if (extension == HALF_CONVERT_F16C)
+        i = ConvertHalfToFloatF16C(dst, src, count);
+#endif
+
+    for (; i < count; i++)
+    {
+        half value;
+        value.setBits(src[i]);
+        dst[i] = value;
+    }
+}
+
+void ConvertFloatToHalf(unsigned short* dst, const float* src, size_t count)
+{
+    size_t i = 0;
+
+#ifdef HALF_CONVERT_X86
+    HalfConvertExtension extension = GetHalfConvertExtension();
+    if (extension == HALF_CONVERT_AVX512)
+        i = ConvertFloatToHalfAVX512(dst, src, count);
+    else if (extension == HALF_CONVERT_F16C)
+        i = ConvertFloatToHalfF16C(dst, src, count);
+#endif
+
+    for (; i < count; i++)
+        dst[i] = half(src[i]).bits();
+}
@@ -0,0 +1,60 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#ifndef HALFCONVERT_H
+#define HALFCONVERT_H
+
+#include <stddef.h>
+
+#include "half.h"
+
+// Bulk conversion between arrays of halfs and floats.
+//
+// The conversions use the AVX-512 or F16C instructions when the CPU supports them and the scalar half
+// class otherwise. The results are bit identical to converting each element with the half class:
+// float to half rounds to nearest even, and NANs keep the bit patterns of the half class.
+
+enum HalfConvertExtension
+{
+    HALF_CONVERT_SCALAR = 0,
+    HALF_CONVERT_F16C,
+    HALF_CONVERT_AVX512
+};
+
+// The instruction set used by the conversions on the current CPU
+HalfConvertExtension GetHalfConvertExtension();
+
+void ConvertHalfToFloat(float* dst, const unsigned short* src, size_t count);
+void ConvertFloatToHalf(unsigned short* dst, const float* src, size_t count);
+
+inline void ConvertHalfToFloat(float* dst, const half* src, size_t count)
+{
+    ConvertHalfToFloat(dst, (const unsigned short*)src, count);
+}
+
+inline void ConvertFloatToHalf(half* dst, const float* src, size_t count)
+{
+    ConvertFloatToHalf((unsigned short*)dst, src, count);
+}
+
+#endif
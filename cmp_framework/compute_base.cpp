@@ -32,6 +32,8 @@
 #include "cmp_core.h"
 #include "atiformats.h"
 #include "bcn_common_kernel.h"
+#include "cmp_filemap.h"
+#include "cmp_stream.h"
 
 #ifndef _WIN32
 #include <unistd.h> /* For open(), creat() */
@@ -653,11 +655,9 @@ void CMP_API CMP_GetMipLevel(CMP_MipLevel** data, const CMP_MipSet* pMipSet, int
 // FILE IO static plugin libs
 //==============================
 
-CMP_ERROR stb_load(const char* SourceFile, MipSet* MipSetIn)
+// Copies RGBA8 pixels decoded by stb into a new single level mip set and frees them
+static CMP_ERROR stb_copy(unsigned char* pTempData, int Width, int Height, MipSet* MipSetIn)
 {
-    int            Width, Height, ComponentCount;
-    unsigned char* pTempData = stbi_load(SourceFile, &Width, &Height, &ComponentCount, STBI_rgb_alpha);
-
     if (pTempData == NULL)
     {
         return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
@@ -666,13 +666,10 @@ CMP_ERROR stb_load(const char* SourceFile, MipSet* MipSetIn)
     CMP_CMIPS CMips;
 
     memset(MipSetIn, 0, sizeof(MipSet));
-    if (!CMips.AllocateMipSet(MipSetIn, CF_8bit, TDT_ARGB, TT_2D, Width, Height, 1))
-    {
-        return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
-    }
-
-    if (!CMips.AllocateMipLevelData(CMips.GetMipLevel(MipSetIn, 0), Width, Height, CF_8bit, TDT_ARGB))
+    if (!CMips.AllocateMipSet(MipSetIn, CF_8bit, TDT_ARGB, TT_2D, Width, Height, 1) ||
+        !CMips.AllocateMipLevelData(CMips.GetMipLevel(MipSetIn, 0), Width, Height, CF_8bit, TDT_ARGB))
     {
+        stbi_image_free(pTempData);
         return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
     }
 
@@ -697,6 +694,56 @@ CMP_ERROR stb_load(const char* SourceFile, MipSet* MipSetIn)
     return CMP_OK;
 }
 
+CMP_ERROR stb_load(const char* SourceFile, MipSet* MipSetIn)
+{
+    int            Width, Height, ComponentCount;
+    unsigned char* pTempData = stbi_load(SourceFile, &Width, &Height, &ComponentCount, STBI_rgb_alpha);
+
+    return stb_copy(pTempData, Width, Height, MipSetIn);
+}
+
+// stb reads through callbacks that also ask for the end of the data, which a stream only reports as a short read
+struct stb_stream
+{
+    CMP_Stream* pStream;
+    bool        bEnd;
+};
+
+static int stb_stream_read(void* user, char* data, int size)
+{
+    stb_stream* pStb = (stb_stream*)user;
+    size_t      read = CMP_StreamRead(pStb->pStream, data, 1, (size_t)size);
+    if (read < (size_t)size)
+        pStb->bEnd = true;
+    return (int)read;
+}
+
+static void stb_stream_skip(void* user, int n)
+{
+    CMP_StreamSeek(((stb_stream*)user)->pStream, n, SEEK_CUR);
+}
+
+static int stb_stream_eof(void* user)
+{
+    return ((stb_stream*)user)->bEnd ? 1 : 0;
+}
+
+static CMP_ERROR stb_load(CMP_Stream* pStream, MipSet* MipSetIn)
+{
+    stbi_io_callbacks callbacks = {stb_stream_read, stb_stream_skip, stb_stream_eof};
+    stb_stream        stb       = {pStream, false};
+
+    int            Width, Height, ComponentCount;
+    unsigned char* pTempData = stbi_load_from_callbacks(&callbacks, &stb, &Width, &Height, &ComponentCount, STBI_rgb_alpha);
+
+    return stb_copy(pTempData, Width, Height, MipSetIn);
+}
+
+static void stb_stream_write(void* context, void* data, int size)
+{
+    CMP_StreamWrite((CMP_Stream*)context, data, 1, (size_t)size);
+}
+
 void CMP_API CMP_FreeMipSet(CMP_MipSet* MipSetIn)
 {
     if (!MipSetIn)
@@ -715,6 +762,19 @@ char toupperChar(char ch)
     return static_cast<char>(::toupper(static_cast<unsigned char>(ch)));
 }
 
+// Make sure MipSetIn->pData is at top mip level
+static void SetTopMipLevelData(CMP_CMIPS& CMips, CMP_MipSet* MipSetIn)
+{
+    if (MipSetIn->pData == NULL)
+    {
+        CMP_MipLevel* pOutMipLevel = CMips.GetMipLevel(MipSetIn, 0, 0);
+        MipSetIn->pData            = pOutMipLevel->m_pbData;
+        MipSetIn->dwDataSize       = pOutMipLevel->m_dwLinearSize;
+        MipSetIn->dwHeight         = pOutMipLevel->m_nHeight;
+        MipSetIn->dwWidth          = pOutMipLevel->m_nWidth;
+    }
+}
+
 void CMP_API CMP_InitFramework()
 {
     CMP_RegisterHostPlugins();
@@ -767,15 +827,7 @@ CMP_ERROR CMP_API CMP_LoadTexture(const char* SourceFile, CMP_MipSet* MipSetIn)
     }
     else
     {
-        // Make sure MipSetIn->pData is at top mip level
-        if (MipSetIn->pData == NULL)
-        {
-            CMP_MipLevel* pOutMipLevel = CMips.GetMipLevel(MipSetIn, 0, 0);
-            MipSetIn->pData            = pOutMipLevel->m_pbData;
-            MipSetIn->dwDataSize       = pOutMipLevel->m_dwLinearSize;
-            MipSetIn->dwHeight         = pOutMipLevel->m_nHeight;
-            MipSetIn->dwWidth          = pOutMipLevel->m_nWidth;
-        }
+        SetTopMipLevelData(CMips, MipSetIn);
     }
     return status;
 }
@@ -801,6 +853,13 @@ CMP_ERROR CMP_API CMP_SaveTexture(const char* DestFile, CMP_MipSet* MipSetIn)
     //    return CMP_ERR_INVALID_DEST_TEXTURE;
     //}
 
+    // Opening the destination for writing truncates it, which would pull the data from under levels mapped from it
+    if ((MipSetIn->m_Flags & MS_FLAG_MappedLevels) && CMP_IsFileMapped(DestFile))
+    {
+        if (CMP_DetachMipSet(MipSetIn) != CMP_OK)
+            return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
+    }
+
     PluginInterface_Image* plugin_Image;
     plugin_Image = reinterpret_cast<PluginInterface_Image*>(g_pluginManager.GetPlugin("IMAGE", (char*)file_extension.c_str()));
 
@@ -835,6 +894,286 @@ CMP_ERROR CMP_API CMP_SaveTexture(const char* DestFile, CMP_MipSet* MipSetIn)
     return CMP_OK;
 }
 
+//==============================
+// Texture streams
+//==============================
+
+// Plugin name for a format hint, "ktx2" and ".KTX2" both give "KTX2"
+static std::string FormatName(const char* pszFormat)
+{
+    std::string format = pszFormat ? pszFormat : "";
+    if (!format.empty() && (format[0] == '.'))
+        format.erase(0, 1);
+
+    std::transform(format.begin(), format.end(), format.begin(), toupperChar);
+    return format;
+}
+
+// Plugin name for the signature at the current position of the stream, empty if it is not one a plugin reads
+static std::string DetectFormat(CMP_Stream* pStream)
+{
+    static const CMP_BYTE ktx1[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+    static const CMP_BYTE ktx2[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    static const CMP_BYTE exr[4]   = {0x76, 0x2F, 0x31, 0x01};
+
+    CMP_BYTE header[12] = {};
+    int64_t  pos        = CMP_StreamTell(pStream);
+    size_t   read       = CMP_StreamRead(pStream, header, 1, sizeof(header));
+    CMP_StreamSeek(pStream, pos, SEEK_SET);
+
+    if ((read >= 4) && (memcmp(header, "DDS ", 4) == 0))
+        return "DDS";
+    if ((read >= sizeof(ktx1)) && (memcmp(header, ktx1, sizeof(ktx1)) == 0))
+        return "KTX";
+    if ((read >= sizeof(ktx2)) && (memcmp(header, ktx2, sizeof(ktx2)) == 0))
+        return "KTX2";
+    if ((read >= sizeof(exr)) && (memcmp(header, exr, sizeof(exr)) == 0))
+        return "EXR";
+    if ((read >= 4) && (memcmp(header, "BRLG", 4) == 0))
+        return "BRLG";
+
+    return "";
+}
+
+// Stream loads and saves came with plugin API 1.5, plugins built against an older interface do not have them
+static bool PluginHasStreams(PluginInterface_Image* plugin_Image)
+{
+    TC_PluginVersion version;
+    memset(&version, 0, sizeof(version));
+    plugin_Image->TC_PluginGetVersion(&version);
+
+    return (version.dwAPIVersionMajor > 1) || ((version.dwAPIVersionMajor == 1) && (version.dwAPIVersionMinor >= 5));
+}
+
+// Loads from a stream that can seek, the stream is not closed
+static CMP_ERROR LoadTextureFromStream(CMP_Stream* pStream, const char* pszFormat, CMP_MipSet* MipSetIn)
+{
+    CMP_RegisterHostPlugins();
+
+    CMP_CMIPS CMips;
+    CMP_ERROR status = CMP_ERR_PLUGIN_FILE_NOT_FOUND;
+    int64_t   start  = CMP_StreamTell(pStream);
+
+    std::string format = pszFormat ? FormatName(pszFormat) : DetectFormat(pStream);
+    if (!format.empty())
+    {
+        PluginInterface_Image* plugin_Image = reinterpret_cast<PluginInterface_Image*>(g_pluginManager.GetPlugin("IMAGE", (char*)format.c_str()));
+        if (plugin_Image)
+        {
+            if (PluginHasStreams(plugin_Image))
+            {
+                plugin_Image->TC_PluginSetSharedIO(&CMips);
+                status = (plugin_Image->TC_PluginStreamLoadTexture(pStream, MipSetIn) == 0) ? CMP_OK : CMP_ERR_UNABLE_TO_LOAD_FILE;
+            }
+
+            delete plugin_Image;
+        }
+    }
+
+    // load failed: try stb lib
+    if (status != CMP_OK)
+    {
+        if (CMP_StreamSeek(pStream, start, SEEK_SET) != 0)
+            return CMP_ERR_UNABLE_TO_LOAD_FILE;
+        status = stb_load(pStream, MipSetIn);
+    }
+    else
+    {
+        SetTopMipLevelData(CMips, MipSetIn);
+    }
+    return status;
+}
+
+// Saves to a stream that can seek, the stream is not closed
+static CMP_ERROR SaveTextureToStream(CMP_Stream* pStream, const char* pszFormat, CMP_MipSet* MipSetIn)
+{
+    CMP_RegisterHostPlugins();
+
+    bool  filesaved = false;
+    CMIPS m_CMIPS;
+
+    std::string format = FormatName(pszFormat);
+
+    PluginInterface_Image* plugin_Image;
+    plugin_Image = reinterpret_cast<PluginInterface_Image*>(g_pluginManager.GetPlugin("IMAGE", (char*)format.c_str()));
+
+    if (plugin_Image)
+    {
+        if (PluginHasStreams(plugin_Image))
+        {
+            bool holdswizzle = MipSetIn->m_swizzle;
+
+            plugin_Image->TC_PluginSetSharedIO(&m_CMIPS);
+            if (plugin_Image->TC_PluginStreamSaveTexture(pStream, (MipSet*)MipSetIn) == 0)
+            {
+                filesaved = true;
+            }
+
+            MipSetIn->m_swizzle = holdswizzle;
+        }
+
+        delete plugin_Image;
+        plugin_Image = NULL;
+    }
+
+    if (!filesaved)
+    {
+        int written;
+        if (format.compare("PNG") == 0)
+            written = stbi_write_png_to_func(
+                stb_stream_write, pStream, MipSetIn->m_nWidth, MipSetIn->m_nHeight, 4, MipSetIn->pData, MipSetIn->m_nWidth * 4);
+        else if (format.compare("BMP") == 0)
+            written = stbi_write_bmp_to_func(stb_stream_write, pStream, MipSetIn->m_nWidth, MipSetIn->m_nHeight, 4, MipSetIn->pData);
+        else if (format.compare("JPG") == 0)
+            written = stbi_write_jpg_to_func(stb_stream_write, pStream, MipSetIn->m_nWidth, MipSetIn->m_nHeight, 4, MipSetIn->pData, 100);
+        else
+            return CMP_ERR_GENERIC;
+
+        if (!written)
+            return CMP_ERR_GENERIC;
+    }
+
+    return CMP_OK;
+}
+
+CMP_ERROR CMP_API CMP_LoadTextureFromStream(const CMP_Stream* pStream, const char* pszFormat, CMP_MipSet* MipSetIn)
+{
+    if (!pStream || (pStream->dwSize != sizeof(CMP_Stream)) || !pStream->pRead || !MipSetIn)
+        return CMP_ERR_GENERIC;
+
+    // The plugins never close the caller's stream, that is done once here whatever the outcome
+    CMP_Stream stream = *pStream;
+    stream.pClose     = NULL;
+
+    CMP_ERROR status;
+    if (stream.pSeek && stream.pTell)
+    {
+        status = LoadTextureFromStream(&stream, pszFormat, MipSetIn);
+    }
+    else
+    {
+        // Loaders seek around the data, so a stream that cannot is read into memory first
+        std::vector<CMP_BYTE> data;
+        CMP_StreamReadAll(&stream, data);
+
+        CMP_MemoryStream memory(data.data(), data.size());
+        status = LoadTextureFromStream(memory.GetStream(), pszFormat, MipSetIn);
+    }
+
+    if (pStream->pClose)
+        pStream->pClose(pStream->pUser);
+
+    return status;
+}
+
+// Saves to the caller's stream, which is not closed
+static CMP_ERROR SaveTextureToCallerStream(const CMP_Stream* pStream, const char* pszFormat, CMP_MipSet* MipSetIn)
+{
+    CMP_Stream stream = *pStream;
+    stream.pClose     = NULL;
+
+    CMP_ERROR status;
+    if (stream.pSeek && stream.pTell)
+    {
+        status = SaveTextureToStream(&stream, pszFormat, MipSetIn);
+    }
+    else
+    {
+        // Savers go back to patch headers, so a stream that cannot seek gets the whole file in one write at the end
+        CMP_MemoryStream memory;
+        status = SaveTextureToStream(memory.GetStream(), pszFormat, MipSetIn);
+        if ((status == CMP_OK) && memory.GetSize() && (CMP_StreamWrite(&stream, memory.GetData(), memory.GetSize(), 1) != 1))
+            status = CMP_ERR_GENERIC;
+    }
+
+    return status;
+}
+
+CMP_ERROR CMP_API CMP_SaveTextureToStream(const CMP_Stream* pStream, const char* pszFormat, CMP_MipSet* MipSetIn)
+{
+    if (!pStream || (pStream->dwSize != sizeof(CMP_Stream)) || !pStream->pWrite || !pszFormat || !MipSetIn)
+        return CMP_ERR_GENERIC;
+
+    CMP_ERROR status = SaveTextureToCallerStream(pStream, pszFormat, MipSetIn);
+
+    if (pStream->pClose)
+        pStream->pClose(pStream->pUser);
+
+    return status;
+}
+
+CMP_ERROR CMP_API CMP_SaveTextureHeaderToStream(const CMP_Stream* pStream, const char* pszFormat, const CMP_Texture* pTexture)
+{
+    if (!pStream || (pStream->dwSize != sizeof(CMP_Stream)) || !pStream->pWrite || !pszFormat || !pTexture || (pTexture->dwSize != sizeof(CMP_Texture)))
+        return CMP_ERR_GENERIC;
+
+    // These savers write nothing for a level without data, which leaves the header
+    std::string format = FormatName(pszFormat);
+    if ((format.compare("DDS") != 0) && (format.compare("KTX2") != 0))
+        return CMP_ERR_GENERIC;
+    if (!CMP_IsCompressedFormat(pTexture->format) || !pTexture->dwWidth || !pTexture->dwHeight)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    CMP_CMIPS  CMips;
+    CMP_MipSet mipSet;
+    memset(&mipSet, 0, sizeof(mipSet));
+    mipSet.m_Flags        = MS_FLAG_Default;
+    mipSet.m_format       = pTexture->format;
+    mipSet.m_nBlockWidth  = pTexture->nBlockWidth ? pTexture->nBlockWidth : 4;
+    mipSet.m_nBlockHeight = pTexture->nBlockHeight ? pTexture->nBlockHeight : 4;
+    mipSet.m_nBlockDepth  = pTexture->nBlockDepth ? pTexture->nBlockDepth : 1;
+    mipSet.m_nMipLevels   = 1;
+    CMP_Format2FourCC(pTexture->format, &mipSet);
+
+    if (!CMips.AllocateMipSet(&mipSet, CF_Compressed, TDT_ARGB, TT_2D, pTexture->dwWidth, pTexture->dwHeight, 1))
+        return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
+
+    CMP_MipLevel* pMipLevel   = CMips.GetMipLevel(&mipSet, 0);
+    pMipLevel->m_nWidth       = pTexture->dwWidth;
+    pMipLevel->m_nHeight      = pTexture->dwHeight;
+    pMipLevel->m_dwLinearSize = CMP_CalculateBufferSize(pTexture);
+    pMipLevel->m_pbData       = NULL;
+
+    mipSet.dwWidth    = pTexture->dwWidth;
+    mipSet.dwHeight   = pTexture->dwHeight;
+    mipSet.dwDataSize = pMipLevel->m_dwLinearSize;
+
+    CMP_ERROR status = SaveTextureToCallerStream(pStream, format.c_str(), &mipSet);
+    CMP_FreeMipSet(&mipSet);
+
+    return status;
+}
+
+CMP_ERROR CMP_API CMP_LoadTextureFromMemory(const void* pData, size_t size, const char* pszFormat, CMP_MipSet* MipSetIn)
+{
+    if (!pData || !MipSetIn)
+        return CMP_ERR_GENERIC;
+
+    CMP_MemoryStream memory(pData, size);
+    return LoadTextureFromStream(memory.GetStream(), pszFormat, MipSetIn);
+}
+
+CMP_ERROR CMP_API CMP_SaveTextureToMemory(const char* pszFormat, CMP_MipSet* MipSetIn, void** ppData, size_t* pSize)
+{
+    if (!pszFormat || !MipSetIn || !ppData || !pSize)
+        return CMP_ERR_GENERIC;
+
+    *ppData = NULL;
+    *pSize  = 0;
+
+    CMP_MemoryStream memory;
+    CMP_ERROR        status = SaveTextureToStream(memory.GetStream(), pszFormat, MipSetIn);
+    if (status == CMP_OK)
+        *ppData = memory.Detach(pSize);
+
+    return status;
+}
+
+CMP_VOID CMP_API CMP_FreeTextureMemory(void* pData)
+{
+    free(pData);
+}
+
 CMP_INT CMP_API CMP_NumberOfProcessors(void)
 {
 #ifndef _WIN32
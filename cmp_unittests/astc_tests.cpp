@@ -0,0 +1,134 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include "single_include/catch2/catch.hpp"
+
+#include "compressonator.h"
+
+#if (OPTION_BUILD_ASTC == 1)
+
+#include <thread>
+#include <vector>
+
+struct ASTCTestJob
+{
+    CMP_BYTE              blockWidth;
+    CMP_BYTE              blockHeight;
+    CMP_DWORD             numThreads;
+    std::vector<CMP_BYTE> source;
+    std::vector<CMP_BYTE> result;
+    CMP_ERROR             status;
+};
+
+static const CMP_DWORD ASTC_TEST_WIDTH  = 64;
+static const CMP_DWORD ASTC_TEST_HEIGHT = 48;
+
+static void FillASTCTestImage(std::vector<CMP_BYTE>& data, CMP_DWORD seed)
+{
+    data.resize(ASTC_TEST_WIDTH * ASTC_TEST_HEIGHT * 4);
+    for (CMP_DWORD y = 0; y < ASTC_TEST_HEIGHT; y++)
+    {
+        for (CMP_DWORD x = 0; x < ASTC_TEST_WIDTH; x++)
+        {
+            CMP_BYTE* pixel = &data[(y * ASTC_TEST_WIDTH + x) * 4];
+            pixel[0]        = (CMP_BYTE)(x * 4 + seed * 31);
+            pixel[1]        = (CMP_BYTE)(y * 5 + seed * 17);
+            pixel[2]        = (CMP_BYTE)(((x ^ y) * (seed + 3)) & 0xFF);
+            pixel[3]        = (CMP_BYTE)(255 - ((x + y) & 0x3F) * seed);
+        }
+    }
+}
+
+static void EncodeASTCTestJob(ASTCTestJob* job)
+{
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = ASTC_TEST_WIDTH;
+    srcTexture.dwHeight    = ASTC_TEST_HEIGHT;
+    srcTexture.dwPitch     = ASTC_TEST_WIDTH * 4;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+    srcTexture.dwDataSize  = (CMP_DWORD)job->source.size();
+    srcTexture.pData       = job->source.data();
+
+    CMP_Texture destTexture  = {};
+    destTexture.dwSize       = sizeof(destTexture);
+    destTexture.dwWidth      = ASTC_TEST_WIDTH;
+    destTexture.dwHeight     = ASTC_TEST_HEIGHT;
+    destTexture.format       = CMP_FORMAT_ASTC;
+    destTexture.nBlockWidth  = job->blockWidth;
+    destTexture.nBlockHeight = job->blockHeight;
+    destTexture.nBlockDepth  = 1;
+    destTexture.dwDataSize   = CMP_CalculateBufferSize(&destTexture);
+    job->result.assign(destTexture.dwDataSize, 0);
+    destTexture.pData = job->result.data();
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.fquality            = 0.05f;
+    options.dwnumThreads        = job->numThreads;
+
+    job->status = CMP_ConvertTexture(&srcTexture, &destTexture, &options, NULL);
+}
+
+TEST_CASE("ASTC Concurrent Encodes Match Sequential", "[ASTC]")
+{
+    const CMP_BYTE blockSizes[][2] = {{4, 4}, {6, 6}, {8, 8}, {5, 4}, {4, 4}, {8, 6}};
+    const size_t   numJobs         = sizeof(blockSizes) / sizeof(blockSizes[0]);
+    const int      numRounds       = 4;
+
+    std::vector<ASTCTestJob> expected(numJobs);
+    for (size_t i = 0; i < numJobs; i++)
+    {
+        expected[i].blockWidth  = blockSizes[i][0];
+        expected[i].blockHeight = blockSizes[i][1];
+        expected[i].numThreads  = 1;
+        FillASTCTestImage(expected[i].source, (CMP_DWORD)i);
+
+        EncodeASTCTestJob(&expected[i]);
+        REQUIRE(expected[i].status == CMP_OK);
+    }
+
+    // Each host thread runs its own codec, half of them also spread their blocks over the thread pool
+    for (int round = 0; round < numRounds; round++)
+    {
+        std::vector<ASTCTestJob> jobs(expected);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < numJobs; i++)
+        {
+            jobs[i].numThreads = (i & 1) ? 0 : 1;
+            jobs[i].result.clear();
+            threads.push_back(std::thread(EncodeASTCTestJob, &jobs[i]));
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (size_t i = 0; i < numJobs; i++)
+        {
+            REQUIRE(jobs[i].status == CMP_OK);
+            CHECK(jobs[i].result == expected[i].result);
+        }
+    }
+}
+
+#endif
@@ -21,9 +21,16 @@
 //
 //=====================================================================
 
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
 #include "single_include/catch2/catch.hpp"
 
 #include "compressonator.h"
+#include "benchmark_utils.h"
 
 static inline bool CheckFloatsEqual(float value1, float value2, float error = 0.02f)
 {
@@ -235,4 +242,106 @@ TEST_CASE("BC6H_SF Codec Tests", "[BC6H][BC6H_SF]")
     free(srcTexture.pData);
     free(compressedTexture.pData);
     free(decompressedTexture.pData);
-}
\ No newline at end of file
+}
+
+static void FillHDRTestImage(float* buffer, uint32_t width, uint32_t height)
+{
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            float* pixel = buffer + (y * width + x) * 4;
+            pixel[0]     = (float)x / width * 16.0f;
+            pixel[1]     = (float)y / height * 4.0f;
+            pixel[2]     = (float)((x * 7 + y * 13) % 64) / 8.0f;
+            pixel[3]     = 1.0f;
+        }
+    }
+}
+
+TEST_CASE("BC6H Multithreaded Matches Single Threaded", "[BC6H]")
+{
+    const uint32_t width  = 128;
+    const uint32_t height = 96;
+
+    CMP_Texture srcTexture = CreateRGBA32FTexture(width, height, true);
+    FillHDRTestImage((float*)srcTexture.pData, width, height);
+
+    CMP_Texture singleTexture   = CreateBC6HTexture(width, height, false, true);
+    CMP_Texture threadedTexture = CreateBC6HTexture(width, height, false, true);
+
+    CMP_CompressOptions options = DefaultTestCompressOptions();
+    REQUIRE(CMP_ConvertTexture(&srcTexture, &singleTexture, &options, 0) == CMP_OK);
+
+    options.dwnumThreads = 4;
+    REQUIRE(CMP_ConvertTexture(&srcTexture, &threadedTexture, &options, 0) == CMP_OK);
+
+    CHECK(memcmp(singleTexture.pData, threadedTexture.pData, singleTexture.dwDataSize) == 0);
+
+    free(srcTexture.pData);
+    free(singleTexture.pData);
+    free(threadedTexture.pData);
+}
+
+static bool AbortFeedback(CMP_FLOAT fProgress, CMP_DWORD_PTR pUser1, CMP_DWORD_PTR pUser2)
+{
+    (void)fProgress;
+    (void)pUser1;
+    (void)pUser2;
+    return true;
+}
+
+TEST_CASE("BC6H Multithreaded Abort", "[BC6H]")
+{
+    const uint32_t width  = 64;
+    const uint32_t height = 256;
+
+    CMP_Texture srcTexture        = CreateRGBA32FTexture(width, height, true);
+    CMP_Texture compressedTexture = CreateBC6HTexture(width, height, false, true);
+    FillHDRTestImage((float*)srcTexture.pData, width, height);
+
+    CMP_CompressOptions options = DefaultTestCompressOptions();
+    options.dwnumThreads        = 4;
+
+    CHECK(CMP_ConvertTexture(&srcTexture, &compressedTexture, &options, AbortFeedback) == CMP_ABORTED);
+
+    free(srcTexture.pData);
+    free(compressedTexture.pData);
+}
+
+TEST_CASE("BC6H Encode CPU Time", "[.][BENCHMARK]")
+{
+    const uint32_t width     = 256;
+    const uint32_t height    = 256;
+    const uint32_t numImages = 4;
+    const double   megapixel = (double)width * height * numImages / 1e6;
+
+    CMP_Texture srcTexture        = CreateRGBA32FTexture(width, height, true);
+    CMP_Texture compressedTexture = CreateBC6HTexture(width, height, false, true);
+    FillHDRTestImage((float*)srcTexture.pData, width, height);
+
+    CMP_CompressOptions options = DefaultTestCompressOptions();
+    options.dwnumThreads        = 4;
+
+    BenchmarkTimer timer;
+    for (uint32_t i = 0; i < numImages; ++i)
+        REQUIRE(CMP_ConvertTexture(&srcTexture, &compressedTexture, &options, 0) == CMP_OK);
+    double cpuSeconds  = timer.CPUSeconds();
+    double wallSeconds = timer.WallSeconds();
+
+    // CPU used by the encoder threads while there is no work to do
+    timer.Restart();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    double idleCPUSeconds = timer.CPUSeconds();
+
+    printf("BC6H %ux%u x%u: %.3f CPU s/MP, %.3f wall s/MP, %.3f CPU s idle for 0.25 s\n",
+           width,
+           height,
+           numImages,
+           cpuSeconds / megapixel,
+           wallSeconds / megapixel,
+           idleCPUSeconds);
+
+    free(srcTexture.pData);
+    free(compressedTexture.pData);
+}
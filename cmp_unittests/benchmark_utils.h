@@ -0,0 +1,89 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+// Helpers for the benchmark test cases. Benchmarks are tagged [.][BENCHMARK] so they are
+// hidden from a normal test run, use: cmp_unittests "[BENCHMARK]"
+
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <chrono>
+#include <ctime>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Process CPU time in seconds, summed over all threads
+static inline double BenchmarkCPUTime()
+{
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return 0.0;
+
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart  = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart    = userTime.dwLowDateTime;
+    user.HighPart   = userTime.dwHighDateTime;
+    return (double)(kernel.QuadPart + user.QuadPart) * 1e-7;
+#else
+    return (double)std::clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+// Wall clock time in seconds
+static inline double BenchmarkWallTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct BenchmarkTimer
+{
+    double cpuStart;
+    double wallStart;
+
+    BenchmarkTimer()
+    {
+        Restart();
+    }
+
+    void Restart()
+    {
+        cpuStart  = BenchmarkCPUTime();
+        wallStart = BenchmarkWallTime();
+    }
+
+    double CPUSeconds() const
+    {
+        return BenchmarkCPUTime() - cpuStart;
+    }
+
+    double WallSeconds() const
+    {
+        return BenchmarkWallTime() - wallStart;
+    }
+};
+
+#endif
@@ -33,6 +33,15 @@
 #include "codec_etc2_rgb.h"
 #include "codec_etc2_rgba.h"
 #include "codec_etc2_rgba1.h"
+#include "bc7/bc7_decode.h"
+#include "cmp_core.h"
+#include "common_def.h"
+#include "compressonator.h"
+#include "test_constants.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
 
 // The test data is filled completely with yellow pixels. This was done so that there would be a difference between the red and blue channels which is
 // important to test that no unexpected swizzling is happening
@@ -586,4 +595,175 @@ TEST_CASE("ETC2_RGBA Codec Decoding", "[CODEC][ETC2]")
     delete srcBuffer;
     delete destBuffer;
     delete codec;
-}
\ No newline at end of file
+}
+
+// Compresses an RGBA 8888 image to BC7 and back, returning the PSNR of the round trip
+static double BC7RoundTripPSNR(const CMP_BYTE* pixels, CMP_DWORD width, CMP_DWORD height, CMP_FLOAT quality, CMP_BOOL useFloat)
+{
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = width;
+    srcTexture.dwHeight    = height;
+    srcTexture.dwPitch     = width * 4;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+    srcTexture.dwDataSize  = CMP_CalculateBufferSize(&srcTexture);
+    srcTexture.pData       = (CMP_BYTE*)pixels;
+
+    CMP_Texture cmpTexture = {};
+    cmpTexture.dwSize      = sizeof(cmpTexture);
+    cmpTexture.dwWidth     = width;
+    cmpTexture.dwHeight    = height;
+    cmpTexture.format      = CMP_FORMAT_BC7;
+    cmpTexture.dwDataSize  = CMP_CalculateBufferSize(&cmpTexture);
+    std::vector<CMP_BYTE> cmpData(cmpTexture.dwDataSize);
+    cmpTexture.pData = cmpData.data();
+
+    CMP_Texture dstTexture = srcTexture;
+    std::vector<CMP_BYTE> dstData(srcTexture.dwDataSize);
+    dstTexture.pData = dstData.data();
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.fquality            = quality;
+    options.bUseFloatBC7        = useFloat;
+
+    REQUIRE(CMP_ConvertTexture(&srcTexture, &cmpTexture, &options, NULL) == CMP_OK);
+    REQUIRE(CMP_ConvertTexture(&cmpTexture, &dstTexture, &options, NULL) == CMP_OK);
+
+    double sumSquares = 0.0;
+    for (CMP_DWORD i = 0; i < srcTexture.dwDataSize; i++)
+    {
+        double diff = (double)pixels[i] - (double)dstData[i];
+        sumSquares += diff * diff;
+    }
+
+    double mse = sumSquares / srcTexture.dwDataSize;
+    return (mse > 0.0) ? 10.0 * log10(255.0 * 255.0 / mse) : 100.0;
+}
+
+static void CheckBC7FloatEncoderQuality(const CMP_BYTE* pixels, CMP_DWORD width, CMP_DWORD height)
+{
+    for (CMP_FLOAT quality : {0.05f, 0.5f})
+    {
+        double psnrDouble = BC7RoundTripPSNR(pixels, width, height, quality, false);
+        double psnrFloat  = BC7RoundTripPSNR(pixels, width, height, quality, true);
+
+        INFO("quality " << quality << " double PSNR " << psnrDouble << " float PSNR " << psnrFloat);
+        CHECK(psnrFloat > 30.0);
+        CHECK(psnrFloat >= psnrDouble - 1.0);
+    }
+}
+
+TEST_CASE("BC7 Float Encoder Quality Matches Double Encoder", "[CODEC][BC7]")
+{
+    // Smooth gradients with a little noise, and a hard edged alpha so blocks with and without alpha are both encoded
+    const CMP_DWORD       width  = 64;
+    const CMP_DWORD       height = 48;
+    std::vector<CMP_BYTE> pixels(width * height * 4);
+    CMP_DWORD             seed = 1;
+    for (CMP_DWORD y = 0; y < height; y++)
+    {
+        for (CMP_DWORD x = 0; x < width; x++)
+        {
+            seed              = seed * 1103515245 + 12345;
+            CMP_BYTE  noise   = (CMP_BYTE)((seed >> 16) & 7);
+            CMP_BYTE* pixel   = &pixels[(y * width + x) * 4];
+            pixel[0]          = (CMP_BYTE)(x * 4 + noise);
+            pixel[1]          = (CMP_BYTE)(y * 5 + noise);
+            pixel[2]          = (CMP_BYTE)(128 + ((x * y) & 63));
+            pixel[3]          = (x < width / 2) ? 255 : (CMP_BYTE)(y * 5);
+        }
+    }
+
+    SECTION("Generated image")
+    {
+        CheckBC7FloatEncoderQuality(pixels.data(), width, height);
+    }
+
+    SECTION("Test data images")
+    {
+        const char* images[] = {"/ruby.bmp", "/mipmap_128x128.png"};
+        for (const char* image : images)
+        {
+            const std::string path    = TEST_DATA_PATH + std::string(image);
+            CMP_MipSet        texture = {};
+            if (CMP_LoadTexture(path.c_str(), &texture) != CMP_OK)
+            {
+                WARN("Skipping " << path << ", it could not be loaded");
+                continue;
+            }
+
+            if (texture.m_format == CMP_FORMAT_RGBA_8888)
+                CheckBC7FloatEncoderQuality(texture.pData, texture.dwWidth, texture.dwHeight);
+            CMP_FreeMipSet(&texture);
+        }
+    }
+}
+
+// Decodes a BC7 block with BC7BlockDecoder, converting to bytes the way CCodec_BC7::Decompress did before it used cmp_core
+static void DecodeBC7WithBlockDecoder(BC7BlockDecoder& decoder, const CMP_BYTE block[16], CMP_BYTE pixels[64])
+{
+    double   decoded[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG];
+    CMP_BYTE in[16];
+    memcpy(in, block, 16);
+    decoder.DecompressBlock(decoded, in);
+    for (int i = 0; i < 16; i++)
+    {
+        pixels[i * 4]     = (CMP_BYTE)decoded[i][BC_COMP_RED];
+        pixels[i * 4 + 1] = (CMP_BYTE)decoded[i][BC_COMP_GREEN];
+        pixels[i * 4 + 2] = (CMP_BYTE)decoded[i][BC_COMP_BLUE];
+        pixels[i * 4 + 3] = (CMP_BYTE)decoded[i][BC_COMP_ALPHA];
+    }
+}
+
+TEST_CASE("BC7 Core Decoder Matches Block Decoder", "[CODEC][BC7]")
+{
+    // Bits that follow the mode bits: partition for modes 0-3 and 7, rotation and index selector for modes 4 and 5
+    const CMP_DWORD modeFieldBits[8] = {4, 6, 6, 6, 3, 2, 0, 6};
+    const CMP_DWORD blocksPerField   = 8;
+
+    BC7BlockDecoder decoder;
+    CMP_DWORD       seed = 7;
+    for (CMP_DWORD mode = 0; mode < 8; mode++)
+    {
+        const CMP_DWORD numFields = 1u << modeFieldBits[mode];
+        std::vector<CMP_BYTE> blocks(numFields * blocksPerField * 16);
+        for (CMP_DWORD field = 0; field < numFields; field++)
+        {
+            for (CMP_DWORD n = 0; n < blocksPerField; n++)
+            {
+                CMP_BYTE* block = &blocks[(field * blocksPerField + n) * 16];
+                for (int i = 0; i < 16; i++)
+                {
+                    seed     = seed * 1103515245 + 12345;
+                    block[i] = (CMP_BYTE)(seed >> 16);
+                }
+
+                // The lowest set bit selects the mode, the mode field follows it
+                CMP_DWORD low = (CMP_DWORD)block[0] | ((CMP_DWORD)block[1] << 8);
+                low &= ~((1u << (mode + 1 + modeFieldBits[mode])) - 1);
+                low |= (1u << mode) | (field << (mode + 1));
+                block[0] = (CMP_BYTE)low;
+                block[1] = (CMP_BYTE)(low >> 8);
+            }
+        }
+
+        // Every block of the mode in one row, decoded the way CCodec_BC7::Decompress does for RGBA:8888 buffers
+        const CMP_DWORD       numBlocks = numFields * blocksPerField;
+        std::vector<CMP_BYTE> corePixels(numBlocks * 64);
+        REQUIRE(DecompressBlocksBC7(blocks.data(), numBlocks * 16, numBlocks, 1, corePixels.data(), numBlocks * 16) == CGU_CORE_OK);
+
+        for (CMP_DWORD b = 0; b < numBlocks; b++)
+        {
+            CMP_BYTE pixels[64];
+            DecodeBC7WithBlockDecoder(decoder, &blocks[b * 16], pixels);
+
+            bool same = true;
+            for (int row = 0; row < 4; row++)
+                same = same && (memcmp(&pixels[row * 16], &corePixels[row * numBlocks * 16 + b * 16], 16) == 0);
+
+            INFO("mode " << mode << " field " << (b / blocksPerField));
+            REQUIRE(same);
+        }
+    }
+}
@@ -21,7 +21,9 @@
 //
 //=====================================================================
 
+#include <cmath>
 #include <string>
+#include <vector>
 
 #include "single_include/catch2/catch.hpp"
 
@@ -30,6 +32,14 @@
 #include "common_def.h"
 #include "cmp_core.h"
 #include "cpu_timing.h"
+#include "benchmark_utils.h"
+#include "etcpack_lib.h"
+
+// from etcpack.cxx and etcdec.cxx, not declared in etcpack_lib.h
+void compressBlockAlphaFast(uint8* data, int ix, int iy, int width, int height, uint8* returnData);
+void compressBlockAlphaSlow(uint8* data, int ix, int iy, int width, int height, uint8* returnData);
+void compressBlockETC1ExhaustivePerceptual(uint8* img, uint8* imgdec, int width, int height, int startx, int starty, unsigned int& compressed1, unsigned int& compressed2);
+void decompressBlockAlpha(uint8* data, uint8* img, int width, int height, int ix, int iy);
 
 TEST_CASE("Enabling_SIMD", "[SIMD]")
 {
@@ -250,3 +260,1214 @@ TEST_CASE("BC1_Compression", "[SIMD]")
 
     printf("\n");
 }
+
+// Converts a positive float to a half float, truncating the mantissa and clamping to the largest finite half
+static unsigned short FloatToHalfBits(float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    int          exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+    unsigned int mantissa = (bits >> 13) & 0x3FF;
+
+    if (exponent <= 0)
+        return 0;
+    if (exponent >= 31)
+        return 0x7BFF;
+
+    return (unsigned short)((exponent << 10) | mantissa);
+}
+
+// RGB half float test image with HDR gradients above 1.0 and noise
+static std::vector<unsigned short> CreateBC6TestImage(unsigned int width, unsigned int height)
+{
+    std::vector<unsigned short> image(width * height * 3);
+    unsigned int                seed = 1;
+
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            for (unsigned int ch = 0; ch < 3; ++ch)
+            {
+                seed = seed * 1103515245 + 12345;
+
+                float ramp  = expf(((x + y / 2 + ch * 20) % 97) / 20.0f - 2.0f);
+                float noise = 1.0f + ((seed >> 16) & 63) / 200.0f;
+
+                image[(y * width + x) * 3 + ch] = FloatToHalfBits(ramp * noise);
+            }
+        }
+    }
+
+    return image;
+}
+
+TEST_CASE("BC6H_Compression", "[SIMD]")
+{
+    const unsigned int width   = 32;
+    const unsigned int height  = 32;
+    const unsigned int blocksX = width / 4;
+    const unsigned int blocksY = height / 4;
+
+    std::vector<unsigned short> image = CreateBC6TestImage(width, height);
+
+    std::vector<unsigned char> referenceData(blocksX * blocksY * 16);
+    std::vector<unsigned char> compressedData(blocksX * blocksY * 16);
+
+    // the SIMD endpoint search runs at the highest quality setting
+    const float qualities[] = {0.05f, 1.0f};
+
+    for (float quality : qualities)
+    {
+        void* options = NULL;
+        REQUIRE(CreateOptionsBC6(&options) == CGU_CORE_OK);
+        REQUIRE(SetQualityBC6(options, quality) == CGU_CORE_OK);
+
+        DisableSIMD();
+        REQUIRE(CompressBlocksBC6(image.data(), width * 3, blocksX, blocksY, referenceData.data(), blocksX * 16, options) == CGU_CORE_OK);
+
+        // The SIMD endpoint search must produce the same blocks as the scalar encoder
+        if (EnableSSE4() == CGU_CORE_OK)
+        {
+            REQUIRE(CompressBlocksBC6(image.data(), width * 3, blocksX, blocksY, compressedData.data(), blocksX * 16, options) == CGU_CORE_OK);
+            CHECK(memcmp(referenceData.data(), compressedData.data(), referenceData.size()) == 0);
+        }
+        else
+            WARN("Skipping SSE4 BC6H test because it is not supported on the current CPU.");
+
+        if (EnableAVX2() == CGU_CORE_OK)
+        {
+            REQUIRE(CompressBlocksBC6(image.data(), width * 3, blocksX, blocksY, compressedData.data(), blocksX * 16, options) == CGU_CORE_OK);
+            CHECK(memcmp(referenceData.data(), compressedData.data(), referenceData.size()) == 0);
+        }
+        else
+            WARN("Skipping AVX2 BC6H test because it is not supported on the current CPU.");
+
+        if (EnableAVX512() == CGU_CORE_OK)
+        {
+            REQUIRE(CompressBlocksBC6(image.data(), width * 3, blocksX, blocksY, compressedData.data(), blocksX * 16, options) == CGU_CORE_OK);
+            CHECK(memcmp(referenceData.data(), compressedData.data(), referenceData.size()) == 0);
+        }
+        else
+            WARN("Skipping AVX-512 BC6H test because it is not supported on the current CPU.");
+
+        DestroyOptionsBC6(options);
+    }
+
+    DisableSIMD();
+}
+
+static void BenchmarkBC6Throughput(const char* name, const std::vector<unsigned short>& image, unsigned int width, unsigned int height, void* options)
+{
+    std::vector<unsigned char> compressedData(width / 4 * height / 4 * 16);
+
+    BenchmarkTimer timer;
+    CompressBlocksBC6(image.data(), width * 3, width / 4, height / 4, compressedData.data(), width / 4 * 16, options);
+    double seconds = timer.WallSeconds();
+
+    printf("  %-8s %8.3f s  %6.3f MPixels/s\n", name, seconds, (width * height) / (seconds * 1000000.0));
+}
+
+TEST_CASE("BC6H_SIMD_Throughput", "[.][BENCHMARK]")
+{
+    const unsigned int width  = 128;
+    const unsigned int height = 128;
+
+    std::vector<unsigned short> image = CreateBC6TestImage(width, height);
+
+    const float qualities[] = {0.05f, 0.5f, 1.0f};
+
+    for (float quality : qualities)
+    {
+        void* options = NULL;
+        REQUIRE(CreateOptionsBC6(&options) == CGU_CORE_OK);
+        SetQualityBC6(options, quality);
+
+        printf("BC6H %ux%u quality %.2f, single thread\n", width, height, quality);
+
+        DisableSIMD();
+        BenchmarkBC6Throughput("Scalar", image, width, height, options);
+
+        if (EnableSSE4() == CGU_CORE_OK)
+            BenchmarkBC6Throughput("SSE4", image, width, height, options);
+        else
+            printf("  SSE4     not supported\n");
+
+        if (EnableAVX2() == CGU_CORE_OK)
+            BenchmarkBC6Throughput("AVX2", image, width, height, options);
+        else
+            printf("  AVX2     not supported\n");
+
+        if (EnableAVX512() == CGU_CORE_OK)
+            BenchmarkBC6Throughput("AVX-512", image, width, height, options);
+        else
+            printf("  AVX-512  not supported\n");
+
+        DestroyOptionsBC6(options);
+    }
+
+    DisableSIMD();
+}
+
+// Single channel test image with gradients, hard edges and noise, like a roughness or one half of a normal map
+static std::vector<unsigned char> CreateBC4TestImage(unsigned int width, unsigned int height, unsigned int seed)
+{
+    std::vector<unsigned char> image(width * height);
+
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            seed = seed * 1103515245 + 12345;
+
+            unsigned int noise = (seed >> 16) & 0xFF;
+            unsigned int tile  = (x / 16 + y / 16) % 4;
+            unsigned int value;
+
+            if (tile == 0)
+                value = (x * 4 + y * 2) & 0xFF;
+            else if (tile == 1)
+                value = ((x % 4) < 2) ? 40 : 220;
+            else if (tile == 2)
+                value = noise;
+            else
+                value = 96 + (noise & 0x1F);
+
+            image[y * width + x] = (unsigned char)value;
+        }
+    }
+
+    return image;
+}
+
+TEST_CASE("BC4_BC5_Compression", "[SIMD]")
+{
+    const unsigned int width   = 64;
+    const unsigned int height  = 64;
+    const unsigned int blocksX = width / 4;
+    const unsigned int blocksY = height / 4;
+
+    std::vector<unsigned char> red   = CreateBC4TestImage(width, height, 1);
+    std::vector<unsigned char> green = CreateBC4TestImage(width, height, 7);
+
+    std::vector<unsigned char> referenceBC4(blocksX * blocksY * 8);
+    std::vector<unsigned char> compressedBC4(blocksX * blocksY * 8);
+    std::vector<unsigned char> referenceBC5(blocksX * blocksY * 16);
+    std::vector<unsigned char> compressedBC5(blocksX * blocksY * 16);
+
+    // the SIMD endpoint search only runs at the high quality settings
+    const float qualities[] = {0.5f, 1.0f};
+
+    for (float quality : qualities)
+    {
+        void* optionsBC4 = NULL;
+        void* optionsBC5 = NULL;
+        REQUIRE(CreateOptionsBC4(&optionsBC4) == CGU_CORE_OK);
+        REQUIRE(CreateOptionsBC5(&optionsBC5) == CGU_CORE_OK);
+        REQUIRE(SetQualityBC4(optionsBC4, quality) == CGU_CORE_OK);
+        REQUIRE(SetQualityBC5(optionsBC5, quality) == CGU_CORE_OK);
+
+        DisableSIMD();
+        REQUIRE(CompressBlocksBC4(red.data(), width, blocksX, blocksY, referenceBC4.data(), blocksX * 8, optionsBC4) == CGU_CORE_OK);
+        REQUIRE(CompressBlocksBC5(red.data(), width, green.data(), width, blocksX, blocksY, referenceBC5.data(), blocksX * 16, optionsBC5) ==
+                CGU_CORE_OK);
+
+        // The SIMD endpoint search must produce the same blocks as the scalar encoder
+        if (EnableSSE4() == CGU_CORE_OK)
+        {
+            REQUIRE(CompressBlocksBC4(red.data(), width, blocksX, blocksY, compressedBC4.data(), blocksX * 8, optionsBC4) == CGU_CORE_OK);
+            CHECK(memcmp(referenceBC4.data(), compressedBC4.data(), referenceBC4.size()) == 0);
+
+            REQUIRE(CompressBlocksBC5(red.data(), width, green.data(), width, blocksX, blocksY, compressedBC5.data(), blocksX * 16, optionsBC5) ==
+                    CGU_CORE_OK);
+            CHECK(memcmp(referenceBC5.data(), compressedBC5.data(), referenceBC5.size()) == 0);
+        }
+        else
+            WARN("Skipping SSE4 BC4/BC5 test because it is not supported on the current CPU.");
+
+        if (EnableAVX2() == CGU_CORE_OK)
+        {
+            REQUIRE(CompressBlocksBC4(red.data(), width, blocksX, blocksY, compressedBC4.data(), blocksX * 8, optionsBC4) == CGU_CORE_OK);
+            CHECK(memcmp(referenceBC4.data(), compressedBC4.data(), referenceBC4.size()) == 0);
+
+            REQUIRE(CompressBlocksBC5(red.data(), width, green.data(), width, blocksX, blocksY, compressedBC5.data(), blocksX * 16, optionsBC5) ==
+                    CGU_CORE_OK);
+            CHECK(memcmp(referenceBC5.data(), compressedBC5.data(), referenceBC5.size()) == 0);
+        }
+        else
+            WARN("Skipping AVX2 BC4/BC5 test because it is not supported on the current CPU.");
+
+        if (EnableAVX512() == CGU_CORE_OK)
+        {
+            REQUIRE(CompressBlocksBC4(red.data(), width, blocksX, blocksY, compressedBC4.data(), blocksX * 8, optionsBC4) == CGU_CORE_OK);
+            CHECK(memcmp(referenceBC4.data(), compressedBC4.data(), referenceBC4.size()) == 0);
+
+            REQUIRE(CompressBlocksBC5(red.data(), width, green.data(), width, blocksX, blocksY, compressedBC5.data(), blocksX * 16, optionsBC5) ==
+                    CGU_CORE_OK);
+            CHECK(memcmp(referenceBC5.data(), compressedBC5.data(), referenceBC5.size()) == 0);
+        }
+        else
+            WARN("Skipping AVX-512 BC4/BC5 test because it is not supported on the current CPU.");
+
+        DestroyOptionsBC4(optionsBC4);
+        DestroyOptionsBC5(optionsBC5);
+    }
+
+    DisableSIMD();
+}
+
+static void BenchmarkBC5Throughput(const char*                       name,
+                                   const std::vector<unsigned char>& red,
+                                   const std::vector<unsigned char>& green,
+                                   unsigned int                      width,
+                                   unsigned int                      height,
+                                   void*                             options)
+{
+    std::vector<unsigned char> compressedData(width / 4 * height / 4 * 16);
+
+    BenchmarkTimer timer;
+    CompressBlocksBC5(red.data(), width, green.data(), width, width / 4, height / 4, compressedData.data(), width / 4 * 16, options);
+    double seconds = timer.WallSeconds();
+
+    printf("  %-8s %8.3f s  %6.3f MPixels/s\n", name, seconds, (width * height) / (seconds * 1000000.0));
+}
+
+TEST_CASE("BC5_SIMD_Throughput", "[.][BENCHMARK]")
+{
+    const unsigned int width  = 1024;
+    const unsigned int height = 1024;
+
+    std::vector<unsigned char> red   = CreateBC4TestImage(width, height, 1);
+    std::vector<unsigned char> green = CreateBC4TestImage(width, height, 7);
+
+    const float qualities[] = {0.5f, 1.0f};
+
+    for (float quality : qualities)
+    {
+        void* options = NULL;
+        REQUIRE(CreateOptionsBC5(&options) == CGU_CORE_OK);
+        SetQualityBC5(options, quality);
+
+        printf("BC5 %ux%u quality %.2f, single thread\n", width, height, quality);
+
+        DisableSIMD();
+        BenchmarkBC5Throughput("Scalar", red, green, width, height, options);
+
+        if (EnableSSE4() == CGU_CORE_OK)
+            BenchmarkBC5Throughput("SSE4", red, green, width, height, options);
+        else
+            printf("  SSE4     not supported\n");
+
+        if (EnableAVX2() == CGU_CORE_OK)
+            BenchmarkBC5Throughput("AVX2", red, green, width, height, options);
+        else
+            printf("  AVX2     not supported\n");
+
+        if (EnableAVX512() == CGU_CORE_OK)
+            BenchmarkBC5Throughput("AVX-512", red, green, width, height, options);
+        else
+            printf("  AVX-512  not supported\n");
+
+        DestroyOptionsBC5(options);
+    }
+
+    DisableSIMD();
+}
+
+// RGBA8 test image with gradients, hard edges, noise and varying alpha so every BC7 mode gets used
+static std::vector<unsigned char> CreateBC7TestImage(unsigned int width, unsigned int height)
+{
+    std::vector<unsigned char> image(width * height * 4);
+    unsigned int               seed = 1;
+
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            unsigned char* pixel = &image[(y * width + x) * 4];
+            unsigned int   tile  = (x / 16 + y / 16) % 4;
+
+            for (unsigned int ch = 0; ch < 4; ++ch)
+            {
+                seed = seed * 1103515245 + 12345;
+
+                unsigned int noise = (seed >> 16) & 0xFF;
+                unsigned int value;
+
+                if (tile == 0)
+                    value = (x * 4 + y * 2 + ch * 60) & 0xFF;
+                else if (tile == 1)
+                    value = ((x % 4) < 2) ? 40 + ch * 30 : 220 - ch * 20;
+                else if (tile == 2)
+                    value = noise;
+                else
+                    value = ((x * 3 + y * 5 + ch * 40) & 0xFF) / 2 + (noise & 0x1F);
+
+                if (ch == 3 && tile != 3)
+                    value = (tile == 1) ? 255 : 128 + (x & 0x7F);
+
+                pixel[ch] = (unsigned char)value;
+            }
+        }
+    }
+
+    return image;
+}
+
+TEST_CASE("BC7_Compression", "[SIMD]")
+{
+    const unsigned int width   = 64;
+    const unsigned int height  = 64;
+    const unsigned int blocksX = width / 4;
+    const unsigned int blocksY = height / 4;
+
+    std::vector<unsigned char> image = CreateBC7TestImage(width, height);
+
+    std::vector<unsigned char> referenceData(blocksX * blocksY * 16);
+    std::vector<unsigned char> compressedData(blocksX * blocksY * 16);
+
+    const float qualities[] = {0.05f, 0.5f};
+
+    for (float quality : qualities)
+    {
+        void* options = NULL;
+        REQUIRE(CreateOptionsBC7(&options) == CGU_CORE_OK);
+        REQUIRE(SetQualityBC7(options, quality) == CGU_CORE_OK);
+
+        DisableSIMD();
+        REQUIRE(CompressBlocksBC7(image.data(), width * 4, blocksX, blocksY, referenceData.data(), blocksX * 16, options) == CGU_CORE_OK);
+
+        // The SIMD partition search must produce the same blocks as the scalar encoder
+        if (EnableAVX2() == CGU_CORE_OK)
+        {
+            REQUIRE(CompressBlocksBC7(image.data(), width * 4, blocksX, blocksY, compressedData.data(), blocksX * 16, options) == CGU_CORE_OK);
+            CHECK(memcmp(referenceData.data(), compressedData.data(), referenceData.size()) == 0);
+        }
+        else
+            WARN("Skipping AVX2 BC7 test because it is not supported on the current CPU.");
+
+        if (EnableAVX512() == CGU_CORE_OK)
+        {
+            REQUIRE(CompressBlocksBC7(image.data(), width * 4, blocksX, blocksY, compressedData.data(), blocksX * 16, options) == CGU_CORE_OK);
+            CHECK(memcmp(referenceData.data(), compressedData.data(), referenceData.size()) == 0);
+        }
+        else
+            WARN("Skipping AVX-512 BC7 test because it is not supported on the current CPU.");
+
+        DestroyOptionsBC7(options);
+    }
+}
+
+static void BenchmarkBC7Throughput(const char* name, const std::vector<unsigned char>& image, unsigned int width, unsigned int height, void* options)
+{
+    std::vector<unsigned char> compressedData(width / 4 * height / 4 * 16);
+
+    BenchmarkTimer timer;
+    CompressBlocksBC7(image.data(), width * 4, width / 4, height / 4, compressedData.data(), width / 4 * 16, options);
+    double seconds = timer.WallSeconds();
+
+    printf("  %-8s %8.3f s  %6.3f MPixels/s\n", name, seconds, (width * height) / (seconds * 1000000.0));
+}
+
+TEST_CASE("BC7_SIMD_Throughput", "[.][BENCHMARK]")
+{
+    const unsigned int width  = 512;
+    const unsigned int height = 512;
+
+    std::vector<unsigned char> image = CreateBC7TestImage(width, height);
+
+    const float qualities[] = {0.05f, 0.2f, 0.5f};
+
+    for (float quality : qualities)
+    {
+        void* options = NULL;
+        REQUIRE(CreateOptionsBC7(&options) == CGU_CORE_OK);
+        SetQualityBC7(options, quality);
+
+        printf("BC7 %ux%u quality %.2f, single thread\n", width, height, quality);
+
+        DisableSIMD();
+        BenchmarkBC7Throughput("Scalar", image, width, height, options);
+
+        if (EnableAVX2() == CGU_CORE_OK)
+            BenchmarkBC7Throughput("AVX2", image, width, height, options);
+        else
+            printf("  AVX2     not supported\n");
+
+        if (EnableAVX512() == CGU_CORE_OK)
+            BenchmarkBC7Throughput("AVX-512", image, width, height, options);
+        else
+            printf("  AVX-512  not supported\n");
+
+        DestroyOptionsBC7(options);
+    }
+
+    DisableSIMD();
+}
+
+// RGBA image for the BC1 to BC3 encoders, every seventh block is a solid color with varying alpha
+static std::vector<unsigned char> CreateBC1TestImage(unsigned int width, unsigned int height)
+{
+    std::vector<unsigned char> image(width * height * 4);
+
+    for (unsigned int channel = 0; channel < 4; channel++)
+    {
+        std::vector<unsigned char> plane = CreateBC4TestImage(width, height, 3 + channel * 4);
+        for (unsigned int i = 0; i < width * height; i++)
+            image[i * 4 + channel] = plane[i];
+    }
+
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            if ((x / 4 + y / 4) % 7 == 0)
+            {
+                image[(y * width + x) * 4 + 0] = 200;
+                image[(y * width + x) * 4 + 1] = (unsigned char)(y / 4 * 40);
+                image[(y * width + x) * 4 + 2] = 90;
+            }
+        }
+    }
+
+    return image;
+}
+
+static int CompressTestBlocksBC1To3(unsigned int bcn, const std::vector<unsigned char>& image, unsigned int width, unsigned int height, void* options, std::vector<unsigned char>& cmpData)
+{
+    unsigned int blockBytes = bcn == 1 ? 8 : 16;
+
+    cmpData.assign(width / 4 * height / 4 * blockBytes, 0);
+
+    if (bcn == 1)
+        return CompressBlocksBC1(image.data(), width * 4, width / 4, height / 4, cmpData.data(), width / 4 * blockBytes, options);
+    if (bcn == 2)
+        return CompressBlocksBC2(image.data(), width * 4, width / 4, height / 4, cmpData.data(), width / 4 * blockBytes, options);
+    return CompressBlocksBC3(image.data(), width * 4, width / 4, height / 4, cmpData.data(), width / 4 * blockBytes, options);
+}
+
+static void* CreateTestOptionsBC1To3(unsigned int bcn, float quality, unsigned int steps)
+{
+    void* options = NULL;
+
+    if (bcn == 1)
+    {
+        CreateOptionsBC1(&options);
+        SetQualityBC1(options, quality);
+        SetRefineStepsBC1(options, steps);
+    }
+    else if (bcn == 2)
+    {
+        CreateOptionsBC2(&options);
+        SetQualityBC2(options, quality);
+    }
+    else
+    {
+        CreateOptionsBC3(&options);
+        SetQualityBC3(options, quality);
+    }
+
+    return options;
+}
+
+static void DestroyTestOptionsBC1To3(unsigned int bcn, void* options)
+{
+    if (bcn == 1)
+        DestroyOptionsBC1(options);
+    else if (bcn == 2)
+        DestroyOptionsBC2(options);
+    else
+        DestroyOptionsBC3(options);
+}
+
+TEST_CASE("BC1_BC3_Compression", "[SIMD]")
+{
+    // An odd number of blocks per row leaves a partial batch for the SIMD block encoders
+    const unsigned int width  = 148;
+    const unsigned int height = 20;
+
+    std::vector<unsigned char> image = CreateBC1TestImage(width, height);
+
+    std::vector<unsigned char> referenceData;
+    std::vector<unsigned char> compressedData;
+
+    // the SIMD block batches run up to CMP_QUALITY0 for BC1 and CMP_QUALITY1 for BC2 and BC3
+    const float qualities[] = {0.05f, 0.3f, 0.5f};
+
+    for (unsigned int bcn = 1; bcn <= 3; bcn++)
+    {
+        for (float quality : qualities)
+        {
+            for (unsigned int steps = 0; steps < 2; steps++)
+            {
+                // the refine steps are only used by the BC1 encoder
+                if (bcn != 1 && steps > 0)
+                    continue;
+
+                void* options = CreateTestOptionsBC1To3(bcn, quality, steps);
+                REQUIRE(options != NULL);
+
+                INFO("BC" << bcn << " quality " << quality << " refine steps " << steps);
+
+                DisableSIMD();
+                REQUIRE(CompressTestBlocksBC1To3(bcn, image, width, height, options, referenceData) == CGU_CORE_OK);
+
+                if (EnableSSE4() == CGU_CORE_OK)
+                {
+                    REQUIRE(CompressTestBlocksBC1To3(bcn, image, width, height, options, compressedData) == CGU_CORE_OK);
+                    CHECK(compressedData == referenceData);
+                }
+                else
+                    WARN("Skipping SSE4 BC1 to BC3 test because it is not supported on the current CPU.");
+
+                if (EnableAVX2() == CGU_CORE_OK)
+                {
+                    REQUIRE(CompressTestBlocksBC1To3(bcn, image, width, height, options, compressedData) == CGU_CORE_OK);
+                    CHECK(compressedData == referenceData);
+                }
+                else
+                    WARN("Skipping AVX2 BC1 to BC3 test because it is not supported on the current CPU.");
+
+                if (EnableAVX512() == CGU_CORE_OK)
+                {
+                    REQUIRE(CompressTestBlocksBC1To3(bcn, image, width, height, options, compressedData) == CGU_CORE_OK);
+                    CHECK(compressedData == referenceData);
+                }
+                else
+                    WARN("Skipping AVX-512 BC1 to BC3 test because it is not supported on the current CPU.");
+
+                DestroyTestOptionsBC1To3(bcn, options);
+            }
+        }
+    }
+
+    DisableSIMD();
+}
+
+static void BenchmarkBC1To3Throughput(const char* name, unsigned int bcn, const std::vector<unsigned char>& image, unsigned int width, unsigned int height, void* options)
+{
+    std::vector<unsigned char> compressedData;
+
+    BenchmarkTimer timer;
+    CompressTestBlocksBC1To3(bcn, image, width, height, options, compressedData);
+    double seconds = timer.WallSeconds();
+
+    printf("  %-8s %8.3f s  %8.3f MPixels/s\n", name, seconds, (width * height) / (seconds * 1000000.0));
+}
+
+TEST_CASE("BC1_BC3_SIMD_Throughput", "[.][BENCHMARK]")
+{
+    const unsigned int width  = 512;
+    const unsigned int height = 512;
+
+    std::vector<unsigned char> image = CreateBC1TestImage(width, height);
+
+    const float qualities[] = {0.05f, 0.5f, 1.0f};
+
+    for (unsigned int bcn = 1; bcn <= 3; bcn += 2)
+    {
+        for (float quality : qualities)
+        {
+            for (unsigned int steps = 0; steps < 3; steps++)
+            {
+                // the refine steps are only used by the BC1 encoder
+                if (bcn != 1 && steps > 0)
+                    continue;
+
+                void* options = CreateTestOptionsBC1To3(bcn, quality, steps);
+                REQUIRE(options != NULL);
+
+                printf("BC%u %ux%u quality %.2f refine steps %u, single thread\n", bcn, width, height, quality, steps);
+
+                DisableSIMD();
+                BenchmarkBC1To3Throughput("Scalar", bcn, image, width, height, options);
+
+                if (EnableSSE4() == CGU_CORE_OK)
+                    BenchmarkBC1To3Throughput("SSE4", bcn, image, width, height, options);
+                else
+                    printf("  SSE4     not supported\n");
+
+                if (EnableAVX2() == CGU_CORE_OK)
+                    BenchmarkBC1To3Throughput("AVX2", bcn, image, width, height, options);
+                else
+                    printf("  AVX2     not supported\n");
+
+                if (EnableAVX512() == CGU_CORE_OK)
+                    BenchmarkBC1To3Throughput("AVX-512", bcn, image, width, height, options);
+                else
+                    printf("  AVX-512  not supported\n");
+
+                DestroyTestOptionsBC1To3(bcn, options);
+            }
+        }
+    }
+
+    DisableSIMD();
+}
+
+static const unsigned int BCnDecodeBlockBytes[] = {8, 16, 16, 8, 16};
+
+// Decodes the blocks of a BC1 to BC5 image with the row decoders, the rows of each
+// destination are padded so that the decoders do not see a tightly packed pitch
+static int DecompressTestBlocks(unsigned int                      bcn,
+                                const std::vector<unsigned char>& cmpData,
+                                unsigned int                      blocksX,
+                                unsigned int                      blocksY,
+                                std::vector<unsigned char>&       output)
+{
+    const unsigned int cmpPitch   = blocksX * BCnDecodeBlockBytes[bcn - 1];
+    const unsigned int pixelBytes = (bcn >= 4) ? 1 : 4;
+    const unsigned int dstPitch   = blocksX * 4 * pixelBytes + 3;
+    const unsigned int planeSize  = dstPitch * blocksY * 4;
+
+    output.assign((bcn == 5) ? planeSize * 2 : planeSize, 0xCD);
+
+    switch (bcn)
+    {
+    case 1:
+        return DecompressBlocksBC1(cmpData.data(), cmpPitch, blocksX, blocksY, output.data(), dstPitch);
+    case 2:
+        return DecompressBlocksBC2(cmpData.data(), cmpPitch, blocksX, blocksY, output.data(), dstPitch);
+    case 3:
+        return DecompressBlocksBC3(cmpData.data(), cmpPitch, blocksX, blocksY, output.data(), dstPitch);
+    case 4:
+        return DecompressBlocksBC4(cmpData.data(), cmpPitch, blocksX, blocksY, output.data(), dstPitch);
+    default:
+        return DecompressBlocksBC5(cmpData.data(), cmpPitch, blocksX, blocksY, output.data(), dstPitch, output.data() + planeSize, dstPitch);
+    }
+}
+
+// Builds the expected output of DecompressTestBlocks from the single block decoders
+static void DecompressTestBlocksReference(unsigned int                      bcn,
+                                          const std::vector<unsigned char>& cmpData,
+                                          unsigned int                      blocksX,
+                                          unsigned int                      blocksY,
+                                          std::vector<unsigned char>&       output)
+{
+    const unsigned int pixelBytes = (bcn >= 4) ? 1 : 4;
+    const unsigned int dstPitch   = blocksX * 4 * pixelBytes + 3;
+    const unsigned int planeSize  = dstPitch * blocksY * 4;
+
+    output.assign((bcn == 5) ? planeSize * 2 : planeSize, 0xCD);
+
+    for (unsigned int y = 0; y < blocksY; y++)
+    {
+        for (unsigned int x = 0; x < blocksX; x++)
+        {
+            const unsigned char* block = cmpData.data() + (y * blocksX + x) * BCnDecodeBlockBytes[bcn - 1];
+
+            unsigned char pixels[2][64];
+            switch (bcn)
+            {
+            case 1:
+                DecompressBlockBC1(block, pixels[0], NULL);
+                break;
+            case 2:
+                DecompressBlockBC2(block, pixels[0], NULL);
+                break;
+            case 3:
+                DecompressBlockBC3(block, pixels[0], NULL);
+                break;
+            case 4:
+                DecompressBlockBC4(block, pixels[0], NULL);
+                break;
+            default:
+                DecompressBlockBC5(block, pixels[0], pixels[1], NULL);
+                break;
+            }
+
+            for (unsigned int plane = 0; plane < ((bcn == 5) ? 2u : 1u); plane++)
+            {
+                for (unsigned int row = 0; row < 4; row++)
+                {
+                    unsigned char* dst = output.data() + plane * planeSize + (y * 4 + row) * dstPitch + x * 4 * pixelBytes;
+                    memcpy(dst, &pixels[plane][row * 4 * pixelBytes], 4 * pixelBytes);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("BCn_Decompression", "[SIMD]")
+{
+    // An odd number of blocks per row leaves a partial batch for the SIMD decoders
+    const unsigned int blocksX = 37;
+    const unsigned int blocksY = 5;
+
+    std::vector<unsigned char> referenceData;
+    std::vector<unsigned char> decodedData;
+
+    for (unsigned int bcn = 1; bcn <= 5; bcn++)
+    {
+        // Random blocks cover both BC1 colour modes and both BC4 alpha ramps
+        std::vector<unsigned char> cmpData(blocksX * blocksY * BCnDecodeBlockBytes[bcn - 1]);
+        unsigned int               seed = 0x2545F491u * bcn;
+        for (unsigned char& value : cmpData)
+        {
+            seed  = seed * 1664525u + 1013904223u;
+            value = static_cast<unsigned char>(seed >> 24);
+        }
+
+        INFO("BC" << bcn);
+        DecompressTestBlocksReference(bcn, cmpData, blocksX, blocksY, referenceData);
+
+        DisableSIMD();
+        REQUIRE(DecompressTestBlocks(bcn, cmpData, blocksX, blocksY, decodedData) == CGU_CORE_OK);
+        CHECK(decodedData == referenceData);
+
+        if (EnableSSE4() == CGU_CORE_OK)
+        {
+            REQUIRE(DecompressTestBlocks(bcn, cmpData, blocksX, blocksY, decodedData) == CGU_CORE_OK);
+            CHECK(decodedData == referenceData);
+        }
+        else
+            WARN("Skipping SSE4 BCn decoding test because it is not supported on the current CPU.");
+
+        if (EnableAVX2() == CGU_CORE_OK)
+        {
+            REQUIRE(DecompressTestBlocks(bcn, cmpData, blocksX, blocksY, decodedData) == CGU_CORE_OK);
+            CHECK(decodedData == referenceData);
+        }
+        else
+            WARN("Skipping AVX2 BCn decoding test because it is not supported on the current CPU.");
+
+        if (EnableAVX512() == CGU_CORE_OK)
+        {
+            REQUIRE(DecompressTestBlocks(bcn, cmpData, blocksX, blocksY, decodedData) == CGU_CORE_OK);
+            CHECK(decodedData == referenceData);
+        }
+        else
+            WARN("Skipping AVX-512 BCn decoding test because it is not supported on the current CPU.");
+    }
+
+    DisableSIMD();
+}
+
+static void BenchmarkBCnDecodeThroughput(const char* name, unsigned int bcn, const std::vector<unsigned char>& cmpData, unsigned int blocksX, unsigned int blocksY)
+{
+    std::vector<unsigned char> decodedData;
+
+    BenchmarkTimer timer;
+    for (int i = 0; i < 10; i++)
+        DecompressTestBlocks(bcn, cmpData, blocksX, blocksY, decodedData);
+    double seconds = timer.WallSeconds() / 10;
+
+    printf("  %-8s %8.4f s  %8.1f MPixels/s\n", name, seconds, (blocksX * blocksY * 16) / (seconds * 1000000.0));
+}
+
+TEST_CASE("BCn_Decode_Throughput", "[.][BENCHMARK]")
+{
+    const unsigned int blocksX = 512;
+    const unsigned int blocksY = 512;
+
+    for (unsigned int bcn = 1; bcn <= 5; bcn++)
+    {
+        std::vector<unsigned char> cmpData(blocksX * blocksY * BCnDecodeBlockBytes[bcn - 1]);
+        unsigned int               seed = 1;
+        for (unsigned char& value : cmpData)
+        {
+            seed  = seed * 1664525u + 1013904223u;
+            value = static_cast<unsigned char>(seed >> 24);
+        }
+
+        printf("BC%u %ux%u blocks, single thread\n", bcn, blocksX, blocksY);
+
+        DisableSIMD();
+        BenchmarkBCnDecodeThroughput("Scalar", bcn, cmpData, blocksX, blocksY);
+
+        if (EnableSSE4() == CGU_CORE_OK)
+            BenchmarkBCnDecodeThroughput("SSE4", bcn, cmpData, blocksX, blocksY);
+        else
+            printf("  SSE4     not supported\n");
+
+        if (EnableAVX2() == CGU_CORE_OK)
+            BenchmarkBCnDecodeThroughput("AVX2", bcn, cmpData, blocksX, blocksY);
+        else
+            printf("  AVX2     not supported\n");
+    }
+
+    DisableSIMD();
+}
+
+// ETC test formats: 0 = ETC1, 1 = ETC2 RGB, 2 = ETC2 RGBA
+static const unsigned int ETCBlockBytes[] = {8, 8, 16};
+static const char*        ETCFormatNames[] = {"ETC1", "ETC2 RGB", "ETC2 RGBA"};
+
+static int CompressTestBlocksETC(unsigned int format, const std::vector<unsigned char>& image, unsigned int width, unsigned int height, void* options, std::vector<unsigned char>& cmpData)
+{
+    unsigned int blockBytes = ETCBlockBytes[format];
+
+    cmpData.resize(width / 4 * height / 4 * blockBytes);
+
+    for (unsigned int y = 0; y < height; y += 4)
+    {
+        for (unsigned int x = 0; x < width; x += 4)
+        {
+            const unsigned char* srcBlock = &image[(y * width + x) * 4];
+            unsigned char*       cmpBlock = &cmpData[((y / 4) * (width / 4) + x / 4) * blockBytes];
+
+            int result;
+            if (format == 0)
+                result = CompressBlockETC1(srcBlock, width * 4, cmpBlock, options);
+            else if (format == 1)
+                result = CompressBlockETC2(srcBlock, width * 4, cmpBlock, options);
+            else
+                result = CompressBlockETC2RGBA(srcBlock, width * 4, cmpBlock, options);
+
+            if (result != CGU_CORE_OK)
+                return result;
+        }
+    }
+
+    return CGU_CORE_OK;
+}
+
+static void DecompressTestBlocksETC(unsigned int format, const std::vector<unsigned char>& cmpData, unsigned int width, unsigned int height, std::vector<unsigned char>& image)
+{
+    unsigned int blockBytes = ETCBlockBytes[format];
+
+    image.resize(width * height * 4);
+
+    for (unsigned int y = 0; y < height; y += 4)
+    {
+        for (unsigned int x = 0; x < width; x += 4)
+        {
+            const unsigned char* cmpBlock = &cmpData[((y / 4) * (width / 4) + x / 4) * blockBytes];
+            unsigned char        block[64];
+
+            if (format == 0)
+                DecompressBlockETC1(cmpBlock, block);
+            else if (format == 1)
+                DecompressBlockETC2(cmpBlock, block);
+            else
+                DecompressBlockETC2RGBA(cmpBlock, block);
+
+            for (unsigned int row = 0; row < 4; row++)
+                memcpy(&image[((y + row) * width + x) * 4], &block[row * 16], 16);
+        }
+    }
+}
+
+static unsigned int ReadBigEndian32(const unsigned char* data)
+{
+    return ((unsigned int)data[0] << 24) | ((unsigned int)data[1] << 16) | ((unsigned int)data[2] << 8) | data[3];
+}
+
+// Decodes with etcpack, the ETC reference implementation
+static void DecompressTestBlocksEtcpack(unsigned int format, const std::vector<unsigned char>& cmpData, unsigned int width, unsigned int height, std::vector<unsigned char>& image)
+{
+    unsigned int               blockBytes = ETCBlockBytes[format];
+    std::vector<unsigned char> rgb(width * height * 3);
+    std::vector<unsigned char> alpha(width * height, 255);
+
+    for (unsigned int y = 0; y < height; y += 4)
+    {
+        for (unsigned int x = 0; x < width; x += 4)
+        {
+            unsigned char* cmpBlock   = (unsigned char*)&cmpData[((y / 4) * (width / 4) + x / 4) * blockBytes];
+            unsigned char* colorBlock = format == 2 ? cmpBlock + 8 : cmpBlock;
+
+            if (format == 0)
+                decompressBlockDiffFlip(ReadBigEndian32(colorBlock), ReadBigEndian32(colorBlock + 4), rgb.data(), width, height, x, y);
+            else
+                decompressBlockETC2(ReadBigEndian32(colorBlock), ReadBigEndian32(colorBlock + 4), rgb.data(), width, height, x, y);
+
+            if (format == 2)
+                decompressBlockAlpha(cmpBlock, alpha.data(), width, height, x, y);
+        }
+    }
+
+    image.resize(width * height * 4);
+    for (unsigned int i = 0; i < width * height; i++)
+    {
+        image[i * 4 + 0] = rgb[i * 3 + 0];
+        image[i * 4 + 1] = rgb[i * 3 + 1];
+        image[i * 4 + 2] = rgb[i * 3 + 2];
+        image[i * 4 + 3] = alpha[i];
+    }
+}
+
+// Encodes with the etcpack fast perceptual encoders, which the ETC codecs used before CMP_Core, or with its exhaustive ones
+static void CompressTestBlocksEtcpack(unsigned int                      format,
+                                      const std::vector<unsigned char>& image,
+                                      unsigned int                      width,
+                                      unsigned int                      height,
+                                      std::vector<unsigned char>&       cmpData,
+                                      bool                              exhaustive = false)
+{
+    unsigned int               blockBytes = ETCBlockBytes[format];
+    std::vector<unsigned char> rgb(width * height * 3);
+    std::vector<unsigned char> alpha(width * height);
+    std::vector<unsigned char> decoded(width * height * 3);
+
+    for (unsigned int i = 0; i < width * height; i++)
+    {
+        rgb[i * 3 + 0] = image[i * 4 + 0];
+        rgb[i * 3 + 1] = image[i * 4 + 1];
+        rgb[i * 3 + 2] = image[i * 4 + 2];
+        alpha[i]       = image[i * 4 + 3];
+    }
+
+    cmpData.resize(width / 4 * height / 4 * blockBytes);
+
+    for (unsigned int y = 0; y < height; y += 4)
+    {
+        for (unsigned int x = 0; x < width; x += 4)
+        {
+            unsigned char* cmpBlock   = &cmpData[((y / 4) * (width / 4) + x / 4) * blockBytes];
+            unsigned char* colorBlock = format == 2 ? cmpBlock + 8 : cmpBlock;
+            unsigned int   hi, lo;
+
+            if (format == 0 && exhaustive)
+                compressBlockETC1ExhaustivePerceptual(rgb.data(), decoded.data(), width, height, x, y, hi, lo);
+            else if (format == 0)
+                compressBlockDiffFlipFastPerceptual(rgb.data(), decoded.data(), width, height, x, y, hi, lo);
+            else if (exhaustive)
+                compressBlockETC2ExhaustivePerceptual(rgb.data(), decoded.data(), width, height, x, y, hi, lo);
+            else
+                compressBlockETC2FastPerceptual(rgb.data(), decoded.data(), width, height, x, y, hi, lo);
+
+            for (unsigned int i = 0; i < 4; i++)
+            {
+                colorBlock[i]     = (unsigned char)(hi >> (24 - i * 8));
+                colorBlock[i + 4] = (unsigned char)(lo >> (24 - i * 8));
+            }
+
+            if (format == 2 && exhaustive)
+                compressBlockAlphaSlow(alpha.data(), x, y, width, height, cmpBlock);
+            else if (format == 2)
+                compressBlockAlphaFast(alpha.data(), x, y, width, height, cmpBlock);
+        }
+    }
+}
+
+// PSNR with the perceptual channel weights both etcpack and CMP_Core minimize, alpha has weight one
+static double ETCTestPSNR(const std::vector<unsigned char>& image, const std::vector<unsigned char>& decoded, bool useAlpha)
+{
+    const double weights[4]   = {0.299, 0.587, 0.114, 1.0};
+    double       squaredError = 0.0;
+    unsigned int numPixels    = (unsigned int)image.size() / 4;
+
+    for (unsigned int i = 0; i < numPixels; i++)
+    {
+        for (unsigned int ch = 0; ch < (useAlpha ? 4u : 3u); ch++)
+        {
+            double d = (double)image[i * 4 + ch] - (double)decoded[i * 4 + ch];
+            squaredError += weights[ch] * d * d;
+        }
+    }
+
+    double mse = squaredError / (numPixels * (useAlpha ? 2.0 : 1.0));
+    return (mse > 0.0) ? 10.0 * log10(255.0 * 255.0 / mse) : 100.0;
+}
+
+TEST_CASE("ETC_Compression", "[SIMD]")
+{
+    const unsigned int width  = 64;
+    const unsigned int height = 64;
+
+    std::vector<unsigned char> image = CreateBC7TestImage(width, height);
+
+    readCompressParams();
+    setupAlphaTableAndValtab();
+
+    const float qualities[] = {0.05f, 1.0f};
+
+    for (unsigned int format = 0; format < 3; format++)
+    {
+        bool useAlpha = format == 2;
+
+        std::vector<unsigned char> etcpackData;
+        std::vector<unsigned char> etcpackDecoded;
+        CompressTestBlocksEtcpack(format, image, width, height, etcpackData);
+        DecompressTestBlocksEtcpack(format, etcpackData, width, height, etcpackDecoded);
+
+        double etcpackPSNR = ETCTestPSNR(image, etcpackDecoded, useAlpha);
+
+        for (float quality : qualities)
+        {
+            void* options = NULL;
+            REQUIRE(CreateOptionsETC(&options) == CGU_CORE_OK);
+            REQUIRE(SetQualityETC(options, quality) == CGU_CORE_OK);
+
+            std::vector<unsigned char> referenceData;
+            std::vector<unsigned char> compressedData;
+
+            DisableSIMD();
+            REQUIRE(CompressTestBlocksETC(format, image, width, height, options, referenceData) == CGU_CORE_OK);
+
+            // The SIMD palette searches must produce the same blocks as the scalar encoder
+            if (EnableSSE4() == CGU_CORE_OK)
+            {
+                REQUIRE(CompressTestBlocksETC(format, image, width, height, options, compressedData) == CGU_CORE_OK);
+                CHECK(memcmp(referenceData.data(), compressedData.data(), referenceData.size()) == 0);
+            }
+            else
+                WARN("Skipping SSE4 ETC test because it is not supported on the current CPU.");
+
+            if (EnableAVX2() == CGU_CORE_OK)
+            {
+                REQUIRE(CompressTestBlocksETC(format, image, width, height, options, compressedData) == CGU_CORE_OK);
+                CHECK(memcmp(referenceData.data(), compressedData.data(), referenceData.size()) == 0);
+            }
+            else
+                WARN("Skipping AVX2 ETC test because it is not supported on the current CPU.");
+
+            if (EnableAVX512() == CGU_CORE_OK)
+            {
+                REQUIRE(CompressTestBlocksETC(format, image, width, height, options, compressedData) == CGU_CORE_OK);
+                CHECK(memcmp(referenceData.data(), compressedData.data(), referenceData.size()) == 0);
+            }
+            else
+                WARN("Skipping AVX-512 ETC test because it is not supported on the current CPU.");
+
+            // The blocks must decode the same with etcpack and with CMP_Core
+            std::vector<unsigned char> decoded;
+            std::vector<unsigned char> etcpackReferenceDecoded;
+            DecompressTestBlocksETC(format, referenceData, width, height, decoded);
+            DecompressTestBlocksEtcpack(format, referenceData, width, height, etcpackReferenceDecoded);
+            CHECK(memcmp(decoded.data(), etcpackReferenceDecoded.data(), decoded.size()) == 0);
+
+            // and have at least the quality of the etcpack fast encoders
+            double psnr = ETCTestPSNR(image, decoded, useAlpha);
+
+            INFO(ETCFormatNames[format] << " quality " << quality << " PSNR " << psnr << " etcpack PSNR " << etcpackPSNR);
+            CHECK(psnr > etcpackPSNR - 0.25);
+
+            DestroyOptionsETC(options);
+        }
+    }
+
+    DisableSIMD();
+}
+
+TEST_CASE("ETC_Full_Search_Quality", "[SIMD]")
+{
+    // Quality 0.5 and above selects the full search, the etcpack exhaustive encoders are slow so the image is small
+    const unsigned int width  = 32;
+    const unsigned int height = 32;
+
+    std::vector<unsigned char> image = CreateBC7TestImage(width, height);
+
+    readCompressParams();
+    setupAlphaTableAndValtab();
+
+    void* options = NULL;
+    REQUIRE(CreateOptionsETC(&options) == CGU_CORE_OK);
+    REQUIRE(SetQualityETC(options, 0.5f) == CGU_CORE_OK);
+
+    for (unsigned int format = 0; format < 3; format++)
+    {
+        bool useAlpha = format == 2;
+
+        std::vector<unsigned char> cmpData;
+        std::vector<unsigned char> decoded;
+        REQUIRE(CompressTestBlocksETC(format, image, width, height, options, cmpData) == CGU_CORE_OK);
+        DecompressTestBlocksEtcpack(format, cmpData, width, height, decoded);
+        double psnr = ETCTestPSNR(image, decoded, useAlpha);
+
+        CompressTestBlocksEtcpack(format, image, width, height, cmpData);
+        DecompressTestBlocksEtcpack(format, cmpData, width, height, decoded);
+        double fastPSNR = ETCTestPSNR(image, decoded, useAlpha);
+
+        CompressTestBlocksEtcpack(format, image, width, height, cmpData, true);
+        DecompressTestBlocksEtcpack(format, cmpData, width, height, decoded);
+        double exhaustivePSNR = ETCTestPSNR(image, decoded, useAlpha);
+
+        // Never worse than the etcpack encoders the codecs used, and close to the etcpack exhaustive search
+        INFO(ETCFormatNames[format] << " PSNR " << psnr << " etcpack fast PSNR " << fastPSNR << " etcpack exhaustive PSNR " << exhaustivePSNR);
+        CHECK(psnr >= fastPSNR);
+        CHECK(psnr > exhaustivePSNR - 0.25);
+    }
+
+    DestroyOptionsETC(options);
+}
+
+static void BenchmarkETCThroughput(const char*                       name,
+                                   unsigned int                      format,
+                                   const std::vector<unsigned char>& image,
+                                   unsigned int                      width,
+                                   unsigned int                      height,
+                                   void*                             options)
+{
+    std::vector<unsigned char> compressedData;
+    std::vector<unsigned char> decoded;
+
+    BenchmarkTimer timer;
+    if (options)
+        CompressTestBlocksETC(format, image, width, height, options, compressedData);
+    else
+        CompressTestBlocksEtcpack(format, image, width, height, compressedData);
+    double seconds = timer.WallSeconds();
+
+    DecompressTestBlocksEtcpack(format, compressedData, width, height, decoded);
+
+    printf("  %-12s %8.3f s  %8.3f MPixels/s  %6.2f dB\n",
+           name,
+           seconds,
+           (width * height) / (seconds * 1000000.0),
+           ETCTestPSNR(image, decoded, format == 2));
+}
+
+TEST_CASE("ETC_SIMD_Throughput", "[.][BENCHMARK]")
+{
+    const unsigned int width  = 256;
+    const unsigned int height = 256;
+
+    std::vector<unsigned char> image = CreateBC7TestImage(width, height);
+
+    readCompressParams();
+    setupAlphaTableAndValtab();
+
+    for (unsigned int format = 0; format < 3; format++)
+    {
+        printf("%s %ux%u, single thread\n", ETCFormatNames[format], width, height);
+
+        BenchmarkETCThroughput("etcpack", format, image, width, height, NULL);
+
+        const float qualities[]    = {0.05f, 1.0f};
+        const char* qualityNames[] = {"fast", "full"};
+
+        for (unsigned int q = 0; q < 2; q++)
+        {
+            void* options = NULL;
+            REQUIRE(CreateOptionsETC(&options) == CGU_CORE_OK);
+            SetQualityETC(options, qualities[q]);
+
+            std::string name;
+
+            DisableSIMD();
+            name = std::string("Scalar ") + qualityNames[q];
+            BenchmarkETCThroughput(name.c_str(), format, image, width, height, options);
+
+            if (EnableSSE4() == CGU_CORE_OK)
+            {
+                name = std::string("SSE4 ") + qualityNames[q];
+                BenchmarkETCThroughput(name.c_str(), format, image, width, height, options);
+            }
+            else
+                printf("  SSE4     not supported\n");
+
+            if (EnableAVX2() == CGU_CORE_OK)
+            {
+                name = std::string("AVX2 ") + qualityNames[q];
+                BenchmarkETCThroughput(name.c_str(), format, image, width, height, options);
+            }
+            else
+                printf("  AVX2     not supported\n");
+
+            if (EnableAVX512() == CGU_CORE_OK)
+            {
+                name = std::string("AVX-512 ") + qualityNames[q];
+                BenchmarkETCThroughput(name.c_str(), format, image, width, height, options);
+            }
+            else
+                printf("  AVX-512  not supported\n");
+
+            DestroyOptionsETC(options);
+        }
+    }
+
+    DisableSIMD();
+}
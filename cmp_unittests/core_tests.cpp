@@ -29,11 +29,18 @@
 #include "blockconstants.h"
 
 #include <cmp_core.h>
+#include <common_def.h>
 #include <utilfuncs.h>
+#include "compressonator.h"
+#include "benchmark_utils.h"
 
+#include <algorithm>
 #include <map>
+#include <cmath>
 #include <cstring>
 #include <array>
+#include <thread>
+#include <vector>
 
 #ifdef USE_LOSSLESS_COMPRESSION
 #include "brotlig/brlg_sdk_wrapper.h"
@@ -2750,4 +2757,388 @@ TEST_CASE("BC7_Green_Half_Alpha", "[BC7_Green_Half_Alpha]")
     CHECK(ColorMatches(decompCompBlock, blockColor, false));
 }
 
-//***************************************************************************************
\ No newline at end of file
+//***************************************************************************************
+// Source rows and compressed block rows are padded so the pitches differ from the packed sizes,
+// and the rectangle is wider than one batch of blocks
+static const unsigned int BATCH_TEST_BLOCKS_X = 19;
+static const unsigned int BATCH_TEST_BLOCKS_Y = 3;
+
+static void FillBatchTestImage(std::vector<unsigned char>& data, unsigned int pitch, unsigned int rows)
+{
+    data.resize(pitch * rows);
+    for (unsigned int i = 0; i < data.size(); i++)
+        data[i] = (unsigned char)((i * 7 + (i / pitch) * 13 + ((i * i) >> 5)) & 0xFF);
+}
+
+template <typename CompressBlocks, typename CompressBlock>
+static void CheckCompressBlocks(unsigned int   bytesPerPixel,
+                                unsigned int   blockSize,
+                                CompressBlocks compressBlocks,
+                                CompressBlock  compressBlock)
+{
+    const unsigned int srcPitch = BATCH_TEST_BLOCKS_X * 4 * bytesPerPixel + 12;
+    const unsigned int cmpPitch = BATCH_TEST_BLOCKS_X * blockSize + 8;
+
+    std::vector<unsigned char> source;
+    FillBatchTestImage(source, srcPitch, BATCH_TEST_BLOCKS_Y * 4);
+
+    std::vector<unsigned char> batched(cmpPitch * BATCH_TEST_BLOCKS_Y, 0xCD);
+    std::vector<unsigned char> single(cmpPitch * BATCH_TEST_BLOCKS_Y, 0xCD);
+
+    REQUIRE(compressBlocks(source.data(), srcPitch, batched.data(), cmpPitch) == CGU_CORE_OK);
+
+    for (unsigned int y = 0; y < BATCH_TEST_BLOCKS_Y; y++)
+    {
+        for (unsigned int x = 0; x < BATCH_TEST_BLOCKS_X; x++)
+        {
+            const unsigned char* srcBlock = &source[y * 4 * srcPitch + x * 4 * bytesPerPixel];
+            REQUIRE(compressBlock(srcBlock, srcPitch, &single[y * cmpPitch + x * blockSize]) == CGU_CORE_OK);
+        }
+    }
+
+    CHECK(batched == single);
+}
+
+TEST_CASE("CompressBlocks_Matches_CompressBlock", "[CORE_BLOCKS]")
+{
+    const unsigned int bx = BATCH_TEST_BLOCKS_X;
+    const unsigned int by = BATCH_TEST_BLOCKS_Y;
+
+    SECTION("BC1")
+    {
+        void* options = nullptr;
+        REQUIRE(CreateOptionsBC1(&options) == CGU_CORE_OK);
+        SetQualityBC1(options, 0.6f);
+        CheckCompressBlocks(
+            4,
+            8,
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp, unsigned int cmpPitch) {
+                return CompressBlocksBC1(src, pitch, bx, by, cmp, cmpPitch, options);
+            },
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp) { return CompressBlockBC1(src, pitch, cmp, options); });
+        DestroyOptionsBC1(options);
+    }
+
+    SECTION("BC2")
+    {
+        CheckCompressBlocks(
+            4,
+            16,
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp, unsigned int cmpPitch) {
+                return CompressBlocksBC2(src, pitch, bx, by, cmp, cmpPitch, nullptr);
+            },
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp) { return CompressBlockBC2(src, pitch, cmp, nullptr); });
+    }
+
+    SECTION("BC3")
+    {
+        CheckCompressBlocks(
+            4,
+            16,
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp, unsigned int cmpPitch) {
+                return CompressBlocksBC3(src, pitch, bx, by, cmp, cmpPitch, nullptr);
+            },
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp) { return CompressBlockBC3(src, pitch, cmp, nullptr); });
+    }
+
+    SECTION("BC4")
+    {
+        CheckCompressBlocks(
+            1,
+            8,
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp, unsigned int cmpPitch) {
+                return CompressBlocksBC4(src, pitch, bx, by, cmp, cmpPitch, nullptr);
+            },
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp) { return CompressBlockBC4(src, pitch, cmp, nullptr); });
+    }
+
+    SECTION("BC5")
+    {
+        // The second channel is read two bytes further into the same padded rows
+        CheckCompressBlocks(
+            1,
+            16,
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp, unsigned int cmpPitch) {
+                return CompressBlocksBC5(src, pitch, src + 2, pitch, bx, by, cmp, cmpPitch, nullptr);
+            },
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp) { return CompressBlockBC5(src, pitch, src + 2, pitch, cmp, nullptr); });
+    }
+
+    SECTION("BC6")
+    {
+        void* options = nullptr;
+        REQUIRE(CreateOptionsBC6(&options) == CGU_CORE_OK);
+        SetQualityBC6(options, 0.1f);
+
+        // Half floats below 1.0 keep the generated values in a sensible range
+        const unsigned int srcPitch = bx * 4 * 3 + 6;
+        std::vector<unsigned short> source(srcPitch * by * 4);
+        for (unsigned int i = 0; i < source.size(); i++)
+            source[i] = (unsigned short)(0x3000 + ((i * 37 + (i / srcPitch) * 101) & 0x0BFF));
+
+        const unsigned int         cmpPitch = bx * 16 + 8;
+        std::vector<unsigned char> batched(cmpPitch * by, 0xCD);
+        std::vector<unsigned char> single(cmpPitch * by, 0xCD);
+
+        REQUIRE(CompressBlocksBC6(source.data(), srcPitch, bx, by, batched.data(), cmpPitch, options) == CGU_CORE_OK);
+        for (unsigned int y = 0; y < by; y++)
+            for (unsigned int x = 0; x < bx; x++)
+                REQUIRE(CompressBlockBC6(&source[y * 4 * srcPitch + x * 4 * 3], srcPitch, &single[y * cmpPitch + x * 16], options) == CGU_CORE_OK);
+
+        CHECK(batched == single);
+        DestroyOptionsBC6(options);
+    }
+
+    SECTION("BC7")
+    {
+        void* options = nullptr;
+        REQUIRE(CreateOptionsBC7(&options) == CGU_CORE_OK);
+        SetQualityBC7(options, 0.1f);
+        CheckCompressBlocks(
+            4,
+            16,
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp, unsigned int cmpPitch) {
+                return CompressBlocksBC7(src, pitch, bx, by, cmp, cmpPitch, options);
+            },
+            [&](const unsigned char* src, unsigned int pitch, unsigned char* cmp) { return CompressBlockBC7(src, pitch, cmp, options); });
+        DestroyOptionsBC7(options);
+    }
+
+    SECTION("Invalid pointers")
+    {
+        unsigned char block[16] = {};
+        CHECK(CompressBlocksBC1(nullptr, 16, 1, 1, block, 8) == CGU_CORE_ERR_INVALIDPTR);
+        CHECK(CompressBlocksBC7(block, 16, 1, 1, nullptr, 16) == CGU_CORE_ERR_INVALIDPTR);
+    }
+}
+
+// Smooth gradients with some noise, so that the decoded images can be compared against the source
+static void FillImageTestImage(std::vector<unsigned char>& data, unsigned int width, unsigned int height, unsigned int pitch)
+{
+    data.assign(pitch * height, 0xCD);
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            unsigned char* pixel = &data[y * pitch + x * 4];
+            pixel[0]             = (unsigned char)(x * 255 / width);
+            pixel[1]             = (unsigned char)(y * 255 / height);
+            pixel[2]             = (unsigned char)(((x + y) * 3 + ((x * y) & 7)) & 0xFF);
+            pixel[3]             = 255;
+        }
+    }
+}
+
+static double ImageTestRMSE(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b, unsigned int width, unsigned int height, unsigned int pitch)
+{
+    double sum = 0.0;
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width * 4; x++)
+        {
+            double diff = (double)a[y * pitch + x] - (double)b[y * pitch + x];
+            sum += diff * diff;
+        }
+    }
+    return sqrt(sum / (width * height * 4));
+}
+
+TEST_CASE("CompressImage_Threads_And_Edges", "[CORE_IMAGE]")
+{
+    // Not a multiple of the block size in either direction, with padded rows
+    const unsigned int width    = 37;
+    const unsigned int height   = 22;
+    const unsigned int blocksX  = (width + 3) / 4;
+    const unsigned int blocksY  = (height + 3) / 4;
+    const unsigned int srcPitch = width * 4 + 20;
+    const unsigned int cmpPitch = blocksX * 8 + 8;
+
+    std::vector<unsigned char> source;
+    FillImageTestImage(source, width, height, srcPitch);
+
+    std::vector<unsigned char> single(cmpPitch * blocksY, 0);
+    std::vector<unsigned char> threaded(cmpPitch * blocksY, 0);
+    REQUIRE(CompressImageBC1(source.data(), srcPitch, width, height, single.data(), cmpPitch, 1, nullptr) == CGU_CORE_OK);
+    REQUIRE(CompressImageBC1(source.data(), srcPitch, width, height, threaded.data(), cmpPitch, 3, nullptr) == CGU_CORE_OK);
+    CHECK(single == threaded);
+
+    // Interior blocks match the block level API, the corner block is padded with its last pixel column and row
+    unsigned char cmpBlock[8];
+    REQUIRE(CompressBlockBC1(&source[4 * srcPitch + 8 * 4], srcPitch, cmpBlock, nullptr) == CGU_CORE_OK);
+    CHECK(memcmp(cmpBlock, &single[1 * cmpPitch + 2 * 8], 8) == 0);
+
+    unsigned char cornerBlock[64];
+    for (unsigned int row = 0; row < 4; row++)
+    {
+        for (unsigned int col = 0; col < 4; col++)
+        {
+            unsigned int x = std::min((blocksX - 1) * 4 + col, width - 1);
+            unsigned int y = std::min((blocksY - 1) * 4 + row, height - 1);
+            memcpy(&cornerBlock[(row * 4 + col) * 4], &source[y * srcPitch + x * 4], 4);
+        }
+    }
+    REQUIRE(CompressBlockBC1(cornerBlock, 16, cmpBlock, nullptr) == CGU_CORE_OK);
+    CHECK(memcmp(cmpBlock, &single[(blocksY - 1) * cmpPitch + (blocksX - 1) * 8], 8) == 0);
+
+    // Decoding only writes the pixels inside of the image and leaves the row padding alone
+    std::vector<unsigned char> decoded(srcPitch * height, 0xCD);
+    REQUIRE(DecompressImageBC1(single.data(), cmpPitch, width, height, decoded.data(), srcPitch, 2, nullptr) == CGU_CORE_OK);
+    for (unsigned int y = 0; y < height; y++)
+        for (unsigned int x = width * 4; x < srcPitch; x++)
+            REQUIRE(decoded[y * srcPitch + x] == 0xCD);
+    CHECK(ImageTestRMSE(source, decoded, width, height, srcPitch) < 8.0);
+
+    CHECK(CompressImageBC7(nullptr, srcPitch, width, height, single.data(), cmpPitch, 1, nullptr) == CGU_CORE_ERR_INVALIDPTR);
+    CHECK(DecompressImageBC7(single.data(), cmpPitch, width, height, nullptr, srcPitch, 1, nullptr) == CGU_CORE_ERR_INVALIDPTR);
+}
+
+TEST_CASE("CompressImage_BC4_BC5_BC6_Edges", "[CORE_IMAGE]")
+{
+    const unsigned int width   = 10;
+    const unsigned int height  = 7;
+    const unsigned int blocksX = (width + 3) / 4;
+    const unsigned int blocksY = (height + 3) / 4;
+
+    std::vector<unsigned char> red(width * height);
+    std::vector<unsigned char> green(width * height);
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            red[y * width + x]   = (unsigned char)(x * 10 + y * 5);
+            green[y * width + x] = (unsigned char)(200 - x * 6 - y * 9);
+        }
+    }
+
+    std::vector<unsigned char> cmp(blocksX * blocksY * 16);
+    std::vector<unsigned char> decodedRed(width * height, 0);
+    std::vector<unsigned char> decodedGreen(width * height, 0);
+
+    REQUIRE(CompressImageBC4(red.data(), width, width, height, cmp.data(), blocksX * 8, 2, nullptr) == CGU_CORE_OK);
+    REQUIRE(DecompressImageBC4(cmp.data(), blocksX * 8, width, height, decodedRed.data(), width, 2, nullptr) == CGU_CORE_OK);
+    for (unsigned int i = 0; i < red.size(); i++)
+        CHECK(abs((int)red[i] - (int)decodedRed[i]) <= 4);
+
+    REQUIRE(CompressImageBC5(red.data(), width, green.data(), width, width, height, cmp.data(), blocksX * 16, 2, nullptr) == CGU_CORE_OK);
+    REQUIRE(DecompressImageBC5(cmp.data(), blocksX * 16, width, height, decodedRed.data(), width, decodedGreen.data(), width, 2, nullptr) ==
+            CGU_CORE_OK);
+    for (unsigned int i = 0; i < red.size(); i++)
+    {
+        CHECK(abs((int)red[i] - (int)decodedRed[i]) <= 4);
+        CHECK(abs((int)green[i] - (int)decodedGreen[i]) <= 4);
+    }
+
+    // A constant half float colour survives BC6H compression of partial blocks exactly
+    std::vector<unsigned short> hdr(width * height * 3);
+    for (unsigned int i = 0; i < hdr.size(); i += 3)
+    {
+        hdr[i]     = 0x3C00;  // 1.0
+        hdr[i + 1] = 0x3800;  // 0.5
+        hdr[i + 2] = 0x0000;  // 0.0
+    }
+    std::vector<unsigned short> decodedHDR(hdr.size(), 0xFFFF);
+    REQUIRE(CompressImageBC6(hdr.data(), width * 3, width, height, cmp.data(), blocksX * 16, 2, nullptr) == CGU_CORE_OK);
+    REQUIRE(DecompressImageBC6(cmp.data(), blocksX * 16, width, height, decodedHDR.data(), width * 3, 2, nullptr) == CGU_CORE_OK);
+    for (unsigned int i = 0; i < hdr.size(); i++)
+        CHECK(abs((int)hdr[i] - (int)decodedHDR[i]) <= 8);
+}
+
+static void BenchmarkCompressImage(CMP_FORMAT format, float quality, unsigned int numThreads)
+{
+    const unsigned int width    = 1024;
+    const unsigned int height   = 1024;
+    const unsigned int pitch    = width * 4;
+    const unsigned int blocks   = (width / 4) * (height / 4);
+    const unsigned int cmpBytes = (format == CMP_FORMAT_BC1) ? 8 : 16;
+
+    std::vector<unsigned char> source;
+    FillImageTestImage(source, width, height, pitch);
+
+    std::vector<unsigned char> coreResult(blocks * cmpBytes);
+    std::vector<unsigned char> libResult(blocks * cmpBytes);
+    std::vector<unsigned char> decoded(pitch * height);
+
+    // cmp_core path
+    void* options = nullptr;
+    if (format == CMP_FORMAT_BC1)
+    {
+        CreateOptionsBC1(&options);
+        SetQualityBC1(options, quality);
+    }
+    else
+    {
+        CreateOptionsBC7(&options);
+        SetQualityBC7(options, quality);
+    }
+
+    BenchmarkTimer timer;
+    if (format == CMP_FORMAT_BC1)
+        REQUIRE(CompressImageBC1(source.data(), pitch, width, height, coreResult.data(), (width / 4) * cmpBytes, numThreads, options) == CGU_CORE_OK);
+    else
+        REQUIRE(CompressImageBC7(source.data(), pitch, width, height, coreResult.data(), (width / 4) * cmpBytes, numThreads, options) == CGU_CORE_OK);
+    double coreWall = timer.WallSeconds();
+
+    if (format == CMP_FORMAT_BC1)
+    {
+        DecompressImageBC1(coreResult.data(), (width / 4) * cmpBytes, width, height, decoded.data(), pitch, numThreads, options);
+        DestroyOptionsBC1(options);
+    }
+    else
+    {
+        DecompressImageBC7(coreResult.data(), (width / 4) * cmpBytes, width, height, decoded.data(), pitch, numThreads, options);
+        DestroyOptionsBC7(options);
+    }
+    double coreRMSE = ImageTestRMSE(source, decoded, width, height, pitch);
+
+    // cmp_compressonatorlib path
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = width;
+    srcTexture.dwHeight    = height;
+    srcTexture.dwPitch     = pitch;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+    srcTexture.dwDataSize  = (CMP_DWORD)source.size();
+    srcTexture.pData       = source.data();
+
+    CMP_Texture destTexture = {};
+    destTexture.dwSize      = sizeof(destTexture);
+    destTexture.dwWidth     = width;
+    destTexture.dwHeight    = height;
+    destTexture.format      = format;
+    destTexture.dwDataSize  = (CMP_DWORD)libResult.size();
+    destTexture.pData       = libResult.data();
+
+    CMP_CompressOptions compressOptions = {};
+    compressOptions.dwSize              = sizeof(compressOptions);
+    compressOptions.fquality            = quality;
+    compressOptions.dwnumThreads        = numThreads;
+
+    timer.Restart();
+    REQUIRE(CMP_ConvertTexture(&srcTexture, &destTexture, &compressOptions, NULL) == CMP_OK);
+    double libWall = timer.WallSeconds();
+
+    CMP_Texture decodedTexture = srcTexture;
+    decodedTexture.pData       = decoded.data();
+    REQUIRE(CMP_ConvertTexture(&destTexture, &decodedTexture, &compressOptions, NULL) == CMP_OK);
+    double libRMSE = ImageTestRMSE(source, decoded, width, height, pitch);
+
+    printf("%s q %.2f %ux%u %u threads: cmp_core %.3f s (RMSE %.3f), compressonatorlib %.3f s (RMSE %.3f)\n",
+           format == CMP_FORMAT_BC1 ? "BC1" : "BC7",
+           quality,
+           width,
+           height,
+           numThreads,
+           coreWall,
+           coreRMSE,
+           libWall,
+           libRMSE);
+}
+
+TEST_CASE("CompressImage_Core_vs_Lib", "[.][BENCHMARK]")
+{
+    unsigned int numThreads = std::thread::hardware_concurrency();
+
+    BenchmarkCompressImage(CMP_FORMAT_BC1, 1.0f, numThreads);
+    BenchmarkCompressImage(CMP_FORMAT_BC7, 0.05f, numThreads);
+    BenchmarkCompressImage(CMP_FORMAT_BC7, 0.2f, numThreads);
+}
@@ -23,12 +23,22 @@
 
 #include "single_include/catch2/catch.hpp"
 
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
 #include <string>
+#include <vector>
 
 #include "compressonator.h"
+#include "halfconvert.h"
+#include "pluginmanager.h"
 
+#include "benchmark_utils.h"
 #include "test_constants.h"
 
+extern PluginManager g_pluginManager;
+
 TEST_CASE("Load_Texture_16_Bit", "[FRAMEWORK]")
 {
     CMP_MipSet texture = {};
@@ -52,4 +62,883 @@ TEST_CASE("Load_Texture_16_Bit", "[FRAMEWORK]")
     REQUIRE(texture.m_ChannelFormat == CF_8bit);
 
     CMP_FreeMipSet(&texture);
-}
\ No newline at end of file
+}
+
+static bool HalfBitsEqual(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+TEST_CASE("Half_Bulk_Conversion", "[FRAMEWORK]")
+{
+    // Every half, plus an odd tail so the scalar remainder is covered
+    std::vector<unsigned short> halfs(65536 + 13);
+    for (size_t i = 0; i < halfs.size(); i++)
+        halfs[i] = (unsigned short)(i & 0xffff);
+
+    std::vector<float> floats(halfs.size());
+    ConvertHalfToFloat(floats.data(), halfs.data(), halfs.size());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < halfs.size(); i++)
+    {
+        half h;
+        h.setBits(halfs[i]);
+        if (!HalfBitsEqual(floats[i], (float)h))
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    // A strided sweep over the float bit patterns, with the edge cases for rounding, overflow, denormals and NANs
+    std::vector<float> source;
+    for (unsigned long long bits = 0; bits < 0x100000000ull; bits += 65521)
+    {
+        unsigned int u = (unsigned int)bits;
+        float        f;
+        memcpy(&f, &u, sizeof(float));
+        source.push_back(f);
+    }
+
+    const unsigned int edges[] = {0x00000000, 0x80000000, 0x33000000, 0x33000001, 0x387fc000, 0x38800000, 0x477fefff, 0x477ff000,
+                                  0x47800000, 0x7f800000, 0xff800000, 0x7fc00000, 0x7f800001, 0xffc00123, 0x3f800000, 0x3f801000};
+    for (unsigned int u : edges)
+    {
+        float f;
+        memcpy(&f, &u, sizeof(float));
+        source.push_back(f);
+    }
+
+    std::vector<unsigned short> converted(source.size());
+    ConvertFloatToHalf(converted.data(), source.data(), source.size());
+
+    mismatches = 0;
+    for (size_t i = 0; i < source.size(); i++)
+    {
+        if (converted[i] != half(source[i]).bits())
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST_CASE("Half_Bulk_Conversion_Throughput", "[.][BENCHMARK]")
+{
+    const size_t count = 1 << 24;
+
+    std::vector<float> floats(count);
+    for (size_t i = 0; i < count; i++)
+        floats[i] = (float)(i % 65536) * 0.001f - 32.0f;
+
+    std::vector<unsigned short> halfs(count);
+
+    const char* extensions[] = {"Scalar", "F16C", "AVX-512"};
+    printf("Half conversion of %u values using %s\n", (unsigned int)count, extensions[GetHalfConvertExtension()]);
+
+    BenchmarkTimer timer;
+    double         seconds;
+    for (size_t i = 0; i < count; i++)
+        halfs[i] = half(floats[i]).bits();
+    seconds = timer.WallSeconds();
+    printf("  %-16s %8.3f s  %8.3f MValues/s\n", "float->half", seconds, count / seconds / 1e6);
+
+    timer.Restart();
+    ConvertFloatToHalf(halfs.data(), floats.data(), count);
+    seconds = timer.WallSeconds();
+    printf("  %-16s %8.3f s  %8.3f MValues/s\n", "float->half bulk", seconds, count / seconds / 1e6);
+
+    timer.Restart();
+    for (size_t i = 0; i < count; i++)
+    {
+        half h;
+        h.setBits(halfs[i]);
+        floats[i] = h;
+    }
+    seconds = timer.WallSeconds();
+    printf("  %-16s %8.3f s  %8.3f MValues/s\n", "half->float", seconds, count / seconds / 1e6);
+
+    timer.Restart();
+    ConvertHalfToFloat(floats.data(), halfs.data(), count);
+    seconds = timer.WallSeconds();
+    printf("  %-16s %8.3f s  %8.3f MValues/s\n", "half->float bulk", seconds, count / seconds / 1e6);
+}
+
+static CMP_ERROR CreateAnalysisTexture(CMP_MipSet& texture, CMP_FORMAT format, CMP_ChannelFormat channelFormat, CMP_INT width, CMP_INT height)
+{
+    texture = {};
+
+    CMP_ERROR error  = CMP_CreateMipSet(&texture, width, height, 1, channelFormat, TT_2D);
+    texture.m_format = format;
+    return error;
+}
+
+// Fills the texture with pseudo random values, seeds give two images that differ everywhere
+static void FillAnalysisTexture(CMP_MipSet& texture, unsigned int seed)
+{
+    size_t       numValues = (size_t)texture.m_nWidth * texture.m_nHeight * 4;
+    unsigned int state     = seed;
+
+    for (size_t i = 0; i < numValues; i++)
+    {
+        state = state * 1664525u + 1013904223u;
+
+        unsigned int value  = state >> 24;
+        CMP_FLOAT    valueF = (CMP_FLOAT)value / 255.0f * 4.0f - 1.0f;
+        switch (texture.m_ChannelFormat)
+        {
+        case CF_Float16:
+            ((unsigned short*)texture.pData)[i] = half(valueF).bits();
+            break;
+        case CF_Float32:
+            ((CMP_FLOAT*)texture.pData)[i] = valueF;
+            break;
+        default:
+            texture.pData[i] = (CMP_BYTE)value;
+            break;
+        }
+    }
+}
+
+// Reference per channel squared error sums, summed in pixel order
+static void AnalysisReferenceSums(const CMP_MipSet& texture1, const CMP_MipSet& texture2, double sums[4])
+{
+    size_t numValues = (size_t)texture1.m_nWidth * texture1.m_nHeight * 4;
+
+    for (int ch = 0; ch < 4; ch++)
+        sums[ch] = 0.0;
+
+    for (size_t i = 0; i < numValues; i++)
+    {
+        double a, b;
+        switch (texture1.m_ChannelFormat)
+        {
+        case CF_Float16:
+        {
+            half ha, hb;
+            ha.setBits(((unsigned short*)texture1.pData)[i]);
+            hb.setBits(((unsigned short*)texture2.pData)[i]);
+            a = (float)ha;
+            b = (float)hb;
+            break;
+        }
+        case CF_Float32:
+            a = ((CMP_FLOAT*)texture1.pData)[i];
+            b = ((CMP_FLOAT*)texture2.pData)[i];
+            break;
+        default:
+            a = texture1.pData[i];
+            b = texture2.pData[i];
+            break;
+        }
+        sums[i % 4] += (a - b) * (a - b);
+    }
+}
+
+static bool AnalysisDataEqual(const CMP_AnalysisData& a, const CMP_AnalysisData& b)
+{
+    return (a.mse == b.mse) && (a.mseR == b.mseR) && (a.mseG == b.mseG) && (a.mseB == b.mseB) && (a.mseA == b.mseA) && (a.psnr == b.psnr) &&
+           (a.psnrR == b.psnrR) && (a.psnrG == b.psnrG) && (a.psnrB == b.psnrB) && (a.psnrA == b.psnrA);
+}
+
+TEST_CASE("MipSet_Analysis", "[FRAMEWORK]")
+{
+    // Several analysis tiles with a partial last tile and an odd number of pixels
+    const CMP_INT width  = 509;
+    const CMP_INT height = 263;
+
+    struct
+    {
+        CMP_FORMAT        format;
+        CMP_ChannelFormat channelFormat;
+    } formats[] = {{CMP_FORMAT_RGBA_8888, CF_8bit}, {CMP_FORMAT_RGBA_16F, CF_Float16}, {CMP_FORMAT_RGBA_32F, CF_Float32}};
+
+    for (auto& format : formats)
+    {
+        CMP_MipSet texture1, texture2;
+        REQUIRE(CreateAnalysisTexture(texture1, format.format, format.channelFormat, width, height) == CMP_OK);
+        REQUIRE(CreateAnalysisTexture(texture2, format.format, format.channelFormat, width, height) == CMP_OK);
+        FillAnalysisTexture(texture1, 1);
+        FillAnalysisTexture(texture2, 2);
+
+        double sums[4];
+        AnalysisReferenceSums(texture1, texture2, sums);
+
+        CMP_ThreadPoolOptions options = {};
+        options.dwSize                = sizeof(options);
+        options.dwNumThreads          = 1;
+        REQUIRE(CMP_InitThreadPool(&options) == CMP_OK);
+
+        CMP_AnalysisData single = {};
+        single.channelBitMap    = 0xF;
+        REQUIRE(CMP_MipSetAnlaysis(&texture1, &texture2, 0, 0, &single) == CMP_OK);
+
+        // The results do not depend on the number of threads
+        options.dwNumThreads = 4;
+        REQUIRE(CMP_InitThreadPool(&options) == CMP_OK);
+
+        CMP_AnalysisData threaded = {};
+        threaded.channelBitMap    = 0xF;
+        REQUIRE(CMP_MipSetAnlaysis(&texture1, &texture2, 0, 0, &threaded) == CMP_OK);
+        CHECK(AnalysisDataEqual(single, threaded));
+
+        options.dwNumThreads = 0;
+        REQUIRE(CMP_InitThreadPool(&options) == CMP_OK);
+
+        double numPixels = (double)width * height;
+        CHECK(threaded.mseR == Approx(sums[0] / numPixels).epsilon(1e-6));
+        CHECK(threaded.mseG == Approx(sums[1] / numPixels).epsilon(1e-6));
+        CHECK(threaded.mseB == Approx(sums[2] / numPixels).epsilon(1e-6));
+        CHECK(threaded.mseA == Approx(sums[3] / numPixels).epsilon(1e-6));
+        CHECK(threaded.mse == Approx((sums[0] + sums[1] + sums[2] + sums[3]) / (numPixels * 4)).epsilon(1e-6));
+        CHECK(threaded.psnr == Approx(10.0 * log10(255.0 * 255.0 / threaded.mse)).epsilon(1e-5));
+
+        // Only the active channels count towards the combined error
+        CMP_AnalysisData rgb = {};
+        rgb.channelBitMap    = 0x7;
+        REQUIRE(CMP_MipSetAnlaysis(&texture1, &texture2, 0, 0, &rgb) == CMP_OK);
+        CHECK(rgb.mse == Approx((sums[0] + sums[1] + sums[2]) / (numPixels * 3)).epsilon(1e-6));
+
+        // Identical images
+        CMP_AnalysisData same = {};
+        same.channelBitMap    = 0xF;
+        REQUIRE(CMP_MipSetAnlaysis(&texture1, &texture1, 0, 0, &same) == CMP_OK);
+        CHECK(same.mse == 0.0f);
+        CHECK(same.psnr == 128.0f);
+
+        CMP_FreeMipSet(&texture1);
+        CMP_FreeMipSet(&texture2);
+    }
+}
+
+TEST_CASE("MipSet_Analysis_Throughput", "[.][BENCHMARK]")
+{
+    const CMP_INT width  = 8192;
+    const CMP_INT height = 4096;
+
+    struct
+    {
+        const char*       name;
+        CMP_FORMAT        format;
+        CMP_ChannelFormat channelFormat;
+    } formats[] = {{"RGBA_8888", CMP_FORMAT_RGBA_8888, CF_8bit}, {"RGBA_16F", CMP_FORMAT_RGBA_16F, CF_Float16}, {"RGBA_32F", CMP_FORMAT_RGBA_32F, CF_Float32}};
+
+    printf("MSE and PSNR of %dx%d images on %d threads\n", width, height, CMP_GetThreadPoolSize());
+
+    for (auto& format : formats)
+    {
+        CMP_MipSet texture1, texture2;
+        REQUIRE(CreateAnalysisTexture(texture1, format.format, format.channelFormat, width, height) == CMP_OK);
+        REQUIRE(CreateAnalysisTexture(texture2, format.format, format.channelFormat, width, height) == CMP_OK);
+        FillAnalysisTexture(texture1, 1);
+        FillAnalysisTexture(texture2, 2);
+
+        CMP_AnalysisData analysis = {};
+        analysis.channelBitMap    = 0xF;
+
+        BenchmarkTimer timer;
+        REQUIRE(CMP_MipSetAnlaysis(&texture1, &texture2, 0, 0, &analysis) == CMP_OK);
+        double seconds = timer.WallSeconds();
+        printf("  %-12s %8.3f s  %8.3f MPixels/s  %6.2f dB\n", format.name, seconds, (double)width * height / seconds / 1e6, analysis.psnr);
+
+        CMP_FreeMipSet(&texture1);
+        CMP_FreeMipSet(&texture2);
+    }
+}
+
+// A BC7 texture whose blocks are a byte pattern, the DDS plugin does not look at the blocks
+static void CreateCompressedTexture(CMP_MipSet& texture, CMP_INT width, CMP_INT height)
+{
+    CMP_MipSet source = {};
+    REQUIRE(CMP_CreateMipSet(&source, width, height, 1, CF_8bit, TT_2D) == CMP_OK);
+
+    texture = {};
+    REQUIRE(CMP_CreateCompressMipSet(&texture, &source) == CMP_OK);
+    texture.m_format     = CMP_FORMAT_BC7;
+    texture.m_compressed = true;
+    CMP_FreeMipSet(&source);
+
+    for (CMP_DWORD i = 0; i < texture.dwDataSize; i++)
+        texture.pData[i] = (CMP_BYTE)(i * 7 + (i >> 11));
+}
+
+static std::vector<CMP_BYTE> ReadFileBytes(const std::string& path)
+{
+    std::vector<CMP_BYTE> bytes;
+
+    FILE* pFile = fopen(path.c_str(), "rb");
+    if (!pFile)
+        return bytes;
+
+    CMP_BYTE buffer[65536];
+    size_t   nRead;
+    while ((nRead = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+        bytes.insert(bytes.end(), buffer, buffer + nRead);
+
+    fclose(pFile);
+    return bytes;
+}
+
+static std::vector<CMP_BYTE> TopLevelBytes(const CMP_MipSet& texture)
+{
+    CMP_MipLevel* level = NULL;
+    CMP_GetMipLevel(&level, &texture, 0, 0);
+    return std::vector<CMP_BYTE>(level->m_pbData, level->m_pbData + level->m_dwLinearSize);
+}
+
+TEST_CASE("Load_Texture_Mapped_DDS", "[FRAMEWORK]")
+{
+    std::string sourcePath = TEST_DATA_PATH + std::string("/mapped_source.dds");
+    std::string copyPath   = TEST_DATA_PATH + std::string("/mapped_copy.dds");
+
+    CMP_MipSet original;
+    CreateCompressedTexture(original, 256, 128);
+    std::vector<CMP_BYTE> originalBytes = TopLevelBytes(original);
+    REQUIRE(CMP_SaveTexture(sourcePath.c_str(), &original) == CMP_OK);
+    CMP_FreeMipSet(&original);
+
+    CMP_MemoryStats before = {};
+    before.dwSize          = sizeof(before);
+    REQUIRE(CMP_GetMemoryStats(&before) == CMP_OK);
+
+    // The level data points into the file, nothing is allocated for it
+    CMP_MipSet mapped = {};
+    mapped.m_Flags    = MS_FLAG_MapSourceFile;
+    REQUIRE(CMP_LoadTexture(sourcePath.c_str(), &mapped) == CMP_OK);
+    CHECK((mapped.m_Flags & MS_FLAG_MappedLevels) != 0);
+    CHECK(mapped.m_format == CMP_FORMAT_BC7);
+    CHECK(TopLevelBytes(mapped) == originalBytes);
+
+    CMP_MemoryStats after = {};
+    after.dwSize          = sizeof(after);
+    REQUIRE(CMP_GetMemoryStats(&after) == CMP_OK);
+    CHECK(after.nBytesInUse == before.nBytesInUse);
+
+    // Saving the mapped data elsewhere writes the same file
+    REQUIRE(CMP_SaveTexture(copyPath.c_str(), &mapped) == CMP_OK);
+    CHECK((mapped.m_Flags & MS_FLAG_MappedLevels) != 0);
+    CHECK(ReadFileBytes(copyPath) == ReadFileBytes(sourcePath));
+
+    // Writes go to private copies of the pages
+    mapped.pData[0] ^= 0xff;
+    CMP_MipSet loaded = {};
+    REQUIRE(CMP_LoadTexture(sourcePath.c_str(), &loaded) == CMP_OK);
+    CHECK((loaded.m_Flags & MS_FLAG_MappedLevels) == 0);
+    CHECK(TopLevelBytes(loaded) == originalBytes);
+    CMP_FreeMipSet(&loaded);
+
+    // Saving over the source file first copies the data out of the mapping
+    std::vector<CMP_BYTE> changedBytes = TopLevelBytes(mapped);
+    REQUIRE(CMP_SaveTexture(sourcePath.c_str(), &mapped) == CMP_OK);
+    CHECK((mapped.m_Flags & MS_FLAG_MappedLevels) == 0);
+    CHECK(TopLevelBytes(mapped) == changedBytes);
+    CMP_FreeMipSet(&mapped);
+
+    loaded = {};
+    REQUIRE(CMP_LoadTexture(sourcePath.c_str(), &loaded) == CMP_OK);
+    CHECK(TopLevelBytes(loaded) == changedBytes);
+    CMP_FreeMipSet(&loaded);
+
+    // An explicit detach leaves a mip set that owns its data
+    mapped         = {};
+    mapped.m_Flags = MS_FLAG_MapSourceFile;
+    REQUIRE(CMP_LoadTexture(copyPath.c_str(), &mapped) == CMP_OK);
+    REQUIRE((mapped.m_Flags & MS_FLAG_MappedLevels) != 0);
+    REQUIRE(CMP_DetachMipSet(&mapped) == CMP_OK);
+    CHECK((mapped.m_Flags & MS_FLAG_MappedLevels) == 0);
+    CHECK(TopLevelBytes(mapped) == originalBytes);
+
+    CMP_MipLevel* level = NULL;
+    CMP_GetMipLevel(&level, &mapped, 0, 0);
+    CHECK(mapped.pData == level->m_pbData);
+    CMP_FreeMipSet(&mapped);
+
+    remove(sourcePath.c_str());
+    remove(copyPath.c_str());
+}
+
+TEST_CASE("Load_Texture_Mapped_DDS_Throughput", "[.][BENCHMARK]")
+{
+    // A 64 MB BC7 texture, loaded from the page cache
+    const CMP_INT size = 8192;
+    const CMP_INT runs = 5;
+
+    std::string path = TEST_DATA_PATH + std::string("/mapped_benchmark.dds");
+
+    CMP_MipSet texture;
+    CreateCompressedTexture(texture, size, size);
+    REQUIRE(CMP_SaveTexture(path.c_str(), &texture) == CMP_OK);
+    CMP_FreeMipSet(&texture);
+
+    double readSeconds   = 1e30;
+    double mapSeconds    = 1e30;
+    double touchSeconds  = 1e30;
+    double detachSeconds = 1e30;
+    for (CMP_INT run = 0; run < runs; run++)
+    {
+        CMP_MipSet loaded = {};
+        BenchmarkTimer timer;
+        REQUIRE(CMP_LoadTexture(path.c_str(), &loaded) == CMP_OK);
+        readSeconds = std::min(readSeconds, timer.WallSeconds());
+        CMP_FreeMipSet(&loaded);
+
+        CMP_MipSet mapped = {};
+        mapped.m_Flags    = MS_FLAG_MapSourceFile;
+        timer.Restart();
+        REQUIRE(CMP_LoadTexture(path.c_str(), &mapped) == CMP_OK);
+        mapSeconds = std::min(mapSeconds, timer.WallSeconds());
+
+        // First access of every page
+        timer.Restart();
+        CMP_DWORD sum = 0;
+        for (CMP_DWORD i = 0; i < mapped.dwDataSize; i += 4096)
+            sum += mapped.pData[i];
+        touchSeconds = std::min(touchSeconds, timer.WallSeconds());
+        CHECK(sum != 0xffffffff);
+
+        timer.Restart();
+        REQUIRE(CMP_DetachMipSet(&mapped) == CMP_OK);
+        detachSeconds = std::min(detachSeconds, timer.WallSeconds());
+        CMP_FreeMipSet(&mapped);
+    }
+
+    remove(path.c_str());
+
+    printf("Load a %dx%d BC7 DDS, best of %d runs\n", size, size, runs);
+    printf("  read %8.2f ms  map %8.3f ms  first access %8.2f ms  detach %8.2f ms\n",
+           readSeconds * 1000.0,
+           mapSeconds * 1000.0,
+           touchSeconds * 1000.0,
+           detachSeconds * 1000.0);
+}
+
+// A stream that can only read or write in order, like a pipe or a socket
+struct SequentialStream
+{
+    std::vector<CMP_BYTE> bytes;
+    size_t                pos    = 0;
+    int                   closes = 0;
+};
+
+static size_t CMP_API SequentialRead(void* pBuffer, size_t size, CMP_DWORD_PTR pUser)
+{
+    SequentialStream* stream = (SequentialStream*)pUser;
+    size                     = std::min(size, stream->bytes.size() - stream->pos);
+    memcpy(pBuffer, stream->bytes.data() + stream->pos, size);
+    stream->pos += size;
+    return size;
+}
+
+static size_t CMP_API SequentialWrite(const void* pBuffer, size_t size, CMP_DWORD_PTR pUser)
+{
+    SequentialStream* stream = (SequentialStream*)pUser;
+    stream->bytes.insert(stream->bytes.end(), (const CMP_BYTE*)pBuffer, (const CMP_BYTE*)pBuffer + size);
+    return size;
+}
+
+static void CMP_API SequentialClose(CMP_DWORD_PTR pUser)
+{
+    ((SequentialStream*)pUser)->closes++;
+}
+
+TEST_CASE("Load_Save_Texture_Memory", "[FRAMEWORK]")
+{
+    std::string path = TEST_DATA_PATH + std::string("/memory_texture.dds");
+
+    CMP_MipSet original;
+    CreateCompressedTexture(original, 64, 32);
+    std::vector<CMP_BYTE> originalBytes = TopLevelBytes(original);
+    REQUIRE(CMP_SaveTexture(path.c_str(), &original) == CMP_OK);
+    std::vector<CMP_BYTE> fileBytes = ReadFileBytes(path);
+    remove(path.c_str());
+
+    // The saved memory is the file
+    void*  pData = NULL;
+    size_t size  = 0;
+    REQUIRE(CMP_SaveTextureToMemory(".dds", &original, &pData, &size) == CMP_OK);
+    REQUIRE(pData != NULL);
+    CHECK(std::vector<CMP_BYTE>((CMP_BYTE*)pData, (CMP_BYTE*)pData + size) == fileBytes);
+
+    // Loading finds the format from the data without a hint
+    CMP_MipSet loaded = {};
+    REQUIRE(CMP_LoadTextureFromMemory(pData, size, NULL, &loaded) == CMP_OK);
+    CHECK(loaded.m_format == CMP_FORMAT_BC7);
+    CHECK(loaded.m_nWidth == 64);
+    CHECK(loaded.m_nHeight == 32);
+    CHECK(TopLevelBytes(loaded) == originalBytes);
+    CMP_FreeMipSet(&loaded);
+
+    loaded = {};
+    REQUIRE(CMP_LoadTextureFromMemory(pData, size, "DDS", &loaded) == CMP_OK);
+    CHECK(TopLevelBytes(loaded) == originalBytes);
+    CMP_FreeMipSet(&loaded);
+
+    CMP_FreeTextureMemory(pData);
+
+    // Streams that cannot seek are buffered, and closed once
+    SequentialStream output;
+    CMP_Stream       stream = {};
+    stream.dwSize           = sizeof(stream);
+    stream.pWrite           = SequentialWrite;
+    stream.pClose           = SequentialClose;
+    stream.pUser            = (CMP_DWORD_PTR)&output;
+    REQUIRE(CMP_SaveTextureToStream(&stream, "dds", &original) == CMP_OK);
+    CHECK(output.bytes == fileBytes);
+    CHECK(output.closes == 1);
+
+    SequentialStream input;
+    input.bytes   = fileBytes;
+    stream        = {};
+    stream.dwSize = sizeof(stream);
+    stream.pRead  = SequentialRead;
+    stream.pClose = SequentialClose;
+    stream.pUser  = (CMP_DWORD_PTR)&input;
+    loaded        = {};
+    REQUIRE(CMP_LoadTextureFromStream(&stream, NULL, &loaded) == CMP_OK);
+    CHECK(TopLevelBytes(loaded) == originalBytes);
+    CHECK(input.closes == 1);
+    CMP_FreeMipSet(&loaded);
+
+    CMP_FreeMipSet(&original);
+
+    // Formats without a plugin go through stb
+    CMP_MipSet image = {};
+    REQUIRE(CMP_CreateMipSet(&image, 16, 8, 1, CF_8bit, TT_2D) == CMP_OK);
+    for (CMP_DWORD i = 0; i < image.dwDataSize; i++)
+        image.pData[i] = (CMP_BYTE)(i * 13);
+    std::vector<CMP_BYTE> imageBytes = TopLevelBytes(image);
+
+    REQUIRE(CMP_SaveTextureToMemory("png", &image, &pData, &size) == CMP_OK);
+    CMP_FreeMipSet(&image);
+
+    loaded = {};
+    REQUIRE(CMP_LoadTextureFromMemory(pData, size, NULL, &loaded) == CMP_OK);
+    CHECK(loaded.m_nWidth == 16);
+    CHECK(loaded.m_nHeight == 8);
+    CHECK(TopLevelBytes(loaded) == imageBytes);
+    CMP_FreeMipSet(&loaded);
+    CMP_FreeTextureMemory(pData);
+
+    // Data no loader knows is an error
+    std::vector<CMP_BYTE> garbage(256, 0x5a);
+    loaded = {};
+    CHECK(CMP_LoadTextureFromMemory(garbage.data(), garbage.size(), NULL, &loaded) != CMP_OK);
+}
+
+// The KTX2 and EXR plugins are found at run time, their tests are skipped where they were not built
+static bool ImagePluginAvailable(const char* name)
+{
+    CMP_InitFramework();
+    if (g_pluginManager.PluginSupported((char*)"IMAGE", (char*)name))
+        return true;
+
+    WARN("No " << name << " image plugin, skipped");
+    return false;
+}
+
+TEST_CASE("Load_Save_Texture_Memory_KTX2", "[FRAMEWORK]")
+{
+    if (!ImagePluginAvailable("KTX2"))
+        return;
+
+    CMP_MipSet original;
+    CreateCompressedTexture(original, 64, 32);
+    std::vector<CMP_BYTE> originalBytes = TopLevelBytes(original);
+
+    void*  pData = NULL;
+    size_t size  = 0;
+    REQUIRE(CMP_SaveTextureToMemory("ktx2", &original, &pData, &size) == CMP_OK);
+    REQUIRE(pData != NULL);
+    std::vector<CMP_BYTE> savedBytes((CMP_BYTE*)pData, (CMP_BYTE*)pData + size);
+
+    CMP_MipSet loaded = {};
+    REQUIRE(CMP_LoadTextureFromMemory(pData, size, NULL, &loaded) == CMP_OK);
+    CHECK(loaded.m_format == CMP_FORMAT_BC7);
+    CHECK(loaded.m_nWidth == 64);
+    CHECK(loaded.m_nHeight == 32);
+    CHECK(TopLevelBytes(loaded) == originalBytes);
+    CMP_FreeMipSet(&loaded);
+    CMP_FreeTextureMemory(pData);
+
+    SequentialStream output;
+    CMP_Stream       stream = {};
+    stream.dwSize           = sizeof(stream);
+    stream.pWrite           = SequentialWrite;
+    stream.pClose           = SequentialClose;
+    stream.pUser            = (CMP_DWORD_PTR)&output;
+    REQUIRE(CMP_SaveTextureToStream(&stream, "KTX2", &original) == CMP_OK);
+    CHECK(output.closes == 1);
+
+    SequentialStream input;
+    input.bytes   = output.bytes;
+    stream        = {};
+    stream.dwSize = sizeof(stream);
+    stream.pRead  = SequentialRead;
+    stream.pClose = SequentialClose;
+    stream.pUser  = (CMP_DWORD_PTR)&input;
+    loaded        = {};
+    REQUIRE(CMP_LoadTextureFromStream(&stream, NULL, &loaded) == CMP_OK);
+    CHECK(loaded.m_format == CMP_FORMAT_BC7);
+    CHECK(TopLevelBytes(loaded) == originalBytes);
+    CHECK(input.closes == 1);
+    CMP_FreeMipSet(&loaded);
+
+    CMP_FreeMipSet(&original);
+}
+
+TEST_CASE("Load_Save_Texture_Memory_EXR", "[FRAMEWORK]")
+{
+    if (!ImagePluginAvailable("EXR"))
+        return;
+
+    // Halves in [1, 2) come back from the RGBA half pixels of the file unchanged
+    CMP_MipSet image = {};
+    REQUIRE(CMP_CreateMipSet(&image, 16, 8, 1, CF_Float16, TT_2D) == CMP_OK);
+    image.m_format = CMP_FORMAT_ARGB_16F;
+
+    CMP_MipLevel* level = NULL;
+    CMP_GetMipLevel(&level, &image, 0, 0);
+    CMP_HALFSHORT* pHalfs = level->m_phfsData;
+    for (CMP_DWORD i = 0; i < level->m_dwLinearSize / sizeof(CMP_HALFSHORT); i++)
+        pHalfs[i] = (CMP_HALFSHORT)(0x3C00 | ((i * 37) & 0x3FF));
+    std::vector<CMP_BYTE> imageBytes = TopLevelBytes(image);
+
+    void*  pData = NULL;
+    size_t size  = 0;
+    REQUIRE(CMP_SaveTextureToMemory(".exr", &image, &pData, &size) == CMP_OK);
+    REQUIRE(pData != NULL);
+    CMP_FreeMipSet(&image);
+
+    CMP_MipSet loaded = {};
+    REQUIRE(CMP_LoadTextureFromMemory(pData, size, NULL, &loaded) == CMP_OK);
+    CHECK(loaded.m_ChannelFormat == CF_Float16);
+    CHECK(loaded.m_nWidth == 16);
+    CHECK(loaded.m_nHeight == 8);
+    CHECK(TopLevelBytes(loaded) == imageBytes);
+    CMP_FreeMipSet(&loaded);
+    CMP_FreeTextureMemory(pData);
+}
+
+// Source rows for CMP_ConvertTextureStream from an image in memory, the rows are checked to come in order
+struct RowSource
+{
+    std::vector<CMP_BYTE> pixels;
+    CMP_DWORD             dwPitch  = 0;
+    CMP_DWORD             nNextRow = 0;
+    CMP_DWORD             nMaxRows = 0;
+    CMP_DWORD             nFailRow = 0xFFFFFFFF;
+    SequentialStream      output;
+    CMP_DWORD             nNextOut = 0;
+    bool                  bInOrder = true;
+};
+
+static CMP_ERROR CMP_API RowSourceRead(CMP_BYTE* pRows, CMP_DWORD dwRow, CMP_DWORD dwRowCount, CMP_DWORD dwPitch, CMP_DWORD_PTR pUser)
+{
+    RowSource* source = (RowSource*)pUser;
+    if ((dwRow != source->nNextRow) || (dwPitch != source->dwPitch))
+        source->bInOrder = false;
+    if (dwRow >= source->nFailRow)
+        return CMP_ERR_GENERIC;
+
+    source->nNextRow = dwRow + dwRowCount;
+    source->nMaxRows = std::max(source->nMaxRows, dwRowCount);
+    memcpy(pRows, source->pixels.data() + (size_t)dwRow * dwPitch, (size_t)dwRowCount * dwPitch);
+    return CMP_OK;
+}
+
+static CMP_ERROR CMP_API RowSourceWrite(const CMP_BYTE* pData, CMP_DWORD dwSize, CMP_DWORD dwRow, CMP_DWORD dwRowCount, CMP_DWORD_PTR pUser)
+{
+    RowSource* source = (RowSource*)pUser;
+    if (dwRow != source->nNextOut)
+        source->bInOrder = false;
+
+    source->nNextOut = dwRow + dwRowCount;
+    SequentialWrite(pData, dwSize, (CMP_DWORD_PTR)&source->output);
+    return CMP_OK;
+}
+
+static bool CMP_API AbortFeedback(CMP_FLOAT fProgress, CMP_DWORD_PTR pUser1, CMP_DWORD_PTR pUser2)
+{
+    (void)fProgress;
+    (void)pUser1;
+    (void)pUser2;
+    return true;
+}
+
+TEST_CASE("Convert_Texture_Stream", "[FRAMEWORK]")
+{
+    const CMP_DWORD width  = 100;
+    const CMP_DWORD height = 70;
+
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = width;
+    srcTexture.dwHeight    = height;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+
+    std::vector<CMP_BYTE> pixels(width * height * 4);
+    for (size_t i = 0; i < pixels.size(); i++)
+        pixels[i] = (CMP_BYTE)((i * 31) ^ (i >> 9));
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.fquality            = 0.05f;
+
+    const CMP_FORMAT formats[] = {CMP_FORMAT_BC1, CMP_FORMAT_BC7};
+    for (CMP_FORMAT format : formats)
+    {
+        CMP_Texture destTexture = {};
+        destTexture.dwSize      = sizeof(destTexture);
+        destTexture.dwWidth     = width;
+        destTexture.dwHeight    = height;
+        destTexture.format      = format;
+
+        // The whole image converted at once is the reference
+        CMP_Texture wholeSrc  = srcTexture;
+        wholeSrc.pData        = pixels.data();
+        wholeSrc.dwDataSize   = (CMP_DWORD)pixels.size();
+        CMP_Texture wholeDest = destTexture;
+        wholeDest.dwDataSize  = CMP_CalculateBufferSize(&wholeDest);
+        std::vector<CMP_BYTE> expected(wholeDest.dwDataSize);
+        wholeDest.pData = expected.data();
+        REQUIRE(CMP_ConvertTexture(&wholeSrc, &wholeDest, &options, NULL) == CMP_OK);
+
+        // The file header goes first, then the rows complete the file
+        RowSource source;
+        source.pixels  = pixels;
+        source.dwPitch = width * 4;
+
+        CMP_Stream stream = {};
+        stream.dwSize     = sizeof(stream);
+        stream.pWrite     = SequentialWrite;
+        stream.pClose     = SequentialClose;
+        stream.pUser      = (CMP_DWORD_PTR)&source.output;
+        REQUIRE(CMP_SaveTextureHeaderToStream(&stream, "DDS", &destTexture) == CMP_OK);
+        CHECK(source.output.closes == 0);
+        size_t headerSize = source.output.bytes.size();
+
+        CMP_RowStream rows = {};
+        rows.dwSize        = sizeof(rows);
+        rows.dwBandRows    = 6;
+        rows.pReadRows     = RowSourceRead;
+        rows.pWriteRows    = RowSourceWrite;
+        rows.pUser         = (CMP_DWORD_PTR)&source;
+        REQUIRE(CMP_ConvertTextureStream(&srcTexture, &destTexture, &options, &rows, NULL) == CMP_OK);
+
+        // Bands are rounded up to whole blocks and no more than one band is read at a time
+        CHECK(source.bInOrder);
+        CHECK(source.nNextRow == height);
+        CHECK(source.nNextOut == height);
+        CHECK(source.nMaxRows == 8);
+        CHECK(std::vector<CMP_BYTE>(source.output.bytes.begin() + headerSize, source.output.bytes.end()) == expected);
+
+        CMP_MipSet loaded = {};
+        REQUIRE(CMP_LoadTextureFromMemory(source.output.bytes.data(), source.output.bytes.size(), NULL, &loaded) == CMP_OK);
+        CHECK(loaded.m_format == format);
+        CHECK(loaded.m_nWidth == (CMP_INT)width);
+        CHECK(loaded.m_nHeight == (CMP_INT)height);
+        CHECK(TopLevelBytes(loaded) == expected);
+        CMP_FreeMipSet(&loaded);
+    }
+
+    CMP_Texture destTexture = {};
+    destTexture.dwSize      = sizeof(destTexture);
+    destTexture.dwWidth     = width;
+    destTexture.dwHeight    = height;
+    destTexture.format      = CMP_FORMAT_BC1;
+
+    RowSource source;
+    source.pixels  = pixels;
+    source.dwPitch = width * 4;
+
+    CMP_RowStream rows = {};
+    rows.dwSize        = sizeof(rows);
+    rows.pReadRows     = RowSourceRead;
+    rows.pWriteRows    = RowSourceWrite;
+    rows.pUser         = (CMP_DWORD_PTR)&source;
+
+    // Errors from the callbacks and the feedback stop the conversion
+    source.nFailRow = 32;
+    rows.dwBandRows = 16;
+    CHECK(CMP_ConvertTextureStream(&srcTexture, &destTexture, &options, &rows, NULL) == CMP_ERR_GENERIC);
+
+    source               = RowSource();
+    source.pixels        = pixels;
+    source.dwPitch       = width * 4;
+    options.dwnumThreads = 1;
+    CHECK(CMP_ConvertTextureStream(&srcTexture, &destTexture, &options, &rows, AbortFeedback) == CMP_ABORTED);
+    CHECK(source.nNextOut == 16);
+
+    // Only compression to block formats can be streamed
+    destTexture.format = CMP_FORMAT_RGBA_8888;
+    CHECK(CMP_ConvertTextureStream(&srcTexture, &destTexture, &options, &rows, NULL) == CMP_ERR_UNSUPPORTED_DEST_FORMAT);
+    destTexture.format = CMP_FORMAT_BC1;
+    CHECK(CMP_SaveTextureHeaderToStream(NULL, "DDS", &destTexture) != CMP_OK);
+}
+
+TEST_CASE("Convert_Texture_Stream_KTX2", "[FRAMEWORK]")
+{
+    if (!ImagePluginAvailable("KTX2"))
+        return;
+
+    const CMP_DWORD width  = 100;
+    const CMP_DWORD height = 70;
+
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = width;
+    srcTexture.dwHeight    = height;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+
+    std::vector<CMP_BYTE> pixels(width * height * 4);
+    for (size_t i = 0; i < pixels.size(); i++)
+        pixels[i] = (CMP_BYTE)((i * 31) ^ (i >> 9));
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.fquality            = 0.05f;
+
+    CMP_Texture destTexture = {};
+    destTexture.dwSize      = sizeof(destTexture);
+    destTexture.dwWidth     = width;
+    destTexture.dwHeight    = height;
+    destTexture.format      = CMP_FORMAT_BC7;
+
+    CMP_Texture wholeSrc  = srcTexture;
+    wholeSrc.pData        = pixels.data();
+    wholeSrc.dwDataSize   = (CMP_DWORD)pixels.size();
+    CMP_Texture wholeDest = destTexture;
+    wholeDest.dwDataSize  = CMP_CalculateBufferSize(&wholeDest);
+    std::vector<CMP_BYTE> expected(wholeDest.dwDataSize);
+    wholeDest.pData = expected.data();
+    REQUIRE(CMP_ConvertTexture(&wholeSrc, &wholeDest, &options, NULL) == CMP_OK);
+
+    // The KTX2 header ends on the aligned offset of the level data, which libktx reads back
+    RowSource source;
+    source.pixels  = pixels;
+    source.dwPitch = width * 4;
+
+    CMP_Stream stream = {};
+    stream.dwSize     = sizeof(stream);
+    stream.pWrite     = SequentialWrite;
+    stream.pClose     = SequentialClose;
+    stream.pUser      = (CMP_DWORD_PTR)&source.output;
+    REQUIRE(CMP_SaveTextureHeaderToStream(&stream, "KTX2", &destTexture) == CMP_OK);
+    size_t headerSize = source.output.bytes.size();
+    CHECK(headerSize % 16 == 0);
+
+    CMP_RowStream rows = {};
+    rows.dwSize        = sizeof(rows);
+    rows.dwBandRows    = 6;
+    rows.pReadRows     = RowSourceRead;
+    rows.pWriteRows    = RowSourceWrite;
+    rows.pUser         = (CMP_DWORD_PTR)&source;
+    REQUIRE(CMP_ConvertTextureStream(&srcTexture, &destTexture, &options, &rows, NULL) == CMP_OK);
+    CHECK(source.bInOrder);
+    CHECK(std::vector<CMP_BYTE>(source.output.bytes.begin() + headerSize, source.output.bytes.end()) == expected);
+
+    CMP_MipSet loaded = {};
+    REQUIRE(CMP_LoadTextureFromMemory(source.output.bytes.data(), source.output.bytes.size(), NULL, &loaded) == CMP_OK);
+    CHECK(loaded.m_format == CMP_FORMAT_BC7);
+    CHECK(loaded.m_nWidth == (CMP_INT)width);
+    CHECK(loaded.m_nHeight == (CMP_INT)height);
+    CHECK(TopLevelBytes(loaded) == expected);
+    CMP_FreeMipSet(&loaded);
+}
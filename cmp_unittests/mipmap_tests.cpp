@@ -21,12 +21,25 @@
 //
 //=====================================================================
 
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <string>
+#include <vector>
 
 #include "single_include/catch2/catch.hpp"
 
 #include "compressonator.h"
 #include "common.h"
+#include "atiformats.h"
+#include "cmp_boxfilter.h"
+#include "cmp_memory.h"
+#include "cmp_threadpool.h"
+#include "format_conversion.h"
+#include "halfconvert.h"
+
+#include "benchmark_utils.h"
 #include "test_constants.h"
 
 TEST_CASE("Square Texture", "[MIPMAP]")
@@ -350,3 +363,688 @@ TEST_CASE("Filter Gamma", "[MIPMAP]")
         CHECK(adjustedScore < colorScore);
     }
 }
+
+// A mip level with its own pixel storage
+struct BoxFilterTestLevel
+{
+    CMP_MipLevel          level;
+    std::vector<CMP_BYTE> data;
+
+    BoxFilterTestLevel(CMP_INT width, CMP_INT height, CMP_INT bytesPerPixel)
+        : level()
+        , data((size_t)width * height * bytesPerPixel)
+    {
+        level.m_nWidth  = width;
+        level.m_nHeight = height;
+        level.m_pbData  = data.data();
+    }
+};
+
+static CMP_INT BoxFilterBytesPerPixel(CMP_FORMAT format)
+{
+    if (format == CMP_FORMAT_RGBA_16F)
+        return 8;
+    if (format == CMP_FORMAT_RGBA_32F)
+        return 16;
+    return 4;
+}
+
+static void FillBoxFilterLevel(BoxFilterTestLevel& level, CMP_FORMAT format, uint32_t seed, bool infinities)
+{
+    uint32_t state = seed * 2654435761u + 1;
+    auto     next  = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+
+    CMP_INT numValues = level.level.m_nWidth * level.level.m_nHeight * 4;
+    if (format == CMP_FORMAT_RGBA_16F)
+    {
+        std::vector<float> values(numValues);
+        for (auto& value : values)
+            value = (float)(next() % 20000) / 1000.0f - 4.0f;
+        ConvertFloatToHalf((unsigned short*)level.data.data(), values.data(), numValues);
+
+        // the pixels averaging an infinity take the bulk conversion path
+        for (CMP_INT i = 997; infinities && i < numValues; i += 997)
+            ((unsigned short*)level.data.data())[i] = 0x7c00;
+    }
+    else if (format == CMP_FORMAT_RGBA_32F)
+    {
+        float* values = (float*)level.data.data();
+        for (CMP_INT i = 0; i < numValues; i++)
+            values[i] = (float)(next() % 20000) / 1000.0f - 4.0f;
+    }
+    else
+    {
+        for (auto& value : level.data)
+            value = (CMP_BYTE)next();
+    }
+}
+
+// Straightforward per pixel box filter with the rounding of GenerateMipmapLevel
+static void ReferenceBoxFilter(BoxFilterTestLevel& dest, BoxFilterTestLevel** sources, CMP_INT numSources, CMP_FORMAT format)
+{
+    const CMP_INT width       = dest.level.m_nWidth;
+    const CMP_INT height      = dest.level.m_nHeight;
+    const bool    halveWidth  = width != sources[0]->level.m_nWidth;
+    const bool    halveHeight = height != sources[0]->level.m_nHeight;
+    const CMP_INT numTaps     = numSources * 4;
+
+    for (CMP_INT y = 0; y < height; y++)
+    {
+        for (CMP_INT x = 0; x < width; x++)
+        {
+            const CMP_INT sx[2] = {halveWidth ? 2 * x : x, halveWidth ? 2 * x + 1 : x};
+            const CMP_INT sy[2] = {halveHeight ? 2 * y : y, halveHeight ? 2 * y + 1 : y};
+            const CMP_INT index = y * width + x;
+
+            if (format == CMP_FORMAT_RGBA_1010102)
+            {
+                const CMP_INT offsets[4] = {0, 10, 20, 30};
+                const CMP_INT masks[4]   = {0x3ff, 0x3ff, 0x3ff, 0x3};
+                CMP_DWORD     pixel      = 0;
+                for (CMP_INT ch = 0; ch < 4; ch++)
+                {
+                    CMP_INT sum = 0;
+                    for (CMP_INT i = 0; i < numSources; i++)
+                        for (CMP_INT r = 0; r < 2; r++)
+                            for (CMP_INT c = 0; c < 2; c++)
+                            {
+                                const CMP_DWORD* row = (const CMP_DWORD*)sources[i]->data.data() + sy[r] * sources[i]->level.m_nWidth;
+                                sum += (row[sx[c]] >> offsets[ch]) & masks[ch];
+                            }
+                    pixel |= (CMP_DWORD)((sum + numTaps / 2) / numTaps) << offsets[ch];
+                }
+                ((CMP_DWORD*)dest.data.data())[index] = pixel;
+            }
+            else if (format == CMP_FORMAT_RGBA_8888 || format == CMP_FORMAT_RGBA_8888_S)
+            {
+                const bool isSigned = format == CMP_FORMAT_RGBA_8888_S;
+                for (CMP_INT ch = 0; ch < 4; ch++)
+                {
+                    CMP_INT sum = 0;
+                    for (CMP_INT i = 0; i < numSources; i++)
+                        for (CMP_INT r = 0; r < 2; r++)
+                            for (CMP_INT c = 0; c < 2; c++)
+                            {
+                                const CMP_BYTE* value = sources[i]->data.data() + (sy[r] * sources[i]->level.m_nWidth + sx[c]) * 4 + ch;
+                                sum += isSigned ? *(const CMP_SBYTE*)value : *value;
+                            }
+
+                    // round half up, also for negative sums
+                    CMP_INT average = (sum + numTaps / 2 + 128 * numTaps) / numTaps - 128;
+                    if (isSigned)
+                        ((CMP_SBYTE*)dest.data.data())[index * 4 + ch] = (CMP_SBYTE)average;
+                    else
+                        dest.data[index * 4 + ch] = (CMP_BYTE)average;
+                }
+            }
+            else
+            {
+                const bool isHalf = format == CMP_FORMAT_RGBA_16F;
+                for (CMP_INT ch = 0; ch < 4; ch++)
+                {
+                    float sum = 0.0f;
+                    for (CMP_INT i = 0; i < numSources; i++)
+                        for (CMP_INT r = 0; r < 2; r++)
+                        {
+                            float   pair[2];
+                            CMP_INT offsets[2] = {(sy[r] * sources[i]->level.m_nWidth + sx[0]) * 4 + ch, (sy[r] * sources[i]->level.m_nWidth + sx[1]) * 4 + ch};
+                            for (CMP_INT c = 0; c < 2; c++)
+                            {
+                                if (isHalf)
+                                    ConvertHalfToFloat(&pair[c], (const unsigned short*)sources[i]->data.data() + offsets[c], 1);
+                                else
+                                    pair[c] = ((const float*)sources[i]->data.data())[offsets[c]];
+                            }
+                            sum += pair[0] + pair[1];
+                        }
+
+                    float average = sum * (1.0f / numTaps);
+                    if (isHalf)
+                        ConvertFloatToHalf((unsigned short*)dest.data.data() + index * 4 + ch, &average, 1);
+                    else
+                        ((float*)dest.data.data())[index * 4 + ch] = average;
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Box_Filter_Formats", "[MIPMAP]")
+{
+    const CMP_FORMAT formats[] = {CMP_FORMAT_RGBA_8888, CMP_FORMAT_RGBA_8888_S, CMP_FORMAT_RGBA_1010102, CMP_FORMAT_RGBA_16F, CMP_FORMAT_RGBA_32F};
+
+    // Odd sizes, partial SIMD spans, rows and columns of one pixel, and more than one half float chunk
+    struct
+    {
+        CMP_INT srcWidth, srcHeight, numSources;
+    } sizes[] = {{64, 64, 1}, {37, 19, 1}, {1, 9, 1}, {9, 1, 1}, {301, 6, 1}, {37, 19, 2}, {2, 1, 2}};
+
+    for (CMP_FORMAT format : formats)
+    {
+        for (auto& size : sizes)
+        {
+            CMP_INT width         = std::max(size.srcWidth >> 1, 1);
+            CMP_INT height        = std::max(size.srcHeight >> 1, 1);
+            CMP_INT bytesPerPixel = BoxFilterBytesPerPixel(format);
+
+            BoxFilterTestLevel  slice0(size.srcWidth, size.srcHeight, bytesPerPixel);
+            BoxFilterTestLevel  slice1(size.srcWidth, size.srcHeight, bytesPerPixel);
+            BoxFilterTestLevel* sources[]    = {&slice0, &slice1};
+            CMP_MipLevel*       prevLevels[] = {&slice0.level, &slice1.level};
+            FillBoxFilterLevel(slice0, format, 1, true);
+            FillBoxFilterLevel(slice1, format, 2, false);
+
+            BoxFilterTestLevel result(width, height, bytesPerPixel);
+            BoxFilterTestLevel expected(width, height, bytesPerPixel);
+            GenerateMipmapLevel(&result.level, prevLevels, size.numSources, format);
+            ReferenceBoxFilter(expected, sources, size.numSources, format);
+
+            INFO("format " << format << " source " << size.srcWidth << "x" << size.srcHeight << " slices " << size.numSources);
+            CHECK(memcmp(result.data.data(), expected.data.data(), result.data.size()) == 0);
+        }
+    }
+}
+
+// The box filter before the per format kernels, kept as the benchmark baseline. It checks the format for every
+// pixel and averages each channel with an integer division per tap, single source level only.
+static void LegacyBoxFilter(CMP_MipLevel* currMipLevel, CMP_MipLevel* prevMipLevel, CMP_FORMAT format)
+{
+    const uint32_t    numChannels     = 4;
+    CMP_ChannelFormat channelFormat   = GetChannelFormat(format);
+    const uint32_t    bytesPerChannel = GetChannelFormatBitSize(format) / 8;
+    uint32_t          bytesPerPixel   = (format == CMP_FORMAT_RGBA_1010102) ? 4 : bytesPerChannel * numChannels;
+    CMP_BYTE*         destPixel       = currMipLevel->m_pbData;
+
+    for (uint32_t y = 0; y < (uint32_t)currMipLevel->m_nHeight; ++y)
+    {
+        CMP_BYTE* taps[4];
+        taps[0] = prevMipLevel->m_pbData + 2 * y * prevMipLevel->m_nWidth * bytesPerPixel;
+        taps[1] = taps[0] + bytesPerPixel;
+        taps[2] = taps[0] + prevMipLevel->m_nWidth * bytesPerPixel;
+        taps[3] = taps[2] + bytesPerPixel;
+
+        for (uint32_t x = 0; x < (uint32_t)currMipLevel->m_nWidth; ++x)
+        {
+            if (format == CMP_FORMAT_RGBA_1010102)
+            {
+                CMP_DWORD r = 0, g = 0, b = 0, a = 0;
+                for (uint32_t i = 0; i < 4; ++i)
+                {
+                    r += RGBA1010102_GET_R(*((CMP_DWORD*)taps[i]));
+                    g += RGBA1010102_GET_G(*((CMP_DWORD*)taps[i]));
+                    b += RGBA1010102_GET_B(*((CMP_DWORD*)taps[i]));
+                    a += RGBA1010102_GET_A(*((CMP_DWORD*)taps[i]));
+                }
+                *((CMP_DWORD*)destPixel) = ((r / 4) << RGBA1010102_OFFSET_R) | ((g / 4) << RGBA1010102_OFFSET_G) | ((b / 4) << RGBA1010102_OFFSET_B) |
+                                           ((a / 4) << RGBA1010102_OFFSET_A);
+                destPixel += bytesPerPixel;
+            }
+            else if (format == CMP_FORMAT_RGBA_8888_S)
+            {
+                for (uint32_t i = 0; i < numChannels; ++i)
+                {
+                    *((CMP_SBYTE*)destPixel) = (*((CMP_SBYTE*)taps[0] + i) + *((CMP_SBYTE*)taps[1] + i) + *((CMP_SBYTE*)taps[2] + i) + *((CMP_SBYTE*)taps[3] + i)) / 4;
+                    destPixel += bytesPerChannel;
+                }
+            }
+            else if (channelFormat == CF_8bit)
+            {
+                for (uint32_t i = 0; i < numChannels; ++i)
+                {
+                    *destPixel = (*(taps[0] + i) + *(taps[1] + i) + *(taps[2] + i) + *(taps[3] + i)) / 4;
+                    destPixel += bytesPerChannel;
+                }
+            }
+            else if (channelFormat == CF_Float16)
+            {
+                for (uint32_t i = 0; i < numChannels; ++i)
+                {
+                    *((CMP_HALFSHORT*)destPixel) = (*((CMP_HALFSHORT*)taps[0] + i) + *((CMP_HALFSHORT*)taps[1] + i) + *((CMP_HALFSHORT*)taps[2] + i) +
+                                                    *((CMP_HALFSHORT*)taps[3] + i)) /
+                                                   (CMP_HALFSHORT)4;
+                    destPixel += bytesPerChannel;
+                }
+            }
+            else if (channelFormat == CF_Float32)
+            {
+                for (uint32_t i = 0; i < numChannels; ++i)
+                {
+                    *((CMP_FLOAT*)destPixel) = (*((CMP_FLOAT*)taps[0] + i) + *((CMP_FLOAT*)taps[1] + i) + *((CMP_FLOAT*)taps[2] + i) + *((CMP_FLOAT*)taps[3] + i)) / 4.0f;
+                    destPixel += bytesPerChannel;
+                }
+            }
+
+            for (uint32_t i = 0; i < 4; ++i)
+                taps[i] += bytesPerPixel * 2;
+        }
+    }
+}
+
+TEST_CASE("Box_Filter_Throughput", "[.][BENCHMARK]")
+{
+    // A level that stays in the caches and one that is limited by the memory bandwidth
+    const CMP_INT srcSizes[] = {1024, 4096};
+    const CMP_INT runs       = 5;
+
+    struct
+    {
+        const char* name;
+        CMP_FORMAT  format;
+    } formats[] = {{"RGBA_8888", CMP_FORMAT_RGBA_8888},
+                   {"RGBA_8888_S", CMP_FORMAT_RGBA_8888_S},
+                   {"RGBA_1010102", CMP_FORMAT_RGBA_1010102},
+                   {"RGBA_16F", CMP_FORMAT_RGBA_16F},
+                   {"RGBA_32F", CMP_FORMAT_RGBA_32F}};
+
+    for (CMP_INT srcSize : srcSizes)
+    {
+        printf("Box filter %dx%d to %dx%d, best of %d runs\n", srcSize, srcSize, srcSize / 2, srcSize / 2, runs);
+
+        for (auto& format : formats)
+        {
+            CMP_INT            bytesPerPixel = BoxFilterBytesPerPixel(format.format);
+            BoxFilterTestLevel source(srcSize, srcSize, bytesPerPixel);
+            BoxFilterTestLevel dest(srcSize / 2, srcSize / 2, bytesPerPixel);
+            CMP_MipLevel*      prevLevel = &source.level;
+            FillBoxFilterLevel(source, format.format, 1, false);
+
+            double legacySeconds = 1e30;
+            double kernelSeconds = 1e30;
+            for (CMP_INT run = 0; run < runs; run++)
+            {
+                BenchmarkTimer timer;
+                LegacyBoxFilter(&dest.level, prevLevel, format.format);
+                legacySeconds = std::min(legacySeconds, timer.WallSeconds());
+
+                timer.Restart();
+                GenerateMipmapLevel(&dest.level, &prevLevel, 1, format.format);
+                kernelSeconds = std::min(kernelSeconds, timer.WallSeconds());
+            }
+
+            double mpixels = (double)srcSize * srcSize / 1e6;
+            printf("  %-14s legacy %8.1f MPixels/s  kernel %8.1f MPixels/s  %5.1fx\n",
+                   format.name,
+                   mpixels / legacySeconds,
+                   mpixels / kernelSeconds,
+                   legacySeconds / kernelSeconds);
+        }
+    }
+}
+
+// A texture with every face or slice of the top level filled with random pixels. A contiguous texture has all of its
+// levels allocated up front.
+static void CreateMipChainTexture(CMP_MipSet&     mipSet,
+                                  CMP_FORMAT      format,
+                                  CMP_TextureType textureType,
+                                  CMP_INT         width,
+                                  CMP_INT         height,
+                                  CMP_INT         depth,
+                                  bool            contiguous = false)
+{
+    CMP_CMIPS     cmips;
+    ChannelFormat channelFormat = format == CMP_FORMAT_RGBA_16F ? CF_Float16 : format == CMP_FORMAT_RGBA_32F ? CF_Float32 : CF_8bit;
+
+    mipSet = {};
+    if (contiguous)
+        REQUIRE(CMP_CreateContiguousMipSet(&mipSet, width, height, depth, channelFormat, textureType) == CMP_OK);
+    else
+        REQUIRE(cmips.AllocateMipSet(&mipSet, channelFormat, TDT_ARGB, textureType, width, height, depth));
+    mipSet.m_format = format;
+
+    for (CMP_INT nFaceOrSlice = 0; nFaceOrSlice < depth; nFaceOrSlice++)
+    {
+        BoxFilterTestLevel source(width, height, BoxFilterBytesPerPixel(format));
+        FillBoxFilterLevel(source, format, nFaceOrSlice + 1, false);
+
+        CMP_MipLevel* level = cmips.GetMipLevel(&mipSet, 0, nFaceOrSlice);
+        if (!contiguous)
+            REQUIRE(cmips.AllocateMipLevelData(level, width, height, channelFormat, TDT_ARGB));
+        REQUIRE(level->m_dwLinearSize == source.data.size());
+        memcpy(level->m_pbData, source.data.data(), source.data.size());
+    }
+}
+
+// Gathers every face or slice of every level so the results can be compared in one go
+static void GatherMipChain(CMP_MipSet& mipSet, std::vector<CMP_BYTE>& dst)
+{
+    CMP_CMIPS cmips;
+    for (CMP_INT nMipLevel = 0; nMipLevel < mipSet.m_nMipLevels; nMipLevel++)
+    {
+        for (CMP_INT nFaceOrSlice = 0; nFaceOrSlice < CMP_MaxFacesOrSlices(&mipSet, nMipLevel); nFaceOrSlice++)
+        {
+            CMP_MipLevel* level = cmips.GetMipLevel(&mipSet, nMipLevel, nFaceOrSlice);
+            dst.insert(dst.end(), level->m_pbData, level->m_pbData + level->m_dwLinearSize);
+        }
+    }
+}
+
+static CMP_ERROR GenerateMipChain(CMP_MipSet& mipSet, bool useThreadPool, CMP_DWORD numThreads, std::vector<CMP_BYTE>* dst)
+{
+    CMP_CFilterParams CFilterParam = {};
+    CFilterParam.nMinSize          = 1;
+    CFilterParam.fGammaCorrection  = 1;
+    CFilterParam.useThreadPool     = useThreadPool;
+    CFilterParam.dwnumThreads      = numThreads;
+
+    CMP_ERROR error = (CMP_ERROR)CMP_GenerateMIPLevelsEx(&mipSet, &CFilterParam);
+    if (error == CMP_OK && dst)
+        GatherMipChain(mipSet, *dst);
+    return error;
+}
+
+TEST_CASE("Threaded_Mip_Chain", "[MIPMAP]")
+{
+    CMP_ThreadPoolOptions poolOptions = {};
+    poolOptions.dwSize                = sizeof(poolOptions);
+    poolOptions.dwNumThreads          = 4;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+
+    // Levels that are cut into several tiles with a partial last tile, and small cube faces that are only worth
+    // threading together
+    struct
+    {
+        CMP_FORMAT      format;
+        CMP_TextureType textureType;
+        CMP_INT         width;
+        CMP_INT         height;
+        CMP_INT         depth;
+    } cases[] = {{CMP_FORMAT_RGBA_8888, TT_2D, 1000, 700, 1},
+                 {CMP_FORMAT_RGBA_16F, TT_2D, 517, 389, 1},
+                 {CMP_FORMAT_RGBA_32F, TT_2D, 300, 600, 1},
+                 {CMP_FORMAT_RGBA_8888, TT_CubeMap, 131, 131, 6},
+                 {CMP_FORMAT_RGBA_16F, TT_CubeMap, 130, 130, 6},
+                 {CMP_FORMAT_RGBA_8888, TT_VolumeTexture, 150, 140, 8}};
+
+    for (const auto& test : cases)
+    {
+        std::vector<CMP_BYTE> serial;
+        std::vector<CMP_BYTE> threaded;
+        std::vector<CMP_BYTE> limited;
+
+        CMP_MipSet mipSet;
+        CreateMipChainTexture(mipSet, test.format, test.textureType, test.width, test.height, test.depth);
+
+        REQUIRE(GenerateMipChain(mipSet, false, 0, &serial) == CMP_OK);
+        CHECK(mipSet.m_nMipLevels == mipSet.m_nMaxMipLevels);
+
+        // The mip levels are regenerated from the unchanged top level
+        REQUIRE(GenerateMipChain(mipSet, true, 0, &threaded) == CMP_OK);
+        REQUIRE(GenerateMipChain(mipSet, true, 2, &limited) == CMP_OK);
+
+        CHECK(!serial.empty());
+        CHECK(serial == threaded);
+        CHECK(serial == limited);
+
+        CMP_FreeMipSet(&mipSet);
+    }
+
+    poolOptions.dwNumThreads = 0;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+}
+
+TEST_CASE("Threaded_Mip_Chain_Throughput", "[.][BENCHMARK]")
+{
+    const CMP_INT runs = 3;
+
+    struct
+    {
+        const char*     name;
+        CMP_FORMAT      format;
+        CMP_TextureType textureType;
+        CMP_INT         size;
+        CMP_INT         depth;
+    } cases[] = {{"RGBA_8888 4096x4096", CMP_FORMAT_RGBA_8888, TT_2D, 4096, 1},
+                 {"RGBA_16F 4096x4096", CMP_FORMAT_RGBA_16F, TT_2D, 4096, 1},
+                 {"RGBA_8888 cube 1024", CMP_FORMAT_RGBA_8888, TT_CubeMap, 1024, 6}};
+
+    printf("Mip chain generation on %d pool threads, best of %d runs\n", CMP_ThreadPool::GetInstance().GetNumThreads(), runs);
+
+    for (const auto& test : cases)
+    {
+        CMP_MipSet mipSet;
+        CreateMipChainTexture(mipSet, test.format, test.textureType, test.size, test.size, test.depth);
+
+        double serialSeconds   = 1e30;
+        double threadedSeconds = 1e30;
+        for (CMP_INT run = 0; run < runs; run++)
+        {
+            BenchmarkTimer timer;
+            REQUIRE(GenerateMipChain(mipSet, false, 0, nullptr) == CMP_OK);
+            serialSeconds = std::min(serialSeconds, timer.WallSeconds());
+
+            timer.Restart();
+            REQUIRE(GenerateMipChain(mipSet, true, 0, nullptr) == CMP_OK);
+            threadedSeconds = std::min(threadedSeconds, timer.WallSeconds());
+        }
+
+        printf("  %-20s serial %8.2f ms  threaded %8.2f ms  %5.1fx\n",
+               test.name,
+               serialSeconds * 1000.0,
+               threadedSeconds * 1000.0,
+               serialSeconds / threadedSeconds);
+
+        CMP_FreeMipSet(&mipSet);
+    }
+}
+
+TEST_CASE("Contiguous_Mip_Set", "[MIPMAP]")
+{
+    struct
+    {
+        CMP_FORMAT      format;
+        CMP_TextureType textureType;
+        CMP_INT         width;
+        CMP_INT         height;
+        CMP_INT         depth;
+    } cases[] = {{CMP_FORMAT_RGBA_8888, TT_2D, 1000, 700, 1},
+                 {CMP_FORMAT_RGBA_32F, TT_2D, 33, 1, 1},
+                 {CMP_FORMAT_RGBA_16F, TT_CubeMap, 131, 131, 6},
+                 {CMP_FORMAT_RGBA_8888, TT_VolumeTexture, 150, 140, 8}};
+
+    for (const auto& test : cases)
+    {
+        CMP_MipSet contiguous;
+        CMP_MipSet separate;
+        CreateMipChainTexture(contiguous, test.format, test.textureType, test.width, test.height, test.depth, true);
+        CreateMipChainTexture(separate, test.format, test.textureType, test.width, test.height, test.depth);
+        CHECK((contiguous.m_Flags & MS_FLAG_ContiguousLevels) != 0);
+        CHECK(contiguous.pData == contiguous.m_pMipLevelTable[0]->m_pbData);
+
+        // The levels are filled in place and match the levels allocated one by one
+        std::vector<CMP_BYTE> contiguousChain;
+        std::vector<CMP_BYTE> separateChain;
+        REQUIRE(GenerateMipChain(contiguous, false, 0, &contiguousChain) == CMP_OK);
+        REQUIRE(GenerateMipChain(separate, false, 0, &separateChain) == CMP_OK);
+        CHECK(contiguous.m_nMipLevels == contiguous.m_nMaxMipLevels);
+        CHECK(contiguousChain == separateChain);
+
+        // Every level is aligned and follows the previous one in the block
+        CMP_CMIPS       cmips;
+        const CMP_BYTE* end = contiguous.m_pMipLevelTable[0]->m_pbData;
+        for (CMP_INT nMipLevel = 0; nMipLevel < contiguous.m_nMipLevels; nMipLevel++)
+        {
+            for (CMP_INT nFaceOrSlice = 0; nFaceOrSlice < CMP_MaxFacesOrSlices(&contiguous, nMipLevel); nFaceOrSlice++)
+            {
+                CMP_MipLevel* level = cmips.GetMipLevel(&contiguous, nMipLevel, nFaceOrSlice);
+                CMP_MipLevel* other = cmips.GetMipLevel(&separate, nMipLevel, nFaceOrSlice);
+                CHECK(((uintptr_t)level->m_pbData & 63) == 0);
+                CHECK(level->m_pbData >= end);
+                CHECK(level->m_pbData < end + 64);
+                CHECK(level->m_dwLinearSize == other->m_dwLinearSize);
+                end = level->m_pbData + level->m_dwLinearSize;
+            }
+        }
+
+        CMP_FreeMipSet(&contiguous);
+        CMP_FreeMipSet(&separate);
+        CHECK(contiguous.m_pMipLevelTable == NULL);
+        CHECK((contiguous.m_Flags & MS_FLAG_ContiguousLevels) == 0);
+    }
+
+    // Compressed levels are sized by the codecs, not the mip set
+    CMP_MipSet compressed = {};
+    CHECK(CMP_CreateContiguousMipSet(&compressed, 64, 64, 1, CF_Compressed, TT_2D) == CMP_ERR_UNSUPPORTED_SOURCE_FORMAT);
+    CHECK(compressed.m_pMipLevelTable == NULL);
+}
+
+TEST_CASE("Contiguous_Mip_Set_Allocation", "[.][BENCHMARK]")
+{
+    // A 2K cube map with a full chain, allocated one level at a time and as one block
+    const CMP_INT size = 2048;
+    const CMP_INT runs = 200;
+
+    CMP_CMIPS cmips;
+
+    BenchmarkTimer timer;
+    for (CMP_INT run = 0; run < runs; run++)
+    {
+        CMP_MipSet mipSet = {};
+        REQUIRE(cmips.AllocateMipSet(&mipSet, CF_8bit, TDT_ARGB, TT_CubeMap, size, size, 6));
+        for (CMP_INT nMipLevel = 0; nMipLevel < mipSet.m_nMaxMipLevels; nMipLevel++)
+        {
+            CMP_INT levelSize = (size >> nMipLevel) > 0 ? (size >> nMipLevel) : 1;
+            for (CMP_INT nFace = 0; nFace < 6; nFace++)
+                REQUIRE(cmips.AllocateMipLevelData(cmips.GetMipLevel(&mipSet, nMipLevel, nFace), levelSize, levelSize, CF_8bit, TDT_ARGB));
+        }
+        cmips.FreeMipSet(&mipSet);
+    }
+    double separateSeconds = timer.WallSeconds();
+
+    timer.Restart();
+    for (CMP_INT run = 0; run < runs; run++)
+    {
+        CMP_MipSet mipSet = {};
+        REQUIRE(CMP_CreateContiguousMipSet(&mipSet, size, size, 6, CF_8bit, TT_CubeMap) == CMP_OK);
+        cmips.FreeMipSet(&mipSet);
+    }
+    double contiguousSeconds = timer.WallSeconds();
+
+    printf("Allocate and free a %dx%d cube map chain, %d runs\n", size, size, runs);
+    printf("  per level %8.2f us  contiguous %8.2f us  %5.1fx\n",
+           separateSeconds * 1e6 / runs,
+           contiguousSeconds * 1e6 / runs,
+           separateSeconds / contiguousSeconds);
+}
+
+struct AllocatorCounters
+{
+    CMP_DWORD allocs;
+    CMP_DWORD frees;
+};
+
+static void* CMP_API CountingAlloc(size_t size, CMP_DWORD_PTR pUser)
+{
+    ((AllocatorCounters*)pUser)->allocs++;
+    return malloc(size);
+}
+
+static void CMP_API CountingFree(void* ptr, CMP_DWORD_PTR pUser)
+{
+    ((AllocatorCounters*)pUser)->frees++;
+    free(ptr);
+}
+
+TEST_CASE("Mip_Set_Allocator", "[MIPMAP]")
+{
+    AllocatorCounters counters = {};
+
+    CMP_AllocatorOptions options = {};
+    options.dwSize               = sizeof(options);
+    options.pAlloc               = CountingAlloc;
+    options.pFree                = CountingFree;
+    options.pUser                = (CMP_DWORD_PTR)&counters;
+    options.bUseArena            = true;
+    REQUIRE(CMP_SetAllocator(&options) == CMP_OK);
+
+    CMP_MemoryStats stats = {};
+    stats.dwSize          = sizeof(stats);
+
+    // The second chain of the same size is served from the blocks the first one gave back
+    std::vector<CMP_BYTE> first;
+    std::vector<CMP_BYTE> second;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        CMP_MipSet mipSet;
+        CreateMipChainTexture(mipSet, CMP_FORMAT_RGBA_8888, TT_2D, 300, 200, 1);
+        REQUIRE(GenerateMipChain(mipSet, false, 0, pass == 0 ? &first : &second) == CMP_OK);
+
+        CMP_CMIPS cmips;
+        for (CMP_INT nMipLevel = 0; nMipLevel < mipSet.m_nMipLevels; nMipLevel++)
+            CHECK(((uintptr_t)cmips.GetMipLevel(&mipSet, nMipLevel)->m_pbData & (CMP_MEM_ALIGNMENT - 1)) == 0);
+
+        REQUIRE(CMP_GetMemoryStats(&stats) == CMP_OK);
+        CHECK(stats.nBytesInUse > 0);
+        CMP_FreeMipSet(&mipSet);
+    }
+    CHECK(first == second);
+
+    REQUIRE(CMP_GetMemoryStats(&stats) == CMP_OK);
+    CHECK(stats.dwArenaReuses > 0);
+    CHECK(stats.dwAllocations == counters.allocs);
+    CHECK(stats.nBytesInUse == 0);
+    CHECK(stats.nPeakBytesInUse > 0);
+    CHECK(stats.nArenaBytes > 0);
+    CHECK(counters.frees == 0);
+
+    // Level data the host allocated itself is still released by the mip set
+    CMP_MipSet mipSet = {};
+    CMP_CMIPS  cmips;
+    REQUIRE(cmips.AllocateMipSet(&mipSet, CF_8bit, TDT_ARGB, TT_2D, 16, 16, 1));
+    CMP_MipLevel* level = cmips.GetMipLevel(&mipSet, 0);
+    level->m_pbData     = (CMP_BYTE*)calloc(1, 16 * 16 * 4);
+    CMP_FreeMipSet(&mipSet);
+
+    // Changing the allocator gives the arena back to the allocator that made it
+    REQUIRE(CMP_SetAllocator(NULL) == CMP_OK);
+    CHECK(counters.frees == counters.allocs);
+    REQUIRE(CMP_GetMemoryStats(&stats) == CMP_OK);
+    CHECK(stats.nArenaBytes == 0);
+
+    // The allocator and its free function come in pairs
+    options.pFree = NULL;
+    CHECK(CMP_SetAllocator(&options) == CMP_ERR_GENERIC);
+    options.dwSize = 0;
+    CHECK(CMP_SetAllocator(&options) == CMP_ERR_GENERIC);
+}
+
+TEST_CASE("Mip_Set_Allocator_Arena", "[.][BENCHMARK]")
+{
+    // A batch of conversions that allocate and free the same 2K chains over and over
+    const CMP_INT size = 2048;
+    const CMP_INT runs = 100;
+
+    double seconds[2];
+    for (int useArena = 0; useArena < 2; useArena++)
+    {
+        CMP_AllocatorOptions options = {};
+        options.dwSize               = sizeof(options);
+        options.bUseArena            = useArena != 0;
+        REQUIRE(CMP_SetAllocator(&options) == CMP_OK);
+
+        BenchmarkTimer timer;
+        for (CMP_INT run = 0; run < runs; run++)
+        {
+            CMP_MipSet mipSet;
+            CreateMipChainTexture(mipSet, CMP_FORMAT_RGBA_8888, TT_2D, size, size, 1);
+            REQUIRE(GenerateMipChain(mipSet, false, 0, nullptr) == CMP_OK);
+            CMP_FreeMipSet(&mipSet);
+        }
+        seconds[useArena] = timer.WallSeconds();
+    }
+
+    CMP_MemoryStats stats = {};
+    stats.dwSize          = sizeof(stats);
+    REQUIRE(CMP_GetMemoryStats(&stats) == CMP_OK);
+    REQUIRE(CMP_SetAllocator(NULL) == CMP_OK);
+
+    printf("Create, filter and free a %dx%d mip chain, %d runs\n", size, size, runs);
+    printf("  heap %8.2f ms  arena %8.2f ms  %5.2fx  (%u allocations, %u reuses)\n",
+           seconds[0] * 1000.0 / runs,
+           seconds[1] * 1000.0 / runs,
+           seconds[0] / seconds[1],
+           stats.dwAllocations,
+           stats.dwArenaReuses);
+}
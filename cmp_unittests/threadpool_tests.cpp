@@ -0,0 +1,687 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "compressonator.h"
+#include "cmp_threadpool.h"
+#include "common.h"
+#include "compress.h"
+
+#include "benchmark_utils.h"
+
+static void FillTestImage(std::vector<CMP_BYTE>& data, CMP_DWORD width, CMP_DWORD height)
+{
+    data.resize(width * height * 4);
+    for (CMP_DWORD y = 0; y < height; y++)
+    {
+        for (CMP_DWORD x = 0; x < width; x++)
+        {
+            CMP_BYTE* pixel = &data[(y * width + x) * 4];
+            pixel[0]        = (CMP_BYTE)(x * 4);
+            pixel[1]        = (CMP_BYTE)(y * 4);
+            pixel[2]        = (CMP_BYTE)((x * y) & 0xFF);
+            pixel[3]        = (CMP_BYTE)(255 - x);
+        }
+    }
+}
+
+static bool AbortFeedback(CMP_FLOAT fProgress, CMP_DWORD_PTR pUser1, CMP_DWORD_PTR pUser2)
+{
+    (void)fProgress;
+    (void)pUser1;
+    (void)pUser2;
+    return true;
+}
+
+static CMP_ERROR CompressTestImage(std::vector<CMP_BYTE>& src,
+                                   CMP_DWORD              width,
+                                   CMP_DWORD              height,
+                                   CMP_FORMAT             format,
+                                   CMP_DWORD              numThreads,
+                                   std::vector<CMP_BYTE>& dst,
+                                   CMP_Feedback_Proc      feedbackProc = NULL)
+{
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = width;
+    srcTexture.dwHeight    = height;
+    srcTexture.dwPitch     = width * 4;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+    srcTexture.dwDataSize  = (CMP_DWORD)src.size();
+    srcTexture.pData       = src.data();
+
+    CMP_Texture destTexture = {};
+    destTexture.dwSize      = sizeof(destTexture);
+    destTexture.dwWidth     = width;
+    destTexture.dwHeight    = height;
+    destTexture.format      = format;
+    destTexture.dwDataSize  = CMP_CalculateBufferSize(&destTexture);
+    dst.assign(destTexture.dwDataSize, 0);
+    destTexture.pData = dst.data();
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.fquality            = 0.05f;
+    options.dwnumThreads        = numThreads;
+
+    return CMP_ConvertTexture(&srcTexture, &destTexture, &options, feedbackProc);
+}
+
+TEST_CASE("ThreadPool ParallelFor", "[THREADPOOL]")
+{
+    const CMP_INT count = 1000;
+
+    std::vector<std::atomic<CMP_INT>> visits(count);
+    for (auto& v : visits)
+        v = 0;
+
+    std::atomic<CMP_INT> badWorkerIndex(0);
+    CMP_INT              poolSize = CMP_GetThreadPoolSize();
+    REQUIRE(poolSize > 0);
+
+    CMP_ThreadPool::GetInstance().ParallelFor(count, 0, [&](CMP_INT i) {
+        CMP_INT worker = CMP_ThreadPool::GetWorkerIndex();
+        if ((worker < 0) || (worker >= poolSize))
+            badWorkerIndex++;
+        visits[i]++;
+    });
+
+    CHECK(badWorkerIndex == 0);
+    for (CMP_INT i = 0; i < count; i++)
+        CHECK(visits[i] == 1);
+
+    CHECK(CMP_ThreadPool::GetWorkerIndex() == -1);
+}
+
+TEST_CASE("ThreadPool ParallelFor Does Not Requeue For Its Own Tasks", "[THREADPOOL]")
+{
+    CMP_ThreadPoolOptions poolOptions = {};
+    poolOptions.dwSize                = sizeof(poolOptions);
+    poolOptions.dwNumThreads          = 4;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+
+    // The other copies of the loop wait in the shared queue, they are not work of another caller
+    std::atomic<CMP_INT> visits(0);
+    CMP_ThreadPool::GetInstance().ResetStats();
+    CMP_ThreadPool::GetInstance().ParallelFor(1000, 0, [&](CMP_INT) { visits++; });
+    CHECK(visits == 1000);
+
+    CMP_ThreadPoolStats stats = {};
+    stats.dwSize              = sizeof(stats);
+    REQUIRE(CMP_GetThreadPoolStats(&stats) == CMP_OK);
+    CMP_DWORD tasks = 0;
+    for (CMP_INT i = 0; i < stats.nNumThreads; i++)
+        tasks += stats.dwTasks[i];
+    CHECK(tasks == 4);
+
+    poolOptions.dwNumThreads = 0;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+}
+
+TEST_CASE("ThreadPool Nested Tasks", "[THREADPOOL]")
+{
+    std::atomic<CMP_INT> total(0);
+
+    CMP_ThreadPool& pool = CMP_ThreadPool::GetInstance();
+    CMP_TaskGroup   outer;
+    for (CMP_INT i = 0; i < 16; i++)
+    {
+        pool.Submit(outer, [&pool, &total]() {
+            CMP_TaskGroup inner;
+            for (CMP_INT j = 0; j < 16; j++)
+                pool.Submit(inner, [&total]() { total++; });
+            pool.Wait(inner);
+        });
+    }
+    pool.Wait(outer);
+
+    CHECK(outer.IsDone());
+    CHECK(total == 16 * 16);
+}
+
+TEST_CASE("ThreadPool Resize", "[THREADPOOL]")
+{
+    CMP_ThreadPoolOptions options = {};
+    CHECK(CMP_InitThreadPool(&options) == CMP_ERR_GENERIC);
+
+    options.dwSize       = sizeof(options);
+    options.dwNumThreads = 3;
+    options.bPinThreads  = true;
+    REQUIRE(CMP_InitThreadPool(&options) == CMP_OK);
+    CHECK(CMP_GetThreadPoolSize() == 3);
+
+    CMP_ShutdownThreadPool();
+
+    // The pool restarts with default settings on next use
+    CHECK(CMP_GetThreadPoolSize() > 0);
+
+    options.dwNumThreads = 0;
+    options.bPinThreads  = false;
+    REQUIRE(CMP_InitThreadPool(&options) == CMP_OK);
+}
+
+TEST_CASE("ThreadPool Codecs Match Single Threaded", "[THREADPOOL]")
+{
+    const CMP_DWORD width  = 64;
+    const CMP_DWORD height = 64;
+
+    std::vector<CMP_BYTE> src;
+    FillTestImage(src, width, height);
+
+    CMP_FORMAT formats[] = {CMP_FORMAT_BC1, CMP_FORMAT_BC3, CMP_FORMAT_BC7};
+    for (CMP_FORMAT format : formats)
+    {
+        std::vector<CMP_BYTE> single;
+        std::vector<CMP_BYTE> threaded;
+
+        REQUIRE(CompressTestImage(src, width, height, format, 1, single) == CMP_OK);
+        REQUIRE(CompressTestImage(src, width, height, format, 0, threaded) == CMP_OK);
+
+        CHECK(single == threaded);
+    }
+}
+
+TEST_CASE("ThreadPool BC7 Row Jobs Abort", "[THREADPOOL]")
+{
+    const CMP_DWORD width  = 64;
+    const CMP_DWORD height = 256;
+
+    std::vector<CMP_BYTE> src;
+    std::vector<CMP_BYTE> dst;
+    FillTestImage(src, width, height);
+
+    CHECK(CompressTestImage(src, width, height, CMP_FORMAT_BC7, 0, dst, AbortFeedback) == CMP_ABORTED);
+}
+
+// Flat sky on top and dense detail below, the bottom rows take far longer to compress
+static void FillUnevenTestImage(std::vector<CMP_BYTE>& data, CMP_DWORD width, CMP_DWORD height)
+{
+    data.resize(width * height * 4);
+    CMP_DWORD seed = 12345;
+    for (CMP_DWORD y = 0; y < height; y++)
+    {
+        for (CMP_DWORD x = 0; x < width; x++)
+        {
+            CMP_BYTE* pixel = &data[(y * width + x) * 4];
+            for (int c = 0; c < 4; c++)
+            {
+                seed     = seed * 1664525 + 1013904223;
+                pixel[c] = (y < height * 3 / 4) ? (CMP_BYTE)(120 + c) : (CMP_BYTE)(seed >> 24);
+            }
+        }
+    }
+}
+
+static CMP_ERROR CompressTestImageTiled(std::vector<CMP_BYTE>& src,
+                                        CMP_DWORD              width,
+                                        CMP_DWORD              height,
+                                        CMP_FORMAT             format,
+                                        CMP_DWORD              tileHeight,
+                                        bool                   threaded,
+                                        std::vector<CMP_BYTE>& dst,
+                                        CMP_Feedback_Proc      feedbackProc = NULL)
+{
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = width;
+    srcTexture.dwHeight    = height;
+    srcTexture.dwPitch     = width * 4;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+    srcTexture.dwDataSize  = (CMP_DWORD)src.size();
+    srcTexture.pData       = src.data();
+
+    CMP_Texture destTexture  = {};
+    destTexture.dwSize       = sizeof(destTexture);
+    destTexture.dwWidth      = width;
+    destTexture.dwHeight     = height;
+    destTexture.nBlockWidth  = 4;
+    destTexture.nBlockHeight = 4;
+    destTexture.nBlockDepth  = 1;
+    destTexture.format       = format;
+    destTexture.dwDataSize   = CMP_CalculateBufferSize(&destTexture);
+    dst.assign(destTexture.dwDataSize, 0);
+    destTexture.pData = dst.data();
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.fquality            = 0.1f;  // The single threaded path skips the "Quality" parameter at the default
+    options.dwTileHeight        = tileHeight;
+
+    // Called directly, CMP_ConvertTexture only takes the threaded path on machines with several processors
+    if (threaded)
+        return CodecCompressTextureThreaded(&srcTexture, &destTexture, &options, feedbackProc);
+    return CodecCompressTexture(&srcTexture, &destTexture, &options, feedbackProc);
+}
+
+TEST_CASE("ThreadPool Tiled Compression Matches Single Threaded", "[THREADPOOL]")
+{
+    CMP_ThreadPoolOptions poolOptions = {};
+    poolOptions.dwSize                = sizeof(poolOptions);
+    poolOptions.dwNumThreads          = 4;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+
+    // Height is not a multiple of any of the tile heights and ends on a partial block
+    const CMP_DWORD width  = 72;
+    const CMP_DWORD height = 102;
+
+    std::vector<CMP_BYTE> src;
+    FillUnevenTestImage(src, width, height);
+
+    CMP_FORMAT formats[]     = {CMP_FORMAT_BC1, CMP_FORMAT_BC3, CMP_FORMAT_BC5, CMP_FORMAT_ETC2_RGB};
+    CMP_DWORD  tileHeights[] = {0, 1, 3, 64};
+    for (CMP_FORMAT format : formats)
+    {
+        std::vector<CMP_BYTE> single;
+        REQUIRE(CompressTestImageTiled(src, width, height, format, 0, false, single) == CMP_OK);
+
+        for (CMP_DWORD tileHeight : tileHeights)
+        {
+            std::vector<CMP_BYTE> tiled;
+            REQUIRE(CompressTestImageTiled(src, width, height, format, tileHeight, true, tiled) == CMP_OK);
+            CHECK(single == tiled);
+        }
+    }
+
+    CMP_ThreadPoolStats stats = {};
+    CHECK(CMP_GetThreadPoolStats(&stats) == CMP_ERR_GENERIC);
+
+    CMP_ResetThreadPoolStats();
+    std::vector<CMP_BYTE> tiled;
+    REQUIRE(CompressTestImageTiled(src, width, height, CMP_FORMAT_BC1, 1, true, tiled) == CMP_OK);
+
+    stats.dwSize = sizeof(stats);
+    REQUIRE(CMP_GetThreadPoolStats(&stats) == CMP_OK);
+    CHECK(stats.nNumThreads == 4);
+    CMP_DWORD totalTasks = 0;
+    for (CMP_INT i = 0; i < stats.nNumThreads; i++)
+    {
+        CHECK(stats.fBusyMS[i] <= stats.fElapsedMS);
+        totalTasks += stats.dwTasks[i];
+    }
+    CHECK(totalTasks > 0);
+    CHECK(stats.dwTasks[stats.nNumThreads] == 0);
+
+    poolOptions.dwNumThreads = 0;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+}
+
+TEST_CASE("ThreadPool Tiled Compression Abort", "[THREADPOOL]")
+{
+    std::vector<CMP_BYTE> src;
+    std::vector<CMP_BYTE> dst;
+    FillUnevenTestImage(src, 64, 256);
+
+    CHECK(CompressTestImageTiled(src, 64, 256, CMP_FORMAT_BC1, 1, true, dst, AbortFeedback) == CMP_ABORTED);
+}
+
+TEST_CASE("Uneven Image Tile Balance", "[.][BENCHMARK]")
+{
+    const CMP_DWORD width  = 2048;
+    const CMP_DWORD height = 2048;
+
+    std::vector<CMP_BYTE> src;
+    std::vector<CMP_BYTE> dst;
+    FillUnevenTestImage(src, width, height);
+
+    // A tile height of one band per worker reproduces the old static split
+    CMP_DWORD numThreads  = (CMP_DWORD)CMP_GetThreadPoolSize();
+    CMP_DWORD bandHeight  = (height / 4 + numThreads - 1) / numThreads;
+    CMP_DWORD tileHeights[] = {bandHeight, 16, 4, 1};
+    for (CMP_DWORD tileHeight : tileHeights)
+    {
+        CMP_ResetThreadPoolStats();
+
+        BenchmarkTimer timer;
+        REQUIRE(CompressTestImageTiled(src, width, height, CMP_FORMAT_ETC2_RGB, tileHeight, true, dst) == CMP_OK);
+        double wall = timer.WallSeconds();
+
+        CMP_ThreadPoolStats stats = {};
+        stats.dwSize              = sizeof(stats);
+        REQUIRE(CMP_GetThreadPoolStats(&stats) == CMP_OK);
+
+        CMP_FLOAT maxBusy = 0.0f;
+        CMP_FLOAT sumBusy = 0.0f;
+        for (CMP_INT i = 0; i < stats.nNumThreads; i++)
+        {
+            maxBusy = (stats.fBusyMS[i] > maxBusy) ? stats.fBusyMS[i] : maxBusy;
+            sumBusy += stats.fBusyMS[i];
+        }
+
+        printf("ETC2 %ux%u tiles of %u block rows: wall %.3f s, busy per thread avg %.1f ms max %.1f ms (%d threads)\n",
+               width,
+               height,
+               tileHeight,
+               wall,
+               sumBusy / stats.nNumThreads,
+               maxBusy,
+               stats.nNumThreads);
+    }
+}
+
+static void CreateTestCubeMap(CMP_MipSet& mipSet, CMP_INT size)
+{
+    CMP_CMIPS cmips;
+
+    mipSet          = {};
+    mipSet.m_format = CMP_FORMAT_RGBA_8888;
+    REQUIRE(cmips.AllocateMipSet(&mipSet, CF_8bit, TDT_ARGB, TT_CubeMap, size, size, 6));
+    mipSet.m_nMipLevels = mipSet.m_nMaxMipLevels;
+
+    for (CMP_INT nMipLevel = 0; nMipLevel < mipSet.m_nMipLevels; nMipLevel++)
+    {
+        CMP_INT levelSize = (size >> nMipLevel) > 0 ? (size >> nMipLevel) : 1;
+        for (CMP_INT nFace = 0; nFace < 6; nFace++)
+        {
+            CMP_MipLevel* level = cmips.GetMipLevel(&mipSet, nMipLevel, nFace);
+            REQUIRE(cmips.AllocateMipLevelData(level, levelSize, levelSize, CF_8bit, TDT_ARGB));
+
+            std::vector<CMP_BYTE> face;
+            FillTestImage(face, levelSize, levelSize);
+            for (size_t i = 0; i < face.size(); i += 4)
+                face[i + 2] = (CMP_BYTE)(face[i + 2] + nFace * 40);
+            memcpy(level->m_pbData, face.data(), face.size());
+        }
+    }
+}
+
+// Gathers every face of every level so the results can be compared in one go
+static void GatherTestCubeMap(CMP_MipSet& mipSet, std::vector<CMP_BYTE>& dst)
+{
+    CMP_CMIPS cmips;
+    for (CMP_INT nMipLevel = 0; nMipLevel < mipSet.m_nMipLevels; nMipLevel++)
+    {
+        for (CMP_INT nFace = 0; nFace < 6; nFace++)
+        {
+            CMP_MipLevel* level = cmips.GetMipLevel(&mipSet, nMipLevel, nFace);
+            dst.insert(dst.end(), level->m_pbData, level->m_pbData + level->m_dwLinearSize);
+        }
+    }
+}
+
+static CMP_ERROR CompressTestCubeMap(CMP_MipSet&            mipSetIn,
+                                     CMP_FORMAT             format,
+                                     CMP_DWORD              numThreads,
+                                     std::vector<CMP_BYTE>& dst,
+                                     CMP_Feedback_Proc      feedbackProc = NULL)
+{
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.fquality            = 0.05f;
+    options.dwnumThreads        = numThreads;
+    options.DestFormat          = format;
+
+    CMP_MipSet mipSetOut = {};
+    CMP_ERROR  status    = CMP_ConvertMipTexture(&mipSetIn, &mipSetOut, &options, feedbackProc);
+
+    dst.clear();
+    if (status == CMP_OK)
+        GatherTestCubeMap(mipSetOut, dst);
+
+    CMP_FreeMipSet(&mipSetOut);
+    return status;
+}
+
+TEST_CASE("ThreadPool Mip Set Bands Match Sequential", "[THREADPOOL]")
+{
+    CMP_ThreadPoolOptions poolOptions = {};
+    poolOptions.dwSize                = sizeof(poolOptions);
+    poolOptions.dwNumThreads          = 4;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+
+    // Sizes that are not a multiple of the band height and tail mips smaller than a block
+    struct
+    {
+        CMP_FORMAT format;
+        CMP_INT    size;
+    } cases[] = {{CMP_FORMAT_BC1, 264}, {CMP_FORMAT_BC3, 200}, {CMP_FORMAT_BC7, 132}};
+
+    for (const auto& test : cases)
+    {
+        CMP_MipSet mipSetIn;
+        CreateTestCubeMap(mipSetIn, test.size);
+
+        std::vector<CMP_BYTE> sequential;
+        std::vector<CMP_BYTE> banded;
+        std::vector<CMP_BYTE> limited;
+
+        REQUIRE(CompressTestCubeMap(mipSetIn, test.format, 1, sequential) == CMP_OK);
+        REQUIRE(CompressTestCubeMap(mipSetIn, test.format, 0, banded) == CMP_OK);
+        REQUIRE(CompressTestCubeMap(mipSetIn, test.format, 2, limited) == CMP_OK);
+
+        CHECK(!sequential.empty());
+        CHECK(sequential == banded);
+        CHECK(sequential == limited);
+
+        CMP_FreeMipSet(&mipSetIn);
+    }
+
+    poolOptions.dwNumThreads = 0;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+}
+
+TEST_CASE("ThreadPool Mip Set Bands Abort", "[THREADPOOL]")
+{
+    CMP_MipSet mipSetIn;
+    CreateTestCubeMap(mipSetIn, 128);
+
+    std::vector<CMP_BYTE> dst;
+    CHECK(CompressTestCubeMap(mipSetIn, CMP_FORMAT_BC7, 0, dst, AbortFeedback) == CMP_ABORTED);
+
+    CMP_FreeMipSet(&mipSetIn);
+}
+
+struct AsyncTestJob
+{
+    CMP_MipSet           mipSetIn;
+    CMP_MipSet           mipSetOut;
+    CMP_ConvertJob*      handle;
+    CMP_ERROR            status;
+    std::atomic<CMP_INT> completions;
+    std::atomic<CMP_INT> finishOrder;
+    std::atomic<CMP_INT> feedbackUserErrors;
+};
+
+static std::atomic<CMP_INT> g_AsyncFinished(0);
+
+static void CMP_API AsyncTestComplete(CMP_ERROR status, CMP_DWORD_PTR pUser)
+{
+    AsyncTestJob* job = (AsyncTestJob*)pUser;
+    job->status       = status;
+    job->finishOrder  = g_AsyncFinished++;
+    job->completions++;
+}
+
+static bool CMP_API AsyncTestFeedback(CMP_FLOAT fProgress, CMP_DWORD_PTR pUser1, CMP_DWORD_PTR pUser2)
+{
+    (void)fProgress;
+    (void)pUser2;
+    AsyncTestJob* job = (AsyncTestJob*)pUser1;
+    if (job->completions.load() != 0)
+        job->feedbackUserErrors++;
+    return false;
+}
+
+static CMP_ERROR StartAsyncTestJob(AsyncTestJob& job, CMP_INT size, CMP_FORMAT format)
+{
+    CreateTestCubeMap(job.mipSetIn, size);
+    job.mipSetOut          = {};
+    job.handle             = NULL;
+    job.status             = CMP_ERR_GENERIC;
+    job.completions        = 0;
+    job.finishOrder        = -1;
+    job.feedbackUserErrors = 0;
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.fquality            = 0.05f;
+    options.DestFormat          = format;
+
+    return CMP_ConvertMipTextureAsync(&job.mipSetIn, &job.mipSetOut, &options, AsyncTestFeedback, AsyncTestComplete, (CMP_DWORD_PTR)&job, &job.handle);
+}
+
+static void FreeAsyncTestJob(AsyncTestJob& job)
+{
+    CMP_ReleaseConvertJob(job.handle);
+    CMP_FreeMipSet(&job.mipSetOut);
+    CMP_FreeMipSet(&job.mipSetIn);
+}
+
+TEST_CASE("ThreadPool Async Mip Set Matches Blocking", "[THREADPOOL]")
+{
+    CMP_ThreadPoolOptions poolOptions = {};
+    poolOptions.dwSize                = sizeof(poolOptions);
+    poolOptions.dwNumThreads          = 4;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    CHECK(CMP_ConvertMipTextureAsync(NULL, NULL, &options, NULL, NULL, 0, NULL) == CMP_ERR_INVALID_SOURCE_TEXTURE);
+
+    AsyncTestJob jobs[2];
+    REQUIRE(StartAsyncTestJob(jobs[0], 264, CMP_FORMAT_BC1) == CMP_OK);
+    REQUIRE(StartAsyncTestJob(jobs[1], 200, CMP_FORMAT_BC3) == CMP_OK);
+
+    CMP_FORMAT formats[] = {CMP_FORMAT_BC1, CMP_FORMAT_BC3};
+    for (int i = 0; i < 2; i++)
+    {
+        AsyncTestJob& job = jobs[i];
+        REQUIRE(job.handle != NULL);
+        CHECK(CMP_WaitConvertJob(job.handle) == CMP_OK);
+        CHECK(job.completions == 1);
+        CHECK(job.status == CMP_OK);
+        CHECK(job.feedbackUserErrors == 0);
+
+        CMP_FLOAT progress = 0.0f;
+        CHECK(CMP_PollConvertJob(job.handle, &progress));
+        CHECK(progress == 100.0f);
+
+        std::vector<CMP_BYTE> blocking;
+        std::vector<CMP_BYTE> async;
+        REQUIRE(CompressTestCubeMap(job.mipSetIn, formats[i], 1, blocking) == CMP_OK);
+        GatherTestCubeMap(job.mipSetOut, async);
+        CHECK(!async.empty());
+        CHECK(async == blocking);
+
+        FreeAsyncTestJob(job);
+    }
+
+    poolOptions.dwNumThreads = 0;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+}
+
+TEST_CASE("ThreadPool Async Jobs Share Workers", "[THREADPOOL]")
+{
+    CMP_ThreadPoolOptions poolOptions = {};
+    poolOptions.dwSize                = sizeof(poolOptions);
+    poolOptions.dwNumThreads          = 2;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+
+    // The small job queued behind a large one gets its turn instead of waiting for the large one to finish
+    AsyncTestJob large;
+    AsyncTestJob small;
+    REQUIRE(StartAsyncTestJob(large, 512, CMP_FORMAT_BC3) == CMP_OK);
+    REQUIRE(StartAsyncTestJob(small, 64, CMP_FORMAT_BC3) == CMP_OK);
+
+    CHECK(CMP_WaitConvertJob(small.handle) == CMP_OK);
+    CHECK(CMP_WaitConvertJob(large.handle) == CMP_OK);
+    CHECK(small.finishOrder < large.finishOrder);
+
+    FreeAsyncTestJob(large);
+    FreeAsyncTestJob(small);
+
+    poolOptions.dwNumThreads = 0;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+}
+
+TEST_CASE("ThreadPool Async Cancel", "[THREADPOOL]")
+{
+    AsyncTestJob job;
+    REQUIRE(StartAsyncTestJob(job, 1024, CMP_FORMAT_BC7) == CMP_OK);
+
+    CMP_CancelConvertJob(job.handle);
+    CHECK(CMP_WaitConvertJob(job.handle) == CMP_ABORTED);
+    CHECK(job.status == CMP_ABORTED);
+    CHECK(job.completions == 1);
+
+    FreeAsyncTestJob(job);
+}
+
+TEST_CASE("ThreadPool Async Wait On Worker", "[THREADPOOL]")
+{
+    CMP_ThreadPoolOptions poolOptions = {};
+    poolOptions.dwSize                = sizeof(poolOptions);
+    poolOptions.dwNumThreads          = 2;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+
+    // A worker that waits on a job runs the job's bands itself or sleeps until another worker finishes them
+    AsyncTestJob  job;
+    CMP_ERROR     status = CMP_ERR_GENERIC;
+    CMP_TaskGroup group;
+    CMP_ThreadPool::GetInstance().Submit(group, [&job, &status]() {
+        if (StartAsyncTestJob(job, 128, CMP_FORMAT_BC1) == CMP_OK)
+            status = CMP_WaitConvertJob(job.handle);
+    });
+    CMP_ThreadPool::GetInstance().Wait(group);
+
+    CHECK(status == CMP_OK);
+    CHECK(job.completions == 1);
+    FreeAsyncTestJob(job);
+
+    poolOptions.dwNumThreads = 0;
+    REQUIRE(CMP_InitThreadPool(&poolOptions) == CMP_OK);
+}
+
+TEST_CASE("Cube Map Mip Set Wall Time", "[.][BENCHMARK]")
+{
+    const CMP_INT size = 2048;
+
+    CMP_MipSet mipSetIn;
+    CreateTestCubeMap(mipSetIn, size);
+
+    CMP_FORMAT formats[] = {CMP_FORMAT_BC1, CMP_FORMAT_BC3};
+    for (CMP_FORMAT format : formats)
+    {
+        std::vector<CMP_BYTE> dst;
+
+        BenchmarkTimer timer;
+        REQUIRE(CompressTestCubeMap(mipSetIn, format, 0, dst) == CMP_OK);
+        double wall = timer.WallSeconds();
+        double cpu  = timer.CPUSeconds();
+
+        printf("%s 6 x %dx%d with mips, %d pool threads: wall %.2f s, cpu %.2f s\n",
+               (format == CMP_FORMAT_BC1) ? "BC1" : "BC3",
+               size,
+               size,
+               CMP_GetThreadPoolSize(),
+               wall,
+               cpu);
+    }
+
+    CMP_FreeMipSet(&mipSetIn);
+}